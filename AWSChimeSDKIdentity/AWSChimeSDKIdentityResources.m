@@ -15,6 +15,7 @@
 
 #import "AWSChimeSDKIdentityResources.h"
 #import <AWSCore/AWSCocoaLumberjack.h>
+#import <AWSCore/AWSServiceModelCache.h>
 
 @interface AWSChimeSDKIdentityResources ()
 
@@ -42,15 +43,9 @@
 - (instancetype)init {
     if (self = [super init]) {
         //init method
-        NSError *error = nil;
-        _definitionDictionary = [NSJSONSerialization JSONObjectWithData:[[self definitionString] dataUsingEncoding:NSUTF8StringEncoding]
-                                                                options:kNilOptions
-                                                                  error:&error];
-        if (_definitionDictionary == nil) {
-            if (error) {
-                AWSDDLogError(@"Failed to parse JSON service definition: %@",error);
-            }
-        }
+        _definitionDictionary = [[AWSServiceModelCache sharedInstance] serviceDefinitionForName:@"ChimeSDKIdentity"
+                                                                               definitionString:[self definitionString]
+                                                                                         bundle:[NSBundle bundleForClass:[self class]]];
     }
     return self;
 }
@@ -15,6 +15,7 @@
 
 #import "AWSCognitoIdentityProviderResources.h"
 #import <AWSCore/AWSCocoaLumberjack.h>
+#import <AWSCore/AWSServiceModelCache.h>
 
 @interface AWSCognitoIdentityProviderResources ()
 
@@ -42,15 +43,9 @@
 - (instancetype)init {
     if (self = [super init]) {
         //init method
-        NSError *error = nil;
-        _definitionDictionary = [NSJSONSerialization JSONObjectWithData:[[self definitionString] dataUsingEncoding:NSUTF8StringEncoding]
-                                                                options:kNilOptions
-                                                                  error:&error];
-        if (_definitionDictionary == nil) {
-            if (error) {
-                AWSDDLogError(@"Failed to parse JSON service definition: %@",error);
-            }
-        }
+        _definitionDictionary = [[AWSServiceModelCache sharedInstance] serviceDefinitionForName:@"CognitoIdentityProvider"
+                                                                               definitionString:[self definitionString]
+                                                                                         bundle:[NSBundle bundleForClass:[self class]]];
     }
     return self;
 }
@@ -53,7 +53,17 @@ FOUNDATION_EXPORT const unsigned char AWSCoreVersionString[] DEPRECATED_MSG_ATTR
 #import "AWSSynchronizedMutableDictionary.h"
 #import "AWSXMLDictionary.h"
 #import "AWSSerialization.h"
+#import "AWSJSONWriter.h"
+#import "AWSXMLStreamingParser.h"
+#import "AWSServiceModelCache.h"
 #import "AWSTimestampSerialization.h"
+#import "AWSChecksum.h"
+#import "AWSNetworkingMetrics.h"
+#import "AWSResponseBodyConsumer.h"
+#import "AWSRequestCoalescer.h"
+#import "AWSResponseCache.h"
+#import "AWSURLSessionPool.h"
+#import "AWSBoundedExecutor.h"
 #import "AWSURLRequestSerialization.h"
 #import "AWSURLResponseSerialization.h"
 #import "AWSURLSessionManager.h"
@@ -0,0 +1,79 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class AWSCredentials;
+
+/**
+ Keeps the items of a keychain service in memory and writes changes to them to the keychain in the background, so that
+ credentials providers do not wait for keychain calls when they return or refresh credentials.
+
+ Each item is read from the keychain at most once. Changes made while earlier ones are waiting to be written are
+ coalesced, and values equal to what the keychain already holds are not written again. Stores are shared by service
+ within the process, so that credentials providers using the same service see each other's changes right away. Pending
+ changes are written before the app resigns active or terminates.
+ */
+@interface AWSCredentialsKeychainStore : NSObject
+
+/**
+ The service the items are stored under.
+ */
+@property (nonatomic, readonly) NSString *service;
+
+/**
+ The credentials stored under the service, read from the keychain when the store is created. They are immutable and can
+ be used without locking; setting new credentials replaces them at once and writes them in the background.
+ */
+@property (nonatomic, strong, nullable) AWSCredentials *credentials;
+
+/**
+ The number of items read from the keychain.
+ */
+@property (readonly) NSUInteger keychainReadCount;
+
+/**
+ The number of items written to or removed from the keychain.
+ */
+@property (readonly) NSUInteger keychainWriteCount;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Returns the store of a keychain service, creating it when there is none in use.
+
+ @param service The keychain service.
+
+ @return The store of the service.
+ */
++ (instancetype)storeWithService:(NSString *)service;
+
+- (nullable NSString *)stringForKey:(NSString *)key;
+
+/**
+ Sets the value of an item, or removes it when `string` is `nil`.
+ */
+- (void)setString:(nullable NSString *)string forKey:(NSString *)key;
+
+/**
+ Waits until the changes made so far have been written to the keychain.
+ */
+- (void)flush;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -154,6 +154,36 @@ typedef NS_ENUM(NSInteger, AWSCognitoCredentialsProviderErrorType) {
 
 @end
 
+/**
+ How an `AWSCognitoCredentialsProvider` refreshed its credentials, and how long callers waited for them.
+ */
+@interface AWSCredentialsRefreshMetrics : NSObject
+
+/**
+ The number of times credentials were fetched from the service, including failed and proactive fetches.
+ */
+@property (nonatomic, readonly) NSUInteger refreshCount;
+
+/**
+ The number of fetches started ahead of expiration while the cached credentials were still served.
+ */
+@property (nonatomic, readonly) NSUInteger proactiveRefreshCount;
+
+@property (nonatomic, readonly) NSUInteger failedRefreshCount;
+@property (nonatomic, readonly) NSTimeInterval totalRefreshDuration;
+@property (nonatomic, readonly) NSTimeInterval maximumRefreshDuration;
+
+/**
+ The number of calls to `credentials` that could not be served from the cache and waited for a refresh.
+ */
+@property (nonatomic, readonly) NSUInteger stallCount;
+@property (nonatomic, readonly) NSTimeInterval totalStallDuration;
+@property (nonatomic, readonly) NSTimeInterval maximumStallDuration;
+
+- (void)reset;
+
+@end
+
 /**
  An AWSCredentialsProvider that uses Amazon Cognito to fetch temporary credentials tied to an identity.
 
@@ -183,6 +213,18 @@ typedef NS_ENUM(NSInteger, AWSCognitoCredentialsProviderErrorType) {
  */
 @property (nonatomic, strong, readonly) NSString *identityPoolId;
 
+/**
+ The fraction of the lifetime of the credentials after which they are refreshed in the background, while callers keep
+ getting the cached credentials, e.g. 0.5 refreshes one hour credentials after 30 minutes. 0, the default, refreshes
+ them when they expire within 10 minutes, which callers wait for.
+
+ Concurrent callers share a single refresh either way, and get the cached credentials during a refresh as long as they
+ are valid for another minute.
+ */
+@property (nonatomic, assign) double proactiveRefreshFraction;
+
+@property (nonatomic, readonly) AWSCredentialsRefreshMetrics *refreshMetrics;
+
 /**
  Initializer for credentials provider with enhanced authentication flow. This is the recommended constructor for first time Amazon Cognito developers. Will create an instance of `AWSEnhancedCognitoIdentityProvider`.
 
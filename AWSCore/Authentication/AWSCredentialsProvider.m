@@ -14,6 +14,7 @@
 //
 
 #import "AWSCredentialsProvider.h"
+#import "AWSCredentialsKeychainStore.h"
 #import "AWSCognitoIdentity.h"
 #import "AWSSTS.h"
 #import "AWSUICKeyChainStore.h"
@@ -27,6 +28,8 @@ static NSString *const AWSCredentialsProviderKeychainSecretAccessKey = @"secretK
 static NSString *const AWSCredentialsProviderKeychainSessionToken = @"sessionKey";
 static NSString *const AWSCredentialsProviderKeychainExpiration = @"expiration";
 static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
+// How long cached credentials must stay valid to be used while they are refreshed.
+static NSTimeInterval const AWSCognitoCredentialsProviderMinimumValidity = 60;
 
 @interface AWSCognitoIdentity()
 
@@ -48,25 +51,28 @@ static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
 
 @interface AWSCredentials()
 
-- (nullable instancetype)initFromKeychain:(nonnull AWSUICKeyChainStore *)keychain;
+- (nullable instancetype)initFromKeychainStore:(nonnull AWSCredentialsKeychainStore *)keychainStore;
 
 @end
 
 @implementation AWSCredentials
 
-- (nullable instancetype)initFromKeychain:(nonnull AWSUICKeyChainStore *)keychain {
+- (nullable instancetype)initFromKeychainStore:(nonnull AWSCredentialsKeychainStore *)keychainStore {
+    NSString *accessKey = [keychainStore stringForKey:AWSCredentialsProviderKeychainAccessKeyId];
+    NSString *secretKey = [keychainStore stringForKey:AWSCredentialsProviderKeychainSecretAccessKey];
+    if (!accessKey || !secretKey) {
+        return nil;
+    }
+
     if (self = [super init]) {
-        if (keychain[AWSCredentialsProviderKeychainAccessKeyId]
-            && keychain[AWSCredentialsProviderKeychainSecretAccessKey]) {
-            AWSDDLogVerbose(@"Retrieving credentials from keychain");
-            _accessKey = keychain[AWSCredentialsProviderKeychainAccessKeyId];
-            _secretKey = keychain[AWSCredentialsProviderKeychainSecretAccessKey];
-            _sessionKey = keychain[AWSCredentialsProviderKeychainSessionToken];
-
-            NSString *expirationString = keychain[AWSCredentialsProviderKeychainExpiration];
-            if (expirationString) {
-                _expiration = [NSDate dateWithTimeIntervalSince1970:[expirationString doubleValue]];
-            }
+        AWSDDLogVerbose(@"Retrieving credentials from keychain");
+        _accessKey = accessKey;
+        _secretKey = secretKey;
+        _sessionKey = [keychainStore stringForKey:AWSCredentialsProviderKeychainSessionToken];
+
+        NSString *expirationString = [keychainStore stringForKey:AWSCredentialsProviderKeychainExpiration];
+        if (expirationString) {
+            _expiration = [NSDate dateWithTimeIntervalSince1970:[expirationString doubleValue]];
         }
     }
 
@@ -97,6 +103,173 @@ static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
 
 @end
 
+@interface AWSCredentialsKeychainStore()
+
+@property (nonatomic, strong) NSString *service;
+@property (nonatomic, strong) AWSUICKeyChainStore *keychain;
+// The credentials read without locking; `credentials` is set together with its items.
+@property (atomic, strong) AWSCredentials *snapshot;
+// The values of the items, `NSNull` for the ones known not to exist.
+@property (nonatomic, strong) NSMutableDictionary<NSString *, id> *items;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, id> *pendingItems;
+@property (nonatomic, assign) BOOL writeScheduled;
+// The values the keychain is known to hold, only accessed on `keychainQueue`.
+@property (nonatomic, strong) NSMutableDictionary<NSString *, id> *keychainItems;
+@property (nonatomic, strong) dispatch_queue_t keychainQueue;
+@property (atomic, assign) NSUInteger keychainReadCount;
+@property (atomic, assign) NSUInteger keychainWriteCount;
+
+@end
+
+@implementation AWSCredentialsKeychainStore
+
++ (instancetype)storeWithService:(NSString *)service {
+    static NSMapTable<NSString *, AWSCredentialsKeychainStore *> *stores = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        stores = [NSMapTable strongToWeakObjectsMapTable];
+    });
+
+    @synchronized(stores) {
+        AWSCredentialsKeychainStore *store = [stores objectForKey:service];
+        if (!store) {
+            store = [[AWSCredentialsKeychainStore alloc] initWithService:service];
+            [stores setObject:store forKey:service];
+        }
+        return store;
+    }
+}
+
+- (instancetype)initWithService:(NSString *)service {
+    if (self = [super init]) {
+        _service = service;
+        _keychain = [AWSUICKeyChainStore keyChainStoreWithService:service];
+        _items = [NSMutableDictionary new];
+        _pendingItems = [NSMutableDictionary new];
+        _keychainItems = [NSMutableDictionary new];
+        _keychainQueue = dispatch_queue_create("com.amazonaws.AWSCredentialsKeychainStore", DISPATCH_QUEUE_SERIAL);
+        _snapshot = [[AWSCredentials alloc] initFromKeychainStore:self];
+
+        // The app may be suspended and killed without further notice once it is no longer active.
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(applicationWillResignActive:)
+                                                     name:@"UIApplicationWillResignActiveNotification"
+                                                   object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(applicationWillResignActive:)
+                                                     name:@"UIApplicationWillTerminateNotification"
+                                                   object:nil];
+    }
+    return self;
+}
+
+- (void)applicationWillResignActive:(NSNotification *)notification {
+    [self flush];
+}
+
+- (AWSCredentials *)credentials {
+    return self.snapshot;
+}
+
+- (void)setCredentials:(AWSCredentials *)credentials {
+    NSString *expirationString = nil;
+    if (credentials.expiration) {
+        expirationString = [NSString stringWithFormat:@"%f", [credentials.expiration timeIntervalSince1970]];
+    }
+
+    @synchronized(self) {
+        self.snapshot = credentials;
+        [self setItem:credentials.accessKey forKey:AWSCredentialsProviderKeychainAccessKeyId];
+        [self setItem:credentials.secretKey forKey:AWSCredentialsProviderKeychainSecretAccessKey];
+        [self setItem:credentials.sessionKey forKey:AWSCredentialsProviderKeychainSessionToken];
+        [self setItem:expirationString forKey:AWSCredentialsProviderKeychainExpiration];
+    }
+}
+
+- (NSString *)stringForKey:(NSString *)key {
+    @synchronized(self) {
+        id item = self.items[key];
+        if (item) {
+            return item == [NSNull null] ? nil : item;
+        }
+    }
+
+    // Reads after the pending writes.
+    __block id keychainItem = nil;
+    dispatch_sync(self.keychainQueue, ^{
+        keychainItem = [self.keychain stringForKey:key] ?: [NSNull null];
+        self.keychainItems[key] = keychainItem;
+        self.keychainReadCount++;
+    });
+
+    @synchronized(self) {
+        // Set while the keychain was read.
+        id item = self.items[key];
+        if (!item) {
+            item = keychainItem;
+            self.items[key] = item;
+        }
+        return item == [NSNull null] ? nil : item;
+    }
+}
+
+- (void)setString:(NSString *)string forKey:(NSString *)key {
+    @synchronized(self) {
+        [self setItem:string forKey:key];
+    }
+}
+
+- (void)flush {
+    dispatch_sync(self.keychainQueue, ^{
+        // Only waits for the writes scheduled so far.
+    });
+}
+
+#pragma mark -
+
+// Must be called in @synchronized(self).
+- (void)setItem:(NSString *)string forKey:(NSString *)key {
+    id item = string ?: [NSNull null];
+    self.items[key] = item;
+    self.pendingItems[key] = item;
+    if (!self.writeScheduled) {
+        self.writeScheduled = YES;
+        dispatch_async(self.keychainQueue, ^{
+            [self writePendingItems];
+        });
+    }
+}
+
+- (void)writePendingItems {
+    NSDictionary<NSString *, id> *pendingItems = nil;
+    @synchronized(self) {
+        pendingItems = self.pendingItems;
+        self.pendingItems = [NSMutableDictionary new];
+        self.writeScheduled = NO;
+    }
+
+    [pendingItems enumerateKeysAndObjectsUsingBlock:^(NSString *key, id item, BOOL *stop) {
+        if ([self.keychainItems[key] isEqual:item]) {
+            return;
+        }
+        BOOL succeeded = NO;
+        if (item == [NSNull null]) {
+            succeeded = [self.keychain removeItemForKey:key];
+        } else {
+            succeeded = [self.keychain setString:item forKey:key];
+        }
+        self.keychainWriteCount++;
+        if (succeeded) {
+            self.keychainItems[key] = item;
+        } else {
+            AWSDDLogError(@"Failed to write the keychain item [%@] of service [%@].", key, self.service);
+            [self.keychainItems removeObjectForKey:key];
+        }
+    }];
+}
+
+@end
+
 @interface AWSStaticCredentialsProvider()
 
 @property (nonatomic, strong) AWSCredentials *internalCredentials;
@@ -171,22 +344,20 @@ static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
 @interface AWSWebIdentityCredentialsProvider()
 
 @property (nonatomic, strong) AWSSTS *sts;
-@property (nonatomic, strong) AWSUICKeyChainStore *keychain;
+@property (nonatomic, strong) AWSCredentialsKeychainStore *keychainStore;
 @property (nonatomic, strong) AWSCredentials *internalCredentials;
 
 @end
 
 @implementation AWSWebIdentityCredentialsProvider
 
-@synthesize internalCredentials = _internalCredentials;
-
 - (instancetype)initWithRegionType:(AWSRegionType)regionType
                         providerId:(NSString *)providerId
                            roleArn:(NSString *)roleArn
                    roleSessionName:(NSString *)roleSessionName
                   webIdentityToken:(NSString *)webIdentityToken {
     if (self = [super init]) {
-        _keychain = [AWSUICKeyChainStore keyChainStoreWithService:[NSString stringWithFormat:@"%@.%@.%@", providerId, webIdentityToken, roleArn]];
+        _keychainStore = [AWSCredentialsKeychainStore storeWithService:[NSString stringWithFormat:@"%@.%@.%@", providerId, webIdentityToken, roleArn]];
         _providerId = providerId;
         _roleArn = roleArn;
         _roleSessionName = roleSessionName;
@@ -196,7 +367,6 @@ static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
         AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:regionType
                                                                              credentialsProvider:credentialsProvider];
         _sts = [[AWSSTS alloc] initWithConfiguration:configuration];
-        _internalCredentials = [[AWSCredentials alloc] initFromKeychain:self.keychain];
     }
 
     return self;
@@ -247,22 +417,78 @@ static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
 #pragma mark -
 
 - (AWSCredentials *)internalCredentials {
-    if (! _internalCredentials) {
-        _internalCredentials = [[AWSCredentials alloc] initFromKeychain:self.keychain];
-    }
-    return _internalCredentials;
+    return self.keychainStore.credentials;
 }
 
 - (void)setInternalCredentials:(AWSCredentials *)internalCredentials {
-    _internalCredentials = internalCredentials;
+    self.keychainStore.credentials = internalCredentials;
+}
 
-    self.keychain[AWSCredentialsProviderKeychainAccessKeyId] = internalCredentials.accessKey;
-    self.keychain[AWSCredentialsProviderKeychainSecretAccessKey] = internalCredentials.secretKey;
-    self.keychain[AWSCredentialsProviderKeychainSessionToken] = internalCredentials.sessionKey;
-    if (internalCredentials.expiration) {
-        self.keychain[AWSCredentialsProviderKeychainExpiration] = [NSString stringWithFormat:@"%f", [internalCredentials.expiration timeIntervalSince1970]];
-    } else {
-        self.keychain[AWSCredentialsProviderKeychainExpiration] = nil;
+@end
+
+@interface AWSCredentialsRefreshMetrics()
+
+@property (nonatomic, assign) NSUInteger refreshCount;
+@property (nonatomic, assign) NSUInteger proactiveRefreshCount;
+@property (nonatomic, assign) NSUInteger failedRefreshCount;
+@property (nonatomic, assign) NSTimeInterval totalRefreshDuration;
+@property (nonatomic, assign) NSTimeInterval maximumRefreshDuration;
+@property (nonatomic, assign) NSUInteger stallCount;
+@property (nonatomic, assign) NSTimeInterval totalStallDuration;
+@property (nonatomic, assign) NSTimeInterval maximumStallDuration;
+
+@end
+
+@implementation AWSCredentialsRefreshMetrics
+
+- (void)recordRefreshDuration:(NSTimeInterval)duration
+                    proactive:(BOOL)proactive
+                       failed:(BOOL)failed {
+    @synchronized(self) {
+        _refreshCount++;
+        if (proactive) {
+            _proactiveRefreshCount++;
+        }
+        if (failed) {
+            _failedRefreshCount++;
+        }
+        _totalRefreshDuration += duration;
+        _maximumRefreshDuration = MAX(_maximumRefreshDuration, duration);
+    }
+}
+
+- (void)recordStallDuration:(NSTimeInterval)duration {
+    @synchronized(self) {
+        _stallCount++;
+        _totalStallDuration += duration;
+        _maximumStallDuration = MAX(_maximumStallDuration, duration);
+    }
+}
+
+- (void)reset {
+    @synchronized(self) {
+        _refreshCount = 0;
+        _proactiveRefreshCount = 0;
+        _failedRefreshCount = 0;
+        _totalRefreshDuration = 0;
+        _maximumRefreshDuration = 0;
+        _stallCount = 0;
+        _totalStallDuration = 0;
+        _maximumStallDuration = 0;
+    }
+}
+
+- (NSString *)description {
+    @synchronized(self) {
+        return [NSString stringWithFormat:@"{refreshes: %lu (%lu proactive, %lu failed), refresh: %.0f ms avg %.0f ms max, stalls: %lu, stall: %.0f ms avg %.0f ms max}",
+                (unsigned long)_refreshCount,
+                (unsigned long)_proactiveRefreshCount,
+                (unsigned long)_failedRefreshCount,
+                _refreshCount ? _totalRefreshDuration * 1000 / _refreshCount : 0,
+                _maximumRefreshDuration * 1000,
+                (unsigned long)_stallCount,
+                _stallCount ? _totalStallDuration * 1000 / _stallCount : 0,
+                _maximumStallDuration * 1000];
     }
 }
 
@@ -274,9 +500,12 @@ static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
 @property (nonatomic, strong) NSString *unAuthRoleArn;
 @property (nonatomic, strong) AWSSTS *sts;
 @property (nonatomic, strong) AWSCognitoIdentity *cognitoIdentity;
-@property (nonatomic, strong) AWSUICKeyChainStore *keychain;
+@property (nonatomic, strong) AWSCredentialsKeychainStore *keychainStore;
 @property (nonatomic, strong) AWSExecutor *refreshExecutor;
-@property (nonatomic, strong) dispatch_semaphore_t semaphore;
+@property (nonatomic, strong) AWSTask<AWSCredentials *> *refreshTask;
+@property (nonatomic, assign) BOOL refreshingCredentialsProactively;
+@property (atomic, strong) NSDate *credentialsFetchDate;
+@property (nonatomic, strong) AWSCredentialsRefreshMetrics *refreshMetrics;
 @property (atomic, assign) BOOL useEnhancedFlow;
 @property (nonatomic, strong) AWSCredentials *internalCredentials;
 @property (atomic, assign, getter=isRefreshingCredentials) BOOL refreshingCredentials;
@@ -290,8 +519,6 @@ static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
 
 @implementation AWSCognitoCredentialsProvider
 
-@synthesize internalCredentials = _internalCredentials;
-
 - (instancetype)initWithRegionType:(AWSRegionType)regionType
                     identityPoolId:(NSString *)identityPoolId
          identityPoolConfiguration:(AWSServiceConfiguration *)configuration {
@@ -388,7 +615,7 @@ static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
   identityPoolConfiguration:(AWSServiceConfiguration *)configuration {
     _refreshExecutor = [AWSExecutor executorWithOperationQueue:[NSOperationQueue new]];
     _refreshingCredentials = NO;
-    _semaphore = dispatch_semaphore_create(0);
+    _refreshMetrics = [AWSCredentialsRefreshMetrics new];
 
     _identityProvider = identityProvider;
     _unAuthRoleArn = unauthRoleArn;
@@ -396,15 +623,16 @@ static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
     _useEnhancedFlow = !unauthRoleArn && !authRoleArn;
 
     // initialize keychain - name spaced by app bundle and identity pool id
-    _keychain = [AWSUICKeyChainStore keyChainStoreWithService:[NSString stringWithFormat:@"%@.%@.%@", [NSBundle mainBundle].bundleIdentifier, [AWSCognitoCredentialsProvider class], identityProvider.identityPoolId]];
+    _keychainStore = [AWSCredentialsKeychainStore storeWithService:[NSString stringWithFormat:@"%@.%@.%@", [NSBundle mainBundle].bundleIdentifier, [AWSCognitoCredentialsProvider class], identityProvider.identityPoolId]];
 
     // If the identity provider has an identity id, use it
     if (identityProvider.identityId) {
-        _keychain[AWSCredentialsProviderKeychainIdentityId] = identityProvider.identityId;
+        [_keychainStore setString:identityProvider.identityId forKey:AWSCredentialsProviderKeychainIdentityId];
+        [_keychainStore flush];
     }
     // Otherwise push whatever is in the keychain down to the identity provider
     else {
-        identityProvider.identityId = _keychain[AWSCredentialsProviderKeychainIdentityId];
+        identityProvider.identityId = [_keychainStore stringForKey:AWSCredentialsProviderKeychainIdentityId];
     }
     _cognitoIdentity = [[AWSCognitoIdentity alloc] initWithConfiguration:configuration];
 
@@ -413,8 +641,6 @@ static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
     if (!_useEnhancedFlow) {
         _sts = [[AWSSTS alloc] initWithConfiguration:configuration];
     }
-
-    _internalCredentials = [[AWSCredentials alloc] initFromKeychain:self.keychain];
 }
 
 - (void)setUpWithRegionType:(AWSRegionType)regionType
@@ -603,11 +829,24 @@ static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
     // Returns cached credentials when all of the following conditions are true:
     // 1. The cached credentials are not nil.
     // 2. The credentials do not expire within 10 minutes.
-    if (self.internalCredentials
-        && [self.internalCredentials.expiration compare:[NSDate dateWithTimeIntervalSinceNow:10 * 60]] == NSOrderedDescending) {
-        return [AWSTask taskWithResult:self.internalCredentials];
+    AWSCredentials *internalCredentials = self.internalCredentials;
+    if ([self isFreshCredentials:internalCredentials]) {
+        if ([self shouldRefreshCredentialsProactively:internalCredentials]) {
+            [self refreshCredentialsProactively];
+        }
+        return [AWSTask taskWithResult:internalCredentials];
     }
-    
+
+    CFAbsoluteTime stallStart = CFAbsoluteTimeGetCurrent();
+    return [[self refreshCredentialsWithCancellationToken:cancellationTokenSource
+                                                proactive:NO] continueWithBlock:^id(AWSTask *task) {
+        [self.refreshMetrics recordStallDuration:CFAbsoluteTimeGetCurrent() - stallStart];
+        return task;
+    }];
+}
+
+- (AWSTask<AWSCredentials *> *)refreshCredentialsWithCancellationToken:(AWSCancellationTokenSource *)cancellationTokenSource
+                                                             proactive:(BOOL)proactive {
     id<AWSCognitoCredentialsProviderHelper> providerRef = self.identityProvider;
     return [[[providerRef logins] continueWithExecutor:self.refreshExecutor withSuccessBlock:^id _Nullable(AWSTask<NSDictionary<NSString *,NSString *> *> * _Nonnull task) {
         
@@ -636,66 +875,138 @@ static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
             // 1. The cached logins are different from the one the identity provider provided.
             // 2. The cached credentials is nil.
             // 3. The credentials expire within 10 minutes.
-            if ((!self.cachedLogins || [self.cachedLogins isEqualToDictionary:logins])
-                && self.internalCredentials
-                && [self.internalCredentials.expiration compare:[NSDate dateWithTimeIntervalSinceNow:10 * 60]] == NSOrderedDescending) {
-                return [AWSTask taskWithResult:self.internalCredentials];
-            }
-            
-            if (self.isRefreshingCredentials) {
-                // Waits up to 60 seconds for the Google SDK to refresh a token.
-                if (dispatch_semaphore_wait(self.semaphore, dispatch_time(DISPATCH_TIME_NOW, 60 * NSEC_PER_SEC)) != 0) {
-                    NSError *error = [NSError errorWithDomain:AWSCognitoCredentialsProviderErrorDomain
-                                                         code:AWSCognitoCredentialsProviderCredentialsRefreshTimeout
-                                                     userInfo:nil];
-                    return [AWSTask taskWithError:error];
-                }
-            }
-            
-            if (cancellationTokenSource.isCancellationRequested) {
-                return [AWSTask cancelledTask];
-            }
-            
-            if ((!self.cachedLogins || [self.cachedLogins isEqualToDictionary:logins])
-                && self.internalCredentials
-                && [self.internalCredentials.expiration compare:[NSDate dateWithTimeIntervalSinceNow:10 * 60]] == NSOrderedDescending) {
+            // 4. The credentials are refreshed proactively.
+            if (!proactive
+                && (!self.cachedLogins || [self.cachedLogins isEqualToDictionary:logins])
+                && [self isFreshCredentials:self.internalCredentials]) {
                 return [AWSTask taskWithResult:self.internalCredentials];
             }
             
-            self.refreshingCredentials = YES;
-            self.cachedLogins = logins;
-            
-            if (self.useEnhancedFlow) {
-                NSString * customRoleArn = nil;
-                if([providerRef.identityProviderManager respondsToSelector:@selector(customRoleArn)]){
-                    customRoleArn = providerRef.identityProviderManager.customRoleArn;
-                }
-                if(self.customRoleArnOverride){
-                    customRoleArn = self.customRoleArnOverride;
-                }
-                return [self getCredentialsWithCognito:logins
-                                         authenticated:[providerRef isAuthenticated]
-                                         customRoleArn:customRoleArn
-                                 withCancellationToken:cancellationTokenSource];
-            } else {
-                return [self getCredentialsWithSTS:logins
-                                     authenticated:[providerRef isAuthenticated]
-                             withCancellationToken:cancellationTokenSource];
-            }
-            
+            return [self fetchCredentialsWithLogins:logins
+                                          proactive:proactive
+                              withCancellationToken:cancellationTokenSource];
         }];
     }] continueWithBlock:^id(AWSTask *task) {
         if (task.error) {
             AWSDDLogError(@"Unable to refresh. Error is [%@]", task.error);
         }
         
-        self.refreshingCredentials = NO;
-        dispatch_semaphore_signal(self.semaphore);
-        
         return task;
     }];
 }
 
+/**
+ Fetches new credentials unless another caller already is. Callers arriving during the fetch get the cached credentials
+ while they are still valid, and wait for the fetch otherwise.
+ */
+- (AWSTask<AWSCredentials *> *)fetchCredentialsWithLogins:(NSDictionary<NSString *,NSString *> *)logins
+                                                proactive:(BOOL)proactive
+                                    withCancellationToken:(AWSCancellationTokenSource *)cancellationTokenSource {
+    AWSTask<AWSCredentials *> *refreshTask = nil;
+    AWSTaskCompletionSource<AWSCredentials *> *taskCompletionSource = nil;
+    @synchronized(self) {
+        refreshTask = self.refreshTask;
+        if (!refreshTask) {
+            taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+            self.refreshTask = taskCompletionSource.task;
+            self.refreshingCredentials = YES;
+        }
+    }
+
+    if (refreshTask) {
+        AWSCredentials *internalCredentials = self.internalCredentials;
+        if ((!self.cachedLogins || [self.cachedLogins isEqualToDictionary:logins])
+            && [internalCredentials.expiration compare:[NSDate dateWithTimeIntervalSinceNow:AWSCognitoCredentialsProviderMinimumValidity]] == NSOrderedDescending) {
+            return [AWSTask taskWithResult:internalCredentials];
+        }
+        return [refreshTask continueWithBlock:^id _Nullable(AWSTask<AWSCredentials *> * _Nonnull task) {
+            // The refresh was cancelled by its own caller, or was for other logins.
+            if (task.isCancelled
+                || (self.cachedLogins && ![self.cachedLogins isEqualToDictionary:logins])) {
+                return [self fetchCredentialsWithLogins:logins
+                                              proactive:proactive
+                                  withCancellationToken:cancellationTokenSource];
+            }
+            return task;
+        }];
+    }
+
+    self.cachedLogins = logins;
+
+    AWSTask<AWSCredentials *> *fetchTask = nil;
+    id<AWSCognitoCredentialsProviderHelper> providerRef = self.identityProvider;
+    if (self.useEnhancedFlow) {
+        NSString * customRoleArn = nil;
+        if([providerRef.identityProviderManager respondsToSelector:@selector(customRoleArn)]){
+            customRoleArn = providerRef.identityProviderManager.customRoleArn;
+        }
+        if(self.customRoleArnOverride){
+            customRoleArn = self.customRoleArnOverride;
+        }
+        fetchTask = [self getCredentialsWithCognito:logins
+                                      authenticated:[providerRef isAuthenticated]
+                                      customRoleArn:customRoleArn
+                              withCancellationToken:cancellationTokenSource];
+    } else {
+        fetchTask = [self getCredentialsWithSTS:logins
+                                  authenticated:[providerRef isAuthenticated]
+                          withCancellationToken:cancellationTokenSource];
+    }
+
+    NSDate *fetchDate = [NSDate date];
+    return [fetchTask continueWithBlock:^id _Nullable(AWSTask<AWSCredentials *> * _Nonnull task) {
+        [self.refreshMetrics recordRefreshDuration:-[fetchDate timeIntervalSinceNow]
+                                         proactive:proactive
+                                            failed:task.result == nil];
+        if (task.result) {
+            self.credentialsFetchDate = fetchDate;
+        }
+        @synchronized(self) {
+            self.refreshTask = nil;
+            self.refreshingCredentials = NO;
+        }
+
+        if (task.isCancelled) {
+            [taskCompletionSource cancel];
+        } else if (task.error) {
+            taskCompletionSource.error = task.error;
+        } else {
+            taskCompletionSource.result = task.result;
+        }
+        return task;
+    }];
+}
+
+- (BOOL)isFreshCredentials:(AWSCredentials *)credentials {
+    return credentials
+    && [credentials.expiration compare:[NSDate dateWithTimeIntervalSinceNow:10 * 60]] == NSOrderedDescending;
+}
+
+- (BOOL)shouldRefreshCredentialsProactively:(AWSCredentials *)credentials {
+    NSDate *credentialsFetchDate = self.credentialsFetchDate;
+    if (self.proactiveRefreshFraction <= 0 || !credentialsFetchDate || !credentials.expiration) {
+        return NO;
+    }
+    NSTimeInterval lifetime = [credentials.expiration timeIntervalSinceDate:credentialsFetchDate];
+    return -[credentialsFetchDate timeIntervalSinceNow] >= lifetime * self.proactiveRefreshFraction;
+}
+
+- (void)refreshCredentialsProactively {
+    @synchronized(self) {
+        if (self.refreshTask || self.refreshingCredentialsProactively) {
+            return;
+        }
+        self.refreshingCredentialsProactively = YES;
+    }
+    [[self refreshCredentialsWithCancellationToken:nil
+                                         proactive:YES] continueWithBlock:^id _Nullable(AWSTask<AWSCredentials *> * _Nonnull task) {
+        @synchronized(self) {
+            self.refreshingCredentialsProactively = NO;
+        }
+        return nil;
+    }];
+}
+
 #pragma mark - AWSCredentialsProvider methods
 
 - (AWSTask<AWSCredentials *> *)credentials {
@@ -783,31 +1094,21 @@ static NSString *const AWSCredentialsProviderKeychainIdentityId = @"identityId";
     if (identityId) {
         return identityId;
     }
-    return [self.keychain stringForKey:AWSCredentialsProviderKeychainIdentityId];
+    return [self.keychainStore stringForKey:AWSCredentialsProviderKeychainIdentityId];
 }
 
 - (void)setIdentityId:(NSString *)identityId {
-    self.keychain[AWSCredentialsProviderKeychainIdentityId] = identityId;
+    // Unlike credentials, a lost identity id can not be refreshed: the next launch would create a new identity.
+    [self.keychainStore setString:identityId forKey:AWSCredentialsProviderKeychainIdentityId];
+    [self.keychainStore flush];
 }
 
 - (AWSCredentials *)internalCredentials {
-    if (! _internalCredentials) {
-        _internalCredentials = [[AWSCredentials alloc] initFromKeychain:self.keychain];
-    }
-    return _internalCredentials;
+    return self.keychainStore.credentials;
 }
 
 - (void)setInternalCredentials:(AWSCredentials *)internalCredentials {
-    _internalCredentials = internalCredentials;
-
-    self.keychain[AWSCredentialsProviderKeychainAccessKeyId] = internalCredentials.accessKey;
-    self.keychain[AWSCredentialsProviderKeychainSecretAccessKey] = internalCredentials.secretKey;
-    self.keychain[AWSCredentialsProviderKeychainSessionToken] = internalCredentials.sessionKey;
-    if (internalCredentials.expiration) {
-        self.keychain[AWSCredentialsProviderKeychainExpiration] = [NSString stringWithFormat:@"%f", [internalCredentials.expiration timeIntervalSince1970]];
-    } else {
-        self.keychain[AWSCredentialsProviderKeychainExpiration] = nil;
-    }
+    self.keychainStore.credentials = internalCredentials;
 }
 
 @end
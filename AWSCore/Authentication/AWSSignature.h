@@ -15,9 +15,42 @@
 
 #import <Foundation/Foundation.h>
 #import "AWSNetworking.h"
+#import "AWSChecksum.h"
 
 FOUNDATION_EXPORT NSString * _Nonnull const AWSSignatureV4Algorithm;
 FOUNDATION_EXPORT NSString * _Nonnull const AWSSignatureV4Terminator;
+/**
+ The `NSURLProtocol` property holding the absolute URL string of the file read by the `HTTPBodyStream` of a request. When
+ `payloadFileHashingEnabled` is set, `AWSSignatureV4Signer` hashes the file in bounded memory and signs the payload hash,
+ instead of sending the stream aws-chunked.
+ */
+FOUNDATION_EXPORT NSString * _Nonnull const AWSSignatureV4PayloadFileURLKey;
+
+/**
+ The `NSURLProtocol` property set by the signers to the time in seconds (an `NSNumber`) spent waiting for credentials
+ before signing a request. Reported as the credentials wait of `AWSNetworkingRequestMetrics`.
+ */
+FOUNDATION_EXPORT NSString * _Nonnull const AWSSignatureCredentialsWaitDurationKey;
+
+/**
+ How `AWSSignatureV4Signer` signs the payload of S3 requests.
+ */
+typedef NS_ENUM(NSInteger, AWSSignatureV4PayloadSigningMode) {
+    /**
+     The payload is signed: with its SHA-256 when it is known up front, or chunk by chunk when it is streamed.
+     */
+    AWSSignatureV4PayloadSigningModeSigned,
+    /**
+     The payload is sent with `UNSIGNED-PAYLOAD` and relies on TLS for integrity. Only used for HTTPS requests.
+     */
+    AWSSignatureV4PayloadSigningModeUnsigned,
+    /**
+     Streamed payloads are sent unsigned in aws-chunked encoding, followed by a checksum trailer computed while they
+     are sent. Payloads known up front are sent with `UNSIGNED-PAYLOAD` and a checksum header. Only used for HTTPS
+     requests.
+     */
+    AWSSignatureV4PayloadSigningModeTrailingChecksum,
+};
 
 @class AWSEndpoint;
 
@@ -29,6 +62,17 @@ FOUNDATION_EXPORT NSString * _Nonnull const AWSSignatureV4Terminator;
 + (NSString * _Nonnull)hashString:(NSString * _Nullable)stringToHash;
 + (NSData * _Nonnull)hash:(NSData * _Nullable)dataToHash;
 + (NSString * _Nonnull)hexEncode:(NSString * _Nullable)string;
+/**
+ Returns the hex encoded SHA-256 of the contents of `stream`, read through a fixed size buffer. The stream is opened
+ and closed by this method.
+
+ @param stream A stream that has not been opened yet.
+ @param length Set to the number of bytes read from the stream.
+ @param error  Set when the stream could not be read.
+ */
++ (NSString * _Nullable)hexEncodedSHA256OfStream:(NSInputStream * _Nonnull)stream
+                                          length:(unsigned long long * _Nullable)length
+                                           error:(NSError * _Nullable __autoreleasing * _Nullable)error;
 + (NSString * _Nullable)HMACSign:(NSData * _Nullable)data withKey:(NSString * _Nonnull)key usingAlgorithm:(uint32_t)algorithm;
 
 @end
@@ -37,6 +81,26 @@ FOUNDATION_EXPORT NSString * _Nonnull const AWSSignatureV4Terminator;
 
 @property (nonatomic, strong, readonly) id<AWSCredentialsProvider> _Nonnull credentialsProvider;
 
+/**
+ How the payload of S3 requests is signed. The default is `AWSSignatureV4PayloadSigningModeSigned`.
+ */
+@property (nonatomic, assign) AWSSignatureV4PayloadSigningMode payloadSigningMode;
+
+/**
+ The checksum sent with the payload in `AWSSignatureV4PayloadSigningModeTrailingChecksum`. The default,
+ `AWSChecksumAlgorithmNone`, uses CRC32.
+ */
+@property (nonatomic, assign) AWSChecksumAlgorithm payloadChecksumAlgorithm;
+
+/**
+ Whether signed S3 payloads read from a file (see `AWSSignatureV4PayloadFileURLKey`) are hashed on a background queue
+ and signed with their SHA-256, instead of being sent aws-chunked. The default is `NO`.
+
+ The file is then read twice, once to hash it and once to send it, and the request is not sent before the whole file
+ is hashed. In exchange, the upload does not carry the aws-chunked framing and per-chunk signatures.
+ */
+@property (nonatomic, assign, getter=isPayloadFileHashingEnabled) BOOL payloadFileHashingEnabled;
+
 - (instancetype _Nonnull)initWithCredentialsProvider:(id<AWSCredentialsProvider> _Nonnull)credentialsProvider
                                    endpoint:(AWSEndpoint * _Nonnull)endpoint;
 
@@ -126,6 +190,28 @@ FOUNDATION_EXPORT NSString * _Nonnull const AWSSignatureV4Terminator;
 @interface AWSS3ChunkedEncodingInputStream : NSInputStream <NSStreamDelegate>
 
 @property (atomic, assign) int64_t totalLengthOfChunkSignatureSent;
+
+/**
+ * The number of payload bytes signed per chunk. At least 8 KB.
+ **/
+@property (nonatomic, assign, readonly) NSUInteger chunkSize;
+
+/**
+ * The chunk size used by streams created without an explicit chunk size,
+ * including the ones created by `AWSSignatureV4Signer` for S3 uploads.
+ * Values smaller than 8 KB are raised to 8 KB. Larger chunks mean fewer
+ * signatures to compute and send for large uploads.
+ **/
++ (NSUInteger)defaultChunkSize;
++ (void)setDefaultChunkSize:(NSUInteger)chunkSize;
+
+/**
+ * How long a read waits for the next chunk to be read from the original
+ * stream and signed before it fails with `ETIMEDOUT`. The default is 60
+ * seconds.
+ **/
+@property (nonatomic, assign) NSTimeInterval readTimeout;
+
 /**
  * Initialize the input stream with date, scope, signing key and signature
  * of request headers.
@@ -136,9 +222,34 @@ FOUNDATION_EXPORT NSString * _Nonnull const AWSSignatureV4Terminator;
                                      kSigning:(NSData * _Nullable)kSigning
                               headerSignature:(NSString * _Nullable)headerSignature;
 
+/**
+ * Initialize the input stream with date, scope, signing key, signature
+ * of request headers and the number of payload bytes per chunk.
+ **/
+- (instancetype _Nonnull )initWithInputStream:(NSInputStream * _Nonnull)stream
+                                         date:(NSDate * _Nullable)date
+                                        scope:(NSString * _Nullable)scope
+                                     kSigning:(NSData * _Nullable)kSigning
+                              headerSignature:(NSString * _Nullable)headerSignature
+                                    chunkSize:(NSUInteger)chunkSize;
+
+/**
+ * Initialize the input stream to send unsigned chunks followed by a trailer
+ * with the checksum of the data.
+ **/
+- (instancetype _Nonnull )initWithInputStream:(NSInputStream * _Nonnull)stream
+                            checksumAlgorithm:(AWSChecksumAlgorithm)checksumAlgorithm
+                                    chunkSize:(NSUInteger)chunkSize;
+
 /**
  * Computes new content length after data being chunked encoded.
  **/
 + (NSUInteger)computeContentLengthForChunkedData:(NSUInteger)dataLength;
 
+/**
+ * Computes new content length after data being chunked encoded with the given chunk size.
+ **/
++ (NSUInteger)computeContentLengthForChunkedData:(NSUInteger)dataLength
+                                       chunkSize:(NSUInteger)chunkSize;
+
 @end
@@ -21,10 +21,35 @@
 #import "AWSCocoaLumberjack.h"
 #import "AWSBolts.h"
 #import "AWSNetworkingHelpers.h"
+#import "AWSChecksum.h"
 
 static NSString *const AWSSigV4Marker = @"AWS4";
+static NSUInteger const AWSSignatureV4DerivedKeyCacheLimit = 64;
 NSString *const AWSSignatureV4Algorithm = @"AWS4-HMAC-SHA256";
 NSString *const AWSSignatureV4Terminator = @"aws4_request";
+NSString *const AWSSignatureV4PayloadFileURLKey = @"com.amazonaws.AWSSignatureV4PayloadFileURL";
+NSString *const AWSSignatureCredentialsWaitDurationKey = @"com.amazonaws.AWSSignatureCredentialsWaitDuration";
+
+// Size of the buffer used to hash payloads read from a stream.
+static NSUInteger const AWSSignatureV4PayloadHashBufferSize = 1024 * 1024;
+static const char AWSSignatureV4HexDigits[] = "0123456789abcdef";
+
+static void AWSSignatureV4HexEncode(const unsigned char *bytes, size_t length, char *hex) {
+    for (size_t i = 0; i < length; i++) {
+        hex[i * 2] = AWSSignatureV4HexDigits[bytes[i] >> 4];
+        hex[i * 2 + 1] = AWSSignatureV4HexDigits[bytes[i] & 0x0F];
+    }
+    hex[length * 2] = '\0';
+}
+
+static NSString *AWSSignatureV4HexEncodedSHA256(NSData *data) {
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    char hex[CC_SHA256_DIGEST_LENGTH * 2 + 1];
+    CC_SHA256([data bytes], (CC_LONG)[data length], digest);
+    AWSSignatureV4HexEncode(digest, CC_SHA256_DIGEST_LENGTH, hex);
+    return [NSString stringWithUTF8String:hex];
+}
+
 
 @implementation AWSSignatureSignerUtility
 
@@ -60,6 +85,47 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
     return [[NSData alloc] initWithBytes:result length:CC_SHA256_DIGEST_LENGTH];
 }
 
++ (NSString *)hexEncodedSHA256OfStream:(NSInputStream *)stream
+                               length:(unsigned long long *)length
+                                error:(NSError *__autoreleasing *)error {
+    uint8_t *buffer = malloc(AWSSignatureV4PayloadHashBufferSize);
+    if (buffer == NULL) {
+        [NSException raise:@"NSInternalInconsistencyException" format:@"failed malloc" arguments:nil];
+        return nil;
+    }
+
+    CC_SHA256_CTX sha256;
+    CC_SHA256_Init(&sha256);
+    unsigned long long totalLength = 0;
+    NSInteger read = 0;
+    [stream open];
+    while ((read = [stream read:buffer maxLength:AWSSignatureV4PayloadHashBufferSize]) > 0) {
+        CC_SHA256_Update(&sha256, buffer, (CC_LONG)read);
+        totalLength += read;
+    }
+    NSError *streamError = [stream streamError];
+    [stream close];
+    free(buffer);
+
+    if (read < 0) {
+        if (error) {
+            *error = streamError ?: [NSError errorWithDomain:NSCocoaErrorDomain
+                                                        code:NSFileReadUnknownError
+                                                    userInfo:nil];
+        }
+        return nil;
+    }
+
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    char hex[CC_SHA256_DIGEST_LENGTH * 2 + 1];
+    CC_SHA256_Final(digest, &sha256);
+    AWSSignatureV4HexEncode(digest, CC_SHA256_DIGEST_LENGTH, hex);
+    if (length) {
+        *length = totalLength;
+    }
+    return [NSString stringWithUTF8String:hex];
+}
+
 + (NSString *)hexEncode:(NSString *)string {
     NSUInteger len = [string length];
     if (len == 0) {
@@ -122,6 +188,299 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
 
 @end
 
+#pragma mark - AWSSignatureV4Canonicalizer
+
+static NSString *const AWSSignatureV4CanonicalizerThreadDictionaryKey = @"com.amazonaws.AWSSignatureV4Canonicalizer";
+
+typedef struct {
+    const char *name;
+    size_t nameLength;
+    const char *value;
+    size_t valueLength;
+} AWSSignatureV4Pair;
+
+static int AWSSignatureV4CompareBytes(const char *left, size_t leftLength, const char *right, size_t rightLength) {
+    int result = memcmp(left, right, MIN(leftLength, rightLength));
+    if (result != 0) {
+        return result;
+    }
+    return leftLength < rightLength ? -1 : (leftLength > rightLength ? 1 : 0);
+}
+
+static int AWSSignatureV4ComparePairs(const void *left, const void *right) {
+    const AWSSignatureV4Pair *leftPair = left;
+    const AWSSignatureV4Pair *rightPair = right;
+    int result = AWSSignatureV4CompareBytes(leftPair->name, leftPair->nameLength, rightPair->name, rightPair->nameLength);
+    if (result != 0) {
+        return result;
+    }
+    return AWSSignatureV4CompareBytes(leftPair->value, leftPair->valueLength, rightPair->value, rightPair->valueLength);
+}
+
+/**
+ Builds the canonical request and the string to sign into byte buffers reused by every request signed on the same
+ thread, instead of going through intermediate strings, arrays and predicates.
+ */
+@interface AWSSignatureV4Canonicalizer : NSObject
+
+@property (nonatomic, strong, readonly) NSString *signedHeaders;
+
++ (instancetype)canonicalizerForCurrentThread;
+
+- (void)canonicalizeMethod:(NSString *)method
+                      path:(NSString *)path
+                     query:(NSString *)query
+                   headers:(NSDictionary *)headers
+             contentSha256:(NSString *)contentSha256;
+
+- (NSString *)canonicalRequest;
+- (NSString *)canonicalizedQueryString:(NSString *)query;
+- (NSString *)canonicalizedHeaderString:(NSDictionary *)headers;
+
+- (NSString *)signatureWithKey:(NSData *)kSigning
+                       amzDate:(NSString *)amzDate
+                         scope:(NSString *)scope;
+
+@end
+
+@implementation AWSSignatureV4Canonicalizer {
+    NSMutableData *_buffer;
+    NSMutableData *_scratch;
+    NSMutableData *_pairs;
+}
+
++ (instancetype)canonicalizerForCurrentThread {
+    NSMutableDictionary *threadDictionary = [[NSThread currentThread] threadDictionary];
+    AWSSignatureV4Canonicalizer *canonicalizer = threadDictionary[AWSSignatureV4CanonicalizerThreadDictionaryKey];
+    if (!canonicalizer) {
+        canonicalizer = [AWSSignatureV4Canonicalizer new];
+        threadDictionary[AWSSignatureV4CanonicalizerThreadDictionaryKey] = canonicalizer;
+    }
+    return canonicalizer;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _buffer = [NSMutableData dataWithCapacity:1024];
+        _scratch = [NSMutableData dataWithCapacity:1024];
+        _pairs = [NSMutableData dataWithCapacity:16 * sizeof(AWSSignatureV4Pair)];
+    }
+    return self;
+}
+
+static void AWSSignatureV4AppendBytes(NSMutableData *buffer, const void *bytes, size_t length) {
+    [buffer appendBytes:bytes length:length];
+}
+
+static void AWSSignatureV4AppendString(NSMutableData *buffer, NSString *string) {
+    if ([string length] == 0) {
+        return;
+    }
+    NSUInteger offset = [buffer length];
+    NSUInteger maxLength = [string maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    [buffer setLength:offset + maxLength];
+    NSUInteger usedLength = 0;
+    [string getBytes:(char *)[buffer mutableBytes] + offset
+           maxLength:maxLength
+          usedLength:&usedLength
+            encoding:NSUTF8StringEncoding
+             options:0
+               range:NSMakeRange(0, [string length])
+      remainingRange:NULL];
+    [buffer setLength:offset + usedLength];
+}
+
+- (void)canonicalizeMethod:(NSString *)method
+                      path:(NSString *)path
+                     query:(NSString *)query
+                   headers:(NSDictionary *)headers
+             contentSha256:(NSString *)contentSha256 {
+    [_buffer setLength:0];
+
+    AWSSignatureV4AppendString(_buffer, method);
+    AWSSignatureV4AppendBytes(_buffer, "\n", 1);
+    AWSSignatureV4AppendString(_buffer, path); // Canonicalized resource path
+    AWSSignatureV4AppendBytes(_buffer, "\n", 1);
+    [self appendCanonicalizedQueryString:query]; // Canonicalized Query String
+    AWSSignatureV4AppendBytes(_buffer, "\n", 1);
+    [self appendCanonicalizedHeaders:headers];
+    AWSSignatureV4AppendBytes(_buffer, "\n", 1);
+    AWSSignatureV4AppendString(_buffer, contentSha256);
+}
+
+- (NSString *)canonicalRequest {
+    return [[NSString alloc] initWithData:_buffer encoding:NSUTF8StringEncoding];
+}
+
+- (NSString *)canonicalizedQueryString:(NSString *)query {
+    [_buffer setLength:0];
+    [self appendCanonicalizedQueryString:query];
+    return [[NSString alloc] initWithData:_buffer encoding:NSUTF8StringEncoding];
+}
+
+- (NSString *)canonicalizedHeaderString:(NSDictionary *)headers {
+    [_buffer setLength:0];
+    [self appendCanonicalizedHeaders:headers];
+    // Drop the signed headers line; only the canonical headers are returned.
+    NSString *canonicalizedHeaders = [[NSString alloc] initWithData:_buffer encoding:NSUTF8StringEncoding];
+    return [canonicalizedHeaders substringToIndex:[canonicalizedHeaders length] - [self.signedHeaders length] - 1];
+}
+
+// Sorts `key=value` pairs by key, then value, in strict byte order. Pairs with an empty key or more than one `=` are skipped.
+- (void)appendCanonicalizedQueryString:(NSString *)query {
+    [_scratch setLength:0];
+    AWSSignatureV4AppendString(_scratch, query);
+    const char *bytes = [_scratch bytes];
+    size_t length = [_scratch length];
+
+    [_pairs setLength:0];
+    size_t start = 0;
+    while (start <= length && length > 0) {
+        const char *end = memchr(bytes + start, '&', length - start);
+        size_t componentLength = end ? (size_t)(end - (bytes + start)) : length - start;
+        const char *component = bytes + start;
+        const char *separator = memchr(component, '=', componentLength);
+        BOOL hasSingleSeparator = !separator || !memchr(separator + 1, '=', componentLength - (separator + 1 - component));
+        size_t nameLength = separator ? (size_t)(separator - component) : componentLength;
+        if (hasSingleSeparator && nameLength > 0) {
+            AWSSignatureV4Pair pair = {component, nameLength, separator ? separator + 1 : "", separator ? componentLength - nameLength - 1 : 0};
+            [_pairs appendBytes:&pair length:sizeof(pair)];
+        }
+        start += componentLength + 1;
+    }
+
+    AWSSignatureV4Pair *pairs = [_pairs mutableBytes];
+    size_t count = [_pairs length] / sizeof(AWSSignatureV4Pair);
+    qsort(pairs, count, sizeof(AWSSignatureV4Pair), AWSSignatureV4ComparePairs);
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) {
+            AWSSignatureV4AppendBytes(_buffer, "&", 1);
+        }
+        AWSSignatureV4AppendBytes(_buffer, pairs[i].name, pairs[i].nameLength);
+        AWSSignatureV4AppendBytes(_buffer, "=", 1);
+        AWSSignatureV4AppendBytes(_buffer, pairs[i].value, pairs[i].valueLength);
+    }
+}
+
+// Appends the canonical headers followed by a blank line and the signed headers, and keeps the signed headers for the authorization header.
+- (void)appendCanonicalizedHeaders:(NSDictionary *)headers {
+    [_scratch setLength:0];
+    [_pairs setLength:0];
+
+    // Lowercased names and collapsed values are written to the scratch buffer first and referenced by offset, since
+    // the buffer may move while it grows.
+    NSCharacterSet *whitespaceChars = nil;
+    for (NSString *header in headers) {
+        NSString *value = [headers[header] description];
+
+        size_t nameOffset = [_scratch length];
+        AWSSignatureV4AppendString(_scratch, header);
+        char *name = (char *)[_scratch mutableBytes] + nameOffset;
+        size_t nameLength = [_scratch length] - nameOffset;
+        for (size_t i = 0; i < nameLength; i++) {
+            name[i] = (char)tolower((unsigned char)name[i]);
+        }
+
+        // SigV4 expects all whitespace in headers and values to be collapsed to a single space
+        size_t valueOffset = [_scratch length];
+        AWSSignatureV4AppendString(_scratch, value);
+        size_t valueLength = [_scratch length] - valueOffset;
+        const unsigned char *rawValue = (const unsigned char *)[_scratch bytes] + valueOffset;
+        BOOL isASCII = YES;
+        for (size_t i = 0; i < valueLength; i++) {
+            if (rawValue[i] >= 0x80) {
+                isASCII = NO;
+                break;
+            }
+        }
+        if (!isASCII) {
+            // Non-ASCII values may contain other Unicode whitespace; collapse them the way NSString does.
+            whitespaceChars = whitespaceChars ?: [NSCharacterSet whitespaceCharacterSet];
+            NSArray *parts = [value componentsSeparatedByCharactersInSet:whitespaceChars];
+            NSArray *nonWhitespace = [parts filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"SELF != ''"]];
+            [_scratch setLength:valueOffset];
+            AWSSignatureV4AppendString(_scratch, [nonWhitespace componentsJoinedByString:@" "]);
+        } else {
+            char *collapsed = (char *)[_scratch mutableBytes] + valueOffset;
+            size_t collapsedLength = 0;
+            BOOL pendingSpace = NO;
+            for (size_t i = 0; i < valueLength; i++) {
+                char c = collapsed[i];
+                if (c == ' ' || c == '\t') {
+                    pendingSpace = collapsedLength > 0;
+                    continue;
+                }
+                if (pendingSpace) {
+                    collapsed[collapsedLength++] = ' ';
+                    pendingSpace = NO;
+                }
+                collapsed[collapsedLength++] = c;
+            }
+            [_scratch setLength:valueOffset + collapsedLength];
+        }
+
+        AWSSignatureV4Pair pair = {(const char *)nameOffset, nameLength, (const char *)valueOffset, [_scratch length] - valueOffset};
+        [_pairs appendBytes:&pair length:sizeof(pair)];
+    }
+
+    const char *base = [_scratch bytes];
+    AWSSignatureV4Pair *pairs = [_pairs mutableBytes];
+    size_t count = [_pairs length] / sizeof(AWSSignatureV4Pair);
+    for (size_t i = 0; i < count; i++) {
+        pairs[i].name = base + (size_t)pairs[i].name;
+        pairs[i].value = base + (size_t)pairs[i].value;
+    }
+    qsort(pairs, count, sizeof(AWSSignatureV4Pair), AWSSignatureV4ComparePairs);
+
+    for (size_t i = 0; i < count; i++) {
+        AWSSignatureV4AppendBytes(_buffer, pairs[i].name, pairs[i].nameLength);
+        AWSSignatureV4AppendBytes(_buffer, ":", 1);
+        AWSSignatureV4AppendBytes(_buffer, pairs[i].value, pairs[i].valueLength);
+        AWSSignatureV4AppendBytes(_buffer, "\n", 1);
+    }
+    AWSSignatureV4AppendBytes(_buffer, "\n", 1);
+
+    size_t signedHeadersOffset = [_buffer length];
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) {
+            AWSSignatureV4AppendBytes(_buffer, ";", 1);
+        }
+        AWSSignatureV4AppendBytes(_buffer, pairs[i].name, pairs[i].nameLength);
+    }
+    _signedHeaders = [[NSString alloc] initWithBytes:(const char *)[_buffer bytes] + signedHeadersOffset
+                                              length:[_buffer length] - signedHeadersOffset
+                                            encoding:NSUTF8StringEncoding];
+}
+
+- (NSString *)signatureWithKey:(NSData *)kSigning
+                       amzDate:(NSString *)amzDate
+                         scope:(NSString *)scope {
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    char hex[CC_SHA256_DIGEST_LENGTH * 2 + 1];
+    CC_SHA256([_buffer bytes], (CC_LONG)[_buffer length], digest);
+    AWSSignatureV4HexEncode(digest, CC_SHA256_DIGEST_LENGTH, hex);
+
+    [_scratch setLength:0];
+    AWSSignatureV4AppendString(_scratch, AWSSignatureV4Algorithm);
+    AWSSignatureV4AppendBytes(_scratch, "\n", 1);
+    AWSSignatureV4AppendString(_scratch, amzDate);
+    AWSSignatureV4AppendBytes(_scratch, "\n", 1);
+    AWSSignatureV4AppendString(_scratch, scope);
+    AWSSignatureV4AppendBytes(_scratch, "\n", 1);
+    AWSSignatureV4AppendBytes(_scratch, hex, CC_SHA256_DIGEST_LENGTH * 2);
+
+    if ([AWSDDLog sharedInstance].logLevel & AWSDDLogFlagVerbose) {
+        AWSDDLogVerbose(@"AWS4 Canonical Request: [%@]", [self canonicalRequest]);
+        AWSDDLogVerbose(@"AWS4 String to Sign: [%@]", [[NSString alloc] initWithData:_scratch encoding:NSUTF8StringEncoding]);
+    }
+
+    CCHmac(kCCHmacAlgSHA256, [kSigning bytes], [kSigning length], [_scratch bytes], [_scratch length], digest);
+    AWSSignatureV4HexEncode(digest, CC_SHA256_DIGEST_LENGTH, hex);
+    return [NSString stringWithUTF8String:hex];
+}
+
+@end
+
 #pragma mark - AWSSignatureV4Signer
 
 @interface AWSSignatureV4Signer()
@@ -151,7 +510,39 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
 
 - (AWSTask *)interceptRequest:(NSMutableURLRequest *)request {
     [request setValue:request.URL.host forHTTPHeaderField:@"Host"];
-    return [[self.credentialsProvider credentials] continueWithSuccessBlock:^id _Nullable(AWSTask<AWSCredentials *> * _Nonnull task) {
+
+    CFAbsoluteTime credentialsStart = CFAbsoluteTimeGetCurrent();
+    AWSTask<AWSCredentials *> *credentialsTask = [[self.credentialsProvider credentials] continueWithBlock:^id _Nullable(AWSTask<AWSCredentials *> * _Nonnull task) {
+        [NSURLProtocol setProperty:@(CFAbsoluteTimeGetCurrent() - credentialsStart)
+                            forKey:AWSSignatureCredentialsWaitDurationKey
+                         inRequest:request];
+        return task;
+    }];
+
+    // When enabled, a payload read from a file is hashed in bounded memory on a background queue while the
+    // credentials are retrieved, so the request can be signed with the payload hash instead of being sent aws-chunked.
+    NSString *payloadFileURLString = [NSURLProtocol propertyForKey:AWSSignatureV4PayloadFileURLKey inRequest:request];
+    NSURL *payloadFileURL = payloadFileURLString ? [NSURL URLWithString:payloadFileURLString] : nil;
+    AWSTask<NSString *> *payloadHashTask = [AWSTask taskWithResult:nil];
+    __block unsigned long long payloadLength = 0;
+    if (self.payloadFileHashingEnabled && payloadFileURL && request.HTTPBodyStream
+        && [self payloadSigningModeForRequest:request] == AWSSignatureV4PayloadSigningModeSigned) {
+        AWSExecutor *hashingExecutor = [AWSExecutor executorWithDispatchQueue:dispatch_get_global_queue(QOS_CLASS_UTILITY, 0)];
+        payloadHashTask = [AWSTask taskFromExecutor:hashingExecutor withBlock:^id{
+            NSError *error = nil;
+            NSString *payloadSha256 = [AWSSignatureSignerUtility hexEncodedSHA256OfStream:[NSInputStream inputStreamWithURL:payloadFileURL]
+                                                                                   length:&payloadLength
+                                                                                    error:&error];
+            if (!payloadSha256) {
+                AWSDDLogWarn(@"Failed to hash the payload at %@, sending it aws-chunked instead: %@", payloadFileURL, error);
+            }
+            return payloadSha256;
+        }];
+    }
+
+    return [[payloadHashTask continueWithBlock:^id _Nullable(AWSTask<NSString *> * _Nonnull task) {
+        return credentialsTask;
+    }] continueWithSuccessBlock:^id _Nullable(AWSTask<AWSCredentials *> * _Nonnull task) {
         AWSCredentials *credentials = task.result;
         // clear authorization header if set
         [request setValue:nil forHTTPHeaderField:@"Authorization"];
@@ -165,7 +556,9 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
                 ([hostArray firstObject] && [[hostArray firstObject] rangeOfString:@"s3"].location != NSNotFound) ) {
                 //If it is a S3 Request
                 authorization = [self signS3RequestV4:request
-                                         credentials:credentials];
+                                         credentials:credentials
+                                       payloadSha256:payloadHashTask.result
+                                       payloadLength:payloadLength];
             } else {
                 authorization = [self signRequestV4:request
                                        credentials:credentials];
@@ -179,8 +572,28 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
     }];
 }
 
+// Unsigned payloads rely on TLS for integrity, so plain HTTP requests are always signed.
+- (AWSSignatureV4PayloadSigningMode)payloadSigningModeForRequest:(NSURLRequest *)request {
+    if ([[request.URL scheme] caseInsensitiveCompare:@"https"] != NSOrderedSame) {
+        return AWSSignatureV4PayloadSigningModeSigned;
+    }
+    return self.payloadSigningMode;
+}
+
 - (NSString *)signS3RequestV4:(NSMutableURLRequest *)urlRequest
                   credentials:(AWSCredentials *)credentials {
+    return [self signS3RequestV4:urlRequest
+                     credentials:credentials
+                   payloadSha256:nil
+                   payloadLength:0];
+}
+
+// `payloadSha256` is the hash of the body stream when it has already been computed, in which case the stream is sent
+// as is with its length instead of being signed chunk by chunk.
+- (NSString *)signS3RequestV4:(NSMutableURLRequest *)urlRequest
+                  credentials:(AWSCredentials *)credentials
+                payloadSha256:(NSString *)payloadSha256
+                payloadLength:(unsigned long long)payloadLength {
     if ([urlRequest valueForHTTPHeaderField:@"Content-Type"] == nil) {
         [urlRequest addValue:@"binary/octet-stream" forHTTPHeaderField:@"Content-Type"];
     }
@@ -223,7 +636,33 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
     NSString *contentSha256;
     NSInputStream *stream = [urlRequest HTTPBodyStream];
     NSUInteger contentLength = [[urlRequest allHTTPHeaderFields][@"Content-Length"] integerValue];
-    if (nil != stream) {
+    AWSSignatureV4PayloadSigningMode payloadSigningMode = [self payloadSigningModeForRequest:urlRequest];
+    AWSChecksum *checksum = nil;
+    if (payloadSigningMode == AWSSignatureV4PayloadSigningModeTrailingChecksum) {
+        checksum = [AWSChecksum checksumWithAlgorithm:self.payloadChecksumAlgorithm] ?: [AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmCRC32];
+    }
+
+    if (nil != stream && nil != payloadSha256) {
+        contentSha256 = payloadSha256;
+        [urlRequest setValue:[NSString stringWithFormat:@"%llu", payloadLength] forHTTPHeaderField:@"Content-Length"];
+        stream = nil;
+    } else if (nil != stream && payloadSigningMode == AWSSignatureV4PayloadSigningModeUnsigned) {
+        contentSha256 = @"UNSIGNED-PAYLOAD";
+        if (contentLength == 0) {
+            [urlRequest setValue:nil forHTTPHeaderField:@"Content-Length"];
+        }
+        stream = nil;
+    } else if (nil != stream && nil != checksum) {
+        contentSha256 = @"STREAMING-UNSIGNED-PAYLOAD-TRAILER";
+        [urlRequest setValue:nil forHTTPHeaderField:@"Content-Length"]; //remove Content-Length header if it is a HTTPBodyStream
+        [urlRequest addValue:@"aws-chunked" forHTTPHeaderField:@"Content-Encoding"];
+        [urlRequest setValue:[NSString stringWithFormat:@"%lu", (unsigned long)contentLength] forHTTPHeaderField:@"x-amz-decoded-content-length"];
+        [urlRequest setValue:[AWSChecksum headerNameForAlgorithm:checksum.algorithm] forHTTPHeaderField:@"x-amz-trailer"];
+        [urlRequest setHTTPBodyStream:[[AWSS3ChunkedEncodingInputStream alloc] initWithInputStream:stream
+                                                                                  checksumAlgorithm:checksum.algorithm
+                                                                                          chunkSize:[AWSS3ChunkedEncodingInputStream defaultChunkSize]]];
+        stream = nil;
+    } else if (nil != stream) {
         contentSha256 = @"STREAMING-AWS4-HMAC-SHA256-PAYLOAD";
         [urlRequest setValue:[NSString stringWithFormat:@"%lu", (unsigned long)[AWSS3ChunkedEncodingInputStream computeContentLengthForChunkedData:contentLength]]
           forHTTPHeaderField:@"Content-Length"];
@@ -231,7 +670,15 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
         [urlRequest addValue:@"aws-chunked" forHTTPHeaderField:@"Content-Encoding"]; //add aws-chunked keyword for s3 chunk upload
         [urlRequest setValue:[NSString stringWithFormat:@"%lu", (unsigned long)contentLength] forHTTPHeaderField:@"x-amz-decoded-content-length"];
     } else {
-        contentSha256 = [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:[AWSSignatureSignerUtility hash:[urlRequest HTTPBody]] encoding:NSASCIIStringEncoding]];
+        if (payloadSigningMode == AWSSignatureV4PayloadSigningModeSigned) {
+            contentSha256 = AWSSignatureV4HexEncodedSHA256([urlRequest HTTPBody]);
+        } else {
+            contentSha256 = @"UNSIGNED-PAYLOAD";
+            if (checksum && [[urlRequest HTTPBody] length] > 0) {
+                [checksum updateWithData:[urlRequest HTTPBody]];
+                [urlRequest setValue:[checksum base64EncodedChecksum] forHTTPHeaderField:[AWSChecksum headerNameForAlgorithm:checksum.algorithm]];
+            }
+        }
         //using Content-Length with value of '0' cause auth issue, remove it.
         if (contentLength == 0) {
             [urlRequest setValue:nil forHTTPHeaderField:@"Content-Length"];
@@ -255,36 +702,26 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
         
     }
     
-    NSMutableDictionary *headers = [[urlRequest allHTTPHeaderFields] mutableCopy];
-
-    NSString *canonicalRequest = [AWSSignatureV4Signer getCanonicalizedRequest:httpMethod
-                                                                          path:path
-                                                                         query:query
-                                                                       headers:headers
-                                                                 contentSha256:contentSha256];
-    AWSDDLogVerbose(@"Canonical request: [%@]", canonicalRequest);
-
-    NSString *stringToSign = [NSString stringWithFormat:@"%@\n%@\n%@\n%@",
-                              AWSSignatureV4Algorithm,
-                              [urlRequest valueForHTTPHeaderField:@"X-Amz-Date"],
-                              scope,
-                              [AWSSignatureSignerUtility hexEncode:[AWSSignatureSignerUtility hashString:canonicalRequest]]];
-    AWSDDLogVerbose(@"AWS4 String to Sign: [%@]", stringToSign);
+    AWSSignatureV4Canonicalizer *canonicalizer = [AWSSignatureV4Canonicalizer canonicalizerForCurrentThread];
+    [canonicalizer canonicalizeMethod:httpMethod
+                                 path:path
+                                query:query
+                              headers:[urlRequest allHTTPHeaderFields]
+                        contentSha256:contentSha256];
 
     NSData *kSigning  = [AWSSignatureV4Signer getV4DerivedKey:credentials.secretKey
                                                          date:dateStamp
                                                        region:self.endpoint.regionName
                                                       service:self.endpoint.serviceName];
 
-    NSData *signature = [AWSSignatureSignerUtility sha256HMacWithData:[stringToSign dataUsingEncoding:NSUTF8StringEncoding]
-                                                              withKey:kSigning];
-    NSString *signatureString = [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:signature
-                                                                                           encoding:NSASCIIStringEncoding]];
+    NSString *signatureString = [canonicalizer signatureWithKey:kSigning
+                                                        amzDate:[urlRequest valueForHTTPHeaderField:@"X-Amz-Date"]
+                                                          scope:scope];
 
     NSString *authorization = [NSString stringWithFormat:@"%@ Credential=%@, SignedHeaders=%@, Signature=%@",
                                AWSSignatureV4Algorithm,
                                signingCredentials,
-                               [AWSSignatureV4Signer getSignedHeadersString:headers],
+                               canonicalizer.signedHeaders,
                                signatureString];
 
     if (nil != stream) {
@@ -324,16 +761,14 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
         query = [NSString stringWithFormat:@""];
     }
 
-    NSString *contentSha256 = [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:[AWSSignatureSignerUtility hash:request.HTTPBody] encoding:NSASCIIStringEncoding]];
-
-    NSString *canonicalRequest = [AWSSignatureV4Signer getCanonicalizedRequest:request.HTTPMethod
-                                                                          path:path
-                                                                         query:query
-                                                                       headers:request.allHTTPHeaderFields
-                                                                 contentSha256:contentSha256];
+    NSString *contentSha256 = AWSSignatureV4HexEncodedSHA256(request.HTTPBody);
 
-    AWSDDLogVerbose(@"AWS4 Canonical Request: [%@]", canonicalRequest);
-    AWSDDLogVerbose(@"payload %@",[[NSString alloc] initWithData:request.HTTPBody encoding:NSUTF8StringEncoding]);
+    AWSSignatureV4Canonicalizer *canonicalizer = [AWSSignatureV4Canonicalizer canonicalizerForCurrentThread];
+    [canonicalizer canonicalizeMethod:request.HTTPMethod
+                                 path:path
+                                query:query
+                              headers:request.allHTTPHeaderFields
+                        contentSha256:contentSha256];
 
     NSString *scope = [NSString stringWithFormat:@"%@/%@/%@/%@",
                        dateStamp,
@@ -343,30 +778,20 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
     NSString *signingCredentials = [NSString stringWithFormat:@"%@/%@",
                                     credentials.accessKey,
                                     scope];
-    NSString *stringToSign = [NSString stringWithFormat:@"%@\n%@\n%@\n%@",
-                              AWSSignatureV4Algorithm,
-                              [request valueForHTTPHeaderField:@"X-Amz-Date"],
-                              scope,
-                              [AWSSignatureSignerUtility hexEncode:[AWSSignatureSignerUtility hashString:canonicalRequest]]];
-
-    AWSDDLogVerbose(@"AWS4 String to Sign: [%@]", stringToSign);
 
     NSData *kSigning  = [AWSSignatureV4Signer getV4DerivedKey:credentials.secretKey
                                                          date:dateStamp
                                                        region:self.endpoint.regionName
                                                       service:self.endpoint.signingName];
-    NSData *signature = [AWSSignatureSignerUtility sha256HMacWithData:[stringToSign dataUsingEncoding:NSUTF8StringEncoding]
-                                                              withKey:kSigning];
+    NSString *signatureString = [canonicalizer signatureWithKey:kSigning
+                                                        amzDate:[request valueForHTTPHeaderField:@"X-Amz-Date"]
+                                                          scope:scope];
 
-    NSString *credentialsAuthorizationHeader = [NSString stringWithFormat:@"Credential=%@", signingCredentials];
-    NSString *signedHeadersAuthorizationHeader = [NSString stringWithFormat:@"SignedHeaders=%@", [AWSSignatureV4Signer getSignedHeadersString:request.allHTTPHeaderFields]];
-    NSString *signatureAuthorizationHeader = [NSString stringWithFormat:@"Signature=%@", [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:signature encoding:NSASCIIStringEncoding]]];
-
-    NSString *authorization = [NSString stringWithFormat:@"%@ %@, %@, %@",
+    NSString *authorization = [NSString stringWithFormat:@"%@ Credential=%@, SignedHeaders=%@, Signature=%@",
                                AWSSignatureV4Algorithm,
-                               credentialsAuthorizationHeader,
-                               signedHeadersAuthorizationHeader,
-                               signatureAuthorizationHeader];
+                               signingCredentials,
+                               canonicalizer.signedHeaders,
+                               signatureString];
 
     return authorization;
 }
@@ -600,116 +1025,47 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
 }
 
 + (NSString *)getCanonicalizedRequest:(NSString *)method path:(NSString *)path query:(NSString *)query headers:(NSDictionary *)headers contentSha256:(NSString *)contentSha256 {
-    NSMutableString *canonicalRequest = [NSMutableString new];
-    [canonicalRequest appendString:method];
-    [canonicalRequest appendString:@"\n"];
-    [canonicalRequest appendString:path]; // Canonicalized resource path
-    [canonicalRequest appendString:@"\n"];
-
-    [canonicalRequest appendString:[AWSSignatureV4Signer getCanonicalizedQueryString:query]]; // Canonicalized Query String
-    [canonicalRequest appendString:@"\n"];
-
-    [canonicalRequest appendString:[AWSSignatureV4Signer getCanonicalizedHeaderString:headers]];
-    [canonicalRequest appendString:@"\n"];
-
-    [canonicalRequest appendString:[AWSSignatureV4Signer getSignedHeadersString:headers]];
-    [canonicalRequest appendString:@"\n"];
-
-    [canonicalRequest appendString:[NSString stringWithFormat:@"%@", contentSha256]];
-
-    return canonicalRequest;
+    AWSSignatureV4Canonicalizer *canonicalizer = [AWSSignatureV4Canonicalizer canonicalizerForCurrentThread];
+    [canonicalizer canonicalizeMethod:method
+                                 path:path
+                                query:query
+                              headers:headers
+                        contentSha256:contentSha256];
+    return [canonicalizer canonicalRequest];
 }
 
 + (NSString *)getCanonicalizedQueryString:(NSString *)query {
-    NSMutableDictionary<NSString *, NSMutableArray<NSString *> *> *queryDictionary = [NSMutableDictionary new];
-    [[query componentsSeparatedByString:@"&"] enumerateObjectsUsingBlock:^(id obj, NSUInteger idx, BOOL *stop) {
-        NSArray *components = [obj componentsSeparatedByString:@"="];
-        NSString *key;
-        NSString *value = @"";
-        NSUInteger count = [components count];
-        if (count > 0 && count <= 2) {
-            //can be ?a=b or ?a
-            key = components[0];
-            if  (! [key isEqualToString:@""] ) {
-                if (count == 2) {
-                    //is ?a=b
-                    value = components[1];
-                }
-                if (queryDictionary[key]) {
-                    // If the query parameter has multiple values, add it in the mutable array
-                    [[queryDictionary objectForKey:key] addObject:value];
-                } else {
-                    // Insert the value for query parameter as an element in mutable array
-                    [queryDictionary setObject:[@[value] mutableCopy] forKey:key];
-                }
-            }
-        }
-    }];
-
-    NSMutableArray *sortedQuery = [[NSMutableArray alloc] initWithArray:[queryDictionary allKeys]];
-
-    [sortedQuery sortUsingSelector:@selector(compare:)];
-
-    NSMutableString *sortedQueryString = [NSMutableString new];
-    for (NSString *key in sortedQuery) {
-        [queryDictionary[key] sortUsingSelector:@selector(compare:)];
-        for (NSString *parameterValue in queryDictionary[key]) {
-            [sortedQueryString appendString:key];
-            [sortedQueryString appendString:@"="];
-            [sortedQueryString appendString:parameterValue];
-            [sortedQueryString appendString:@"&"];
-        }
-    }
-    // Remove the trailing & for a valid canonical query string.
-    if ([sortedQueryString hasSuffix:@"&"]) {
-        return [sortedQueryString substringToIndex:[sortedQueryString length] - 1];
-    }
-
-    return sortedQueryString;
+    return [[AWSSignatureV4Canonicalizer canonicalizerForCurrentThread] canonicalizedQueryString:query];
 }
 
 + (NSString *)getCanonicalizedHeaderString:(NSDictionary *)headers {
-    NSCharacterSet *whitespaceChars = [NSCharacterSet whitespaceCharacterSet];
-
-    NSMutableArray *sortedHeaders = [[NSMutableArray alloc] initWithArray:[headers allKeys]];
-
-    [sortedHeaders sortUsingSelector:@selector(caseInsensitiveCompare:)];
-
-    NSMutableString *headerString = [NSMutableString new];
-    for (NSString *header in sortedHeaders) {
-        NSString *value = [headers valueForKey:header];
-        value = [value stringByTrimmingCharactersInSet:whitespaceChars];
-        [headerString appendString:[header lowercaseString]];
-        [headerString appendString:@":"];
-        [headerString appendString:value];
-        [headerString appendString:@"\n"];
-    }
-
-    // SigV4 expects all whitespace in headers and values to be collapsed to a single space
-    NSPredicate *noEmptyStrings = [NSPredicate predicateWithFormat:@"SELF != ''"];
-
-    NSArray *parts = [headerString componentsSeparatedByCharactersInSet:whitespaceChars];
-    NSArray *nonWhitespace = [parts filteredArrayUsingPredicate:noEmptyStrings];
-    return [nonWhitespace componentsJoinedByString:@" "];
+    return [[AWSSignatureV4Canonicalizer canonicalizerForCurrentThread] canonicalizedHeaderString:headers];
 }
 
 + (NSString *)getSignedHeadersString:(NSDictionary *)headers {
-    NSMutableArray *sortedHeaders = [[NSMutableArray alloc] initWithArray:[headers allKeys]];
-
-    [sortedHeaders sortUsingSelector:@selector(caseInsensitiveCompare:)];
+    AWSSignatureV4Canonicalizer *canonicalizer = [AWSSignatureV4Canonicalizer canonicalizerForCurrentThread];
+    [canonicalizer canonicalizedHeaderString:headers];
+    return canonicalizer.signedHeaders;
+}
 
-    NSMutableString *headerString = [NSMutableString new];
-    for (NSString *header in sortedHeaders) {
-        if ([headerString length] > 0) {
-            [headerString appendString:@";"];
++ (NSData *)getV4DerivedKey:(NSString *)secret date:(NSString *)dateStamp region:(NSString *)regionName service:(NSString *)serviceName {
+    // The derived key only changes with the date, region and service, so it is cached across requests.
+    static NSMutableDictionary<NSString *, NSArray *> *derivedKeys = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        derivedKeys = [NSMutableDictionary new];
+    });
+
+    NSString *cacheKey = [NSString stringWithFormat:@"%@/%@/%@", dateStamp, regionName, serviceName];
+    if (secret) {
+        @synchronized(derivedKeys) {
+            NSArray *cachedKey = derivedKeys[cacheKey];
+            if (cachedKey && [cachedKey[0] isEqualToString:secret]) {
+                return cachedKey[1];
+            }
         }
-        [headerString appendString:[header lowercaseString]];
     }
 
-    return headerString;
-}
-
-+ (NSData *)getV4DerivedKey:(NSString *)secret date:(NSString *)dateStamp region:(NSString *)regionName service:(NSString *)serviceName {
     // AWS4 uses a series of derived keys, formed by hashing different pieces of data
     NSString *kSecret = [NSString stringWithFormat:@"%@%@", AWSSigV4Marker, secret];
     NSData *kDate = [AWSSignatureSignerUtility sha256HMacWithData:[dateStamp dataUsingEncoding:NSUTF8StringEncoding]
@@ -721,7 +1077,16 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
     NSData *kSigning = [AWSSignatureSignerUtility sha256HMacWithData:[AWSSignatureV4Terminator dataUsingEncoding:NSUTF8StringEncoding]
                                                              withKey:kService];
 
-    //TODO: cache this derived key?
+    if (secret) {
+        @synchronized(derivedKeys) {
+            // Keys of previous days are never used again; keep the cache bounded.
+            if ([derivedKeys count] >= AWSSignatureV4DerivedKeyCacheLimit) {
+                [derivedKeys removeAllObjects];
+            }
+            derivedKeys[cacheKey] = @[[secret copy], kSigning];
+        }
+    }
+
     return kSigning;
 }
 
@@ -794,7 +1159,11 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
 }
 
 - (AWSTask *)interceptRequest:(NSMutableURLRequest *)request {
+    CFAbsoluteTime credentialsStart = CFAbsoluteTimeGetCurrent();
     return [[self.credentialsProvider credentials] continueWithSuccessBlock:^id _Nullable(AWSTask<AWSCredentials *> * _Nonnull task) {
+        [NSURLProtocol setProperty:@(CFAbsoluteTimeGetCurrent() - credentialsStart)
+                            forKey:AWSSignatureCredentialsWaitDurationKey
+                         inRequest:request];
         AWSCredentials *credentials = task.result;
 
         NSString *HTTPBodyString = [[NSString alloc] initWithData:request.HTTPBody
@@ -832,22 +1201,46 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
 
 #pragma mark - S3ChunkedEncodingInputStream
 
+static NSUInteger const AWSS3ChunkedEncodingMinimumChunkSize = 8 * 1024;
+static NSUInteger const AWSS3ChunkedEncodingBufferCount = 2;
+// <chunk size in hex>;chunk-signature=<sha256>\r\n without the chunk size digits
+static NSUInteger const AWSS3ChunkedEncodingHeaderLength = 17 + CC_SHA256_DIGEST_LENGTH * 2 + 2;
 static NSUInteger defaultChunkSize = 32 * 1024 - 91;
+static NSTimeInterval const AWSS3ChunkedEncodingDefaultReadTimeout = 60;
 static NSString *const emptyStringSha256 = @"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
 
+typedef NS_ENUM(NSInteger, AWSS3ChunkedEncodingBufferStatus) {
+    AWSS3ChunkedEncodingBufferStatusChunk,
+    AWSS3ChunkedEncodingBufferStatusFinalChunk,
+    AWSS3ChunkedEncodingBufferStatusExhausted,
+    AWSS3ChunkedEncodingBufferStatusError,
+};
+
+// One signed chunk: header, data and trailer are laid out contiguously in `bytes[start..<end]`.
+typedef struct {
+    uint8_t *bytes;
+    size_t start;
+    size_t end;
+    size_t dataLength;
+    AWSS3ChunkedEncodingBufferStatus status;
+} AWSS3ChunkedEncodingBuffer;
+
+static NSUInteger AWSS3ChunkedEncodingHexDigits(NSUInteger dataLength) {
+    // The chunk size is written with at least 6 hex digits.
+    NSUInteger digits = 6;
+    while (digits < sizeof(NSUInteger) * 2 && (dataLength >> (digits * 4)) > 0) {
+        digits++;
+    }
+    return digits;
+}
+
 @interface AWSS3ChunkedEncodingInputStream()
 
 // original input stream
 @property (nonatomic, strong) NSInputStream *stream;
 
-// buffer for chunked data plus header
-@property (nonatomic, strong) NSMutableData *chunkData;
-
-// Mark the location of chunkData to be read
-@property (nonatomic, assign) NSUInteger location;
-
 // A flag indicates end of stream
-@property (nonatomic, assign) BOOL endOfStream;
+@property (atomic, assign) BOOL endOfStream;
 
 // SigV4 related properties
 // Date, used in signing
@@ -856,39 +1249,129 @@ static NSString *const emptyStringSha256 = @"e3b0c44298fc1c149afbf4c8996fb92427a
 // Keypath/Scope
 @property (nonatomic, strong) NSString *scope;
 
-// Signature of previous chunk. It's initialized as that of headers.
-@property (nonatomic, strong) NSString *priorSha256;
-
 // SigV4 signing key
 @property (nonatomic, strong) NSData *kSigning;
 
 @end
 
-@implementation AWSS3ChunkedEncodingInputStream
+@implementation AWSS3ChunkedEncodingInputStream {
+    // Chunks are read from the original stream and signed on `_signingQueue` into a fixed ring of buffers, one ahead
+    // of the buffer being read, so reading and hashing the next chunk overlaps with sending the current one. The
+    // original stream is opened, read and closed only on `_signingQueue`, and is never scheduled on a run loop.
+    AWSS3ChunkedEncodingBuffer _buffers[AWSS3ChunkedEncodingBufferCount];
+    NSArray<dispatch_semaphore_t> *_bufferReady;
+    size_t _bufferCapacity;
+    size_t _dataOffset;
+    NSUInteger _readIndex;
+    BOOL _hasCurrentBuffer;
+    BOOL _started;
+
+    dispatch_queue_t _signingQueue;
+    // Only accessed on `_signingQueue`.
+    BOOL _sourceExhausted;
+    char _priorSignature[CC_SHA256_DIGEST_LENGTH * 2 + 1];
+    // "AWS4-HMAC-SHA256-PAYLOAD\n<date>\n<scope>\n"
+    NSData *_stringToSignPrefix;
+    // Set for unsigned chunks that end with a checksum trailer instead of being signed.
+    AWSChecksum *_checksum;
+    // Set on `_signingQueue` when reading the original stream fails.
+    NSError *_sourceError;
+    volatile BOOL _closed;
+
+    NSStreamStatus _status;
+    NSError *_error;
+}
 
 @synthesize delegate = _delegate;
 
++ (NSUInteger)defaultChunkSize {
+    return defaultChunkSize;
+}
+
++ (void)setDefaultChunkSize:(NSUInteger)chunkSize {
+    defaultChunkSize = MAX(chunkSize, AWSS3ChunkedEncodingMinimumChunkSize);
+}
+
 - (instancetype)initWithInputStream:(NSInputStream *)stream
                                date:(NSDate *)date
                               scope:(NSString *)scope
                            kSigning:(NSData *)kSigning
                     headerSignature:(NSString *)headerSignature {
-    if (self = [super init]) {
-        _stream = stream;
-        _stream.delegate = self;
+    return [self initWithInputStream:stream
+                                date:date
+                               scope:scope
+                            kSigning:kSigning
+                     headerSignature:headerSignature
+                           chunkSize:defaultChunkSize];
+}
+
+- (instancetype)initWithInputStream:(NSInputStream *)stream
+                               date:(NSDate *)date
+                              scope:(NSString *)scope
+                           kSigning:(NSData *)kSigning
+                    headerSignature:(NSString *)headerSignature
+                          chunkSize:(NSUInteger)chunkSize {
+    if (self = [self initWithInputStream:stream chunkSize:chunkSize]) {
         _date = [date copy];
         _scope = [scope copy];
         _kSigning = [kSigning copy];
-        _priorSha256 = [headerSignature copy];
 
-        // Chunk size plus signature header
-        NSUInteger chunkSize = defaultChunkSize + [AWSS3ChunkedEncodingInputStream oneChunkedDataSize:defaultChunkSize];
-        _chunkData = [[NSMutableData alloc] initWithCapacity:chunkSize];
+        memset(_priorSignature, 0, sizeof(_priorSignature));
+        [[headerSignature ?: @"" dataUsingEncoding:NSASCIIStringEncoding] getBytes:_priorSignature
+                                                                              length:CC_SHA256_DIGEST_LENGTH * 2];
+        _priorSignature[CC_SHA256_DIGEST_LENGTH * 2] = '\0';
+        _stringToSignPrefix = [[NSString stringWithFormat:@"AWS4-HMAC-SHA256-PAYLOAD\n%@\n%@\n",
+                                [_date aws_stringValue:AWSDateISO8601DateFormat2],
+                                _scope] dataUsingEncoding:NSUTF8StringEncoding];
+    }
+
+    return self;
+}
+
+- (instancetype)initWithInputStream:(NSInputStream *)stream
+                  checksumAlgorithm:(AWSChecksumAlgorithm)checksumAlgorithm
+                          chunkSize:(NSUInteger)chunkSize {
+    if (self = [self initWithInputStream:stream chunkSize:chunkSize]) {
+        _checksum = [AWSChecksum checksumWithAlgorithm:checksumAlgorithm] ?: [AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmCRC32];
+    }
+
+    return self;
+}
+
+- (instancetype)initWithInputStream:(NSInputStream *)stream
+                          chunkSize:(NSUInteger)chunkSize {
+    if (self = [super init]) {
+        _stream = stream;
+        _stream.delegate = self;
+        _chunkSize = MAX(chunkSize, AWSS3ChunkedEncodingMinimumChunkSize);
+        _readTimeout = AWSS3ChunkedEncodingDefaultReadTimeout;
+        _status = NSStreamStatusNotOpen;
+
+        // The header is written right before the data once its length is known, so room for the longest one is kept.
+        // The data area is at least 8 KB, which is also enough for the checksum trailer of the final chunk.
+        _dataOffset = AWSS3ChunkedEncodingHexDigits(_chunkSize) + AWSS3ChunkedEncodingHeaderLength;
+        _bufferCapacity = _dataOffset + _chunkSize + 2;
+        NSMutableArray *bufferReady = [NSMutableArray arrayWithCapacity:AWSS3ChunkedEncodingBufferCount];
+        for (NSUInteger i = 0; i < AWSS3ChunkedEncodingBufferCount; i++) {
+            _buffers[i].bytes = malloc(_bufferCapacity);
+            if (_buffers[i].bytes == NULL) {
+                [NSException raise:@"NSInternalInconsistencyException" format:@"failed malloc" arguments:nil];
+            }
+            [bufferReady addObject:dispatch_semaphore_create(0)];
+        }
+        _bufferReady = bufferReady;
+        _signingQueue = dispatch_queue_create("com.amazonaws.AWSS3ChunkedEncodingInputStream", DISPATCH_QUEUE_SERIAL);
     }
 
     return self;
 }
 
+- (void)dealloc {
+    for (NSUInteger i = 0; i < AWSS3ChunkedEncodingBufferCount; i++) {
+        free(_buffers[i].bytes);
+    }
+}
+
 - (void)stream:(NSStream *)aStream handleEvent:(NSStreamEvent)eventCode {
     if ((eventCode & (1 << 4))) {
         // toggle the NSStreamEventEndEncountered bit.
@@ -899,93 +1382,170 @@ static NSString *const emptyStringSha256 = @"e3b0c44298fc1c149afbf4c8996fb92427a
     }
 }
 
-// Read next chunk of data from stream, and sign the chunk.
-// Returns YES on a successful read, NO otherwise.
-- (BOOL)nextChunk {
-    if (self.endOfStream) {
-        return NO;
-    }
-
-    // clear current chunkData for next chunk
-    [self.chunkData setLength:0];
-
-    uint8_t *chunkBuffer = calloc(defaultChunkSize, sizeof(uint8_t));
-    NSInteger read = [self.stream read:chunkBuffer maxLength:defaultChunkSize];
-
-    // mark end of stream if no data is read
-    self.endOfStream = (read <= 0);
+// Schedules the next chunk to be read from stream and signed into the buffer at `index`.
+- (void)fillBufferAtIndex:(NSUInteger)index {
+    dispatch_async(_signingQueue, ^{
+        [self signNextChunkIntoBuffer:&self->_buffers[index]];
+        dispatch_semaphore_signal(self->_bufferReady[index]);
+    });
+}
 
-    // return NO if stream read failed
-    if (read < 0) {
-        free(chunkBuffer);
-        AWSDDLogError(@"stream read failed streamStatus: %lu streamError: %@", (unsigned long)[self.stream streamStatus], [self.stream streamError].description);
-        return NO;
+// Reads next chunk of data from stream directly into the buffer, hashing it as it is read, and signs the chunk.
+- (void)signNextChunkIntoBuffer:(AWSS3ChunkedEncodingBuffer *)buffer {
+    if (_sourceExhausted || _closed) {
+        buffer->status = AWSS3ChunkedEncodingBufferStatusExhausted;
+        return;
     }
 
-    NSData *data = [NSData dataWithBytesNoCopy:chunkBuffer length:read];
-    [self.chunkData appendData:[self getSignedChunk:data]];
-
-    AWSDDLogVerbose(@"stream read: %ld, chunk size: %lu", (long)read, (unsigned long)[self.chunkData length]);
-
-    return YES;
-}
-
-// Signs data
-- (NSData *)getSignedChunk:(NSData *)data {
-    NSString *chunkSha256 = [self dataToHexString:[AWSSignatureSignerUtility hash:data]];
-    NSString *stringToSign = [NSString stringWithFormat:
-                              @"%@\n%@\n%@\n%@\n%@\n%@",
-                              @"AWS4-HMAC-SHA256-PAYLOAD",
-                              [self.date aws_stringValue:AWSDateISO8601DateFormat2],
-                              self.scope,
-                              self.priorSha256,
-                              emptyStringSha256,
-                              chunkSha256];
-    AWSDDLogVerbose(@"AWS4 String to Sign: [%@]", stringToSign);
+    CC_SHA256_CTX sha256;
+    CC_SHA256_Init(&sha256);
+    uint8_t *data = buffer->bytes + _dataOffset;
+    NSUInteger dataLength = 0;
+    while (dataLength < _chunkSize) {
+        NSInteger read = [self.stream read:data + dataLength maxLength:_chunkSize - dataLength];
+        if (read < 0) {
+            AWSDDLogError(@"stream read failed streamStatus: %lu streamError: %@", (unsigned long)[self.stream streamStatus], [self.stream streamError].description);
+            _sourceError = [self.stream streamError] ?: [NSError errorWithDomain:NSCocoaErrorDomain
+                                                                             code:NSFileReadUnknownError
+                                                                         userInfo:nil];
+            buffer->status = AWSS3ChunkedEncodingBufferStatusError;
+            _sourceExhausted = YES;
+            return;
+        }
+        if (read == 0) {
+            break;
+        }
+        if (_checksum) {
+            [_checksum updateWithBytes:data + dataLength length:read];
+        } else {
+            CC_SHA256_Update(&sha256, data + dataLength, (CC_LONG)read);
+        }
+        dataLength += read;
+    }
 
-    NSData *signature = [AWSSignatureSignerUtility sha256HMacWithData:[stringToSign dataUsingEncoding:NSUTF8StringEncoding]
-                                                              withKey:self.kSigning];
-    self.priorSha256 = [self dataToHexString:signature];
-    NSString *chunkedHeader = [NSString stringWithFormat:@"%06lx;chunk-signature=%@\r\n", (unsigned long)[data length], self.priorSha256];
-    AWSDDLogVerbose(@"AWS4 Chunked Header: [%@]", chunkedHeader);
+    buffer->dataLength = dataLength;
+    if (dataLength == 0) {
+        buffer->status = AWSS3ChunkedEncodingBufferStatusFinalChunk;
+        _sourceExhausted = YES;
+    } else {
+        buffer->status = AWSS3ChunkedEncodingBufferStatusChunk;
+    }
 
-    NSMutableData *signedChunk = [NSMutableData data];
-    [signedChunk appendData:[chunkedHeader dataUsingEncoding:NSUTF8StringEncoding]];
-    [signedChunk appendData:data];
-    [signedChunk appendData:[@"\r\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    if (_checksum) {
+        [self writeUnsignedChunkIntoBuffer:buffer];
+        return;
+    }
 
-    self.totalLengthOfChunkSignatureSent += [AWSS3ChunkedEncodingInputStream oneChunkedDataSize:0];
-    return signedChunk;
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    char chunkSha256[CC_SHA256_DIGEST_LENGTH * 2 + 1];
+    CC_SHA256_Final(digest, &sha256);
+    AWSSignatureV4HexEncode(digest, CC_SHA256_DIGEST_LENGTH, chunkSha256);
+
+    CCHmacContext hmac;
+    CCHmacInit(&hmac, kCCHmacAlgSHA256, [self.kSigning bytes], [self.kSigning length]);
+    CCHmacUpdate(&hmac, [_stringToSignPrefix bytes], [_stringToSignPrefix length]);
+    CCHmacUpdate(&hmac, _priorSignature, CC_SHA256_DIGEST_LENGTH * 2);
+    CCHmacUpdate(&hmac, "\n", 1);
+    CCHmacUpdate(&hmac, [emptyStringSha256 UTF8String], CC_SHA256_DIGEST_LENGTH * 2);
+    CCHmacUpdate(&hmac, "\n", 1);
+    CCHmacUpdate(&hmac, chunkSha256, CC_SHA256_DIGEST_LENGTH * 2);
+    CCHmacFinal(&hmac, digest);
+    AWSSignatureV4HexEncode(digest, CC_SHA256_DIGEST_LENGTH, _priorSignature);
+
+    // <chunk size in hex>;chunk-signature=<sha256>\r\n<data>\r\n
+    char header[32];
+    int sizeLength = snprintf(header, sizeof(header), "%06lx", (unsigned long)dataLength);
+    size_t headerLength = sizeLength + AWSS3ChunkedEncodingHeaderLength;
+    uint8_t *chunk = data - headerLength;
+    memcpy(chunk, header, sizeLength);
+    memcpy(chunk + sizeLength, ";chunk-signature=", 17);
+    memcpy(chunk + sizeLength + 17, _priorSignature, CC_SHA256_DIGEST_LENGTH * 2);
+    memcpy(data - 2, "\r\n", 2);
+    memcpy(data + dataLength, "\r\n", 2);
+
+    buffer->start = chunk - buffer->bytes;
+    buffer->end = _dataOffset + dataLength + 2;
+
+    AWSDDLogVerbose(@"stream read: %lu, chunk signature: %s", (unsigned long)dataLength, _priorSignature);
 }
 
-- (NSString *)dataToHexString:(NSData *) data {
-    return [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:data
-                                                                      encoding:NSASCIIStringEncoding]];
+// <chunk size in hex>\r\n<data>\r\n, and for the final chunk
+// 0\r\n<checksum header>:<base64 checksum>\r\n\r\n
+- (void)writeUnsignedChunkIntoBuffer:(AWSS3ChunkedEncodingBuffer *)buffer {
+    uint8_t *data = buffer->bytes + _dataOffset;
+    char header[32];
+    int headerLength = snprintf(header, sizeof(header), "%lx\r\n", (unsigned long)buffer->dataLength);
+    memcpy(data - headerLength, header, headerLength);
+    buffer->start = _dataOffset - headerLength;
+
+    if (buffer->status == AWSS3ChunkedEncodingBufferStatusFinalChunk) {
+        NSString *trailer = [NSString stringWithFormat:@"%@:%@\r\n\r\n",
+                             [AWSChecksum headerNameForAlgorithm:_checksum.algorithm],
+                             [_checksum base64EncodedChecksum]];
+        NSUInteger trailerLength = [trailer lengthOfBytesUsingEncoding:NSASCIIStringEncoding];
+        [trailer getCString:(char *)data maxLength:trailerLength + 1 encoding:NSASCIIStringEncoding];
+        buffer->end = _dataOffset + trailerLength;
+        AWSDDLogVerbose(@"AWS4 Chunked Trailer: [%@]", trailer);
+    } else {
+        memcpy(data + buffer->dataLength, "\r\n", 2);
+        buffer->end = _dataOffset + buffer->dataLength + 2;
+    }
 }
 
 #pragma mark NSInputStream methods
 
 - (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)len {
-    //change the defaultChunkSize according to caller reading capacity.
-    defaultChunkSize = len - [AWSS3ChunkedEncodingInputStream oneChunkedDataSize:0];
-    // check whether there is data available
-    if ([self.chunkData length] <= self.location) {
-        // set up next chunk
-        if ([self nextChunk]) {
-            // rewind location
-            self.location = 0;
-        } else {
+    if (self.endOfStream) {
+        return 0;
+    }
+    if (!_started) {
+        _started = YES;
+        for (NSUInteger i = 0; i < AWSS3ChunkedEncodingBufferCount; i++) {
+            [self fillBufferAtIndex:i];
+        }
+    }
+
+    AWSS3ChunkedEncodingBuffer *current = &_buffers[_readIndex];
+    if (!_hasCurrentBuffer) {
+        // A stalled original stream fails the read instead of blocking the thread of the session forever.
+        if (dispatch_semaphore_wait(_bufferReady[_readIndex], dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.readTimeout * NSEC_PER_SEC))) != 0) {
+            AWSDDLogError(@"Timed out after %.0f seconds waiting for the next chunk of the stream.", self.readTimeout);
+            _error = [NSError errorWithDomain:NSPOSIXErrorDomain code:ETIMEDOUT userInfo:nil];
+            _status = NSStreamStatusError;
+            self.endOfStream = YES;
+            return -1;
+        }
+        if (current->status == AWSS3ChunkedEncodingBufferStatusExhausted) {
+            self.endOfStream = YES;
+            _status = NSStreamStatusAtEnd;
             return 0;
         }
+        if (current->status == AWSS3ChunkedEncodingBufferStatusError) {
+            // The semaphore orders this read after the write of `_sourceError` on `_signingQueue`.
+            _error = _sourceError;
+            _status = NSStreamStatusError;
+            self.endOfStream = YES;
+            return -1;
+        }
+        _hasCurrentBuffer = YES;
+        self.totalLengthOfChunkSignatureSent += (current->end - current->start) - current->dataLength;
     }
 
     // compute how many bytes to read from chunk
-    NSUInteger length = MIN(len, [self.chunkData length] - self.location);
-    NSRange range = {self.location, length};
-    [self.chunkData getBytes:(void *)buffer range:range];
-
-    // Update location
-    self.location += length;
+    NSUInteger length = MIN(len, current->end - current->start);
+    memcpy(buffer, current->bytes + current->start, length);
+    current->start += length;
+
+    if (current->start == current->end) {
+        _hasCurrentBuffer = NO;
+        if (current->status == AWSS3ChunkedEncodingBufferStatusFinalChunk) {
+            self.endOfStream = YES;
+            _status = NSStreamStatusAtEnd;
+        } else {
+            [self fillBufferAtIndex:_readIndex];
+            _readIndex = (_readIndex + 1) % AWSS3ChunkedEncodingBufferCount;
+        }
+    }
 
     return length;
 }
@@ -999,11 +1559,21 @@ static NSString *const emptyStringSha256 = @"e3b0c44298fc1c149afbf4c8996fb92427a
 }
 
 - (void)open {
-    [self.stream open];
+    _status = NSStreamStatusOpen;
+    NSInputStream *stream = self.stream;
+    dispatch_async(_signingQueue, ^{
+        [stream open];
+    });
 }
 
 - (void)close {
-	[self.stream close];
+    // The original stream is closed after the chunk being signed, without waiting for a stalled read to return.
+    _closed = YES;
+    _status = NSStreamStatusClosed;
+    NSInputStream *stream = self.stream;
+    dispatch_async(_signingQueue, ^{
+        [stream close];
+    });
 }
 
 - (void)setDelegate:(id<NSStreamDelegate>)delegate {
@@ -1014,36 +1584,42 @@ static NSString *const emptyStringSha256 = @"e3b0c44298fc1c149afbf4c8996fb92427a
     }
 }
 
+// The original stream is read on `_signingQueue`, so it is not scheduled on the run loop of the session as well.
+// `read:maxLength:` blocks until the next chunk is signed, which the session handles like a synchronous stream.
 - (void)scheduleInRunLoop:(NSRunLoop *)aRunLoop forMode:(NSString *)mode {
-	[self.stream scheduleInRunLoop:aRunLoop forMode:mode];
 }
 
 - (void)removeFromRunLoop:(NSRunLoop *)aRunLoop forMode:(NSString *)mode {
-	[self.stream removeFromRunLoop:aRunLoop forMode:mode];
 }
 
+// Called by CFNetwork on the toll-free bridged stream. Without them, the calls would be forwarded to the original
+// stream by `forwardInvocation:` and schedule it on the run loop of the session.
+- (void)_scheduleInCFRunLoop:(CFRunLoopRef)runLoop forMode:(CFStringRef)mode {
+}
+
+- (void)_unscheduleFromCFRunLoop:(CFRunLoopRef)runLoop forMode:(CFStringRef)mode {
+}
+
+- (BOOL)_setCFClientFlags:(CFOptionFlags)flags callback:(CFReadStreamClientCallBack)callback context:(CFStreamClientContext *)context {
+    return NO;
+}
+
+// The offsets and properties of the original stream do not describe the chunked stream, and are only accessed on
+// `_signingQueue`.
 - (id)propertyForKey:(NSString *)key {
-	return [self.stream propertyForKey:key];
+    return nil;
 }
 
 - (BOOL)setProperty:(id)property forKey:(NSString *)key {
-	return [self.stream setProperty:property forKey:key];
+    return NO;
 }
 
 - (NSStreamStatus)streamStatus {
-    if ([self.stream streamStatus] == NSStreamStatusAtEnd) {
-        if (self.endOfStream) {
-            return [self.stream streamStatus];
-        } else {
-            return NSStreamStatusOpen;
-        }
-    } else {
-        return [self.stream streamStatus];
-    }
+    return _status;
 }
 
 - (NSError *)streamError {
-	return [self.stream streamError];
+    return _error;
 }
 
 - (NSMethodSignature *)methodSignatureForSelector:(SEL)aSelector {
@@ -1061,24 +1637,29 @@ static NSString *const emptyStringSha256 = @"e3b0c44298fc1c149afbf4c8996fb92427a
  * <data>\r\n
  **/
 + (NSUInteger)oneChunkedDataSize:(NSUInteger)dataLength {
-    return [[NSString stringWithFormat:@"%06lx;chunk-signature=%@\r\n",  (unsigned long)dataLength, emptyStringSha256] length] + dataLength + [@"\r\n" length];
+    return AWSS3ChunkedEncodingHexDigits(dataLength) + AWSS3ChunkedEncodingHeaderLength + dataLength + 2;
 }
 
 + (NSUInteger)computeContentLengthForChunkedData:(NSUInteger)dataLength {
+    return [self computeContentLengthForChunkedData:dataLength chunkSize:defaultChunkSize];
+}
+
++ (NSUInteger)computeContentLengthForChunkedData:(NSUInteger)dataLength chunkSize:(NSUInteger)chunkSize {
+    chunkSize = MAX(chunkSize, AWSS3ChunkedEncodingMinimumChunkSize);
     NSUInteger result = 0;
 
     // length of full chunks
-    result += (dataLength / defaultChunkSize) * [AWSS3ChunkedEncodingInputStream oneChunkedDataSize:defaultChunkSize];
-    
+    result += (dataLength / chunkSize) * [AWSS3ChunkedEncodingInputStream oneChunkedDataSize:chunkSize];
+
     // length of remaining data
-    NSUInteger remainingDataLength = dataLength % defaultChunkSize;
+    NSUInteger remainingDataLength = dataLength % chunkSize;
     if (remainingDataLength > 0) {
         result += [AWSS3ChunkedEncodingInputStream oneChunkedDataSize:remainingDataLength];
     }
-    
+
     // length of final chunk
     result += [AWSS3ChunkedEncodingInputStream oneChunkedDataSize:0];
-    
+
     return result;
 }
 
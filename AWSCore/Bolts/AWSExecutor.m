@@ -14,6 +14,10 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+// The stack of the current thread does not move or resize, so it is only looked up once per thread.
+static __thread uint8_t *awsbf_endStack = NULL;
+static __thread size_t awsbf_stackSize = 0;
+
 /*!
  Get the remaining stack-size of the current thread.
 
@@ -25,11 +29,15 @@ NS_ASSUME_NONNULL_BEGIN
  remaining stack space.
  */
 __attribute__((noinline)) static size_t remaining_stack_size(size_t *restrict totalSize) {
-    pthread_t currentThread = pthread_self();
-
-    // NOTE: We must store stack pointers as uint8_t so that the pointer math is well-defined
-    uint8_t *endStack = pthread_get_stackaddr_np(currentThread);
-    *totalSize = pthread_get_stacksize_np(currentThread);
+    if (!awsbf_endStack) {
+        pthread_t currentThread = pthread_self();
+
+        // NOTE: We must store stack pointers as uint8_t so that the pointer math is well-defined
+        awsbf_endStack = pthread_get_stackaddr_np(currentThread);
+        awsbf_stackSize = pthread_get_stacksize_np(currentThread);
+    }
+    uint8_t *endStack = awsbf_endStack;
+    *totalSize = awsbf_stackSize;
 
     // NOTE: If the function is inlined, this value could be incorrect
     uint8_t *frameAddr = __builtin_frame_address(0);
@@ -11,6 +11,8 @@
 #import "AWSTask.h"
 
 #import <libkern/OSAtomic.h>
+#import <pthread.h>
+#import <stdatomic.h>
 
 #import "AWSBolts.h"
 
@@ -26,21 +28,47 @@ NSInteger const kAWSMultipleErrorsError = 80175001;
 
 NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
 
+typedef NS_ENUM(int, AWSTaskState) {
+    AWSTaskStatePending,
+    // Claimed by the caller completing the task, which is setting the result or the error.
+    AWSTaskStateCompleting,
+    AWSTaskStateSucceeded,
+    AWSTaskStateFaulted,
+    AWSTaskStateCancelled,
+};
+
 @interface AWSTask () {
+    // Changes once from pending to completing with a compare-and-swap, so that reading the state, the result or the
+    // error never takes a lock.
+    _Atomic(int) _state;
     id _result;
     NSError *_error;
-}
 
-@property (nonatomic, assign, readwrite, getter=isCancelled) BOOL cancelled;
-@property (nonatomic, assign, readwrite, getter=isFaulted) BOOL faulted;
-@property (nonatomic, assign, readwrite, getter=isCompleted) BOOL completed;
-
-@property (nonatomic, strong) NSObject *lock;
-@property (nonatomic, strong) NSCondition *condition;
-@property (nonatomic, strong) NSMutableArray *callbacks;
+    // Guards the continuations and the condition, so that none is added after the task has run them.
+    pthread_mutex_t _mutex;
+    // Most tasks have a single continuation, which is stored inline. The others are wrapped in `_continuations`.
+    AWSExecutor *_continuationExecutor;
+    dispatch_block_t _continuation;
+    NSMutableArray<dispatch_block_t> *_continuations;
+    // Only created when a thread waits for the task.
+    NSCondition *_condition;
+}
 
 @end
 
+// Completes `taskCompletionSource` like `task`, which has completed.
+static void awsbf_completeTaskCompletionSource(AWSTaskCompletionSource *taskCompletionSource,
+                                               AWSTask *task,
+                                               AWSCancellationToken * _Nullable cancellationToken) {
+    if (cancellationToken.cancellationRequested || task.cancelled) {
+        [taskCompletionSource cancel];
+    } else if (task.error) {
+        taskCompletionSource.error = task.error;
+    } else {
+        taskCompletionSource.result = task.result;
+    }
+}
+
 @implementation AWSTask
 
 #pragma mark - Initializer
@@ -49,15 +77,14 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
     self = [super init];
     if (!self) return self;
 
-    _lock = [[NSObject alloc] init];
-    _condition = [[NSCondition alloc] init];
-    _callbacks = [NSMutableArray array];
+    atomic_init(&_state, AWSTaskStatePending);
+    pthread_mutex_init(&_mutex, NULL);
 
     return self;
 }
 
 - (instancetype)initWithResult:(nullable id)result {
-    self = [super init];
+    self = [self init];
     if (!self) return self;
 
     [self trySetResult:result];
@@ -66,7 +93,7 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
 }
 
 - (instancetype)initWithError:(NSError *)error {
-    self = [super init];
+    self = [self init];
     if (!self) return self;
 
     [self trySetError:error];
@@ -75,7 +102,7 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
 }
 
 - (instancetype)initCancelled {
-    self = [super init];
+    self = [self init];
     if (!self) return self;
 
     [self trySetCancelled];
@@ -83,6 +110,10 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
     return self;
 }
 
+- (void)dealloc {
+    pthread_mutex_destroy(&_mutex);
+}
+
 #pragma mark - Task Class methods
 
 + (instancetype)taskWithResult:(nullable id)result {
@@ -231,83 +262,111 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
 
 #pragma mark - Custom Setters/Getters
 
+- (AWSTaskState)state {
+    return atomic_load_explicit(&_state, memory_order_acquire);
+}
+
 - (nullable id)result {
-    @synchronized(self.lock) {
-        return _result;
-    }
+    return [self state] == AWSTaskStateSucceeded ? _result : nil;
 }
 
 - (BOOL)trySetResult:(nullable id)result {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        _result = result;
-        [self runContinuations];
-        return YES;
+    if (![self beginCompletion]) {
+        return NO;
     }
+    _result = result;
+    [self finishCompletionWithState:AWSTaskStateSucceeded];
+    return YES;
 }
 
 - (nullable NSError *)error {
-    @synchronized(self.lock) {
-        return _error;
-    }
+    return [self state] == AWSTaskStateFaulted ? _error : nil;
 }
 
 - (BOOL)trySetError:(NSError *)error {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.faulted = YES;
-        _error = error;
-        [self runContinuations];
-        return YES;
+    if (![self beginCompletion]) {
+        return NO;
     }
+    _error = error;
+    [self finishCompletionWithState:AWSTaskStateFaulted];
+    return YES;
 }
 
 - (BOOL)isCancelled {
-    @synchronized(self.lock) {
-        return _cancelled;
-    }
+    return [self state] == AWSTaskStateCancelled;
 }
 
 - (BOOL)isFaulted {
-    @synchronized(self.lock) {
-        return _faulted;
-    }
+    return [self state] == AWSTaskStateFaulted;
 }
 
 - (BOOL)trySetCancelled {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.cancelled = YES;
-        [self runContinuations];
-        return YES;
+    if (![self beginCompletion]) {
+        return NO;
     }
+    [self finishCompletionWithState:AWSTaskStateCancelled];
+    return YES;
 }
 
 - (BOOL)isCompleted {
-    @synchronized(self.lock) {
-        return _completed;
+    return [self state] >= AWSTaskStateSucceeded;
+}
+
+- (BOOL)beginCompletion {
+    int pending = AWSTaskStatePending;
+    return atomic_compare_exchange_strong(&_state, &pending, AWSTaskStateCompleting);
+}
+
+- (void)finishCompletionWithState:(AWSTaskState)state {
+    pthread_mutex_lock(&_mutex);
+    atomic_store_explicit(&_state, state, memory_order_release);
+    AWSExecutor *continuationExecutor = _continuationExecutor;
+    dispatch_block_t continuation = _continuation;
+    NSArray<dispatch_block_t> *continuations = _continuations;
+    NSCondition *condition = _condition;
+    _continuationExecutor = nil;
+    _continuation = nil;
+    _continuations = nil;
+    pthread_mutex_unlock(&_mutex);
+
+    // Continuations run without the lock, so that they can add continuations to this task.
+    if (condition) {
+        [condition lock];
+        [condition broadcast];
+        [condition unlock];
+    }
+    if (continuation) {
+        [continuationExecutor execute:continuation];
+    }
+    for (dispatch_block_t callback in continuations) {
+        callback();
     }
 }
 
-- (void)runContinuations {
-    @synchronized(self.lock) {
-        [self.condition lock];
-        [self.condition broadcast];
-        [self.condition unlock];
-        for (void (^callback)(void) in self.callbacks) {
-            callback();
+/**
+ Runs `block` with `executor` once the task has completed, right away when it already has.
+ */
+- (void)addContinuationWithExecutor:(AWSExecutor *)executor block:(dispatch_block_t)block {
+    if (![self isCompleted]) {
+        pthread_mutex_lock(&_mutex);
+        if (![self isCompleted]) {
+            if (!_continuation) {
+                _continuationExecutor = executor;
+                _continuation = block;
+            } else {
+                if (!_continuations) {
+                    _continuations = [NSMutableArray new];
+                }
+                [_continuations addObject:[^{
+                    [executor execute:block];
+                } copy]];
+            }
+            pthread_mutex_unlock(&_mutex);
+            return;
         }
-        [self.callbacks removeAllObjects];
+        pthread_mutex_unlock(&_mutex);
     }
+    [executor execute:block];
 }
 
 #pragma mark - Chaining methods
@@ -319,6 +378,20 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
 - (AWSTask *)continueWithExecutor:(AWSExecutor *)executor
                            block:(AWSContinuationBlock)block
                cancellationToken:(nullable AWSCancellationToken *)cancellationToken {
+    return [self continueWithExecutor:executor
+                                block:block
+                    cancellationToken:cancellationToken
+                          successOnly:NO];
+}
+
+/**
+ @param successOnly Whether `block` only runs when the task succeeded. Otherwise the returned task completes like this
+                    one, without the block being wrapped in another.
+ */
+- (AWSTask *)continueWithExecutor:(AWSExecutor *)executor
+                            block:(AWSContinuationBlock)block
+                cancellationToken:(nullable AWSCancellationToken *)cancellationToken
+                      successOnly:(BOOL)successOnly {
     AWSTaskCompletionSource *tcs = [AWSTaskCompletionSource taskCompletionSource];
 
     // Capture all of the state that needs to used when the continuation is complete.
@@ -327,27 +400,21 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
             [tcs cancel];
             return;
         }
+        if (successOnly && (self.faulted || self.cancelled)) {
+            awsbf_completeTaskCompletionSource(tcs, self, cancellationToken);
+            return;
+        }
 
         id result = block(self);
         if ([result isKindOfClass:[AWSTask class]]) {
-
-            id (^setupWithTask) (AWSTask *) = ^id(AWSTask *task) {
-                if (cancellationToken.cancellationRequested || task.cancelled) {
-                    [tcs cancel];
-                } else if (task.error) {
-                    tcs.error = task.error;
-                } else {
-                    tcs.result = task.result;
-                }
-                return nil;
-            };
-
             AWSTask *resultTask = (AWSTask *)result;
 
             if (resultTask.completed) {
-                setupWithTask(resultTask);
+                awsbf_completeTaskCompletionSource(tcs, resultTask, cancellationToken);
             } else {
-                [resultTask continueWithBlock:setupWithTask];
+                [resultTask addContinuationWithExecutor:[AWSExecutor defaultExecutor] block:^{
+                    awsbf_completeTaskCompletionSource(tcs, resultTask, cancellationToken);
+                }];
             }
 
         } else {
@@ -355,18 +422,7 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
         }
     };
 
-    BOOL completed;
-    @synchronized(self.lock) {
-        completed = self.completed;
-        if (!completed) {
-            [self.callbacks addObject:[^{
-                [executor execute:executionBlock];
-            } copy]];
-        }
-    }
-    if (completed) {
-        [executor execute:executionBlock];
-    }
+    [self addContinuationWithExecutor:executor block:executionBlock];
 
     return tcs.task;
 }
@@ -391,13 +447,10 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
         return [AWSTask cancelledTask];
     }
 
-    return [self continueWithExecutor:executor block:^id(AWSTask *task) {
-        if (task.faulted || task.cancelled) {
-            return task;
-        } else {
-            return block(task);
-        }
-    } cancellationToken:cancellationToken];
+    return [self continueWithExecutor:executor
+                                block:block
+                    cancellationToken:cancellationToken
+                          successOnly:YES];
 }
 
 - (AWSTask *)continueWithSuccessBlock:(AWSContinuationBlock)block {
@@ -419,35 +472,36 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
         [self warnOperationOnMainThread];
     }
 
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return;
-        }
-        [self.condition lock];
+    if (self.completed) {
+        return;
+    }
+    pthread_mutex_lock(&_mutex);
+    if (self.completed) {
+        pthread_mutex_unlock(&_mutex);
+        return;
     }
-    // TODO: (nlutsenko) Restructure this to use Bolts-Swift thread access synchronization architecture
-    // In the meantime, it's absolutely safe to get `_completed` aka an ivar, as long as it's a `BOOL` aka less than word size.
-    while (!_completed) {
-        [self.condition wait];
+    if (!_condition) {
+        _condition = [[NSCondition alloc] init];
     }
-    [self.condition unlock];
+    NSCondition *condition = _condition;
+    [condition lock];
+    pthread_mutex_unlock(&_mutex);
+
+    while (!self.completed) {
+        [condition wait];
+    }
+    [condition unlock];
 }
 
 #pragma mark - NSObject
 
 - (NSString *)description {
-    // Acquire the data from the locked properties
-    BOOL completed;
-    BOOL cancelled;
-    BOOL faulted;
-    NSString *resultDescription = nil;
-
-    @synchronized(self.lock) {
-        completed = self.completed;
-        cancelled = self.cancelled;
-        faulted = self.faulted;
-        resultDescription = completed ? [NSString stringWithFormat:@" result = %@", self.result] : @"";
-    }
+    // Reads the state once, so that the description is consistent.
+    AWSTaskState state = [self state];
+    BOOL completed = state >= AWSTaskStateSucceeded;
+    BOOL cancelled = state == AWSTaskStateCancelled;
+    BOOL faulted = state == AWSTaskStateFaulted;
+    NSString *resultDescription = completed ? [NSString stringWithFormat:@" result = %@", self.result] : @"";
 
     // Description string includes status information and, if available, the
     // result since in some ways this is what a promise actually "is".
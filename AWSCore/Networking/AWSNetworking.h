@@ -20,7 +20,8 @@ FOUNDATION_EXPORT NSString *const AWSNetworkingErrorDomain;
 typedef NS_ENUM(NSInteger, AWSNetworkingErrorType) {
     AWSNetworkingErrorUnknown,
     AWSNetworkingErrorCancelled,
-    AWSNetworkingErrorSessionInvalid
+    AWSNetworkingErrorSessionInvalid,
+    AWSNetworkingErrorChecksumMismatch
 };
 
 typedef NS_ENUM(NSInteger, AWSNetworkingRetryType) {
@@ -32,15 +33,34 @@ typedef NS_ENUM(NSInteger, AWSNetworkingRetryType) {
     AWSNetworkingRetryTypeResetStreamAndRetry
 };
 
+/**
+ How `AWSURLRequestRetryHandler` spaces and limits retries.
+ */
+typedef NS_ENUM(NSInteger, AWSNetworkingRetryMode) {
+    /** Retries after `2^n * 100ms`, without jitter and without limiting the number of retries across requests. */
+    AWSNetworkingRetryModeLegacy,
+    /** Jittered backoff, and retries are paid from a retry quota shared by all requests to the same endpoint. */
+    AWSNetworkingRetryModeStandard,
+    /** Standard mode, plus a client side send rate per endpoint that backs off when requests are throttled and recovers afterwards. */
+    AWSNetworkingRetryModeAdaptive
+};
+
 /** UserInfo dictionary key for response errors */
 FOUNDATION_EXPORT NSString *const AWSResponseObjectErrorUserInfoKey;
 
 @class AWSNetworkingConfiguration;
 @class AWSNetworkingRequest;
+@class AWSNetworkingRequestMetrics;
+@class AWSRequestCoalescer;
+@class AWSResponseCache;
+@class AWSURLSessionPool;
 @class AWSTask<__covariant ResultType>;
+@protocol AWSNetworkingResponseBodyConsumer;
 
 typedef void (^AWSNetworkingUploadProgressBlock) (int64_t bytesSent, int64_t totalBytesSent, int64_t totalBytesExpectedToSend);
 typedef void (^AWSNetworkingDownloadProgressBlock) (int64_t bytesWritten, int64_t totalBytesWritten, int64_t totalBytesExpectedToWrite);
+typedef void (^AWSNetworkingResponseItemBlock) (NSString *memberName, id item);
+typedef void (^AWSNetworkingMetricsBlock) (AWSNetworkingRequestMetrics *metrics);
 
 #pragma mark - AWSHTTPMethod
 
@@ -113,6 +133,60 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
                            data:(id)data
                           error:(NSError *__autoreleasing *)error;
 
+@optional
+
+- (void)setResponseItemHandler:(AWSNetworkingResponseItemBlock)responseItemHandler;
+
+/**
+ A consumer parsing the body of `response` while it is received, used when the request does not have a
+ `responseBodyConsumer`. The object it finishes with is passed to `responseObjectForResponse:...` as `data`.
+
+ @return A consumer, or `nil` to receive the whole body as `NSData`.
+ */
+- (id<AWSNetworkingResponseBodyConsumer>)responseBodyConsumerForResponse:(NSHTTPURLResponse *)response
+                                                         originalRequest:(NSURLRequest *)originalRequest;
+
+@end
+
+/**
+ Receives the body of a successful (2xx) response while it arrives, instead of the body being collected into an
+ `NSData` before the response serializer runs. Bodies of error responses are always collected, so that the error can be
+ parsed.
+
+ The methods are called on the delegate queue of the URL session, one attempt after the other: a consumer set on a
+ request that is retried begins again with each attempt.
+ */
+@protocol AWSNetworkingResponseBodyConsumer <NSObject>
+
+@required
+
+/**
+ Called when the headers of the response have been received, before any data. Discards what an earlier attempt left.
+ */
+- (BOOL)beginResponse:(NSHTTPURLResponse *)response
+                error:(NSError *__autoreleasing *)error;
+
+/**
+ Called with each chunk of the body, in order. Returning `NO` cancels the request with `error`.
+ */
+- (BOOL)consumeData:(NSData *)data
+              error:(NSError *__autoreleasing *)error;
+
+/**
+ Called when the whole body has been received.
+
+ @return What the response serializer receives in place of the body: `NSData`, the `NSURL` of a file holding the body,
+ a parsed body, or `nil` when the body has been consumed entirely. `nil` with `error` set fails the request.
+ */
+- (id)finishResponseWithError:(NSError *__autoreleasing *)error;
+
+@optional
+
+/**
+ Called instead of `-finishResponseWithError:` when the attempt fails after `-beginResponse:error:`.
+ */
+- (void)cancelResponse;
+
 @end
 
 @protocol AWSURLRequestRetryHandler <NSObject>
@@ -136,6 +210,38 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
 
 - (NSDictionary *)resetParameters:(NSDictionary *)parameters;
 
+/**
+ Called before every attempt of a request, the first one included. The attempt is sent after the returned delay.
+ */
+- (NSTimeInterval)timeIntervalBeforeAttempt:(uint32_t)currentRetryCount
+                            originalRequest:(AWSNetworkingRequest *)originalRequest;
+
+/**
+ Called with the outcome of every attempt, before `shouldRetry:originalRequest:response:data:error:` is asked about
+ failed ones.
+ */
+- (void)attempt:(uint32_t)currentRetryCount
+didCompleteForRequest:(AWSNetworkingRequest *)originalRequest
+       response:(NSHTTPURLResponse *)response
+          error:(NSError *)error;
+
+/**
+ Called once `shouldRetry:originalRequest:response:data:error:` decided to retry. Returning `NO` fails the request
+ with its current error instead, e.g. when the retry quota of the endpoint is exhausted.
+ */
+- (BOOL)acquireRetry:(uint32_t)currentRetryCount
+     originalRequest:(AWSNetworkingRequest *)originalRequest
+               error:(NSError *)error;
+
+/**
+ Used instead of `timeIntervalForRetry:response:data:error:` when implemented.
+ */
+- (NSTimeInterval)timeIntervalForRetry:(uint32_t)currentRetryCount
+                       originalRequest:(AWSNetworkingRequest *)originalRequest
+                              response:(NSHTTPURLResponse *)response
+                                  data:(NSData *)data
+                                 error:(NSError *)error;
+
 @end
 
 
@@ -157,6 +263,11 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
 @property (nonatomic, strong) NSArray<id<AWSNetworkingHTTPResponseInterceptor>> *responseInterceptors;
 @property (nonatomic, strong) id<AWSURLRequestRetryHandler> retryHandler;
 
+/**
+ The retry mode used by `AWSURLRequestRetryHandler`. The default is `AWSNetworkingRetryModeLegacy`.
+ */
+@property (nonatomic, assign) AWSNetworkingRetryMode retryMode;
+
 /**
  The maximum number of retries for failed requests. The value needs to be between 0 and 10 inclusive. If set to higher than 10, it becomes 10.
  */
@@ -172,6 +283,36 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
  */
 @property (nonatomic, assign) NSTimeInterval timeoutIntervalForResource;
 
+/**
+ The maximum number of simultaneous connections to a host. 0, the default, uses the `NSURLSession` default.
+ */
+@property (nonatomic, assign) NSInteger maximumConnectionsPerHost;
+
+/**
+ Sends the requests through a `NSURLSession` shared with the other clients using the pool and the same session settings,
+ so they share connections to the same hosts, including the ones opened by `-[AWSURLSessionPool prewarmEndpoints:configuration:]`.
+ `nil`, the default, gives each client its own session.
+ */
+@property (nonatomic, strong) AWSURLSessionPool *sessionPool;
+
+/**
+ Called with the per-phase timings of each request when it completes, on the thread completing the request. Keep it
+ short; `AWSNetworkingMetricsAggregator` provides a handler collecting the timings into histograms.
+ */
+@property (nonatomic, copy) AWSNetworkingMetricsBlock metricsHandler;
+
+/**
+ Lets concurrent identical read requests share a single request on the wire. `nil`, the default, sends every request.
+ See `AWSRequestCoalescer`.
+ */
+@property (nonatomic, strong) AWSRequestCoalescer *requestCoalescer;
+
+/**
+ Caches the responses of read requests and revalidates them with `If-None-Match` and `If-Modified-Since`, so unchanged
+ responses are not downloaded again. `nil`, the default, caches nothing. See `AWSResponseCache`.
+ */
+@property (nonatomic, strong) AWSResponseCache *responseCache;
+
 @end
 
 #pragma mark - AWSNetworkingRequest
@@ -185,6 +326,12 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
 
 @property (nonatomic, copy) AWSNetworkingUploadProgressBlock uploadProgress;
 @property (nonatomic, copy) AWSNetworkingDownloadProgressBlock downloadProgress;
+@property (nonatomic, copy) AWSNetworkingResponseItemBlock responseItemHandler;
+
+/**
+ Receives the body of a successful response while it arrives. See `AWSNetworkingResponseBodyConsumer`.
+ */
+@property (nonatomic, strong) id<AWSNetworkingResponseBodyConsumer> responseBodyConsumer;
 
 @property (readonly, nonatomic, strong) NSURLSessionTask *task;
 @property (readonly, nonatomic, assign, getter = isCancelled) BOOL cancelled;
@@ -199,6 +346,20 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
 
 @property (nonatomic, copy) AWSNetworkingUploadProgressBlock uploadProgress;
 @property (nonatomic, copy) AWSNetworkingDownloadProgressBlock downloadProgress;
+
+/**
+ Called with each element of the lists in an XML response, e.g. each `AWSS3Object` of a `ListObjectsV2` page, as soon
+ as it has been parsed. Elements passed to the handler are not added to the response object, so listing a large bucket
+ does not keep a whole page in memory.
+ */
+@property (nonatomic, copy) AWSNetworkingResponseItemBlock responseItemHandler;
+
+/**
+ Receives the body of a successful response while it arrives, e.g. an `AWSFileResponseBodyConsumer` writing it to a
+ file or an `AWSHashingResponseBodyConsumer` checksumming it. The response object is built from what the consumer
+ finishes with, so members that are not in the headers are only set when the consumer hands the body on.
+ */
+@property (nonatomic, strong) id<AWSNetworkingResponseBodyConsumer> responseBodyConsumer;
 @property (nonatomic, assign, readonly, getter = isCancelled) BOOL cancelled;
 @property (nonatomic, strong) NSURL *downloadingFileURL;
 
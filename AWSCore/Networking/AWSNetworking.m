@@ -163,9 +163,15 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     configuration.responseSerializer = self.responseSerializer;
     configuration.responseInterceptors = [self.responseInterceptors copy];
     configuration.retryHandler = self.retryHandler;
+    configuration.retryMode = self.retryMode;
     configuration.maxRetryCount = self.maxRetryCount;
     configuration.timeoutIntervalForRequest = self.timeoutIntervalForRequest;
     configuration.timeoutIntervalForResource = self.timeoutIntervalForResource;
+    configuration.maximumConnectionsPerHost = self.maximumConnectionsPerHost;
+    configuration.sessionPool = self.sessionPool;
+    configuration.metricsHandler = self.metricsHandler;
+    configuration.requestCoalescer = self.requestCoalescer;
+    configuration.responseCache = self.responseCache;
 
     return configuration;
 }
@@ -223,6 +229,22 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     if (!self.retryHandler) {
         self.retryHandler = configuration.retryHandler;
     }
+
+    if (self.retryMode == AWSNetworkingRetryModeLegacy) {
+        self.retryMode = configuration.retryMode;
+    }
+
+    if (!self.metricsHandler) {
+        self.metricsHandler = configuration.metricsHandler;
+    }
+
+    if (!self.requestCoalescer) {
+        self.requestCoalescer = configuration.requestCoalescer;
+    }
+
+    if (!self.responseCache) {
+        self.responseCache = configuration.responseCache;
+    }
 }
 
 - (void)setTask:(NSURLSessionTask *)task {
@@ -279,6 +301,8 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
 
     encodingBehaviors[@"downloadProgress"] = @(AWSMTLModelEncodingBehaviorExcluded);
     encodingBehaviors[@"internalRequest"] = @(AWSMTLModelEncodingBehaviorExcluded);
+    encodingBehaviors[@"responseItemHandler"] = @(AWSMTLModelEncodingBehaviorExcluded);
+    encodingBehaviors[@"responseBodyConsumer"] = @(AWSMTLModelEncodingBehaviorExcluded);
     encodingBehaviors[@"uploadProgress"] = @(AWSMTLModelEncodingBehaviorExcluded);
 
     return encodingBehaviors;
@@ -313,6 +337,20 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     return NULL;
 }
 
+// This may be a bug in our version of Mantle--despite declaring these properties as "excluded",
+// Mantle attempts to decode them from an archive, and fails when it cannot find the field name.
+- (nullable id)decodeResponseItemHandlerWithCoder:(NSCoder *)coder
+                                     modelVersion:(NSUInteger)modelVersion {
+    return NULL;
+}
+
+// This may be a bug in our version of Mantle--despite declaring these properties as "excluded",
+// Mantle attempts to decode them from an archive, and fails when it cannot find the field name.
+- (nullable id)decodeResponseBodyConsumerWithCoder:(NSCoder *)coder
+                                      modelVersion:(NSUInteger)modelVersion {
+    return NULL;
+}
+
 - (void)setUploadProgress:(AWSNetworkingUploadProgressBlock)uploadProgress {
     self.internalRequest.uploadProgress = uploadProgress;
 }
@@ -321,6 +359,15 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     self.internalRequest.downloadProgress = downloadProgress;
 }
 
+- (void)setResponseItemHandler:(AWSNetworkingResponseItemBlock)responseItemHandler {
+    self.internalRequest.responseItemHandler = responseItemHandler;
+}
+
+- (void)setResponseBodyConsumer:(id<AWSNetworkingResponseBodyConsumer>)responseBodyConsumer {
+    _responseBodyConsumer = responseBodyConsumer;
+    self.internalRequest.responseBodyConsumer = responseBodyConsumer;
+}
+
 - (BOOL)isCancelled {
     return [self.internalRequest isCancelled];
 }
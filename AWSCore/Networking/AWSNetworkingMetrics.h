@@ -0,0 +1,127 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import "AWSNetworking.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The phases of a request that are timed by `AWSNetworkingRequestMetrics`.
+ */
+typedef NS_ENUM(NSInteger, AWSNetworkingMetricsPhase) {
+    /** Building and validating the `NSURLRequest` from the request parameters. */
+    AWSNetworkingMetricsPhaseSerialization,
+    /** Waiting for the credentials provider (and payload hashing running alongside it) before the request can be signed. */
+    AWSNetworkingMetricsPhaseCredentialsWait,
+    /** The request interceptors, mostly signing, excluding the credentials wait. */
+    AWSNetworkingMetricsPhaseSigning,
+    AWSNetworkingMetricsPhaseDomainLookup,
+    AWSNetworkingMetricsPhaseConnect,
+    AWSNetworkingMetricsPhaseSecureConnection,
+    /** From the start of the request to the first byte of the response. */
+    AWSNetworkingMetricsPhaseTimeToFirstByte,
+    /** From the first to the last byte of the response. */
+    AWSNetworkingMetricsPhaseResponseTransfer,
+    /** Turning the response into the output object with the response serializer. */
+    AWSNetworkingMetricsPhaseParsing,
+    /** Time slept between attempts. */
+    AWSNetworkingMetricsPhaseRetryDelay,
+    /** From `-[AWSNetworking sendRequest:]` to the completion of the request, all attempts included. */
+    AWSNetworkingMetricsPhaseTotal,
+};
+
+FOUNDATION_EXPORT NSUInteger const AWSNetworkingMetricsPhaseCount;
+
+/**
+ Timings of a single request, passed to the `metricsHandler` of `AWSNetworkingConfiguration` when the request
+ completes. Durations are in seconds and are summed over all attempts when the request was retried.
+
+ DNS, connect, TLS, time to first byte and transfer timings come from `NSURLSessionTaskMetrics` and are only
+ available on iOS 10 and later. They are 0 when a connection was reused.
+ */
+@interface AWSNetworkingRequestMetrics : NSObject
+
+@property (nonatomic, readonly, nullable) NSURL *URL;
+@property (nonatomic, readonly) AWSHTTPMethod HTTPMethod;
+
+/**
+ The status code of the last response, or 0 when no response was received.
+ */
+@property (nonatomic, readonly) NSInteger statusCode;
+@property (nonatomic, readonly, nullable) NSError *error;
+@property (nonatomic, readonly) uint32_t retryCount;
+
+/**
+ Whether every attempt of the request was sent on a connection that was already open.
+ */
+@property (nonatomic, readonly, getter=isReusedConnection) BOOL reusedConnection;
+
+@property (nonatomic, readonly) NSTimeInterval serializationDuration;
+@property (nonatomic, readonly) NSTimeInterval credentialsWaitDuration;
+@property (nonatomic, readonly) NSTimeInterval signingDuration;
+@property (nonatomic, readonly) NSTimeInterval domainLookupDuration;
+@property (nonatomic, readonly) NSTimeInterval connectDuration;
+@property (nonatomic, readonly) NSTimeInterval secureConnectionDuration;
+@property (nonatomic, readonly) NSTimeInterval timeToFirstByte;
+@property (nonatomic, readonly) NSTimeInterval responseTransferDuration;
+@property (nonatomic, readonly) NSTimeInterval parsingDuration;
+@property (nonatomic, readonly) NSTimeInterval retryDelayDuration;
+@property (nonatomic, readonly) NSTimeInterval totalDuration;
+
+- (NSTimeInterval)durationForPhase:(AWSNetworkingMetricsPhase)phase;
+
+@end
+
+/**
+ Collects `AWSNetworkingRequestMetrics` into in-memory histograms, one per phase, with quarter-octave buckets from
+ 1 microsecond to about an hour. Memory use is fixed regardless of the number of requests recorded.
+
+     AWSNetworkingMetricsAggregator *aggregator = [AWSNetworkingMetricsAggregator new];
+     serviceConfiguration.metricsHandler = aggregator.metricsHandler;
+     ...
+     NSLog(@"%@", [aggregator dump]);
+ */
+@interface AWSNetworkingMetricsAggregator : NSObject
+
+/**
+ A handler recording the metrics it is called with into the receiver, to be set as `metricsHandler`.
+ */
+@property (nonatomic, readonly) AWSNetworkingMetricsBlock metricsHandler;
+
+- (void)recordMetrics:(AWSNetworkingRequestMetrics *)metrics;
+
+/**
+ Returns a snapshot of the recorded metrics.
+
+ The `requests` key holds the `count`, `retries` and `errors` counters. Every phase with at least one sample has a key
+ (`serialization`, `credentialsWait`, `signing`, `domainLookup`, `connect`, `secureConnection`, `timeToFirstByte`,
+ `responseTransfer`, `parsing`, `retryDelay`, `total`) holding `count`, `min`, `max`, `mean`, `p50`, `p90` and `p99`
+ in seconds. Percentiles are accurate to the width of a bucket, about 19%.
+ */
+- (NSDictionary<NSString *, NSDictionary<NSString *, NSNumber *> *> *)dump;
+
+/**
+ The snapshot returned by `-dump` as a table for logging.
+ */
+- (NSString *)dumpDescription;
+
+- (void)reset;
+
++ (NSString *)nameForPhase:(AWSNetworkingMetricsPhase)phase;
+
+@end
+
+NS_ASSUME_NONNULL_END
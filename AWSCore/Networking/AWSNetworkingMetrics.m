@@ -0,0 +1,276 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSNetworkingMetrics.h"
+
+NSUInteger const AWSNetworkingMetricsPhaseCount = AWSNetworkingMetricsPhaseTotal + 1;
+
+// Quarter-octave buckets of microseconds: bucket i holds [2^(i/4), 2^((i+1)/4)) us, up to 2^32 us.
+#define AWSNetworkingMetricsBucketsPerOctave 4
+#define AWSNetworkingMetricsBucketCount (32 * AWSNetworkingMetricsBucketsPerOctave)
+
+#pragma mark - AWSNetworkingRequestMetrics
+
+@interface AWSNetworkingRequestMetrics()
+
+@property (nonatomic, strong) NSURL *URL;
+@property (nonatomic, assign) AWSHTTPMethod HTTPMethod;
+@property (nonatomic, assign) NSInteger statusCode;
+@property (nonatomic, strong) NSError *error;
+@property (nonatomic, assign) uint32_t retryCount;
+@property (nonatomic, assign, getter=isReusedConnection) BOOL reusedConnection;
+
+@property (nonatomic, assign) NSTimeInterval serializationDuration;
+@property (nonatomic, assign) NSTimeInterval credentialsWaitDuration;
+@property (nonatomic, assign) NSTimeInterval signingDuration;
+@property (nonatomic, assign) NSTimeInterval domainLookupDuration;
+@property (nonatomic, assign) NSTimeInterval connectDuration;
+@property (nonatomic, assign) NSTimeInterval secureConnectionDuration;
+@property (nonatomic, assign) NSTimeInterval timeToFirstByte;
+@property (nonatomic, assign) NSTimeInterval responseTransferDuration;
+@property (nonatomic, assign) NSTimeInterval parsingDuration;
+@property (nonatomic, assign) NSTimeInterval retryDelayDuration;
+@property (nonatomic, assign) NSTimeInterval totalDuration;
+
+@end
+
+@implementation AWSNetworkingRequestMetrics
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _reusedConnection = YES;
+    }
+    return self;
+}
+
+- (NSTimeInterval)durationForPhase:(AWSNetworkingMetricsPhase)phase {
+    switch (phase) {
+        case AWSNetworkingMetricsPhaseSerialization:
+            return self.serializationDuration;
+        case AWSNetworkingMetricsPhaseCredentialsWait:
+            return self.credentialsWaitDuration;
+        case AWSNetworkingMetricsPhaseSigning:
+            return self.signingDuration;
+        case AWSNetworkingMetricsPhaseDomainLookup:
+            return self.domainLookupDuration;
+        case AWSNetworkingMetricsPhaseConnect:
+            return self.connectDuration;
+        case AWSNetworkingMetricsPhaseSecureConnection:
+            return self.secureConnectionDuration;
+        case AWSNetworkingMetricsPhaseTimeToFirstByte:
+            return self.timeToFirstByte;
+        case AWSNetworkingMetricsPhaseResponseTransfer:
+            return self.responseTransferDuration;
+        case AWSNetworkingMetricsPhaseParsing:
+            return self.parsingDuration;
+        case AWSNetworkingMetricsPhaseRetryDelay:
+            return self.retryDelayDuration;
+        case AWSNetworkingMetricsPhaseTotal:
+            return self.totalDuration;
+    }
+    return 0;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p> %@ %@ status: %ld, retries: %u, serialization: %.6f, credentialsWait: %.6f, signing: %.6f, domainLookup: %.6f, connect: %.6f, secureConnection: %.6f, timeToFirstByte: %.6f, responseTransfer: %.6f, parsing: %.6f, retryDelay: %.6f, total: %.6f",
+            NSStringFromClass([self class]), self,
+            [NSString aws_stringWithHTTPMethod:self.HTTPMethod], self.URL,
+            (long)self.statusCode, self.retryCount,
+            self.serializationDuration, self.credentialsWaitDuration, self.signingDuration,
+            self.domainLookupDuration, self.connectDuration, self.secureConnectionDuration,
+            self.timeToFirstByte, self.responseTransferDuration, self.parsingDuration,
+            self.retryDelayDuration, self.totalDuration];
+}
+
+@end
+
+#pragma mark - AWSNetworkingMetricsAggregator
+
+typedef struct {
+    uint64_t buckets[AWSNetworkingMetricsBucketCount];
+    uint64_t count;
+    double sum;
+    double min;
+    double max;
+} AWSNetworkingMetricsHistogram;
+
+static NSUInteger AWSNetworkingMetricsBucketForDuration(NSTimeInterval duration) {
+    double microseconds = duration * 1e6;
+    if (microseconds < 1) {
+        return 0;
+    }
+    NSUInteger bucket = (NSUInteger)(log2(microseconds) * AWSNetworkingMetricsBucketsPerOctave);
+    return MIN(bucket, (NSUInteger)AWSNetworkingMetricsBucketCount - 1);
+}
+
+static void AWSNetworkingMetricsHistogramRecord(AWSNetworkingMetricsHistogram *histogram, NSTimeInterval duration) {
+    if (duration < 0) {
+        duration = 0;
+    }
+    histogram->buckets[AWSNetworkingMetricsBucketForDuration(duration)]++;
+    histogram->min = histogram->count == 0 ? duration : MIN(histogram->min, duration);
+    histogram->max = histogram->count == 0 ? duration : MAX(histogram->max, duration);
+    histogram->count++;
+    histogram->sum += duration;
+}
+
+// Returns the geometric middle of the bucket holding the percentile, clamped to the recorded range.
+static NSTimeInterval AWSNetworkingMetricsHistogramPercentile(const AWSNetworkingMetricsHistogram *histogram, double percentile) {
+    uint64_t rank = (uint64_t)ceil(percentile * histogram->count);
+    rank = MAX(rank, 1);
+    uint64_t seen = 0;
+    for (NSUInteger i = 0; i < AWSNetworkingMetricsBucketCount; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            NSTimeInterval middle = exp2((i + 0.5) / (double)AWSNetworkingMetricsBucketsPerOctave) / 1e6;
+            return MIN(MAX(middle, histogram->min), histogram->max);
+        }
+    }
+    return histogram->max;
+}
+
+@interface AWSNetworkingMetricsAggregator() {
+    AWSNetworkingMetricsHistogram _histograms[AWSNetworkingMetricsPhaseTotal + 1];
+    uint64_t _requestCount;
+    uint64_t _retryCount;
+    uint64_t _errorCount;
+}
+
+@end
+
+@implementation AWSNetworkingMetricsAggregator
+
++ (NSString *)nameForPhase:(AWSNetworkingMetricsPhase)phase {
+    switch (phase) {
+        case AWSNetworkingMetricsPhaseSerialization:
+            return @"serialization";
+        case AWSNetworkingMetricsPhaseCredentialsWait:
+            return @"credentialsWait";
+        case AWSNetworkingMetricsPhaseSigning:
+            return @"signing";
+        case AWSNetworkingMetricsPhaseDomainLookup:
+            return @"domainLookup";
+        case AWSNetworkingMetricsPhaseConnect:
+            return @"connect";
+        case AWSNetworkingMetricsPhaseSecureConnection:
+            return @"secureConnection";
+        case AWSNetworkingMetricsPhaseTimeToFirstByte:
+            return @"timeToFirstByte";
+        case AWSNetworkingMetricsPhaseResponseTransfer:
+            return @"responseTransfer";
+        case AWSNetworkingMetricsPhaseParsing:
+            return @"parsing";
+        case AWSNetworkingMetricsPhaseRetryDelay:
+            return @"retryDelay";
+        case AWSNetworkingMetricsPhaseTotal:
+            return @"total";
+    }
+    return nil;
+}
+
+- (AWSNetworkingMetricsBlock)metricsHandler {
+    __weak AWSNetworkingMetricsAggregator *weakSelf = self;
+    return ^(AWSNetworkingRequestMetrics *metrics) {
+        [weakSelf recordMetrics:metrics];
+    };
+}
+
+- (void)recordMetrics:(AWSNetworkingRequestMetrics *)metrics {
+    @synchronized(self) {
+        _requestCount++;
+        _retryCount += metrics.retryCount;
+        if (metrics.error) {
+            _errorCount++;
+        }
+        for (NSInteger phase = 0; phase < AWSNetworkingMetricsPhaseCount; phase++) {
+            switch (phase) {
+                case AWSNetworkingMetricsPhaseDomainLookup:
+                case AWSNetworkingMetricsPhaseConnect:
+                case AWSNetworkingMetricsPhaseSecureConnection:
+                    // A reused connection did not go through these phases, a 0 would only skew the distribution.
+                    if (metrics.isReusedConnection) {
+                        continue;
+                    }
+                    break;
+                case AWSNetworkingMetricsPhaseRetryDelay:
+                    if (metrics.retryCount == 0) {
+                        continue;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            AWSNetworkingMetricsHistogramRecord(&_histograms[phase], [metrics durationForPhase:phase]);
+        }
+    }
+}
+
+- (NSDictionary<NSString *, NSDictionary<NSString *, NSNumber *> *> *)dump {
+    NSMutableDictionary *dump = [NSMutableDictionary new];
+    @synchronized(self) {
+        dump[@"requests"] = @{@"count" : @(_requestCount),
+                              @"retries" : @(_retryCount),
+                              @"errors" : @(_errorCount)};
+        for (NSInteger phase = 0; phase < AWSNetworkingMetricsPhaseCount; phase++) {
+            const AWSNetworkingMetricsHistogram *histogram = &_histograms[phase];
+            if (histogram->count == 0) {
+                continue;
+            }
+            dump[[AWSNetworkingMetricsAggregator nameForPhase:phase]] = @{@"count" : @(histogram->count),
+                                                                         @"min" : @(histogram->min),
+                                                                         @"max" : @(histogram->max),
+                                                                         @"mean" : @(histogram->sum / histogram->count),
+                                                                         @"p50" : @(AWSNetworkingMetricsHistogramPercentile(histogram, 0.5)),
+                                                                         @"p90" : @(AWSNetworkingMetricsHistogramPercentile(histogram, 0.9)),
+                                                                         @"p99" : @(AWSNetworkingMetricsHistogramPercentile(histogram, 0.99))};
+        }
+    }
+    return dump;
+}
+
+- (NSString *)dumpDescription {
+    NSDictionary *dump = [self dump];
+    NSDictionary *requests = dump[@"requests"];
+    NSMutableString *description = [NSMutableString stringWithFormat:@"requests: %@, retries: %@, errors: %@\n",
+                                    requests[@"count"], requests[@"retries"], requests[@"errors"]];
+    [description appendFormat:@"%-18s %8s %10s %10s %10s %10s %10s (ms)\n", "phase", "count", "mean", "p50", "p90", "p99", "max"];
+    for (NSInteger phase = 0; phase < AWSNetworkingMetricsPhaseCount; phase++) {
+        NSString *name = [AWSNetworkingMetricsAggregator nameForPhase:phase];
+        NSDictionary *histogram = dump[name];
+        if (!histogram) {
+            continue;
+        }
+        [description appendFormat:@"%-18s %8llu %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+         [name UTF8String],
+         [histogram[@"count"] unsignedLongLongValue],
+         [histogram[@"mean"] doubleValue] * 1000,
+         [histogram[@"p50"] doubleValue] * 1000,
+         [histogram[@"p90"] doubleValue] * 1000,
+         [histogram[@"p99"] doubleValue] * 1000,
+         [histogram[@"max"] doubleValue] * 1000];
+    }
+    return description;
+}
+
+- (void)reset {
+    @synchronized(self) {
+        memset(_histograms, 0, sizeof(_histograms));
+        _requestCount = 0;
+        _retryCount = 0;
+        _errorCount = 0;
+    }
+}
+
+@end
@@ -0,0 +1,90 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class AWSTask<__covariant ResultType>;
+
+/**
+ Lets identical read requests that are in flight at the same time share one request on the wire. The first request is
+ sent, and the ones made before it completes wait for it and complete with its result, including its retries.
+
+ Requests are identical when their signed requests are: same method, URL, body and headers, signed with the same access
+ key. The headers that change with every signature (`Authorization`, `X-Amz-Date`, `User-Agent`) are left out.
+
+ Set the same instance as `requestCoalescer` on the configurations whose requests may be shared:
+
+     AWSRequestCoalescer *requestCoalescer = [AWSRequestCoalescer new];
+     serviceConfiguration.requestCoalescer = requestCoalescer;
+     ...
+     NSLog(@"%.0f%% of the requests were coalesced", requestCoalescer.hitRate * 100);
+
+ Requests written to a file, or with a download progress block, a response item handler or a response body consumer,
+ are always sent on their own, since each caller expects its own side effects. A request that joins another is not
+ cancelled with its own `cancel`; it completes when the shared request does, and is sent again on its own if the shared
+ request was cancelled.
+ */
+@interface AWSRequestCoalescer : NSObject
+
+/**
+ The number of requests that could be coalesced.
+ */
+@property (nonatomic, readonly) uint64_t requestCount;
+
+/**
+ The number of requests that completed with the result of another request instead of being sent.
+ */
+@property (nonatomic, readonly) uint64_t coalescedCount;
+
+/**
+ `coalescedCount / requestCount`, 0 before any request.
+ */
+@property (nonatomic, readonly) double hitRate;
+
+/**
+ The number of distinct requests in flight.
+ */
+@property (nonatomic, readonly) NSUInteger inFlightCount;
+
+/**
+ Whether `request` only reads and may be shared. `GET` and `HEAD` requests, and `POST` requests of JSON protocols whose
+ operation in `X-Amz-Target` starts with `Describe`, `Get`, `List` or `BatchGet`, e.g. `Kinesis_20131202.DescribeStream`.
+ Override to change which requests are coalesced.
+ */
+- (BOOL)shouldCoalesceRequest:(NSURLRequest *)request;
+
+/**
+ The key under which `request` is coalesced with identical requests.
+ */
+- (NSString *)keyForRequest:(NSURLRequest *)request;
+
+/**
+ Used by `AWSURLSessionManager` once `request` has been signed.
+
+ @param request The signed request.
+ @param task    Completes with the result of `request`.
+ @return The task of an identical request in flight, which `request` should wait for instead of being sent. `nil` when
+ `request` should be sent, in which case `task` is registered for the requests made until it completes.
+ */
+- (nullable AWSTask *)inFlightTaskForRequest:(NSURLRequest *)request
+                             registeringTask:(AWSTask *)task;
+
+- (void)resetCounters;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,162 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSRequestCoalescer.h"
+#import <CommonCrypto/CommonDigest.h>
+#import "AWSBolts.h"
+
+@interface AWSRequestCoalescer()
+
+@property (nonatomic, strong) NSMutableDictionary<NSString *, AWSTask *> *inFlightTasks;
+@property (nonatomic, assign) uint64_t requestCount;
+@property (nonatomic, assign) uint64_t coalescedCount;
+
+@end
+
+@implementation AWSRequestCoalescer
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _inFlightTasks = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (uint64_t)requestCount {
+    @synchronized(self) {
+        return _requestCount;
+    }
+}
+
+- (uint64_t)coalescedCount {
+    @synchronized(self) {
+        return _coalescedCount;
+    }
+}
+
+- (double)hitRate {
+    @synchronized(self) {
+        return _requestCount == 0 ? 0 : (double)_coalescedCount / _requestCount;
+    }
+}
+
+- (NSUInteger)inFlightCount {
+    @synchronized(self) {
+        return [_inFlightTasks count];
+    }
+}
+
+- (void)resetCounters {
+    @synchronized(self) {
+        _requestCount = 0;
+        _coalescedCount = 0;
+    }
+}
+
+- (BOOL)shouldCoalesceRequest:(NSURLRequest *)request {
+    if (request.HTTPBodyStream) {
+        return NO;
+    }
+    NSString *HTTPMethod = [request.HTTPMethod uppercaseString];
+    if ([HTTPMethod isEqualToString:@"GET"] || [HTTPMethod isEqualToString:@"HEAD"]) {
+        return YES;
+    }
+    if ([HTTPMethod isEqualToString:@"POST"]) {
+        NSString *target = [request valueForHTTPHeaderField:@"X-Amz-Target"];
+        NSString *operationName = [[target componentsSeparatedByString:@"."] lastObject];
+        for (NSString *prefix in @[@"Describe", @"Get", @"List", @"BatchGet"]) {
+            if ([operationName hasPrefix:prefix]) {
+                return YES;
+            }
+        }
+    }
+    return NO;
+}
+
+- (NSString *)keyForRequest:(NSURLRequest *)request {
+    NSMutableString *key = [NSMutableString stringWithFormat:@"%@ %@\n", [request.HTTPMethod uppercaseString], request.URL.absoluteString];
+
+    NSDictionary<NSString *, NSString *> *headers = [request allHTTPHeaderFields];
+    NSMutableArray<NSString *> *headerNames = [NSMutableArray arrayWithCapacity:[headers count]];
+    for (NSString *headerName in headers) {
+        NSString *lowercaseHeaderName = [headerName lowercaseString];
+        if ([lowercaseHeaderName isEqualToString:@"authorization"]) {
+            // The signature changes with the date, the access key it was signed with does not.
+            NSString *authorization = headers[headerName];
+            NSRange credential = [authorization rangeOfString:@"Credential="];
+            if (credential.location != NSNotFound) {
+                NSString *scope = [authorization substringFromIndex:NSMaxRange(credential)];
+                [key appendFormat:@"credential:%@\n", [[scope componentsSeparatedByString:@"/"] firstObject]];
+            }
+            continue;
+        }
+        if ([lowercaseHeaderName isEqualToString:@"x-amz-date"]
+            || [lowercaseHeaderName isEqualToString:@"date"]
+            || [lowercaseHeaderName isEqualToString:@"user-agent"]
+            || [lowercaseHeaderName isEqualToString:@"x-amz-user-agent"]
+            || [lowercaseHeaderName hasPrefix:@"amz-sdk-"]) {
+            continue;
+        }
+        [headerNames addObject:headerName];
+    }
+    [headerNames sortUsingSelector:@selector(caseInsensitiveCompare:)];
+    for (NSString *headerName in headerNames) {
+        [key appendFormat:@"%@:%@\n", [headerName lowercaseString], headers[headerName]];
+    }
+
+    NSData *body = request.HTTPBody;
+    if ([body length] > 0) {
+        unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+        CC_SHA256([body bytes], (CC_LONG)[body length], digest);
+        for (NSUInteger i = 0; i < CC_SHA256_DIGEST_LENGTH; i++) {
+            [key appendFormat:@"%02x", digest[i]];
+        }
+    }
+    return key;
+}
+
+- (AWSTask *)inFlightTaskForRequest:(NSURLRequest *)request
+                    registeringTask:(AWSTask *)task {
+    if (![self shouldCoalesceRequest:request]) {
+        return nil;
+    }
+    NSString *key = [self keyForRequest:request];
+
+    @synchronized(self) {
+        _requestCount++;
+        AWSTask *inFlightTask = _inFlightTasks[key];
+        if (inFlightTask) {
+            _coalescedCount++;
+            return inFlightTask;
+        }
+        _inFlightTasks[key] = task;
+    }
+
+    __weak AWSRequestCoalescer *weakSelf = self;
+    [task continueWithBlock:^id(AWSTask *completedTask) {
+        AWSRequestCoalescer *strongSelf = weakSelf;
+        if (strongSelf) {
+            @synchronized(strongSelf) {
+                if (strongSelf.inFlightTasks[key] == completedTask) {
+                    [strongSelf.inFlightTasks removeObjectForKey:key];
+                }
+            }
+        }
+        return nil;
+    }];
+    return nil;
+}
+
+@end
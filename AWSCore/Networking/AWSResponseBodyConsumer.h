@@ -0,0 +1,106 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import "AWSNetworking.h"
+#import "AWSChecksum.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Writes the body to a file as it arrives and finishes with the file URL, which becomes the streaming payload member of
+ the response (e.g. `body` of `AWSS3GetObjectOutput`). The file is replaced at the start of each attempt.
+ */
+@interface AWSFileResponseBodyConsumer : NSObject <AWSNetworkingResponseBodyConsumer>
+
+@property (nonatomic, readonly) NSURL *fileURL;
+
+/**
+ The number of bytes written for the current attempt.
+ */
+@property (nonatomic, readonly) int64_t bytesWritten;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithFileURL:(NSURL *)fileURL;
+
+@end
+
+/**
+ Checksums the body as it passes through to another consumer, or collects it into `NSData` when there is none.
+
+ When the response has an `x-amz-checksum-*` header for `checksumAlgorithm`, the request fails with
+ `AWSNetworkingErrorChecksumMismatch` if the body does not match it. Checksums of multipart objects, which are
+ checksums of the part checksums, can not be verified from the body and are ignored.
+ */
+@interface AWSHashingResponseBodyConsumer : NSObject <AWSNetworkingResponseBodyConsumer>
+
+@property (nonatomic, readonly, nullable) id<AWSNetworkingResponseBodyConsumer> consumer;
+@property (nonatomic, readonly) AWSChecksumAlgorithm checksumAlgorithm;
+
+/**
+ Whether the SHA-256 digest of the body is computed too. The default is `NO`.
+ */
+@property (nonatomic, assign) BOOL computesSHA256;
+
+/**
+ The checksum of the body once the response has finished, `nil` for `AWSChecksumAlgorithmNone`.
+ */
+@property (nonatomic, readonly, nullable) AWSChecksum *checksum;
+
+/**
+ The SHA-256 digest of the body once the response has finished, when `computesSHA256` is set.
+ */
+@property (nonatomic, readonly, nullable) NSData *SHA256Digest;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithConsumer:(nullable id<AWSNetworkingResponseBodyConsumer>)consumer
+               checksumAlgorithm:(AWSChecksumAlgorithm)checksumAlgorithm;
+
+@end
+
+/**
+ Parses the body from an `NSInputStream`.
+
+ @param inputStream The body. It is not open yet.
+ @param response    The response.
+ @param error       Set when the body can not be parsed.
+ @return The parsed body.
+ */
+typedef _Nullable id (^AWSStreamingResponseBodyParser)(NSInputStream *inputStream,
+                                                       NSHTTPURLResponse *response,
+                                                       NSError *__autoreleasing *error);
+
+/**
+ Runs a parser reading from an `NSInputStream` on a background queue, fed with the body as it arrives, so parsing
+ overlaps the download and only a bounded buffer of the body is held in memory. When the parser falls behind, the
+ session delegate queue waits for it.
+ */
+@interface AWSStreamingResponseBodyConsumer : NSObject <AWSNetworkingResponseBodyConsumer>
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithParser:(AWSStreamingResponseBodyParser)parser;
+
+/**
+ @param bufferSize The number of bytes received but not read by the parser yet that can be buffered. The default is 64KB.
+ */
+- (instancetype)initWithParser:(AWSStreamingResponseBodyParser)parser
+                    bufferSize:(NSUInteger)bufferSize;
+
+@end
+
+NS_ASSUME_NONNULL_END
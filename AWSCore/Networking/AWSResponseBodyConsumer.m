@@ -0,0 +1,321 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSResponseBodyConsumer.h"
+#import <CommonCrypto/CommonDigest.h>
+#import "AWSCocoaLumberjack.h"
+
+static NSUInteger const AWSStreamingResponseBodyConsumerDefaultBufferSize = 64 * 1024;
+
+#pragma mark - AWSFileResponseBodyConsumer
+
+@interface AWSFileResponseBodyConsumer()
+
+@property (nonatomic, strong) NSURL *fileURL;
+@property (nonatomic, assign) int64_t bytesWritten;
+@property (nonatomic, strong) NSFileHandle *fileHandle;
+
+@end
+
+@implementation AWSFileResponseBodyConsumer
+
+- (instancetype)initWithFileURL:(NSURL *)fileURL {
+    if (self = [super init]) {
+        _fileURL = fileURL;
+    }
+    return self;
+}
+
+- (BOOL)beginResponse:(NSHTTPURLResponse *)response
+                error:(NSError *__autoreleasing *)error {
+    [self.fileHandle closeFile];
+    self.fileHandle = nil;
+    self.bytesWritten = 0;
+
+    // Truncates what an earlier attempt wrote.
+    if (![[NSFileManager defaultManager] createFileAtPath:self.fileURL.path contents:nil attributes:nil]) {
+        if (error) {
+            *error = [NSError errorWithDomain:AWSNetworkingErrorDomain
+                                         code:AWSNetworkingErrorUnknown
+                                     userInfo:@{NSLocalizedDescriptionKey : [NSString stringWithFormat:@"Can not create file with file path: %@", self.fileURL.path]}];
+        }
+        return NO;
+    }
+    self.fileHandle = [NSFileHandle fileHandleForWritingToURL:self.fileURL error:error];
+    return self.fileHandle != nil;
+}
+
+- (BOOL)consumeData:(NSData *)data
+              error:(NSError *__autoreleasing *)error {
+    @try {
+        [self.fileHandle writeData:data];
+    }
+    @catch (NSException *exception) {
+        AWSDDLogError(@"Error: [%@]", exception);
+        if (error) {
+            *error = [NSError errorWithDomain:AWSNetworkingErrorDomain
+                                         code:AWSNetworkingErrorUnknown
+                                     userInfo:@{NSLocalizedDescriptionKey : [NSString stringWithFormat:@"Failed to write data: %@", exception]}];
+        }
+        return NO;
+    }
+    self.bytesWritten += [data length];
+    return YES;
+}
+
+- (id)finishResponseWithError:(NSError *__autoreleasing *)error {
+    [self.fileHandle closeFile];
+    self.fileHandle = nil;
+    return self.fileURL;
+}
+
+- (void)cancelResponse {
+    [self.fileHandle closeFile];
+    self.fileHandle = nil;
+    [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:nil];
+}
+
+@end
+
+#pragma mark - AWSHashingResponseBodyConsumer
+
+@interface AWSHashingResponseBodyConsumer() {
+    CC_SHA256_CTX _SHA256Context;
+}
+
+@property (nonatomic, strong) id<AWSNetworkingResponseBodyConsumer> consumer;
+@property (nonatomic, assign) AWSChecksumAlgorithm checksumAlgorithm;
+@property (nonatomic, strong) AWSChecksum *checksum;
+@property (nonatomic, strong) NSData *SHA256Digest;
+@property (nonatomic, strong) NSString *expectedChecksum;
+@property (nonatomic, strong) NSMutableData *data;
+
+@end
+
+@implementation AWSHashingResponseBodyConsumer
+
+- (instancetype)initWithConsumer:(id<AWSNetworkingResponseBodyConsumer>)consumer
+               checksumAlgorithm:(AWSChecksumAlgorithm)checksumAlgorithm {
+    if (self = [super init]) {
+        _consumer = consumer;
+        _checksumAlgorithm = checksumAlgorithm;
+    }
+    return self;
+}
+
+- (BOOL)beginResponse:(NSHTTPURLResponse *)response
+                error:(NSError *__autoreleasing *)error {
+    self.checksum = [AWSChecksum checksumWithAlgorithm:self.checksumAlgorithm];
+    self.SHA256Digest = nil;
+    if (self.computesSHA256) {
+        CC_SHA256_Init(&_SHA256Context);
+    }
+
+    self.expectedChecksum = nil;
+    NSString *headerName = [AWSChecksum headerNameForAlgorithm:self.checksumAlgorithm];
+    if (headerName) {
+        NSString *expectedChecksum = nil;
+        for (NSString *field in [response allHeaderFields]) {
+            if ([field caseInsensitiveCompare:headerName] == NSOrderedSame) {
+                expectedChecksum = [response allHeaderFields][field];
+                break;
+            }
+        }
+        // The checksum of a multipart object ends with the number of parts, e.g. "3c4Q+A==-12".
+        if ([expectedChecksum rangeOfString:@"-"].location == NSNotFound) {
+            self.expectedChecksum = expectedChecksum;
+        }
+    }
+
+    if (self.consumer) {
+        self.data = nil;
+        return [self.consumer beginResponse:response error:error];
+    }
+    self.data = [NSMutableData new];
+    return YES;
+}
+
+- (BOOL)consumeData:(NSData *)data
+              error:(NSError *__autoreleasing *)error {
+    [self.checksum updateWithData:data];
+    if (self.computesSHA256) {
+        [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+            CC_SHA256_Update(&self->_SHA256Context, bytes, (CC_LONG)byteRange.length);
+        }];
+    }
+
+    if (self.consumer) {
+        return [self.consumer consumeData:data error:error];
+    }
+    [self.data appendData:data];
+    return YES;
+}
+
+- (id)finishResponseWithError:(NSError *__autoreleasing *)error {
+    if (self.computesSHA256) {
+        unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+        CC_SHA256_Final(digest, &_SHA256Context);
+        self.SHA256Digest = [NSData dataWithBytes:digest length:CC_SHA256_DIGEST_LENGTH];
+    }
+
+    if (self.expectedChecksum
+        && ![self.expectedChecksum isEqualToString:[self.checksum base64EncodedChecksum]]) {
+        if ([self.consumer respondsToSelector:@selector(cancelResponse)]) {
+            [self.consumer cancelResponse];
+        }
+        if (error) {
+            *error = [NSError errorWithDomain:AWSNetworkingErrorDomain
+                                         code:AWSNetworkingErrorChecksumMismatch
+                                     userInfo:@{NSLocalizedDescriptionKey : [NSString stringWithFormat:@"The %@ of the response body is %@, expected %@.",
+                                                                             [AWSChecksum headerNameForAlgorithm:self.checksumAlgorithm],
+                                                                             [self.checksum base64EncodedChecksum],
+                                                                             self.expectedChecksum]}];
+        }
+        return nil;
+    }
+
+    if (self.consumer) {
+        return [self.consumer finishResponseWithError:error];
+    }
+    NSData *data = self.data;
+    self.data = nil;
+    return data;
+}
+
+- (void)cancelResponse {
+    self.data = nil;
+    if ([self.consumer respondsToSelector:@selector(cancelResponse)]) {
+        [self.consumer cancelResponse];
+    }
+}
+
+@end
+
+#pragma mark - AWSStreamingResponseBodyConsumer
+
+// The parse of one attempt, so that a parser still running for a cancelled attempt does not affect the next one.
+@interface AWSStreamingResponseBodyParse : NSObject
+
+@property (nonatomic, strong) NSOutputStream *outputStream;
+@property (nonatomic, strong) dispatch_group_t group;
+@property (nonatomic, strong) id result;
+@property (nonatomic, strong) NSError *error;
+
+@end
+
+@implementation AWSStreamingResponseBodyParse
+
+@end
+
+@interface AWSStreamingResponseBodyConsumer()
+
+@property (nonatomic, copy) AWSStreamingResponseBodyParser parser;
+@property (nonatomic, assign) NSUInteger bufferSize;
+@property (nonatomic, strong) AWSStreamingResponseBodyParse *parse;
+
+@end
+
+@implementation AWSStreamingResponseBodyConsumer
+
+- (instancetype)initWithParser:(AWSStreamingResponseBodyParser)parser {
+    return [self initWithParser:parser bufferSize:AWSStreamingResponseBodyConsumerDefaultBufferSize];
+}
+
+- (instancetype)initWithParser:(AWSStreamingResponseBodyParser)parser
+                    bufferSize:(NSUInteger)bufferSize {
+    if (self = [super init]) {
+        _parser = [parser copy];
+        _bufferSize = bufferSize;
+    }
+    return self;
+}
+
+- (BOOL)beginResponse:(NSHTTPURLResponse *)response
+                error:(NSError *__autoreleasing *)error {
+    [self cancelResponse];
+
+    CFReadStreamRef readStream = NULL;
+    CFWriteStreamRef writeStream = NULL;
+    CFStreamCreateBoundPair(kCFAllocatorDefault, &readStream, &writeStream, (CFIndex)self.bufferSize);
+    NSInputStream *inputStream = CFBridgingRelease(readStream);
+
+    AWSStreamingResponseBodyParse *parse = [AWSStreamingResponseBodyParse new];
+    parse.outputStream = CFBridgingRelease(writeStream);
+    parse.group = dispatch_group_create();
+    [parse.outputStream open];
+    self.parse = parse;
+
+    AWSStreamingResponseBodyParser parser = self.parser;
+    dispatch_group_async(parse.group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        NSError *parseError = nil;
+        parse.result = parser(inputStream, response, &parseError);
+        parse.error = parseError;
+        // Unblocks the writer when the parser stopped before the end of the body.
+        [inputStream close];
+    });
+    return YES;
+}
+
+- (BOOL)consumeData:(NSData *)data
+              error:(NSError *__autoreleasing *)error {
+    AWSStreamingResponseBodyParse *parse = self.parse;
+    __block BOOL succeeded = YES;
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        const uint8_t *buffer = bytes;
+        NSUInteger remaining = byteRange.length;
+        while (remaining > 0) {
+            // Blocks while the buffer is full.
+            NSInteger written = [parse.outputStream write:buffer maxLength:remaining];
+            if (written <= 0) {
+                succeeded = NO;
+                *stop = YES;
+                return;
+            }
+            buffer += written;
+            remaining -= written;
+        }
+    }];
+    if (succeeded) {
+        return YES;
+    }
+
+    // The parser stopped reading, most likely because of an error in the body.
+    dispatch_group_wait(parse.group, DISPATCH_TIME_FOREVER);
+    if (error) {
+        *error = parse.error ?: [NSError errorWithDomain:AWSNetworkingErrorDomain
+                                                    code:AWSNetworkingErrorUnknown
+                                                userInfo:@{NSLocalizedDescriptionKey : @"The response parser stopped before the end of the response body."}];
+    }
+    return NO;
+}
+
+- (id)finishResponseWithError:(NSError *__autoreleasing *)error {
+    AWSStreamingResponseBodyParse *parse = self.parse;
+    self.parse = nil;
+    [parse.outputStream close];
+    dispatch_group_wait(parse.group, DISPATCH_TIME_FOREVER);
+    if (parse.error && error) {
+        *error = parse.error;
+    }
+    return parse.result;
+}
+
+- (void)cancelResponse {
+    // The parser reads the end of the stream and finishes on its own.
+    [self.parse.outputStream close];
+    self.parse = nil;
+}
+
+@end
@@ -0,0 +1,116 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Caches the responses of read requests that have an `ETag` or `Last-Modified` header, in memory and on disk, and
+ revalidates them: the next identical request is sent with `If-None-Match` and `If-Modified-Since`, and when the service
+ answers `304 Not Modified` the request completes with the cached response instead of downloading the body again.
+
+ Both tiers are bounded and evict the least recently used responses first. Responses that do not fit in memory stay on
+ disk.
+
+ Set it as `responseCache` on the configurations of the services whose responses may be cached, e.g. S3 for
+ `GetObject` and `HeadObject`, API Gateway or Location:
+
+     serviceConfiguration.responseCache = [AWSResponseCache defaultResponseCache];
+ */
+@interface AWSResponseCache : NSObject
+
+/**
+ A cache of 4MB in memory and 64MB in the caches directory.
+ */
++ (instancetype)defaultResponseCache;
+
+/**
+ @param memoryCapacity The maximum number of bytes of responses kept in memory.
+ @param diskCapacity   The maximum number of bytes of responses kept on disk. 0 keeps responses in memory only.
+ @param directoryURL   Where the responses are written. `nil` uses a directory in the caches directory.
+ */
+- (instancetype)initWithMemoryCapacity:(NSUInteger)memoryCapacity
+                          diskCapacity:(NSUInteger)diskCapacity
+                          directoryURL:(nullable NSURL *)directoryURL;
+
+@property (nonatomic, readonly) NSUInteger memoryCapacity;
+@property (nonatomic, readonly) NSUInteger diskCapacity;
+@property (nonatomic, readonly) NSUInteger currentMemoryUsage;
+@property (nonatomic, readonly) NSUInteger currentDiskUsage;
+
+/**
+ The number of requests answered with `304 Not Modified` that completed with a cached response.
+ */
+@property (nonatomic, readonly) uint64_t hitCount;
+
+/**
+ The number of cacheable requests that downloaded the response.
+ */
+@property (nonatomic, readonly) uint64_t missCount;
+
+/**
+ `hitCount / (hitCount + missCount)`, 0 before any request.
+ */
+@property (nonatomic, readonly) double hitRate;
+
+/**
+ Whether the response of `request` may be cached. `GET` and `HEAD` requests without a body, a `Range` header or
+ conditional headers set by the caller. Override to change which requests are cached.
+ */
+- (BOOL)shouldCacheRequest:(NSURLRequest *)request;
+
+/**
+ The key under which the response of `request` is cached. Headers set by the signer, which change with every
+ signature, are left out. The service authorizes each revalidation, so a cached response is only returned to callers
+ allowed to read it.
+ */
+- (NSString *)keyForRequest:(NSURLRequest *)request;
+
+/**
+ Used by `AWSURLSessionManager` before `request` is signed.
+
+ @return The cached response for `request`, whose validators have been added to `request`, `nil` when there is none.
+ */
+- (nullable NSCachedURLResponse *)prepareRequest:(NSMutableURLRequest *)request;
+
+/**
+ Used by `AWSURLSessionManager` when `request`, prepared with `prepareRequest:`, received `304 Not Modified`.
+
+ @return `cachedResponse` with the headers of `response`, which replaces it in the cache.
+ */
+- (NSCachedURLResponse *)revalidateCachedResponse:(NSCachedURLResponse *)cachedResponse
+                                     withResponse:(NSHTTPURLResponse *)response
+                                       forRequest:(NSURLRequest *)request;
+
+/**
+ Used by `AWSURLSessionManager` when `request`, prepared with `prepareRequest:`, received a response other than
+ `304 Not Modified`. Caches successful responses with a validator and removes the cached response otherwise.
+ */
+- (void)storeResponse:(NSHTTPURLResponse *)response
+                 data:(nullable NSData *)data
+           forRequest:(NSURLRequest *)request;
+
+- (nullable NSCachedURLResponse *)cachedResponseForRequest:(NSURLRequest *)request;
+
+- (void)removeCachedResponseForRequest:(NSURLRequest *)request;
+
+- (void)removeAllCachedResponses;
+
+- (void)resetCounters;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,640 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSResponseCache.h"
+#import <CommonCrypto/CommonDigest.h>
+#import <pthread.h>
+#import "AWSCocoaLumberjack.h"
+
+static NSString *const AWSResponseCacheDirectoryName = @"com.amazonaws.AWSResponseCache";
+static NSUInteger const AWSResponseCacheDefaultMemoryCapacity = 4 * 1024 * 1024;
+static NSUInteger const AWSResponseCacheDefaultDiskCapacity = 64 * 1024 * 1024;
+
+static NSString *const AWSResponseCacheKeyKey = @"Key";
+static NSString *const AWSResponseCacheURLKey = @"URL";
+static NSString *const AWSResponseCacheStatusCodeKey = @"StatusCode";
+static NSString *const AWSResponseCacheHeadersKey = @"Headers";
+static NSString *const AWSResponseCacheBodyKey = @"Body";
+
+#pragma mark - AWSResponseCacheLRU
+
+@interface AWSResponseCacheEntry : NSObject
+
+@property (nonatomic, strong) NSString *key;
+@property (nonatomic, strong) NSCachedURLResponse *cachedResponse;
+@property (nonatomic, assign) NSUInteger cost;
+@property (nonatomic, weak) AWSResponseCacheEntry *previous;
+@property (nonatomic, strong) AWSResponseCacheEntry *next;
+
+@end
+
+@implementation AWSResponseCacheEntry
+
+@end
+
+// A map whose entries are kept in the order they were used, to evict the least recently used ones. Not thread safe.
+@interface AWSResponseCacheLRU : NSObject
+
+@property (nonatomic, assign) NSUInteger capacity;
+@property (nonatomic, assign) NSUInteger totalCost;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, AWSResponseCacheEntry *> *entries;
+// The most recently used entry is the head.
+@property (nonatomic, strong) AWSResponseCacheEntry *head;
+@property (nonatomic, weak) AWSResponseCacheEntry *tail;
+
+@end
+
+@implementation AWSResponseCacheLRU
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    if (self = [super init]) {
+        _capacity = capacity;
+        _entries = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (AWSResponseCacheEntry *)entryForKey:(NSString *)key {
+    AWSResponseCacheEntry *entry = self.entries[key];
+    if (entry && entry != self.head) {
+        [self unlinkEntry:entry];
+        [self linkEntryAtHead:entry];
+    }
+    return entry;
+}
+
+/**
+ Adds the entry as the most recently used one, or appends it as the least recently used one, and returns the entries
+ evicted to stay within the capacity. An entry larger than the capacity is not added.
+ */
+- (NSArray<AWSResponseCacheEntry *> *)setCachedResponse:(NSCachedURLResponse *)cachedResponse
+                                                   cost:(NSUInteger)cost
+                                                 forKey:(NSString *)key
+                                     leastRecentlyUsed:(BOOL)leastRecentlyUsed {
+    [self removeEntryForKey:key];
+    if (cost > self.capacity) {
+        return @[];
+    }
+
+    AWSResponseCacheEntry *entry = [AWSResponseCacheEntry new];
+    entry.key = key;
+    entry.cachedResponse = cachedResponse;
+    entry.cost = cost;
+    self.entries[key] = entry;
+    self.totalCost += cost;
+    if (leastRecentlyUsed) {
+        [self linkEntryAtTail:entry];
+    } else {
+        [self linkEntryAtHead:entry];
+    }
+
+    NSMutableArray<AWSResponseCacheEntry *> *evictedEntries = [NSMutableArray new];
+    while (self.totalCost > self.capacity && self.tail) {
+        AWSResponseCacheEntry *evictedEntry = self.tail;
+        [self removeEntryForKey:evictedEntry.key];
+        [evictedEntries addObject:evictedEntry];
+    }
+    return evictedEntries;
+}
+
+- (AWSResponseCacheEntry *)removeEntryForKey:(NSString *)key {
+    AWSResponseCacheEntry *entry = self.entries[key];
+    if (entry) {
+        [self unlinkEntry:entry];
+        [self.entries removeObjectForKey:key];
+        self.totalCost -= entry.cost;
+    }
+    return entry;
+}
+
+- (void)removeAllEntries {
+    // Unlinks the entries one by one, releasing a long list recursively could exhaust the stack.
+    while (self.head) {
+        [self removeEntryForKey:self.head.key];
+    }
+}
+
+- (void)linkEntryAtHead:(AWSResponseCacheEntry *)entry {
+    entry.previous = nil;
+    entry.next = self.head;
+    self.head.previous = entry;
+    self.head = entry;
+    if (!self.tail) {
+        self.tail = entry;
+    }
+}
+
+- (void)linkEntryAtTail:(AWSResponseCacheEntry *)entry {
+    if (!self.tail) {
+        [self linkEntryAtHead:entry];
+        return;
+    }
+    entry.previous = self.tail;
+    entry.next = nil;
+    self.tail.next = entry;
+    self.tail = entry;
+}
+
+- (void)unlinkEntry:(AWSResponseCacheEntry *)entry {
+    AWSResponseCacheEntry *previous = entry.previous;
+    AWSResponseCacheEntry *next = entry.next;
+    if (previous) {
+        previous.next = next;
+    } else {
+        self.head = next;
+    }
+    if (next) {
+        next.previous = previous;
+    } else {
+        self.tail = previous;
+    }
+    entry.previous = nil;
+    entry.next = nil;
+}
+
+@end
+
+#pragma mark - AWSResponseCache
+
+@interface AWSResponseCache() {
+    pthread_mutex_t _lock;
+}
+
+// Guarded by `_lock`.
+@property (nonatomic, strong) AWSResponseCacheLRU *memoryCache;
+@property (nonatomic, assign) uint64_t hitCount;
+@property (nonatomic, assign) uint64_t missCount;
+
+// Only used on `diskQueue`. The keys are the file names.
+@property (nonatomic, strong) AWSResponseCacheLRU *diskCache;
+@property (nonatomic, strong) dispatch_queue_t diskQueue;
+@property (nonatomic, strong) NSURL *directoryURL;
+
+@end
+
+@implementation AWSResponseCache
+
++ (instancetype)defaultResponseCache {
+    static AWSResponseCache *_defaultResponseCache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _defaultResponseCache = [[AWSResponseCache alloc] initWithMemoryCapacity:AWSResponseCacheDefaultMemoryCapacity
+                                                                    diskCapacity:AWSResponseCacheDefaultDiskCapacity
+                                                                    directoryURL:nil];
+    });
+    return _defaultResponseCache;
+}
+
+- (instancetype)init {
+    return [self initWithMemoryCapacity:AWSResponseCacheDefaultMemoryCapacity
+                           diskCapacity:AWSResponseCacheDefaultDiskCapacity
+                           directoryURL:nil];
+}
+
+- (instancetype)initWithMemoryCapacity:(NSUInteger)memoryCapacity
+                          diskCapacity:(NSUInteger)diskCapacity
+                          directoryURL:(NSURL *)directoryURL {
+    if (self = [super init]) {
+        pthread_mutex_init(&_lock, NULL);
+        _memoryCache = [[AWSResponseCacheLRU alloc] initWithCapacity:memoryCapacity];
+        _diskQueue = dispatch_queue_create("com.amazonaws.AWSResponseCache", DISPATCH_QUEUE_SERIAL);
+        if (diskCapacity > 0) {
+            if (!directoryURL) {
+                NSString *cachesPath = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) firstObject];
+                directoryURL = [NSURL fileURLWithPath:[cachesPath stringByAppendingPathComponent:AWSResponseCacheDirectoryName]
+                                          isDirectory:YES];
+            }
+            _directoryURL = directoryURL;
+            // The index of the responses on disk is built on the disk queue, the first lookup waits for it.
+            _diskCache = [[AWSResponseCacheLRU alloc] initWithCapacity:diskCapacity];
+            dispatch_async(_diskQueue, ^{
+                [self loadDiskCache];
+            });
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+#pragma mark - Properties
+
+- (NSUInteger)memoryCapacity {
+    return self.memoryCache.capacity;
+}
+
+- (NSUInteger)diskCapacity {
+    return self.diskCache.capacity;
+}
+
+- (NSUInteger)currentMemoryUsage {
+    pthread_mutex_lock(&_lock);
+    NSUInteger currentMemoryUsage = self.memoryCache.totalCost;
+    pthread_mutex_unlock(&_lock);
+    return currentMemoryUsage;
+}
+
+- (NSUInteger)currentDiskUsage {
+    if (!self.diskCache) {
+        return 0;
+    }
+    __block NSUInteger currentDiskUsage = 0;
+    dispatch_sync(self.diskQueue, ^{
+        currentDiskUsage = self.diskCache.totalCost;
+    });
+    return currentDiskUsage;
+}
+
+- (uint64_t)hitCount {
+    pthread_mutex_lock(&_lock);
+    uint64_t hitCount = _hitCount;
+    pthread_mutex_unlock(&_lock);
+    return hitCount;
+}
+
+- (uint64_t)missCount {
+    pthread_mutex_lock(&_lock);
+    uint64_t missCount = _missCount;
+    pthread_mutex_unlock(&_lock);
+    return missCount;
+}
+
+- (double)hitRate {
+    pthread_mutex_lock(&_lock);
+    uint64_t requestCount = _hitCount + _missCount;
+    double hitRate = requestCount == 0 ? 0 : (double)_hitCount / requestCount;
+    pthread_mutex_unlock(&_lock);
+    return hitRate;
+}
+
+- (void)resetCounters {
+    pthread_mutex_lock(&_lock);
+    _hitCount = 0;
+    _missCount = 0;
+    pthread_mutex_unlock(&_lock);
+}
+
+#pragma mark - Requests
+
+- (BOOL)shouldCacheRequest:(NSURLRequest *)request {
+    NSString *HTTPMethod = [request.HTTPMethod uppercaseString];
+    if (![HTTPMethod isEqualToString:@"GET"] && ![HTTPMethod isEqualToString:@"HEAD"]) {
+        return NO;
+    }
+    if ([request.HTTPBody length] > 0 || request.HTTPBodyStream) {
+        return NO;
+    }
+    for (NSString *headerName in @[@"Range", @"If-None-Match", @"If-Modified-Since", @"If-Match", @"If-Unmodified-Since"]) {
+        if ([request valueForHTTPHeaderField:headerName]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+- (NSString *)keyForRequest:(NSURLRequest *)request {
+    NSMutableString *key = [NSMutableString stringWithFormat:@"%@ %@\n", [request.HTTPMethod uppercaseString], request.URL.absoluteString];
+
+    NSDictionary<NSString *, NSString *> *headers = [request allHTTPHeaderFields];
+    NSMutableArray<NSString *> *headerNames = [NSMutableArray arrayWithCapacity:[headers count]];
+    for (NSString *headerName in headers) {
+        NSString *lowercaseHeaderName = [headerName lowercaseString];
+        if ([lowercaseHeaderName isEqualToString:@"authorization"]
+            || [lowercaseHeaderName isEqualToString:@"host"]
+            || [lowercaseHeaderName isEqualToString:@"date"]
+            || [lowercaseHeaderName isEqualToString:@"x-amz-date"]
+            || [lowercaseHeaderName isEqualToString:@"x-amz-security-token"]
+            || [lowercaseHeaderName isEqualToString:@"x-amz-content-sha256"]
+            || [lowercaseHeaderName isEqualToString:@"user-agent"]
+            || [lowercaseHeaderName isEqualToString:@"x-amz-user-agent"]
+            || [lowercaseHeaderName isEqualToString:@"if-none-match"]
+            || [lowercaseHeaderName isEqualToString:@"if-modified-since"]
+            || [lowercaseHeaderName hasPrefix:@"amz-sdk-"]) {
+            continue;
+        }
+        [headerNames addObject:headerName];
+    }
+    [headerNames sortUsingSelector:@selector(caseInsensitiveCompare:)];
+    for (NSString *headerName in headerNames) {
+        [key appendFormat:@"%@:%@\n", [headerName lowercaseString], headers[headerName]];
+    }
+    return key;
+}
+
+- (NSCachedURLResponse *)prepareRequest:(NSMutableURLRequest *)request {
+    NSCachedURLResponse *cachedResponse = [self cachedResponseForRequest:request];
+    if (!cachedResponse) {
+        return nil;
+    }
+
+    NSHTTPURLResponse *response = (NSHTTPURLResponse *)cachedResponse.response;
+    NSString *ETag = [self valueForHeaderField:@"ETag" inResponse:response];
+    NSString *lastModified = [self valueForHeaderField:@"Last-Modified" inResponse:response];
+    if (ETag) {
+        [request setValue:ETag forHTTPHeaderField:@"If-None-Match"];
+    }
+    if (lastModified) {
+        [request setValue:lastModified forHTTPHeaderField:@"If-Modified-Since"];
+    }
+    return cachedResponse;
+}
+
+- (NSCachedURLResponse *)revalidateCachedResponse:(NSCachedURLResponse *)cachedResponse
+                                     withResponse:(NSHTTPURLResponse *)response
+                                       forRequest:(NSURLRequest *)request {
+    NSHTTPURLResponse *cachedHTTPResponse = (NSHTTPURLResponse *)cachedResponse.response;
+
+    // The headers of a 304 replace the stored ones, except the ones describing its own empty body.
+    NSMutableDictionary *headers = [[cachedHTTPResponse allHeaderFields] mutableCopy];
+    [[response allHeaderFields] enumerateKeysAndObjectsUsingBlock:^(NSString *headerName, NSString *value, BOOL *stop) {
+        if ([headerName caseInsensitiveCompare:@"Content-Length"] == NSOrderedSame
+            || [headerName caseInsensitiveCompare:@"Content-Encoding"] == NSOrderedSame
+            || [headerName caseInsensitiveCompare:@"Transfer-Encoding"] == NSOrderedSame) {
+            return;
+        }
+        for (NSString *cachedHeaderName in [headers allKeys]) {
+            if ([cachedHeaderName caseInsensitiveCompare:headerName] == NSOrderedSame) {
+                [headers removeObjectForKey:cachedHeaderName];
+            }
+        }
+        headers[headerName] = value;
+    }];
+    NSHTTPURLResponse *revalidatedResponse = [[NSHTTPURLResponse alloc] initWithURL:cachedHTTPResponse.URL
+                                                                         statusCode:cachedHTTPResponse.statusCode
+                                                                        HTTPVersion:@"HTTP/1.1"
+                                                                       headerFields:headers];
+    NSCachedURLResponse *revalidatedCachedResponse = [[NSCachedURLResponse alloc] initWithResponse:revalidatedResponse
+                                                                                              data:cachedResponse.data];
+    [self setCachedResponse:revalidatedCachedResponse forKey:[self keyForRequest:request]];
+
+    pthread_mutex_lock(&_lock);
+    _hitCount++;
+    pthread_mutex_unlock(&_lock);
+    return revalidatedCachedResponse;
+}
+
+- (void)storeResponse:(NSHTTPURLResponse *)response
+                 data:(NSData *)data
+           forRequest:(NSURLRequest *)request {
+    pthread_mutex_lock(&_lock);
+    _missCount++;
+    pthread_mutex_unlock(&_lock);
+
+    NSString *key = [self keyForRequest:request];
+    NSString *cacheControl = [self valueForHeaderField:@"Cache-Control" inResponse:response];
+    if (response.statusCode == 200
+        && ([self valueForHeaderField:@"ETag" inResponse:response] || [self valueForHeaderField:@"Last-Modified" inResponse:response])
+        && [cacheControl rangeOfString:@"no-store" options:NSCaseInsensitiveSearch].location == NSNotFound) {
+        NSCachedURLResponse *cachedResponse = [[NSCachedURLResponse alloc] initWithResponse:response
+                                                                                       data:[data copy] ?: [NSData data]];
+        [self setCachedResponse:cachedResponse forKey:key];
+    } else if ((response.statusCode >= 200 && response.statusCode < 300)
+               || response.statusCode == 404
+               || response.statusCode == 410) {
+        // The cached response is stale. Errors that may be transient keep it.
+        [self removeCachedResponseForKey:key];
+    }
+}
+
+- (NSCachedURLResponse *)cachedResponseForRequest:(NSURLRequest *)request {
+    NSString *key = [self keyForRequest:request];
+
+    pthread_mutex_lock(&_lock);
+    NSCachedURLResponse *cachedResponse = [self.memoryCache entryForKey:key].cachedResponse;
+    pthread_mutex_unlock(&_lock);
+    if (cachedResponse || !self.diskCache) {
+        return cachedResponse;
+    }
+
+    __block NSCachedURLResponse *diskCachedResponse = nil;
+    dispatch_sync(self.diskQueue, ^{
+        diskCachedResponse = [self readCachedResponseForKey:key];
+    });
+    if (diskCachedResponse) {
+        pthread_mutex_lock(&_lock);
+        [self.memoryCache setCachedResponse:diskCachedResponse
+                                       cost:[self costOfCachedResponse:diskCachedResponse]
+                                     forKey:key
+                          leastRecentlyUsed:NO];
+        pthread_mutex_unlock(&_lock);
+    }
+    return diskCachedResponse;
+}
+
+- (void)removeCachedResponseForRequest:(NSURLRequest *)request {
+    [self removeCachedResponseForKey:[self keyForRequest:request]];
+}
+
+- (void)removeAllCachedResponses {
+    pthread_mutex_lock(&_lock);
+    [self.memoryCache removeAllEntries];
+    pthread_mutex_unlock(&_lock);
+
+    if (self.diskCache) {
+        dispatch_sync(self.diskQueue, ^{
+            [self.diskCache removeAllEntries];
+            NSError *error = nil;
+            if ([[NSFileManager defaultManager] fileExistsAtPath:self.directoryURL.path]
+                && ![[NSFileManager defaultManager] removeItemAtURL:self.directoryURL error:&error]) {
+                AWSDDLogError(@"Failed to remove the response cache: %@", error);
+            }
+            [[NSFileManager defaultManager] createDirectoryAtURL:self.directoryURL
+                                     withIntermediateDirectories:YES
+                                                      attributes:nil
+                                                           error:nil];
+        });
+    }
+}
+
+#pragma mark - Helpers
+
+- (NSString *)valueForHeaderField:(NSString *)headerName inResponse:(NSHTTPURLResponse *)response {
+    NSDictionary *headers = [response allHeaderFields];
+    for (NSString *field in headers) {
+        if ([field caseInsensitiveCompare:headerName] == NSOrderedSame) {
+            return headers[field];
+        }
+    }
+    return nil;
+}
+
+- (NSUInteger)costOfCachedResponse:(NSCachedURLResponse *)cachedResponse {
+    NSUInteger cost = [cachedResponse.data length];
+    NSDictionary *headers = [(NSHTTPURLResponse *)cachedResponse.response allHeaderFields];
+    for (NSString *headerName in headers) {
+        cost += [headerName length] + [headers[headerName] length];
+    }
+    return cost;
+}
+
+- (void)setCachedResponse:(NSCachedURLResponse *)cachedResponse forKey:(NSString *)key {
+    pthread_mutex_lock(&_lock);
+    [self.memoryCache setCachedResponse:cachedResponse
+                                   cost:[self costOfCachedResponse:cachedResponse]
+                                 forKey:key
+                      leastRecentlyUsed:NO];
+    pthread_mutex_unlock(&_lock);
+
+    if (self.diskCache) {
+        dispatch_async(self.diskQueue, ^{
+            [self writeCachedResponse:cachedResponse forKey:key];
+        });
+    }
+}
+
+- (void)removeCachedResponseForKey:(NSString *)key {
+    pthread_mutex_lock(&_lock);
+    [self.memoryCache removeEntryForKey:key];
+    pthread_mutex_unlock(&_lock);
+
+    if (self.diskCache) {
+        dispatch_async(self.diskQueue, ^{
+            NSString *fileName = [self fileNameForKey:key];
+            if ([self.diskCache removeEntryForKey:fileName]) {
+                [[NSFileManager defaultManager] removeItemAtURL:[self.directoryURL URLByAppendingPathComponent:fileName] error:nil];
+            }
+        });
+    }
+}
+
+#pragma mark - Disk
+
+- (NSString *)fileNameForKey:(NSString *)key {
+    NSData *keyData = [key dataUsingEncoding:NSUTF8StringEncoding];
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256([keyData bytes], (CC_LONG)[keyData length], digest);
+    NSMutableString *fileName = [NSMutableString stringWithCapacity:CC_SHA256_DIGEST_LENGTH * 2];
+    for (NSUInteger i = 0; i < CC_SHA256_DIGEST_LENGTH; i++) {
+        [fileName appendFormat:@"%02x", digest[i]];
+    }
+    return fileName;
+}
+
+- (void)loadDiskCache {
+    NSError *error = nil;
+    if (![[NSFileManager defaultManager] createDirectoryAtURL:self.directoryURL
+                                  withIntermediateDirectories:YES
+                                                   attributes:nil
+                                                        error:&error]) {
+        AWSDDLogError(@"Failed to create the response cache directory: %@", error);
+        return;
+    }
+
+    NSArray<NSURLResourceKey> *resourceKeys = @[NSURLContentModificationDateKey, NSURLFileSizeKey];
+    NSArray<NSURL *> *fileURLs = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:self.directoryURL
+                                                               includingPropertiesForKeys:resourceKeys
+                                                                                  options:NSDirectoryEnumerationSkipsHiddenFiles
+                                                                                    error:nil];
+    NSMutableArray<NSDictionary<NSURLResourceKey, id> *> *files = [NSMutableArray arrayWithCapacity:[fileURLs count]];
+    for (NSURL *fileURL in fileURLs) {
+        NSMutableDictionary<NSURLResourceKey, id> *resourceValues = [[fileURL resourceValuesForKeys:resourceKeys error:nil] mutableCopy];
+        if (resourceValues[NSURLContentModificationDateKey] && resourceValues[NSURLFileSizeKey]) {
+            resourceValues[NSURLNameKey] = [fileURL lastPathComponent];
+            [files addObject:resourceValues];
+        }
+    }
+    // Reading a response touches its file, so the least recently used responses are the least recently modified files.
+    [files sortUsingComparator:^NSComparisonResult(NSDictionary *file1, NSDictionary *file2) {
+        return [file2[NSURLContentModificationDateKey] compare:file1[NSURLContentModificationDateKey]];
+    }];
+    for (NSDictionary<NSURLResourceKey, id> *file in files) {
+        NSArray<AWSResponseCacheEntry *> *evictedEntries = [self.diskCache setCachedResponse:nil
+                                                                                       cost:[file[NSURLFileSizeKey] unsignedIntegerValue]
+                                                                                     forKey:file[NSURLNameKey]
+                                                                          leastRecentlyUsed:YES];
+        [self removeFilesOfEntries:evictedEntries];
+    }
+}
+
+- (NSCachedURLResponse *)readCachedResponseForKey:(NSString *)key {
+    NSString *fileName = [self fileNameForKey:key];
+    if (![self.diskCache entryForKey:fileName]) {
+        return nil;
+    }
+
+    NSURL *fileURL = [self.directoryURL URLByAppendingPathComponent:fileName];
+    NSData *fileData = [NSData dataWithContentsOfURL:fileURL options:NSDataReadingMappedIfSafe error:nil];
+    NSDictionary *file = nil;
+    if (fileData) {
+        file = [NSPropertyListSerialization propertyListWithData:fileData
+                                                         options:NSPropertyListImmutable
+                                                          format:NULL
+                                                           error:nil];
+    }
+    // A different key with the same hash is a miss.
+    if (![file isKindOfClass:[NSDictionary class]]
+        || ![file[AWSResponseCacheKeyKey] isEqual:key]
+        || ![file[AWSResponseCacheBodyKey] isKindOfClass:[NSData class]]) {
+        AWSDDLogWarn(@"Ignoring unreadable cached response at %@", fileURL);
+        return nil;
+    }
+
+    [[NSFileManager defaultManager] setAttributes:@{NSFileModificationDate : [NSDate date]}
+                                     ofItemAtPath:fileURL.path
+                                            error:nil];
+
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:file[AWSResponseCacheURLKey]]
+                                                              statusCode:[file[AWSResponseCacheStatusCodeKey] integerValue]
+                                                             HTTPVersion:@"HTTP/1.1"
+                                                            headerFields:file[AWSResponseCacheHeadersKey]];
+    return [[NSCachedURLResponse alloc] initWithResponse:response
+                                                    data:file[AWSResponseCacheBodyKey]];
+}
+
+- (void)writeCachedResponse:(NSCachedURLResponse *)cachedResponse forKey:(NSString *)key {
+    NSHTTPURLResponse *response = (NSHTTPURLResponse *)cachedResponse.response;
+    NSDictionary *file = @{AWSResponseCacheKeyKey : key,
+                           AWSResponseCacheURLKey : response.URL.absoluteString ?: @"",
+                           AWSResponseCacheStatusCodeKey : @(response.statusCode),
+                           AWSResponseCacheHeadersKey : [response allHeaderFields] ?: @{},
+                           AWSResponseCacheBodyKey : cachedResponse.data};
+    NSError *error = nil;
+    NSData *fileData = [NSPropertyListSerialization dataWithPropertyList:file
+                                                                  format:NSPropertyListBinaryFormat_v1_0
+                                                                 options:0
+                                                                   error:&error];
+    NSString *fileName = [self fileNameForKey:key];
+    if (!fileData || [fileData length] > self.diskCache.capacity) {
+        if (error) {
+            AWSDDLogError(@"Failed to serialize the cached response: %@", error);
+        }
+        if ([self.diskCache removeEntryForKey:fileName]) {
+            [[NSFileManager defaultManager] removeItemAtURL:[self.directoryURL URLByAppendingPathComponent:fileName] error:nil];
+        }
+        return;
+    }
+
+    if (![fileData writeToURL:[self.directoryURL URLByAppendingPathComponent:fileName]
+                      options:NSDataWritingAtomic
+                        error:&error]) {
+        AWSDDLogError(@"Failed to write the cached response: %@", error);
+        return;
+    }
+    NSArray<AWSResponseCacheEntry *> *evictedEntries = [self.diskCache setCachedResponse:nil
+                                                                                   cost:[fileData length]
+                                                                                 forKey:fileName
+                                                                      leastRecentlyUsed:NO];
+    [self removeFilesOfEntries:evictedEntries];
+}
+
+- (void)removeFilesOfEntries:(NSArray<AWSResponseCacheEntry *> *)entries {
+    for (AWSResponseCacheEntry *entry in entries) {
+        [[NSFileManager defaultManager] removeItemAtURL:[self.directoryURL URLByAppendingPathComponent:entry.key] error:nil];
+    }
+}
+
+@end
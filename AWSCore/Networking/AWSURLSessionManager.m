@@ -20,6 +20,10 @@
 #import "AWSSignature.h"
 #import "AWSBolts.h"
 #import "AWSCredentialsProvider.h"
+#import "AWSNetworkingMetrics.h"
+#import "AWSRequestCoalescer.h"
+#import "AWSResponseCache.h"
+#import "AWSURLSessionPool.h"
 
 NSString* const AWSResponseObjectErrorUserInfoKey = @"ResponseObjectError";
 
@@ -46,14 +50,23 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 @property (nonatomic, strong) NSError *error;
 @property (nonatomic, strong) id responseObject;
 @property (nonatomic, strong) NSMutableData *responseData;
+// Set for the attempt when the body of a successful response goes to a consumer instead of `responseData`.
+@property (nonatomic, strong) id<AWSNetworkingResponseBodyConsumer> responseBodyConsumer;
 @property (nonatomic, strong) NSFileHandle *responseFilehandle;
 @property (nonatomic, strong) NSURL *tempDownloadedFileURL;
 @property (nonatomic, assign) BOOL shouldWriteDirectly;
 @property (nonatomic, assign) BOOL shouldWriteToFile;
+// Set for the attempt when its response may be cached, before the validators of `cachedResponse` were added.
+@property (nonatomic, strong) NSURLRequest *responseCacheRequest;
+@property (nonatomic, strong) NSCachedURLResponse *cachedResponse;
 
 @property (atomic, assign) int64_t lastTotalLengthOfChunkSignatureSent;
 @property (atomic, assign) int64_t payloadTotalBytesWritten;
 
+// Only set when the request has a metrics handler.
+@property (nonatomic, strong) AWSNetworkingRequestMetrics *metrics;
+@property (nonatomic, assign) CFAbsoluteTime startTime;
+
 @end
 
 @implementation AWSURLSessionManagerDelegate
@@ -76,6 +89,43 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 
 @end
 
+#pragma mark - AWSNetworkingRequestMetrics
+
+@interface AWSNetworkingRequestMetrics()
+
+@property (nonatomic, strong) NSURL *URL;
+@property (nonatomic, assign) AWSHTTPMethod HTTPMethod;
+@property (nonatomic, assign) NSInteger statusCode;
+@property (nonatomic, strong) NSError *error;
+@property (nonatomic, assign) uint32_t retryCount;
+@property (nonatomic, assign, getter=isReusedConnection) BOOL reusedConnection;
+
+@property (nonatomic, assign) NSTimeInterval serializationDuration;
+@property (nonatomic, assign) NSTimeInterval credentialsWaitDuration;
+@property (nonatomic, assign) NSTimeInterval signingDuration;
+@property (nonatomic, assign) NSTimeInterval domainLookupDuration;
+@property (nonatomic, assign) NSTimeInterval connectDuration;
+@property (nonatomic, assign) NSTimeInterval secureConnectionDuration;
+@property (nonatomic, assign) NSTimeInterval timeToFirstByte;
+@property (nonatomic, assign) NSTimeInterval responseTransferDuration;
+@property (nonatomic, assign) NSTimeInterval parsingDuration;
+@property (nonatomic, assign) NSTimeInterval retryDelayDuration;
+@property (nonatomic, assign) NSTimeInterval totalDuration;
+
+@end
+
+#pragma mark - AWSURLSessionPool
+
+@interface AWSURLSessionPool()
+
++ (NSURLSessionConfiguration *)sessionConfigurationForConfiguration:(AWSNetworkingConfiguration *)configuration;
+- (NSURLSession *)sessionForConfiguration:(AWSNetworkingConfiguration *)configuration;
+- (void)setDelegate:(id<NSURLSessionDataDelegate>)delegate
+            forTask:(NSURLSessionTask *)task
+          inSession:(NSURLSession *)session;
+
+@end
+
 #pragma mark - AWSURLSessionManager
 
 //const int64_t AWSMinimumDownloadTaskSize = 1000000;
@@ -83,6 +133,8 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 @interface AWSURLSessionManager()
 
 @property (nonatomic, strong) NSURLSession *session;
+// Set when `session` is shared, the pool routes its callbacks to this manager.
+@property (nonatomic, strong) AWSURLSessionPool *sessionPool;
 @property (nonatomic, strong) AWSSynchronizedMutableDictionary *sessionManagerDelegates;
 @property (nonatomic) BOOL isSessionValid;
 
@@ -105,21 +157,14 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
     if (self = [super init]) {
         _configuration = configuration;
 
-
-        NSURLSessionConfiguration *sessionConfiguration = [NSURLSessionConfiguration defaultSessionConfiguration];
-        sessionConfiguration.URLCache = nil;
-        if (configuration.timeoutIntervalForRequest > 0) {
-            sessionConfiguration.timeoutIntervalForRequest = configuration.timeoutIntervalForRequest;
-        }
-        if (configuration.timeoutIntervalForResource > 0) {
-            sessionConfiguration.timeoutIntervalForResource = configuration.timeoutIntervalForResource;
+        if (configuration.sessionPool) {
+            _sessionPool = configuration.sessionPool;
+            _session = [_sessionPool sessionForConfiguration:configuration];
+        } else {
+            _session = [NSURLSession sessionWithConfiguration:[AWSURLSessionPool sessionConfigurationForConfiguration:configuration]
+                                                     delegate:self
+                                                delegateQueue:nil];
         }
-        sessionConfiguration.allowsCellularAccess = configuration.allowsCellularAccess;
-        sessionConfiguration.sharedContainerIdentifier = configuration.sharedContainerIdentifier;
-        
-        _session = [NSURLSession sessionWithConfiguration:sessionConfiguration
-                                                 delegate:self
-                                            delegateQueue:nil];
         _sessionManagerDelegates = [AWSSynchronizedMutableDictionary new];
         _isSessionValid = YES;
     }
@@ -137,6 +182,11 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
     delegate.downloadingFileURL = request.downloadingFileURL;
     delegate.uploadingFileURL = request.uploadingFileURL;
     delegate.shouldWriteDirectly = request.shouldWriteDirectly;
+    if (request.metricsHandler) {
+        delegate.metrics = [AWSNetworkingRequestMetrics new];
+        delegate.metrics.HTTPMethod = request.HTTPMethod;
+        delegate.startTime = CFAbsoluteTimeGetCurrent();
+    }
 
     [self taskWithDelegate:delegate];
 
@@ -145,14 +195,19 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 
 - (void)taskWithDelegate:(AWSURLSessionManagerDelegate *)delegate {
     if (!self.session || !self.isSessionValid) {
-        delegate.taskCompletionSource.error = [NSError errorWithDomain:AWSNetworkingErrorDomain
-                                                                  code:AWSNetworkingErrorSessionInvalid
-                                                              userInfo:@{NSLocalizedDescriptionKey: @"URLSession is nil or invalidated"}];
+        NSError *error = [NSError errorWithDomain:AWSNetworkingErrorDomain
+                                             code:AWSNetworkingErrorSessionInvalid
+                                         userInfo:@{NSLocalizedDescriptionKey: @"URLSession is nil or invalidated"}];
+        [self reportMetricsForDelegate:delegate response:nil error:error];
+        delegate.taskCompletionSource.error = error;
         return;
     }
 
     if (delegate.downloadingFileURL) delegate.shouldWriteToFile = YES;
     delegate.responseData = nil;
+    delegate.responseBodyConsumer = nil;
+    delegate.responseCacheRequest = nil;
+    delegate.cachedResponse = nil;
     delegate.responseObject = nil;
     delegate.error = nil;
     NSMutableURLRequest *mutableRequest = [NSMutableURLRequest requestWithURL:delegate.request.URL];
@@ -160,20 +215,73 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 
     AWSNetworkingRequest *request = delegate.request;
     if (request.isCancelled) {
-        delegate.taskCompletionSource.error = [NSError errorWithDomain:AWSNetworkingErrorDomain
-                                                                  code:AWSNetworkingErrorCancelled
-                                                              userInfo:nil];
+        NSError *error = [NSError errorWithDomain:AWSNetworkingErrorDomain
+                                             code:AWSNetworkingErrorCancelled
+                                         userInfo:nil];
+        [self reportMetricsForDelegate:delegate response:nil error:error];
+        delegate.taskCompletionSource.error = error;
         return;
     }
 
     mutableRequest.HTTPMethod = [NSString aws_stringWithHTTPMethod:delegate.request.HTTPMethod];
 
+    if (request.responseItemHandler
+        && [request.responseSerializer respondsToSelector:@selector(setResponseItemHandler:)]) {
+        [request.responseSerializer setResponseItemHandler:request.responseItemHandler];
+    }
+
+    AWSNetworkingRequestMetrics *metrics = delegate.metrics;
+    __block CFAbsoluteTime phaseStart = CFAbsoluteTimeGetCurrent();
+
     AWSTask *task = [AWSTask taskWithResult:nil];
 
+    // The adaptive retry mode may hold the attempt back to limit the rate of requests to the endpoint.
+    NSTimeInterval timeIntervalBeforeAttempt = 0;
+    if ([request.retryHandler respondsToSelector:@selector(timeIntervalBeforeAttempt:originalRequest:)]) {
+        timeIntervalBeforeAttempt = [request.retryHandler timeIntervalBeforeAttempt:delegate.currentRetryCount
+                                                                    originalRequest:request];
+    }
+    if (timeIntervalBeforeAttempt > 0) {
+        metrics.retryDelayDuration += timeIntervalBeforeAttempt;
+        task = [[AWSTask taskWithDelay:(int)ceil(timeIntervalBeforeAttempt * 1000)] continueWithBlock:^id(AWSTask *task) {
+            phaseStart = CFAbsoluteTimeGetCurrent();
+            return nil;
+        }];
+    }
+
     if (request.requestSerializer) {
-        task = [request.requestSerializer serializeRequest:mutableRequest
-                                                   headers:request.headers
-                                                parameters:request.parameters];
+        if (timeIntervalBeforeAttempt > 0) {
+            task = [task continueWithSuccessBlock:^id(AWSTask *task) {
+                return [request.requestSerializer serializeRequest:mutableRequest
+                                                           headers:request.headers
+                                                        parameters:request.parameters];
+            }];
+        } else {
+            task = [request.requestSerializer serializeRequest:mutableRequest
+                                                       headers:request.headers
+                                                    parameters:request.parameters];
+        }
+    }
+
+    if (metrics) {
+        task = [task continueWithSuccessBlock:^id(AWSTask *task) {
+            CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+            metrics.serializationDuration += now - phaseStart;
+            phaseStart = now;
+            return nil;
+        }];
+    }
+
+    // The validators are added before the request is signed.
+    if ([self shouldCacheResponseForDelegate:delegate]) {
+        AWSResponseCache *responseCache = request.responseCache;
+        task = [task continueWithSuccessBlock:^id(AWSTask *task) {
+            if ([responseCache shouldCacheRequest:mutableRequest]) {
+                delegate.responseCacheRequest = [mutableRequest copy];
+                delegate.cachedResponse = [responseCache prepareRequest:mutableRequest];
+            }
+            return nil;
+        }];
     }
 
     for(id<AWSNetworkingRequestInterceptor>interceptor in request.requestInterceptors) {
@@ -183,9 +291,34 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
     }
 
     [[[task continueWithSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        if (metrics) {
+            // The signers report how long they waited for credentials, the rest of the interceptors' time is signing.
+            CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+            NSTimeInterval credentialsWaitDuration = [[NSURLProtocol propertyForKey:AWSSignatureCredentialsWaitDurationKey
+                                                                          inRequest:mutableRequest] doubleValue];
+            metrics.credentialsWaitDuration += credentialsWaitDuration;
+            metrics.signingDuration += MAX(now - phaseStart - credentialsWaitDuration, 0);
+            phaseStart = now;
+        }
         AWSNetworkingRequest *request = delegate.request;
         return [request.requestSerializer validateRequest:mutableRequest];
     }] continueWithSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        if (metrics) {
+            metrics.serializationDuration += CFAbsoluteTimeGetCurrent() - phaseStart;
+        }
+
+        if ([self shouldCoalesceDelegate:delegate]) {
+            AWSTask *inFlightTask = [delegate.request.requestCoalescer inFlightTaskForRequest:mutableRequest
+                                                                               registeringTask:delegate.taskCompletionSource.task];
+            if (inFlightTask) {
+                [inFlightTask continueWithBlock:^id(AWSTask *inFlightTask) {
+                    [self completeCoalescedDelegate:delegate withTask:inFlightTask];
+                    return nil;
+                }];
+                return nil;
+            }
+        }
+
         switch (delegate.taskType) {
             case AWSURLSessionTaskTypeData:
                 delegate.request.task = [self.session dataTaskWithRequest:mutableRequest];
@@ -205,6 +338,9 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 
             [self.sessionManagerDelegates setObject:delegate
                                              forKey:@(((NSURLSessionTask *)delegate.request.task).taskIdentifier)];
+            if (self.sessionPool) {
+                [self.sessionPool setDelegate:self forTask:delegate.request.task inSession:self.session];
+            }
 
             [self printHTTPHeadersAndBodyForRequest:delegate.request.task.originalRequest];
 
@@ -220,6 +356,7 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
     }] continueWithBlock:^id(AWSTask *task) {
         if (task.error) {
             NSError *error = task.error;
+            [self reportMetricsForDelegate:delegate response:nil error:error];
             delegate.taskCompletionSource.error = error;
         }
         return nil;
@@ -236,6 +373,10 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 - (void)invalidate {
     // Invalidate the session so its strong reference to self is released.
     self.isSessionValid = NO;
+    if (self.sessionPool) {
+        // Other clients use the session. The pool releases this manager once its tasks complete.
+        return;
+    }
     [self.session finishTasksAndInvalidate];
 }
 
@@ -275,6 +416,25 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
             [[NSFileManager defaultManager] removeItemAtPath:delegate.tempDownloadedFileURL.path error:nil];
         }
 
+        id responseBody = delegate.responseData;
+        NSTimeInterval consumerFinishDuration = 0;
+        if (delegate.responseBodyConsumer) {
+            if (delegate.error) {
+                if ([delegate.responseBodyConsumer respondsToSelector:@selector(cancelResponse)]) {
+                    [delegate.responseBodyConsumer cancelResponse];
+                }
+            } else {
+                // Waits for a consumer parsing the body to catch up.
+                NSError *error = nil;
+                CFAbsoluteTime finishStart = CFAbsoluteTimeGetCurrent();
+                responseBody = [delegate.responseBodyConsumer finishResponseWithError:&error];
+                consumerFinishDuration = CFAbsoluteTimeGetCurrent() - finishStart;
+                if (error) {
+                    delegate.error = error;
+                }
+            }
+        }
+
 
         if (!delegate.error
             && [sessionTask.response isKindOfClass:[NSHTTPURLResponse class]]) {
@@ -302,11 +462,13 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                 } else {
                     if ([delegate.request.responseSerializer respondsToSelector:@selector(responseObjectForResponse:originalRequest:currentRequest:data:error:)]) {
                         NSError *error = nil;
+                        CFAbsoluteTime parsingStart = CFAbsoluteTimeGetCurrent();
                         delegate.responseObject = [delegate.request.responseSerializer responseObjectForResponse:httpResponse
                                                                                                  originalRequest:sessionTask.originalRequest
                                                                                                   currentRequest:sessionTask.currentRequest
                                                                                                             data:delegate.downloadingFileURL
                                                                                                            error:&error];
+                        delegate.metrics.parsingDuration += CFAbsoluteTimeGetCurrent() - parsingStart;
                         if (error) {
                             delegate.error = error;
                         }
@@ -316,14 +478,31 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                     }
                 }
             } else if (!delegate.error) {
+                if (delegate.responseCacheRequest) {
+                    AWSResponseCache *responseCache = delegate.request.responseCache;
+                    if (httpResponse.statusCode == 304 && delegate.cachedResponse) {
+                        NSCachedURLResponse *cachedResponse = [responseCache revalidateCachedResponse:delegate.cachedResponse
+                                                                                         withResponse:httpResponse
+                                                                                           forRequest:delegate.responseCacheRequest];
+                        httpResponse = (NSHTTPURLResponse *)cachedResponse.response;
+                        responseBody = cachedResponse.data;
+                    } else {
+                        [responseCache storeResponse:httpResponse
+                                                data:[responseBody isKindOfClass:[NSData class]] ? responseBody : nil
+                                          forRequest:delegate.responseCacheRequest];
+                    }
+                }
+
                 // need to call responseSerializer if there is no client-side error.
                 if ([delegate.request.responseSerializer respondsToSelector:@selector(responseObjectForResponse:originalRequest:currentRequest:data:error:)]) {
                     NSError *error = nil;
+                    CFAbsoluteTime parsingStart = CFAbsoluteTimeGetCurrent();
                     delegate.responseObject = [delegate.request.responseSerializer responseObjectForResponse:httpResponse
                                                                                              originalRequest:sessionTask.originalRequest
                                                                                               currentRequest:sessionTask.currentRequest
-                                                                                                        data:delegate.responseData
+                                                                                                        data:responseBody
                                                                                                        error:&error];
+                    delegate.metrics.parsingDuration += CFAbsoluteTimeGetCurrent() - parsingStart + consumerFinishDuration;
                     if (error) {
                         if ([delegate.responseObject isKindOfClass:[NSDictionary class]]) {
                             NSDictionary *responseObject = (NSDictionary *)delegate.responseObject;
@@ -343,11 +522,20 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                     }
                 }
                 else {
-                    delegate.responseObject = delegate.responseData;
+                    delegate.responseObject = responseBody;
                 }
             }
         }
 
+        id<AWSURLRequestRetryHandler> retryHandler = delegate.request.retryHandler;
+        if ([retryHandler respondsToSelector:@selector(attempt:didCompleteForRequest:response:error:)]
+            && ([sessionTask.response isKindOfClass:[NSHTTPURLResponse class]] || sessionTask.response == nil)) {
+            [retryHandler attempt:delegate.currentRetryCount
+            didCompleteForRequest:delegate.request
+                         response:(NSHTTPURLResponse *)sessionTask.response
+                            error:delegate.error];
+        }
+
         if (delegate.error
             && ([sessionTask.response isKindOfClass:[NSHTTPURLResponse class]] || sessionTask.response == nil)
             && delegate.request.retryHandler) {
@@ -356,6 +544,14 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                                                                                  response:(NSHTTPURLResponse *)sessionTask.response
                                                                                      data:delegate.responseData
                                                                                     error:delegate.error];
+            if (retryType != AWSNetworkingRetryTypeShouldNotRetry
+                && [retryHandler respondsToSelector:@selector(acquireRetry:originalRequest:error:)]
+                && ![retryHandler acquireRetry:delegate.currentRetryCount
+                               originalRequest:delegate.request
+                                         error:delegate.error]) {
+                AWSDDLogDebug(@"The retry quota of %@ is exhausted, not retrying.", sessionTask.originalRequest.URL.host);
+                retryType = AWSNetworkingRetryTypeShouldNotRetry;
+            }
             switch (retryType) {
                 case AWSNetworkingRetryTypeShouldCorrectClockSkewAndRetry: {
                     //Correct Clock Skew
@@ -392,17 +588,28 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                 }
                     // Keep going to the next 'case' statement.
                 case AWSNetworkingRetryTypeShouldRetry: {
-                    NSTimeInterval timeIntervalToSleep = [delegate.request.retryHandler timeIntervalForRetry:delegate.currentRetryCount
-                                                                                                    response:(NSHTTPURLResponse *)sessionTask.response
-                                                                                                        data:delegate.responseData
-                                                                                                       error:delegate.error];
+                    NSTimeInterval timeIntervalToSleep = 0;
+                    if ([retryHandler respondsToSelector:@selector(timeIntervalForRetry:originalRequest:response:data:error:)]) {
+                        timeIntervalToSleep = [retryHandler timeIntervalForRetry:delegate.currentRetryCount
+                                                                 originalRequest:delegate.request
+                                                                        response:(NSHTTPURLResponse *)sessionTask.response
+                                                                            data:delegate.responseData
+                                                                           error:delegate.error];
+                    } else {
+                        timeIntervalToSleep = [retryHandler timeIntervalForRetry:delegate.currentRetryCount
+                                                                        response:(NSHTTPURLResponse *)sessionTask.response
+                                                                            data:delegate.responseData
+                                                                           error:delegate.error];
+                    }
                     [NSThread sleepForTimeInterval:timeIntervalToSleep];
+                    delegate.metrics.retryDelayDuration += timeIntervalToSleep;
                     delegate.currentRetryCount++;
                     [self taskWithDelegate:delegate];
                 }
                     break;
 
                 case AWSNetworkingRetryTypeShouldNotRetry: {
+                    [self reportMetricsForDelegate:delegate response:sessionTask.response error:delegate.error];
                     if (delegate.error) {
                         NSError *error = delegate.error;
                         delegate.taskCompletionSource.error = error;
@@ -425,6 +632,7 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                 [retryHandler setValue:@NO forKey:@"isClockSkewRetried"];
             }
 
+            [self reportMetricsForDelegate:delegate response:sessionTask.response error:delegate.error];
             if (delegate.error) {
                 NSError *error = delegate.error;
                 delegate.taskCompletionSource.error = error;
@@ -464,6 +672,40 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
     }
 }
 
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)taskMetrics API_AVAILABLE(ios(10.0)) {
+    AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:@(task.taskIdentifier)];
+    AWSNetworkingRequestMetrics *metrics = delegate.metrics;
+    if (!metrics) {
+        return;
+    }
+
+    // Redirects add transactions, the last one is the request that produced the response.
+    NSURLSessionTaskTransactionMetrics *transaction = [taskMetrics.transactionMetrics lastObject];
+    if (!transaction) {
+        return;
+    }
+    if (!transaction.isReusedConnection) {
+        metrics.reusedConnection = NO;
+    }
+    if (transaction.domainLookupStartDate && transaction.domainLookupEndDate) {
+        metrics.domainLookupDuration += [transaction.domainLookupEndDate timeIntervalSinceDate:transaction.domainLookupStartDate];
+    }
+    // connectEndDate includes the TLS handshake, which is reported separately.
+    if (transaction.connectStartDate && transaction.connectEndDate) {
+        NSDate *connectEndDate = transaction.secureConnectionStartDate ?: transaction.connectEndDate;
+        metrics.connectDuration += [connectEndDate timeIntervalSinceDate:transaction.connectStartDate];
+    }
+    if (transaction.secureConnectionStartDate && transaction.secureConnectionEndDate) {
+        metrics.secureConnectionDuration += [transaction.secureConnectionEndDate timeIntervalSinceDate:transaction.secureConnectionStartDate];
+    }
+    if (transaction.requestStartDate && transaction.responseStartDate) {
+        metrics.timeToFirstByte += [transaction.responseStartDate timeIntervalSinceDate:transaction.requestStartDate];
+    }
+    if (transaction.responseStartDate && transaction.responseEndDate) {
+        metrics.responseTransferDuration += [transaction.responseEndDate timeIntervalSinceDate:transaction.responseStartDate];
+    }
+}
+
 #pragma mark - NSURLSessionDataDelegate
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response
@@ -476,6 +718,24 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
         
         if (httpResponse.statusCode >= 200 && httpResponse.statusCode < 300) {
             // status is good, we can keep value of shouldWriteToFile
+            if (!delegate.shouldWriteToFile) {
+                id<AWSNetworkingResponseBodyConsumer> responseBodyConsumer = delegate.request.responseBodyConsumer;
+                if (!responseBodyConsumer
+                    && [delegate.request.responseSerializer respondsToSelector:@selector(responseBodyConsumerForResponse:originalRequest:)]) {
+                    responseBodyConsumer = [delegate.request.responseSerializer responseBodyConsumerForResponse:httpResponse
+                                                                                                originalRequest:dataTask.originalRequest];
+                }
+                if (responseBodyConsumer) {
+                    NSError *error = nil;
+                    if (![responseBodyConsumer beginResponse:httpResponse error:&error]) {
+                        AWSDDLogError(@"Error: [%@]", error);
+                        delegate.error = error ?: [NSError errorWithDomain:AWSNetworkingErrorDomain code:AWSNetworkingErrorUnknown userInfo:nil];
+                        completionHandler(NSURLSessionResponseCancel);
+                        return;
+                    }
+                    delegate.responseBodyConsumer = responseBodyConsumer;
+                }
+            }
         } else {
             // got error status code, avoid write data to disk
             delegate.shouldWriteToFile = NO;
@@ -571,6 +831,13 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
             delegate.error = [NSError errorWithDomain:AWSNetworkingErrorDomain code:AWSNetworkingErrorUnknown userInfo: userInfo];
             [dataTask cancel];
         }
+    } else if (delegate.responseBodyConsumer) {
+        NSError *error = nil;
+        if (!delegate.error && ![delegate.responseBodyConsumer consumeData:data error:&error]) {
+            AWSDDLogError(@"Error: [%@]", error);
+            delegate.error = error ?: [NSError errorWithDomain:AWSNetworkingErrorDomain code:AWSNetworkingErrorUnknown userInfo:nil];
+            [dataTask cancel];
+        }
     } else {
         if (!delegate.responseData) {
             delegate.responseData = [NSMutableData dataWithData:data];
@@ -602,6 +869,75 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 
 #pragma mark - Helper methods
 
+- (BOOL)shouldCacheResponseForDelegate:(AWSURLSessionManagerDelegate *)delegate {
+    AWSNetworkingRequest *request = delegate.request;
+    // Responses going to a file or a consumer are never held in memory.
+    return request.responseCache
+    && !delegate.downloadingFileURL
+    && !request.responseBodyConsumer
+    && !request.responseItemHandler;
+}
+
+- (BOOL)shouldCoalesceDelegate:(AWSURLSessionManagerDelegate *)delegate {
+    AWSNetworkingRequest *request = delegate.request;
+    // Only first attempts join; a retry is already the only request waiting for its result.
+    return request.requestCoalescer
+    && delegate.currentRetryCount == 0
+    && !delegate.downloadingFileURL
+    && !request.responseBodyConsumer
+    && !request.downloadProgress
+    && !request.responseItemHandler;
+}
+
+- (void)completeCoalescedDelegate:(AWSURLSessionManagerDelegate *)delegate
+                         withTask:(AWSTask *)inFlightTask {
+    // A request that joined another one has no task of its own for `-[AWSNetworkingRequest cancel]` to cancel.
+    if (delegate.request.isCancelled) {
+        NSError *error = [NSError errorWithDomain:AWSNetworkingErrorDomain
+                                             code:AWSNetworkingErrorCancelled
+                                         userInfo:nil];
+        [self reportMetricsForDelegate:delegate response:nil error:error];
+        delegate.taskCompletionSource.error = error;
+        return;
+    }
+
+    NSError *error = inFlightTask.error;
+    if (inFlightTask.isCancelled
+        || ([error.domain isEqualToString:AWSNetworkingErrorDomain] && error.code == AWSNetworkingErrorCancelled)
+        || ([error.domain isEqualToString:NSURLErrorDomain] && error.code == NSURLErrorCancelled)) {
+        // The request it joined was cancelled by its own caller, not this one.
+        [self taskWithDelegate:delegate];
+        return;
+    }
+
+    [self reportMetricsForDelegate:delegate response:nil error:error];
+    if (error) {
+        delegate.taskCompletionSource.error = error;
+    } else {
+        delegate.taskCompletionSource.result = inFlightTask.result;
+    }
+}
+
+- (void)reportMetricsForDelegate:(AWSURLSessionManagerDelegate *)delegate
+                        response:(NSURLResponse *)response
+                           error:(NSError *)error {
+    AWSNetworkingRequestMetrics *metrics = delegate.metrics;
+    AWSNetworkingMetricsBlock metricsHandler = delegate.request.metricsHandler;
+    if (!metrics || !metricsHandler) {
+        return;
+    }
+    delegate.metrics = nil;
+
+    metrics.URL = response.URL ?: delegate.request.task.originalRequest.URL;
+    if ([response isKindOfClass:[NSHTTPURLResponse class]]) {
+        metrics.statusCode = ((NSHTTPURLResponse *)response).statusCode;
+    }
+    metrics.error = error;
+    metrics.retryCount = delegate.currentRetryCount;
+    metrics.totalDuration = CFAbsoluteTimeGetCurrent() - delegate.startTime;
+    metricsHandler(metrics);
+}
+
 - (void)printHTTPHeadersAndBodyForRequest:(NSURLRequest *)request {
     AWSDDLogDebug(@"Request headers:\n%@", request.allHTTPHeaderFields);
     if([AWSDDLog sharedInstance].logLevel & AWSDDLogFlagDebug){
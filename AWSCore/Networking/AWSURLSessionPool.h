@@ -0,0 +1,59 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class AWSNetworkingConfiguration;
+@class AWSTask<__covariant ResultType>;
+
+/**
+ Shares `NSURLSession`s between service clients. `NSURLSession` keeps a pool of connections per host, so the clients of a
+ pool whose configurations have the same session settings (timeouts, `allowsCellularAccess`, `sharedContainerIdentifier`
+ and `maximumConnectionsPerHost`) reuse each other's connections instead of each paying for DNS, TCP and TLS on its
+ first request to a host.
+
+     AWSURLSessionPool *sessionPool = [AWSURLSessionPool sharedPool];
+     serviceConfiguration.sessionPool = sessionPool;
+     [sessionPool prewarmEndpoints:@[serviceConfiguration.endpoint.URL] configuration:serviceConfiguration];
+
+ The sessions of a pool live as long as the pool, which the configurations using it retain. Their idle connections are
+ closed by the system.
+ */
+@interface AWSURLSessionPool : NSObject
+
++ (instancetype)sharedPool;
+
+/**
+ The number of sessions in the pool, one per distinct session settings.
+ */
+@property (nonatomic, readonly) NSUInteger sessionCount;
+
+/**
+ Opens connections to `endpoints` ahead of the first request, with an unauthenticated `HEAD` request to the root of each
+ endpoint, in the session used by clients with the session settings of `configuration`.
+
+ @param endpoints     The URLs of the endpoints, e.g. `AWSEndpoint.URL`. Only the scheme, host and port are used.
+ @param configuration The configuration of the clients that will use the connections.
+ @return Completes when every endpoint answered, with an error if one of them could not be reached. The status of the
+ responses is ignored.
+ */
+- (AWSTask *)prewarmEndpoints:(NSArray<NSURL *> *)endpoints
+                configuration:(AWSNetworkingConfiguration *)configuration;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,192 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSURLSessionPool.h"
+#import "AWSNetworking.h"
+#import "AWSSynchronizedMutableDictionary.h"
+#import "AWSCocoaLumberjack.h"
+#import "AWSBolts.h"
+
+#pragma mark - AWSURLSessionPoolRouter
+
+// The delegate of a shared session, forwarding the callbacks of each task to the session manager that created it.
+@interface AWSURLSessionPoolRouter : NSObject <NSURLSessionDataDelegate>
+
+@property (nonatomic, strong) AWSSynchronizedMutableDictionary *sessionDelegates;
+
+@end
+
+@implementation AWSURLSessionPoolRouter
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _sessionDelegates = [AWSSynchronizedMutableDictionary new];
+    }
+    return self;
+}
+
+- (id<NSURLSessionDataDelegate>)delegateForTask:(NSURLSessionTask *)task {
+    return [self.sessionDelegates objectForKey:@(task.taskIdentifier)];
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
+    id<NSURLSessionDataDelegate> delegate = [self delegateForTask:task];
+    [self.sessionDelegates removeObjectForKey:@(task.taskIdentifier)];
+    [delegate URLSession:session task:task didCompleteWithError:error];
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didSendBodyData:(int64_t)bytesSent totalBytesSent:(int64_t)totalBytesSent totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend {
+    id<NSURLSessionDataDelegate> delegate = [self delegateForTask:task];
+    if ([delegate respondsToSelector:@selector(URLSession:task:didSendBodyData:totalBytesSent:totalBytesExpectedToSend:)]) {
+        [delegate URLSession:session task:task didSendBodyData:bytesSent totalBytesSent:totalBytesSent totalBytesExpectedToSend:totalBytesExpectedToSend];
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics API_AVAILABLE(ios(10.0)) {
+    id<NSURLSessionDataDelegate> delegate = [self delegateForTask:task];
+    if ([delegate respondsToSelector:@selector(URLSession:task:didFinishCollectingMetrics:)]) {
+        [delegate URLSession:session task:task didFinishCollectingMetrics:metrics];
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response
+ completionHandler:(void (^)(NSURLSessionResponseDisposition disposition))completionHandler {
+    id<NSURLSessionDataDelegate> delegate = [self delegateForTask:dataTask];
+    if ([delegate respondsToSelector:@selector(URLSession:dataTask:didReceiveResponse:completionHandler:)]) {
+        [delegate URLSession:session dataTask:dataTask didReceiveResponse:response completionHandler:completionHandler];
+    } else {
+        completionHandler(NSURLSessionResponseAllow);
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
+    id<NSURLSessionDataDelegate> delegate = [self delegateForTask:dataTask];
+    if ([delegate respondsToSelector:@selector(URLSession:dataTask:didReceiveData:)]) {
+        [delegate URLSession:session dataTask:dataTask didReceiveData:data];
+    }
+}
+
+@end
+
+#pragma mark - AWSURLSessionPool
+
+@interface AWSURLSessionPool()
+
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSURLSession *> *sessions;
+
+@end
+
+@implementation AWSURLSessionPool
+
++ (instancetype)sharedPool {
+    static AWSURLSessionPool *_sharedPool = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _sharedPool = [AWSURLSessionPool new];
+    });
+    return _sharedPool;
+}
+
++ (NSURLSessionConfiguration *)sessionConfigurationForConfiguration:(AWSNetworkingConfiguration *)configuration {
+    NSURLSessionConfiguration *sessionConfiguration = [NSURLSessionConfiguration defaultSessionConfiguration];
+    sessionConfiguration.URLCache = nil;
+    if (configuration.timeoutIntervalForRequest > 0) {
+        sessionConfiguration.timeoutIntervalForRequest = configuration.timeoutIntervalForRequest;
+    }
+    if (configuration.timeoutIntervalForResource > 0) {
+        sessionConfiguration.timeoutIntervalForResource = configuration.timeoutIntervalForResource;
+    }
+    if (configuration.maximumConnectionsPerHost > 0) {
+        sessionConfiguration.HTTPMaximumConnectionsPerHost = configuration.maximumConnectionsPerHost;
+    }
+    sessionConfiguration.allowsCellularAccess = configuration.allowsCellularAccess;
+    sessionConfiguration.sharedContainerIdentifier = configuration.sharedContainerIdentifier;
+    return sessionConfiguration;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _sessions = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    // The configurations retain the pool, no client is using its sessions anymore.
+    for (NSURLSession *session in [_sessions allValues]) {
+        [session finishTasksAndInvalidate];
+    }
+}
+
+- (NSUInteger)sessionCount {
+    @synchronized(self) {
+        return [self.sessions count];
+    }
+}
+
+- (NSURLSession *)sessionForConfiguration:(AWSNetworkingConfiguration *)configuration {
+    NSString *key = [NSString stringWithFormat:@"%f|%f|%ld|%d|%@",
+                     configuration.timeoutIntervalForRequest,
+                     configuration.timeoutIntervalForResource,
+                     (long)configuration.maximumConnectionsPerHost,
+                     configuration.allowsCellularAccess,
+                     configuration.sharedContainerIdentifier ?: @""];
+    @synchronized(self) {
+        NSURLSession *session = self.sessions[key];
+        if (!session) {
+            session = [NSURLSession sessionWithConfiguration:[AWSURLSessionPool sessionConfigurationForConfiguration:configuration]
+                                                    delegate:[AWSURLSessionPoolRouter new]
+                                               delegateQueue:nil];
+            self.sessions[key] = session;
+        }
+        return session;
+    }
+}
+
+- (void)setDelegate:(id<NSURLSessionDataDelegate>)delegate
+            forTask:(NSURLSessionTask *)task
+          inSession:(NSURLSession *)session {
+    AWSURLSessionPoolRouter *router = (AWSURLSessionPoolRouter *)session.delegate;
+    [router.sessionDelegates setObject:delegate forKey:@(task.taskIdentifier)];
+}
+
+- (AWSTask *)prewarmEndpoints:(NSArray<NSURL *> *)endpoints
+                configuration:(AWSNetworkingConfiguration *)configuration {
+    NSURLSession *session = [self sessionForConfiguration:configuration];
+    NSMutableArray<AWSTask *> *tasks = [NSMutableArray arrayWithCapacity:[endpoints count]];
+    for (NSURL *endpoint in endpoints) {
+        NSURLComponents *components = [NSURLComponents new];
+        components.scheme = endpoint.scheme;
+        components.host = endpoint.host;
+        components.port = endpoint.port;
+        components.path = @"/";
+        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:components.URL];
+        request.HTTPMethod = @"HEAD";
+
+        AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+        [[session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            if (error) {
+                AWSDDLogDebug(@"Failed to prewarm %@: %@", request.URL, error);
+                taskCompletionSource.error = error;
+            } else {
+                taskCompletionSource.result = nil;
+            }
+        }] resume];
+        [tasks addObject:taskCompletionSource.task];
+    }
+    return [AWSTask taskForCompletionOfAllTasks:tasks];
+}
+
+@end
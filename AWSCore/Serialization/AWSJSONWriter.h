@@ -0,0 +1,52 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class AWSJSONDictionary;
+
+/**
+ Writes the JSON body of a request straight from its parameters and the shape rules of the operation.
+
+ `AWSJSONBuilder` used to build a serialized copy of the parameters and hand it to `NSJSONSerialization`. The writer
+ walks the parameters and the rules once instead, appending UTF-8 bytes to a buffer that is reused by every request
+ written on the same thread. Blobs are base64 encoded directly into the buffer.
+
+ Errors are reported in `AWSJSONBuilderErrorDomain`, with the same codes as `AWSJSONBuilder`.
+ */
+@interface AWSJSONWriter : NSObject
+
+/**
+ Returns the writer reused by the current thread.
+ */
++ (instancetype)writerForCurrentThread;
+
+/**
+ Returns the JSON body for the given parameters.
+
+ @param params The parameters of the request, as produced by `AWSMTLJSONAdapter`.
+ @param rules  The input rules of the operation. Rules with a `payload` trait are not supported; use `AWSJSONBuilder`.
+ @param error  Set when a value does not match its shape.
+ @return The JSON body, or `nil` on error.
+ */
+- (nullable NSData *)dataForParameters:(NSDictionary *)params
+                                 rules:(AWSJSONDictionary *)rules
+                                 error:(NSError *__autoreleasing *)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,398 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSJSONWriter.h"
+#import "AWSSerialization.h"
+#import "AWSTimestampSerialization.h"
+
+static NSString *const AWSJSONWriterThreadDictionaryKey = @"com.amazonaws.AWSJSONWriter";
+
+// Buffers grown beyond this size by a large request are released once the request is written.
+static size_t const AWSJSONWriterRetainedCapacity = 256 * 1024;
+
+static const char AWSJSONWriterBase64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char AWSJSONWriterHexDigits[] = "0123456789abcdef";
+
+@implementation AWSJSONWriter {
+    uint8_t *_bytes;
+    size_t _length;
+    size_t _capacity;
+    NSMutableData *_scratch;
+}
+
++ (instancetype)writerForCurrentThread {
+    NSMutableDictionary *threadDictionary = [[NSThread currentThread] threadDictionary];
+    AWSJSONWriter *writer = threadDictionary[AWSJSONWriterThreadDictionaryKey];
+    if (!writer) {
+        writer = [AWSJSONWriter new];
+        threadDictionary[AWSJSONWriterThreadDictionaryKey] = writer;
+    }
+    return writer;
+}
+
+- (void)dealloc {
+    free(_bytes);
+}
+
+- (NSData *)dataForParameters:(NSDictionary *)params
+                        rules:(AWSJSONDictionary *)rules
+                        error:(NSError *__autoreleasing *)error {
+    _length = 0;
+    if (!_scratch) {
+        _scratch = [NSMutableData new];
+    }
+
+    NSError *writeError = nil;
+    BOOL succeeded = [self writeMember:params shape:rules error:&writeError];
+    NSData *data = succeeded ? [NSData dataWithBytes:_bytes length:_length] : nil;
+
+    if (_capacity > AWSJSONWriterRetainedCapacity) {
+        free(_bytes);
+        _bytes = NULL;
+        _capacity = 0;
+        _scratch = nil;
+    }
+    _length = 0;
+
+    if (error) {
+        *error = writeError;
+    }
+    return data;
+}
+
+#pragma mark - Shapes
+
+- (BOOL)writeMember:(id)value shape:(NSDictionary *)shape error:(NSError *__autoreleasing *)error {
+    NSString *rulesType = shape[@"type"];
+    if ([rulesType isEqualToString:@"structure"]) {
+        if (![value isKindOfClass:[NSDictionary class]]) {
+            [self appendCString:"{}"];
+            return [value isKindOfClass:[NSNull class]] || [self failWithDescription:[NSString stringWithFormat:@"a structure input should be a dictionary but got:%@", value] error:error];
+        }
+        return [self writeStructure:value shape:shape error:error];
+    } else if ([rulesType isEqualToString:@"list"]) {
+        if (![value isKindOfClass:[NSArray class]]) {
+            [self appendCString:"[]"];
+            return [value isKindOfClass:[NSNull class]] || [self failWithDescription:[NSString stringWithFormat:@"a list input should be an array but got:%@", value] error:error];
+        }
+        return [self writeList:value shape:shape error:error];
+    } else if ([rulesType isEqualToString:@"map"]) {
+        if (![value isKindOfClass:[NSDictionary class]]) {
+            [self appendCString:"{}"];
+            return [value isKindOfClass:[NSNull class]] || [self failWithDescription:[NSString stringWithFormat:@"a map input should be a dictionary but got:%@", value] error:error];
+        }
+        return [self writeMap:value shape:shape error:error];
+    } else if ([rulesType isEqualToString:@"timestamp"]) {
+        NSString *timestampStr = [AWSJSONTimestampSerialization serializeTimestamp:shape value:value error:error];
+        if ([shape[@"timestampFormat"] isEqualToString:@"iso8601"] || [shape[@"timestampFormat"] isEqualToString:@"rfc822"]) {
+            [self appendString:timestampStr ?: @""];
+            return YES;
+        }
+        return [self appendNumber:[NSNumber numberWithDouble:[timestampStr doubleValue]] error:error];
+    } else if ([rulesType isEqualToString:@"blob"]) {
+        if ([value isKindOfClass:[NSString class]]) {
+            value = [value dataUsingEncoding:NSUTF8StringEncoding];
+        }
+        if (![value isKindOfClass:[NSData class]]) {
+            [self appendCString:"\"\""];
+            return [self failWithDescription:@"'blob' value should be a NSData type." error:error];
+        }
+        [self appendBase64:value];
+        return YES;
+    } else if ([rulesType isEqualToString:@"boolean"] && [value isKindOfClass:[NSNumber class]]) {
+        [self appendCString:[value boolValue] ? "true" : "false"];
+        return YES;
+    }
+
+    return [self writeValue:value error:error];
+}
+
+- (BOOL)writeStructure:(NSDictionary *)values shape:(NSDictionary *)shape error:(NSError *__autoreleasing *)error {
+    NSDictionary *members = shape[@"members"];
+    __block BOOL first = YES;
+    __block BOOL succeeded = YES;
+    __block NSError *blockError = nil;
+
+    [self appendByte:'{'];
+    [values enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, BOOL *stop) {
+        NSDictionary *memberShape = members[key];
+        if (!memberShape || memberShape[@"location"]) {
+            //It should be another location rather than body, will be process at different place
+            return;
+        }
+
+        if (!first) {
+            [self appendByte:','];
+        }
+        first = NO;
+        [self appendString:memberShape[@"locationName"] ?: key];
+        [self appendByte:':'];
+        if (![self writeMember:value shape:memberShape error:&blockError]) {
+            succeeded = NO;
+            *stop = YES;
+        }
+    }];
+    [self appendByte:'}'];
+
+    if (error && blockError) {
+        *error = blockError;
+    }
+    return succeeded;
+}
+
+- (BOOL)writeList:(NSArray *)values shape:(NSDictionary *)shape error:(NSError *__autoreleasing *)error {
+    NSDictionary *memberShape = shape[@"member"];
+    BOOL first = YES;
+
+    [self appendByte:'['];
+    for (id value in values) {
+        if (!first) {
+            [self appendByte:','];
+        }
+        first = NO;
+        if (![self writeMember:value shape:memberShape error:error]) {
+            return NO;
+        }
+    }
+    [self appendByte:']'];
+    return YES;
+}
+
+- (BOOL)writeMap:(NSDictionary *)values shape:(NSDictionary *)shape error:(NSError *__autoreleasing *)error {
+    NSDictionary *valueShape = shape[@"value"];
+    __block BOOL first = YES;
+    __block BOOL succeeded = YES;
+    __block NSError *blockError = nil;
+
+    [self appendByte:'{'];
+    [values enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+        if (!first) {
+            [self appendByte:','];
+        }
+        first = NO;
+        [self appendString:[key isKindOfClass:[NSString class]] ? key : [key description]];
+        [self appendByte:':'];
+        if (![self writeMember:value shape:valueShape error:&blockError]) {
+            succeeded = NO;
+            *stop = YES;
+        }
+    }];
+    [self appendByte:'}'];
+
+    if (error && blockError) {
+        *error = blockError;
+    }
+    return succeeded;
+}
+
+/**
+ Writes a value which has no shape rules, the same way `NSJSONSerialization` would.
+ */
+- (BOOL)writeValue:(id)value error:(NSError *__autoreleasing *)error {
+    if ([value isKindOfClass:[NSString class]]) {
+        [self appendString:value];
+    } else if ([value isKindOfClass:[NSNumber class]]) {
+        return [self appendNumber:value error:error];
+    } else if ([value isKindOfClass:[NSNull class]] || value == nil) {
+        [self appendCString:"null"];
+    } else if ([value isKindOfClass:[NSArray class]]) {
+        BOOL first = YES;
+        [self appendByte:'['];
+        for (id element in value) {
+            if (!first) {
+                [self appendByte:','];
+            }
+            first = NO;
+            if (![self writeValue:element error:error]) {
+                return NO;
+            }
+        }
+        [self appendByte:']'];
+    } else if ([value isKindOfClass:[NSDictionary class]]) {
+        BOOL first = YES;
+        [self appendByte:'{'];
+        for (id key in value) {
+            if (!first) {
+                [self appendByte:','];
+            }
+            first = NO;
+            [self appendString:[key isKindOfClass:[NSString class]] ? key : [key description]];
+            [self appendByte:':'];
+            if (![self writeValue:value[key] error:error]) {
+                return NO;
+            }
+        }
+        [self appendByte:'}'];
+    } else {
+        return [self failWithDescription:[NSString stringWithFormat:@"serialized object is neither a valid json Object nor NSData object: %@", value] error:error];
+    }
+    return YES;
+}
+
+- (BOOL)failWithDescription:(NSString *)description error:(NSError *__autoreleasing *)error {
+    if (error) {
+        *error = [NSError errorWithDomain:AWSJSONBuilderErrorDomain
+                                     code:AWSJSONBuilderInvalidParameter
+                                 userInfo:@{NSLocalizedDescriptionKey : description}];
+    }
+    return NO;
+}
+
+#pragma mark - Buffer
+
+- (void)reserveCapacity:(size_t)additionalLength {
+    if (_length + additionalLength <= _capacity) {
+        return;
+    }
+    size_t capacity = MAX(_capacity * 2, (size_t)4096);
+    while (capacity < _length + additionalLength) {
+        capacity *= 2;
+    }
+    _bytes = reallocf(_bytes, capacity);
+    if (!_bytes) {
+        [NSException raise:NSMallocException format:@"AWSJSONWriter failed to allocate %zu bytes", capacity];
+    }
+    _capacity = capacity;
+}
+
+- (void)appendByte:(uint8_t)byte {
+    [self reserveCapacity:1];
+    _bytes[_length++] = byte;
+}
+
+- (void)appendCString:(const char *)string {
+    size_t length = strlen(string);
+    [self reserveCapacity:length];
+    memcpy(_bytes + _length, string, length);
+    _length += length;
+}
+
+- (BOOL)appendNumber:(NSNumber *)number error:(NSError *__autoreleasing *)error {
+    if ((__bridge CFBooleanRef)number == kCFBooleanTrue || (__bridge CFBooleanRef)number == kCFBooleanFalse) {
+        [self appendCString:[number boolValue] ? "true" : "false"];
+        return YES;
+    }
+
+    char formatted[64];
+    if (CFNumberIsFloatType((__bridge CFNumberRef)number)) {
+        double doubleValue = [number doubleValue];
+        if (isnan(doubleValue) || isinf(doubleValue)) {
+            return [self failWithDescription:[NSString stringWithFormat:@"Invalid number value (NaN or infinity) in JSON write: %@", number] error:error];
+        }
+        if (doubleValue == floor(doubleValue) && fabs(doubleValue) < 1e15) {
+            snprintf(formatted, sizeof(formatted), "%lld", (long long)doubleValue);
+        } else {
+            // Prefer the shortest representation that still round trips, as NSJSONSerialization does.
+            snprintf(formatted, sizeof(formatted), "%.15g", doubleValue);
+            if (strtod(formatted, NULL) != doubleValue) {
+                snprintf(formatted, sizeof(formatted), "%.17g", doubleValue);
+            }
+        }
+    } else if (strcmp([number objCType], @encode(unsigned long long)) == 0) {
+        snprintf(formatted, sizeof(formatted), "%llu", [number unsignedLongLongValue]);
+    } else {
+        snprintf(formatted, sizeof(formatted), "%lld", [number longLongValue]);
+    }
+    [self appendCString:formatted];
+    return YES;
+}
+
+- (void)appendString:(NSString *)string {
+    const char *bytes = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingUTF8);
+    size_t length = 0;
+    if (bytes) {
+        length = strlen(bytes);
+    } else {
+        NSUInteger maxLength = [string maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        if (_scratch.length < maxLength) {
+            _scratch.length = maxLength;
+        }
+        NSUInteger usedLength = 0;
+        [string getBytes:_scratch.mutableBytes
+               maxLength:maxLength
+              usedLength:&usedLength
+                encoding:NSUTF8StringEncoding
+                 options:0
+                   range:NSMakeRange(0, string.length)
+          remainingRange:NULL];
+        bytes = _scratch.mutableBytes;
+        length = usedLength;
+    }
+
+    // Worst case, every byte is written as a six byte \u escape.
+    [self reserveCapacity:length * 6 + 2];
+    uint8_t *output = _bytes + _length;
+    *output++ = '"';
+    for (size_t i = 0; i < length; i++) {
+        uint8_t byte = (uint8_t)bytes[i];
+        switch (byte) {
+            case '"': *output++ = '\\'; *output++ = '"'; break;
+            case '\\': *output++ = '\\'; *output++ = '\\'; break;
+            case '\n': *output++ = '\\'; *output++ = 'n'; break;
+            case '\r': *output++ = '\\'; *output++ = 'r'; break;
+            case '\t': *output++ = '\\'; *output++ = 't'; break;
+            case '\b': *output++ = '\\'; *output++ = 'b'; break;
+            case '\f': *output++ = '\\'; *output++ = 'f'; break;
+            default:
+                if (byte < 0x20) {
+                    *output++ = '\\';
+                    *output++ = 'u';
+                    *output++ = '0';
+                    *output++ = '0';
+                    *output++ = AWSJSONWriterHexDigits[byte >> 4];
+                    *output++ = AWSJSONWriterHexDigits[byte & 0x0F];
+                } else {
+                    *output++ = byte;
+                }
+                break;
+        }
+    }
+    *output++ = '"';
+    _length = output - _bytes;
+}
+
+- (void)appendBase64:(NSData *)data {
+    size_t inputLength = data.length;
+    size_t outputLength = ((inputLength + 2) / 3) * 4;
+    [self reserveCapacity:outputLength + 2];
+
+    const uint8_t *input = data.bytes;
+    uint8_t *output = _bytes + _length;
+    *output++ = '"';
+
+    size_t i = 0;
+    for (; i + 2 < inputLength; i += 3) {
+        uint32_t triple = ((uint32_t)input[i] << 16) | ((uint32_t)input[i + 1] << 8) | input[i + 2];
+        *output++ = AWSJSONWriterBase64Alphabet[(triple >> 18) & 0x3F];
+        *output++ = AWSJSONWriterBase64Alphabet[(triple >> 12) & 0x3F];
+        *output++ = AWSJSONWriterBase64Alphabet[(triple >> 6) & 0x3F];
+        *output++ = AWSJSONWriterBase64Alphabet[triple & 0x3F];
+    }
+    if (i < inputLength) {
+        uint32_t triple = (uint32_t)input[i] << 16;
+        if (i + 1 < inputLength) {
+            triple |= (uint32_t)input[i + 1] << 8;
+        }
+        *output++ = AWSJSONWriterBase64Alphabet[(triple >> 18) & 0x3F];
+        *output++ = AWSJSONWriterBase64Alphabet[(triple >> 12) & 0x3F];
+        *output++ = (i + 1 < inputLength) ? AWSJSONWriterBase64Alphabet[(triple >> 6) & 0x3F] : '=';
+        *output++ = '=';
+    }
+
+    *output++ = '"';
+    _length = output - _bytes;
+}
+
+@end
@@ -97,6 +97,20 @@ typedef NS_ENUM(NSInteger, AWSJSONParserErrorType) {
 
 @interface AWSJSONDictionary : NSDictionary
 
+/**
+ Returns the resolved rules for the input or output of an operation.
+
+ The rules are resolved lazily and cached per service definition, so nested rules looked up while serializing one
+ request are reused by every later request for the same operation instead of being resolved again.
+
+ @param actionName            The name of the operation, e.g. `PutRecords`.
+ @param ruleType              `input` or `output`.
+ @param serviceDefinitionRule The service definition returned by the `*Resources` class of the service.
+ */
++ (instancetype)rulesForOperation:(NSString *)actionName
+                         ruleType:(NSString *)ruleType
+            serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule;
+
 - (instancetype)initWithDictionary:(NSDictionary *)otherDictionary
                 JSONDefinitionRule:(NSDictionary *)rule;
 - (NSUInteger)count;
@@ -127,6 +141,16 @@ typedef NS_ENUM(NSInteger, AWSJSONParserErrorType) {
                         serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule
                                         error:(NSError *__autoreleasing *)error;
 
+/**
+ Parses the response body like `-dictionaryForXMLData:actionName:serviceDefinitionRule:error:`, passing the elements of
+ the top-level lists of rest-xml responses to `itemHandler` as they are parsed instead of adding them to the result.
+ */
+- (NSMutableDictionary *)dictionaryForXMLData:(NSData *)data
+                                   actionName:(NSString *)actionName
+                        serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule
+                                  itemHandler:(void (^)(NSString *memberName, id item))itemHandler
+                                        error:(NSError *__autoreleasing *)error;
+
 @end
 
 @interface AWSQueryParamBuilder : NSObject
@@ -15,9 +15,12 @@
 #import "AWSSerialization.h"
 #import "AWSTimestampSerialization.h"
 #import "AWSXMLWriter.h"
+#import "AWSJSONWriter.h"
+#import "AWSXMLStreamingParser.h"
 #import "AWSCategory.h"
 #import "AWSCocoaLumberjack.h"
 #import "AWSXMLDictionary.h"
+#import <pthread.h>
 
 NSString *const AWSXMLBuilderErrorDomain = @"com.amazonaws.AWSXMLBuilderErrorDomain";
 NSString *const AWSXMLParserErrorDomain = @"com.amazonaws.AWSXMLParserErrorDomain";
@@ -29,25 +32,96 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
 
 @property (nonatomic, strong) NSDictionary *embeddedDictionary;
 @property (nonatomic, strong) NSDictionary *JSONDefinitionRule;
+@property (nonatomic, strong) NSDictionary *resolvedDictionary;
+@property (nonatomic, strong) NSMutableDictionary *resolvedChildren;
 
 @end
 
-@implementation AWSJSONDictionary
+@implementation AWSJSONDictionary {
+    pthread_mutex_t _resolvedChildrenLock;
+}
+
++ (instancetype)rulesForOperation:(NSString *)actionName
+                         ruleType:(NSString *)ruleType
+            serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule {
+    static NSMapTable *resolvedRulesByService = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        resolvedRulesByService = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality
+                                                       valueOptions:NSPointerFunctionsStrongMemory];
+    });
+
+    NSDictionary *actionRule = [[[serviceDefinitionRule objectForKey:@"operations"] objectForKey:actionName] objectForKey:ruleType];
+    NSDictionary *definitionRules = [serviceDefinitionRule objectForKey:@"shapes"];
+    if (actionRule == (id)[NSNull null]) {
+        actionRule = nil;
+    }
+    if (definitionRules == (id)[NSNull null]) {
+        definitionRules = nil;
+    }
+    if (!serviceDefinitionRule || !actionName) {
+        return [[AWSJSONDictionary alloc] initWithDictionary:actionRule JSONDefinitionRule:definitionRules];
+    }
+
+    NSString *cacheKey = [NSString stringWithFormat:@"%@.%@", actionName, ruleType];
+    @synchronized (resolvedRulesByService) {
+        NSMutableDictionary *resolvedRules = [resolvedRulesByService objectForKey:serviceDefinitionRule];
+        if (!resolvedRules) {
+            resolvedRules = [NSMutableDictionary new];
+            [resolvedRulesByService setObject:resolvedRules forKey:serviceDefinitionRule];
+        }
+
+        AWSJSONDictionary *rules = resolvedRules[cacheKey];
+        if (!rules) {
+            rules = [[AWSJSONDictionary alloc] initWithResolvedDictionary:actionRule JSONDefinitionRule:definitionRules];
+            resolvedRules[cacheKey] = rules;
+        }
+        return rules;
+    }
+}
 
 - (instancetype)initWithDictionary:(NSDictionary *)otherDictionary JSONDefinitionRule:(NSDictionary *)rule {
+    return [self initWithResolvedDictionary:[[NSDictionary alloc] initWithDictionary:otherDictionary]
+                         JSONDefinitionRule:[rule copy]];
+}
+
+/**
+ Rule dictionaries are immutable once loaded, so nested rules reference them without copying. The lookups done by
+ `objectForKey:` are flattened here once: a key of the rule itself takes precedence over its `metadata`, which takes
+ precedence over the referenced shape and then over the metadata of that shape.
+ */
+- (instancetype)initWithResolvedDictionary:(NSDictionary *)embeddedDictionary JSONDefinitionRule:(NSDictionary *)rule {
     self = [super init];
     if (self) {
-        _embeddedDictionary = [[NSDictionary alloc] initWithDictionary:otherDictionary];
-        _JSONDefinitionRule = [rule copy];
+        _embeddedDictionary = embeddedDictionary ?: @{};
+        _JSONDefinitionRule = rule;
+        _resolvedChildren = [NSMutableDictionary new];
+        pthread_mutex_init(&_resolvedChildrenLock, NULL);
+
+        NSMutableDictionary *resolvedDictionary = [NSMutableDictionary new];
+        NSString *shapeName = [_embeddedDictionary objectForKey:@"shape"];
+        if ([shapeName isKindOfClass:[NSString class]] && shapeName.length != 0) {
+            NSDictionary *definitionResult = [_JSONDefinitionRule objectForKey:shapeName];
+            if ([definitionResult isKindOfClass:[NSDictionary class]]) {
+                [self addEntriesFromMetadataOf:definitionResult toDictionary:resolvedDictionary];
+                [resolvedDictionary addEntriesFromDictionary:definitionResult];
+            }
+        }
+        [self addEntriesFromMetadataOf:_embeddedDictionary toDictionary:resolvedDictionary];
+        [resolvedDictionary addEntriesFromDictionary:_embeddedDictionary];
+        _resolvedDictionary = resolvedDictionary;
     }
     return self;
 }
 
-- (id)parseResult:(id)result {
-    if ([result isKindOfClass:[NSDictionary class]]) {
-        return [[AWSJSONDictionary alloc] initWithDictionary:result JSONDefinitionRule:self.JSONDefinitionRule];
-    } else {
-        return result;
+- (void)dealloc {
+    pthread_mutex_destroy(&_resolvedChildrenLock);
+}
+
+- (void)addEntriesFromMetadataOf:(NSDictionary *)dictionary toDictionary:(NSMutableDictionary *)resolvedDictionary {
+    NSDictionary *metadata = [dictionary objectForKey:@"metadata"];
+    if ([metadata isKindOfClass:[NSDictionary class]]) {
+        [resolvedDictionary addEntriesFromDictionary:metadata];
     }
 }
 
@@ -56,35 +130,20 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
 }
 
 - (id)objectForKey:(id)aKey {
-    //If value found, just return value
-    id value = [self.embeddedDictionary objectForKey:aKey];
-    if (value) {
-        return [self parseResult:value];
-    }
-
-    //find value in metadata dictionary, return the value if found
-    id result = [[self.embeddedDictionary objectForKey:@"metadata"] objectForKey:aKey];
-    if (result) {
-        return [self parseResult:result];
+    id value = [self.resolvedDictionary objectForKey:aKey];
+    if (![value isKindOfClass:[NSDictionary class]]) {
+        return value;
     }
 
-    //find value according to shapeName, return the value if found
-    NSString *shapeName = [self.embeddedDictionary objectForKey:@"shape"];
-    if (shapeName.length != 0) {
-        NSDictionary *definitionResult = [self.JSONDefinitionRule objectForKey:shapeName];
-
-        id result = [definitionResult objectForKey:aKey];
-        if (result) {
-            return [self parseResult:result];
-        }
-
-        id metaDataResult = [[definitionResult objectForKey:@"metadata"] objectForKey:aKey];
-        if (metaDataResult) {
-            return [self parseResult:metaDataResult];
-        }
+    pthread_mutex_lock(&_resolvedChildrenLock);
+    AWSJSONDictionary *child = [self.resolvedChildren objectForKey:aKey];
+    if (!child) {
+        child = [[AWSJSONDictionary alloc] initWithResolvedDictionary:value JSONDefinitionRule:self.JSONDefinitionRule];
+        [self.resolvedChildren setObject:child forKey:aKey];
     }
+    pthread_mutex_unlock(&_resolvedChildrenLock);
 
-    return nil;
+    return child;
 }
 
 - (NSEnumerator *)keyEnumerator {
@@ -137,7 +196,7 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
 
 
     AWSXMLWriter* xmlWriter = [[AWSXMLWriter alloc]init];
-    AWSJSONDictionary *rules = [[AWSJSONDictionary alloc] initWithDictionary:actionRule JSONDefinitionRule:definitionRules];
+    AWSJSONDictionary *rules = [AWSJSONDictionary rulesForOperation:actionName ruleType:@"input" serviceDefinitionRule:serviceDefinitionRule];
 
     NSString *xmlElementName = rules[@"locationName"];
     if (xmlElementName) {
@@ -407,6 +466,18 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
                                    actionName:(NSString *)actionName
                         serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule
                                         error:(NSError *__autoreleasing *)error {
+    return [self dictionaryForXMLData:data
+                           actionName:actionName
+                serviceDefinitionRule:serviceDefinitionRule
+                          itemHandler:nil
+                                error:error];
+}
+
+- (NSMutableDictionary *)dictionaryForXMLData:(NSData *)data
+                                   actionName:(NSString *)actionName
+                        serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule
+                                  itemHandler:(AWSXMLStreamingParserItemBlock)itemHandler
+                                        error:(NSError *__autoreleasing *)error {
     if (!data) {
         return [NSMutableDictionary new];
     }
@@ -431,6 +502,17 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
         return nil;
     }
 
+    NSString *serviceTypeStr = serviceDefinitionRule[@"metadata"][@"type"]?serviceDefinitionRule[@"metadata"][@"type"]:serviceDefinitionRule[@"metadata"][@"protocol"];
+    if ([serviceTypeStr isEqualToString:@"rest-xml"] && [data isKindOfClass:[NSData class]]) {
+        //apply the rules while parsing instead of building the whole xml tree first
+        AWSXMLStreamingParser *streamingParser = [[AWSXMLStreamingParser alloc] initWithRules:[AWSJSONDictionary rulesForOperation:actionName ruleType:@"output" serviceDefinitionRule:serviceDefinitionRule]];
+        streamingParser.itemHandler = itemHandler;
+        NSMutableDictionary *parsedData = [streamingParser parseData:data error:error];
+        if (parsedData) {
+            return parsedData;
+        }
+    }
+
     NSMutableDictionary *rootXmlDictionary = nil;
     if ([data isKindOfClass:[NSData class]]) {
         @synchronized (self) {
@@ -459,7 +541,7 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
         //This is mostly used error response, return xmlDictionary
         return [xmlDictionary mutableCopy];
     }else {
-        AWSJSONDictionary *rules = [[AWSJSONDictionary alloc] initWithDictionary:actionRule JSONDefinitionRule:definitionRules];
+        AWSJSONDictionary *rules = [AWSJSONDictionary rulesForOperation:actionName ruleType:@"output" serviceDefinitionRule:serviceDefinitionRule];
 
         xmlDictionary = [AWSXMLParser preprocessDictionary:xmlDictionary operationName:actionName actionRule:rules serviceDefinitionRule:serviceDefinitionRule];
 
@@ -483,7 +565,6 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
 
         if ([parsedData count] == 0) {
             //try again with rootDictionary if it is S3 response
-            NSString *serviceTypeStr = serviceDefinitionRule[@"metadata"][@"type"]?serviceDefinitionRule[@"metadata"][@"type"]:serviceDefinitionRule[@"metadata"][@"protocol"];
             if ([serviceTypeStr isEqualToString:@"rest-xml"]) {
                 xmlDictionary = [AWSXMLParser preprocessDictionary:xmlDictionary operationName:actionName actionRule:actionRule serviceDefinitionRule:serviceDefinitionRule];
                 parsedData = [AWSXMLParser parseStructure:xmlDictionary rules:rules error:error];
@@ -847,7 +928,7 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
         return nil;
     }
 
-    AWSJSONDictionary *rules = [[AWSJSONDictionary alloc] initWithDictionary:actionRule JSONDefinitionRule:definitionRules];
+    AWSJSONDictionary *rules = [AWSJSONDictionary rulesForOperation:actionName ruleType:@"input" serviceDefinitionRule:serviceDefinitionRule];
 
 
     [AWSQueryParamBuilder serializeStructure:params rules:rules prefix:@"" formattedParams:formattedParams  error:error];
@@ -1038,7 +1119,7 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
         return nil;
     }
 
-    AWSJSONDictionary *rules = [[AWSJSONDictionary alloc] initWithDictionary:actionRule JSONDefinitionRule:definitionRules];
+    AWSJSONDictionary *rules = [AWSJSONDictionary rulesForOperation:actionName ruleType:@"input" serviceDefinitionRule:serviceDefinitionRule];
 
 
     [AWSEC2ParamBuilder serializeStructure:params rules:rules prefix:@"" formattedParams:formattedParams  error:error];
@@ -1158,6 +1239,18 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
             serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule
                             error:(NSError *__autoreleasing *)error {
 
+    NSDictionary *actionRule = serviceDefinitionRule[@"operations"][actionName][@"input"];
+    NSDictionary *definitionRules = serviceDefinitionRule[@"shapes"];
+    if ([params count] > 0
+        && [actionRule isKindOfClass:[NSDictionary class]] && [actionRule count] > 0
+        && [definitionRules isKindOfClass:[NSDictionary class]] && [definitionRules count] > 0) {
+        AWSJSONDictionary *rules = [AWSJSONDictionary rulesForOperation:actionName ruleType:@"input" serviceDefinitionRule:serviceDefinitionRule];
+        if (!rules[@"payload"]) {
+            // Write the body straight from the parameters instead of building a serialized copy for NSJSONSerialization.
+            return [[AWSJSONWriter writerForCurrentThread] dataForParameters:params rules:rules error:error];
+        }
+    }
+
     id serializedJsonObject = [self buildJSONDictionary:params actionName:actionName serviceDefinitionRule:serviceDefinitionRule error:error];
 
     if (!serializedJsonObject) {
@@ -1206,7 +1299,7 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
         return nil;
     }
 
-    AWSJSONDictionary *rules = [[AWSJSONDictionary alloc] initWithDictionary:actionRule JSONDefinitionRule:definitionRules];
+    AWSJSONDictionary *rules = [AWSJSONDictionary rulesForOperation:actionName ruleType:@"input" serviceDefinitionRule:serviceDefinitionRule];
 
     id resultParams = [self serializeMember:rules value:params isPayloadType:NO error:error];
 
@@ -1380,9 +1473,16 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
     // They are valid JSON texts according to RFC 7159 and ECMA 404.
     // (RFC 4627 was replaced with RFC 7159 in March 2014.)
     // You need to pass NSJSONReadingAllowFragments here, otherwise, they may fail.
-    id result =  [NSJSONSerialization JSONObjectWithData:data
-                                                               options:NSJSONReadingAllowFragments
-                                                                 error:error];
+    // A response body consumer may have parsed the body already, or written it to a file, which only ends up in a
+    // streaming payload member.
+    id result = nil;
+    if ([data isKindOfClass:[NSData class]]) {
+        result = [NSJSONSerialization JSONObjectWithData:data
+                                                 options:NSJSONReadingAllowFragments
+                                                   error:error];
+    } else if ([data isKindOfClass:[NSDictionary class]] || [data isKindOfClass:[NSArray class]]) {
+        result = data;
+    }
 
     NSDictionary *actionRule = [[[serviceDefinitionRule objectForKey:@"operations"] objectForKey:actionName] objectForKey:@"output"];
     if (actionRule == (id)[NSNull null]) {
@@ -1403,7 +1503,7 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
         return result;
     }
 
-    AWSJSONDictionary *rules = [[AWSJSONDictionary alloc] initWithDictionary:actionRule JSONDefinitionRule:definitionRules];
+    AWSJSONDictionary *rules = [AWSJSONDictionary rulesForOperation:actionName ruleType:@"output" serviceDefinitionRule:serviceDefinitionRule];
 
     //check if has payload tag.
     NSString *isPayloadData = rules[@"payload"];
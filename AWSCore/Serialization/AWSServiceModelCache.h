@@ -0,0 +1,99 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ File extension used for compiled service models, both for models bundled with the app and for models cached on disk.
+ */
+FOUNDATION_EXPORT NSString *const AWSServiceModelCacheFileExtension;
+
+/**
+ Key in the root dictionary of a compiled service model which holds the fingerprint of the JSON definition it was
+ compiled from.
+ */
+FOUNDATION_EXPORT NSString *const AWSServiceModelCacheFingerprintKey;
+
+/**
+ Loads the service definitions used by the `*Resources` classes of each service.
+
+ Parsing the JSON definition of a large service (e.g. S3 or IoT) with `NSJSONSerialization` is a noticeable part of
+ the cold start cost of a client. This class keeps a compiled form of each definition: a binary property list with the
+ `documentation` traits removed, which is smaller and decodes faster than the original JSON text. It is still decoded
+ in full when it is loaded.
+
+ A compiled model is looked up in this order:
+
+ 1. `<serviceName>.awsmodel` in the bundle passed by the caller. These files are produced at build time by
+    `Scripts/compile_service_models.py`.
+ 2. `<serviceName>.awsmodel` in `Library/Caches/com.amazonaws.AWSServiceModelCache`, written the first time the
+    JSON definition was parsed on this device.
+ 3. The JSON definition itself. A compiled model is written to the cache directory in the background afterwards.
+
+ A compiled model is only used when its fingerprint matches the JSON definition string, so a stale model left behind
+ by an older version of the SDK is ignored and replaced.
+ */
+@interface AWSServiceModelCache : NSObject
+
+/**
+ Whether compiled models are read and written. Defaults to `YES`. When set to `NO`, every definition is parsed from
+ its JSON string.
+ */
+@property (atomic, assign, getter=isEnabled) BOOL enabled;
+
+/**
+ Returns the shared cache instance.
+ */
++ (instancetype)sharedInstance;
+
+/**
+ Returns the service definition for the given service.
+
+ @param serviceName      The name of the compiled model file without its extension, e.g. `S3`.
+ @param definitionString The JSON service definition the compiled model must match.
+ @param bundle           The bundle to look for a precompiled model in. May be `nil`.
+ @return The service definition, or `nil` if the JSON definition could not be parsed.
+ */
+- (nullable NSDictionary *)serviceDefinitionForName:(NSString *)serviceName
+                                   definitionString:(NSString *)definitionString
+                                             bundle:(nullable NSBundle *)bundle;
+
+/**
+ Removes every compiled model written to the cache directory. Models bundled with the app are not affected.
+ */
+- (void)removeAllCachedModels;
+
+/**
+ Returns the fingerprint of a JSON service definition string. The fingerprint combines `AWSiOSSDKVersion`, the UTF-8
+ length of the definition and its CRC-32.
+ */
++ (NSString *)fingerprintForDefinitionString:(NSString *)definitionString;
+
+/**
+ Compiles a parsed JSON service definition into the binary property list form read by this class.
+
+ @param definition  The parsed JSON service definition.
+ @param fingerprint The fingerprint of the JSON definition string.
+ @param error       Set when the definition can not be represented as a property list.
+ */
++ (nullable NSData *)compiledModelDataForDefinition:(NSDictionary *)definition
+                                        fingerprint:(NSString *)fingerprint
+                                              error:(NSError *__autoreleasing *)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
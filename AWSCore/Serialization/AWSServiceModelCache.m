@@ -0,0 +1,226 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSServiceModelCache.h"
+#import "AWSService.h"
+#import "AWSCocoaLumberjack.h"
+#import "AWSChecksum.h"
+
+NSString *const AWSServiceModelCacheFileExtension = @"awsmodel";
+NSString *const AWSServiceModelCacheFingerprintKey = @"x-aws-model-fingerprint";
+
+static NSString *const AWSServiceModelCacheDirectoryName = @"com.amazonaws.AWSServiceModelCache";
+
+@interface AWSServiceModelCache()
+
+@property (nonatomic, strong) NSString *cacheDirectoryPath;
+@property (nonatomic, strong) dispatch_queue_t writeQueue;
+
+@end
+
+@implementation AWSServiceModelCache
+
++ (instancetype)sharedInstance {
+    static AWSServiceModelCache *_sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _sharedInstance = [AWSServiceModelCache new];
+    });
+
+    return _sharedInstance;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _enabled = YES;
+        NSString *cachesPath = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) firstObject];
+        _cacheDirectoryPath = [cachesPath stringByAppendingPathComponent:AWSServiceModelCacheDirectoryName];
+        _writeQueue = dispatch_queue_create("com.amazonaws.AWSServiceModelCache", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (NSDictionary *)serviceDefinitionForName:(NSString *)serviceName
+                          definitionString:(NSString *)definitionString
+                                    bundle:(NSBundle *)bundle {
+    if (!self.isEnabled) {
+        return [self parseDefinitionString:definitionString];
+    }
+
+    NSString *fingerprint = [AWSServiceModelCache fingerprintForDefinitionString:definitionString];
+
+    NSString *bundledModelPath = [bundle pathForResource:serviceName ofType:AWSServiceModelCacheFileExtension];
+    NSDictionary *definition = [self loadCompiledModelAtPath:bundledModelPath fingerprint:fingerprint];
+    if (definition) {
+        return definition;
+    }
+
+    NSString *cachedModelPath = [self cachedModelPathForName:serviceName];
+    definition = [self loadCompiledModelAtPath:cachedModelPath fingerprint:fingerprint];
+    if (definition) {
+        return definition;
+    }
+
+    definition = [self parseDefinitionString:definitionString];
+    if (definition) {
+        dispatch_async(self.writeQueue, ^{
+            [self writeCompiledModelForDefinition:definition
+                                      fingerprint:fingerprint
+                                           toPath:cachedModelPath];
+        });
+    }
+    return definition;
+}
+
+- (void)removeAllCachedModels {
+    dispatch_sync(self.writeQueue, ^{
+        NSError *error = nil;
+        if ([[NSFileManager defaultManager] fileExistsAtPath:self.cacheDirectoryPath]
+            && ![[NSFileManager defaultManager] removeItemAtPath:self.cacheDirectoryPath error:&error]) {
+            AWSDDLogError(@"Failed to remove the service model cache: %@", error);
+        }
+    });
+}
+
+#pragma mark - Helpers
+
+- (NSString *)cachedModelPathForName:(NSString *)serviceName {
+    NSString *fileName = [serviceName stringByAppendingPathExtension:AWSServiceModelCacheFileExtension];
+    return [self.cacheDirectoryPath stringByAppendingPathComponent:fileName];
+}
+
+- (NSDictionary *)parseDefinitionString:(NSString *)definitionString {
+    NSError *error = nil;
+    NSDictionary *definition = [NSJSONSerialization JSONObjectWithData:[definitionString dataUsingEncoding:NSUTF8StringEncoding]
+                                                               options:kNilOptions
+                                                                 error:&error];
+    if (definition == nil) {
+        if (error) {
+            AWSDDLogError(@"Failed to parse JSON service definition: %@",error);
+        }
+    }
+    return definition;
+}
+
+- (NSDictionary *)loadCompiledModelAtPath:(NSString *)path fingerprint:(NSString *)fingerprint {
+    if (!path) {
+        return nil;
+    }
+
+    NSData *data = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:nil];
+    if ([data length] == 0) {
+        return nil;
+    }
+
+    NSError *error = nil;
+    id definition = [NSPropertyListSerialization propertyListWithData:data
+                                                              options:NSPropertyListImmutable
+                                                               format:NULL
+                                                                error:&error];
+    if (![definition isKindOfClass:[NSDictionary class]]) {
+        AWSDDLogWarn(@"Ignoring unreadable compiled service model at %@: %@", path, error);
+        return nil;
+    }
+    if (![definition[AWSServiceModelCacheFingerprintKey] isEqualToString:fingerprint]) {
+        AWSDDLogDebug(@"Ignoring stale compiled service model at %@", path);
+        return nil;
+    }
+
+    return definition;
+}
+
+- (void)writeCompiledModelForDefinition:(NSDictionary *)definition
+                            fingerprint:(NSString *)fingerprint
+                                 toPath:(NSString *)path {
+    NSError *error = nil;
+    NSData *data = [AWSServiceModelCache compiledModelDataForDefinition:definition
+                                                            fingerprint:fingerprint
+                                                                  error:&error];
+    if (!data) {
+        AWSDDLogWarn(@"Failed to compile service model for %@: %@", [path lastPathComponent], error);
+        return;
+    }
+
+    if (![[NSFileManager defaultManager] createDirectoryAtPath:self.cacheDirectoryPath
+                                   withIntermediateDirectories:YES
+                                                    attributes:nil
+                                                         error:&error]) {
+        AWSDDLogWarn(@"Failed to create the service model cache directory: %@", error);
+        return;
+    }
+
+    if (![data writeToFile:path options:NSDataWritingAtomic error:&error]) {
+        AWSDDLogWarn(@"Failed to write compiled service model to %@: %@", path, error);
+    }
+}
+
++ (NSString *)fingerprintForDefinitionString:(NSString *)definitionString {
+    // Generated definitions are plain ASCII literals, so the backing store can usually be read without a copy.
+    const char *bytes = CFStringGetCStringPtr((__bridge CFStringRef)definitionString, kCFStringEncodingUTF8);
+    NSData *data = nil;
+    NSUInteger length = 0;
+    if (bytes) {
+        length = strlen(bytes);
+    } else {
+        data = [definitionString dataUsingEncoding:NSUTF8StringEncoding];
+        bytes = [data bytes];
+        length = [data length];
+    }
+
+    uint32_t crc = [AWSChecksum CRC32ForBytes:bytes length:length];
+
+    return [NSString stringWithFormat:@"%@-%lu-%08lx", AWSiOSSDKVersion, (unsigned long)length, (unsigned long)crc];
+}
+
++ (NSData *)compiledModelDataForDefinition:(NSDictionary *)definition
+                               fingerprint:(NSString *)fingerprint
+                                     error:(NSError *__autoreleasing *)error {
+    NSMutableDictionary *compiledModel = [self stripDocumentation:definition parentKey:nil];
+    compiledModel[AWSServiceModelCacheFingerprintKey] = fingerprint;
+
+    return [NSPropertyListSerialization dataWithPropertyList:compiledModel
+                                                      format:NSPropertyListBinaryFormat_v1_0
+                                                     options:0
+                                                       error:error];
+}
+
+/**
+ The `documentation` traits make up most of a service definition but are never read by the serializers. Keys of a
+ `members` dictionary are member names, so a member called `documentation` is kept.
+ */
++ (id)stripDocumentation:(id)object parentKey:(NSString *)parentKey {
+    if ([object isKindOfClass:[NSDictionary class]]) {
+        BOOL isMembers = [parentKey isEqualToString:@"members"];
+        NSMutableDictionary *result = [NSMutableDictionary dictionaryWithCapacity:[object count]];
+        [object enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, BOOL *stop) {
+            if (!isMembers
+                && ([key isEqualToString:@"documentation"] || [key isEqualToString:@"documentationUrl"])
+                && [value isKindOfClass:[NSString class]]) {
+                return;
+            }
+            result[key] = [self stripDocumentation:value parentKey:key];
+        }];
+        return result;
+    } else if ([object isKindOfClass:[NSArray class]]) {
+        NSMutableArray *result = [NSMutableArray arrayWithCapacity:[object count]];
+        for (id value in object) {
+            [result addObject:[self stripDocumentation:value parentKey:nil]];
+        }
+        return result;
+    }
+    return object;
+}
+
+@end
@@ -17,10 +17,133 @@
 
 #import "AWSNetworking.h"
 
+/**
+ Returns the current time in seconds. Used to drive the retry quota and rate limiter from a simulated clock in tests.
+ */
+typedef NSTimeInterval (^AWSRetryClock)(void);
+
+/**
+ Returns a random number in `[0, 1)`.
+ */
+typedef double (^AWSRetryRandomGenerator)(void);
+
+typedef NS_ENUM(NSInteger, AWSRetryBackoffStrategy) {
+    /** `base * 2^n` capped at `maximumBackoff`, picked uniformly from `[0, backoff)`. */
+    AWSRetryBackoffStrategyFullJitter,
+    /** Picked uniformly from `[base, 3 * previous delay)`, capped at `maximumBackoff`. */
+    AWSRetryBackoffStrategyDecorrelatedJitter,
+    /** `base * 2^n` capped at `maximumBackoff`, without jitter. */
+    AWSRetryBackoffStrategyExponential
+};
+
+/**
+ A token bucket limiting the retries sent to an endpoint. Each retry takes tokens from the bucket, and successful
+ requests put tokens back, so retries stop when most requests to the endpoint fail instead of multiplying its load.
+ */
+@interface AWSRetryQuota : NSObject
+
+@property (nonatomic, readonly) NSUInteger capacity;
+@property (nonatomic, readonly) NSUInteger availableTokens;
+
+/**
+ The quota shared by all requests to `host`, with the default capacity of 500 tokens.
+ */
++ (instancetype)sharedQuotaForHost:(NSString *)host;
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+/**
+ Takes the cost of a retry from the bucket: 10 tokens after a timeout, 5 after any other error.
+
+ @return The number of tokens taken, or 0 when the bucket does not have enough and the request must not be retried.
+ */
+- (NSUInteger)acquireForRetryWithError:(NSError *)error;
+
+/**
+ Called when a request succeeds. Puts back the tokens taken by its last retry, or 1 token when `acquiredTokens` is 0
+ because it succeeded on its first attempt.
+ */
+- (void)releaseTokens:(NSUInteger)acquiredTokens;
+
+@end
+
+/**
+ Limits the rate at which requests are sent to an endpoint, adapting to throttling errors the way the adaptive retry
+ mode of the other AWS SDKs does: the allowed rate drops to 70% of the measured send rate on each throttling error,
+ and grows back along a cubic curve while requests succeed. Requests are not limited until the first throttling error.
+ */
+@interface AWSClientRateLimiter : NSObject
+
+@property (nonatomic, readonly, getter=isEnabled) BOOL enabled;
+
+/**
+ The allowed rate in requests per second, once enabled.
+ */
+@property (nonatomic, readonly) double fillRate;
+
+/**
+ The smoothed rate at which requests have been completing, in requests per second.
+ */
+@property (nonatomic, readonly) double measuredSendRate;
+
++ (instancetype)sharedRateLimiterForHost:(NSString *)host;
+
+- (instancetype)initWithClock:(AWSRetryClock)clock;
+
+/**
+ Takes a token for sending a request.
+
+ @return How long the request must wait before it is sent. The token is reserved, so concurrent callers are spaced
+ out instead of all waiting for the same token.
+ */
+- (NSTimeInterval)acquireToken;
+
+/**
+ Updates the allowed rate with the outcome of a request.
+ */
+- (void)updateWithThrottlingResponse:(BOOL)throttled;
+
+@end
+
 @interface AWSURLRequestRetryHandler : NSObject <AWSURLRequestRetryHandler>
 
 @property (nonatomic, assign) uint32_t maxRetryCount;
 
+/**
+ The backoff between retries in the standard and adaptive retry modes. The default is `AWSRetryBackoffStrategyFullJitter`.
+ */
+@property (nonatomic, assign) AWSRetryBackoffStrategy backoffStrategy;
+
+/**
+ The base delay of the backoff in the standard and adaptive retry modes. The default is 100ms.
+ */
+@property (nonatomic, assign) NSTimeInterval baseDelay;
+
+/**
+ The longest delay between retries in the standard and adaptive retry modes. The default is 20 seconds.
+ */
+@property (nonatomic, assign) NSTimeInterval maximumBackoff;
+
+/**
+ The source of randomness for the jitter. Defaults to `arc4random`.
+ */
+@property (nonatomic, copy) AWSRetryRandomGenerator randomGenerator;
+
 - (instancetype)initWithMaximumRetryCount:(uint32_t)maxRetryCount;
 
+/**
+ Whether `error` reports that the request was throttled, e.g. `ThrottlingException`, `SlowDown` or a 429 status.
+ */
+- (BOOL)isThrottlingError:(NSError *)error response:(NSHTTPURLResponse *)response;
+
+/**
+ The retry quota for the endpoint `host`. Returns the quota shared by all handlers by default.
+ */
+- (AWSRetryQuota *)retryQuotaForHost:(NSString *)host;
+
+/**
+ The rate limiter for the endpoint `host` in the adaptive retry mode. Returns the one shared by all handlers by default.
+ */
+- (AWSClientRateLimiter *)rateLimiterForHost:(NSString *)host;
+
 @end
@@ -17,22 +17,333 @@
 #import "AWSURLResponseSerialization.h"
 #import "AWSService.h"
 
+static NSUInteger const AWSRetryQuotaDefaultCapacity = 500;
+static NSUInteger const AWSRetryQuotaRetryCost = 5;
+static NSUInteger const AWSRetryQuotaTimeoutRetryCost = 10;
+static NSUInteger const AWSRetryQuotaNoRetryIncrement = 1;
+
+// Constants of the cubic rate adjustment of the adaptive retry mode.
+static double const AWSClientRateLimiterMinimumFillRate = 0.5;
+static double const AWSClientRateLimiterMinimumCapacity = 1;
+static double const AWSClientRateLimiterSmoothing = 0.8;
+static double const AWSClientRateLimiterBeta = 0.7;
+static double const AWSClientRateLimiterScaleConstant = 0.4;
+
+static NSTimeInterval const AWSURLRequestRetryHandlerDefaultBaseDelay = 0.1;
+static NSTimeInterval const AWSURLRequestRetryHandlerDefaultMaximumBackoff = 20;
+
+static AWSRetryClock AWSRetryDefaultClock(void) {
+    return ^NSTimeInterval{
+        return [[NSProcessInfo processInfo] systemUptime];
+    };
+}
+
+// The endpoint a request is sent to, without calling `-[AWSNetworkingConfiguration URL]`, which updates the headers.
+static NSString *AWSRetryHostForRequest(AWSNetworkingRequest *request) {
+    NSURL *URL = request.task.originalRequest.URL;
+    if (!URL) {
+        URL = request.URLString ? [NSURL URLWithString:request.URLString relativeToURL:request.baseURL] : request.baseURL;
+    }
+    return [URL host] ?: @"";
+}
+
+#pragma mark - AWSRetryQuota
+
+@implementation AWSRetryQuota
+
++ (instancetype)sharedQuotaForHost:(NSString *)host {
+    static NSMutableDictionary *_sharedQuotas = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _sharedQuotas = [NSMutableDictionary new];
+    });
+    @synchronized(_sharedQuotas) {
+        AWSRetryQuota *quota = [_sharedQuotas objectForKey:host];
+        if (!quota) {
+            quota = [[AWSRetryQuota alloc] initWithCapacity:AWSRetryQuotaDefaultCapacity];
+            [_sharedQuotas setObject:quota forKey:host];
+        }
+        return quota;
+    }
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    if (self = [super init]) {
+        _capacity = capacity;
+        _availableTokens = capacity;
+    }
+    return self;
+}
+
+- (NSUInteger)availableTokens {
+    @synchronized(self) {
+        return _availableTokens;
+    }
+}
+
+- (NSUInteger)acquireForRetryWithError:(NSError *)error {
+    NSUInteger cost = AWSRetryQuotaRetryCost;
+    if ([error.domain isEqualToString:NSURLErrorDomain] && error.code == NSURLErrorTimedOut) {
+        cost = AWSRetryQuotaTimeoutRetryCost;
+    }
+    @synchronized(self) {
+        if (_availableTokens < cost) {
+            return 0;
+        }
+        _availableTokens -= cost;
+        return cost;
+    }
+}
+
+- (void)releaseTokens:(NSUInteger)acquiredTokens {
+    @synchronized(self) {
+        _availableTokens = MIN(_capacity, _availableTokens + (acquiredTokens > 0 ? acquiredTokens : AWSRetryQuotaNoRetryIncrement));
+    }
+}
+
+@end
+
+#pragma mark - AWSClientRateLimiter
+
+@interface AWSClientRateLimiter() {
+    AWSRetryClock _clock;
+    double _maximumCapacity;
+    double _currentCapacity;
+    NSTimeInterval _lastRefillTime;
+    double _lastMaximumRate;
+    NSTimeInterval _lastThrottleTime;
+    NSTimeInterval _timeWindow;
+    NSTimeInterval _lastSendRateBucket;
+    NSUInteger _requestCount;
+}
+
+@end
+
+@implementation AWSClientRateLimiter
+
++ (instancetype)sharedRateLimiterForHost:(NSString *)host {
+    static NSMutableDictionary *_sharedRateLimiters = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _sharedRateLimiters = [NSMutableDictionary new];
+    });
+    @synchronized(_sharedRateLimiters) {
+        AWSClientRateLimiter *rateLimiter = [_sharedRateLimiters objectForKey:host];
+        if (!rateLimiter) {
+            rateLimiter = [[AWSClientRateLimiter alloc] initWithClock:AWSRetryDefaultClock()];
+            [_sharedRateLimiters setObject:rateLimiter forKey:host];
+        }
+        return rateLimiter;
+    }
+}
+
+- (instancetype)init {
+    return [self initWithClock:AWSRetryDefaultClock()];
+}
+
+- (instancetype)initWithClock:(AWSRetryClock)clock {
+    if (self = [super init]) {
+        _clock = [clock copy];
+        NSTimeInterval now = _clock();
+        _fillRate = AWSClientRateLimiterMinimumFillRate;
+        _maximumCapacity = AWSClientRateLimiterMinimumCapacity;
+        _lastRefillTime = -1;
+        _lastThrottleTime = now;
+        _lastSendRateBucket = floor(now);
+    }
+    return self;
+}
+
+- (BOOL)isEnabled {
+    @synchronized(self) {
+        return _enabled;
+    }
+}
+
+- (double)fillRate {
+    @synchronized(self) {
+        return _fillRate;
+    }
+}
+
+- (double)measuredSendRate {
+    @synchronized(self) {
+        return _measuredSendRate;
+    }
+}
+
+- (NSTimeInterval)acquireToken {
+    @synchronized(self) {
+        if (!_enabled) {
+            return 0;
+        }
+        [self refill];
+        NSTimeInterval delay = 0;
+        if (_currentCapacity < 1) {
+            delay = (1 - _currentCapacity) / _fillRate;
+        }
+        _currentCapacity -= 1;
+        return delay;
+    }
+}
+
+- (void)updateWithThrottlingResponse:(BOOL)throttled {
+    @synchronized(self) {
+        NSTimeInterval now = _clock();
+        [self updateMeasuredRateAtTime:now];
+
+        double calculatedRate = 0;
+        if (throttled) {
+            double rateToUse = _enabled ? MIN(_measuredSendRate, _fillRate) : _measuredSendRate;
+            _lastMaximumRate = rateToUse;
+            [self updateTimeWindow];
+            _lastThrottleTime = now;
+            calculatedRate = rateToUse * AWSClientRateLimiterBeta;
+            _enabled = YES;
+        } else {
+            [self updateTimeWindow];
+            calculatedRate = AWSClientRateLimiterScaleConstant * pow(now - _lastThrottleTime - _timeWindow, 3) + _lastMaximumRate;
+        }
+
+        double rate = MIN(calculatedRate, 2 * _measuredSendRate);
+        [self refill];
+        _fillRate = MAX(rate, AWSClientRateLimiterMinimumFillRate);
+        _maximumCapacity = MAX(rate, AWSClientRateLimiterMinimumCapacity);
+        _currentCapacity = MIN(_currentCapacity, _maximumCapacity);
+    }
+}
+
+- (void)refill {
+    NSTimeInterval now = _clock();
+    if (_lastRefillTime >= 0) {
+        _currentCapacity = MIN(_maximumCapacity, _currentCapacity + (now - _lastRefillTime) * _fillRate);
+    }
+    _lastRefillTime = now;
+}
+
+// The time it takes the cubic curve to climb back to the rate at which the last throttling error happened.
+- (void)updateTimeWindow {
+    _timeWindow = cbrt(_lastMaximumRate * (1 - AWSClientRateLimiterBeta) / AWSClientRateLimiterScaleConstant);
+}
+
+- (void)updateMeasuredRateAtTime:(NSTimeInterval)now {
+    // Requests are counted in half second buckets.
+    NSTimeInterval bucket = floor(now * 2) / 2;
+    _requestCount++;
+    if (bucket > _lastSendRateBucket) {
+        double currentRate = _requestCount / (bucket - _lastSendRateBucket);
+        _measuredSendRate = currentRate * AWSClientRateLimiterSmoothing + _measuredSendRate * (1 - AWSClientRateLimiterSmoothing);
+        _requestCount = 0;
+        _lastSendRateBucket = bucket;
+    }
+}
+
+@end
+
+#pragma mark - AWSURLRequestRetryHandler
+
+// What a handler remembers about a request between its attempts.
+@interface AWSURLRequestRetryState : NSObject
+
+@property (nonatomic, assign) NSTimeInterval previousDelay;
+@property (nonatomic, assign) NSUInteger acquiredTokens;
+
+@end
+
+@implementation AWSURLRequestRetryState
+
+@end
+
 @interface AWSURLRequestRetryHandler ()
 
 @property (atomic, assign) BOOL isClockSkewRetried;
+@property (nonatomic, strong) NSMapTable<AWSNetworkingRequest *, AWSURLRequestRetryState *> *retryStates;
 
 @end
 
 @implementation AWSURLRequestRetryHandler
 
+- (instancetype)init {
+    return [self initWithMaximumRetryCount:0];
+}
+
 - (instancetype)initWithMaximumRetryCount:(uint32_t)maxRetryCount {
     if (self = [super init]) {
         _maxRetryCount = maxRetryCount;
+        _backoffStrategy = AWSRetryBackoffStrategyFullJitter;
+        _baseDelay = AWSURLRequestRetryHandlerDefaultBaseDelay;
+        _maximumBackoff = AWSURLRequestRetryHandlerDefaultMaximumBackoff;
+        _randomGenerator = ^double{
+            return arc4random() / ((double)UINT32_MAX + 1);
+        };
+        _retryStates = [NSMapTable weakToStrongObjectsMapTable];
     }
 
     return self;
 }
 
+- (AWSRetryQuota *)retryQuotaForHost:(NSString *)host {
+    return [AWSRetryQuota sharedQuotaForHost:host];
+}
+
+- (AWSClientRateLimiter *)rateLimiterForHost:(NSString *)host {
+    return [AWSClientRateLimiter sharedRateLimiterForHost:host];
+}
+
+- (AWSURLRequestRetryState *)retryStateForRequest:(AWSNetworkingRequest *)request {
+    @synchronized(self.retryStates) {
+        AWSURLRequestRetryState *state = [self.retryStates objectForKey:request];
+        if (!state) {
+            state = [AWSURLRequestRetryState new];
+            [self.retryStates setObject:state forKey:request];
+        }
+        return state;
+    }
+}
+
+- (BOOL)isThrottlingError:(NSError *)error response:(NSHTTPURLResponse *)response {
+    if (response.statusCode == 429) {
+        return YES;
+    }
+    if ([error.domain isEqualToString:AWSServiceErrorDomain]) {
+        switch (error.code) {
+            case AWSServiceErrorThrottling:
+            case AWSServiceErrorThrottlingException:
+                return YES;
+            default:
+                break;
+        }
+    }
+
+    static NSSet<NSString *> *throttlingErrorCodes = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        throttlingErrorCodes = [NSSet setWithArray:@[@"Throttling",
+                                                     @"ThrottlingException",
+                                                     @"ThrottledException",
+                                                     @"RequestThrottledException",
+                                                     @"TooManyRequestsException",
+                                                     @"ProvisionedThroughputExceededException",
+                                                     @"TransactionInProgressException",
+                                                     @"RequestLimitExceeded",
+                                                     @"BandwidthLimitExceeded",
+                                                     @"LimitExceededException",
+                                                     @"RequestThrottled",
+                                                     @"SlowDown",
+                                                     @"PriorRequestNotComplete",
+                                                     @"EC2ThrottledException"]];
+    });
+    // JSON protocols report the error code in `__type`, XML protocols in `Code`.
+    id code = [[error.userInfo[@"__type"] componentsSeparatedByString:@"#"] lastObject];
+    if (![code isKindOfClass:[NSString class]]) {
+        code = error.userInfo[@"Code"];
+    }
+    if (![code isKindOfClass:[NSString class]] && [error.userInfo[@"Error"] isKindOfClass:[NSDictionary class]]) {
+        code = error.userInfo[@"Error"][@"Code"];
+    }
+    return [code isKindOfClass:[NSString class]] && [throttlingErrorCodes containsObject:code];
+}
+
 - (BOOL)isClockSkewError:(NSError *)error {
     if ([error.domain isEqualToString:AWSServiceErrorDomain]) {
         switch (error.code) {
@@ -141,4 +452,83 @@
     return pow(2, currentRetryCount) * 100 / 1000;
 }
 
+#pragma mark - Retry modes
+
+- (NSTimeInterval)timeIntervalBeforeAttempt:(uint32_t)currentRetryCount
+                            originalRequest:(AWSNetworkingRequest *)originalRequest {
+    if (originalRequest.retryMode != AWSNetworkingRetryModeAdaptive) {
+        return 0;
+    }
+    return [[self rateLimiterForHost:AWSRetryHostForRequest(originalRequest)] acquireToken];
+}
+
+- (void)attempt:(uint32_t)currentRetryCount
+didCompleteForRequest:(AWSNetworkingRequest *)originalRequest
+       response:(NSHTTPURLResponse *)response
+          error:(NSError *)error {
+    if (originalRequest.retryMode == AWSNetworkingRetryModeLegacy) {
+        return;
+    }
+    NSString *host = AWSRetryHostForRequest(originalRequest);
+    if (originalRequest.retryMode == AWSNetworkingRetryModeAdaptive) {
+        [[self rateLimiterForHost:host] updateWithThrottlingResponse:[self isThrottlingError:error response:response]];
+    }
+    if (!error) {
+        AWSURLRequestRetryState *state = nil;
+        @synchronized(self.retryStates) {
+            state = [self.retryStates objectForKey:originalRequest];
+            [self.retryStates removeObjectForKey:originalRequest];
+        }
+        [[self retryQuotaForHost:host] releaseTokens:state.acquiredTokens];
+    }
+}
+
+- (BOOL)acquireRetry:(uint32_t)currentRetryCount
+     originalRequest:(AWSNetworkingRequest *)originalRequest
+               error:(NSError *)error {
+    if (originalRequest.retryMode == AWSNetworkingRetryModeLegacy) {
+        return YES;
+    }
+    NSUInteger acquiredTokens = [[self retryQuotaForHost:AWSRetryHostForRequest(originalRequest)] acquireForRetryWithError:error];
+    if (acquiredTokens == 0) {
+        @synchronized(self.retryStates) {
+            [self.retryStates removeObjectForKey:originalRequest];
+        }
+        return NO;
+    }
+    [self retryStateForRequest:originalRequest].acquiredTokens = acquiredTokens;
+    return YES;
+}
+
+- (NSTimeInterval)timeIntervalForRetry:(uint32_t)currentRetryCount
+                       originalRequest:(AWSNetworkingRequest *)originalRequest
+                              response:(NSHTTPURLResponse *)response
+                                  data:(NSData *)data
+                                 error:(NSError *)error {
+    if (originalRequest.retryMode == AWSNetworkingRetryModeLegacy) {
+        return [self timeIntervalForRetry:currentRetryCount
+                                 response:response
+                                     data:data
+                                    error:error];
+    }
+
+    NSTimeInterval backoff = MIN(self.maximumBackoff, self.baseDelay * pow(2, currentRetryCount));
+    switch (self.backoffStrategy) {
+        case AWSRetryBackoffStrategyFullJitter:
+            return self.randomGenerator() * backoff;
+
+        case AWSRetryBackoffStrategyDecorrelatedJitter: {
+            AWSURLRequestRetryState *state = [self retryStateForRequest:originalRequest];
+            NSTimeInterval previousDelay = MAX(state.previousDelay, self.baseDelay);
+            NSTimeInterval delay = MIN(self.maximumBackoff, self.baseDelay + self.randomGenerator() * (previousDelay * 3 - self.baseDelay));
+            state.previousDelay = delay;
+            return delay;
+        }
+
+        case AWSRetryBackoffStrategyExponential:
+            return backoff;
+    }
+    return backoff;
+}
+
 @end
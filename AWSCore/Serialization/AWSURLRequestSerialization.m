@@ -22,6 +22,7 @@
 #import "AWSCategory.h"
 #import "AWSCocoaLumberjack.h"
 #import "AWSClientContext.h"
+#import "AWSSignature.h"
 
 @interface NSMutableURLRequest (AWSRequestSerializer)
 
@@ -87,8 +88,7 @@
     }
 
     NSDictionary *actionRules = [[self.serviceDefinitionJSON objectForKey:@"operations"] objectForKey:self.actionName];
-    NSDictionary *shapeRules = [self.serviceDefinitionJSON objectForKey:@"shapes"];
-    AWSJSONDictionary *inputRules = [[AWSJSONDictionary alloc] initWithDictionary:[actionRules objectForKey:@"input"] JSONDefinitionRule:shapeRules];
+    AWSJSONDictionary *inputRules = [AWSJSONDictionary rulesForOperation:self.actionName ruleType:@"input" serviceDefinitionRule:self.serviceDefinitionJSON];
 
     NSDictionary *actionHTTPRule = [actionRules objectForKey:@"http"];
     NSString *ruleURIStr = [actionHTTPRule objectForKey:@"requestUri"];
@@ -187,8 +187,7 @@
 
     //Construct URI and Headers and HTTPBodyStream
     NSString *ruleURIStr = [actionHTTPRule objectForKey:@"requestUri"];
-    NSDictionary *shapeRules = [self.serviceDefinitionJSON objectForKey:@"shapes"];
-    AWSJSONDictionary *inputRules = [[AWSJSONDictionary alloc] initWithDictionary:[anActionRules objectForKey:@"input"] JSONDefinitionRule:shapeRules];
+    AWSJSONDictionary *inputRules = [AWSJSONDictionary rulesForOperation:self.actionName ruleType:@"input" serviceDefinitionRule:self.serviceDefinitionJSON];
 
     NSDictionary *actionEndpoint = [anActionRules objectForKey:@"endpoint"];
     NSString *endpointHostPrefix = [actionEndpoint objectForKey:@"hostPrefix"];
@@ -342,6 +341,7 @@
                 if ([value isKindOfClass:[NSURL class]]) {
                     if ([value checkResourceIsReachableAndReturnError:&blockErr]) {
                         request.HTTPBodyStream = [NSInputStream inputStreamWithURL:value];
+                        [NSURLProtocol setProperty:[value absoluteString] forKey:AWSSignatureV4PayloadFileURLKey inRequest:request];
                     } else {
                         //URL is not reachable, stop enumeration
                         isValid = NO;
@@ -34,6 +34,11 @@
 
 @property (nonatomic, assign) Class outputClass;
 
+/**
+ Called with each element of the top-level lists of the response, converted to the model class of the list.
+ */
+@property (nonatomic, copy) AWSNetworkingResponseItemBlock responseItemHandler;
+
 - (instancetype)initWithJSONDefinition:(NSDictionary *)JSONDefinition
                             actionName:(NSString *)actionName
                            outputClass:(Class)outputClass;
@@ -19,6 +19,8 @@
 #import "AWSService.h"
 #import "AWSValidation.h"
 #import "AWSSerialization.h"
+#import "AWSXMLStreamingParser.h"
+#import "AWSResponseBodyConsumer.h"
 
 #pragma mark - Service errors
 
@@ -98,9 +100,7 @@
 
     //Parse AWSServiceError
     if ([result isKindOfClass:[NSDictionary class]]) {
-        NSDictionary *anActionRules = [[self.serviceDefinitionJSON objectForKey:@"operations"] objectForKey:_actionName];
-        NSDictionary *shapeRules = [self.serviceDefinitionJSON objectForKey:@"shapes"];
-        AWSJSONDictionary *outputRules = [[AWSJSONDictionary alloc] initWithDictionary:[anActionRules objectForKey:@"output"] JSONDefinitionRule:shapeRules];
+        AWSJSONDictionary *outputRules = [AWSJSONDictionary rulesForOperation:self.actionName ruleType:@"output" serviceDefinitionRule:self.serviceDefinitionJSON];
         result = [AWSXMLResponseSerializer parseResponse:response rules:outputRules bodyDictionary:[result mutableCopy] error:error];
 
         NSNumber *errorCode = [[AWSService errorCodeDictionary] objectForKey:[[[result objectForKey:@"__type"] componentsSeparatedByString:@"#"] lastObject]];
@@ -160,6 +160,48 @@
     return YES;
 }
 
+- (id<AWSNetworkingResponseBodyConsumer>)responseBodyConsumerForResponse:(NSHTTPURLResponse *)response
+                                                         originalRequest:(NSURLRequest *)originalRequest {
+    // Only list responses delivered to an item handler are worth parsing while they download. Error documents, including
+    // the ones S3 may return with a 200 status to a PUT, are collected and parsed as usual.
+    if (!self.responseItemHandler
+        || response.statusCode / 100 != 2
+        || [originalRequest.HTTPMethod isEqualToString:@"PUT"]) {
+        return nil;
+    }
+    AWSJSONDictionary *outputRules = [AWSJSONDictionary rulesForOperation:self.actionName ruleType:@"output" serviceDefinitionRule:self.serviceDefinitionJSON];
+    if (outputRules[@"payload"]) {
+        return nil;
+    }
+
+    AWSNetworkingResponseItemBlock responseItemHandler = self.responseItemHandler;
+    Class outputClass = self.outputClass;
+    return [[AWSStreamingResponseBodyConsumer alloc] initWithParser:^id(NSInputStream *inputStream, NSHTTPURLResponse *response, NSError *__autoreleasing *error) {
+        AWSXMLStreamingParser *streamingParser = [[AWSXMLStreamingParser alloc] initWithRules:outputRules];
+        streamingParser.itemHandler = ^(NSString *memberName, id item) {
+            responseItemHandler(memberName, [AWSXMLResponseSerializer modelForItem:item memberName:memberName outputClass:outputClass]);
+        };
+        return [streamingParser parseStream:inputStream error:error];
+    }];
+}
+
++ (id)modelForItem:(id)item memberName:(NSString *)memberName outputClass:(Class)outputClass {
+    if (![outputClass respondsToSelector:@selector(JSONKeyPathsByPropertyKey)]) {
+        return item;
+    }
+
+    //the list transformer of the output class turns an element into its model class
+    NSString *propertyKey = [[[outputClass JSONKeyPathsByPropertyKey] allKeysForObject:memberName] firstObject];
+    SEL selector = NSSelectorFromString([propertyKey stringByAppendingString:@"JSONTransformer"]);
+    if (!propertyKey || ![outputClass respondsToSelector:selector]) {
+        return item;
+    }
+    NSValueTransformer *(*transformerForKey)(id, SEL) = (void *)[outputClass methodForSelector:selector];
+    NSValueTransformer *transformer = transformerForKey(outputClass, selector);
+    id models = [transformer transformedValue:@[item]];
+    return [models isKindOfClass:[NSArray class]] ? [models firstObject] : item;
+}
+
 + (NSMutableDictionary *)parseResponse:(NSHTTPURLResponse *)response
                                  rules:(AWSJSONDictionary *)rules
                         bodyDictionary:(NSMutableDictionary *)bodyDictionary
@@ -250,9 +292,7 @@
         return nil;
     }
 
-    NSDictionary *anActionRules = [[self.serviceDefinitionJSON objectForKey:@"operations"] objectForKey:self.actionName];
-    NSDictionary *shapeRules = [self.serviceDefinitionJSON objectForKey:@"shapes"];
-    AWSJSONDictionary *outputRules = [[AWSJSONDictionary alloc] initWithDictionary:[anActionRules objectForKey:@"output"] JSONDefinitionRule:shapeRules];
+    AWSJSONDictionary *outputRules = [AWSJSONDictionary rulesForOperation:self.actionName ruleType:@"output" serviceDefinitionRule:self.serviceDefinitionJSON];
 
     NSMutableDictionary *resultDic = [NSMutableDictionary new];
 
@@ -268,11 +308,19 @@
         }
     }
 
-    if ([resultDic count] == 0) {
+    if ([data isKindOfClass:[NSDictionary class]]) {
+        //already parsed while it was received, see -responseBodyConsumerForResponse:originalRequest:
+        resultDic = [data mutableCopy];
+    } else if ([resultDic count] == 0) {
         //if not blob type, try to parse as XML string
+        AWSNetworkingResponseItemBlock responseItemHandler = self.responseItemHandler;
+        Class outputClass = self.outputClass;
         resultDic = [[AWSXMLParser sharedInstance] dictionaryForXMLData:data
                                                              actionName:self.actionName
                                                   serviceDefinitionRule:self.serviceDefinitionJSON
+                                                            itemHandler:responseItemHandler ? ^(NSString *memberName, id item) {
+            responseItemHandler(memberName, [AWSXMLResponseSerializer modelForItem:item memberName:memberName outputClass:outputClass]);
+        } : nil
                                                                   error:error];
     }
 
@@ -0,0 +1,72 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class AWSJSONDictionary;
+
+/**
+ Called for each element of a list member of the response structure, e.g. each `Contents` entry of `ListObjectsV2`.
+ */
+typedef void (^AWSXMLStreamingParserItemBlock)(NSString *memberName, id item);
+
+/**
+ Parses a rest-xml response body in a single pass, applying the output rules of the operation as elements are read.
+
+ `AWSXMLParser` used to build an `AWSXMLDictionary` tree of the whole document and then walk it again to apply the
+ rules. The streaming parser only keeps the values that end up in the result, and when an `itemHandler` is set, the
+ elements of the top-level lists are handed to it as soon as they are complete instead of being kept at all.
+
+ The result has the same shape as the one returned by `-[AWSXMLParser dictionaryForXMLData:actionName:serviceDefinitionRule:error:]`.
+ Error documents and payload members are not handled; `-parseData:error:` returns `nil` without an error for them so
+ the caller can fall back to `AWSXMLParser`.
+ */
+@interface AWSXMLStreamingParser : NSObject
+
+/**
+ Called with the elements of the lists that are direct members of the response structure. Elements passed to the
+ handler are not added to the result.
+ */
+@property (nonatomic, copy, nullable) AWSXMLStreamingParserItemBlock itemHandler;
+
+/**
+ @param rules The output rules of the operation, as returned by `+[AWSJSONDictionary rulesForOperation:ruleType:serviceDefinitionRule:]`.
+ */
+- (instancetype)initWithRules:(AWSJSONDictionary *)rules;
+
+/**
+ Returns the parsed response structure.
+
+ @param data  The XML response body.
+ @param error Set when the document does not match the rules.
+ @return The parsed structure, or `nil` when the document can not be parsed by the streaming parser.
+ */
+- (nullable NSMutableDictionary *)parseData:(NSData *)data
+                                      error:(NSError *__autoreleasing *)error;
+
+/**
+ Returns the parsed response structure, reading the document from `inputStream` as it becomes available.
+
+ Unlike `-parseData:error:`, a document the streaming parser does not handle is reported as an error, since there is
+ no copy of it to fall back to.
+ */
+- (nullable NSMutableDictionary *)parseStream:(NSInputStream *)inputStream
+                                        error:(NSError *__autoreleasing *)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
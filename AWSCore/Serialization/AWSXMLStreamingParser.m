@@ -0,0 +1,455 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSXMLStreamingParser.h"
+#import "AWSSerialization.h"
+#import "AWSTimestampSerialization.h"
+#import "AWSCocoaLumberjack.h"
+
+typedef NS_ENUM(NSInteger, AWSXMLStreamingFrameType) {
+    AWSXMLStreamingFrameTypeIgnored,
+    AWSXMLStreamingFrameTypeStructure,
+    AWSXMLStreamingFrameTypeList,
+    AWSXMLStreamingFrameTypeMap,
+    AWSXMLStreamingFrameTypeMapEntry,
+    AWSXMLStreamingFrameTypeScalar,
+};
+
+// How the value of a frame is handed to its parent once the element ends.
+typedef NS_ENUM(NSInteger, AWSXMLStreamingDelivery) {
+    AWSXMLStreamingDeliveryNone,
+    AWSXMLStreamingDeliveryMember,
+    AWSXMLStreamingDeliveryListItem,
+    AWSXMLStreamingDeliveryFlattenedListItem,
+    AWSXMLStreamingDeliveryMapEntry,
+    AWSXMLStreamingDeliveryFlattenedMapEntry,
+    AWSXMLStreamingDeliveryMapKey,
+    AWSXMLStreamingDeliveryMapValue,
+};
+
+@interface AWSXMLStreamingFrame : NSObject {
+@public
+    AWSXMLStreamingFrameType _type;
+    AWSXMLStreamingDelivery _delivery;
+    NSDictionary *_rules;
+    NSString *_name;
+    id _container;
+    NSMutableString *_text;
+    BOOL _streamsItems;
+    id _entryKey;
+    id _entryValue;
+}
+
+@end
+
+@implementation AWSXMLStreamingFrame
+
+@end
+
+@interface AWSXMLStreamingParser() <NSXMLParserDelegate>
+
+@property (nonatomic, strong) AWSJSONDictionary *rules;
+@property (nonatomic, strong) NSMutableArray<AWSXMLStreamingFrame *> *frames;
+@property (nonatomic, strong) NSMutableDictionary *result;
+@property (nonatomic, strong) NSError *ruleError;
+@property (nonatomic, assign) BOOL unsupported;
+
+@end
+
+@implementation AWSXMLStreamingParser
+
+- (instancetype)initWithRules:(AWSJSONDictionary *)rules {
+    if (self = [super init]) {
+        _rules = rules;
+    }
+    return self;
+}
+
+- (NSMutableDictionary *)parseData:(NSData *)data
+                             error:(NSError *__autoreleasing *)error {
+    if (self.rules[@"payload"]) {
+        return nil;
+    }
+    return [self parseWithParser:[[NSXMLParser alloc] initWithData:data] error:error];
+}
+
+- (NSMutableDictionary *)parseStream:(NSInputStream *)inputStream
+                               error:(NSError *__autoreleasing *)error {
+    NSError *parseError = nil;
+    NSMutableDictionary *result = nil;
+    if (!self.rules[@"payload"]) {
+        result = [self parseWithParser:[[NSXMLParser alloc] initWithStream:inputStream] error:&parseError];
+    }
+    if (!result && !parseError) {
+        // There is no body to fall back to.
+        parseError = [NSError errorWithDomain:AWSXMLParserErrorDomain
+                                         code:AWSXMLParserUnexpectedXMLElement
+                                     userInfo:@{NSLocalizedDescriptionKey : @"The response body can not be parsed while it is received."}];
+    }
+    if (parseError && error) {
+        *error = parseError;
+    }
+    return result;
+}
+
+- (NSMutableDictionary *)parseWithParser:(NSXMLParser *)parser
+                                   error:(NSError *__autoreleasing *)error {
+    self.frames = [NSMutableArray new];
+    self.result = nil;
+    self.ruleError = nil;
+    self.unsupported = NO;
+
+    parser.delegate = self;
+    parser.shouldProcessNamespaces = NO;
+    parser.shouldResolveExternalEntities = NO;
+    BOOL succeeded = [parser parse];
+    self.frames = nil;
+
+    if (self.ruleError) {
+        if (error) {
+            *error = self.ruleError;
+        }
+        return self.result ?: [NSMutableDictionary new];
+    }
+    if (!succeeded || self.unsupported || !self.result) {
+        return nil;
+    }
+    return self.result;
+}
+
+#pragma mark - Rules
+
++ (NSDictionary<NSString *, NSString *> *)memberNamesByXMLNameForMembers:(NSDictionary *)members {
+    static NSMapTable *cache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        // The members dictionaries are shared by the rules of a service definition, so they are looked up by pointer.
+        // With object personality, every lookup would compare whole dictionaries, whose hash is only their count.
+        cache = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality
+                                      valueOptions:NSPointerFunctionsStrongMemory];
+    });
+
+    @synchronized(cache) {
+        NSDictionary *memberNames = [cache objectForKey:members];
+        if (memberNames) {
+            return memberNames;
+        }
+    }
+
+    // Same lookup as `+[AWSXMLParser findKeyNameByXMLName:rules:]`, where a member name wins over any location name.
+    NSMutableDictionary *memberNames = [NSMutableDictionary new];
+    [members enumerateKeysAndObjectsUsingBlock:^(NSString *key, id obj, BOOL *stop) {
+        if (![obj isKindOfClass:[NSDictionary class]]) {
+            return;
+        }
+        NSString *xmlName = obj[@"locationName"];
+        if (([obj[@"type"] isEqualToString:@"list"] || [obj[@"type"] isEqualToString:@"map"]) && [obj[@"flattened"] boolValue]) {
+            xmlName = obj[@"member"][@"locationName"] ?: obj[@"locationName"] ?: @"member";
+        }
+        if (xmlName && !memberNames[xmlName]) {
+            memberNames[xmlName] = key;
+        }
+    }];
+    for (NSString *key in members) {
+        memberNames[key] = key;
+    }
+
+    @synchronized(cache) {
+        [cache setObject:memberNames forKey:members];
+    }
+    return memberNames;
+}
+
+- (AWSXMLStreamingFrame *)frameForRules:(NSDictionary *)rules {
+    AWSXMLStreamingFrame *frame = [AWSXMLStreamingFrame new];
+    frame->_rules = rules;
+
+    NSString *rulesType = rules[@"type"];
+    if (!rulesType) {
+        self.ruleError = [NSError errorWithDomain:AWSXMLParserErrorDomain
+                                             code:AWSXMLParserNoTypeDefinitionInRule
+                                         userInfo:@{NSLocalizedDescriptionKey : [NSString stringWithFormat:@"can not find the 'type' keywords in definition file:%@", [rules description]]}];
+        return nil;
+    }
+
+    if ([rulesType isEqualToString:@"structure"]) {
+        frame->_type = AWSXMLStreamingFrameTypeStructure;
+        frame->_container = [NSMutableDictionary new];
+    } else if ([rulesType isEqualToString:@"list"]) {
+        frame->_type = AWSXMLStreamingFrameTypeList;
+        frame->_container = [NSMutableArray new];
+    } else if ([rulesType isEqualToString:@"map"]) {
+        frame->_type = AWSXMLStreamingFrameTypeMap;
+        frame->_container = [NSMutableDictionary new];
+    } else {
+        frame->_type = AWSXMLStreamingFrameTypeScalar;
+        frame->_text = [NSMutableString new];
+    }
+    return frame;
+}
+
+- (AWSXMLStreamingFrame *)mapEntryFrameForRules:(NSDictionary *)mapRules {
+    AWSXMLStreamingFrame *frame = [AWSXMLStreamingFrame new];
+    frame->_type = AWSXMLStreamingFrameTypeMapEntry;
+    frame->_rules = mapRules;
+    return frame;
+}
+
+- (AWSXMLStreamingFrame *)childFrameForElement:(NSString *)elementName parent:(AWSXMLStreamingFrame *)parent {
+    BOOL isTopLevel = [self.frames count] == 1;
+
+    switch (parent->_type) {
+        case AWSXMLStreamingFrameTypeStructure: {
+            NSDictionary *members = parent->_rules[@"members"] ?: @{};
+            NSString *keyName = [AWSXMLStreamingParser memberNamesByXMLNameForMembers:members][elementName];
+            if (!keyName) {
+                if (isTopLevel && ([elementName isEqualToString:@"Error"] || [elementName isEqualToString:@"Errors"])) {
+                    self.unsupported = YES;
+                } else if (![elementName isEqualToString:@"requestId"] && ![elementName isEqualToString:@"ResponseMetadata"]) {
+                    AWSDDLogWarn(@"Response element ignored: no rule for %@", elementName);
+                }
+                return nil;
+            }
+
+            NSDictionary *memberRules = members[keyName];
+            NSString *name = memberRules[@"name"] ?: keyName;
+            BOOL isFlattened = [memberRules[@"flattened"] boolValue];
+            AWSXMLStreamingFrame *frame = nil;
+            if (isFlattened && [memberRules[@"type"] isEqualToString:@"list"]) {
+                frame = [self frameForRules:memberRules[@"member"] ?: @{}];
+                frame->_delivery = AWSXMLStreamingDeliveryFlattenedListItem;
+                frame->_streamsItems = isTopLevel && self.itemHandler;
+            } else if (isFlattened && [memberRules[@"type"] isEqualToString:@"map"]) {
+                frame = [self mapEntryFrameForRules:memberRules];
+                frame->_delivery = AWSXMLStreamingDeliveryFlattenedMapEntry;
+            } else {
+                frame = [self frameForRules:memberRules];
+                frame->_delivery = AWSXMLStreamingDeliveryMember;
+                frame->_streamsItems = isTopLevel && self.itemHandler && frame->_type == AWSXMLStreamingFrameTypeList;
+            }
+            frame->_name = name;
+            return frame;
+        }
+        case AWSXMLStreamingFrameTypeList: {
+            NSDictionary *memberRules = parent->_rules[@"member"] ?: @{};
+            NSString *memberName = memberRules[@"locationName"] ?: @"member";
+            if (![elementName isEqualToString:memberName]) {
+                return nil;
+            }
+            AWSXMLStreamingFrame *frame = [self frameForRules:memberRules];
+            frame->_delivery = AWSXMLStreamingDeliveryListItem;
+            frame->_streamsItems = parent->_streamsItems;
+            frame->_name = parent->_name;
+            return frame;
+        }
+        case AWSXMLStreamingFrameTypeMap: {
+            if (![elementName isEqualToString:@"entry"]) {
+                return nil;
+            }
+            AWSXMLStreamingFrame *frame = [self mapEntryFrameForRules:parent->_rules];
+            frame->_delivery = AWSXMLStreamingDeliveryMapEntry;
+            return frame;
+        }
+        case AWSXMLStreamingFrameTypeMapEntry: {
+            NSDictionary *keyRules = parent->_rules[@"key"] ?: @{};
+            NSDictionary *valueRules = parent->_rules[@"value"] ?: @{};
+            if ([elementName isEqualToString:keyRules[@"locationName"] ?: @"key"]) {
+                AWSXMLStreamingFrame *frame = [AWSXMLStreamingFrame new];
+                frame->_type = AWSXMLStreamingFrameTypeScalar;
+                frame->_rules = @{@"type" : @"string"};
+                frame->_text = [NSMutableString new];
+                frame->_delivery = AWSXMLStreamingDeliveryMapKey;
+                return frame;
+            } else if ([elementName isEqualToString:valueRules[@"locationName"] ?: @"value"]) {
+                AWSXMLStreamingFrame *frame = [self frameForRules:valueRules];
+                frame->_delivery = AWSXMLStreamingDeliveryMapValue;
+                return frame;
+            }
+            return nil;
+        }
+        default:
+            return nil;
+    }
+}
+
+- (id)valueForScalarFrame:(AWSXMLStreamingFrame *)frame {
+    NSString *text = frame->_text;
+    NSString *rulesType = frame->_rules[@"type"];
+
+    if ([rulesType isEqualToString:@"string"] || [rulesType isEqualToString:@"character"]) {
+        return [text copy];
+    } else if ([rulesType isEqualToString:@"integer"] || [rulesType isEqualToString:@"long"]) {
+        return [NSNumber numberWithInteger:[text integerValue]];
+    } else if ([rulesType isEqualToString:@"float"] || [rulesType isEqualToString:@"double"]) {
+        return [NSNumber numberWithDouble:[text doubleValue]];
+    } else if ([rulesType isEqualToString:@"boolean"]) {
+        return [NSNumber numberWithBool:[text boolValue]];
+    } else if ([rulesType isEqualToString:@"timestamp"]) {
+        NSError *error = nil;
+        NSString *timestampStr = [AWSQueryTimestampSerialization serializeTimestamp:frame->_rules value:[text copy] error:&error];
+        if (error) {
+            self.ruleError = error;
+        }
+        return timestampStr;
+    } else if ([rulesType isEqualToString:@"blob"]) {
+        //decode Base64Str to NSData
+        NSData *decodedData = [[NSData alloc] initWithBase64EncodedString:text options:0];
+        //return origin string value if can not be encoded.
+        return decodedData ?: [text copy];
+    }
+
+    self.ruleError = [NSError errorWithDomain:AWSXMLParserErrorDomain
+                                         code:AWSXMLParserUnHandledType
+                                     userInfo:@{NSLocalizedDescriptionKey : [NSString stringWithFormat:@"unhandled type for value:%@", text]}];
+    return nil;
+}
+
+#pragma mark - NSXMLParserDelegate
+
+- (void)parser:(NSXMLParser *)parser
+didStartElement:(NSString *)elementName
+  namespaceURI:(NSString *)namespaceURI
+ qualifiedName:(NSString *)qName
+    attributes:(NSDictionary<NSString *, NSString *> *)attributeDict {
+    AWSXMLStreamingFrame *parent = [self.frames lastObject];
+    AWSXMLStreamingFrame *frame = nil;
+
+    if (!parent) {
+        // Error documents, and documents whose root element is itself the member (e.g. `LocationConstraint`), are left to AWSXMLParser.
+        if ([elementName isEqualToString:@"Error"]
+            || [AWSXMLStreamingParser memberNamesByXMLNameForMembers:self.rules[@"members"] ?: @{}][elementName]) {
+            self.unsupported = YES;
+            [parser abortParsing];
+            return;
+        }
+        frame = [self frameForRules:@{@"type" : @"structure", @"members" : self.rules[@"members"] ?: @{}}];
+        self.result = frame->_container;
+    } else if (parent->_type != AWSXMLStreamingFrameTypeIgnored) {
+        frame = [self childFrameForElement:elementName parent:parent];
+    }
+
+    if (self.ruleError || self.unsupported) {
+        [parser abortParsing];
+        return;
+    }
+
+    if (!frame) {
+        // Skip the element and everything inside it.
+        frame = [AWSXMLStreamingFrame new];
+        frame->_type = AWSXMLStreamingFrameTypeIgnored;
+    }
+    [self.frames addObject:frame];
+}
+
+- (void)parser:(NSXMLParser *)parser foundCharacters:(NSString *)string {
+    AWSXMLStreamingFrame *frame = [self.frames lastObject];
+    if (frame->_type == AWSXMLStreamingFrameTypeScalar) {
+        [frame->_text appendString:string];
+    }
+}
+
+- (void)parser:(NSXMLParser *)parser foundCDATA:(NSData *)CDATABlock {
+    AWSXMLStreamingFrame *frame = [self.frames lastObject];
+    if (frame->_type == AWSXMLStreamingFrameTypeScalar) {
+        NSString *string = [[NSString alloc] initWithData:CDATABlock encoding:NSUTF8StringEncoding];
+        if (string) {
+            [frame->_text appendString:string];
+        }
+    }
+}
+
+- (void)parser:(NSXMLParser *)parser
+ didEndElement:(NSString *)elementName
+  namespaceURI:(NSString *)namespaceURI
+ qualifiedName:(NSString *)qName {
+    AWSXMLStreamingFrame *frame = [self.frames lastObject];
+    [self.frames removeLastObject];
+    AWSXMLStreamingFrame *parent = [self.frames lastObject];
+
+    if (frame->_type == AWSXMLStreamingFrameTypeIgnored || !parent) {
+        return;
+    }
+
+    id value = nil;
+    if (frame->_type == AWSXMLStreamingFrameTypeScalar) {
+        value = [self valueForScalarFrame:frame];
+        if (self.ruleError) {
+            [parser abortParsing];
+            return;
+        }
+    } else {
+        value = frame->_container;
+    }
+
+    switch (frame->_delivery) {
+        case AWSXMLStreamingDeliveryMember:
+            if (value) {
+                parent->_container[frame->_name] = value;
+            }
+            break;
+        case AWSXMLStreamingDeliveryListItem:
+            if (!value) {
+                break;
+            }
+            if (frame->_streamsItems) {
+                self.itemHandler(frame->_name, value);
+            } else {
+                [parent->_container addObject:value];
+            }
+            break;
+        case AWSXMLStreamingDeliveryFlattenedListItem: {
+            NSMutableArray *list = parent->_container[frame->_name];
+            if (!list) {
+                list = [NSMutableArray new];
+                parent->_container[frame->_name] = list;
+            }
+            if (!value) {
+                break;
+            }
+            if (frame->_streamsItems) {
+                self.itemHandler(frame->_name, value);
+            } else {
+                [list addObject:value];
+            }
+            break;
+        }
+        case AWSXMLStreamingDeliveryMapEntry:
+            if (frame->_entryKey && frame->_entryValue) {
+                parent->_container[frame->_entryKey] = frame->_entryValue;
+            }
+            break;
+        case AWSXMLStreamingDeliveryFlattenedMapEntry: {
+            NSMutableDictionary *map = parent->_container[frame->_name];
+            if (!map) {
+                map = [NSMutableDictionary new];
+                parent->_container[frame->_name] = map;
+            }
+            if (frame->_entryKey && frame->_entryValue) {
+                map[frame->_entryKey] = frame->_entryValue;
+            }
+            break;
+        }
+        case AWSXMLStreamingDeliveryMapKey:
+            parent->_entryKey = value;
+            break;
+        case AWSXMLStreamingDeliveryMapValue:
+            parent->_entryValue = value;
+            break;
+        case AWSXMLStreamingDeliveryNone:
+            break;
+    }
+}
+
+@end
@@ -17,6 +17,7 @@
 #import "AWSNetworking.h"
 #import "AWSCredentialsProvider.h"
 #import "AWSServiceEnum.h"
+#import "AWSSignature.h"
 
 //! SDK version for AWS Core
 FOUNDATION_EXPORT NSString *const AWSiOSSDKVersion;
@@ -95,6 +96,27 @@ typedef NS_ENUM(NSInteger, AWSServiceErrorType) {
 @property (nonatomic, readonly) NSString *userAgent;
 @property (nonatomic, readonly) BOOL localTestingEnabled;
 
+/**
+ How the payload of S3 requests is signed. The default is `AWSSignatureV4PayloadSigningModeSigned`.
+
+ `AWSSignatureV4PayloadSigningModeUnsigned` and `AWSSignatureV4PayloadSigningModeTrailingChecksum` skip the SHA-256
+ pass over the payload and rely on TLS, plus a CRC checksum for the latter, for its integrity.
+ */
+@property (nonatomic, assign) AWSSignatureV4PayloadSigningMode payloadSigningMode;
+
+/**
+ The checksum sent with the payload in `AWSSignatureV4PayloadSigningModeTrailingChecksum`. The default,
+ `AWSChecksumAlgorithmNone`, uses CRC32.
+ */
+@property (nonatomic, assign) AWSChecksumAlgorithm payloadChecksumAlgorithm;
+
+/**
+ Whether signed S3 payloads read from a file are hashed up front and signed with their SHA-256 instead of being sent
+ aws-chunked. The default is `NO`. This reads the file twice and delays the first byte of the upload until the whole
+ file is hashed.
+ */
+@property (nonatomic, assign, getter=isPayloadFileHashingEnabled) BOOL payloadFileHashingEnabled;
+
 + (NSString *)baseUserAgent;
 
 + (void)addGlobalUserAgentProductToken:(NSString *)productToken;
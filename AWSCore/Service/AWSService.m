@@ -236,6 +236,9 @@ static NSMutableArray *_globalUserAgentPrefixes = nil;
     configuration.userAgentProductTokens = self.userAgentProductTokens;
     configuration.endpoint = self.endpoint;
     configuration.localTestingEnabled = self.localTestingEnabled;
+    configuration.payloadSigningMode = self.payloadSigningMode;
+    configuration.payloadChecksumAlgorithm = self.payloadChecksumAlgorithm;
+    configuration.payloadFileHashingEnabled = self.payloadFileHashingEnabled;
     return configuration;
 }
 
@@ -0,0 +1,81 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import "AWSExecutor.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, AWSExecutorPriority) {
+    // Work the user is waiting for.
+    AWSExecutorPriorityInteractive,
+    AWSExecutorPriorityDefault,
+    // Transfers, uploads of recorded events and other work the user is not waiting for.
+    AWSExecutorPriorityBackground,
+};
+
+/**
+ Runs blocks on the global queues with at most `maxConcurrentCount` of them running at once. Blocks waiting for a slot
+ start in priority order, then in the order they were submitted, and background blocks never take more than
+ `maxBackgroundConcurrentCount` slots, so interactive work started during heavy background work does not wait behind it.
+
+ The executors of the lanes can be passed to `-[AWSTask continueWithExecutor:withBlock:]`. A block must not wait for
+ another block of the same executor, which may never get a slot.
+ */
+@interface AWSBoundedExecutor : NSObject
+
+/**
+ The number of blocks that can run at once.
+ */
+@property (nonatomic, readonly) NSUInteger maxConcurrentCount;
+
+/**
+ The number of background blocks that can run at once. The default is half of `maxConcurrentCount`, and at least 1.
+ */
+@property (nonatomic, assign) NSUInteger maxBackgroundConcurrentCount;
+
+/**
+ The number of blocks running.
+ */
+@property (nonatomic, readonly) NSUInteger runningCount;
+
+/**
+ The number of blocks waiting for a slot.
+ */
+@property (nonatomic, readonly) NSUInteger pendingCount;
+
+/**
+ Returns the executor shared by the SDK clients that opt into bounded concurrency. It runs up to twice as many blocks as
+ there are active processors.
+ */
++ (instancetype)sharedExecutor;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithMaxConcurrentCount:(NSUInteger)maxConcurrentCount NS_DESIGNATED_INITIALIZER;
+
+/**
+ Returns the executor of a lane, which runs its blocks concurrently within the limits of this executor.
+ */
+- (AWSExecutor *)executorWithPriority:(AWSExecutorPriority)priority;
+
+/**
+ Returns a new executor running its blocks one at a time, in the order they were submitted, in a lane of this executor.
+ */
+- (AWSExecutor *)serialExecutorWithPriority:(AWSExecutorPriority)priority;
+
+@end
+
+NS_ASSUME_NONNULL_END
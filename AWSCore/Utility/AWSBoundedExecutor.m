@@ -0,0 +1,231 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSBoundedExecutor.h"
+#import <pthread.h>
+
+static NSUInteger const AWSExecutorPriorityCount = AWSExecutorPriorityBackground + 1;
+
+// The blocks of a serial executor, submitted to the lane one at a time.
+@interface AWSBoundedExecutorSerialLane : NSObject
+
+@property (nonatomic, strong) AWSExecutor *executor;
+@property (nonatomic, strong) NSMutableArray<dispatch_block_t> *blocks;
+@property (nonatomic, assign) BOOL running;
+
+@end
+
+@implementation AWSBoundedExecutorSerialLane
+
+- (instancetype)initWithExecutor:(AWSExecutor *)executor {
+    if (self = [super init]) {
+        _executor = executor;
+        _blocks = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (void)submitBlock:(dispatch_block_t)block {
+    @synchronized(self) {
+        [self.blocks addObject:[block copy]];
+        if (self.running) {
+            return;
+        }
+        self.running = YES;
+    }
+    [self.executor execute:^{
+        [self runNextBlock];
+    }];
+}
+
+// Runs the first block, then submits the next one to the lane again, so that a long series of blocks does not hold a
+// slot while other blocks of the lane wait.
+- (void)runNextBlock {
+    dispatch_block_t block = nil;
+    @synchronized(self) {
+        block = [self.blocks firstObject];
+        [self.blocks removeObjectAtIndex:0];
+    }
+    block();
+
+    @synchronized(self) {
+        if ([self.blocks count] == 0) {
+            self.running = NO;
+            return;
+        }
+    }
+    [self.executor execute:^{
+        [self runNextBlock];
+    }];
+}
+
+@end
+
+@interface AWSBoundedExecutor() {
+    pthread_mutex_t _mutex;
+    // The pending blocks of each lane, in the order they were submitted.
+    NSMutableArray<dispatch_block_t> *_lanes[AWSExecutorPriorityCount];
+    NSUInteger _runningCount;
+    NSUInteger _runningBackgroundCount;
+}
+
+@end
+
+@implementation AWSBoundedExecutor
+
++ (instancetype)sharedExecutor {
+    static AWSBoundedExecutor *sharedExecutor = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedExecutor = [[AWSBoundedExecutor alloc] initWithMaxConcurrentCount:[NSProcessInfo processInfo].activeProcessorCount * 2];
+    });
+    return sharedExecutor;
+}
+
+- (instancetype)initWithMaxConcurrentCount:(NSUInteger)maxConcurrentCount {
+    if (self = [super init]) {
+        _maxConcurrentCount = MAX(maxConcurrentCount, 1);
+        _maxBackgroundConcurrentCount = MAX(_maxConcurrentCount / 2, 1);
+        pthread_mutex_init(&_mutex, NULL);
+        for (NSUInteger priority = 0; priority < AWSExecutorPriorityCount; priority++) {
+            _lanes[priority] = [NSMutableArray new];
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_mutex);
+}
+
+- (NSUInteger)maxBackgroundConcurrentCount {
+    pthread_mutex_lock(&_mutex);
+    NSUInteger maxBackgroundConcurrentCount = _maxBackgroundConcurrentCount;
+    pthread_mutex_unlock(&_mutex);
+    return maxBackgroundConcurrentCount;
+}
+
+- (void)setMaxBackgroundConcurrentCount:(NSUInteger)maxBackgroundConcurrentCount {
+    pthread_mutex_lock(&_mutex);
+    _maxBackgroundConcurrentCount = MAX(maxBackgroundConcurrentCount, 1);
+    pthread_mutex_unlock(&_mutex);
+    [self startPendingBlocks];
+}
+
+- (NSUInteger)runningCount {
+    pthread_mutex_lock(&_mutex);
+    NSUInteger runningCount = _runningCount;
+    pthread_mutex_unlock(&_mutex);
+    return runningCount;
+}
+
+- (NSUInteger)pendingCount {
+    pthread_mutex_lock(&_mutex);
+    NSUInteger pendingCount = 0;
+    for (NSUInteger priority = 0; priority < AWSExecutorPriorityCount; priority++) {
+        pendingCount += [_lanes[priority] count];
+    }
+    pthread_mutex_unlock(&_mutex);
+    return pendingCount;
+}
+
+- (AWSExecutor *)executorWithPriority:(AWSExecutorPriority)priority {
+    AWSExecutorPriority lane = [self laneForPriority:priority];
+    return [AWSExecutor executorWithBlock:^(void (^block)(void)) {
+        [self submitBlock:block priority:lane];
+    }];
+}
+
+- (AWSExecutor *)serialExecutorWithPriority:(AWSExecutorPriority)priority {
+    AWSBoundedExecutorSerialLane *serialLane = [[AWSBoundedExecutorSerialLane alloc] initWithExecutor:[self executorWithPriority:priority]];
+    return [AWSExecutor executorWithBlock:^(void (^block)(void)) {
+        [serialLane submitBlock:block];
+    }];
+}
+
+#pragma mark -
+
+- (AWSExecutorPriority)laneForPriority:(AWSExecutorPriority)priority {
+    if (priority < AWSExecutorPriorityInteractive || priority > AWSExecutorPriorityBackground) {
+        return AWSExecutorPriorityDefault;
+    }
+    return priority;
+}
+
+- (void)submitBlock:(dispatch_block_t)block priority:(AWSExecutorPriority)priority {
+    pthread_mutex_lock(&_mutex);
+    [_lanes[priority] addObject:[block copy]];
+    pthread_mutex_unlock(&_mutex);
+    [self startPendingBlocks];
+}
+
+- (void)startPendingBlocks {
+    while (YES) {
+        dispatch_block_t block = nil;
+        AWSExecutorPriority priority = AWSExecutorPriorityDefault;
+
+        pthread_mutex_lock(&_mutex);
+        if (_runningCount < _maxConcurrentCount) {
+            for (NSUInteger lane = 0; lane < AWSExecutorPriorityCount; lane++) {
+                if ([_lanes[lane] count] == 0
+                    || (lane == AWSExecutorPriorityBackground && _runningBackgroundCount >= _maxBackgroundConcurrentCount)) {
+                    continue;
+                }
+                priority = lane;
+                block = [_lanes[lane] firstObject];
+                [_lanes[lane] removeObjectAtIndex:0];
+                _runningCount++;
+                if (lane == AWSExecutorPriorityBackground) {
+                    _runningBackgroundCount++;
+                }
+                break;
+            }
+        }
+        pthread_mutex_unlock(&_mutex);
+
+        if (!block) {
+            return;
+        }
+        dispatch_async([self queueForPriority:priority], ^{
+            @autoreleasepool {
+                block();
+            }
+            [self finishBlockWithPriority:priority];
+        });
+    }
+}
+
+- (void)finishBlockWithPriority:(AWSExecutorPriority)priority {
+    pthread_mutex_lock(&_mutex);
+    _runningCount--;
+    if (priority == AWSExecutorPriorityBackground) {
+        _runningBackgroundCount--;
+    }
+    pthread_mutex_unlock(&_mutex);
+    [self startPendingBlocks];
+}
+
+- (dispatch_queue_t)queueForPriority:(AWSExecutorPriority)priority {
+    switch (priority) {
+        case AWSExecutorPriorityInteractive:
+            return dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+        case AWSExecutorPriorityBackground:
+            return dispatch_get_global_queue(QOS_CLASS_UTILITY, 0);
+        default:
+            return dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0);
+    }
+}
+
+@end
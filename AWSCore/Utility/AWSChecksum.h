@@ -0,0 +1,90 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, AWSChecksumAlgorithm) {
+    AWSChecksumAlgorithmNone,
+    AWSChecksumAlgorithmCRC32,
+    AWSChecksumAlgorithmCRC32C,
+    AWSChecksumAlgorithmCRC64NVME,
+};
+
+/**
+ Computes a checksum incrementally over data that is fed to it in pieces.
+
+ CRC32 and CRC32C use the CRC instructions of the CPU when it has them (ARMv8 CRC32 on devices, SSE4.2 for CRC32C in the
+ simulator). Everything else, including CRC64NVME, is computed eight bytes at a time with slicing-by-8 tables.
+ */
+@interface AWSChecksum : NSObject
+
+@property (nonatomic, assign, readonly) AWSChecksumAlgorithm algorithm;
+
+/**
+ Returns a checksum for `algorithm`, or `nil` for `AWSChecksumAlgorithmNone`.
+ */
++ (nullable instancetype)checksumWithAlgorithm:(AWSChecksumAlgorithm)algorithm;
+
+/**
+ The name of the S3 header carrying the checksum, e.g. `x-amz-checksum-crc32`.
+ */
++ (nullable NSString *)headerNameForAlgorithm:(AWSChecksumAlgorithm)algorithm;
+
+/**
+ Whether the checksum for `algorithm` is computed with CPU instructions on this device.
+ */
++ (BOOL)isHardwareAcceleratedForAlgorithm:(AWSChecksumAlgorithm)algorithm;
+
+/**
+ One-shot checksums of a buffer, e.g. for the prelude and message CRCs of event stream frames.
+ */
++ (uint32_t)CRC32ForBytes:(const void *)bytes length:(NSUInteger)length;
+
++ (uint32_t)CRC32CForBytes:(const void *)bytes length:(NSUInteger)length;
+
++ (uint64_t)CRC64NVMEForBytes:(const void *)bytes length:(NSUInteger)length;
+
+- (void)updateWithBytes:(const void *)bytes length:(NSUInteger)length;
+
+- (void)updateWithData:(NSData *)data;
+
+/**
+ Reads the file at `fileURL` through a fixed size buffer and updates the checksum with its contents.
+
+ @return `NO` and sets `error` when the file could not be read.
+ */
+- (BOOL)updateWithContentsOfURL:(NSURL *)fileURL
+                          error:(NSError *__autoreleasing *)error;
+
+/**
+ The checksum of the data seen so far. CRC32 and CRC32C values only use the low 32 bits.
+ */
+- (uint64_t)value;
+
+/**
+ The big-endian checksum of the data seen so far, 4 bytes for CRC32 and CRC32C and 8 bytes for CRC64NVME.
+ */
+- (NSData *)checksumData;
+
+/**
+ The base64 encoded checksum of the data seen so far, as S3 expects it in checksum headers and trailers.
+ */
+- (NSString *)base64EncodedChecksum;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,339 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSChecksum.h"
+#import <sys/sysctl.h>
+
+#if defined(__arm64__) || defined(__aarch64__)
+#import <arm_acle.h>
+#define AWS_CHECKSUM_ARM_CRC 1
+#elif defined(__x86_64__)
+#import <nmmintrin.h>
+#define AWS_CHECKSUM_SSE42 1
+#endif
+
+// Size of the buffer used to read files.
+static NSUInteger const AWSChecksumFileBufferSize = 1024 * 1024;
+
+// Reflected polynomials
+static uint32_t const AWSChecksumCRC32Polynomial = 0xEDB88320;
+static uint32_t const AWSChecksumCRC32CPolynomial = 0x82F63B78;
+static uint64_t const AWSChecksumCRC64NVMEPolynomial = 0x9A6C9329AC4BC9B5;
+
+// Slicing-by-8 tables: table[0] is the usual byte-wise table, table[k] advances a byte by k more zero bytes.
+static uint32_t AWSChecksumCRC32Tables[8][256];
+static uint32_t AWSChecksumCRC32CTables[8][256];
+static uint64_t AWSChecksumCRC64NVMETables[8][256];
+
+static BOOL AWSChecksumCRC32Hardware = NO;
+static BOOL AWSChecksumCRC32CHardware = NO;
+
+static void AWSChecksumInitializeTables32(uint32_t tables[8][256], uint32_t polynomial) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ ((crc & 1) ? polynomial : 0);
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int k = 1; k < 8; k++) {
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+        }
+    }
+}
+
+static void AWSChecksumInitializeTables64(uint64_t tables[8][256], uint64_t polynomial) {
+    for (uint64_t i = 0; i < 256; i++) {
+        uint64_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ ((crc & 1) ? polynomial : 0);
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int k = 1; k < 8; k++) {
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+        }
+    }
+}
+
+static inline uint32_t AWSChecksumLoad32(const uint8_t *bytes) {
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return CFSwapInt32LittleToHost(value);
+}
+
+static inline uint64_t AWSChecksumLoad64(const uint8_t *bytes) {
+    uint64_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return CFSwapInt64LittleToHost(value);
+}
+
+static uint32_t AWSChecksumUpdateCRC32Sliced(const uint32_t tables[8][256], uint32_t crc, const uint8_t *bytes, size_t length) {
+    crc = ~crc;
+    while (length >= 8) {
+        uint32_t low = AWSChecksumLoad32(bytes) ^ crc;
+        uint32_t high = AWSChecksumLoad32(bytes + 4);
+        crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24]
+            ^ tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+        bytes += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = tables[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static uint64_t AWSChecksumUpdateCRC64Sliced(const uint64_t tables[8][256], uint64_t crc, const uint8_t *bytes, size_t length) {
+    crc = ~crc;
+    while (length >= 8) {
+        crc ^= AWSChecksumLoad64(bytes);
+        crc = tables[7][crc & 0xFF] ^ tables[6][(crc >> 8) & 0xFF] ^ tables[5][(crc >> 16) & 0xFF] ^ tables[4][(crc >> 24) & 0xFF]
+            ^ tables[3][(crc >> 32) & 0xFF] ^ tables[2][(crc >> 40) & 0xFF] ^ tables[1][(crc >> 48) & 0xFF] ^ tables[0][crc >> 56];
+        bytes += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = tables[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+#if AWS_CHECKSUM_ARM_CRC
+
+// Not every ARMv8 core has the CRC32 extension, so these are compiled for it explicitly and only called after the
+// feature was detected at runtime.
+__attribute__((target("crc")))
+static uint32_t AWSChecksumUpdateCRC32Hardware(uint32_t crc, const uint8_t *bytes, size_t length) {
+    crc = ~crc;
+    while (length >= 8) {
+        crc = __crc32d(crc, AWSChecksumLoad64(bytes));
+        bytes += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = __crc32b(crc, *bytes++);
+    }
+    return ~crc;
+}
+
+__attribute__((target("crc")))
+static uint32_t AWSChecksumUpdateCRC32CHardware(uint32_t crc, const uint8_t *bytes, size_t length) {
+    crc = ~crc;
+    while (length >= 8) {
+        crc = __crc32cd(crc, AWSChecksumLoad64(bytes));
+        bytes += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = __crc32cb(crc, *bytes++);
+    }
+    return ~crc;
+}
+
+#elif AWS_CHECKSUM_SSE42
+
+// SSE4.2 only has an instruction for the Castagnoli polynomial.
+__attribute__((target("sse4.2")))
+static uint32_t AWSChecksumUpdateCRC32CHardware(uint32_t crc, const uint8_t *bytes, size_t length) {
+    uint64_t crc64 = ~crc;
+    while (length >= 8) {
+        crc64 = _mm_crc32_u64(crc64, AWSChecksumLoad64(bytes));
+        bytes += 8;
+        length -= 8;
+    }
+    crc = (uint32_t)crc64;
+    while (length-- > 0) {
+        crc = _mm_crc32_u8(crc, *bytes++);
+    }
+    return ~crc;
+}
+
+#endif
+
+#if AWS_CHECKSUM_ARM_CRC || AWS_CHECKSUM_SSE42
+static BOOL AWSChecksumHasCPUFeature(const char *name) {
+    int value = 0;
+    size_t size = sizeof(value);
+    return sysctlbyname(name, &value, &size, NULL, 0) == 0 && value != 0;
+}
+#endif
+
+static uint32_t AWSChecksumUpdateCRC32(uint32_t crc, const uint8_t *bytes, size_t length, BOOL hardware) {
+#if AWS_CHECKSUM_ARM_CRC
+    if (hardware) {
+        return AWSChecksumUpdateCRC32Hardware(crc, bytes, length);
+    }
+#endif
+    return AWSChecksumUpdateCRC32Sliced(AWSChecksumCRC32Tables, crc, bytes, length);
+}
+
+static uint32_t AWSChecksumUpdateCRC32C(uint32_t crc, const uint8_t *bytes, size_t length, BOOL hardware) {
+#if AWS_CHECKSUM_ARM_CRC || AWS_CHECKSUM_SSE42
+    if (hardware) {
+        return AWSChecksumUpdateCRC32CHardware(crc, bytes, length);
+    }
+#endif
+    return AWSChecksumUpdateCRC32Sliced(AWSChecksumCRC32CTables, crc, bytes, length);
+}
+
+@implementation AWSChecksum {
+    uint64_t _crc;
+    BOOL _hardwareAccelerated;
+}
+
++ (void)initialize {
+    if (self == [AWSChecksum class]) {
+        AWSChecksumInitializeTables32(AWSChecksumCRC32Tables, AWSChecksumCRC32Polynomial);
+        AWSChecksumInitializeTables32(AWSChecksumCRC32CTables, AWSChecksumCRC32CPolynomial);
+        AWSChecksumInitializeTables64(AWSChecksumCRC64NVMETables, AWSChecksumCRC64NVMEPolynomial);
+#if AWS_CHECKSUM_ARM_CRC
+        AWSChecksumCRC32Hardware = AWSChecksumHasCPUFeature("hw.optional.armv8_crc32");
+        AWSChecksumCRC32CHardware = AWSChecksumCRC32Hardware;
+#elif AWS_CHECKSUM_SSE42
+        AWSChecksumCRC32CHardware = AWSChecksumHasCPUFeature("hw.optional.sse4_2");
+#endif
+    }
+}
+
++ (instancetype)checksumWithAlgorithm:(AWSChecksumAlgorithm)algorithm {
+    return [[self alloc] initWithAlgorithm:algorithm
+                       hardwareAccelerated:[self isHardwareAcceleratedForAlgorithm:algorithm]];
+}
+
++ (NSString *)headerNameForAlgorithm:(AWSChecksumAlgorithm)algorithm {
+    switch (algorithm) {
+        case AWSChecksumAlgorithmCRC32:
+            return @"x-amz-checksum-crc32";
+        case AWSChecksumAlgorithmCRC32C:
+            return @"x-amz-checksum-crc32c";
+        case AWSChecksumAlgorithmCRC64NVME:
+            return @"x-amz-checksum-crc64nvme";
+        default:
+            return nil;
+    }
+}
+
++ (BOOL)isHardwareAcceleratedForAlgorithm:(AWSChecksumAlgorithm)algorithm {
+    switch (algorithm) {
+        case AWSChecksumAlgorithmCRC32:
+            return AWSChecksumCRC32Hardware;
+        case AWSChecksumAlgorithmCRC32C:
+            return AWSChecksumCRC32CHardware;
+        default:
+            return NO;
+    }
+}
+
++ (uint32_t)CRC32ForBytes:(const void *)bytes length:(NSUInteger)length {
+    return AWSChecksumUpdateCRC32(0, bytes, length, AWSChecksumCRC32Hardware);
+}
+
++ (uint32_t)CRC32CForBytes:(const void *)bytes length:(NSUInteger)length {
+    return AWSChecksumUpdateCRC32C(0, bytes, length, AWSChecksumCRC32CHardware);
+}
+
++ (uint64_t)CRC64NVMEForBytes:(const void *)bytes length:(NSUInteger)length {
+    return AWSChecksumUpdateCRC64Sliced(AWSChecksumCRC64NVMETables, 0, bytes, length);
+}
+
+- (instancetype)initWithAlgorithm:(AWSChecksumAlgorithm)algorithm
+              hardwareAccelerated:(BOOL)hardwareAccelerated {
+    switch (algorithm) {
+        case AWSChecksumAlgorithmCRC32:
+        case AWSChecksumAlgorithmCRC32C:
+        case AWSChecksumAlgorithmCRC64NVME:
+            break;
+        default:
+            return nil;
+    }
+    if (self = [super init]) {
+        _algorithm = algorithm;
+        _hardwareAccelerated = hardwareAccelerated && [AWSChecksum isHardwareAcceleratedForAlgorithm:algorithm];
+    }
+    return self;
+}
+
+- (void)updateWithBytes:(const void *)bytes length:(NSUInteger)length {
+    switch (_algorithm) {
+        case AWSChecksumAlgorithmCRC32:
+            _crc = AWSChecksumUpdateCRC32((uint32_t)_crc, bytes, length, _hardwareAccelerated);
+            break;
+        case AWSChecksumAlgorithmCRC32C:
+            _crc = AWSChecksumUpdateCRC32C((uint32_t)_crc, bytes, length, _hardwareAccelerated);
+            break;
+        case AWSChecksumAlgorithmCRC64NVME:
+            _crc = AWSChecksumUpdateCRC64Sliced(AWSChecksumCRC64NVMETables, _crc, bytes, length);
+            break;
+        default:
+            break;
+    }
+}
+
+- (void)updateWithData:(NSData *)data {
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        [self updateWithBytes:bytes length:byteRange.length];
+    }];
+}
+
+- (BOOL)updateWithContentsOfURL:(NSURL *)fileURL
+                          error:(NSError *__autoreleasing *)error {
+    NSInputStream *stream = [NSInputStream inputStreamWithURL:fileURL];
+    uint8_t *buffer = malloc(AWSChecksumFileBufferSize);
+    if (buffer == NULL) {
+        [NSException raise:@"NSInternalInconsistencyException" format:@"failed malloc" arguments:nil];
+        return NO;
+    }
+
+    NSInteger read = 0;
+    [stream open];
+    while ((read = [stream read:buffer maxLength:AWSChecksumFileBufferSize]) > 0) {
+        [self updateWithBytes:buffer length:read];
+    }
+    NSError *streamError = [stream streamError];
+    [stream close];
+    free(buffer);
+
+    if (read < 0 || !stream) {
+        if (error) {
+            *error = streamError ?: [NSError errorWithDomain:NSCocoaErrorDomain
+                                                        code:NSFileReadUnknownError
+                                                    userInfo:@{NSURLErrorKey : fileURL}];
+        }
+        return NO;
+    }
+    return YES;
+}
+
+- (uint64_t)value {
+    return _crc;
+}
+
+- (NSData *)checksumData {
+    if (_algorithm == AWSChecksumAlgorithmCRC64NVME) {
+        uint64_t bigEndian = CFSwapInt64HostToBig(_crc);
+        return [NSData dataWithBytes:&bigEndian length:sizeof(bigEndian)];
+    }
+    uint32_t bigEndian = CFSwapInt32HostToBig((uint32_t)_crc);
+    return [NSData dataWithBytes:&bigEndian length:sizeof(bigEndian)];
+}
+
+- (NSString *)base64EncodedChecksum {
+    return [[self checksumData] base64EncodedStringWithOptions:0];
+}
+
+@end
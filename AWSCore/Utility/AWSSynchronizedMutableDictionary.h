@@ -15,6 +15,10 @@
 
 #import <Foundation/Foundation.h>
 
+/**
+ A thread safe mutable dictionary. Keys are spread over independently locked shards, so lookups of different keys from
+ concurrent threads (e.g. the delegate callbacks of concurrent URL session tasks) rarely wait for each other.
+ */
 @interface AWSSynchronizedMutableDictionary : NSObject
 
 - (id)objectForKey:(id)aKey;
@@ -22,5 +26,7 @@
 - (void)removeObject:(id)object;
 - (void)setObject:(id)anObject forKey:(id <NSCopying>)aKey;
 - (NSArray *)allKeys;
+- (NSArray *)allValues;
+- (NSUInteger)count;
 
 @end
@@ -14,11 +14,25 @@
 //
 
 #import "AWSSynchronizedMutableDictionary.h"
+#import <pthread.h>
+#import <stdlib.h>
 
-@interface AWSSynchronizedMutableDictionary()
+// Keys are spread over independently locked shards, so callers working on different keys rarely wait for each other.
+#define AWSSynchronizedMutableDictionaryShardCount 16
 
-@property (nonatomic, strong) NSMutableDictionary *dictionary;
-@property (nonatomic, strong) dispatch_queue_t dispatchQueue;
+// Cache lines are 128 bytes on Apple silicon.
+#define AWSSynchronizedMutableDictionaryCacheLineSize 128
+
+// Shards are padded to a cache line and allocated on a cache line boundary, outside of the object, which is only 16
+// byte aligned. Locking one shard then does not invalidate its neighbours.
+typedef struct {
+    pthread_mutex_t lock;
+    CFMutableDictionaryRef dictionary;
+} __attribute__((aligned(AWSSynchronizedMutableDictionaryCacheLineSize))) AWSSynchronizedMutableDictionaryShard;
+
+@interface AWSSynchronizedMutableDictionary() {
+    AWSSynchronizedMutableDictionaryShard *_shards;
+}
 
 @end
 
@@ -26,52 +40,116 @@
 
 - (instancetype)init {
     if (self = [super init]) {
-        _dictionary = [NSMutableDictionary new];
-        _dispatchQueue = dispatch_queue_create("com.amazonaws.AWSSynchronizedMutableDictionary", DISPATCH_QUEUE_SERIAL);
+        if (posix_memalign((void **)&_shards,
+                           AWSSynchronizedMutableDictionaryCacheLineSize,
+                           sizeof(AWSSynchronizedMutableDictionaryShard) * AWSSynchronizedMutableDictionaryShardCount) != 0) {
+            [NSException raise:@"NSInternalInconsistencyException" format:@"failed posix_memalign" arguments:nil];
+        }
+        for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryShardCount; i++) {
+            pthread_mutex_init(&_shards[i].lock, NULL);
+            _shards[i].dictionary = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+        }
     }
 
     return self;
 }
 
-- (id)objectForKey:(id)aKey {
-    __block id returnObject = nil;
+- (void)dealloc {
+    for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryShardCount; i++) {
+        pthread_mutex_destroy(&_shards[i].lock);
+        CFRelease(_shards[i].dictionary);
+    }
+    free(_shards);
+}
+
+- (AWSSynchronizedMutableDictionaryShard *)shardForKey:(id)aKey {
+    // Task identifiers and other small integers hash to consecutive values, mix the bits before picking a shard.
+    uint64_t hash = (uint64_t)[aKey hash] * 0x9E3779B97F4A7C15ULL;
+    return &_shards[hash >> 60];
+}
 
-    dispatch_sync(self.dispatchQueue, ^{
-        returnObject = [self.dictionary objectForKey:aKey];
-    });
+- (id)objectForKey:(id)aKey {
+    if (!aKey) {
+        return nil;
+    }
+    AWSSynchronizedMutableDictionaryShard *shard = [self shardForKey:aKey];
+    pthread_mutex_lock(&shard->lock);
+    // Retained by the strong local before the lock is released.
+    id returnObject = (__bridge id)CFDictionaryGetValue(shard->dictionary, (__bridge const void *)aKey);
+    pthread_mutex_unlock(&shard->lock);
 
     return returnObject;
 }
 
 - (void)removeObjectForKey:(id)aKey {
-    dispatch_sync(self.dispatchQueue, ^{
-        [self.dictionary removeObjectForKey:aKey];
-    });
+    if (!aKey) {
+        return;
+    }
+    AWSSynchronizedMutableDictionaryShard *shard = [self shardForKey:aKey];
+    pthread_mutex_lock(&shard->lock);
+    CFDictionaryRemoveValue(shard->dictionary, (__bridge const void *)aKey);
+    pthread_mutex_unlock(&shard->lock);
 }
 
 - (void)setObject:(id)anObject forKey:(id <NSCopying>)aKey {
-    dispatch_sync(self.dispatchQueue, ^{
-        [self.dictionary setObject:anObject forKey:aKey];
-    });
+    if (!anObject || !aKey) {
+        [NSException raise:NSInvalidArgumentException format:@"Attempt to insert nil object or key"];
+    }
+    // Keys are copied, as NSMutableDictionary does, and outside of the lock.
+    id key = [(id)aKey copyWithZone:nil];
+    AWSSynchronizedMutableDictionaryShard *shard = [self shardForKey:key];
+    pthread_mutex_lock(&shard->lock);
+    CFDictionarySetValue(shard->dictionary, (__bridge const void *)key, (__bridge const void *)anObject);
+    pthread_mutex_unlock(&shard->lock);
 }
 
 - (NSArray *)allKeys {
-    __block NSArray *allKeys = nil;
-    dispatch_sync(self.dispatchQueue, ^{
-        allKeys = [self.dictionary allKeys];
-    });
+    NSMutableArray *allKeys = [NSMutableArray new];
+    for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryShardCount; i++) {
+        pthread_mutex_lock(&_shards[i].lock);
+        [allKeys addObjectsFromArray:[(__bridge NSDictionary *)_shards[i].dictionary allKeys]];
+        pthread_mutex_unlock(&_shards[i].lock);
+    }
     return allKeys;
 }
 
+- (NSArray *)allValues {
+    NSMutableArray *allValues = [NSMutableArray new];
+    for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryShardCount; i++) {
+        pthread_mutex_lock(&_shards[i].lock);
+        [allValues addObjectsFromArray:[(__bridge NSDictionary *)_shards[i].dictionary allValues]];
+        pthread_mutex_unlock(&_shards[i].lock);
+    }
+    return allValues;
+}
+
+- (NSUInteger)count {
+    NSUInteger count = 0;
+    for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryShardCount; i++) {
+        pthread_mutex_lock(&_shards[i].lock);
+        count += CFDictionaryGetCount(_shards[i].dictionary);
+        pthread_mutex_unlock(&_shards[i].lock);
+    }
+    return count;
+}
+
 - (void)removeObject:(id)object {
-    dispatch_sync(self.dispatchQueue, ^{
-        for (NSString *key in self.dictionary) {
-            if (object == self.dictionary[key]) {
-                [self.dictionary removeObjectForKey:key];
+    for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryShardCount; i++) {
+        BOOL removed = NO;
+        pthread_mutex_lock(&_shards[i].lock);
+        NSDictionary *dictionary = (__bridge NSDictionary *)_shards[i].dictionary;
+        for (id key in dictionary) {
+            if (object == dictionary[key]) {
+                CFDictionaryRemoveValue(_shards[i].dictionary, (__bridge const void *)key);
+                removed = YES;
                 break;
             }
         }
-    });
+        pthread_mutex_unlock(&_shards[i].lock);
+        if (removed) {
+            break;
+        }
+    }
 }
 
 @end
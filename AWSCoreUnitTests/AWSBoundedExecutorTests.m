@@ -0,0 +1,211 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <stdatomic.h>
+#import "AWSCore.h"
+
+@interface AWSBoundedExecutorTests : XCTestCase
+
+@end
+
+@implementation AWSBoundedExecutorTests
+
+// Runs `count` blocks sleeping for `duration` in `executor` and returns the highest number of them running at once.
+- (NSInteger)maxConcurrentBlocksOf:(NSUInteger)count
+                          duration:(useconds_t)duration
+                        inExecutor:(AWSExecutor *)executor {
+    __block atomic_int running = 0;
+    __block atomic_int maxRunning = 0;
+    dispatch_group_t group = dispatch_group_create();
+    for (NSUInteger i = 0; i < count; i++) {
+        dispatch_group_enter(group);
+        [executor execute:^{
+            int current = atomic_fetch_add(&running, 1) + 1;
+            int observed = atomic_load(&maxRunning);
+            while (current > observed
+                   && !atomic_compare_exchange_weak(&maxRunning, &observed, current)) {
+            }
+            usleep(duration);
+            atomic_fetch_sub(&running, 1);
+            dispatch_group_leave(group);
+        }];
+    }
+    XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 30 * NSEC_PER_SEC)), 0);
+    return atomic_load(&maxRunning);
+}
+
+- (void)testDefaultBackgroundCount {
+    XCTAssertEqual([[AWSBoundedExecutor alloc] initWithMaxConcurrentCount:8].maxBackgroundConcurrentCount, 4);
+    XCTAssertEqual([[AWSBoundedExecutor alloc] initWithMaxConcurrentCount:1].maxBackgroundConcurrentCount, 1);
+    XCTAssertGreaterThanOrEqual([AWSBoundedExecutor sharedExecutor].maxConcurrentCount, 2);
+    XCTAssertEqual([AWSBoundedExecutor sharedExecutor], [AWSBoundedExecutor sharedExecutor]);
+}
+
+- (void)testConcurrencyLimit {
+    AWSBoundedExecutor *boundedExecutor = [[AWSBoundedExecutor alloc] initWithMaxConcurrentCount:3];
+    NSInteger maxRunning = [self maxConcurrentBlocksOf:30
+                                              duration:5000
+                                            inExecutor:[boundedExecutor executorWithPriority:AWSExecutorPriorityDefault]];
+    XCTAssertLessThanOrEqual(maxRunning, 3);
+    XCTAssertGreaterThan(maxRunning, 1);
+    XCTAssertEqual(boundedExecutor.runningCount, 0);
+    XCTAssertEqual(boundedExecutor.pendingCount, 0);
+}
+
+- (void)testBackgroundLimit {
+    AWSBoundedExecutor *boundedExecutor = [[AWSBoundedExecutor alloc] initWithMaxConcurrentCount:4];
+    boundedExecutor.maxBackgroundConcurrentCount = 2;
+    AWSExecutor *backgroundExecutor = [boundedExecutor executorWithPriority:AWSExecutorPriorityBackground];
+
+    // Interactive blocks still get a slot while the background lane is full.
+    XCTestExpectation *expectation = [self expectationWithDescription:@"interactive"];
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        usleep(20000);
+        [[boundedExecutor executorWithPriority:AWSExecutorPriorityInteractive] execute:^{
+            [expectation fulfill];
+        }];
+    });
+    NSInteger maxRunning = [self maxConcurrentBlocksOf:40 duration:5000 inExecutor:backgroundExecutor];
+    XCTAssertLessThanOrEqual(maxRunning, 2);
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testPriorityOrder {
+    AWSBoundedExecutor *boundedExecutor = [[AWSBoundedExecutor alloc] initWithMaxConcurrentCount:1];
+    dispatch_semaphore_t blocked = dispatch_semaphore_create(0);
+    dispatch_semaphore_t started = dispatch_semaphore_create(0);
+    [[boundedExecutor executorWithPriority:AWSExecutorPriorityDefault] execute:^{
+        dispatch_semaphore_signal(started);
+        dispatch_semaphore_wait(blocked, DISPATCH_TIME_FOREVER);
+    }];
+    dispatch_semaphore_wait(started, DISPATCH_TIME_FOREVER);
+
+    NSMutableArray *order = [NSMutableArray new];
+    dispatch_group_t group = dispatch_group_create();
+    NSArray *priorities = @[@(AWSExecutorPriorityBackground), @(AWSExecutorPriorityDefault), @(AWSExecutorPriorityInteractive),
+                            @(AWSExecutorPriorityBackground), @(AWSExecutorPriorityInteractive)];
+    [priorities enumerateObjectsUsingBlock:^(NSNumber *priority, NSUInteger index, BOOL *stop) {
+        dispatch_group_enter(group);
+        [[boundedExecutor executorWithPriority:[priority integerValue]] execute:^{
+            @synchronized(order) {
+                [order addObject:@(index)];
+            }
+            dispatch_group_leave(group);
+        }];
+    }];
+    XCTAssertEqual(boundedExecutor.pendingCount, 5);
+
+    dispatch_semaphore_signal(blocked);
+    XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC)), 0);
+    NSArray *expected = @[@2, @4, @1, @0, @3];
+    XCTAssertEqualObjects(order, expected);
+}
+
+- (void)testSerialExecutor {
+    AWSBoundedExecutor *boundedExecutor = [[AWSBoundedExecutor alloc] initWithMaxConcurrentCount:4];
+    AWSExecutor *serialExecutor = [boundedExecutor serialExecutorWithPriority:AWSExecutorPriorityBackground];
+    XCTAssertEqual([self maxConcurrentBlocksOf:20 duration:1000 inExecutor:serialExecutor], 1);
+
+    NSMutableArray *order = [NSMutableArray new];
+    dispatch_group_t group = dispatch_group_create();
+    for (NSUInteger i = 0; i < 100; i++) {
+        dispatch_group_enter(group);
+        [serialExecutor execute:^{
+            [order addObject:@(i)];
+            dispatch_group_leave(group);
+        }];
+    }
+    XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC)), 0);
+    XCTAssertEqual([order count], 100);
+    for (NSUInteger i = 0; i < [order count]; i++) {
+        XCTAssertEqualObjects(order[i], @(i));
+    }
+}
+
+- (void)testTaskContinuations {
+    AWSBoundedExecutor *boundedExecutor = [[AWSBoundedExecutor alloc] initWithMaxConcurrentCount:2];
+    AWSTask *task = [[AWSTask taskFromExecutor:[boundedExecutor executorWithPriority:AWSExecutorPriorityBackground] withBlock:^id _Nullable{
+        return @1;
+    }] continueWithExecutor:[boundedExecutor executorWithPriority:AWSExecutorPriorityInteractive] withSuccessBlock:^id _Nullable(AWSTask *t) {
+        return @([t.result integerValue] + 1);
+    }];
+    [task waitUntilFinished];
+    XCTAssertEqualObjects(task.result, @2);
+}
+
+#pragma mark - Benchmark
+
+/**
+ Measures how long interactive blocks wait to start while a flood of background blocks, standing in for part uploads
+ and recorder submissions, is queued. Returns the latencies in milliseconds, sorted.
+ */
+- (NSArray<NSNumber *> *)interactiveLatenciesWithBackground:(void (^)(dispatch_block_t block))background
+                                                interactive:(void (^)(dispatch_block_t block))interactive {
+    NSUInteger const backgroundCount = 2000;
+    NSUInteger const interactiveCount = 200;
+
+    dispatch_group_t group = dispatch_group_create();
+    for (NSUInteger i = 0; i < backgroundCount; i++) {
+        dispatch_group_enter(group);
+        background(^{
+            usleep(2000);
+            dispatch_group_leave(group);
+        });
+    }
+
+    NSMutableArray<NSNumber *> *latencies = [NSMutableArray new];
+    for (NSUInteger i = 0; i < interactiveCount; i++) {
+        CFAbsoluteTime submitted = CFAbsoluteTimeGetCurrent();
+        dispatch_group_enter(group);
+        interactive(^{
+            CFAbsoluteTime latency = CFAbsoluteTimeGetCurrent() - submitted;
+            @synchronized(latencies) {
+                [latencies addObject:@(latency * 1000)];
+            }
+            dispatch_group_leave(group);
+        });
+        usleep(1000);
+    }
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    return [latencies sortedArrayUsingSelector:@selector(compare:)];
+}
+
+- (void)testInteractiveLatencyBenchmark {
+    dispatch_queue_t globalQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    NSArray<NSNumber *> *global = [self interactiveLatenciesWithBackground:^(dispatch_block_t block) {
+        dispatch_async(globalQueue, block);
+    } interactive:^(dispatch_block_t block) {
+        dispatch_async(globalQueue, block);
+    }];
+
+    AWSBoundedExecutor *boundedExecutor = [[AWSBoundedExecutor alloc] initWithMaxConcurrentCount:[AWSBoundedExecutor sharedExecutor].maxConcurrentCount];
+    AWSExecutor *backgroundExecutor = [boundedExecutor executorWithPriority:AWSExecutorPriorityBackground];
+    AWSExecutor *interactiveExecutor = [boundedExecutor executorWithPriority:AWSExecutorPriorityInteractive];
+    NSArray<NSNumber *> *bounded = [self interactiveLatenciesWithBackground:^(dispatch_block_t block) {
+        [backgroundExecutor execute:block];
+    } interactive:^(dispatch_block_t block) {
+        [interactiveExecutor execute:block];
+    }];
+
+    NSUInteger p50 = [global count] / 2;
+    NSUInteger p99 = [global count] * 99 / 100;
+    NSLog(@"Interactive latency under background load: global queue p50 %.2f ms p99 %.2f ms, bounded executor p50 %.2f ms p99 %.2f ms",
+          [global[p50] doubleValue], [global[p99] doubleValue],
+          [bounded[p50] doubleValue], [bounded[p99] doubleValue]);
+    XCTAssertLessThan([bounded[p99] doubleValue], 100);
+}
+
+@end
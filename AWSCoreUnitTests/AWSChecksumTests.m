@@ -0,0 +1,185 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+#import <sys/sysctl.h>
+
+static NSUInteger const AWSChecksumTestsBenchmarkLength = 64 * 1024 * 1024;
+
+@interface AWSChecksum()
+
+- (instancetype)initWithAlgorithm:(AWSChecksumAlgorithm)algorithm
+              hardwareAccelerated:(BOOL)hardwareAccelerated;
+
+@end
+
+@interface AWSChecksumTests : XCTestCase
+
+@end
+
+@implementation AWSChecksumTests
+
+- (uint32_t)checksumValue:(AWSChecksum *)checksum {
+    uint32_t value = 0;
+    [[checksum checksumData] getBytes:&value length:sizeof(value)];
+    return CFSwapInt32BigToHost(value);
+}
+
+- (void)testCheckValues {
+    NSData *data = [@"123456789" dataUsingEncoding:NSUTF8StringEncoding];
+
+    AWSChecksum *crc32 = [AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmCRC32];
+    [crc32 updateWithData:data];
+    XCTAssertEqual([self checksumValue:crc32], 0xCBF43926);
+    XCTAssertEqualObjects([crc32 base64EncodedChecksum], @"y/Q5Jg==");
+
+    AWSChecksum *crc32c = [AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmCRC32C];
+    [crc32c updateWithData:data];
+    XCTAssertEqual([self checksumValue:crc32c], 0xE3069283);
+
+    AWSChecksum *crc64 = [AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmCRC64NVME];
+    [crc64 updateWithData:data];
+    XCTAssertEqual([crc64 value], 0xAE8B14860A799888ULL);
+    XCTAssertEqual([[crc64 checksumData] length], 8);
+    XCTAssertEqualObjects([crc64 base64EncodedChecksum], @"rosUhgp5mIg=");
+
+    XCTAssertEqual([AWSChecksum CRC32ForBytes:[data bytes] length:[data length]], 0xCBF43926);
+    XCTAssertEqual([AWSChecksum CRC32CForBytes:[data bytes] length:[data length]], 0xE3069283);
+    XCTAssertEqual([AWSChecksum CRC64NVMEForBytes:[data bytes] length:[data length]], 0xAE8B14860A799888ULL);
+    XCTAssertEqual([AWSChecksum CRC32ForBytes:NULL length:0], 0);
+
+    XCTAssertNil([AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmNone]);
+    XCTAssertEqualObjects([AWSChecksum headerNameForAlgorithm:AWSChecksumAlgorithmCRC32C], @"x-amz-checksum-crc32c");
+    XCTAssertEqualObjects([AWSChecksum headerNameForAlgorithm:AWSChecksumAlgorithmCRC64NVME], @"x-amz-checksum-crc64nvme");
+}
+
+- (void)testHardwareMatchesSlicingByEight {
+    NSMutableData *data = [NSMutableData dataWithLength:4099];
+    for (NSUInteger i = 0; i < [data length]; i++) {
+        ((uint8_t *)[data mutableBytes])[i] = (uint8_t)(i * 131 + 7);
+    }
+    for (NSNumber *algorithm in @[@(AWSChecksumAlgorithmCRC32), @(AWSChecksumAlgorithmCRC32C), @(AWSChecksumAlgorithmCRC64NVME)]) {
+        // Every length around the 8 byte stride, starting at unaligned offsets.
+        for (NSUInteger offset = 0; offset < 8; offset++) {
+            for (NSUInteger length = 0; length < 40; length++) {
+                AWSChecksum *hardware = [[AWSChecksum alloc] initWithAlgorithm:[algorithm integerValue] hardwareAccelerated:YES];
+                AWSChecksum *software = [[AWSChecksum alloc] initWithAlgorithm:[algorithm integerValue] hardwareAccelerated:NO];
+                [hardware updateWithBytes:(const uint8_t *)[data bytes] + offset length:length];
+                [software updateWithBytes:(const uint8_t *)[data bytes] + offset length:length];
+                XCTAssertEqual([hardware value], [software value]);
+            }
+        }
+        AWSChecksum *hardware = [[AWSChecksum alloc] initWithAlgorithm:[algorithm integerValue] hardwareAccelerated:YES];
+        AWSChecksum *software = [[AWSChecksum alloc] initWithAlgorithm:[algorithm integerValue] hardwareAccelerated:NO];
+        [hardware updateWithData:data];
+        [software updateWithData:data];
+        XCTAssertEqualObjects([hardware checksumData], [software checksumData]);
+    }
+}
+
+- (void)testIncrementalUpdatesMatchSingleUpdate {
+    NSMutableData *data = [NSMutableData dataWithLength:100000];
+    for (NSUInteger i = 0; i < [data length]; i++) {
+        ((uint8_t *)[data mutableBytes])[i] = (uint8_t)(i * 31);
+    }
+    for (NSNumber *algorithm in @[@(AWSChecksumAlgorithmCRC32), @(AWSChecksumAlgorithmCRC32C), @(AWSChecksumAlgorithmCRC64NVME)]) {
+        AWSChecksum *whole = [AWSChecksum checksumWithAlgorithm:[algorithm integerValue]];
+        [whole updateWithData:data];
+
+        AWSChecksum *pieces = [AWSChecksum checksumWithAlgorithm:[algorithm integerValue]];
+        NSUInteger offset = 0;
+        NSUInteger length = 1;
+        while (offset < [data length]) {
+            NSUInteger pieceLength = MIN(length, [data length] - offset);
+            [pieces updateWithBytes:(const uint8_t *)[data bytes] + offset length:pieceLength];
+            offset += pieceLength;
+            length = length * 3 + 1;
+        }
+        XCTAssertEqualObjects([pieces checksumData], [whole checksumData]);
+    }
+}
+
+- (void)testFileChecksum {
+    NSData *data = [@"123456789" dataUsingEncoding:NSUTF8StringEncoding];
+    NSURL *fileURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [data writeToURL:fileURL atomically:YES];
+
+    AWSChecksum *checksum = [AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmCRC32];
+    NSError *error = nil;
+    XCTAssertTrue([checksum updateWithContentsOfURL:fileURL error:&error]);
+    XCTAssertNil(error);
+    XCTAssertEqual([self checksumValue:checksum], 0xCBF43926);
+    [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+
+    XCTAssertFalse([[AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmCRC32] updateWithContentsOfURL:fileURL error:&error]);
+    XCTAssertNotNil(error);
+}
+
+#pragma mark - Benchmarks
+
+- (void)testThroughput {
+    NSMutableData *data = [NSMutableData dataWithLength:AWSChecksumTestsBenchmarkLength];
+    arc4random_buf([data mutableBytes], [data length]);
+
+    // Only reported where the kernel exposes the nominal CPU frequency, e.g. the simulator on an Intel Mac.
+    uint64_t frequency = 0;
+    size_t size = sizeof(frequency);
+    if (sysctlbyname("hw.cpufrequency", &frequency, &size, NULL, 0) != 0) {
+        frequency = 0;
+    }
+
+    NSDictionary<NSNumber *, NSString *> *names = @{@(AWSChecksumAlgorithmCRC32) : @"CRC32",
+                                                    @(AWSChecksumAlgorithmCRC32C) : @"CRC32C",
+                                                    @(AWSChecksumAlgorithmCRC64NVME) : @"CRC64NVME"};
+    for (NSNumber *algorithm in @[@(AWSChecksumAlgorithmCRC32), @(AWSChecksumAlgorithmCRC32C), @(AWSChecksumAlgorithmCRC64NVME)]) {
+        for (NSNumber *hardwareAccelerated in @[@NO, @YES]) {
+            if ([hardwareAccelerated boolValue] && ![AWSChecksum isHardwareAcceleratedForAlgorithm:[algorithm integerValue]]) {
+                continue;
+            }
+            AWSChecksum *checksum = [[AWSChecksum alloc] initWithAlgorithm:[algorithm integerValue]
+                                                       hardwareAccelerated:[hardwareAccelerated boolValue]];
+            CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+            [checksum updateWithData:data];
+            CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+
+            double bytesPerSecond = [data length] / elapsed;
+            NSLog(@"%@ (%@): %.2f GB/s%@", names[algorithm],
+                  [hardwareAccelerated boolValue] ? @"hardware" : @"slicing-by-8",
+                  bytesPerSecond / 1e9,
+                  frequency > 0 ? [NSString stringWithFormat:@", %.2f bytes/cycle", bytesPerSecond / frequency] : @"");
+        }
+    }
+}
+
+- (void)testPerformanceCRC32C {
+    NSMutableData *data = [NSMutableData dataWithLength:AWSChecksumTestsBenchmarkLength];
+    arc4random_buf([data mutableBytes], [data length]);
+    [self measureBlock:^{
+        AWSChecksum *checksum = [AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmCRC32C];
+        [checksum updateWithData:data];
+    }];
+}
+
+- (void)testPerformanceCRC64NVME {
+    NSMutableData *data = [NSMutableData dataWithLength:AWSChecksumTestsBenchmarkLength];
+    arc4random_buf([data mutableBytes], [data length]);
+    [self measureBlock:^{
+        AWSChecksum *checksum = [AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmCRC64NVME];
+        [checksum updateWithData:data];
+    }];
+}
+
+@end
@@ -0,0 +1,234 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSCore.h"
+
+@interface AWSAbstractCognitoCredentialsProviderHelper()
+
+@property (nonatomic, strong) NSString *identityPoolId;
+
+@end
+
+@interface AWSCognitoCredentialsProvider()
+
+@property (nonatomic, strong) AWSCredentials *internalCredentials;
+@property (atomic, strong) NSDate *credentialsFetchDate;
+
+- (AWSTask<AWSCredentials *> *)getCredentialsWithCognito:(NSDictionary<NSString *,NSString *> *)logins
+                                           authenticated:(BOOL)isAuthenticated
+                                           customRoleArn:(NSString *)customRoleArn
+                                   withCancellationToken:(AWSCancellationTokenSource *)cancellationTokenSource;
+
+@end
+
+// Fetches credentials from a simulated Amazon Cognito taking `fetchDelay`.
+@interface AWSCognitoCredentialsProviderRefreshTestsProvider : AWSCognitoCredentialsProvider
+
+@property (nonatomic, assign) NSTimeInterval fetchDelay;
+@property (nonatomic, assign) NSTimeInterval lifetime;
+@property (atomic, assign) NSUInteger fetchCount;
+
+@end
+
+@implementation AWSCognitoCredentialsProviderRefreshTestsProvider
+
+- (AWSTask<AWSCredentials *> *)getCredentialsWithCognito:(NSDictionary<NSString *,NSString *> *)logins
+                                           authenticated:(BOOL)isAuthenticated
+                                           customRoleArn:(NSString *)customRoleArn
+                                   withCancellationToken:(AWSCancellationTokenSource *)cancellationTokenSource {
+    NSUInteger fetchCount = 0;
+    @synchronized(self) {
+        fetchCount = ++self.fetchCount;
+    }
+    return [[AWSTask taskWithDelay:(int)(self.fetchDelay * 1000)] continueWithBlock:^id(AWSTask *task) {
+        self.internalCredentials = [[AWSCredentials alloc] initWithAccessKey:[NSString stringWithFormat:@"AKID%lu", (unsigned long)fetchCount]
+                                                                   secretKey:@"secretKey"
+                                                                  sessionKey:@"sessionKey"
+                                                                  expiration:[NSDate dateWithTimeIntervalSinceNow:self.lifetime]];
+        return [AWSTask taskWithResult:self.internalCredentials];
+    }];
+}
+
+@end
+
+@interface AWSCognitoCredentialsProviderRefreshTests : XCTestCase
+
+@property (nonatomic, strong) AWSCognitoCredentialsProviderRefreshTestsProvider *credentialsProvider;
+
+@end
+
+@implementation AWSCognitoCredentialsProviderRefreshTests
+
+- (void)setUp {
+    [super setUp];
+    self.credentialsProvider = [self createCredentialsProvider];
+}
+
+- (void)tearDown {
+    [self.credentialsProvider clearKeychain];
+    [super tearDown];
+}
+
+// Each provider has its own identity pool so that they do not share keychain items.
+- (AWSCognitoCredentialsProviderRefreshTestsProvider *)createCredentialsProvider {
+    AWSAbstractCognitoCredentialsProviderHelper *identityProvider = [AWSAbstractCognitoCredentialsProviderHelper new];
+    identityProvider.identityPoolId = [NSString stringWithFormat:@"us-east-1:%@", [NSUUID UUID].UUIDString];
+    identityProvider.identityId = [NSString stringWithFormat:@"us-east-1:%@", [NSUUID UUID].UUIDString];
+    AWSCognitoCredentialsProviderRefreshTestsProvider *credentialsProvider = [[AWSCognitoCredentialsProviderRefreshTestsProvider alloc] initWithRegionType:AWSRegionUSEast1
+                                                                                                                                       identityProvider:identityProvider];
+    credentialsProvider.fetchDelay = 0.2;
+    credentialsProvider.lifetime = 60 * 60;
+    return credentialsProvider;
+}
+
+- (AWSCredentials *)credentialsWithAccessKey:(NSString *)accessKey
+                                   expiration:(NSDate *)expiration {
+    return [[AWSCredentials alloc] initWithAccessKey:accessKey
+                                           secretKey:@"secretKey"
+                                          sessionKey:@"sessionKey"
+                                          expiration:expiration];
+}
+
+- (void)testConcurrentCallersShareOneRefresh {
+    [self.credentialsProvider clearCredentials];
+
+    NSMutableArray<AWSTask<AWSCredentials *> *> *tasks = [NSMutableArray new];
+    for (NSUInteger i = 0; i < 32; i++) {
+        [tasks addObject:[self.credentialsProvider credentials]];
+    }
+    [[AWSTask taskForCompletionOfAllTasks:tasks] waitUntilFinished];
+
+    XCTAssertEqual(self.credentialsProvider.fetchCount, 1);
+    for (AWSTask<AWSCredentials *> *task in tasks) {
+        XCTAssertEqualObjects(task.result.accessKey, @"AKID1");
+    }
+    AWSCredentialsRefreshMetrics *refreshMetrics = self.credentialsProvider.refreshMetrics;
+    XCTAssertEqual(refreshMetrics.refreshCount, 1);
+    XCTAssertEqual(refreshMetrics.stallCount, 32);
+    XCTAssertGreaterThanOrEqual(refreshMetrics.maximumRefreshDuration, 0.2);
+    XCTAssertGreaterThanOrEqual(refreshMetrics.maximumStallDuration, 0.2);
+}
+
+- (void)testValidCredentialsAreServedDuringRefresh {
+    // Expiring within 10 minutes: the next call refreshes them, but they can still be used.
+    self.credentialsProvider.internalCredentials = [self credentialsWithAccessKey:@"AKID0"
+                                                                       expiration:[NSDate dateWithTimeIntervalSinceNow:5 * 60]];
+
+    AWSTask<AWSCredentials *> *refreshingTask = [self.credentialsProvider credentials];
+    [NSThread sleepForTimeInterval:0.05];
+    XCTAssertFalse(refreshingTask.completed);
+
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    AWSTask<AWSCredentials *> *task = [self.credentialsProvider credentials];
+    [task waitUntilFinished];
+    XCTAssertLessThan(CFAbsoluteTimeGetCurrent() - start, self.credentialsProvider.fetchDelay);
+    XCTAssertEqualObjects(task.result.accessKey, @"AKID0");
+
+    [refreshingTask waitUntilFinished];
+    XCTAssertEqualObjects(refreshingTask.result.accessKey, @"AKID1");
+    XCTAssertEqual(self.credentialsProvider.fetchCount, 1);
+}
+
+- (void)testExpiredCredentialsWaitForRefresh {
+    self.credentialsProvider.internalCredentials = [self credentialsWithAccessKey:@"AKID0"
+                                                                       expiration:[NSDate dateWithTimeIntervalSinceNow:30]];
+
+    AWSTask<AWSCredentials *> *refreshingTask = [self.credentialsProvider credentials];
+    [NSThread sleepForTimeInterval:0.05];
+    AWSTask<AWSCredentials *> *task = [self.credentialsProvider credentials];
+    [task waitUntilFinished];
+    XCTAssertEqualObjects(task.result.accessKey, @"AKID1");
+    [refreshingTask waitUntilFinished];
+    XCTAssertEqual(self.credentialsProvider.fetchCount, 1);
+}
+
+- (void)testProactiveRefresh {
+    self.credentialsProvider.proactiveRefreshFraction = 0.5;
+    // Fetched 40 minutes ago, valid for another 20 minutes.
+    NSDate *fetchDate = [NSDate dateWithTimeIntervalSinceNow:-40 * 60];
+    self.credentialsProvider.internalCredentials = [self credentialsWithAccessKey:@"AKID0"
+                                                                       expiration:[fetchDate dateByAddingTimeInterval:60 * 60]];
+    self.credentialsProvider.credentialsFetchDate = fetchDate;
+
+    for (NSUInteger i = 0; i < 10; i++) {
+        AWSTask<AWSCredentials *> *task = [self.credentialsProvider credentials];
+        XCTAssertTrue(task.completed);
+        XCTAssertEqualObjects(task.result.accessKey, @"AKID0");
+    }
+
+    [NSThread sleepForTimeInterval:self.credentialsProvider.fetchDelay + 0.3];
+    XCTAssertEqual(self.credentialsProvider.fetchCount, 1);
+    AWSTask<AWSCredentials *> *task = [self.credentialsProvider credentials];
+    XCTAssertTrue(task.completed);
+    XCTAssertEqualObjects(task.result.accessKey, @"AKID1");
+
+    AWSCredentialsRefreshMetrics *refreshMetrics = self.credentialsProvider.refreshMetrics;
+    XCTAssertEqual(refreshMetrics.refreshCount, 1);
+    XCTAssertEqual(refreshMetrics.proactiveRefreshCount, 1);
+    XCTAssertEqual(refreshMetrics.stallCount, 0);
+
+    // The new credentials are not refreshed again until half of their lifetime has elapsed.
+    [self.credentialsProvider credentials];
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(self.credentialsProvider.fetchCount, 1);
+
+    [refreshMetrics reset];
+    XCTAssertEqual(refreshMetrics.refreshCount, 0);
+}
+
+- (void)testNoProactiveRefreshByDefault {
+    NSDate *fetchDate = [NSDate dateWithTimeIntervalSinceNow:-40 * 60];
+    self.credentialsProvider.internalCredentials = [self credentialsWithAccessKey:@"AKID0"
+                                                                       expiration:[fetchDate dateByAddingTimeInterval:60 * 60]];
+    self.credentialsProvider.credentialsFetchDate = fetchDate;
+
+    XCTAssertEqualObjects([self.credentialsProvider credentials].result.accessKey, @"AKID0");
+    [NSThread sleepForTimeInterval:self.credentialsProvider.fetchDelay + 0.1];
+    XCTAssertEqual(self.credentialsProvider.fetchCount, 0);
+}
+
+/**
+ Requests signed every 10ms across the expiration of the credentials, refreshed when they expire within 10 minutes or
+ proactively: how long the requests wait for credentials.
+ */
+- (void)testStallBenchmark {
+    for (NSNumber *proactiveRefreshFraction in @[@0, @0.75]) {
+        [self.credentialsProvider clearKeychain];
+        self.credentialsProvider = [self createCredentialsProvider];
+        self.credentialsProvider.proactiveRefreshFraction = [proactiveRefreshFraction doubleValue];
+        // 10 minutes and 1 second before expiration.
+        NSDate *fetchDate = [NSDate dateWithTimeIntervalSinceNow:-(50 * 60 - 1)];
+        self.credentialsProvider.internalCredentials = [self credentialsWithAccessKey:@"AKID0"
+                                                                           expiration:[fetchDate dateByAddingTimeInterval:60 * 60]];
+        self.credentialsProvider.credentialsFetchDate = fetchDate;
+
+        NSMutableArray<AWSTask *> *tasks = [NSMutableArray new];
+        for (NSUInteger i = 0; i < 200; i++) {
+            [tasks addObject:[self.credentialsProvider credentials]];
+            [NSThread sleepForTimeInterval:0.01];
+        }
+        [[AWSTask taskForCompletionOfAllTasks:tasks] waitUntilFinished];
+
+        AWSCredentialsRefreshMetrics *refreshMetrics = self.credentialsProvider.refreshMetrics;
+        NSLog(@"proactiveRefreshFraction %@: %@", proactiveRefreshFraction, refreshMetrics);
+        XCTAssertEqual(refreshMetrics.refreshCount, 1);
+        if ([proactiveRefreshFraction doubleValue] > 0) {
+            XCTAssertEqual(refreshMetrics.stallCount, 0);
+        }
+    }
+}
+
+@end
@@ -0,0 +1,231 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSCore.h"
+#import "AWSCredentialsKeychainStore.h"
+
+// Reads the credentials from the keychain on every call, as the providers did when they had no cached credentials.
+@interface AWSKeychainReadingCredentialsProvider : NSObject <AWSCredentialsProvider>
+
+@property (nonatomic, strong) AWSUICKeyChainStore *keychain;
+
+@end
+
+@implementation AWSKeychainReadingCredentialsProvider
+
+- (AWSTask<AWSCredentials *> *)credentials {
+    AWSCredentials *credentials = [[AWSCredentials alloc] initWithAccessKey:self.keychain[@"accessKey"]
+                                                                  secretKey:self.keychain[@"secretKey"]
+                                                                 sessionKey:self.keychain[@"sessionKey"]
+                                                                 expiration:[NSDate dateWithTimeIntervalSince1970:[self.keychain[@"expiration"] doubleValue]]];
+    return [AWSTask taskWithResult:credentials];
+}
+
+- (void)invalidateCachedTemporaryCredentials {
+}
+
+@end
+
+@interface AWSKeychainStoreCredentialsProvider : NSObject <AWSCredentialsProvider>
+
+@property (nonatomic, strong) AWSCredentialsKeychainStore *keychainStore;
+
+@end
+
+@implementation AWSKeychainStoreCredentialsProvider
+
+- (AWSTask<AWSCredentials *> *)credentials {
+    return [AWSTask taskWithResult:self.keychainStore.credentials];
+}
+
+- (void)invalidateCachedTemporaryCredentials {
+}
+
+@end
+
+@interface AWSCredentialsKeychainStoreTests : XCTestCase
+
+@property (nonatomic, strong) NSString *service;
+
+@end
+
+@implementation AWSCredentialsKeychainStoreTests
+
+- (void)setUp {
+    [super setUp];
+    self.service = [NSString stringWithFormat:@"%@.%@", NSStringFromClass([self class]), [NSUUID UUID].UUIDString];
+}
+
+- (void)tearDown {
+    [[AWSUICKeyChainStore keyChainStoreWithService:self.service] removeAllItems];
+    [super tearDown];
+}
+
+- (AWSCredentials *)credentialsWithAccessKey:(NSString *)accessKey {
+    return [[AWSCredentials alloc] initWithAccessKey:accessKey
+                                           secretKey:@"secretKey"
+                                          sessionKey:@"sessionKey"
+                                          expiration:[NSDate dateWithTimeIntervalSince1970:1700000000]];
+}
+
+- (void)testCredentialsAreWrittenInBackground {
+    AWSCredentialsKeychainStore *store = [AWSCredentialsKeychainStore storeWithService:self.service];
+    XCTAssertNil(store.credentials);
+
+    AWSCredentials *credentials = [self credentialsWithAccessKey:@"AKID1"];
+    store.credentials = credentials;
+    XCTAssertEqual(store.credentials, credentials);
+    [store flush];
+
+    AWSUICKeyChainStore *keychain = [AWSUICKeyChainStore keyChainStoreWithService:self.service];
+    XCTAssertEqualObjects(keychain[@"accessKey"], @"AKID1");
+    XCTAssertEqualObjects(keychain[@"secretKey"], @"secretKey");
+    XCTAssertEqualObjects(keychain[@"sessionKey"], @"sessionKey");
+    XCTAssertEqual([keychain[@"expiration"] doubleValue], 1700000000);
+
+    store.credentials = nil;
+    XCTAssertNil(store.credentials);
+    [store flush];
+    XCTAssertNil(keychain[@"accessKey"]);
+    XCTAssertNil(keychain[@"expiration"]);
+}
+
+- (void)testPendingWritesAreFlushedWhenTheAppResignsActive {
+    AWSCredentialsKeychainStore *store = [AWSCredentialsKeychainStore storeWithService:self.service];
+    store.credentials = [self credentialsWithAccessKey:@"AKID1"];
+    [[NSNotificationCenter defaultCenter] postNotificationName:@"UIApplicationWillResignActiveNotification" object:nil];
+    XCTAssertEqualObjects([AWSUICKeyChainStore keyChainStoreWithService:self.service][@"accessKey"], @"AKID1");
+}
+
+- (void)testItemsAreReadOnce {
+    AWSUICKeyChainStore *keychain = [AWSUICKeyChainStore keyChainStoreWithService:self.service];
+    keychain[@"accessKey"] = @"AKID1";
+    keychain[@"secretKey"] = @"secretKey";
+    keychain[@"identityId"] = @"identityId";
+
+    AWSCredentialsKeychainStore *store = [AWSCredentialsKeychainStore storeWithService:self.service];
+    XCTAssertEqualObjects(store.credentials.accessKey, @"AKID1");
+    XCTAssertNil(store.credentials.expiration);
+    NSUInteger keychainReadCount = store.keychainReadCount;
+
+    for (NSUInteger i = 0; i < 100; i++) {
+        XCTAssertEqualObjects(store.credentials.accessKey, @"AKID1");
+        XCTAssertEqualObjects([store stringForKey:@"identityId"], @"identityId");
+        XCTAssertNil([store stringForKey:@"missing"]);
+    }
+    XCTAssertEqual(store.keychainReadCount, keychainReadCount + 2);
+}
+
+- (void)testWritesAreCoalesced {
+    AWSCredentialsKeychainStore *store = [AWSCredentialsKeychainStore storeWithService:self.service];
+    for (NSUInteger i = 0; i < 1000; i++) {
+        store.credentials = [self credentialsWithAccessKey:[NSString stringWithFormat:@"AKID%lu", (unsigned long)i]];
+    }
+    [store flush];
+    NSLog(@"1000 credentials set: %lu keychain writes", (unsigned long)store.keychainWriteCount);
+    XCTAssertLessThan(store.keychainWriteCount, 4 * 1000);
+    XCTAssertEqualObjects([AWSUICKeyChainStore keyChainStoreWithService:self.service][@"accessKey"], @"AKID999");
+
+    // Unchanged values are not written again.
+    [store setString:@"identityId" forKey:@"identityId"];
+    [store flush];
+    NSUInteger keychainWriteCount = store.keychainWriteCount;
+    for (NSUInteger i = 0; i < 100; i++) {
+        [store setString:@"identityId" forKey:@"identityId"];
+        store.credentials = [self credentialsWithAccessKey:@"AKID999"];
+    }
+    [store flush];
+    XCTAssertEqual(store.keychainWriteCount, keychainWriteCount);
+}
+
+- (void)testStoresAreSharedByService {
+    AWSCredentialsKeychainStore *store = [AWSCredentialsKeychainStore storeWithService:self.service];
+    XCTAssertEqual([AWSCredentialsKeychainStore storeWithService:self.service], store);
+    XCTAssertNotEqual([AWSCredentialsKeychainStore storeWithService:[self.service stringByAppendingString:@".other"]], store);
+
+    store.credentials = [self credentialsWithAccessKey:@"AKID1"];
+    XCTAssertEqualObjects([AWSCredentialsKeychainStore storeWithService:self.service].credentials.accessKey, @"AKID1");
+}
+
+- (void)testConcurrentAccess {
+    AWSCredentialsKeychainStore *store = [AWSCredentialsKeychainStore storeWithService:self.service];
+    dispatch_apply(16, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration) {
+        for (NSUInteger i = 0; i < 100; i++) {
+            if (i % 10 == 0) {
+                store.credentials = [self credentialsWithAccessKey:[NSString stringWithFormat:@"AKID%zu", iteration]];
+            }
+            AWSCredentials *credentials = store.credentials;
+            XCTAssertTrue([credentials.accessKey hasPrefix:@"AKID"]);
+            XCTAssertEqualObjects(credentials.secretKey, @"secretKey");
+        }
+    });
+    [store flush];
+    XCTAssertEqualObjects([AWSUICKeyChainStore keyChainStoreWithService:self.service][@"accessKey"], store.credentials.accessKey);
+}
+
+#pragma mark - Benchmark
+
+- (NSTimeInterval)signRequests:(NSUInteger)count withCredentialsProvider:(id<AWSCredentialsProvider>)credentialsProvider {
+    AWSEndpoint *endpoint = [[AWSEndpoint alloc] initWithRegion:AWSRegionUSEast1
+                                                        service:AWSServiceS3
+                                                   useUnsafeURL:NO];
+    AWSSignatureV4Signer *signer = [[AWSSignatureV4Signer alloc] initWithCredentialsProvider:credentialsProvider
+                                                                                  endpoint:endpoint];
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < count; i++) {
+        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"https://s3.amazonaws.com/bucket/key"]];
+        request.HTTPMethod = @"GET";
+        [[signer interceptRequest:request] waitUntilFinished];
+    }
+    return CFAbsoluteTimeGetCurrent() - start;
+}
+
+/**
+ The cost of getting the credentials to sign a request: reading them from the keychain, as before when the cached
+ credentials were nil, or from the in-memory snapshot.
+ */
+- (void)testCredentialAccessBenchmark {
+    AWSCredentialsKeychainStore *store = [AWSCredentialsKeychainStore storeWithService:self.service];
+    store.credentials = [self credentialsWithAccessKey:@"AKID1"];
+    [store flush];
+
+    AWSKeychainReadingCredentialsProvider *keychainReadingProvider = [AWSKeychainReadingCredentialsProvider new];
+    keychainReadingProvider.keychain = [AWSUICKeyChainStore keyChainStoreWithService:self.service];
+    AWSKeychainStoreCredentialsProvider *keychainStoreProvider = [AWSKeychainStoreCredentialsProvider new];
+    keychainStoreProvider.keychainStore = store;
+
+    NSUInteger const count = 1000;
+    NSTimeInterval keychain = [self signRequests:count withCredentialsProvider:keychainReadingProvider];
+    NSTimeInterval snapshot = [self signRequests:count withCredentialsProvider:keychainStoreProvider];
+    NSLog(@"Signing a request: keychain reads %.1f us, snapshot %.1f us (%.1fx)",
+          keychain * 1e6 / count,
+          snapshot * 1e6 / count,
+          keychain / snapshot);
+    XCTAssertLessThan(snapshot, keychain);
+
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < count; i++) {
+        store.credentials = [self credentialsWithAccessKey:[NSString stringWithFormat:@"AKID%lu", (unsigned long)i]];
+    }
+    NSTimeInterval set = CFAbsoluteTimeGetCurrent() - start;
+    [store flush];
+    NSLog(@"Setting credentials: %.1f us, %lu keychain writes for %lu sets",
+          set * 1e6 / count,
+          (unsigned long)store.keychainWriteCount,
+          (unsigned long)count);
+}
+
+@end
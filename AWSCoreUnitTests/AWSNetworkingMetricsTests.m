@@ -0,0 +1,202 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSCore.h"
+
+@interface AWSNetworkingRequestMetrics()
+
+@property (nonatomic, assign) uint32_t retryCount;
+@property (nonatomic, assign, getter=isReusedConnection) BOOL reusedConnection;
+@property (nonatomic, assign) NSTimeInterval serializationDuration;
+@property (nonatomic, assign) NSTimeInterval connectDuration;
+@property (nonatomic, assign) NSTimeInterval retryDelayDuration;
+@property (nonatomic, assign) NSTimeInterval totalDuration;
+
+@end
+
+@interface AWSNetworking()
+
+@property (nonatomic, strong) AWSURLSessionManager *sessionManager;
+
+@end
+
+@interface AWSURLSessionManager()
+
+- (void)invalidate;
+
+@end
+
+// Serializes slowly and then fails validation, so the request never reaches the network.
+@interface AWSNetworkingMetricsTestsSerializer : NSObject <AWSURLRequestSerializer>
+
+@end
+
+@implementation AWSNetworkingMetricsTestsSerializer
+
+- (AWSTask *)serializeRequest:(NSMutableURLRequest *)request
+                      headers:(NSDictionary *)headers
+                   parameters:(NSDictionary *)parameters {
+    [NSThread sleepForTimeInterval:0.02];
+    return [AWSTask taskWithResult:nil];
+}
+
+- (AWSTask *)validateRequest:(NSURLRequest *)request {
+    return [AWSTask taskWithError:[NSError errorWithDomain:AWSNetworkingErrorDomain
+                                                      code:AWSNetworkingErrorUnknown
+                                                  userInfo:nil]];
+}
+
+@end
+
+// Behaves like a signer that waited 30ms for credentials and took 10ms to sign.
+@interface AWSNetworkingMetricsTestsSigner : NSObject <AWSNetworkingRequestInterceptor>
+
+@end
+
+@implementation AWSNetworkingMetricsTestsSigner
+
+- (AWSTask *)interceptRequest:(NSMutableURLRequest *)request {
+    [NSThread sleepForTimeInterval:0.04];
+    [NSURLProtocol setProperty:@(0.03) forKey:AWSSignatureCredentialsWaitDurationKey inRequest:request];
+    return [AWSTask taskWithResult:nil];
+}
+
+@end
+
+@interface AWSNetworkingMetricsTests : XCTestCase
+
+@end
+
+@implementation AWSNetworkingMetricsTests
+
+- (AWSNetworkingRequestMetrics *)metricsWithTotalDuration:(NSTimeInterval)totalDuration {
+    AWSNetworkingRequestMetrics *metrics = [AWSNetworkingRequestMetrics new];
+    metrics.serializationDuration = totalDuration / 10;
+    metrics.totalDuration = totalDuration;
+    return metrics;
+}
+
+- (void)testAggregatorPercentiles {
+    AWSNetworkingMetricsAggregator *aggregator = [AWSNetworkingMetricsAggregator new];
+    // 1ms to 1000ms
+    for (NSUInteger i = 1; i <= 1000; i++) {
+        [aggregator recordMetrics:[self metricsWithTotalDuration:i / 1000.0]];
+    }
+
+    NSDictionary *dump = [aggregator dump];
+    XCTAssertEqualObjects(dump[@"requests"][@"count"], @1000);
+    XCTAssertEqualObjects(dump[@"total"][@"count"], @1000);
+    XCTAssertEqualWithAccuracy([dump[@"total"][@"min"] doubleValue], 0.001, 1e-9);
+    XCTAssertEqualWithAccuracy([dump[@"total"][@"max"] doubleValue], 1.0, 1e-9);
+    XCTAssertEqualWithAccuracy([dump[@"total"][@"mean"] doubleValue], 0.5005, 1e-6);
+
+    // Percentiles are accurate to a quarter octave.
+    XCTAssertEqualWithAccuracy([dump[@"total"][@"p50"] doubleValue], 0.5, 0.5 * 0.19);
+    XCTAssertEqualWithAccuracy([dump[@"total"][@"p90"] doubleValue], 0.9, 0.9 * 0.19);
+    XCTAssertEqualWithAccuracy([dump[@"total"][@"p99"] doubleValue], 0.99, 0.99 * 0.19);
+    XCTAssertEqualWithAccuracy([dump[@"serialization"][@"p50"] doubleValue], 0.05, 0.05 * 0.19);
+
+    // Connection setup is only recorded for new connections, and retry delays for retried requests.
+    XCTAssertNil(dump[@"connect"]);
+    XCTAssertNil(dump[@"retryDelay"]);
+
+    AWSNetworkingRequestMetrics *metrics = [self metricsWithTotalDuration:0.5];
+    metrics.reusedConnection = NO;
+    metrics.connectDuration = 0.02;
+    metrics.retryCount = 2;
+    metrics.retryDelayDuration = 0.3;
+    [aggregator recordMetrics:metrics];
+    dump = [aggregator dump];
+    XCTAssertEqualObjects(dump[@"connect"][@"count"], @1);
+    XCTAssertEqualObjects(dump[@"retryDelay"][@"count"], @1);
+    XCTAssertEqualObjects(dump[@"requests"][@"retries"], @2);
+    XCTAssertTrue([[aggregator dumpDescription] containsString:@"timeToFirstByte"]);
+
+    [aggregator reset];
+    XCTAssertEqualObjects([aggregator dump][@"requests"][@"count"], @0);
+    XCTAssertNil([aggregator dump][@"total"]);
+}
+
+- (void)testExtremeDurationsAreClamped {
+    AWSNetworkingMetricsAggregator *aggregator = [AWSNetworkingMetricsAggregator new];
+    [aggregator recordMetrics:[self metricsWithTotalDuration:0]];
+    [aggregator recordMetrics:[self metricsWithTotalDuration:100000]];
+    NSDictionary *dump = [aggregator dump];
+    XCTAssertEqualObjects(dump[@"total"][@"min"], @0);
+    XCTAssertEqualObjects(dump[@"total"][@"max"], @100000);
+    XCTAssertLessThanOrEqual([dump[@"total"][@"p99"] doubleValue], 100000);
+}
+
+- (void)testPipelinePhasesAreReported {
+    AWSNetworkingMetricsAggregator *aggregator = [AWSNetworkingMetricsAggregator new];
+    __block AWSNetworkingRequestMetrics *reportedMetrics = nil;
+
+    AWSNetworkingConfiguration *configuration = [AWSNetworkingConfiguration new];
+    configuration.baseURL = [NSURL URLWithString:@"https://example.amazonaws.com"];
+    configuration.HTTPMethod = AWSHTTPMethodPOST;
+    configuration.requestSerializer = [AWSNetworkingMetricsTestsSerializer new];
+    configuration.requestInterceptors = @[[AWSNetworkingMetricsTestsSigner new]];
+    configuration.metricsHandler = ^(AWSNetworkingRequestMetrics *metrics) {
+        reportedMetrics = metrics;
+        aggregator.metricsHandler(metrics);
+    };
+
+    AWSNetworking *networking = [[AWSNetworking alloc] initWithConfiguration:configuration];
+    AWSTask *task = [networking sendRequest:[AWSNetworkingRequest new]];
+    [task waitUntilFinished];
+
+    XCTAssertNotNil(task.error);
+    XCTAssertNotNil(reportedMetrics);
+    XCTAssertEqualObjects(reportedMetrics.error, task.error);
+    XCTAssertEqual(reportedMetrics.HTTPMethod, AWSHTTPMethodPOST);
+    XCTAssertEqual(reportedMetrics.retryCount, 0);
+    XCTAssertGreaterThanOrEqual(reportedMetrics.serializationDuration, 0.02);
+    XCTAssertEqualWithAccuracy(reportedMetrics.credentialsWaitDuration, 0.03, 1e-9);
+    XCTAssertGreaterThanOrEqual(reportedMetrics.signingDuration, 0.009);
+    XCTAssertGreaterThanOrEqual(reportedMetrics.totalDuration, 0.06);
+    XCTAssertEqual(reportedMetrics.timeToFirstByte, 0);
+    XCTAssertEqualObjects([aggregator dump][@"requests"][@"errors"], @1);
+}
+
+- (void)testMetricsAreReportedForInvalidatedSession {
+    __block AWSNetworkingRequestMetrics *reportedMetrics = nil;
+    AWSNetworkingConfiguration *configuration = [AWSNetworkingConfiguration new];
+    configuration.baseURL = [NSURL URLWithString:@"https://example.amazonaws.com"];
+    configuration.metricsHandler = ^(AWSNetworkingRequestMetrics *metrics) {
+        reportedMetrics = metrics;
+    };
+
+    AWSNetworking *networking = [[AWSNetworking alloc] initWithConfiguration:configuration];
+    [networking.sessionManager invalidate];
+    AWSTask *task = [networking sendRequest:[AWSNetworkingRequest new]];
+    [task waitUntilFinished];
+
+    XCTAssertEqual(task.error.code, AWSNetworkingErrorSessionInvalid);
+    XCTAssertEqual(reportedMetrics.error.code, AWSNetworkingErrorSessionInvalid);
+}
+
+- (void)testMetricsHandlerIsCopied {
+    AWSNetworkingConfiguration *configuration = [AWSNetworkingConfiguration new];
+    configuration.metricsHandler = [AWSNetworkingMetricsAggregator new].metricsHandler;
+    AWSNetworkingConfiguration *copy = [configuration copy];
+    XCTAssertNotNil(copy.metricsHandler);
+
+    AWSNetworkingRequest *request = [AWSNetworkingRequest new];
+    [request assignProperties:configuration];
+    XCTAssertNotNil(request.metricsHandler);
+}
+
+@end
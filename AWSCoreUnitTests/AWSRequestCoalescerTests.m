@@ -0,0 +1,228 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSCore.h"
+
+@interface AWSRequestCoalescerTestsSerializer : NSObject <AWSURLRequestSerializer>
+
+@end
+
+@implementation AWSRequestCoalescerTestsSerializer
+
+- (AWSTask *)serializeRequest:(NSMutableURLRequest *)request
+                      headers:(NSDictionary *)headers
+                   parameters:(NSDictionary *)parameters {
+    return [AWSTask taskWithResult:nil];
+}
+
+- (AWSTask *)validateRequest:(NSURLRequest *)request {
+    return [AWSTask taskWithResult:nil];
+}
+
+@end
+
+// Registers `inFlightTask` for the request being signed, as if an identical request had been sent before it.
+@interface AWSRequestCoalescerTestsInterceptor : NSObject <AWSNetworkingRequestInterceptor>
+
+@property (nonatomic, strong) AWSRequestCoalescer *requestCoalescer;
+@property (nonatomic, strong) AWSTask *inFlightTask;
+
+@end
+
+@implementation AWSRequestCoalescerTestsInterceptor
+
+- (AWSTask *)interceptRequest:(NSMutableURLRequest *)request {
+    [self.requestCoalescer inFlightTaskForRequest:request registeringTask:self.inFlightTask];
+    return [AWSTask taskWithResult:nil];
+}
+
+@end
+
+@interface AWSRequestCoalescerTests : XCTestCase
+
+@end
+
+@implementation AWSRequestCoalescerTests
+
+- (NSMutableURLRequest *)signedRequestWithURL:(NSString *)URLString
+                                   HTTPMethod:(NSString *)HTTPMethod
+                                  accessKeyId:(NSString *)accessKeyId
+                                         date:(NSString *)date {
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:URLString]];
+    request.HTTPMethod = HTTPMethod;
+    [request setValue:date forHTTPHeaderField:@"X-Amz-Date"];
+    [request setValue:[[NSUUID UUID] UUIDString] forHTTPHeaderField:@"amz-sdk-invocation-id"];
+    [request setValue:@"aws-sdk-iOS/2.x" forHTTPHeaderField:@"User-Agent"];
+    [request setValue:@"examplebucket.s3.amazonaws.com" forHTTPHeaderField:@"Host"];
+    [request setValue:[NSString stringWithFormat:@"AWS4-HMAC-SHA256 Credential=%@/20130524/us-east-1/s3/aws4_request, SignedHeaders=host;x-amz-date, Signature=%@", accessKeyId, [[NSUUID UUID] UUIDString]]
+   forHTTPHeaderField:@"Authorization"];
+    return request;
+}
+
+- (void)testKeyIgnoresPerSignatureHeaders {
+    AWSRequestCoalescer *requestCoalescer = [AWSRequestCoalescer new];
+    NSString *URLString = @"https://examplebucket.s3.amazonaws.com/photos/2006/February/sample.jpg";
+    NSMutableURLRequest *request = [self signedRequestWithURL:URLString HTTPMethod:@"GET" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000000Z"];
+    NSMutableURLRequest *identicalRequest = [self signedRequestWithURL:URLString HTTPMethod:@"GET" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000001Z"];
+    XCTAssertEqualObjects([requestCoalescer keyForRequest:request], [requestCoalescer keyForRequest:identicalRequest]);
+
+    NSMutableURLRequest *otherAccessKeyRequest = [self signedRequestWithURL:URLString HTTPMethod:@"GET" accessKeyId:@"AKIDOTHER" date:@"20130524T000000Z"];
+    XCTAssertNotEqualObjects([requestCoalescer keyForRequest:request], [requestCoalescer keyForRequest:otherAccessKeyRequest]);
+
+    NSMutableURLRequest *otherURLRequest = [self signedRequestWithURL:[URLString stringByAppendingString:@"?versionId=1"] HTTPMethod:@"GET" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000000Z"];
+    XCTAssertNotEqualObjects([requestCoalescer keyForRequest:request], [requestCoalescer keyForRequest:otherURLRequest]);
+
+    NSMutableURLRequest *rangeRequest = [self signedRequestWithURL:URLString HTTPMethod:@"GET" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000000Z"];
+    [rangeRequest setValue:@"bytes=0-9" forHTTPHeaderField:@"Range"];
+    XCTAssertNotEqualObjects([requestCoalescer keyForRequest:request], [requestCoalescer keyForRequest:rangeRequest]);
+
+    NSMutableURLRequest *headRequest = [self signedRequestWithURL:URLString HTTPMethod:@"HEAD" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000000Z"];
+    XCTAssertNotEqualObjects([requestCoalescer keyForRequest:request], [requestCoalescer keyForRequest:headRequest]);
+}
+
+- (void)testKeyIncludesBody {
+    AWSRequestCoalescer *requestCoalescer = [AWSRequestCoalescer new];
+    NSString *URLString = @"https://kinesis.us-east-1.amazonaws.com/";
+    NSMutableURLRequest *request = [self signedRequestWithURL:URLString HTTPMethod:@"POST" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000000Z"];
+    request.HTTPBody = [@"{\"StreamName\":\"a\"}" dataUsingEncoding:NSUTF8StringEncoding];
+    NSMutableURLRequest *sameBodyRequest = [self signedRequestWithURL:URLString HTTPMethod:@"POST" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000001Z"];
+    sameBodyRequest.HTTPBody = [@"{\"StreamName\":\"a\"}" dataUsingEncoding:NSUTF8StringEncoding];
+    NSMutableURLRequest *otherBodyRequest = [self signedRequestWithURL:URLString HTTPMethod:@"POST" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000000Z"];
+    otherBodyRequest.HTTPBody = [@"{\"StreamName\":\"b\"}" dataUsingEncoding:NSUTF8StringEncoding];
+
+    XCTAssertEqualObjects([requestCoalescer keyForRequest:request], [requestCoalescer keyForRequest:sameBodyRequest]);
+    XCTAssertNotEqualObjects([requestCoalescer keyForRequest:request], [requestCoalescer keyForRequest:otherBodyRequest]);
+}
+
+- (void)testShouldCoalesceReadsOnly {
+    AWSRequestCoalescer *requestCoalescer = [AWSRequestCoalescer new];
+    NSString *URLString = @"https://examplebucket.s3.amazonaws.com/key";
+    XCTAssertTrue([requestCoalescer shouldCoalesceRequest:[self signedRequestWithURL:URLString HTTPMethod:@"GET" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000000Z"]]);
+    XCTAssertTrue([requestCoalescer shouldCoalesceRequest:[self signedRequestWithURL:URLString HTTPMethod:@"HEAD" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000000Z"]]);
+    XCTAssertFalse([requestCoalescer shouldCoalesceRequest:[self signedRequestWithURL:URLString HTTPMethod:@"PUT" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000000Z"]]);
+    XCTAssertFalse([requestCoalescer shouldCoalesceRequest:[self signedRequestWithURL:URLString HTTPMethod:@"DELETE" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000000Z"]]);
+
+    NSMutableURLRequest *describeStream = [self signedRequestWithURL:@"https://kinesis.us-east-1.amazonaws.com/" HTTPMethod:@"POST" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000000Z"];
+    [describeStream setValue:@"Kinesis_20131202.DescribeStream" forHTTPHeaderField:@"X-Amz-Target"];
+    XCTAssertTrue([requestCoalescer shouldCoalesceRequest:describeStream]);
+
+    NSMutableURLRequest *putRecords = [self signedRequestWithURL:@"https://kinesis.us-east-1.amazonaws.com/" HTTPMethod:@"POST" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000000Z"];
+    [putRecords setValue:@"Kinesis_20131202.PutRecords" forHTTPHeaderField:@"X-Amz-Target"];
+    XCTAssertFalse([requestCoalescer shouldCoalesceRequest:putRecords]);
+
+    NSMutableURLRequest *streamedRequest = [self signedRequestWithURL:URLString HTTPMethod:@"GET" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000000Z"];
+    streamedRequest.HTTPBodyStream = [NSInputStream inputStreamWithData:[NSData data]];
+    XCTAssertFalse([requestCoalescer shouldCoalesceRequest:streamedRequest]);
+}
+
+- (void)testConcurrentIdenticalRequestsShareOneTask {
+    AWSRequestCoalescer *requestCoalescer = [AWSRequestCoalescer new];
+    NSString *URLString = @"https://examplebucket.s3.amazonaws.com/shadow";
+    NSUInteger const requestCount = 32;
+
+    NSMutableArray<AWSTaskCompletionSource *> *taskCompletionSources = [NSMutableArray new];
+    NSMutableArray<AWSTask *> *tasks = [NSMutableArray new];
+    for (NSUInteger i = 0; i < requestCount; i++) {
+        AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+        NSMutableURLRequest *request = [self signedRequestWithURL:URLString
+                                                       HTTPMethod:@"GET"
+                                                      accessKeyId:@"AKIDEXAMPLE"
+                                                             date:[NSString stringWithFormat:@"20130524T0000%02luZ", (unsigned long)i]];
+        AWSTask *inFlightTask = [requestCoalescer inFlightTaskForRequest:request
+                                                         registeringTask:taskCompletionSource.task];
+        if (inFlightTask) {
+            [tasks addObject:inFlightTask];
+        } else {
+            [taskCompletionSources addObject:taskCompletionSource];
+            [tasks addObject:taskCompletionSource.task];
+        }
+    }
+
+    XCTAssertEqual([taskCompletionSources count], 1);
+    XCTAssertEqual(requestCoalescer.requestCount, requestCount);
+    XCTAssertEqual(requestCoalescer.coalescedCount, requestCount - 1);
+    XCTAssertEqualWithAccuracy(requestCoalescer.hitRate, (double)(requestCount - 1) / requestCount, 0.0001);
+    XCTAssertEqual(requestCoalescer.inFlightCount, 1);
+
+    [taskCompletionSources firstObject].result = @"shadow";
+    [[AWSTask taskForCompletionOfAllTasks:tasks] waitUntilFinished];
+    for (AWSTask *task in tasks) {
+        XCTAssertEqualObjects(task.result, @"shadow");
+    }
+    XCTAssertEqual(requestCoalescer.inFlightCount, 0);
+
+    // Once the request completed, the next one is sent.
+    AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+    XCTAssertNil([requestCoalescer inFlightTaskForRequest:[self signedRequestWithURL:URLString HTTPMethod:@"GET" accessKeyId:@"AKIDEXAMPLE" date:@"20130524T000100Z"]
+                                          registeringTask:taskCompletionSource.task]);
+    taskCompletionSource.result = nil;
+
+    [requestCoalescer resetCounters];
+    XCTAssertEqual(requestCoalescer.requestCount, 0);
+    XCTAssertEqual(requestCoalescer.hitRate, 0);
+}
+
+- (void)testCancellingAJoinedRequest {
+    AWSTaskCompletionSource *inFlightRequest = [AWSTaskCompletionSource taskCompletionSource];
+    AWSRequestCoalescerTestsInterceptor *interceptor = [AWSRequestCoalescerTestsInterceptor new];
+    interceptor.requestCoalescer = [AWSRequestCoalescer new];
+    interceptor.inFlightTask = inFlightRequest.task;
+
+    AWSNetworkingConfiguration *configuration = [AWSNetworkingConfiguration new];
+    configuration.baseURL = [NSURL URLWithString:@"https://examplebucket.s3.amazonaws.com/key"];
+    configuration.HTTPMethod = AWSHTTPMethodGET;
+    configuration.requestSerializer = [AWSRequestCoalescerTestsSerializer new];
+    configuration.requestInterceptors = @[interceptor];
+    configuration.requestCoalescer = interceptor.requestCoalescer;
+
+    AWSNetworking *networking = [[AWSNetworking alloc] initWithConfiguration:configuration];
+    AWSNetworkingRequest *request = [AWSNetworkingRequest new];
+    AWSTask *task = [networking sendRequest:request];
+    // The request joined the one in flight and waits for it.
+    [self waitForExpectations:@[[[XCTNSPredicateExpectation alloc] initWithPredicate:[NSPredicate predicateWithFormat:@"coalescedCount == 1"]
+                                                                              object:interceptor.requestCoalescer]]
+                      timeout:5];
+    XCTAssertFalse(task.completed);
+
+    [request cancel];
+    inFlightRequest.result = @"shared";
+    [task waitUntilFinished];
+    XCTAssertEqualObjects(task.error.domain, AWSNetworkingErrorDomain);
+    XCTAssertEqual(task.error.code, AWSNetworkingErrorCancelled);
+    XCTAssertNil(task.result);
+}
+
+- (void)testConcurrentRegistration {
+    AWSRequestCoalescer *requestCoalescer = [AWSRequestCoalescer new];
+    AWSTaskCompletionSource *leader = [AWSTaskCompletionSource taskCompletionSource];
+    __block NSUInteger leaderCount = 0;
+    dispatch_apply(64, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration) {
+        NSMutableURLRequest *request = [self signedRequestWithURL:@"https://data.iot.us-east-1.amazonaws.com/things/thing/shadow"
+                                                       HTTPMethod:@"GET"
+                                                      accessKeyId:@"AKIDEXAMPLE"
+                                                             date:@"20130524T000000Z"];
+        if (![requestCoalescer inFlightTaskForRequest:request registeringTask:leader.task]) {
+            @synchronized(self) {
+                leaderCount++;
+            }
+        }
+    });
+    XCTAssertEqual(leaderCount, 1);
+    XCTAssertEqual(requestCoalescer.coalescedCount, 63);
+    leader.result = nil;
+}
+
+@end
@@ -0,0 +1,254 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <CommonCrypto/CommonDigest.h>
+#import <mach/mach.h>
+#import "AWSCore.h"
+
+static NSUInteger const AWSResponseBodyConsumerTestsChunkSize = 64 * 1024;
+static NSUInteger const AWSResponseBodyConsumerTestsBodySize = 32 * 1024 * 1024;
+
+// The memory attributed to the process, as reported in the memory gauge of Xcode.
+static int64_t AWSResponseBodyConsumerTestsFootprint(void) {
+    task_vm_info_data_t info;
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_VM_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return (int64_t)info.phys_footprint;
+}
+
+@interface AWSResponseBodyConsumerTests : XCTestCase
+
+@property (nonatomic, strong) NSHTTPURLResponse *response;
+@property (nonatomic, strong) NSURL *fileURL;
+
+@end
+
+@implementation AWSResponseBodyConsumerTests
+
+- (void)setUp {
+    [super setUp];
+    self.response = [self responseWithHeaders:@{}];
+    self.fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:nil];
+    [super tearDown];
+}
+
+- (NSHTTPURLResponse *)responseWithHeaders:(NSDictionary *)headers {
+    return [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://example.amazonaws.com/"]
+                                       statusCode:200
+                                      HTTPVersion:@"HTTP/1.1"
+                                     headerFields:headers];
+}
+
+- (NSData *)dataOfLength:(NSUInteger)length {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    uint8_t *bytes = [data mutableBytes];
+    for (NSUInteger i = 0; i < length; i++) {
+        bytes[i] = (uint8_t)(i * 31 + (i >> 8));
+    }
+    return data;
+}
+
+- (id)feedData:(NSData *)data toConsumer:(id<AWSNetworkingResponseBodyConsumer>)consumer error:(NSError **)error {
+    if (![consumer beginResponse:self.response error:error]) {
+        return nil;
+    }
+    for (NSUInteger offset = 0; offset < [data length]; offset += 1000) {
+        if (![consumer consumeData:[data subdataWithRange:NSMakeRange(offset, MIN(1000, [data length] - offset))] error:error]) {
+            return nil;
+        }
+    }
+    return [consumer finishResponseWithError:error];
+}
+
+#pragma mark - Consumers
+
+- (void)testFileConsumer {
+    NSData *data = [self dataOfLength:100000];
+    AWSFileResponseBodyConsumer *consumer = [[AWSFileResponseBodyConsumer alloc] initWithFileURL:self.fileURL];
+
+    // An attempt that is retried leaves nothing behind.
+    XCTAssertTrue([consumer beginResponse:self.response error:nil]);
+    XCTAssertTrue([consumer consumeData:[self dataOfLength:5000] error:nil]);
+
+    NSError *error = nil;
+    XCTAssertEqualObjects([self feedData:data toConsumer:consumer error:&error], self.fileURL);
+    XCTAssertNil(error);
+    XCTAssertEqual(consumer.bytesWritten, 100000);
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:self.fileURL], data);
+
+    XCTAssertTrue([consumer beginResponse:self.response error:nil]);
+    [consumer cancelResponse];
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:self.fileURL.path]);
+}
+
+- (void)testHashingConsumer {
+    NSData *data = [self dataOfLength:100000];
+    AWSChecksum *checksum = [AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmCRC32C];
+    [checksum updateWithData:data];
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256([data bytes], (CC_LONG)[data length], digest);
+
+    self.response = [self responseWithHeaders:@{@"x-amz-checksum-crc32c" : [checksum base64EncodedChecksum]}];
+    AWSHashingResponseBodyConsumer *consumer = [[AWSHashingResponseBodyConsumer alloc] initWithConsumer:nil
+                                                                                     checksumAlgorithm:AWSChecksumAlgorithmCRC32C];
+    consumer.computesSHA256 = YES;
+    NSError *error = nil;
+    XCTAssertEqualObjects([self feedData:data toConsumer:consumer error:&error], data);
+    XCTAssertNil(error);
+    XCTAssertEqualObjects([consumer.checksum base64EncodedChecksum], [checksum base64EncodedChecksum]);
+    XCTAssertEqualObjects(consumer.SHA256Digest, [NSData dataWithBytes:digest length:CC_SHA256_DIGEST_LENGTH]);
+
+    // Tees into another consumer.
+    AWSFileResponseBodyConsumer *fileConsumer = [[AWSFileResponseBodyConsumer alloc] initWithFileURL:self.fileURL];
+    consumer = [[AWSHashingResponseBodyConsumer alloc] initWithConsumer:fileConsumer
+                                                      checksumAlgorithm:AWSChecksumAlgorithmCRC32C];
+    XCTAssertEqualObjects([self feedData:data toConsumer:consumer error:&error], self.fileURL);
+    XCTAssertNil(error);
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:self.fileURL], data);
+}
+
+- (void)testHashingConsumerChecksumMismatch {
+    AWSHashingResponseBodyConsumer *consumer = [[AWSHashingResponseBodyConsumer alloc] initWithConsumer:[[AWSFileResponseBodyConsumer alloc] initWithFileURL:self.fileURL]
+                                                                                     checksumAlgorithm:AWSChecksumAlgorithmCRC32];
+    self.response = [self responseWithHeaders:@{@"X-Amz-Checksum-Crc32" : @"AAAAAA=="}];
+    NSError *error = nil;
+    XCTAssertNil([self feedData:[self dataOfLength:1000] toConsumer:consumer error:&error]);
+    XCTAssertEqualObjects(error.domain, AWSNetworkingErrorDomain);
+    XCTAssertEqual(error.code, AWSNetworkingErrorChecksumMismatch);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:self.fileURL.path]);
+
+    // The checksum of a multipart object can not be verified from the body.
+    self.response = [self responseWithHeaders:@{@"x-amz-checksum-crc32" : @"AAAAAA==-3"}];
+    error = nil;
+    XCTAssertNotNil([self feedData:[self dataOfLength:1000] toConsumer:consumer error:&error]);
+    XCTAssertNil(error);
+}
+
+- (void)testStreamingConsumer {
+    NSData *data = [self dataOfLength:1000000];
+    AWSStreamingResponseBodyConsumer *consumer = [[AWSStreamingResponseBodyConsumer alloc] initWithParser:^id(NSInputStream *inputStream, NSHTTPURLResponse *response, NSError **error) {
+        AWSChecksum *checksum = [AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmCRC32];
+        uint8_t buffer[4096];
+        [inputStream open];
+        NSInteger length = 0;
+        while ((length = [inputStream read:buffer maxLength:sizeof(buffer)]) > 0) {
+            [checksum updateWithBytes:buffer length:length];
+        }
+        return @([checksum value]);
+    }];
+    NSError *error = nil;
+    XCTAssertEqualObjects([self feedData:data toConsumer:consumer error:&error], @([AWSChecksum CRC32ForBytes:[data bytes] length:[data length]]));
+    XCTAssertNil(error);
+
+    // Each attempt is parsed from the start.
+    XCTAssertEqualObjects([self feedData:data toConsumer:consumer error:&error], @([AWSChecksum CRC32ForBytes:[data bytes] length:[data length]]));
+}
+
+- (void)testStreamingConsumerParserFailure {
+    NSError *parseError = [NSError errorWithDomain:AWSNetworkingErrorDomain code:AWSNetworkingErrorUnknown userInfo:nil];
+    AWSStreamingResponseBodyConsumer *consumer = [[AWSStreamingResponseBodyConsumer alloc] initWithParser:^id(NSInputStream *inputStream, NSHTTPURLResponse *response, NSError **error) {
+        uint8_t buffer[16];
+        [inputStream open];
+        [inputStream read:buffer maxLength:sizeof(buffer)];
+        *error = parseError;
+        return nil;
+    } bufferSize:1024];
+
+    // The parser stops reading; the writer is not left waiting for it.
+    NSError *error = nil;
+    XCTAssertNil([self feedData:[self dataOfLength:1000000] toConsumer:consumer error:&error]);
+    XCTAssertEqualObjects(error, parseError);
+}
+
+- (void)testJSONPayloadFromFile {
+    NSDictionary *definition = @{@"metadata" : @{@"protocol" : @"rest-json"},
+                                 @"operations" : @{@"GetBlob" : @{@"output" : @{@"shape" : @"GetBlobOutput"}}},
+                                 @"shapes" : @{@"GetBlobOutput" : @{@"type" : @"structure",
+                                                                    @"members" : @{@"Body" : @{@"shape" : @"Stream"}},
+                                                                    @"payload" : @"Body"},
+                                               @"Stream" : @{@"type" : @"blob", @"streaming" : @YES}}};
+    NSError *error = nil;
+    NSDictionary *result = [AWSJSONParser dictionaryForJsonData:(NSData *)self.fileURL
+                                                       response:self.response
+                                                     actionName:@"GetBlob"
+                                          serviceDefinitionRule:definition
+                                                          error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(result[@"Body"], self.fileURL);
+}
+
+#pragma mark - Peak memory
+
+/**
+ Feeds a 32MB body in 64KB chunks, as a URL session delivers it, and returns how far the memory footprint grew above
+ where it started.
+ */
+- (int64_t)peakFootprintGrowthFeedingConsumer:(id<AWSNetworkingResponseBodyConsumer>)consumer {
+    NSData *chunk = [self dataOfLength:AWSResponseBodyConsumerTestsChunkSize];
+    int64_t peak = 0;
+    @autoreleasepool {
+        int64_t start = AWSResponseBodyConsumerTestsFootprint();
+        XCTAssertTrue([consumer beginResponse:self.response error:nil]);
+        for (NSUInteger offset = 0; offset < AWSResponseBodyConsumerTestsBodySize; offset += AWSResponseBodyConsumerTestsChunkSize) {
+            @autoreleasepool {
+                XCTAssertTrue([consumer consumeData:[chunk copy] error:nil]);
+            }
+            peak = MAX(peak, AWSResponseBodyConsumerTestsFootprint() - start);
+        }
+        id body = [consumer finishResponseWithError:nil];
+        XCTAssertNotNil(body);
+        peak = MAX(peak, AWSResponseBodyConsumerTestsFootprint() - start);
+    }
+    return peak;
+}
+
+- (void)testPeakMemory {
+    int64_t const limit = 8 * 1024 * 1024;
+
+    // What the session manager does without a consumer.
+    int64_t collected = [self peakFootprintGrowthFeedingConsumer:[[AWSHashingResponseBodyConsumer alloc] initWithConsumer:nil
+                                                                                                      checksumAlgorithm:AWSChecksumAlgorithmNone]];
+    int64_t file = [self peakFootprintGrowthFeedingConsumer:[[AWSFileResponseBodyConsumer alloc] initWithFileURL:self.fileURL]];
+    int64_t hashedFile = [self peakFootprintGrowthFeedingConsumer:[[AWSHashingResponseBodyConsumer alloc] initWithConsumer:[[AWSFileResponseBodyConsumer alloc] initWithFileURL:self.fileURL]
+                                                                                                        checksumAlgorithm:AWSChecksumAlgorithmCRC32C]];
+    int64_t streamed = [self peakFootprintGrowthFeedingConsumer:[[AWSStreamingResponseBodyConsumer alloc] initWithParser:^id(NSInputStream *inputStream, NSHTTPURLResponse *response, NSError **error) {
+        uint8_t buffer[4096];
+        uint64_t total = 0;
+        NSInteger length = 0;
+        [inputStream open];
+        while ((length = [inputStream read:buffer maxLength:sizeof(buffer)]) > 0) {
+            total += length;
+        }
+        return @(total);
+    }]];
+
+    NSLog(@"Peak memory growth for a %luMB body: collected %.1fMB, file %.1fMB, hashed file %.1fMB, streamed %.1fMB",
+          (unsigned long)(AWSResponseBodyConsumerTestsBodySize >> 20),
+          collected / 1048576.0, file / 1048576.0, hashedFile / 1048576.0, streamed / 1048576.0);
+
+    XCTAssertGreaterThanOrEqual(collected, (int64_t)AWSResponseBodyConsumerTestsBodySize - limit);
+    XCTAssertLessThan(file, limit);
+    XCTAssertLessThan(hashedFile, limit);
+    XCTAssertLessThan(streamed, limit);
+}
+
+@end
@@ -0,0 +1,214 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSCore.h"
+
+@interface AWSResponseCacheTests : XCTestCase
+
+@property (nonatomic, strong) NSURL *directoryURL;
+
+@end
+
+@implementation AWSResponseCacheTests
+
+- (void)setUp {
+    [super setUp];
+    self.directoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]
+                                   isDirectory:YES];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.directoryURL error:nil];
+    [super tearDown];
+}
+
+- (NSMutableURLRequest *)requestForKey:(NSString *)key {
+    NSString *URLString = [NSString stringWithFormat:@"https://examplebucket.s3.amazonaws.com/%@", key];
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:URLString]];
+    request.HTTPMethod = @"GET";
+    return request;
+}
+
+- (NSHTTPURLResponse *)responseForRequest:(NSURLRequest *)request
+                               statusCode:(NSInteger)statusCode
+                                  headers:(NSDictionary *)headers {
+    return [[NSHTTPURLResponse alloc] initWithURL:request.URL
+                                       statusCode:statusCode
+                                      HTTPVersion:@"HTTP/1.1"
+                                     headerFields:headers];
+}
+
+// Plays the part of `AWSURLSessionManager` for one request to a service whose object has `ETag`.
+- (NSData *)getKey:(NSString *)key
+         fromCache:(AWSResponseCache *)responseCache
+              ETag:(NSString *)ETag
+              body:(NSData *)body {
+    NSMutableURLRequest *request = [self requestForKey:key];
+    XCTAssertTrue([responseCache shouldCacheRequest:request]);
+    NSURLRequest *responseCacheRequest = [request copy];
+    NSCachedURLResponse *cachedResponse = [responseCache prepareRequest:request];
+
+    // Signing adds headers that must not change the key.
+    [request setValue:[[NSUUID UUID] UUIDString] forHTTPHeaderField:@"Authorization"];
+    [request setValue:[[NSUUID UUID] UUIDString] forHTTPHeaderField:@"X-Amz-Date"];
+
+    if (cachedResponse && [[request valueForHTTPHeaderField:@"If-None-Match"] isEqualToString:ETag]) {
+        NSHTTPURLResponse *notModified = [self responseForRequest:request
+                                                       statusCode:304
+                                                          headers:@{@"ETag" : ETag, @"Date" : @"Wed, 12 Oct 2022 17:50:00 GMT"}];
+        return [responseCache revalidateCachedResponse:cachedResponse
+                                          withResponse:notModified
+                                            forRequest:responseCacheRequest].data;
+    }
+    NSHTTPURLResponse *response = [self responseForRequest:request
+                                                statusCode:200
+                                                   headers:@{@"ETag" : ETag, @"Content-Length" : [@([body length]) stringValue]}];
+    [responseCache storeResponse:response data:body forRequest:responseCacheRequest];
+    return body;
+}
+
+- (void)testRevalidation {
+    AWSResponseCache *responseCache = [[AWSResponseCache alloc] initWithMemoryCapacity:1024 * 1024
+                                                                          diskCapacity:0
+                                                                          directoryURL:nil];
+    NSData *body = [@"object" dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects([self getKey:@"key" fromCache:responseCache ETag:@"\"1\"" body:body], body);
+    XCTAssertEqual(responseCache.missCount, 1);
+    XCTAssertEqual(responseCache.hitCount, 0);
+
+    NSMutableURLRequest *request = [self requestForKey:@"key"];
+    NSCachedURLResponse *cachedResponse = [responseCache prepareRequest:request];
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"If-None-Match"], @"\"1\"");
+    XCTAssertEqualObjects(cachedResponse.data, body);
+
+    // 304: the cached body, with the headers of the 304.
+    XCTAssertEqualObjects([self getKey:@"key" fromCache:responseCache ETag:@"\"1\"" body:[NSData data]], body);
+    XCTAssertEqual(responseCache.hitCount, 1);
+    NSHTTPURLResponse *revalidatedResponse = (NSHTTPURLResponse *)[responseCache cachedResponseForRequest:[self requestForKey:@"key"]].response;
+    XCTAssertEqual(revalidatedResponse.statusCode, 200);
+    XCTAssertEqualObjects([revalidatedResponse allHeaderFields][@"Date"], @"Wed, 12 Oct 2022 17:50:00 GMT");
+    XCTAssertEqualObjects([revalidatedResponse allHeaderFields][@"Content-Length"], @"6");
+
+    // Changed: the new body replaces the cached one.
+    NSData *newBody = [@"modified object" dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects([self getKey:@"key" fromCache:responseCache ETag:@"\"2\"" body:newBody], newBody);
+    XCTAssertEqualObjects([responseCache cachedResponseForRequest:[self requestForKey:@"key"]].data, newBody);
+    XCTAssertEqual(responseCache.missCount, 2);
+    XCTAssertEqualWithAccuracy(responseCache.hitRate, 1.0 / 3, 0.0001);
+
+    [responseCache resetCounters];
+    XCTAssertEqual(responseCache.hitRate, 0);
+}
+
+- (void)testOnlyCacheableResponsesAreStored {
+    AWSResponseCache *responseCache = [[AWSResponseCache alloc] initWithMemoryCapacity:1024 * 1024
+                                                                          diskCapacity:0
+                                                                          directoryURL:nil];
+    NSData *body = [@"object" dataUsingEncoding:NSUTF8StringEncoding];
+    NSURLRequest *request = [self requestForKey:@"key"];
+
+    [responseCache storeResponse:[self responseForRequest:request statusCode:200 headers:@{}] data:body forRequest:request];
+    XCTAssertNil([responseCache cachedResponseForRequest:request]);
+
+    [responseCache storeResponse:[self responseForRequest:request statusCode:200 headers:@{@"ETag" : @"\"1\"", @"Cache-Control" : @"no-store"}]
+                            data:body
+                      forRequest:request];
+    XCTAssertNil([responseCache cachedResponseForRequest:request]);
+
+    [responseCache storeResponse:[self responseForRequest:request statusCode:200 headers:@{@"Last-Modified" : @"Wed, 12 Oct 2022 17:50:00 GMT"}]
+                            data:body
+                      forRequest:request];
+    XCTAssertNotNil([responseCache cachedResponseForRequest:request]);
+    NSMutableURLRequest *conditionalRequest = [self requestForKey:@"key"];
+    [responseCache prepareRequest:conditionalRequest];
+    XCTAssertEqualObjects([conditionalRequest valueForHTTPHeaderField:@"If-Modified-Since"], @"Wed, 12 Oct 2022 17:50:00 GMT");
+    XCTAssertNil([conditionalRequest valueForHTTPHeaderField:@"If-None-Match"]);
+
+    // A transient error keeps the cached response, a missing object removes it.
+    [responseCache storeResponse:[self responseForRequest:request statusCode:503 headers:@{}] data:nil forRequest:request];
+    XCTAssertNotNil([responseCache cachedResponseForRequest:request]);
+    [responseCache storeResponse:[self responseForRequest:request statusCode:404 headers:@{}] data:nil forRequest:request];
+    XCTAssertNil([responseCache cachedResponseForRequest:request]);
+
+    NSMutableURLRequest *rangeRequest = [self requestForKey:@"key"];
+    [rangeRequest setValue:@"bytes=0-1" forHTTPHeaderField:@"Range"];
+    XCTAssertFalse([responseCache shouldCacheRequest:rangeRequest]);
+    NSMutableURLRequest *callerConditionalRequest = [self requestForKey:@"key"];
+    [callerConditionalRequest setValue:@"\"1\"" forHTTPHeaderField:@"If-None-Match"];
+    XCTAssertFalse([responseCache shouldCacheRequest:callerConditionalRequest]);
+    NSMutableURLRequest *putRequest = [self requestForKey:@"key"];
+    putRequest.HTTPMethod = @"PUT";
+    XCTAssertFalse([responseCache shouldCacheRequest:putRequest]);
+}
+
+- (void)testMemoryEvictsLeastRecentlyUsed {
+    AWSResponseCache *responseCache = [[AWSResponseCache alloc] initWithMemoryCapacity:3000
+                                                                          diskCapacity:0
+                                                                          directoryURL:nil];
+    NSMutableData *body = [NSMutableData dataWithLength:900];
+    [self getKey:@"a" fromCache:responseCache ETag:@"\"a\"" body:body];
+    [self getKey:@"b" fromCache:responseCache ETag:@"\"b\"" body:body];
+    [self getKey:@"c" fromCache:responseCache ETag:@"\"c\"" body:body];
+    XCTAssertNotNil([responseCache cachedResponseForRequest:[self requestForKey:@"a"]]);
+
+    // "b" is the least recently used.
+    [self getKey:@"d" fromCache:responseCache ETag:@"\"d\"" body:body];
+    XCTAssertNil([responseCache cachedResponseForRequest:[self requestForKey:@"b"]]);
+    XCTAssertNotNil([responseCache cachedResponseForRequest:[self requestForKey:@"a"]]);
+    XCTAssertNotNil([responseCache cachedResponseForRequest:[self requestForKey:@"c"]]);
+    XCTAssertNotNil([responseCache cachedResponseForRequest:[self requestForKey:@"d"]]);
+    XCTAssertLessThanOrEqual(responseCache.currentMemoryUsage, 3000);
+
+    // Larger than the cache.
+    [self getKey:@"e" fromCache:responseCache ETag:@"\"e\"" body:[NSMutableData dataWithLength:4000]];
+    XCTAssertNil([responseCache cachedResponseForRequest:[self requestForKey:@"e"]]);
+    XCTAssertNotNil([responseCache cachedResponseForRequest:[self requestForKey:@"a"]]);
+}
+
+- (void)testDiskPersistsAndEvictsLeastRecentlyUsed {
+    AWSResponseCache *responseCache = [[AWSResponseCache alloc] initWithMemoryCapacity:0
+                                                                          diskCapacity:4 * 1024
+                                                                          directoryURL:self.directoryURL];
+    NSMutableData *body = [NSMutableData dataWithLength:1024];
+    [self getKey:@"a" fromCache:responseCache ETag:@"\"a\"" body:body];
+    [self getKey:@"b" fromCache:responseCache ETag:@"\"b\"" body:body];
+    [self getKey:@"c" fromCache:responseCache ETag:@"\"c\"" body:body];
+    XCTAssertEqualObjects([responseCache cachedResponseForRequest:[self requestForKey:@"a"]].data, body);
+    XCTAssertGreaterThan(responseCache.currentDiskUsage, 3 * 1024);
+    XCTAssertEqual(responseCache.currentMemoryUsage, 0);
+
+    // Another instance, e.g. after a relaunch, finds the responses.
+    responseCache = [[AWSResponseCache alloc] initWithMemoryCapacity:0
+                                                        diskCapacity:4 * 1024
+                                                        directoryURL:self.directoryURL];
+    XCTAssertEqualObjects([self getKey:@"c" fromCache:responseCache ETag:@"\"c\"" body:[NSData data]], body);
+    XCTAssertEqual(responseCache.hitCount, 1);
+
+    // "b" is the least recently used.
+    [self getKey:@"d" fromCache:responseCache ETag:@"\"d\"" body:body];
+    XCTAssertNil([responseCache cachedResponseForRequest:[self requestForKey:@"b"]]);
+    XCTAssertNotNil([responseCache cachedResponseForRequest:[self requestForKey:@"a"]]);
+    XCTAssertNotNil([responseCache cachedResponseForRequest:[self requestForKey:@"d"]]);
+    XCTAssertLessThanOrEqual(responseCache.currentDiskUsage, 4 * 1024);
+
+    [responseCache removeAllCachedResponses];
+    XCTAssertNil([responseCache cachedResponseForRequest:[self requestForKey:@"a"]]);
+    XCTAssertEqual(responseCache.currentDiskUsage, 0);
+    [self getKey:@"a" fromCache:responseCache ETag:@"\"a\"" body:body];
+    XCTAssertNotNil([responseCache cachedResponseForRequest:[self requestForKey:@"a"]]);
+}
+
+@end
@@ -0,0 +1,155 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSCore.h"
+
+// The previous implementation, serializing every access on a private queue, as a baseline for the benchmark.
+@interface AWSSerialQueueMutableDictionary : NSObject
+
+@property (nonatomic, strong) NSMutableDictionary *dictionary;
+@property (nonatomic, strong) dispatch_queue_t dispatchQueue;
+
+@end
+
+@implementation AWSSerialQueueMutableDictionary
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _dictionary = [NSMutableDictionary new];
+        _dispatchQueue = dispatch_queue_create("com.amazonaws.AWSSerialQueueMutableDictionary", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (id)objectForKey:(id)aKey {
+    __block id returnObject = nil;
+    dispatch_sync(self.dispatchQueue, ^{
+        returnObject = [self.dictionary objectForKey:aKey];
+    });
+    return returnObject;
+}
+
+- (void)removeObjectForKey:(id)aKey {
+    dispatch_sync(self.dispatchQueue, ^{
+        [self.dictionary removeObjectForKey:aKey];
+    });
+}
+
+- (void)setObject:(id)anObject forKey:(id <NSCopying>)aKey {
+    dispatch_sync(self.dispatchQueue, ^{
+        [self.dictionary setObject:anObject forKey:aKey];
+    });
+}
+
+@end
+
+@interface AWSSynchronizedMutableDictionaryTests : XCTestCase
+
+@end
+
+@implementation AWSSynchronizedMutableDictionaryTests
+
+- (void)testBasicOperations {
+    AWSSynchronizedMutableDictionary *dictionary = [AWSSynchronizedMutableDictionary new];
+    NSMutableString *key = [NSMutableString stringWithString:@"key"];
+    [dictionary setObject:@"value" forKey:key];
+    // Keys are copied.
+    [key appendString:@"-modified"];
+    XCTAssertEqualObjects([dictionary objectForKey:@"key"], @"value");
+    XCTAssertNil([dictionary objectForKey:key]);
+    XCTAssertNil([dictionary objectForKey:nil]);
+
+    for (NSUInteger i = 0; i < 100; i++) {
+        [dictionary setObject:@(i * 2) forKey:@(i)];
+    }
+    XCTAssertEqual([dictionary count], 101);
+    XCTAssertEqual([[dictionary allKeys] count], 101);
+    XCTAssertEqual([[dictionary allValues] count], 101);
+    XCTAssertEqualObjects([dictionary objectForKey:@(42)], @84);
+
+    [dictionary removeObjectForKey:@(42)];
+    XCTAssertNil([dictionary objectForKey:@(42)]);
+
+    id value = [dictionary objectForKey:@"key"];
+    [dictionary removeObject:value];
+    XCTAssertNil([dictionary objectForKey:@"key"]);
+    XCTAssertEqual([dictionary count], 99);
+
+    XCTAssertThrows([dictionary setObject:nil forKey:@"key"]);
+}
+
+- (void)testConcurrentAccess {
+    AWSSynchronizedMutableDictionary *dictionary = [AWSSynchronizedMutableDictionary new];
+    dispatch_apply(64, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration) {
+        for (NSUInteger i = 0; i < 1000; i++) {
+            NSNumber *key = @(iteration * 1000 + i);
+            [dictionary setObject:key forKey:key];
+            XCTAssertEqualObjects([dictionary objectForKey:key], key);
+            if (i % 2 == 0) {
+                [dictionary removeObjectForKey:key];
+            }
+        }
+    });
+    XCTAssertEqual([dictionary count], 64 * 500);
+    for (NSNumber *key in [dictionary allKeys]) {
+        XCTAssertEqual([key unsignedIntegerValue] % 2, 1);
+    }
+}
+
+#pragma mark - Benchmark
+
+/**
+ Replays the access pattern of `AWSURLSessionManager`: each task registers its delegate, looks it up on every data
+ callback and removes it on completion.
+ */
+- (NSTimeInterval)runTasks:(NSUInteger)taskCount onDictionary:(id)dictionary {
+    NSUInteger const operations = 1 << 20;
+    NSUInteger const callbacksPerTask = 64;
+    NSUInteger const operationsPerTask = operations / taskCount;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    dispatch_apply(taskCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t task) {
+        NSObject *delegate = [NSObject new];
+        for (NSUInteger i = 0; i < operationsPerTask; i += callbacksPerTask) {
+            NSNumber *taskIdentifier = @(task * operationsPerTask + i);
+            [dictionary setObject:delegate forKey:taskIdentifier];
+            for (NSUInteger callback = 0; callback < callbacksPerTask - 2; callback++) {
+                [dictionary objectForKey:taskIdentifier];
+            }
+            [dictionary removeObjectForKey:taskIdentifier];
+        }
+    });
+    return CFAbsoluteTimeGetCurrent() - start;
+}
+
+- (void)testContentionBenchmark {
+    for (NSNumber *taskCount in @[@1, @8, @64]) {
+        NSTimeInterval serialQueue = [self runTasks:[taskCount unsignedIntegerValue] onDictionary:[AWSSerialQueueMutableDictionary new]];
+        NSTimeInterval sharded = [self runTasks:[taskCount unsignedIntegerValue] onDictionary:[AWSSynchronizedMutableDictionary new]];
+        NSLog(@"%@ concurrent tasks: serial queue %.0f ns/op, sharded %.0f ns/op (%.1fx)",
+              taskCount,
+              serialQueue * 1e9 / (1 << 20),
+              sharded * 1e9 / (1 << 20),
+              serialQueue / sharded);
+    }
+}
+
+- (void)testPerformanceObjectForKey64Tasks {
+    [self measureBlock:^{
+        [self runTasks:64 onDictionary:[AWSSynchronizedMutableDictionary new]];
+    }];
+}
+
+@end
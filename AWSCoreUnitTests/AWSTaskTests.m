@@ -0,0 +1,256 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <malloc/malloc.h>
+#import "AWSCore.h"
+
+@interface AWSTaskTests : XCTestCase
+
+@end
+
+@implementation AWSTaskTests
+
+- (void)testCompletedTasks {
+    AWSTask *task = [AWSTask taskWithResult:@"result"];
+    XCTAssertTrue(task.completed);
+    XCTAssertFalse(task.faulted);
+    XCTAssertFalse(task.cancelled);
+    XCTAssertEqualObjects(task.result, @"result");
+    XCTAssertNil(task.error);
+
+    NSError *error = [NSError errorWithDomain:@"domain" code:1 userInfo:nil];
+    task = [AWSTask taskWithError:error];
+    XCTAssertTrue(task.completed);
+    XCTAssertTrue(task.faulted);
+    XCTAssertEqual(task.error, error);
+    XCTAssertNil(task.result);
+
+    task = [AWSTask cancelledTask];
+    XCTAssertTrue(task.completed);
+    XCTAssertTrue(task.cancelled);
+    XCTAssertFalse(task.faulted);
+}
+
+- (void)testCompletesOnce {
+    AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+    XCTAssertFalse(taskCompletionSource.task.completed);
+    XCTAssertTrue([taskCompletionSource trySetResult:@1]);
+    XCTAssertFalse([taskCompletionSource trySetResult:@2]);
+    XCTAssertFalse([taskCompletionSource trySetError:[NSError errorWithDomain:@"domain" code:1 userInfo:nil]]);
+    XCTAssertFalse([taskCompletionSource trySetCancelled]);
+    XCTAssertThrows([taskCompletionSource cancel]);
+    XCTAssertEqualObjects(taskCompletionSource.task.result, @1);
+    XCTAssertFalse(taskCompletionSource.task.faulted);
+}
+
+- (void)testContinuationsRunInOrder {
+    AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+    NSMutableArray *order = [NSMutableArray new];
+    for (NSUInteger i = 0; i < 5; i++) {
+        [taskCompletionSource.task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *task) {
+            [order addObject:@(i)];
+            return nil;
+        }];
+    }
+    XCTAssertEqual([order count], 0);
+    taskCompletionSource.result = nil;
+    XCTAssertEqualObjects(order, (@[@0, @1, @2, @3, @4]));
+
+    // Continuations added after completion run right away.
+    [taskCompletionSource.task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *task) {
+        [order addObject:@5];
+        return nil;
+    }];
+    XCTAssertEqual([order count], 6);
+}
+
+- (void)testSuccessBlock {
+    NSError *error = [NSError errorWithDomain:@"domain" code:1 userInfo:nil];
+    __block BOOL ran = NO;
+    AWSTask *task = [[AWSTask taskWithError:error] continueWithSuccessBlock:^id(AWSTask *task) {
+        ran = YES;
+        return nil;
+    }];
+    XCTAssertFalse(ran);
+    XCTAssertEqual(task.error, error);
+
+    task = [[AWSTask cancelledTask] continueWithSuccessBlock:^id(AWSTask *task) {
+        ran = YES;
+        return nil;
+    }];
+    XCTAssertFalse(ran);
+    XCTAssertTrue(task.cancelled);
+
+    task = [[AWSTask taskWithResult:@1] continueWithSuccessBlock:^id(AWSTask *task) {
+        return @([task.result integerValue] + 1);
+    }];
+    XCTAssertEqualObjects(task.result, @2);
+
+    AWSCancellationTokenSource *cancellationTokenSource = [AWSCancellationTokenSource cancellationTokenSource];
+    [cancellationTokenSource cancel];
+    task = [[AWSTask taskWithResult:@1] continueWithSuccessBlock:^id(AWSTask *task) {
+        ran = YES;
+        return nil;
+    } cancellationToken:cancellationTokenSource.token];
+    XCTAssertFalse(ran);
+    XCTAssertTrue(task.cancelled);
+}
+
+- (void)testReturnedTaskIsForwarded {
+    AWSTaskCompletionSource *inner = [AWSTaskCompletionSource taskCompletionSource];
+    AWSTask *task = [[AWSTask taskWithResult:nil] continueWithBlock:^id(AWSTask *task) {
+        return inner.task;
+    }];
+    XCTAssertFalse(task.completed);
+    NSError *error = [NSError errorWithDomain:@"domain" code:1 userInfo:nil];
+    inner.error = error;
+    [task waitUntilFinished];
+    XCTAssertEqual(task.error, error);
+
+    task = [[AWSTask taskWithResult:nil] continueWithBlock:^id(AWSTask *task) {
+        return [AWSTask taskWithResult:@"result"];
+    }];
+    XCTAssertEqualObjects(task.result, @"result");
+}
+
+- (void)testConcurrentContinuationsAndCompletion {
+    for (NSUInteger iteration = 0; iteration < 100; iteration++) {
+        AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+        __block int32_t count = 0;
+        NSObject *lock = [NSObject new];
+        dispatch_apply(16, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+            if (i == 8) {
+                [taskCompletionSource trySetResult:@(i)];
+            }
+            [taskCompletionSource.task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *task) {
+                XCTAssertTrue(task.completed);
+                XCTAssertEqualObjects(task.result, @8);
+                @synchronized(lock) {
+                    count++;
+                }
+                return nil;
+            }];
+        });
+        XCTAssertEqual(count, 16);
+    }
+}
+
+- (void)testWaitUntilFinished {
+    AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"The waiting threads return."];
+    expectation.expectedFulfillmentCount = 4;
+    for (NSUInteger i = 0; i < 4; i++) {
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [taskCompletionSource.task waitUntilFinished];
+            XCTAssertEqualObjects(taskCompletionSource.task.result, @"result");
+            [expectation fulfill];
+        });
+    }
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        taskCompletionSource.result = @"result";
+    });
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testLongChainDoesNotOverflowStack {
+    AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+    AWSTask *task = taskCompletionSource.task;
+    for (NSUInteger i = 0; i < 100000; i++) {
+        task = [task continueWithBlock:^id(AWSTask *task) {
+            return @([task.result integerValue] + 1);
+        }];
+    }
+    taskCompletionSource.result = @0;
+    [task waitUntilFinished];
+    XCTAssertEqualObjects(task.result, @100000);
+}
+
+#pragma mark - Benchmark
+
+static size_t AWSTaskTestsBlocksInUse(void) {
+    malloc_statistics_t statistics;
+    malloc_zone_statistics(NULL, &statistics);
+    return statistics.blocks_in_use;
+}
+
+/**
+ Continuations added to a pending task, as an SDK call does while its request is in flight, then run when it completes:
+ the heap blocks each pending continuation holds, and how many continuations run per second.
+ */
+- (void)testContinuationBenchmark {
+    NSUInteger const count = 100000;
+    for (NSNumber *successOnly in @[@NO, @YES]) {
+        @autoreleasepool {
+            AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+            NSMutableArray<AWSTask *> *tasks = [NSMutableArray arrayWithCapacity:count];
+
+            size_t blocksInUse = AWSTaskTestsBlocksInUse();
+            CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+            for (NSUInteger i = 0; i < count; i++) {
+                AWSTask *task = nil;
+                if ([successOnly boolValue]) {
+                    task = [taskCompletionSource.task continueWithSuccessBlock:^id(AWSTask *task) {
+                        return nil;
+                    }];
+                } else {
+                    task = [taskCompletionSource.task continueWithBlock:^id(AWSTask *task) {
+                        return nil;
+                    }];
+                }
+                [tasks addObject:task];
+            }
+            NSTimeInterval add = CFAbsoluteTimeGetCurrent() - start;
+            double blocksPerContinuation = (double)(AWSTaskTestsBlocksInUse() - blocksInUse) / count;
+
+            start = CFAbsoluteTimeGetCurrent();
+            taskCompletionSource.result = nil;
+            NSTimeInterval run = CFAbsoluteTimeGetCurrent() - start;
+            XCTAssertTrue([tasks lastObject].completed);
+
+            NSLog(@"%@: add %.0f ns, run %.0f ns per continuation, %.1f heap blocks per pending continuation",
+                  [successOnly boolValue] ? @"continueWithSuccessBlock:" : @"continueWithBlock:",
+                  add * 1e9 / count,
+                  run * 1e9 / count,
+                  blocksPerContinuation);
+        }
+    }
+
+    // Continuations of completed tasks, which run right away.
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    AWSTask *task = [AWSTask taskWithResult:@0];
+    for (NSUInteger i = 0; i < count; i++) {
+        task = [task continueWithSuccessBlock:^id(AWSTask *task) {
+            return task.result;
+        }];
+    }
+    NSLog(@"Chain of completed tasks: %.0f ns per continuation", (CFAbsoluteTimeGetCurrent() - start) * 1e9 / count);
+}
+
+- (void)testPerformanceContinueWithBlock {
+    [self measureBlock:^{
+        AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+        AWSTask *task = taskCompletionSource.task;
+        for (NSUInteger i = 0; i < 10000; i++) {
+            task = [task continueWithBlock:^id(AWSTask *task) {
+                return nil;
+            }];
+        }
+        taskCompletionSource.result = nil;
+        [task waitUntilFinished];
+    }];
+}
+
+@end
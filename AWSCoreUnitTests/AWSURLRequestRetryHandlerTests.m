@@ -0,0 +1,341 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSCore.h"
+
+// Outcomes of simulated attempts.
+static NSInteger const AWSRetrySimulationSuccess = 200;
+static NSInteger const AWSRetrySimulationThrottled = 429;
+static NSInteger const AWSRetrySimulationTimeout = -1;
+
+// Time a simulated attempt takes on the network.
+static NSTimeInterval const AWSRetrySimulationLatency = 0.05;
+
+// Uses a quota and a rate limiter owned by the test, driven by the simulated clock.
+@interface AWSRetrySimulationHandler : AWSURLRequestRetryHandler
+
+@property (nonatomic, strong) AWSRetryQuota *quota;
+@property (nonatomic, strong) AWSClientRateLimiter *rateLimiter;
+
+@end
+
+@implementation AWSRetrySimulationHandler
+
+- (AWSRetryQuota *)retryQuotaForHost:(NSString *)host {
+    return self.quota;
+}
+
+- (AWSClientRateLimiter *)rateLimiterForHost:(NSString *)host {
+    return self.rateLimiter;
+}
+
+@end
+
+@interface AWSRetrySimulationResult : NSObject
+
+@property (nonatomic, assign) BOOL succeeded;
+@property (nonatomic, assign) uint32_t attempts;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *retryDelays;
+@property (nonatomic, assign) NSTimeInterval rateLimitDelay;
+
+@end
+
+@implementation AWSRetrySimulationResult
+
+@end
+
+@interface AWSURLRequestRetryHandlerTests : XCTestCase
+
+@property (nonatomic, assign) NSTimeInterval now;
+@property (nonatomic, strong) AWSRetrySimulationHandler *handler;
+
+@end
+
+@implementation AWSURLRequestRetryHandlerTests
+
+- (void)setUp {
+    [super setUp];
+    self.now = 1000;
+    self.handler = [self handlerWithSeed:42];
+}
+
+// A handler with a seeded random generator and its own quota and rate limiter on the simulated clock.
+- (AWSRetrySimulationHandler *)handlerWithSeed:(uint64_t)seed {
+    AWSRetrySimulationHandler *handler = [[AWSRetrySimulationHandler alloc] initWithMaximumRetryCount:3];
+    __block uint64_t state = seed;
+    handler.randomGenerator = ^double{
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (state >> 11) * (1.0 / 9007199254740992.0);
+    };
+    handler.quota = [[AWSRetryQuota alloc] initWithCapacity:500];
+    __weak AWSURLRequestRetryHandlerTests *weakSelf = self;
+    handler.rateLimiter = [[AWSClientRateLimiter alloc] initWithClock:^NSTimeInterval{
+        return weakSelf.now;
+    }];
+    return handler;
+}
+
+- (AWSNetworkingRequest *)requestWithRetryMode:(AWSNetworkingRetryMode)retryMode {
+    AWSNetworkingRequest *request = [AWSNetworkingRequest new];
+    request.baseURL = [NSURL URLWithString:@"https://dynamodb.us-east-1.amazonaws.com"];
+    request.retryMode = retryMode;
+    return request;
+}
+
+/**
+ Replays `outcomes` for one request the way `AWSURLSessionManager` drives the retry handler, advancing the simulated
+ clock by the network latency and by every delay the handler asks for.
+ */
+- (AWSRetrySimulationResult *)simulateRequest:(AWSNetworkingRequest *)request
+                                     outcomes:(NSEnumerator<NSNumber *> *)outcomes {
+    AWSURLRequestRetryHandler *handler = self.handler;
+    AWSRetrySimulationResult *result = [AWSRetrySimulationResult new];
+    result.retryDelays = [NSMutableArray new];
+
+    uint32_t retryCount = 0;
+    while (YES) {
+        NSTimeInterval delay = [handler timeIntervalBeforeAttempt:retryCount originalRequest:request];
+        result.rateLimitDelay += delay;
+        self.now += delay + AWSRetrySimulationLatency;
+        result.attempts++;
+
+        NSInteger outcome = [[outcomes nextObject] integerValue] ?: AWSRetrySimulationSuccess;
+        NSHTTPURLResponse *response = nil;
+        NSError *error = nil;
+        if (outcome == AWSRetrySimulationTimeout) {
+            error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil];
+        } else {
+            response = [[NSHTTPURLResponse alloc] initWithURL:request.baseURL
+                                                   statusCode:outcome
+                                                  HTTPVersion:@"HTTP/1.1"
+                                                 headerFields:@{}];
+            if (outcome == AWSRetrySimulationThrottled) {
+                error = [NSError errorWithDomain:AWSServiceErrorDomain code:AWSServiceErrorThrottlingException userInfo:nil];
+            } else if (outcome != AWSRetrySimulationSuccess) {
+                error = [NSError errorWithDomain:AWSServiceErrorDomain code:AWSServiceErrorUnknown userInfo:nil];
+            }
+        }
+
+        [handler attempt:retryCount didCompleteForRequest:request response:response error:error];
+        if (!error) {
+            result.succeeded = YES;
+            return result;
+        }
+
+        AWSNetworkingRetryType retryType = [handler shouldRetry:retryCount
+                                                originalRequest:request
+                                                       response:response
+                                                           data:nil
+                                                          error:error];
+        if (retryType == AWSNetworkingRetryTypeShouldNotRetry
+            || ![handler acquireRetry:retryCount originalRequest:request error:error]) {
+            return result;
+        }
+
+        NSTimeInterval retryDelay = [handler timeIntervalForRetry:retryCount
+                                                  originalRequest:request
+                                                         response:response
+                                                             data:nil
+                                                            error:error];
+        [result.retryDelays addObject:@(retryDelay)];
+        self.now += retryDelay;
+        retryCount++;
+    }
+}
+
+- (AWSRetrySimulationResult *)simulateRetryMode:(AWSNetworkingRetryMode)retryMode outcomes:(NSArray<NSNumber *> *)outcomes {
+    return [self simulateRequest:[self requestWithRetryMode:retryMode] outcomes:[outcomes objectEnumerator]];
+}
+
+#pragma mark - Backoff
+
+- (void)testLegacyModeIsUnchanged {
+    AWSRetrySimulationResult *result = [self simulateRetryMode:AWSNetworkingRetryModeLegacy
+                                                      outcomes:@[@503, @503, @503, @503]];
+    XCTAssertFalse(result.succeeded);
+    XCTAssertEqual(result.attempts, 4);
+    XCTAssertEqualObjects(result.retryDelays, (@[@0.1, @0.2, @0.4]));
+    XCTAssertEqual(self.handler.quota.availableTokens, 500);
+    XCTAssertFalse(self.handler.rateLimiter.isEnabled);
+}
+
+- (void)testFullJitterIsBoundedAndReproducible {
+    AWSRetrySimulationResult *result = [self simulateRetryMode:AWSNetworkingRetryModeStandard
+                                                      outcomes:@[@503, @503, @503, @200]];
+    XCTAssertTrue(result.succeeded);
+    XCTAssertEqual(result.retryDelays.count, 3);
+    for (NSUInteger i = 0; i < result.retryDelays.count; i++) {
+        XCTAssertGreaterThanOrEqual([result.retryDelays[i] doubleValue], 0);
+        XCTAssertLessThan([result.retryDelays[i] doubleValue], 0.1 * pow(2, i));
+    }
+
+    self.handler = [self handlerWithSeed:42];
+    AWSRetrySimulationResult *replay = [self simulateRetryMode:AWSNetworkingRetryModeStandard
+                                                      outcomes:@[@503, @503, @503, @200]];
+    XCTAssertEqualObjects(replay.retryDelays, result.retryDelays);
+}
+
+- (void)testDecorrelatedJitterIsBounded {
+    self.handler.backoffStrategy = AWSRetryBackoffStrategyDecorrelatedJitter;
+    self.handler.maxRetryCount = 10;
+    self.handler.maximumBackoff = 2;
+    AWSRetrySimulationResult *result = [self simulateRetryMode:AWSNetworkingRetryModeStandard
+                                                      outcomes:@[@503, @503, @503, @503, @503, @503, @503, @503, @503, @503]];
+    XCTAssertEqual(result.retryDelays.count, 10);
+    NSTimeInterval previousDelay = 0.1;
+    for (NSNumber *delay in result.retryDelays) {
+        XCTAssertGreaterThanOrEqual([delay doubleValue], 0.1);
+        XCTAssertLessThanOrEqual([delay doubleValue], MIN(2, previousDelay * 3));
+        previousDelay = [delay doubleValue];
+    }
+}
+
+- (void)testRetriesAfterAnOutageAreSpreadOut {
+    // 100 requests fail together once and retry.
+    NSMutableArray<NSNumber *> *legacyDelays = [NSMutableArray new];
+    NSMutableArray<NSNumber *> *standardDelays = [NSMutableArray new];
+    for (NSUInteger i = 0; i < 100; i++) {
+        [legacyDelays addObject:[self simulateRetryMode:AWSNetworkingRetryModeLegacy outcomes:@[@503, @200]].retryDelays[0]];
+        [standardDelays addObject:[self simulateRetryMode:AWSNetworkingRetryModeStandard outcomes:@[@503, @200]].retryDelays[0]];
+    }
+    XCTAssertEqual([[NSSet setWithArray:legacyDelays] count], 1);
+    XCTAssertGreaterThan([[NSSet setWithArray:standardDelays] count], 95);
+}
+
+#pragma mark - Retry quota
+
+- (void)testRetryQuotaStopsRetryStorm {
+    // Every attempt fails: 500 tokens pay for 100 retries, after which requests fail on their first attempt.
+    NSUInteger retries = 0;
+    for (NSUInteger i = 0; i < 50; i++) {
+        AWSRetrySimulationResult *result = [self simulateRetryMode:AWSNetworkingRetryModeStandard
+                                                          outcomes:@[@503, @503, @503, @503]];
+        XCTAssertFalse(result.succeeded);
+        retries += result.retryDelays.count;
+    }
+    XCTAssertEqual(retries, 100);
+    XCTAssertEqual(self.handler.quota.availableTokens, 0);
+
+    AWSRetrySimulationResult *result = [self simulateRetryMode:AWSNetworkingRetryModeStandard outcomes:@[@503, @200]];
+    XCTAssertFalse(result.succeeded);
+    XCTAssertEqual(result.attempts, 1);
+
+    // Successful requests refill the bucket, one token each.
+    for (NSUInteger i = 0; i < 5; i++) {
+        XCTAssertTrue([self simulateRetryMode:AWSNetworkingRetryModeStandard outcomes:@[@200]].succeeded);
+    }
+    XCTAssertEqual(self.handler.quota.availableTokens, 5);
+    result = [self simulateRetryMode:AWSNetworkingRetryModeStandard outcomes:@[@503, @200]];
+    XCTAssertTrue(result.succeeded);
+    // The retry that succeeded gave its tokens back.
+    XCTAssertEqual(self.handler.quota.availableTokens, 5);
+}
+
+- (void)testTimeoutsCostMoreRetryTokens {
+    AWSRetrySimulationResult *result = [self simulateRetryMode:AWSNetworkingRetryModeStandard
+                                                      outcomes:@[@(AWSRetrySimulationTimeout), @503, @(AWSRetrySimulationTimeout), @503]];
+    XCTAssertFalse(result.succeeded);
+    XCTAssertEqual(self.handler.quota.availableTokens, 500 - 10 - 5 - 10);
+}
+
+#pragma mark - Adaptive rate limiting
+
+- (void)testAdaptiveRateLimiterBacksOffAndRecovers {
+    AWSClientRateLimiter *rateLimiter = self.handler.rateLimiter;
+
+    // 20 requests per second succeed, and nothing is limited.
+    NSTimeInterval rateLimitDelay = 0;
+    for (NSUInteger i = 0; i < 200; i++) {
+        rateLimitDelay += [self simulateRetryMode:AWSNetworkingRetryModeAdaptive outcomes:@[@200]].rateLimitDelay;
+    }
+    XCTAssertEqual(rateLimitDelay, 0);
+    XCTAssertFalse(rateLimiter.isEnabled);
+    XCTAssertEqualWithAccuracy(rateLimiter.measuredSendRate, 20, 2.5);
+
+    // A throttling error cuts the allowed rate to 70% of the measured rate.
+    AWSRetrySimulationResult *result = [self simulateRetryMode:AWSNetworkingRetryModeAdaptive outcomes:@[@429, @200]];
+    XCTAssertTrue(result.succeeded);
+    XCTAssertTrue(rateLimiter.isEnabled);
+    double throttledRate = rateLimiter.fillRate;
+    XCTAssertLessThan(throttledRate, 16);
+    XCTAssertGreaterThan(throttledRate, 12);
+
+    // Requests are now held back to the allowed rate.
+    NSTimeInterval start = self.now;
+    rateLimitDelay = 0;
+    for (NSUInteger i = 0; i < 40; i++) {
+        rateLimitDelay += [self simulateRetryMode:AWSNetworkingRetryModeAdaptive outcomes:@[@200]].rateLimitDelay;
+    }
+    XCTAssertGreaterThan(rateLimitDelay, 0);
+    XCTAssertGreaterThan(self.now - start, 40 * AWSRetrySimulationLatency);
+
+    // Without more throttling the rate climbs back past the rate that was throttled.
+    for (NSUInteger i = 0; i < 200; i++) {
+        [self simulateRetryMode:AWSNetworkingRetryModeAdaptive outcomes:@[@200]];
+    }
+    XCTAssertGreaterThan(rateLimiter.fillRate, throttledRate);
+}
+
+- (void)testAdaptiveRateLimiterReservesTokens {
+    AWSClientRateLimiter *rateLimiter = self.handler.rateLimiter;
+    for (NSUInteger i = 0; i < 20; i++) {
+        [rateLimiter updateWithThrottlingResponse:NO];
+        self.now += 0.1;
+    }
+    [rateLimiter updateWithThrottlingResponse:YES];
+    double fillRate = rateLimiter.fillRate;
+
+    // Once the bucket is empty, concurrent callers at the same instant are spaced out by one token each.
+    NSTimeInterval first = [rateLimiter acquireToken];
+    while (first == 0) {
+        first = [rateLimiter acquireToken];
+    }
+    NSTimeInterval second = [rateLimiter acquireToken];
+    NSTimeInterval third = [rateLimiter acquireToken];
+    XCTAssertEqualWithAccuracy(second - first, 1 / fillRate, 1e-9);
+    XCTAssertEqualWithAccuracy(third - second, 1 / fillRate, 1e-9);
+}
+
+- (void)testThrottlingErrorDetection {
+    AWSURLRequestRetryHandler *handler = [[AWSURLRequestRetryHandler alloc] initWithMaximumRetryCount:3];
+    XCTAssertTrue([handler isThrottlingError:[NSError errorWithDomain:AWSServiceErrorDomain code:AWSServiceErrorThrottling userInfo:nil] response:nil]);
+    XCTAssertTrue([handler isThrottlingError:[NSError errorWithDomain:@"com.amazonaws.AWSDynamoDBErrorDomain"
+                                                                 code:1
+                                                             userInfo:@{@"__type" : @"com.amazonaws.dynamodb.v20120810#ProvisionedThroughputExceededException"}]
+                                    response:nil]);
+    XCTAssertTrue([handler isThrottlingError:[NSError errorWithDomain:@"com.amazonaws.AWSS3ErrorDomain"
+                                                                 code:0
+                                                             userInfo:@{@"Error" : @{@"Code" : @"SlowDown"}}]
+                                    response:nil]);
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://example.com"]
+                                                              statusCode:429
+                                                             HTTPVersion:@"HTTP/1.1"
+                                                            headerFields:@{}];
+    XCTAssertTrue([handler isThrottlingError:nil response:response]);
+    XCTAssertFalse([handler isThrottlingError:[NSError errorWithDomain:AWSServiceErrorDomain code:AWSServiceErrorUnknown userInfo:nil] response:nil]);
+}
+
+- (void)testRetryModeIsAssignedFromConfiguration {
+    AWSNetworkingConfiguration *configuration = [AWSNetworkingConfiguration new];
+    configuration.retryMode = AWSNetworkingRetryModeAdaptive;
+    XCTAssertEqual([configuration copy].retryMode, AWSNetworkingRetryModeAdaptive);
+
+    AWSNetworkingRequest *request = [AWSNetworkingRequest new];
+    [request assignProperties:configuration];
+    XCTAssertEqual(request.retryMode, AWSNetworkingRetryModeAdaptive);
+}
+
+@end
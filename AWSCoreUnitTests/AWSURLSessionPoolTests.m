@@ -0,0 +1,288 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <arpa/inet.h>
+#import <netinet/in.h>
+#import <sys/socket.h>
+#import "AWSCore.h"
+
+/**
+ A keep-alive HTTP/1.1 server on the loopback interface standing in for a service endpoint. Each new connection waits
+ `handshakeDelay` before its first response, the cost of DNS, TCP and TLS to a remote endpoint, which is what pooling
+ and prewarming save.
+ */
+@interface AWSURLSessionPoolTestsServer : NSObject
+
+@property (nonatomic, assign) NSTimeInterval handshakeDelay;
+@property (nonatomic, assign) NSTimeInterval responseDelay;
+@property (nonatomic, readonly) uint16_t port;
+@property (atomic, assign) NSUInteger connectionCount;
+@property (atomic, assign) NSUInteger openConnectionCount;
+@property (atomic, assign) NSUInteger maximumOpenConnectionCount;
+
+@property (nonatomic, assign) int listeningSocket;
+@property (nonatomic, strong) NSMutableSet<NSNumber *> *connectionSockets;
+
+@end
+
+@implementation AWSURLSessionPoolTestsServer
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _connectionSockets = [NSMutableSet new];
+    }
+    return self;
+}
+
+- (BOOL)start {
+    self.listeningSocket = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {0};
+    address.sin_len = sizeof(address);
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    if (bind(self.listeningSocket, (struct sockaddr *)&address, sizeof(address)) != 0
+        || listen(self.listeningSocket, 64) != 0) {
+        return NO;
+    }
+    socklen_t length = sizeof(address);
+    getsockname(self.listeningSocket, (struct sockaddr *)&address, &length);
+    _port = ntohs(address.sin_port);
+
+    int listeningSocket = self.listeningSocket;
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        while (YES) {
+            int connectionSocket = accept(listeningSocket, NULL, NULL);
+            if (connectionSocket < 0) {
+                return;
+            }
+            @synchronized(self) {
+                [self.connectionSockets addObject:@(connectionSocket)];
+                self.connectionCount++;
+                self.openConnectionCount++;
+                self.maximumOpenConnectionCount = MAX(self.maximumOpenConnectionCount, self.openConnectionCount);
+            }
+            dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                [self serveConnection:connectionSocket];
+            });
+        }
+    });
+    return YES;
+}
+
+- (void)serveConnection:(int)connectionSocket {
+    [NSThread sleepForTimeInterval:self.handshakeDelay];
+    NSMutableData *buffer = [NSMutableData new];
+    NSData *headerEnd = [@"\r\n\r\n" dataUsingEncoding:NSUTF8StringEncoding];
+    uint8_t bytes[4096];
+    while (YES) {
+        NSRange range = [buffer rangeOfData:headerEnd options:0 range:NSMakeRange(0, [buffer length])];
+        if (range.location == NSNotFound) {
+            ssize_t length = recv(connectionSocket, bytes, sizeof(bytes), 0);
+            if (length <= 0) {
+                break;
+            }
+            [buffer appendBytes:bytes length:length];
+            continue;
+        }
+        BOOL isHEAD = strncmp([buffer bytes], "HEAD ", 5) == 0;
+        [buffer replaceBytesInRange:NSMakeRange(0, NSMaxRange(range)) withBytes:NULL length:0];
+
+        [NSThread sleepForTimeInterval:self.responseDelay];
+        NSString *response = [NSString stringWithFormat:@"HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: keep-alive\r\n\r\n%@", isHEAD ? @"" : @"ok"];
+        NSData *responseData = [response dataUsingEncoding:NSUTF8StringEncoding];
+        if (send(connectionSocket, [responseData bytes], [responseData length], 0) < 0) {
+            break;
+        }
+    }
+    close(connectionSocket);
+    @synchronized(self) {
+        if ([self.connectionSockets containsObject:@(connectionSocket)]) {
+            [self.connectionSockets removeObject:@(connectionSocket)];
+            self.openConnectionCount--;
+        }
+    }
+}
+
+- (void)stop {
+    close(self.listeningSocket);
+    @synchronized(self) {
+        for (NSNumber *connectionSocket in self.connectionSockets) {
+            shutdown([connectionSocket intValue], SHUT_RDWR);
+        }
+    }
+}
+
+- (NSURL *)URL {
+    return [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%u", self.port]];
+}
+
+@end
+
+@interface AWSURLSessionPoolTests : XCTestCase
+
+@property (nonatomic, strong) AWSURLSessionPoolTestsServer *server;
+
+@end
+
+@implementation AWSURLSessionPoolTests
+
+- (void)setUp {
+    [super setUp];
+    self.server = [AWSURLSessionPoolTestsServer new];
+    self.server.handshakeDelay = 0.1;
+    XCTAssertTrue([self.server start]);
+}
+
+- (void)tearDown {
+    [self.server stop];
+    [super tearDown];
+}
+
+- (AWSNetworkingConfiguration *)configurationWithSessionPool:(AWSURLSessionPool *)sessionPool {
+    AWSNetworkingConfiguration *configuration = [AWSNetworkingConfiguration new];
+    configuration.baseURL = self.server.URL;
+    configuration.sessionPool = sessionPool;
+    configuration.maxRetryCount = 0;
+    return configuration;
+}
+
+- (NSTimeInterval)sendRequestWithNetworking:(AWSNetworking *)networking {
+    AWSNetworkingRequest *request = [AWSNetworkingRequest new];
+    request.HTTPMethod = AWSHTTPMethodGET;
+    request.URLString = @"/object";
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    AWSTask *task = [networking sendRequest:request];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    return CFAbsoluteTimeGetCurrent() - start;
+}
+
+- (void)testClientsOfAPoolShareConnections {
+    AWSURLSessionPool *sessionPool = [AWSURLSessionPool new];
+    NSMutableArray<AWSNetworking *> *clients = [NSMutableArray new];
+    for (NSUInteger i = 0; i < 4; i++) {
+        [clients addObject:[[AWSNetworking alloc] initWithConfiguration:[self configurationWithSessionPool:sessionPool]]];
+    }
+    for (AWSNetworking *client in clients) {
+        [self sendRequestWithNetworking:client];
+    }
+    XCTAssertEqual(self.server.connectionCount, 1);
+    XCTAssertEqual(sessionPool.sessionCount, 1);
+
+    // Different session settings get a different session.
+    AWSNetworkingConfiguration *configuration = [self configurationWithSessionPool:sessionPool];
+    configuration.timeoutIntervalForRequest = 30;
+    [self sendRequestWithNetworking:[[AWSNetworking alloc] initWithConfiguration:configuration]];
+    XCTAssertEqual(sessionPool.sessionCount, 2);
+    XCTAssertEqual(self.server.connectionCount, 2);
+}
+
+- (void)testInvalidatedClientDoesNotInvalidateSharedSession {
+    AWSURLSessionPool *sessionPool = [AWSURLSessionPool new];
+    AWSNetworking *client = [[AWSNetworking alloc] initWithConfiguration:[self configurationWithSessionPool:sessionPool]];
+    [self sendRequestWithNetworking:client];
+    client = nil;
+
+    client = [[AWSNetworking alloc] initWithConfiguration:[self configurationWithSessionPool:sessionPool]];
+    [self sendRequestWithNetworking:client];
+    XCTAssertEqual(self.server.connectionCount, 1);
+}
+
+- (void)testMaximumConnectionsPerHost {
+    self.server.handshakeDelay = 0;
+    self.server.responseDelay = 0.1;
+    AWSNetworkingConfiguration *configuration = [self configurationWithSessionPool:[AWSURLSessionPool new]];
+    configuration.maximumConnectionsPerHost = 2;
+    AWSNetworking *client = [[AWSNetworking alloc] initWithConfiguration:configuration];
+
+    NSMutableArray<AWSTask *> *tasks = [NSMutableArray new];
+    for (NSUInteger i = 0; i < 8; i++) {
+        AWSNetworkingRequest *request = [AWSNetworkingRequest new];
+        request.HTTPMethod = AWSHTTPMethodGET;
+        request.URLString = @"/object";
+        [tasks addObject:[client sendRequest:request]];
+    }
+    [[AWSTask taskForCompletionOfAllTasks:tasks] waitUntilFinished];
+    XCTAssertLessThanOrEqual(self.server.maximumOpenConnectionCount, 2);
+}
+
+- (void)testPrewarmOpensConnectionBeforeFirstRequest {
+    AWSURLSessionPool *sessionPool = [AWSURLSessionPool new];
+    AWSNetworkingConfiguration *configuration = [self configurationWithSessionPool:sessionPool];
+    AWSTask *prewarm = [sessionPool prewarmEndpoints:@[[self.server.URL URLByAppendingPathComponent:@"ignored"]]
+                                       configuration:configuration];
+    [prewarm waitUntilFinished];
+    XCTAssertNil(prewarm.error);
+    XCTAssertEqual(self.server.connectionCount, 1);
+
+    NSTimeInterval firstRequestLatency = [self sendRequestWithNetworking:[[AWSNetworking alloc] initWithConfiguration:configuration]];
+    XCTAssertLessThan(firstRequestLatency, self.server.handshakeDelay);
+    XCTAssertEqual(self.server.connectionCount, 1);
+}
+
+#pragma mark - Benchmark
+
+/**
+ The latency of the first request of each of 4 clients of the same endpoint: with a session each, sharing a pool, and
+ sharing a pool prewarmed before the first request.
+ */
+- (void)testFirstRequestLatencyBenchmark {
+    NSUInteger const clientCount = 4;
+    NSArray<NSString *> *modes = @[@"session per client", @"shared pool", @"prewarmed pool"];
+    for (NSString *mode in modes) {
+        AWSURLSessionPoolTestsServer *server = [AWSURLSessionPoolTestsServer new];
+        server.handshakeDelay = 0.1;
+        XCTAssertTrue([server start]);
+        AWSURLSessionPoolTestsServer *previousServer = self.server;
+        self.server = server;
+
+        AWSURLSessionPool *sessionPool = [mode isEqualToString:@"session per client"] ? nil : [AWSURLSessionPool new];
+        if ([mode isEqualToString:@"prewarmed pool"]) {
+            [[sessionPool prewarmEndpoints:@[server.URL] configuration:[self configurationWithSessionPool:sessionPool]] waitUntilFinished];
+        }
+
+        NSTimeInterval totalLatency = 0;
+        NSTimeInterval maximumLatency = 0;
+        NSMutableArray<AWSNetworking *> *clients = [NSMutableArray new];
+        for (NSUInteger i = 0; i < clientCount; i++) {
+            AWSNetworking *client = [[AWSNetworking alloc] initWithConfiguration:[self configurationWithSessionPool:sessionPool]];
+            [clients addObject:client];
+            NSTimeInterval latency = [self sendRequestWithNetworking:client];
+            totalLatency += latency;
+            maximumLatency = MAX(maximumLatency, latency);
+        }
+        NSLog(@"%@: first request %.1f ms on average, %.1f ms at most, %lu connections",
+              mode,
+              totalLatency * 1000 / clientCount,
+              maximumLatency * 1000,
+              (unsigned long)server.connectionCount);
+
+        if ([mode isEqualToString:@"session per client"]) {
+            XCTAssertEqual(server.connectionCount, clientCount);
+        } else {
+            XCTAssertEqual(server.connectionCount, 1);
+        }
+        if ([mode isEqualToString:@"prewarmed pool"]) {
+            XCTAssertLessThan(maximumLatency, server.handshakeDelay);
+        }
+
+        [server stop];
+        self.server = previousServer;
+    }
+}
+
+@end
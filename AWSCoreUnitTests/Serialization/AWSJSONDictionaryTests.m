@@ -0,0 +1,62 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+@interface AWSJSONDictionaryTests : XCTestCase
+
+@end
+
+@implementation AWSJSONDictionaryTests
+
+- (NSDictionary *)serviceDefinitionRule {
+    return @{@"operations" : @{@"PutThing" : @{@"input" : @{@"shape" : @"PutThingInput"}}},
+             @"shapes" : @{@"PutThingInput" : @{@"type" : @"structure",
+                                                @"metadata" : @{@"locationName" : @"ShapeMetadataName"},
+                                                @"members" : @{@"Things" : @{@"shape" : @"ThingList",
+                                                                             @"locationName" : @"things"}}},
+                           @"ThingList" : @{@"type" : @"list",
+                                            @"member" : @{@"shape" : @"Thing"}},
+                           @"Thing" : @{@"type" : @"string"}}};
+}
+
+- (void)testRulesResolveMemberThenMetadataThenShape {
+    NSDictionary *serviceDefinitionRule = [self serviceDefinitionRule];
+    AWSJSONDictionary *rules = [AWSJSONDictionary rulesForOperation:@"PutThing" ruleType:@"input" serviceDefinitionRule:serviceDefinitionRule];
+
+    XCTAssertEqualObjects(rules[@"type"], @"structure");
+    XCTAssertEqualObjects(rules[@"locationName"], @"ShapeMetadataName");
+    XCTAssertEqualObjects(rules[@"members"][@"Things"][@"locationName"], @"things");
+    XCTAssertEqualObjects(rules[@"members"][@"Things"][@"type"], @"list");
+    XCTAssertEqualObjects(rules[@"members"][@"Things"][@"member"][@"type"], @"string");
+    XCTAssertNil(rules[@"payload"]);
+    XCTAssertEqual([rules count], 1);
+}
+
+- (void)testRulesAreResolvedOncePerOperation {
+    NSDictionary *serviceDefinitionRule = [self serviceDefinitionRule];
+    AWSJSONDictionary *rules = [AWSJSONDictionary rulesForOperation:@"PutThing" ruleType:@"input" serviceDefinitionRule:serviceDefinitionRule];
+    AWSJSONDictionary *cachedRules = [AWSJSONDictionary rulesForOperation:@"PutThing" ruleType:@"input" serviceDefinitionRule:serviceDefinitionRule];
+
+    XCTAssertEqual(rules, cachedRules);
+    XCTAssertEqual(rules[@"members"][@"Things"], cachedRules[@"members"][@"Things"]);
+
+    AWSJSONDictionary *outputRules = [AWSJSONDictionary rulesForOperation:@"PutThing" ruleType:@"output" serviceDefinitionRule:serviceDefinitionRule];
+    XCTAssertNotEqual(rules, outputRules);
+    XCTAssertEqual([outputRules count], 0);
+}
+
+@end
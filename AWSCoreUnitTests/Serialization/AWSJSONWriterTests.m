@@ -0,0 +1,155 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+@interface AWSJSONBuilder (AWSJSONWriterTests)
+
++ (id)buildJSONDictionary:(NSDictionary *)params
+               actionName:(NSString *)actionName
+    serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule
+                    error:(NSError *__autoreleasing *)error;
+
+@end
+
+@interface AWSJSONWriterTests : XCTestCase
+
+@end
+
+@implementation AWSJSONWriterTests
+
+- (NSDictionary *)serviceDefinitionRule {
+    return @{@"operations" : @{@"PutThing" : @{@"input" : @{@"shape" : @"PutThingInput"}},
+                               @"PutPayload" : @{@"input" : @{@"shape" : @"PutPayloadInput"}}},
+             @"shapes" : @{@"PutThingInput" : @{@"type" : @"structure",
+                                                @"members" : @{@"Name" : @{@"shape" : @"String"},
+                                                               @"Data" : @{@"shape" : @"Blob"},
+                                                               @"Enabled" : @{@"shape" : @"Boolean"},
+                                                               @"Count" : @{@"shape" : @"Integer"},
+                                                               @"Ratio" : @{@"shape" : @"Double"},
+                                                               @"CreatedAt" : @{@"shape" : @"Timestamp"},
+                                                               @"Things" : @{@"shape" : @"ThingList", @"locationName" : @"things"},
+                                                               @"Attributes" : @{@"shape" : @"AttributeMap"},
+                                                               @"Token" : @{@"shape" : @"String", @"location" : @"header", @"locationName" : @"x-token"}}},
+                           @"PutPayloadInput" : @{@"type" : @"structure",
+                                                  @"payload" : @"Body",
+                                                  @"members" : @{@"Body" : @{@"shape" : @"Blob"}}},
+                           @"ThingList" : @{@"type" : @"list", @"member" : @{@"shape" : @"Thing"}},
+                           @"Thing" : @{@"type" : @"structure", @"members" : @{@"Id" : @{@"shape" : @"String"}}},
+                           @"AttributeMap" : @{@"type" : @"map", @"key" : @{@"shape" : @"String"}, @"value" : @{@"shape" : @"String"}},
+                           @"String" : @{@"type" : @"string"},
+                           @"Blob" : @{@"type" : @"blob"},
+                           @"Boolean" : @{@"type" : @"boolean"},
+                           @"Integer" : @{@"type" : @"integer"},
+                           @"Double" : @{@"type" : @"double"},
+                           @"Timestamp" : @{@"type" : @"timestamp"}}};
+}
+
+- (NSDictionary *)parameters {
+    return @{@"Name" : @"quote \" backslash \\ newline \n tab \t bell \a unicode é\U0001F600",
+             @"Data" : [@"ab" dataUsingEncoding:NSUTF8StringEncoding],
+             @"Enabled" : @YES,
+             @"Count" : @(-42),
+             @"Ratio" : @(0.25),
+             @"CreatedAt" : [NSDate dateWithTimeIntervalSince1970:1500000000],
+             @"Things" : @[@{@"Id" : @"1"}, @{@"Id" : @"2", @"Unknown" : @"dropped"}],
+             @"Attributes" : @{@"color" : @"blue"},
+             @"Token" : @"sent-as-a-header",
+             @"Unknown" : @"dropped"};
+}
+
+- (void)testWriterMatchesJSONSerializationOfBuiltDictionary {
+    NSDictionary *serviceDefinitionRule = [self serviceDefinitionRule];
+    NSError *error = nil;
+    NSData *data = [AWSJSONBuilder jsonDataForDictionary:[self parameters]
+                                              actionName:@"PutThing"
+                                   serviceDefinitionRule:serviceDefinitionRule
+                                                   error:&error];
+    XCTAssertNil(error);
+
+    NSDictionary *built = [AWSJSONBuilder buildJSONDictionary:[self parameters]
+                                                   actionName:@"PutThing"
+                                        serviceDefinitionRule:serviceDefinitionRule
+                                                        error:&error];
+    XCTAssertNil(error);
+
+    NSDictionary *written = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(written, built);
+    XCTAssertEqualObjects(written[@"Data"], @"YWI=");
+    XCTAssertEqualObjects(written[@"things"], (@[@{@"Id" : @"1"}, @{@"Id" : @"2"}]));
+    XCTAssertNil(written[@"Token"]);
+    XCTAssertNil(written[@"Unknown"]);
+
+    NSString *body = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    XCTAssertTrue([body rangeOfString:@"\"Enabled\":true"].location != NSNotFound);
+    XCTAssertTrue([body rangeOfString:@"\"Count\":-42"].location != NSNotFound);
+    XCTAssertTrue([body rangeOfString:@"\\u0007"].location != NSNotFound);
+}
+
+- (void)testBase64Padding {
+    NSDictionary *serviceDefinitionRule = [self serviceDefinitionRule];
+    AWSJSONDictionary *rules = [AWSJSONDictionary rulesForOperation:@"PutThing" ruleType:@"input" serviceDefinitionRule:serviceDefinitionRule];
+    for (NSString *value in @[@"", @"a", @"ab", @"abc", @"abcd", @"abcde"]) {
+        NSData *blob = [value dataUsingEncoding:NSUTF8StringEncoding];
+        NSData *data = [[AWSJSONWriter writerForCurrentThread] dataForParameters:@{@"Data" : blob} rules:rules error:nil];
+        NSDictionary *written = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+        XCTAssertEqualObjects(written[@"Data"], [blob base64EncodedStringWithOptions:0]);
+    }
+}
+
+- (void)testInvalidParameterFails {
+    NSDictionary *serviceDefinitionRule = [self serviceDefinitionRule];
+    NSError *error = nil;
+    NSData *data = [AWSJSONBuilder jsonDataForDictionary:@{@"Things" : @"not-a-list"}
+                                              actionName:@"PutThing"
+                                   serviceDefinitionRule:serviceDefinitionRule
+                                                   error:&error];
+    XCTAssertNil(data);
+    XCTAssertEqualObjects(error.domain, AWSJSONBuilderErrorDomain);
+    XCTAssertEqual(error.code, AWSJSONBuilderInvalidParameter);
+
+    error = nil;
+    data = [AWSJSONBuilder jsonDataForDictionary:@{@"Name" : @"still-works"}
+                                      actionName:@"PutThing"
+                           serviceDefinitionRule:serviceDefinitionRule
+                                           error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects([[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding], @"{\"Name\":\"still-works\"}");
+}
+
+- (void)testPayloadIsNotWritten {
+    NSData *body = [@"raw body" dataUsingEncoding:NSUTF8StringEncoding];
+    NSError *error = nil;
+    NSData *data = [AWSJSONBuilder jsonDataForDictionary:@{@"Body" : body}
+                                              actionName:@"PutPayload"
+                                   serviceDefinitionRule:[self serviceDefinitionRule]
+                                                   error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(data, body);
+}
+
+- (void)testEmptyParameters {
+    NSError *error = nil;
+    NSData *data = [AWSJSONBuilder jsonDataForDictionary:@{}
+                                              actionName:@"PutThing"
+                                   serviceDefinitionRule:[self serviceDefinitionRule]
+                                                   error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects([[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding], @"{}");
+}
+
+@end
@@ -0,0 +1,149 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+// The generated `*Resources` classes keep their JSON definition behind a private method.
+@interface NSObject (AWSServiceModelCacheTests)
+
+- (NSString *)definitionString;
+
+@end
+
+@interface AWSServiceModelCache()
+
+@property (nonatomic, strong) dispatch_queue_t writeQueue;
+
+@end
+
+@interface AWSServiceModelCacheTests : XCTestCase
+
+@end
+
+@implementation AWSServiceModelCacheTests
+
+- (void)setUp {
+    [super setUp];
+    [[AWSServiceModelCache sharedInstance] removeAllCachedModels];
+}
+
+- (void)tearDown {
+    [[AWSServiceModelCache sharedInstance] removeAllCachedModels];
+    [super tearDown];
+}
+
+- (void)testFingerprintIsStableAndSensitiveToContent {
+    NSString *fingerprint = [AWSServiceModelCache fingerprintForDefinitionString:@"{\"version\":\"2.0\"}"];
+    XCTAssertEqualObjects(fingerprint, [AWSServiceModelCache fingerprintForDefinitionString:@"{\"version\":\"2.0\"}"]);
+    XCTAssertNotEqualObjects(fingerprint, [AWSServiceModelCache fingerprintForDefinitionString:@"{\"version\":\"2.1\"}"]);
+    XCTAssertTrue([fingerprint hasPrefix:AWSiOSSDKVersion]);
+}
+
+- (void)testCompiledModelStripsDocumentationButKeepsMembers {
+    NSDictionary *definition = @{@"documentation" : @"<p>Service</p>",
+                                 @"shapes" : @{@"Shape" : @{@"type" : @"structure",
+                                                            @"documentation" : @"<p>Shape</p>",
+                                                            @"members" : @{@"documentation" : @{@"shape" : @"String",
+                                                                                                @"documentation" : @"<p>Member</p>"}}}}};
+    NSError *error = nil;
+    NSData *data = [AWSServiceModelCache compiledModelDataForDefinition:definition fingerprint:@"fingerprint" error:&error];
+    XCTAssertNil(error);
+
+    NSDictionary *compiled = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(compiled[AWSServiceModelCacheFingerprintKey], @"fingerprint");
+    XCTAssertNil(compiled[@"documentation"]);
+    XCTAssertNil(compiled[@"shapes"][@"Shape"][@"documentation"]);
+    XCTAssertEqualObjects(compiled[@"shapes"][@"Shape"][@"members"][@"documentation"], @{@"shape" : @"String"});
+}
+
+- (void)testServiceDefinitionIsServedFromCacheOnSecondLoad {
+    NSString *definitionString = [[AWSCognitoIdentityResources sharedInstance] definitionString];
+    NSDictionary *parsed = [NSJSONSerialization JSONObjectWithData:[definitionString dataUsingEncoding:NSUTF8StringEncoding] options:0 error:nil];
+
+    AWSServiceModelCache *cache = [AWSServiceModelCache new];
+    NSDictionary *first = [cache serviceDefinitionForName:@"AWSServiceModelCacheTests" definitionString:definitionString bundle:nil];
+    XCTAssertEqualObjects(first, parsed);
+    XCTAssertNil(first[AWSServiceModelCacheFingerprintKey]);
+    [self waitForPendingWrites:cache];
+
+    NSDictionary *second = [cache serviceDefinitionForName:@"AWSServiceModelCacheTests" definitionString:definitionString bundle:nil];
+    XCTAssertEqualObjects(second[AWSServiceModelCacheFingerprintKey], [AWSServiceModelCache fingerprintForDefinitionString:definitionString]);
+    XCTAssertEqualObjects(second[@"metadata"], parsed[@"metadata"]);
+    XCTAssertEqualObjects(second[@"operations"][@"GetId"][@"input"], parsed[@"operations"][@"GetId"][@"input"]);
+}
+
+- (void)testStaleCompiledModelIsIgnored {
+    NSString *definitionString = @"{\"metadata\":{\"protocol\":\"json\"}}";
+    AWSServiceModelCache *cache = [AWSServiceModelCache new];
+    [cache serviceDefinitionForName:@"AWSServiceModelCacheStaleTests" definitionString:definitionString bundle:nil];
+    [self waitForPendingWrites:cache];
+
+    NSString *updatedDefinitionString = @"{\"metadata\":{\"protocol\":\"rest-json\"}}";
+    NSDictionary *definition = [cache serviceDefinitionForName:@"AWSServiceModelCacheStaleTests" definitionString:updatedDefinitionString bundle:nil];
+    XCTAssertEqualObjects(definition[@"metadata"][@"protocol"], @"rest-json");
+    [cache removeAllCachedModels];
+}
+
+- (void)waitForPendingWrites:(AWSServiceModelCache *)cache {
+    dispatch_sync(cache.writeQueue, ^{});
+}
+
+#pragma mark - Startup benchmark
+
+// Only the definitions linked into AWSCore are available here. The S3, IoT, Pinpoint Targeting and DynamoDB
+// definitions are benchmarked in the unit tests of their services.
+- (NSArray<NSString *> *)benchmarkedDefinitionStrings {
+    NSArray<NSString *> *definitionStrings = @[[[AWSCognitoIdentityResources sharedInstance] definitionString],
+                                               [[AWSSTSResources sharedInstance] definitionString]];
+    for (NSString *definitionString in definitionStrings) {
+        XCTAssertGreaterThan(definitionString.length, 0);
+    }
+    return definitionStrings;
+}
+
+- (void)testPerformanceParsingJSONDefinitions {
+    NSArray<NSString *> *definitionStrings = [self benchmarkedDefinitionStrings];
+    [self measureBlock:^{
+        for (NSString *definitionString in definitionStrings) {
+            @autoreleasepool {
+                NSDictionary *definition = [NSJSONSerialization JSONObjectWithData:[definitionString dataUsingEncoding:NSUTF8StringEncoding] options:0 error:nil];
+                XCTAssertNotNil(definition);
+            }
+        }
+    }];
+}
+
+- (void)testPerformanceLoadingCompiledDefinitions {
+    NSArray<NSString *> *definitionStrings = [self benchmarkedDefinitionStrings];
+    AWSServiceModelCache *cache = [AWSServiceModelCache new];
+    [definitionStrings enumerateObjectsUsingBlock:^(NSString *definitionString, NSUInteger idx, BOOL *stop) {
+        [cache serviceDefinitionForName:[NSString stringWithFormat:@"Benchmark%lu", (unsigned long)idx] definitionString:definitionString bundle:nil];
+    }];
+    [self waitForPendingWrites:cache];
+
+    [self measureBlock:^{
+        [definitionStrings enumerateObjectsUsingBlock:^(NSString *definitionString, NSUInteger idx, BOOL *stop) {
+            @autoreleasepool {
+                NSDictionary *definition = [cache serviceDefinitionForName:[NSString stringWithFormat:@"Benchmark%lu", (unsigned long)idx] definitionString:definitionString bundle:nil];
+                XCTAssertNotNil(definition[AWSServiceModelCacheFingerprintKey]);
+            }
+        }];
+    }];
+    [cache removeAllCachedModels];
+}
+
+@end
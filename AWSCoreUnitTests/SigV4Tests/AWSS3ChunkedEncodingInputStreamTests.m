@@ -0,0 +1,249 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+#import <sys/resource.h>
+
+static NSString *const AWSS3ChunkedEncodingTestsSeedSignature = @"4f232c4386841ef735655705268965c44a0e4690baa4adea153f7db9fa80a0a9";
+static NSString *const AWSS3ChunkedEncodingTestsScope = @"20130524/us-east-1/s3/aws4_request";
+// Size of the sparse file streamed by the throughput benchmark.
+static unsigned long long const AWSS3ChunkedEncodingTestsBenchmarkFileSize = 2ULL * 1024 * 1024 * 1024;
+
+@interface AWSS3ChunkedEncodingInputStreamTests : XCTestCase
+
+@property (nonatomic, strong) NSData *kSigning;
+@property (nonatomic, strong) NSDate *date;
+
+@end
+
+@implementation AWSS3ChunkedEncodingInputStreamTests
+
+- (void)setUp {
+    [super setUp];
+    self.kSigning = [AWSSignatureV4Signer getV4DerivedKey:@"wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY"
+                                                     date:@"20130524"
+                                                   region:@"us-east-1"
+                                                  service:@"s3"];
+    self.date = [NSDate dateWithTimeIntervalSince1970:1369353600];
+}
+
+- (AWSS3ChunkedEncodingInputStream *)chunkedStreamWithInputStream:(NSInputStream *)inputStream
+                                                        chunkSize:(NSUInteger)chunkSize {
+    return [[AWSS3ChunkedEncodingInputStream alloc] initWithInputStream:inputStream
+                                                                   date:self.date
+                                                                  scope:AWSS3ChunkedEncodingTestsScope
+                                                               kSigning:self.kSigning
+                                                        headerSignature:AWSS3ChunkedEncodingTestsSeedSignature
+                                                              chunkSize:chunkSize];
+}
+
+// Drains the stream the way NSURLSession does, with reads that do not line up with chunk boundaries.
+- (unsigned long long)drainStream:(NSInputStream *)stream
+                       readLength:(NSUInteger)readLength
+                         intoData:(NSMutableData *)data {
+    uint8_t *buffer = malloc(readLength);
+    unsigned long long total = 0;
+    [stream open];
+    NSInteger read;
+    while ((read = [stream read:buffer maxLength:readLength]) > 0) {
+        [data appendBytes:buffer length:read];
+        total += read;
+    }
+    XCTAssertEqual(read, 0);
+    XCTAssertFalse([stream hasBytesAvailable]);
+    [stream close];
+    free(buffer);
+    return total;
+}
+
+- (void)testChunkSignatures {
+    NSMutableData *payload = [NSMutableData dataWithLength:66560];
+    memset([payload mutableBytes], 'a', [payload length]);
+    AWSS3ChunkedEncodingInputStream *stream = [self chunkedStreamWithInputStream:[NSInputStream inputStreamWithData:payload]
+                                                                       chunkSize:65536];
+
+    NSMutableData *output = [NSMutableData data];
+    [self drainStream:stream readLength:1000 intoData:output];
+
+    NSMutableData *expected = [NSMutableData data];
+    [expected appendData:[@"010000;chunk-signature=61ed74d76ad0a0a3cd61199c82a3112c3c90ec6bf34d8b2c625093a11e569c2b\r\n" dataUsingEncoding:NSASCIIStringEncoding]];
+    [expected appendData:[payload subdataWithRange:NSMakeRange(0, 65536)]];
+    [expected appendData:[@"\r\n000400;chunk-signature=1bc5ec3a09ab65cbdd970c67f8744614b27f6f762e6f7b998405f4c8b577a685\r\n" dataUsingEncoding:NSASCIIStringEncoding]];
+    [expected appendData:[payload subdataWithRange:NSMakeRange(65536, 1024)]];
+    [expected appendData:[@"\r\n000000;chunk-signature=7cd0adc4c8559a39c487847ea89a4137b7653d47264e872e48d980f945fc3927\r\n\r\n" dataUsingEncoding:NSASCIIStringEncoding]];
+
+    XCTAssertEqualObjects(output, expected);
+    XCTAssertEqual([output length], [AWSS3ChunkedEncodingInputStream computeContentLengthForChunkedData:[payload length] chunkSize:65536]);
+    XCTAssertEqual(stream.totalLengthOfChunkSignatureSent, 3 * [AWSS3ChunkedEncodingInputStream computeContentLengthForChunkedData:0]);
+}
+
+- (void)testContentLengthMatchesStreamedLength {
+    NSData *payload = [NSMutableData dataWithLength:300 * 1024 + 17];
+    for (NSNumber *chunkSize in @[@([AWSS3ChunkedEncodingInputStream defaultChunkSize]), @(8 * 1024), @(64 * 1024), @(1024 * 1024), @(1)]) {
+        AWSS3ChunkedEncodingInputStream *stream = [self chunkedStreamWithInputStream:[NSInputStream inputStreamWithData:payload]
+                                                                           chunkSize:[chunkSize unsignedIntegerValue]];
+        XCTAssertGreaterThanOrEqual(stream.chunkSize, 8 * 1024);
+        unsigned long long length = [self drainStream:stream readLength:32 * 1024 intoData:[NSMutableData data]];
+        XCTAssertEqual(length, [AWSS3ChunkedEncodingInputStream computeContentLengthForChunkedData:[payload length]
+                                                                                          chunkSize:[chunkSize unsignedIntegerValue]]);
+    }
+}
+
+- (void)testEmptyPayload {
+    AWSS3ChunkedEncodingInputStream *stream = [self chunkedStreamWithInputStream:[NSInputStream inputStreamWithData:[NSData data]]
+                                                                       chunkSize:65536];
+    NSMutableData *output = [NSMutableData data];
+    [self drainStream:stream readLength:32 * 1024 intoData:output];
+    XCTAssertEqual([output length], [AWSS3ChunkedEncodingInputStream computeContentLengthForChunkedData:0]);
+    XCTAssertTrue([[[NSString alloc] initWithData:output encoding:NSASCIIStringEncoding] hasPrefix:@"000000;chunk-signature="]);
+}
+
+- (void)testTrailingChecksum {
+    NSMutableData *payload = [NSMutableData dataWithLength:10000];
+    memset([payload mutableBytes], 'a', [payload length]);
+    AWSS3ChunkedEncodingInputStream *stream = [[AWSS3ChunkedEncodingInputStream alloc] initWithInputStream:[NSInputStream inputStreamWithData:payload]
+                                                                                          checksumAlgorithm:AWSChecksumAlgorithmCRC32
+                                                                                                  chunkSize:8192];
+    NSMutableData *output = [NSMutableData data];
+    [self drainStream:stream readLength:1000 intoData:output];
+
+    AWSChecksum *checksum = [AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmCRC32];
+    [checksum updateWithData:payload];
+
+    NSMutableData *expected = [NSMutableData data];
+    [expected appendData:[@"2000\r\n" dataUsingEncoding:NSASCIIStringEncoding]];
+    [expected appendData:[payload subdataWithRange:NSMakeRange(0, 8192)]];
+    [expected appendData:[@"\r\n710\r\n" dataUsingEncoding:NSASCIIStringEncoding]];
+    [expected appendData:[payload subdataWithRange:NSMakeRange(8192, 1808)]];
+    [expected appendData:[[NSString stringWithFormat:@"\r\n0\r\nx-amz-checksum-crc32:%@\r\n\r\n", [checksum base64EncodedChecksum]] dataUsingEncoding:NSASCIIStringEncoding]];
+
+    XCTAssertEqualObjects(output, expected);
+    XCTAssertEqual(stream.totalLengthOfChunkSignatureSent, [output length] - [payload length]);
+}
+
+- (void)testStalledSourceTimesOut {
+    CFReadStreamRef readStream = NULL;
+    CFWriteStreamRef writeStream = NULL;
+    CFStreamCreateBoundPair(kCFAllocatorDefault, &readStream, &writeStream, 1024);
+    NSOutputStream *outputStream = CFBridgingRelease(writeStream);
+    [outputStream open];
+
+    AWSS3ChunkedEncodingInputStream *stream = [self chunkedStreamWithInputStream:CFBridgingRelease(readStream)
+                                                                       chunkSize:8192];
+    stream.readTimeout = 0.1;
+    [stream scheduleInRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
+    [stream open];
+    uint8_t buffer[1024];
+    XCTAssertEqual([stream read:buffer maxLength:sizeof(buffer)], -1);
+    XCTAssertEqual([stream streamStatus], NSStreamStatusError);
+    XCTAssertEqual([stream streamError].code, ETIMEDOUT);
+    XCTAssertFalse([stream hasBytesAvailable]);
+    [stream close];
+    [stream removeFromRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
+
+    // Ends the read blocked on the signing queue.
+    [outputStream close];
+}
+
+#pragma mark - Benchmarks
+
+- (NSURL *)sparseFileWithSize:(unsigned long long)size {
+    NSURL *fileURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [[NSFileManager defaultManager] createFileAtPath:fileURL.path contents:nil attributes:nil];
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingToURL:fileURL error:nil];
+    [fileHandle truncateFileAtOffset:size];
+    [fileHandle closeFile];
+    [self addTeardownBlock:^{
+        [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+    }];
+    return fileURL;
+}
+
+- (void)testPerformanceChunkedEncoding {
+    NSURL *fileURL = [self sparseFileWithSize:64 * 1024 * 1024];
+    [self measureBlock:^{
+        AWSS3ChunkedEncodingInputStream *stream = [self chunkedStreamWithInputStream:[NSInputStream inputStreamWithURL:fileURL]
+                                                                           chunkSize:[AWSS3ChunkedEncodingInputStream defaultChunkSize]];
+        uint8_t buffer[32 * 1024];
+        [stream open];
+        while ([stream read:buffer maxLength:sizeof(buffer)] > 0);
+        [stream close];
+    }];
+}
+
+- (double)CPUSeconds {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+// Compares the CPU time spent producing the body of a 1 GB upload for each payload signing mode.
+- (void)testPayloadSigningModesCPUPerGigabyte {
+    unsigned long long fileSize = 1024ULL * 1024 * 1024;
+    NSURL *fileURL = [self sparseFileWithSize:fileSize];
+    NSDictionary<NSString *, NSInputStream *(^)(void)> *modes = @{
+        @"signed chunks" : ^NSInputStream *{
+            return [self chunkedStreamWithInputStream:[NSInputStream inputStreamWithURL:fileURL]
+                                            chunkSize:[AWSS3ChunkedEncodingInputStream defaultChunkSize]];
+        },
+        @"unsigned payload" : ^NSInputStream *{
+            return [NSInputStream inputStreamWithURL:fileURL];
+        },
+        @"trailing CRC32" : ^NSInputStream *{
+            return [[AWSS3ChunkedEncodingInputStream alloc] initWithInputStream:[NSInputStream inputStreamWithURL:fileURL]
+                                                              checksumAlgorithm:AWSChecksumAlgorithmCRC32
+                                                                      chunkSize:[AWSS3ChunkedEncodingInputStream defaultChunkSize]];
+        },
+        @"trailing CRC32C" : ^NSInputStream *{
+            return [[AWSS3ChunkedEncodingInputStream alloc] initWithInputStream:[NSInputStream inputStreamWithURL:fileURL]
+                                                              checksumAlgorithm:AWSChecksumAlgorithmCRC32C
+                                                                      chunkSize:[AWSS3ChunkedEncodingInputStream defaultChunkSize]];
+        },
+    };
+    for (NSString *mode in modes) {
+        NSInputStream *stream = modes[mode]();
+        uint8_t buffer[32 * 1024];
+        double start = [self CPUSeconds];
+        [stream open];
+        while ([stream read:buffer maxLength:sizeof(buffer)] > 0);
+        [stream close];
+        NSLog(@"%@: %.2f CPU seconds per GB", mode, ([self CPUSeconds] - start) * (1024.0 * 1024 * 1024) / fileSize);
+    }
+}
+
+- (void)testChunkedEncodingThroughput {
+    NSURL *fileURL = [self sparseFileWithSize:AWSS3ChunkedEncodingTestsBenchmarkFileSize];
+    for (NSNumber *chunkSize in @[@([AWSS3ChunkedEncodingInputStream defaultChunkSize]), @(1024 * 1024), @(8 * 1024 * 1024)]) {
+        AWSS3ChunkedEncodingInputStream *stream = [self chunkedStreamWithInputStream:[NSInputStream inputStreamWithURL:fileURL]
+                                                                           chunkSize:[chunkSize unsignedIntegerValue]];
+        uint8_t buffer[32 * 1024];
+        unsigned long long total = 0;
+        NSInteger read;
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        [stream open];
+        while ((read = [stream read:buffer maxLength:sizeof(buffer)]) > 0) {
+            total += read;
+        }
+        [stream close];
+        CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+
+        XCTAssertEqual(total, [AWSS3ChunkedEncodingInputStream computeContentLengthForChunkedData:(NSUInteger)AWSS3ChunkedEncodingTestsBenchmarkFileSize
+                                                                                         chunkSize:[chunkSize unsignedIntegerValue]]);
+        NSLog(@"chunk size %@: %.1f MB/s", chunkSize, AWSS3ChunkedEncodingTestsBenchmarkFileSize / elapsed / (1024 * 1024));
+    }
+}
+
+@end
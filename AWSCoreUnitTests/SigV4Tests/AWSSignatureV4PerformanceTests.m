@@ -0,0 +1,303 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+static NSString *const AWSSignatureV4PerformanceTestsAccessKey = @"AKIDEXAMPLE";
+static NSString *const AWSSignatureV4PerformanceTestsSecretKey = @"wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY";
+static NSUInteger const AWSSignatureV4PerformanceTestsIterations = 1000;
+
+@interface AWSSignatureV4Signer (AWSSignatureV4PerformanceTests)
+
++ (NSString *)getCanonicalizedQueryString:(NSString *)query;
++ (NSString *)getCanonicalizedHeaderString:(NSDictionary *)headers;
+
+@end
+
+@interface AWSSignatureV4PerformanceTests : XCTestCase
+
+@property (nonatomic, strong) id<AWSCredentialsProvider> credentialsProvider;
+
+@end
+
+@implementation AWSSignatureV4PerformanceTests
+
+- (void)setUp {
+    [super setUp];
+    self.credentialsProvider = [[AWSStaticCredentialsProvider alloc] initWithAccessKey:AWSSignatureV4PerformanceTestsAccessKey
+                                                                             secretKey:AWSSignatureV4PerformanceTestsSecretKey];
+}
+
+- (AWSSignatureV4Signer *)signerForServiceType:(AWSServiceType)serviceType {
+    AWSEndpoint *endpoint = [[AWSEndpoint alloc] initWithRegion:AWSRegionUSEast1
+                                                        service:serviceType
+                                                   useUnsafeURL:NO];
+    return [[AWSSignatureV4Signer alloc] initWithCredentialsProvider:self.credentialsProvider
+                                                            endpoint:endpoint];
+}
+
+- (NSMutableURLRequest *)JSONRequest {
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"https://dynamodb.us-east-1.amazonaws.com/"]];
+    request.HTTPMethod = @"POST";
+    request.HTTPBody = [@"{\"TableName\":\"Music\"}" dataUsingEncoding:NSUTF8StringEncoding];
+    [request setValue:@"application/x-amz-json-1.0" forHTTPHeaderField:@"Content-Type"];
+    [request setValue:@"20150830T123600Z" forHTTPHeaderField:@"X-Amz-Date"];
+    [request setValue:@"DynamoDB_20120810.DescribeTable" forHTTPHeaderField:@"X-Amz-Target"];
+    return request;
+}
+
+- (NSMutableURLRequest *)S3Request {
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"https://bucket.s3.amazonaws.com/photos/2021/image%20name.jpg?versionId=3&partNumber=1"]];
+    request.HTTPMethod = @"GET";
+    [request setValue:[[NSDate aws_clockSkewFixedDate] aws_stringValue:AWSDateISO8601DateFormat2] forHTTPHeaderField:@"X-Amz-Date"];
+    [request setValue:@"bytes=0-1048575" forHTTPHeaderField:@"Range"];
+    return request;
+}
+
+#pragma mark - Correctness
+
+- (void)testDerivedKeyIsCached {
+    NSData *derivedKey = [AWSSignatureV4Signer getV4DerivedKey:AWSSignatureV4PerformanceTestsSecretKey
+                                                          date:@"20120215"
+                                                        region:@"us-east-1"
+                                                       service:@"iam"];
+    const unsigned char expectedBytes[] = {0xf4, 0x78, 0x0e, 0x2d, 0x9f, 0x65, 0xfa, 0x89, 0x5f, 0x9c, 0x67, 0xb3, 0x2c, 0xe1, 0xba, 0xf0,
+                                           0xb0, 0xd8, 0xa4, 0x35, 0x05, 0xa0, 0x00, 0xa1, 0xa9, 0xe0, 0x90, 0xd4, 0x14, 0xdb, 0x40, 0x4d};
+    XCTAssertEqualObjects(derivedKey, [NSData dataWithBytes:expectedBytes length:sizeof(expectedBytes)]);
+    XCTAssertEqual([AWSSignatureV4Signer getV4DerivedKey:AWSSignatureV4PerformanceTestsSecretKey
+                                                    date:@"20120215"
+                                                  region:@"us-east-1"
+                                                 service:@"iam"], derivedKey);
+
+    // A different secret for the same scope must not be served from the cache.
+    NSData *rotatedKey = [AWSSignatureV4Signer getV4DerivedKey:@"rotated-secret"
+                                                          date:@"20120215"
+                                                        region:@"us-east-1"
+                                                       service:@"iam"];
+    XCTAssertNotEqualObjects(rotatedKey, derivedKey);
+}
+
+- (void)testCanonicalRequest {
+    NSString *canonicalRequest = [AWSSignatureV4Signer getCanonicalizedRequest:@"GET"
+                                                                          path:@"/"
+                                                                         query:@""
+                                                                       headers:@{@"Host" : @"example.amazonaws.com",
+                                                                                 @"X-Amz-Date" : @"20150830T123600Z"}
+                                                                 contentSha256:@"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"];
+    XCTAssertEqualObjects(canonicalRequest, @"GET\n/\n\nhost:example.amazonaws.com\nx-amz-date:20150830T123600Z\n\nhost;x-amz-date\ne3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+}
+
+- (void)testCanonicalizedQueryStringSortsByKeyThenValue {
+    XCTAssertEqualObjects([AWSSignatureV4Signer getCanonicalizedQueryString:@"b=2&a=2&a=1&Z=0&empty=&=skipped&bad=1=2"],
+                          @"Z=0&a=1&a=2&b=2&empty=");
+    XCTAssertEqualObjects([AWSSignatureV4Signer getCanonicalizedQueryString:@"location"], @"location=");
+    XCTAssertEqualObjects([AWSSignatureV4Signer getCanonicalizedQueryString:@""], @"");
+}
+
+- (void)testCanonicalizedHeadersCollapseWhitespace {
+    NSDictionary *headers = @{@"My-Header1" : @"  a   b \t c  ",
+                              @"my-header2" : @"\"a   b\"",
+                              @"Unicode" : @"é  ü"};
+    XCTAssertEqualObjects([AWSSignatureV4Signer getCanonicalizedHeaderString:headers],
+                          @"my-header1:a b c\nmy-header2:\"a b\"\nunicode:é ü\n");
+    XCTAssertEqualObjects([AWSSignatureV4Signer getSignedHeadersString:headers], @"my-header1;my-header2;unicode");
+}
+
+- (void)testJSONRequestSignature {
+    NSMutableURLRequest *request = [self JSONRequest];
+    [[[self signerForServiceType:AWSServiceDynamoDB] interceptRequest:request] waitUntilFinished];
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"Authorization"],
+                          @"AWS4-HMAC-SHA256 Credential=AKIDEXAMPLE/20150830/us-east-1/dynamodb/aws4_request, SignedHeaders=content-type;host;x-amz-date;x-amz-target, Signature=23ad5f88fe52353cc06196d0bcd0d0f371df0b33b3299a398ed238e5e84a6fa9");
+}
+
+- (void)testStreamHash {
+    unsigned long long length = 0;
+    NSError *error = nil;
+    NSString *hash = [AWSSignatureSignerUtility hexEncodedSHA256OfStream:[NSInputStream inputStreamWithData:[@"abc" dataUsingEncoding:NSUTF8StringEncoding]]
+                                                                  length:&length
+                                                                   error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqual(length, 3);
+    XCTAssertEqualObjects(hash, @"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+- (void)testS3FilePayloadIsSignedWithPayloadHash {
+    NSURL *fileURL = [self sparseFileWithSize:3 * 1024 * 1024 + 5];
+    NSMutableURLRequest *request = [self S3PutRequestWithFileURL:fileURL];
+    AWSSignatureV4Signer *signer = [self signerForServiceType:AWSServiceS3];
+    signer.payloadFileHashingEnabled = YES;
+    [[signer interceptRequest:request] waitUntilFinished];
+
+    NSString *expectedHash = [AWSSignatureSignerUtility hexEncodedSHA256OfStream:[NSInputStream inputStreamWithURL:fileURL]
+                                                                          length:NULL
+                                                                           error:nil];
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"x-amz-content-sha256"], expectedHash);
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"Content-Length"], @"3145733");
+    XCTAssertNil([request valueForHTTPHeaderField:@"Content-Encoding"]);
+    XCTAssertNil([request valueForHTTPHeaderField:@"x-amz-decoded-content-length"]);
+    XCTAssertFalse([request.HTTPBodyStream isKindOfClass:[AWSS3ChunkedEncodingInputStream class]]);
+    XCTAssertNotNil([request valueForHTTPHeaderField:@"Authorization"]);
+}
+
+- (void)testS3FilePayloadIsSentChunkedByDefault {
+    NSMutableURLRequest *request = [self S3PutRequestWithFileURL:[self sparseFileWithSize:1024]];
+    [request setValue:@"1024" forHTTPHeaderField:@"Content-Length"];
+    [[[self signerForServiceType:AWSServiceS3] interceptRequest:request] waitUntilFinished];
+
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"x-amz-content-sha256"], @"STREAMING-AWS4-HMAC-SHA256-PAYLOAD");
+    XCTAssertTrue([request.HTTPBodyStream isKindOfClass:[AWSS3ChunkedEncodingInputStream class]]);
+}
+
+- (void)testS3StreamPayloadWithoutFileIsSentChunked {
+    NSMutableURLRequest *request = [self S3Request];
+    request.HTTPMethod = @"PUT";
+    request.HTTPBodyStream = [NSInputStream inputStreamWithData:[NSMutableData dataWithLength:1024]];
+    [request setValue:@"1024" forHTTPHeaderField:@"Content-Length"];
+    [[[self signerForServiceType:AWSServiceS3] interceptRequest:request] waitUntilFinished];
+
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"x-amz-content-sha256"], @"STREAMING-AWS4-HMAC-SHA256-PAYLOAD");
+    XCTAssertTrue([request.HTTPBodyStream isKindOfClass:[AWSS3ChunkedEncodingInputStream class]]);
+}
+
+- (void)testUnsignedPayload {
+    AWSSignatureV4Signer *signer = [self signerForServiceType:AWSServiceS3];
+    signer.payloadSigningMode = AWSSignatureV4PayloadSigningModeUnsigned;
+
+    NSURL *fileURL = [self sparseFileWithSize:1024];
+    NSMutableURLRequest *request = [self S3PutRequestWithFileURL:fileURL];
+    [request setValue:@"1024" forHTTPHeaderField:@"Content-Length"];
+    NSInputStream *bodyStream = request.HTTPBodyStream;
+    [[signer interceptRequest:request] waitUntilFinished];
+
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"x-amz-content-sha256"], @"UNSIGNED-PAYLOAD");
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"Content-Length"], @"1024");
+    XCTAssertEqual(request.HTTPBodyStream, bodyStream);
+    XCTAssertNil([request valueForHTTPHeaderField:@"Content-Encoding"]);
+}
+
+- (void)testTrailingChecksum {
+    AWSSignatureV4Signer *signer = [self signerForServiceType:AWSServiceS3];
+    signer.payloadSigningMode = AWSSignatureV4PayloadSigningModeTrailingChecksum;
+    signer.payloadChecksumAlgorithm = AWSChecksumAlgorithmCRC32C;
+
+    NSMutableURLRequest *request = [self S3Request];
+    request.HTTPMethod = @"PUT";
+    request.HTTPBodyStream = [NSInputStream inputStreamWithData:[NSMutableData dataWithLength:1024]];
+    [request setValue:@"1024" forHTTPHeaderField:@"Content-Length"];
+    [[signer interceptRequest:request] waitUntilFinished];
+
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"x-amz-content-sha256"], @"STREAMING-UNSIGNED-PAYLOAD-TRAILER");
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"x-amz-trailer"], @"x-amz-checksum-crc32c");
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"x-amz-decoded-content-length"], @"1024");
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"Content-Encoding"], @"aws-chunked");
+    XCTAssertNil([request valueForHTTPHeaderField:@"Content-Length"]);
+    XCTAssertTrue([request.HTTPBodyStream isKindOfClass:[AWSS3ChunkedEncodingInputStream class]]);
+    XCTAssertTrue([[request valueForHTTPHeaderField:@"Authorization"] containsString:@"x-amz-trailer"]);
+
+    // A body known up front gets its checksum as a header.
+    request = [self S3Request];
+    request.HTTPMethod = @"PUT";
+    request.HTTPBody = [@"123456789" dataUsingEncoding:NSUTF8StringEncoding];
+    [request setValue:@"9" forHTTPHeaderField:@"Content-Length"];
+    [[signer interceptRequest:request] waitUntilFinished];
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"x-amz-content-sha256"], @"UNSIGNED-PAYLOAD");
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"x-amz-checksum-crc32c"], @"4waSgw==");
+}
+
+- (void)testUnsignedPayloadRequiresTLS {
+    AWSSignatureV4Signer *signer = [self signerForServiceType:AWSServiceS3];
+    signer.payloadSigningMode = AWSSignatureV4PayloadSigningModeUnsigned;
+
+    NSMutableURLRequest *request = [self S3Request];
+    request.URL = [NSURL URLWithString:@"http://bucket.s3.amazonaws.com/key"];
+    [[signer interceptRequest:request] waitUntilFinished];
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"x-amz-content-sha256"], @"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+}
+
+#pragma mark - Benchmarks
+
+- (NSURL *)sparseFileWithSize:(unsigned long long)size {
+    NSURL *fileURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [[NSFileManager defaultManager] createFileAtPath:fileURL.path contents:nil attributes:nil];
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingToURL:fileURL error:nil];
+    [fileHandle truncateFileAtOffset:size];
+    [fileHandle closeFile];
+    [self addTeardownBlock:^{
+        [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+    }];
+    return fileURL;
+}
+
+- (NSMutableURLRequest *)S3PutRequestWithFileURL:(NSURL *)fileURL {
+    NSMutableURLRequest *request = [self S3Request];
+    request.HTTPMethod = @"PUT";
+    request.HTTPBodyStream = [NSInputStream inputStreamWithURL:fileURL];
+    [NSURLProtocol setProperty:[fileURL absoluteString] forKey:AWSSignatureV4PayloadFileURLKey inRequest:request];
+    return request;
+}
+
+// Signing a 100 MB part from a file should only need the hashing buffer, not the part.
+- (void)testPerformanceSigningFilePayload {
+    NSURL *fileURL = [self sparseFileWithSize:100 * 1024 * 1024];
+    AWSSignatureV4Signer *signer = [self signerForServiceType:AWSServiceS3];
+    signer.payloadFileHashingEnabled = YES;
+    if (@available(iOS 13.0, *)) {
+        [self measureWithMetrics:@[[XCTMemoryMetric new], [XCTClockMetric new]] block:^{
+            [[signer interceptRequest:[self S3PutRequestWithFileURL:fileURL]] waitUntilFinished];
+        }];
+    }
+}
+
+- (void)measureSigningRequest:(NSMutableURLRequest *(^)(void))requestBlock
+                       signer:(AWSSignatureV4Signer *)signer {
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSSignatureV4PerformanceTestsIterations; i++) {
+            [[signer interceptRequest:requestBlock()] waitUntilFinished];
+        }
+    }];
+}
+
+- (void)testPerformanceSigningS3Request {
+    [self measureSigningRequest:^NSMutableURLRequest *{
+        return [self S3Request];
+    }
+                         signer:[self signerForServiceType:AWSServiceS3]];
+}
+
+- (void)testPerformanceSigningJSONRequest {
+    [self measureSigningRequest:^NSMutableURLRequest *{
+        return [self JSONRequest];
+    }
+                         signer:[self signerForServiceType:AWSServiceDynamoDB]];
+}
+
+- (void)testSignaturesPerSecond {
+    NSArray *cases = @[@[@"S3 GetObject", @(AWSServiceS3), ^NSMutableURLRequest *{ return [self S3Request]; }],
+                       @[@"DynamoDB DescribeTable", @(AWSServiceDynamoDB), ^NSMutableURLRequest *{ return [self JSONRequest]; }]];
+    for (NSArray *signingCase in cases) {
+        AWSSignatureV4Signer *signer = [self signerForServiceType:[signingCase[1] integerValue]];
+        NSMutableURLRequest *(^requestBlock)(void) = signingCase[2];
+
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        for (NSUInteger i = 0; i < AWSSignatureV4PerformanceTestsIterations; i++) {
+            [[signer interceptRequest:requestBlock()] waitUntilFinished];
+        }
+        CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+        NSLog(@"%@: %.0f signatures/second", signingCase[0], AWSSignatureV4PerformanceTestsIterations / elapsed);
+    }
+}
+
+@end
@@ -0,0 +1,89 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSDynamoDBService.h"
+#import "AWSDynamoDBResources.h"
+
+static NSUInteger const AWSDynamoDBPerformanceTestsItemCount = 25;
+
+@interface AWSDynamoDBSerializationPerformanceTests : XCTestCase
+
+@property (nonatomic, strong) NSDictionary *batchWriteItemParameters;
+
+@end
+
+@implementation AWSDynamoDBSerializationPerformanceTests
+
+- (void)setUp {
+    [super setUp];
+
+    NSMutableArray *writeRequests = [NSMutableArray arrayWithCapacity:AWSDynamoDBPerformanceTestsItemCount];
+    for (NSUInteger i = 0; i < AWSDynamoDBPerformanceTestsItemCount; i++) {
+        AWSDynamoDBAttributeValue *hashKey = [AWSDynamoDBAttributeValue new];
+        hashKey.S = [NSString stringWithFormat:@"user-%lu", (unsigned long)i];
+        AWSDynamoDBAttributeValue *score = [AWSDynamoDBAttributeValue new];
+        score.N = [NSString stringWithFormat:@"%lu", (unsigned long)(i * 100)];
+        AWSDynamoDBAttributeValue *tag = [AWSDynamoDBAttributeValue new];
+        tag.S = @"performance";
+        AWSDynamoDBAttributeValue *tags = [AWSDynamoDBAttributeValue new];
+        tags.L = @[tag, tag];
+        AWSDynamoDBAttributeValue *profile = [AWSDynamoDBAttributeValue new];
+        profile.M = @{@"tags" : tags, @"score" : score};
+
+        AWSDynamoDBPutRequest *putRequest = [AWSDynamoDBPutRequest new];
+        putRequest.item = @{@"UserId" : hashKey, @"Score" : score, @"Profile" : profile};
+        AWSDynamoDBWriteRequest *writeRequest = [AWSDynamoDBWriteRequest new];
+        writeRequest.putRequest = putRequest;
+        [writeRequests addObject:writeRequest];
+    }
+
+    AWSDynamoDBBatchWriteItemInput *request = [AWSDynamoDBBatchWriteItemInput new];
+    request.requestItems = @{@"AWSDynamoDBSerializationPerformanceTests" : writeRequests};
+    self.batchWriteItemParameters = [[AWSMTLJSONAdapter JSONDictionaryFromModel:request] aws_removeNullValues];
+}
+
+- (void)testBatchWriteItemSerializationMatchesItemCount {
+    NSError *error = nil;
+    NSData *data = [AWSJSONBuilder jsonDataForDictionary:self.batchWriteItemParameters
+                                              actionName:@"BatchWriteItem"
+                                   serviceDefinitionRule:[[AWSDynamoDBResources sharedInstance] JSONObject]
+                                                   error:&error];
+    XCTAssertNil(error);
+
+    NSDictionary *body = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    NSArray *writeRequests = body[@"RequestItems"][@"AWSDynamoDBSerializationPerformanceTests"];
+    XCTAssertEqual([writeRequests count], AWSDynamoDBPerformanceTestsItemCount);
+    XCTAssertEqualObjects(writeRequests[3][@"PutRequest"][@"Item"][@"UserId"][@"S"], @"user-3");
+    XCTAssertEqualObjects(writeRequests[3][@"PutRequest"][@"Item"][@"Profile"][@"M"][@"tags"][@"L"][0][@"S"], @"performance");
+}
+
+- (void)testPerformanceBatchWriteItemSerialization {
+    NSDictionary *serviceDefinitionRule = [[AWSDynamoDBResources sharedInstance] JSONObject];
+    [self measureBlock:^{
+        for (int i = 0; i < 100; i++) {
+            @autoreleasepool {
+                NSError *error = nil;
+                NSData *data = [AWSJSONBuilder jsonDataForDictionary:self.batchWriteItemParameters
+                                                          actionName:@"BatchWriteItem"
+                                               serviceDefinitionRule:serviceDefinitionRule
+                                                               error:&error];
+                XCTAssertNotNil(data);
+            }
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,70 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+#import "AWSDynamoDBResources.h"
+
+@interface AWSDynamoDBResources (AWSDynamoDBServiceModelCacheTests)
+
+- (NSString *)definitionString;
+
+@end
+
+@interface AWSServiceModelCache (AWSDynamoDBServiceModelCacheTests)
+
+@property (nonatomic, strong) dispatch_queue_t writeQueue;
+
+@end
+
+// The DynamoDB definition is loaded at startup by apps using DynamoDB, so it is benchmarked here, where it is linked.
+@interface AWSDynamoDBServiceModelCacheTests : XCTestCase
+
+@end
+
+@implementation AWSDynamoDBServiceModelCacheTests
+
+- (void)testDynamoDBDefinitionIsLoadedThroughTheCache {
+    NSDictionary *definition = [[AWSDynamoDBResources sharedInstance] JSONObject];
+    XCTAssertEqualObjects(definition[@"metadata"][@"endpointPrefix"], @"dynamodb");
+    XCTAssertNotNil(definition[@"operations"][@"GetItem"]);
+}
+
+- (void)testPerformanceParsingJSONDefinition {
+    NSString *definitionString = [[AWSDynamoDBResources sharedInstance] definitionString];
+    [self measureBlock:^{
+        @autoreleasepool {
+            NSDictionary *definition = [NSJSONSerialization JSONObjectWithData:[definitionString dataUsingEncoding:NSUTF8StringEncoding] options:0 error:nil];
+            XCTAssertNotNil(definition);
+        }
+    }];
+}
+
+- (void)testPerformanceLoadingCompiledDefinition {
+    NSString *definitionString = [[AWSDynamoDBResources sharedInstance] definitionString];
+    AWSServiceModelCache *cache = [AWSServiceModelCache new];
+    [cache serviceDefinitionForName:@"DynamoDBBenchmark" definitionString:definitionString bundle:nil];
+    dispatch_sync(cache.writeQueue, ^{});
+
+    [self measureBlock:^{
+        @autoreleasepool {
+            NSDictionary *definition = [cache serviceDefinitionForName:@"DynamoDBBenchmark" definitionString:definitionString bundle:nil];
+            XCTAssertNotNil(definition[AWSServiceModelCacheFingerprintKey]);
+        }
+    }];
+    [cache removeAllCachedModels];
+}
+
+@end
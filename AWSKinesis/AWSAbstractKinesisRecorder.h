@@ -16,6 +16,8 @@
 #import <Foundation/Foundation.h>
 #import <AWSCore/AWSService.h>
 
+@class AWSBoundedExecutor;
+
 /**
  `AWSAbstractKinesisRecorder` is an abstract class. You should not instantiate this class directly. Instead use its concrete subclasses `AWSKinesisRecorder` and `AWSFirehoseRecorder`.
  */
@@ -47,6 +49,12 @@
  */
 @property (nonatomic, assign) NSUInteger batchRecordsByteLimit;
 
+/**
+ When set, records are saved and submitted in the background lane of this executor, still one operation at a time, so
+ that the recorder does not compete with interactive work for threads. The default is `nil`.
+ */
+@property (nonatomic, strong) AWSBoundedExecutor *boundedExecutor;
+
 /**
  Saves a record to local storage to be sent later. The record will be submitted to the streamName provided with a randomly generated partition key to ensure equal distribution across shards.
 
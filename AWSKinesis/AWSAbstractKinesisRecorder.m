@@ -48,6 +48,7 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
 @property (nonatomic, strong) id<AWSKinesisRecorderHelper> recorderHelper;
 @property (nonatomic, strong) AWSFMDatabaseQueue *databaseQueue;
 @property (nonatomic, strong) NSString *databasePath;
+@property (nonatomic, strong) AWSExecutor *recorderExecutor;
 
 @end
 
@@ -122,6 +123,33 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
     return queue;
 }
 
+- (void)setBoundedExecutor:(AWSBoundedExecutor *)boundedExecutor {
+    @synchronized(self) {
+        _boundedExecutor = boundedExecutor;
+        _recorderExecutor = nil;
+    }
+}
+
+// Runs the operations on the shared queue, through the background lane of `boundedExecutor` when it is set.
+- (AWSExecutor *)recorderExecutor {
+    @synchronized(self) {
+        if (!_recorderExecutor) {
+            dispatch_queue_t queue = [AWSKinesisRecorder sharedQueue];
+            if (_boundedExecutor) {
+                AWSExecutor *serialExecutor = [_boundedExecutor serialExecutorWithPriority:AWSExecutorPriorityBackground];
+                _recorderExecutor = [AWSExecutor executorWithBlock:^(void (^block)(void)) {
+                    [serialExecutor execute:^{
+                        dispatch_sync(queue, block);
+                    }];
+                }];
+            } else {
+                _recorderExecutor = [AWSExecutor executorWithDispatchQueue:queue];
+            }
+        }
+        return _recorderExecutor;
+    }
+}
+
 - (AWSTask *)saveRecord:(NSData *)data
              streamName:(NSString *)streamName {
     return [self saveRecord:data streamName:streamName partitionKey:[[NSUUID UUID] UUIDString]];
@@ -142,7 +170,7 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
     NSUInteger diskByteLimit = self.diskByteLimit;
     __weak id notificationSender = self;
 
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSKinesisRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[self recorderExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         // Inserts a new record to the database.
         __block NSError *error = nil;
         [databaseQueue inDatabase:^(AWSFMDatabase *db) {
@@ -227,7 +255,7 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
 - (AWSTask *)submitAllRecords {
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
 
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSKinesisRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[self recorderExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         __block NSUInteger batchSize = 0;
         __block BOOL stop = NO;
@@ -332,7 +360,7 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
 - (AWSTask *)removeAllRecords {
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
 
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSKinesisRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[self recorderExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         [databaseQueue inDatabase:^(AWSFMDatabase *db) {
             if (![db executeUpdate:@"DELETE FROM record"]) {
@@ -0,0 +1,166 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSKinesisService.h"
+#import "AWSKinesisResources.h"
+#import "AWSFirehoseService.h"
+#import "AWSFirehoseResources.h"
+
+static NSUInteger const AWSKinesisPerformanceTestsRecordCount = 500;
+
+@interface AWSJSONBuilder (AWSKinesisSerializationPerformanceTests)
+
++ (id)buildJSONDictionary:(NSDictionary *)params
+               actionName:(NSString *)actionName
+    serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule
+                    error:(NSError *__autoreleasing *)error;
+
+@end
+
+@interface AWSKinesisSerializationPerformanceTests : XCTestCase
+
+@property (nonatomic, strong) NSDictionary *putRecordsParameters;
+@property (nonatomic, strong) NSDictionary *putRecordBatchParameters;
+
+@end
+
+@implementation AWSKinesisSerializationPerformanceTests
+
+- (void)setUp {
+    [super setUp];
+
+    NSMutableArray *records = [NSMutableArray arrayWithCapacity:AWSKinesisPerformanceTestsRecordCount];
+    for (NSUInteger i = 0; i < AWSKinesisPerformanceTestsRecordCount; i++) {
+        AWSKinesisPutRecordsRequestEntry *entry = [AWSKinesisPutRecordsRequestEntry new];
+        entry.data = [[NSString stringWithFormat:@"{\"event\":\"page_view\",\"sequence\":%lu}", (unsigned long)i] dataUsingEncoding:NSUTF8StringEncoding];
+        entry.partitionKey = [NSString stringWithFormat:@"partition-%lu", (unsigned long)(i % 16)];
+        [records addObject:entry];
+    }
+
+    AWSKinesisPutRecordsInput *request = [AWSKinesisPutRecordsInput new];
+    request.streamName = @"AWSKinesisSerializationPerformanceTests";
+    request.records = records;
+    self.putRecordsParameters = [[AWSMTLJSONAdapter JSONDictionaryFromModel:request] aws_removeNullValues];
+
+    NSMutableArray *firehoseRecords = [NSMutableArray arrayWithCapacity:AWSKinesisPerformanceTestsRecordCount];
+    for (NSUInteger i = 0; i < AWSKinesisPerformanceTestsRecordCount; i++) {
+        AWSFirehoseRecord *record = [AWSFirehoseRecord new];
+        record.data = [[NSString stringWithFormat:@"{\"event\":\"page_view\",\"sequence\":%lu}\n", (unsigned long)i] dataUsingEncoding:NSUTF8StringEncoding];
+        [firehoseRecords addObject:record];
+    }
+
+    AWSFirehosePutRecordBatchInput *batchRequest = [AWSFirehosePutRecordBatchInput new];
+    batchRequest.deliveryStreamName = @"AWSKinesisSerializationPerformanceTests";
+    batchRequest.records = firehoseRecords;
+    self.putRecordBatchParameters = [[AWSMTLJSONAdapter JSONDictionaryFromModel:batchRequest] aws_removeNullValues];
+}
+
+- (void)testPutRecordsSerializationMatchesRecordCount {
+    NSError *error = nil;
+    NSData *data = [AWSJSONBuilder jsonDataForDictionary:self.putRecordsParameters
+                                              actionName:@"PutRecords"
+                                   serviceDefinitionRule:[[AWSKinesisResources sharedInstance] JSONObject]
+                                                   error:&error];
+    XCTAssertNil(error);
+
+    NSDictionary *body = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    XCTAssertEqual([body[@"Records"] count], AWSKinesisPerformanceTestsRecordCount);
+    XCTAssertEqualObjects(body[@"Records"][0][@"PartitionKey"], @"partition-0");
+    XCTAssertEqualObjects([[NSData alloc] initWithBase64EncodedString:body[@"Records"][1][@"Data"] options:0],
+                          [@"{\"event\":\"page_view\",\"sequence\":1}" dataUsingEncoding:NSUTF8StringEncoding]);
+}
+
+- (void)testPerformancePutRecordsSerialization {
+    NSDictionary *serviceDefinitionRule = [[AWSKinesisResources sharedInstance] JSONObject];
+    [self measureBlock:^{
+        for (int i = 0; i < 10; i++) {
+            @autoreleasepool {
+                NSError *error = nil;
+                NSData *data = [AWSJSONBuilder jsonDataForDictionary:self.putRecordsParameters
+                                                          actionName:@"PutRecords"
+                                               serviceDefinitionRule:serviceDefinitionRule
+                                                               error:&error];
+                XCTAssertNotNil(data);
+            }
+        }
+    }];
+}
+
+- (void)testPutRecordBatchSerializationMatchesBuiltDictionary {
+    NSDictionary *serviceDefinitionRule = [[AWSFirehoseResources sharedInstance] JSONObject];
+    NSError *error = nil;
+    NSData *data = [AWSJSONBuilder jsonDataForDictionary:self.putRecordBatchParameters
+                                              actionName:@"PutRecordBatch"
+                                   serviceDefinitionRule:serviceDefinitionRule
+                                                   error:&error];
+    XCTAssertNil(error);
+
+    NSDictionary *built = [AWSJSONBuilder buildJSONDictionary:self.putRecordBatchParameters
+                                                   actionName:@"PutRecordBatch"
+                                        serviceDefinitionRule:serviceDefinitionRule
+                                                        error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects([NSJSONSerialization JSONObjectWithData:data options:0 error:nil], built);
+}
+
+- (void)testPerformancePutRecordBatchSerialization {
+    NSDictionary *serviceDefinitionRule = [[AWSFirehoseResources sharedInstance] JSONObject];
+    [self measureBlock:^{
+        for (int i = 0; i < 10; i++) {
+            @autoreleasepool {
+                NSData *data = [AWSJSONBuilder jsonDataForDictionary:self.putRecordBatchParameters
+                                                          actionName:@"PutRecordBatch"
+                                               serviceDefinitionRule:serviceDefinitionRule
+                                                               error:nil];
+                XCTAssertNotNil(data);
+            }
+        }
+    }];
+}
+
+// Compares the memory used by the direct writer with building a serialized dictionary for NSJSONSerialization.
+- (void)testPerformancePutRecordsMemoryWithWriter {
+    if (@available(iOS 13.0, *)) {
+        NSDictionary *serviceDefinitionRule = [[AWSKinesisResources sharedInstance] JSONObject];
+        [self measureWithMetrics:@[[XCTMemoryMetric new], [XCTClockMetric new]] block:^{
+            for (int i = 0; i < 10; i++) {
+                NSData *data = [AWSJSONBuilder jsonDataForDictionary:self.putRecordsParameters
+                                                          actionName:@"PutRecords"
+                                               serviceDefinitionRule:serviceDefinitionRule
+                                                               error:nil];
+                XCTAssertNotNil(data);
+            }
+        }];
+    }
+}
+
+- (void)testPerformancePutRecordsMemoryWithJSONSerialization {
+    if (@available(iOS 13.0, *)) {
+        NSDictionary *serviceDefinitionRule = [[AWSKinesisResources sharedInstance] JSONObject];
+        [self measureWithMetrics:@[[XCTMemoryMetric new], [XCTClockMetric new]] block:^{
+            for (int i = 0; i < 10; i++) {
+                NSDictionary *built = [AWSJSONBuilder buildJSONDictionary:self.putRecordsParameters
+                                                               actionName:@"PutRecords"
+                                                    serviceDefinitionRule:serviceDefinitionRule
+                                                                    error:nil];
+                NSData *data = [NSJSONSerialization dataWithJSONObject:built options:0 error:nil];
+                XCTAssertNotNil(data);
+            }
+        }];
+    }
+}
+
+@end
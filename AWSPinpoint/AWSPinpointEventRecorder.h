@@ -18,6 +18,8 @@
 
 @class AWSPinpointEvent,AWSPinpointContext,AWSPinpointTargetingClient;
 
+@class AWSBoundedExecutor;
+
 NS_ASSUME_NONNULL_BEGIN
 
 FOUNDATION_EXPORT NSString *const AWSPinpointAnalyticsErrorDomain;
@@ -78,6 +80,12 @@ FOUNDATION_EXPORT NSString *const AWSPinpointEventByteThresholdReachedNotificati
  */
 @property (nonatomic, assign) NSUInteger batchRecordsByteLimit;
 
+/**
+ When set, events are saved and submitted in the background lane of this executor, still one operation at a time, so
+ that the recorder does not compete with interactive work for threads. The default is `nil`.
+ */
+@property (nonatomic, strong, nullable) AWSBoundedExecutor *boundedExecutor;
+
 /**
  Saves an event to local storage to be sent later.
  
@@ -57,6 +57,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 @property (nonatomic, strong) NSString *databasePath;
 @property (nonatomic, strong) AWSPinpointEndpointProfile *profile;
 @property (nonatomic, strong) NSObject *lock;
+@property (nonatomic, strong) AWSExecutor *recorderExecutor;
 
 @end
 
@@ -177,6 +178,33 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
     return queue;
 }
 
+- (void)setBoundedExecutor:(AWSBoundedExecutor *)boundedExecutor {
+    @synchronized(self) {
+        _boundedExecutor = boundedExecutor;
+        _recorderExecutor = nil;
+    }
+}
+
+// Runs the operations on the shared queue, through the background lane of `boundedExecutor` when it is set.
+- (AWSExecutor *)recorderExecutor {
+    @synchronized(self) {
+        if (!_recorderExecutor) {
+            dispatch_queue_t queue = [AWSPinpointEventRecorder sharedQueue];
+            if (_boundedExecutor) {
+                AWSExecutor *serialExecutor = [_boundedExecutor serialExecutorWithPriority:AWSExecutorPriorityBackground];
+                _recorderExecutor = [AWSExecutor executorWithBlock:^(void (^block)(void)) {
+                    [serialExecutor execute:^{
+                        dispatch_sync(queue, block);
+                    }];
+                }];
+            } else {
+                _recorderExecutor = [AWSExecutor executorWithDispatchQueue:queue];
+            }
+        }
+        return _recorderExecutor;
+    }
+}
+
 - (AWSPinpointSession *)validateOrRetrieveSession:(AWSPinpointSession *) session {
     if (session && session.sessionId && session.sessionId.length >=1) {
         return session;
@@ -236,7 +264,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
     __block AWSPinpointEvent *event = [eventToSave copy];
     AWSDDLogVerbose(@"saveEvent: [%@]", event.toDictionary);
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[self recorderExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         // Inserts a new record to the database.
         __block NSError *error = nil;
         [databaseQueue inDatabase:^(AWSFMDatabase *db) {
@@ -366,7 +394,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     NSString *sessionId = [self validateOrRetrieveSessionId:self.context.sessionClient.session.sessionId];
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[self recorderExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         
         [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
@@ -411,7 +439,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     NSString *sessionId = [self validateOrRetrieveSessionId:session.sessionId];
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[self recorderExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         __block AWSPinpointEvent *event;
         
@@ -476,7 +504,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 - (AWSTask<NSArray<AWSPinpointEvent *> *> *) getEventsWithLimit:(NSNumber *) limit {
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[self recorderExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         __block NSMutableArray *events = [NSMutableArray new];
         
@@ -539,7 +567,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 - (AWSTask<NSArray<AWSPinpointEvent *> *> *) getDirtyEventsWithLimit:(NSNumber *) limit {
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[self recorderExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         __block NSMutableArray *events = [NSMutableArray new];
         
@@ -737,7 +765,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     NSDictionary *temporaryEvents = [eventsWithEventId copy];
 
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]]
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[self recorderExecutor]
                                              withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         __block NSMutableDictionary *events = [NSMutableDictionary new];
@@ -753,7 +781,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                                }];
         
         return [[AWSTask taskForCompletionOfAllTasksWithResults:@[submitTask]] continueWithBlock:^id _Nullable(AWSTask * _Nonnull t) {
-            AWSTask *failTask = [AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
+            AWSTask *failTask = [AWSTask taskFromExecutor:[self recorderExecutor] withBlock:^id _Nonnull{
                 // If an event failed three times, mark even as dirty
                 [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
                     BOOL result = [db executeUpdate:[NSString stringWithFormat:
@@ -768,7 +796,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                 return [AWSTask taskWithResult:nil];
             }];
             
-            AWSTask *moveTask = [AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
+            AWSTask *moveTask = [AWSTask taskFromExecutor:[self recorderExecutor] withBlock:^id _Nonnull{
                 //Move dirty events into DirtyEvent table
                 [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
                     BOOL result = [db executeUpdate:[NSString stringWithFormat:
@@ -783,7 +811,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                 return [AWSTask taskWithResult:nil];
             }];
             
-            AWSTask *deleteTask = [AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
+            AWSTask *deleteTask = [AWSTask taskFromExecutor:[self recorderExecutor] withBlock:^id _Nonnull{
                 //Delete dirty events
                 [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
                     BOOL result = [db executeUpdate:[NSString stringWithFormat:
@@ -810,7 +838,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 - (AWSTask *)removeAllEvents {
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[self recorderExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         [databaseQueue inDatabase:^(AWSFMDatabase *db) {
             if (![db executeUpdate:@"DELETE FROM Event"]) {
@@ -830,7 +858,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 - (AWSTask *)removeAllDirtyEvents {
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[self recorderExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         [databaseQueue inDatabase:^(AWSFMDatabase *db) {
             if (![db executeUpdate:@"DELETE FROM DirtyEvent"]) {
@@ -1033,7 +1061,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                 NSInteger responseCode = [task.error.userInfo[@"responseStatusCode"] integerValue];
                 AWSDDLogError(@"Server rejected submission of %lu events. (Events will be marked dirty.) Response code:%ld, Error Message:%@", (unsigned long)[events count], (long)responseCode, task.error);
                 
-                return [AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
+                return [AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[self recorderExecutor] withBlock:^id _Nonnull{
                     for (__block NSString *eventID in _temporaryEvents) {
                         [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
                             BOOL result = [db executeUpdate:[NSString stringWithFormat:@"UPDATE Event SET dirty = %@ WHERE id = :id", [NSNumber numberWithInteger:AWSPinpointClientInvalidEvent]]
@@ -1050,7 +1078,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                 }]]];
             } else {
                 AWSDDLogError(@"Unable to successfully deliver events to server. Events will be retried. Error Message:%@", task.error);
-                return [AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
+                return [AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[self recorderExecutor] withBlock:^id _Nonnull{
                     for (__block NSString *eventID in _temporaryEvents) {
                         [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
                             BOOL result = [db executeUpdate:@"UPDATE Event SET retryCount = retryCount + 1 WHERE id = :id"
@@ -1085,7 +1113,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                          (unsigned int)[[_processedEvents objectForKey:@"retryableEvents"] count],
                          (unsigned int)[[_processedEvents objectForKey:@"dirtyEvents"] count]);
 
-            return [[AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
+            return [[AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[self recorderExecutor] withBlock:^id _Nonnull{
                 //submitted events, update database
                 for (__block NSString *eventID in [_processedEvents objectForKey:@"acceptedEvents"]) {
                     [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
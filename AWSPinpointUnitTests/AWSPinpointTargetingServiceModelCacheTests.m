@@ -0,0 +1,70 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+#import "AWSPinpointTargetingResources.h"
+
+@interface AWSPinpointTargetingResources (AWSPinpointTargetingServiceModelCacheTests)
+
+- (NSString *)definitionString;
+
+@end
+
+@interface AWSServiceModelCache (AWSPinpointTargetingServiceModelCacheTests)
+
+@property (nonatomic, strong) dispatch_queue_t writeQueue;
+
+@end
+
+// The Pinpoint Targeting definition is loaded when Pinpoint starts, so it is benchmarked here, where it is linked.
+@interface AWSPinpointTargetingServiceModelCacheTests : XCTestCase
+
+@end
+
+@implementation AWSPinpointTargetingServiceModelCacheTests
+
+- (void)testPinpointTargetingDefinitionIsLoadedThroughTheCache {
+    NSDictionary *definition = [[AWSPinpointTargetingResources sharedInstance] JSONObject];
+    XCTAssertEqualObjects(definition[@"metadata"][@"endpointPrefix"], @"pinpoint");
+    XCTAssertNotNil(definition[@"operations"][@"GetEndpoint"]);
+}
+
+- (void)testPerformanceParsingJSONDefinition {
+    NSString *definitionString = [[AWSPinpointTargetingResources sharedInstance] definitionString];
+    [self measureBlock:^{
+        @autoreleasepool {
+            NSDictionary *definition = [NSJSONSerialization JSONObjectWithData:[definitionString dataUsingEncoding:NSUTF8StringEncoding] options:0 error:nil];
+            XCTAssertNotNil(definition);
+        }
+    }];
+}
+
+- (void)testPerformanceLoadingCompiledDefinition {
+    NSString *definitionString = [[AWSPinpointTargetingResources sharedInstance] definitionString];
+    AWSServiceModelCache *cache = [AWSServiceModelCache new];
+    [cache serviceDefinitionForName:@"PinpointTargetingBenchmark" definitionString:definitionString bundle:nil];
+    dispatch_sync(cache.writeQueue, ^{});
+
+    [self measureBlock:^{
+        @autoreleasepool {
+            NSDictionary *definition = [cache serviceDefinitionForName:@"PinpointTargetingBenchmark" definitionString:definitionString bundle:nil];
+            XCTAssertNotNil(definition[AWSServiceModelCacheFingerprintKey]);
+        }
+    }];
+    [cache removeAllCachedModels];
+}
+
+@end
@@ -94,6 +94,11 @@ typedef NS_ENUM(NSInteger, AWSS3BucketVersioningStatus) {
     AWSS3BucketVersioningStatusSuspended,
 };
 
+typedef NS_ENUM(NSInteger, AWSS3ChecksumMode) {
+    AWSS3ChecksumModeUnknown,
+    AWSS3ChecksumModeEnabled,
+};
+
 typedef NS_ENUM(NSInteger, AWSS3CompressionType) {
     AWSS3CompressionTypeUnknown,
     AWSS3CompressionTypeNone,
@@ -3860,6 +3865,31 @@ typedef NS_ENUM(NSInteger, AWSS3Types) {
  */
 @property (nonatomic, strong) NSString * _Nullable cacheControl;
 
+/**
+ <p>The base64-encoded, 32-bit CRC32 checksum of the object. This will only be present if it was uploaded with the object and the request enabled <code>ChecksumMode</code>. The checksum of an object uploaded in parts is a checksum of the checksums of its parts, followed by a dash and the number of parts.</p>
+ */
+@property (nonatomic, strong) NSString * _Nullable checksumCRC32;
+
+/**
+ <p>The base64-encoded, 32-bit CRC32C checksum of the object. This will only be present if it was uploaded with the object and the request enabled <code>ChecksumMode</code>. The checksum of an object uploaded in parts is a checksum of the checksums of its parts, followed by a dash and the number of parts.</p>
+ */
+@property (nonatomic, strong) NSString * _Nullable checksumCRC32C;
+
+/**
+ <p>The base64-encoded, 64-bit CRC64NVME checksum of the object. This will only be present if it was uploaded with the object and the request enabled <code>ChecksumMode</code>. The checksum of an object uploaded in parts is a checksum of the checksums of its parts, followed by a dash and the number of parts.</p>
+ */
+@property (nonatomic, strong) NSString * _Nullable checksumCRC64NVME;
+
+/**
+ <p>The base64-encoded, 160-bit SHA-1 checksum of the object. This will only be present if it was uploaded with the object and the request enabled <code>ChecksumMode</code>. The checksum of an object uploaded in parts is a checksum of the checksums of its parts, followed by a dash and the number of parts.</p>
+ */
+@property (nonatomic, strong) NSString * _Nullable checksumSHA1;
+
+/**
+ <p>The base64-encoded, 256-bit SHA-256 checksum of the object. This will only be present if it was uploaded with the object and the request enabled <code>ChecksumMode</code>. The checksum of an object uploaded in parts is a checksum of the checksums of its parts, followed by a dash and the number of parts.</p>
+ */
+@property (nonatomic, strong) NSString * _Nullable checksumSHA256;
+
 /**
  <p>Specifies presentational information for the object.</p>
  */
@@ -4003,6 +4033,11 @@ typedef NS_ENUM(NSInteger, AWSS3Types) {
  */
 @property (nonatomic, strong) NSString * _Nullable bucket;
 
+/**
+ <p>To retrieve the checksum of the object, this must be enabled.</p>
+ */
+@property (nonatomic, assign) AWSS3ChecksumMode checksumMode;
+
 /**
  <p>The account id of the expected bucket owner. If the bucket is owned by a different account, the request will fail with an HTTP <code>403 (Access Denied)</code> error.</p>
  */
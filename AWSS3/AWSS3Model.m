@@ -4151,6 +4151,11 @@ return [date aws_stringValue:AWSDateISO8601DateFormat1];
 	return @{
              @"acceptRanges" : @"AcceptRanges",
              @"cacheControl" : @"CacheControl",
+             @"checksumCRC32" : @"ChecksumCRC32",
+             @"checksumCRC32C" : @"ChecksumCRC32C",
+             @"checksumCRC64NVME" : @"ChecksumCRC64NVME",
+             @"checksumSHA1" : @"ChecksumSHA1",
+             @"checksumSHA256" : @"ChecksumSHA256",
              @"contentDisposition" : @"ContentDisposition",
              @"contentEncoding" : @"ContentEncoding",
              @"contentLanguage" : @"ContentLanguage",
@@ -4376,6 +4381,7 @@ return [date aws_stringValue:AWSDateISO8601DateFormat1];
 + (NSDictionary *)JSONKeyPathsByPropertyKey {
 	return @{
              @"bucket" : @"Bucket",
+             @"checksumMode" : @"ChecksumMode",
              @"expectedBucketOwner" : @"ExpectedBucketOwner",
              @"ifMatch" : @"IfMatch",
              @"ifModifiedSince" : @"IfModifiedSince",
@@ -4392,6 +4398,22 @@ return [date aws_stringValue:AWSDateISO8601DateFormat1];
              };
 }
 
++ (NSValueTransformer *)checksumModeJSONTransformer {
+    return [AWSMTLValueTransformer reversibleTransformerWithForwardBlock:^NSNumber *(NSString *value) {
+        if ([value caseInsensitiveCompare:@"ENABLED"] == NSOrderedSame) {
+            return @(AWSS3ChecksumModeEnabled);
+        }
+        return @(AWSS3ChecksumModeUnknown);
+    } reverseBlock:^NSString *(NSNumber *value) {
+        switch ([value integerValue]) {
+            case AWSS3ChecksumModeEnabled:
+                return @"ENABLED";
+            default:
+                return nil;
+        }
+    }];
+}
+
 + (NSValueTransformer *)ifModifiedSinceJSONTransformer {
     return [AWSMTLValueTransformer reversibleTransformerWithForwardBlock:^id(NSString *str) {
         return [NSDate aws_dateFromString:str];
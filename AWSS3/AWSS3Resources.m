@@ -15,6 +15,7 @@
 
 #import "AWSS3Resources.h"
 #import <AWSCore/AWSCocoaLumberjack.h>
+#import <AWSCore/AWSServiceModelCache.h>
 
 @interface AWSS3Resources ()
 
@@ -42,15 +43,9 @@
 - (instancetype)init {
     if (self = [super init]) {
         //init method
-        NSError *error = nil;
-        _definitionDictionary = [NSJSONSerialization JSONObjectWithData:[[self definitionString] dataUsingEncoding:NSUTF8StringEncoding]
-                                                                options:kNilOptions
-                                                                  error:&error];
-        if (_definitionDictionary == nil) {
-            if (error) {
-                AWSDDLogError(@"Failed to parse JSON service definition: %@",error);
-            }
-        }
+        _definitionDictionary = [[AWSServiceModelCache sharedInstance] serviceDefinitionForName:@"S3"
+                                                                               definitionString:[self definitionString]
+                                                                                         bundle:[NSBundle bundleForClass:[self class]]];
     }
     return self;
 }
@@ -1537,6 +1532,15 @@
       \"documentation\":\"<p>Describes how uncompressed comma-separated values (CSV)-formatted results are formatted.</p>\"\
     },\
     \"CacheControl\":{\"type\":\"string\"},\
+    \"ChecksumCRC32\":{\"type\":\"string\"},\
+    \"ChecksumCRC32C\":{\"type\":\"string\"},\
+    \"ChecksumCRC64NVME\":{\"type\":\"string\"},\
+    \"ChecksumMode\":{\
+      \"type\":\"string\",\
+      \"enum\":[\"ENABLED\"]\
+    },\
+    \"ChecksumSHA1\":{\"type\":\"string\"},\
+    \"ChecksumSHA256\":{\"type\":\"string\"},\
     \"CloudFunction\":{\"type\":\"string\"},\
     \"CloudFunctionConfiguration\":{\
       \"type\":\"structure\",\
@@ -4539,6 +4543,36 @@
           \"location\":\"header\",\
           \"locationName\":\"ETag\"\
         },\
+        \"ChecksumCRC32\":{\
+          \"shape\":\"ChecksumCRC32\",\
+          \"documentation\":\"<p>The base64-encoded, 32-bit CRC32 checksum of the object. This will only be present if it was uploaded with the object and the request enabled <code>ChecksumMode</code>. The checksum of an object uploaded in parts is a checksum of the checksums of its parts, followed by a dash and the number of parts.</p>\",\
+          \"location\":\"header\",\
+          \"locationName\":\"x-amz-checksum-crc32\"\
+        },\
+        \"ChecksumCRC32C\":{\
+          \"shape\":\"ChecksumCRC32C\",\
+          \"documentation\":\"<p>The base64-encoded, 32-bit CRC32C checksum of the object. This will only be present if it was uploaded with the object and the request enabled <code>ChecksumMode</code>. The checksum of an object uploaded in parts is a checksum of the checksums of its parts, followed by a dash and the number of parts.</p>\",\
+          \"location\":\"header\",\
+          \"locationName\":\"x-amz-checksum-crc32c\"\
+        },\
+        \"ChecksumCRC64NVME\":{\
+          \"shape\":\"ChecksumCRC64NVME\",\
+          \"documentation\":\"<p>The base64-encoded, 64-bit CRC64NVME checksum of the object. This will only be present if it was uploaded with the object and the request enabled <code>ChecksumMode</code>. The checksum of an object uploaded in parts is a checksum of the checksums of its parts, followed by a dash and the number of parts.</p>\",\
+          \"location\":\"header\",\
+          \"locationName\":\"x-amz-checksum-crc64nvme\"\
+        },\
+        \"ChecksumSHA1\":{\
+          \"shape\":\"ChecksumSHA1\",\
+          \"documentation\":\"<p>The base64-encoded, 160-bit SHA-1 checksum of the object. This will only be present if it was uploaded with the object and the request enabled <code>ChecksumMode</code>. The checksum of an object uploaded in parts is a checksum of the checksums of its parts, followed by a dash and the number of parts.</p>\",\
+          \"location\":\"header\",\
+          \"locationName\":\"x-amz-checksum-sha1\"\
+        },\
+        \"ChecksumSHA256\":{\
+          \"shape\":\"ChecksumSHA256\",\
+          \"documentation\":\"<p>The base64-encoded, 256-bit SHA-256 checksum of the object. This will only be present if it was uploaded with the object and the request enabled <code>ChecksumMode</code>. The checksum of an object uploaded in parts is a checksum of the checksums of its parts, followed by a dash and the number of parts.</p>\",\
+          \"location\":\"header\",\
+          \"locationName\":\"x-amz-checksum-sha256\"\
+        },\
         \"MissingMeta\":{\
           \"shape\":\"MissingMeta\",\
           \"documentation\":\"<p>This is set to the number of metadata entries not returned in <code>x-amz-meta</code> headers. This can happen if you create metadata using an API like SOAP that supports more flexible metadata than the REST API. For example, using SOAP, you can create metadata whose values are not legal HTTP headers.</p>\",\
@@ -4679,6 +4713,12 @@
           \"location\":\"uri\",\
           \"locationName\":\"Bucket\"\
         },\
+        \"ChecksumMode\":{\
+          \"shape\":\"ChecksumMode\",\
+          \"documentation\":\"<p>To retrieve the checksum of the object, this must be enabled.</p>\",\
+          \"location\":\"header\",\
+          \"locationName\":\"x-amz-checksum-mode\"\
+        },\
         \"IfMatch\":{\
           \"shape\":\"IfMatch\",\
           \"documentation\":\"<p>Return the object only if its entity tag (ETag) is the same as the one specified, otherwise return a 412 (precondition failed).</p>\",\
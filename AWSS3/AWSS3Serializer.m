@@ -162,6 +162,12 @@
     return self;
 }
 
+- (void)setResponseItemHandler:(AWSNetworkingResponseItemBlock)responseItemHandler {
+    if ([self.responseSerializer respondsToSelector:@selector(setResponseItemHandler:)]) {
+        [self.responseSerializer setResponseItemHandler:responseItemHandler];
+    }
+}
+
 static NSDictionary *errorCodeDictionary = nil;
 + (void)initialize {
     errorCodeDictionary = @{
@@ -157,6 +157,9 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
                                                                          
         AWSSignatureV4Signer *signer = [[AWSSignatureV4Signer alloc] initWithCredentialsProvider:_configuration.credentialsProvider
                                                                                         endpoint:_configuration.endpoint];
+        signer.payloadSigningMode = _configuration.payloadSigningMode;
+        signer.payloadChecksumAlgorithm = _configuration.payloadChecksumAlgorithm;
+        signer.payloadFileHashingEnabled = _configuration.payloadFileHashingEnabled;
         AWSNetworkingRequestInterceptor *baseInterceptor = [[AWSNetworkingRequestInterceptor alloc] initWithUserAgent:_configuration.userAgent];
         _configuration.requestInterceptors = @[baseInterceptor, signer];
 
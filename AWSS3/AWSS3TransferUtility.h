@@ -28,7 +28,8 @@ typedef NS_ENUM(NSInteger, AWSS3TransferUtilityErrorType) {
     AWSS3TransferUtilityErrorServerError,
     AWSS3TransferUtilityErrorLocalFileNotFound,
     AWSS3TransferUtilityErrorBaseDirectoryNotFound,
-    AWSS3TransferUtilityErrorPartialFileNotCreated
+    AWSS3TransferUtilityErrorPartialFileNotCreated,
+    AWSS3TransferUtilityErrorChecksumMismatch
 };
 
 
@@ -40,10 +41,12 @@ FOUNDATION_EXPORT NSString *const AWSS3TransferUtilityURLSessionDidBecomeInvalid
 @class AWSS3TransferUtilityUploadTask;
 @class AWSS3TransferUtilityMultiPartUploadTask;
 @class AWSS3TransferUtilityDownloadTask;
+@class AWSS3TransferUtilityMultiPartDownloadTask;
 @class AWSS3TransferUtilityExpression;
 @class AWSS3TransferUtilityUploadExpression;
 @class AWSS3TransferUtilityMultiPartUploadExpression;
 @class AWSS3TransferUtilityDownloadExpression;
+@class AWSS3TransferUtilityMultiPartDownloadExpression;
 
 #pragma mark - AWSS3TransferUtility
 
@@ -612,6 +615,45 @@ handleEventsForBackgroundURLSession:(NSString *)identifier
                                                     expression:(nullable AWSS3TransferUtilityDownloadExpression *)expression
                                              completionHandler:(nullable AWSS3TransferUtilityDownloadCompletionHandlerBlock)completionHandler;
 
+/**
+ Downloads the specified Amazon S3 object to a file URL from the bucket configured in `AWSS3TransferUtilityConfiguration` using MultiPart.
+
+ @param fileURL           The file URL to download the object to.
+ @param key               The Amazon S3 object key name.
+ @param expression        The container object to configure the download request.
+ @param completionHandler The completion handler when the download completes.
+
+ @return Returns an instance of `AWSTask`. On successful initialization, `task.result` contains an instance of `AWSS3TransferUtilityMultiPartDownloadTask`.
+ */
+- (AWSTask<AWSS3TransferUtilityMultiPartDownloadTask *> *)downloadUsingMultiPartToURL:(NSURL *)fileURL
+                                                                                 key:(NSString *)key
+                                                                          expression:(nullable AWSS3TransferUtilityMultiPartDownloadExpression *)expression
+                                                                   completionHandler:(nullable AWSS3TransferUtilityMultiPartDownloadCompletionHandlerBlock)completionHandler
+                                        NS_SWIFT_NAME(downloadUsingMultiPart(fileURL:key:expression:completionHandler:));
+
+/**
+ Downloads the specified Amazon S3 object to a file URL using MultiPart.
+
+ The object is split in byte ranges of the part size of a multipart upload of the same length, which are downloaded
+ concurrently, pinned to the ETag of the object, and written at their offsets in a file preallocated next to `fileURL`.
+ The ranges downloaded are recorded, so that a transfer recovered after the app was terminated only downloads the
+ remaining ones. The file is moved to `fileURL` once the checksum S3 stores for the object, if any, matches it.
+
+ @param fileURL           The file URL to download the object to.
+ @param bucket            The Amazon S3 bucket name.
+ @param key               The Amazon S3 object key name.
+ @param expression        The container object to configure the download request.
+ @param completionHandler The completion handler when the download completes.
+
+ @return Returns an instance of `AWSTask`. On successful initialization, `task.result` contains an instance of `AWSS3TransferUtilityMultiPartDownloadTask`.
+ */
+- (AWSTask<AWSS3TransferUtilityMultiPartDownloadTask *> *)downloadUsingMultiPartToURL:(NSURL *)fileURL
+                                                                              bucket:(NSString *)bucket
+                                                                                 key:(NSString *)key
+                                                                          expression:(nullable AWSS3TransferUtilityMultiPartDownloadExpression *)expression
+                                                                   completionHandler:(nullable AWSS3TransferUtilityMultiPartDownloadCompletionHandlerBlock)completionHandler
+                                        NS_SWIFT_NAME(downloadUsingMultiPart(fileURL:bucket:key:expression:completionHandler:));
+
 /**
  Assigns progress feedback and completion handler blocks. This method should be called when the app was suspended while the transfer is still happening.
 
@@ -672,6 +714,13 @@ handleEventsForBackgroundURLSession:(NSString *)identifier
  */
 - (AWSTask<NSArray<AWSS3TransferUtilityDownloadTask *> *> *)getDownloadTasks;
 
+/**
+ Retrieves all running MultiPart download tasks.
+
+ @return An array of `AWSS3TransferUtilityMultiPartDownloadTask`.
+ */
+- (AWSTask<NSArray<AWSS3TransferUtilityMultiPartDownloadTask *> *> *)getMultiPartDownloadTasks;
+
 @end
 
 #pragma mark - AWSS3TransferUtilityConfiguration
@@ -686,8 +735,37 @@ handleEventsForBackgroundURLSession:(NSString *)identifier
 
 @property (nonatomic, nullable) NSNumber *multiPartConcurrencyLimit;
 
+/**
+ When enabled, the part size of multipart uploads grows with the size of the file, to about 1,000 parts of up to 32 MB,
+ and the number of parts in progress is adjusted to the throughput of the upload and the parts failing, up to
+ `multiPartConcurrencyLimit`. The default is `NO`, which uploads parts of 5 MB, `multiPartConcurrencyLimit` at a time.
+
+ Either way, the part size grows past 5 MB when it takes more than 10,000 parts, the maximum number of parts of an
+ upload.
+ */
+@property (nonatomic, assign, getter=isMultiPartAutoTuningEnabled) BOOL multiPartAutoTuningEnabled;
+
 @property NSInteger timeoutIntervalForResource;
 
+/**
+ When set, single part uploads compute the checksum of the file before it is sent and send it in the matching
+ `x-amz-checksum-*` header, so S3 verifies the object it stores. The default is `AWSChecksumAlgorithmNone`.
+
+ The checksum reads the whole file before the upload starts. It is computed in the background lane of
+ `boundedExecutor` when it is set, and on a utility global queue otherwise, never on the calling thread.
+
+ Uploads use presigned URLs, whose payload is always `UNSIGNED-PAYLOAD`, and background sessions send the file as
+ is, so the checksum is sent as a header rather than as an aws-chunked trailer.
+ */
+@property (nonatomic, assign) AWSChecksumAlgorithm checksumAlgorithm;
+
+/**
+ When set, checksums of uploaded files are computed and the parts of multipart uploads are prepared in the background
+ lane of this executor, so that they do not compete with interactive work for threads. The default is `nil`, which runs
+ them on a utility global queue.
+ */
+@property (nonatomic, strong, nullable) AWSBoundedExecutor *boundedExecutor;
+
 @end
 
 NS_ASSUME_NONNULL_END
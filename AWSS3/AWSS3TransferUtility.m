@@ -17,13 +17,17 @@
 #import "AWSS3PreSignedURL.h"
 #import "AWSS3Service.h"
 #import "AWSS3TransferUtilityDatabaseHelper.h"
+#import "AWSS3TransferUtilityMultiPartTuner.h"
 #import "AWSS3TransferUtilityTasks.h"
 
 #import <AWSCore/AWSFMDB.h>
 #import <AWSCore/AWSSynchronizedMutableDictionary.h>
 #import <AWSCore/AWSXMLDictionary.h>
 
+#include <fcntl.h>
 #include <stdio.h>
+#include <sys/clonefile.h>
+#include <unistd.h>
 
 // Public constants
 NSString *const AWSS3TransferUtilityErrorDomain = @"com.amazonaws.AWSS3TransferUtilityErrorDomain";
@@ -39,6 +43,8 @@ static NSString *const AWSS3TransferUtilityRetrySucceeded = @"AWSS3TransferUtili
 static NSUInteger const AWSS3TransferUtilityMultiPartSize = 5 * 1024 * 1024;
 static NSString *const AWSS3TransferUtiltityRequestTimeoutErrorCode = @"RequestTimeout";
 static int const AWSS3TransferUtilityMultiPartDefaultConcurrencyLimit = 5;
+// The number of part files created ahead of the parts in progress, so that a finished part is followed without waiting for a copy.
+static NSUInteger const AWSS3TransferUtilityMultiPartPreparedPartCount = 2;
 
 
 #pragma mark - Private classes
@@ -59,6 +65,20 @@ static int const AWSS3TransferUtilityMultiPartDefaultConcurrencyLimit = 5;
 
 @end 
 
+@interface AWSS3TransferUtilityDownloadSubTask()
+@property (strong, nonatomic) NSURLSessionTask *sessionTask;
+@property (strong, nonatomic) NSNumber *partNumber;
+@property (readwrite) NSUInteger taskIdentifier;
+@property int64_t offset;
+@property int64_t totalBytesExpectedToReceive;
+@property int64_t totalBytesReceived;
+@property NSString *responseData;
+@property NSString *transferType;
+@property NSString *transferID;
+@property AWSS3TransferUtilityTransferStatusType status;
+@property (strong, nonatomic) NSError *error;
+@end
+
 @interface AWSS3TransferUtility() <NSURLSessionDelegate, NSURLSessionTaskDelegate, NSURLSessionDataDelegate>
 
 @property (strong, nonatomic) AWSServiceConfiguration *configuration;
@@ -106,10 +126,15 @@ static int const AWSS3TransferUtilityMultiPartDefaultConcurrencyLimit = 5;
 @property BOOL cancelled;
 @property BOOL temporaryFileCreated;
 @property NSMutableDictionary <NSNumber *, AWSS3TransferUtilityUploadSubTask *> *waitingPartsDictionary;
+@property (strong, nonatomic) NSMutableOrderedSet <AWSS3TransferUtilityUploadSubTask *> *waitingParts;
+@property (strong, nonatomic) NSMutableArray <AWSS3TransferUtilityUploadSubTask *> *pendingParts;
 @property (strong, nonatomic) NSMutableSet <AWSS3TransferUtilityUploadSubTask *> *completedPartsSet;
+@property int64_t completedPartsLength;
 @property (strong, nonatomic) NSMutableDictionary <NSNumber *, AWSS3TransferUtilityUploadSubTask *> *inProgressPartsDictionary;
 @property int retryCount;
 @property int partNumber;
+@property NSUInteger partSize;
+@property (strong, nonatomic) AWSS3TransferUtilityMultiPartTuner *tuner;
 @property NSString *file;
 @property NSString *transferType;
 @property NSString *nsURLSessionID;
@@ -129,6 +154,31 @@ static int const AWSS3TransferUtilityMultiPartDefaultConcurrencyLimit = 5;
 @property NSString *responseData;
 @end
 
+@interface AWSS3TransferUtilityMultiPartDownloadTask()
+
+@property (strong, nonatomic) AWSS3TransferUtilityMultiPartDownloadExpression *expression;
+@property BOOL cancelled;
+@property (strong, atomic) NSMutableArray <AWSS3TransferUtilityDownloadSubTask *> *pendingParts;
+@property (strong, atomic) NSMutableSet <AWSS3TransferUtilityDownloadSubTask *> *completedPartsSet;
+@property (strong, atomic) NSMutableDictionary <NSNumber *, AWSS3TransferUtilityDownloadSubTask *> *inProgressPartsDictionary;
+@property int retryCount;
+@property NSUInteger partSize;
+@property (strong, nonatomic) AWSS3TransferUtilityMultiPartTuner *tuner;
+@property NSString *file;
+@property NSString *transferType;
+@property NSString *nsURLSessionID;
+@property (strong) AWSFMDatabaseQueue *databaseQueue;
+@property (strong, nonatomic) NSError *error;
+@property (strong, nonatomic) NSString *bucket;
+@property (strong, nonatomic) NSString *key;
+@property (strong, nonatomic) NSString *transferID;
+@property (strong, nonatomic) NSURL *location;
+@property AWSS3TransferUtilityTransferStatusType status;
+@property NSNumber *contentLength;
+@property NSString *eTag;
+@property NSString *checksum;
+@end
+
 @interface AWSS3TransferUtilityExpression()
 
 @property (strong, nonatomic) NSMutableDictionary<NSString *, NSString *> *internalRequestHeaders;
@@ -161,6 +211,16 @@ static int const AWSS3TransferUtilityMultiPartDefaultConcurrencyLimit = 5;
 
 @end
 
+@interface AWSS3TransferUtilityMultiPartDownloadExpression()
+
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSString *> *internalRequestHeaders;
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSString *> *internalRequestParameters;
+- (void)assignRequestParameters:(AWSS3GetPreSignedURLRequest *)getPreSignedURLRequest;
+- (void)assignRequestHeaders:(AWSS3GetPreSignedURLRequest *)getPreSignedURLRequest;
+@property (copy, atomic) AWSS3TransferUtilityMultiPartDownloadCompletionHandlerBlock completionHandler;
+
+@end
+
 @interface AWSS3PreSignedURLBuilder()
 
 - (instancetype)initWithConfiguration:(AWSServiceConfiguration *)configuration;
@@ -199,6 +259,11 @@ static int const AWSS3TransferUtilityMultiPartDefaultConcurrencyLimit = 5;
                        retry_count: (NSUInteger) retryCount
                      databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
 
++ (void) updateTransferRequestInDB: (NSString *) transferID
+                        partNumber: (NSNumber *) partNumber
+                              file: (NSString *) file
+                     databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
+
 + (void) insertUploadTransferRequestInDB:(AWSS3TransferUtilityUploadTask *) task
                              databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
 
@@ -212,9 +277,18 @@ static int const AWSS3TransferUtilityMultiPartDefaultConcurrencyLimit = 5;
                                          subTask:(AWSS3TransferUtilityUploadSubTask *) subTask
                                    databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
 
++ (void) insertMultiPartDownloadRequestInDB:(AWSS3TransferUtilityMultiPartDownloadTask *) task
+                              databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
+
++ (void) insertMultiPartDownloadRequestSubTaskInDB:(AWSS3TransferUtilityMultiPartDownloadTask *) task
+                                           subTask:(AWSS3TransferUtilityDownloadSubTask *) subTask
+                                     databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
+
 + (NSMutableArray *) getTransferTaskDataFromDB:(NSString *)nsURLSessionID
                                  databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
 
++ (void) flushPendingWritesToDatabaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
+
 + (NSString *) getJSONRepresentation: (NSDictionary *) dict;
 + (NSDictionary*) getDictionaryFromJson: (NSString *)json;
 
@@ -385,6 +459,11 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
         [task cancel];
     }
     
+    NSArray<AWSS3TransferUtilityMultiPartDownloadTask *> *allMultiPartDownloads = [[transferUtility getMultiPartDownloadTasks] result];
+    for(AWSS3TransferUtilityMultiPartDownloadTask *task in allMultiPartDownloads) {
+        [task cancel];
+    }
+    
     //Close the session gracefully
     if (transferUtility) {
         [transferUtility.session finishTasksAndInvalidate];
@@ -583,15 +662,79 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
                 [AWSS3TransferUtilityDatabaseHelper deleteTransferRequestFromDB:subTask.transferID databaseQueue:self->_databaseQueue];
                 continue;
             }
+            //All parts but the last one have the part size of the upload.
+            if ([subTask.partNumber integerValue] == 1) {
+                multiPartUploadTask.partSize = (NSUInteger) subTask.totalBytesExpectedToSend;
+            }
+
             //Check if the subTask is is already completed. If it is, add it to the completed parts list, update the progress object and go to the next iteration of the loop
             if (subTask.status== AWSS3TransferUtilityTransferStatusCompleted ) {
                 [multiPartUploadTask.completedPartsSet addObject:subTask];
+                multiPartUploadTask.completedPartsLength += subTask.totalBytesExpectedToSend;
                 continue;
             }
             
+            //The file of a part is only created when the part is about to be uploaded. Parts without one have no NSURLSession task to link.
+            if ([subTask.file length] == 0) {
+                subTask.status = AWSS3TransferUtilityTransferStatusWaiting;
+                [multiPartUploadTask.pendingParts addObject:subTask];
+                continue;
+            }
+
             //The subTask must be in In_Progress, Waiting or Paused status. Lodge it in the temporary Dictionary for linking.
             [tempTransferDictionary setObject:subTask forKey:@(sessionTaskID)];
         }
+        else if ([transferType isEqualToString:@"MULTI_PART_DOWNLOAD"]) {
+            AWSS3TransferUtilityMultiPartDownloadTask *transferUtilityMultiPartDownloadTask = [self hydrateMultiPartDownloadTask:task sessionIdentifier:self.sessionIdentifier databaseQueue:self.databaseQueue];
+
+            //If task is completed, no more processing is required.
+            if (transferUtilityMultiPartDownloadTask.status == AWSS3TransferUtilityTransferStatusCompleted ||
+                transferUtilityMultiPartDownloadTask.status == AWSS3TransferUtilityTransferStatusUnknown ||
+                transferUtilityMultiPartDownloadTask.status == AWSS3TransferUtilityTransferStatusCancelled ||
+                transferUtilityMultiPartDownloadTask.status == AWSS3TransferUtilityTransferStatusError) {
+                [self.completedTaskDictionary setObject:transferUtilityMultiPartDownloadTask forKey:transferUtilityMultiPartDownloadTask.transferID];
+                [self removeFile:[self partialFilePathForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask]];
+                [AWSS3TransferUtilityDatabaseHelper deleteTransferRequestFromDB:transferUtilityMultiPartDownloadTask.transferID databaseQueue:self->_databaseQueue];
+                continue;
+            }
+
+            //Lodge in temporary Dictionary for linking
+            [tempMultiPartMasterTaskDictionary setObject:transferUtilityMultiPartDownloadTask forKey:transferUtilityMultiPartDownloadTask.transferID];
+            AWSDDLogDebug(@"Found MultiPartDownload [%@] with status [%@]",transferUtilityMultiPartDownloadTask.transferID, @(transferUtilityMultiPartDownloadTask.status) );
+        }
+        else if ([transferType isEqualToString:@"MULTI_PART_DOWNLOAD_SUB_TASK"]) {
+            AWSS3TransferUtilityDownloadSubTask *subTask = [self hydrateMultiPartDownloadSubTask:task sessionTaskID:sessionTaskID];
+            AWSDDLogDebug(@"Found MultiPartDownload SubTask [%@] with taskNumber [%@] and status [%@]",subTask.transferID,@(subTask.taskIdentifier), @(subTask.status) );
+
+            //Get the Master MultiPart record from the Dictionary.
+            AWSS3TransferUtilityMultiPartDownloadTask *multiPartDownloadTask = [tempMultiPartMasterTaskDictionary objectForKey:subTask.transferID];
+            if (![multiPartDownloadTask isKindOfClass:[AWSS3TransferUtilityMultiPartDownloadTask class]]) {
+                //Couldn't find the multipart download master record. Must be an orphan part record. Clean up the DB and continue.
+                [AWSS3TransferUtilityDatabaseHelper deleteTransferRequestFromDB:subTask.transferID databaseQueue:self->_databaseQueue];
+                continue;
+            }
+            //All ranges but the last one have the part size of the download.
+            if ([subTask.partNumber integerValue] == 1) {
+                multiPartDownloadTask.partSize = (NSUInteger) subTask.totalBytesExpectedToReceive;
+            }
+            subTask.offset = ([subTask.partNumber longLongValue] - 1) * (int64_t) multiPartDownloadTask.partSize;
+
+            //A completed range is already written to the file of the download.
+            if (subTask.status == AWSS3TransferUtilityTransferStatusCompleted) {
+                [multiPartDownloadTask.completedPartsSet addObject:subTask];
+                continue;
+            }
+
+            //Ranges that were never requested have no NSURLSession task to link.
+            if (sessionTaskID == 0) {
+                subTask.status = AWSS3TransferUtilityTransferStatusWaiting;
+                [multiPartDownloadTask.pendingParts addObject:subTask];
+                continue;
+            }
+
+            //Lodge it in the temporary Dictionary for linking.
+            [tempTransferDictionary setObject:subTask forKey:@(sessionTaskID)];
+        }
     }
 }
 
@@ -700,6 +843,25 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
                     }
                 }
             }
+            else if ([obj isKindOfClass:[AWSS3TransferUtilityDownloadSubTask class]])
+            {
+                //Found a range of a multipart download
+                AWSS3TransferUtilityDownloadSubTask *subTask = obj;
+                AWSS3TransferUtilityMultiPartDownloadTask *multiPartDownloadTask = [tempMultiPartMasterTaskDictionary objectForKey:subTask.transferID];
+                [tempTransferDictionary removeObjectForKey:@(task.taskIdentifier)];
+
+                //A range is written to the file of the download when the delegate gets its data. One that finished or failed while the app was not running is downloaded again.
+                if (taskError || ([task state] != NSURLSessionTaskStateRunning && [task state] != NSURLSessionTaskStateSuspended)) {
+                    [task cancel];
+                    subTask.status = AWSS3TransferUtilityTransferStatusWaiting;
+                    [multiPartDownloadTask.pendingParts addObject:subTask];
+                    continue;
+                }
+                subTask.sessionTask = task;
+                [multiPartDownloadTask.inProgressPartsDictionary setObject:subTask forKey:@(subTask.taskIdentifier)];
+                [self.taskDictionary setObject:multiPartDownloadTask forKey:@(subTask.taskIdentifier)];
+                AWSDDLogDebug(@"Added MultiPartDownload SubTask %@ to task dictionary", @(subTask.taskIdentifier));
+            }
             else {
                 AWSDDLogError(@"Object not found in taskDictionary for %lu",(unsigned long)task.taskIdentifier);
             }
@@ -771,10 +933,17 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
         else if([obj isKindOfClass:[AWSS3TransferUtilityUploadSubTask class]])
         {
             AWSS3TransferUtilityUploadSubTask *subTask = obj;
+            //The part is not in the NSURLSession. Upload it again, in order with the parts not started yet. Its file is reused.
             AWSS3TransferUtilityMultiPartUploadTask *multiPartUploadTask = [tempMultiPartMasterTaskDictionary objectForKey:subTask.uploadID];
-            [self retryUploadSubTask: multiPartUploadTask subTask:subTask startTransfer:NO];
             subTask.status = AWSS3TransferUtilityTransferStatusWaiting;
-            [multiPartUploadTask.waitingPartsDictionary setObject:subTask forKey:@(subTask.taskIdentifier)];
+            [multiPartUploadTask.pendingParts addObject:subTask];
+        }
+        else if ([obj isKindOfClass:[AWSS3TransferUtilityDownloadSubTask class]]) {
+            //The range is not in the NSURLSession. Download it again.
+            AWSS3TransferUtilityDownloadSubTask *subTask = obj;
+            AWSS3TransferUtilityMultiPartDownloadTask *multiPartDownloadTask = [tempMultiPartMasterTaskDictionary objectForKey:subTask.transferID];
+            subTask.status = AWSS3TransferUtilityTransferStatusWaiting;
+            [multiPartDownloadTask.pendingParts addObject:subTask];
         }
         else if ([obj isKindOfClass:[AWSS3TransferUtilityDownloadTask class]]) {
             
@@ -805,6 +974,11 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
     //During the recovery process, it is possible for the multipart transfer to not have an adequate number of parts in progress.
     //This loop below will check and ensure that the correct number of concurrent transfers are in progress.
     for (id obj in [tempMultiPartMasterTaskDictionary allKeys]) {
+        id multiPartTask = [tempMultiPartMasterTaskDictionary objectForKey:obj];
+        if ([multiPartTask isKindOfClass:[AWSS3TransferUtilityMultiPartDownloadTask class]]) {
+            [self scheduleRecoveredMultiPartDownloadTask:multiPartTask];
+            continue;
+        }
         NSString *uploadID = obj;
         
         AWSS3TransferUtilityMultiPartUploadTask *multiPartUploadTask = [tempMultiPartMasterTaskDictionary objectForKey:uploadID];
@@ -812,28 +986,16 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
         
         AWSDDLogDebug(@"Multipart transfer status is [%@]", @(multiPartUploadTask.status));
         
-        if (multiPartUploadTask.status == AWSS3TransferUtilityTransferStatusPaused) {
-            continue;
-        }
-        
-        long numberOfPartsInProgress = 0;
-        while (numberOfPartsInProgress < [self.transferUtilityConfiguration.multiPartConcurrencyLimit integerValue]) {
-            if ([multiPartUploadTask.waitingPartsDictionary count] > 0) {
-                //Get a part from the waitingList
-                AWSS3TransferUtilityUploadSubTask *nextSubTask = [[multiPartUploadTask.waitingPartsDictionary allValues] objectAtIndex:0];
-                
-                //Add to inProgress list
-                [multiPartUploadTask.inProgressPartsDictionary setObject:nextSubTask forKey:@(nextSubTask.taskIdentifier)];
-               
-                //Remove it from the waitingList
-                [multiPartUploadTask.waitingPartsDictionary removeObjectForKey:@(nextSubTask.taskIdentifier)];
-                AWSDDLogDebug(@"Moving Task[%@] to progress for Multipart[%@]", @(nextSubTask.taskIdentifier), multiPartUploadTask.uploadID);
-                [nextSubTask.sessionTask resume];
-            
-                numberOfPartsInProgress++;
-                continue;
-            }
-            break;
+        //Parts are recorded in order, but may have been read back in any order.
+        [multiPartUploadTask.pendingParts sortUsingComparator:^NSComparisonResult(AWSS3TransferUtilityUploadSubTask *subTask1, AWSS3TransferUtilityUploadSubTask *subTask2) {
+            return [subTask1.partNumber compare:subTask2.partNumber];
+        }];
+
+        //A paused transfer gets the files of its next parts too, so that resuming it starts them.
+        NSError *subTaskCreationError = [self scheduleUploadSubTasks:multiPartUploadTask
+                                                       startTransfer:multiPartUploadTask.status != AWSS3TransferUtilityTransferStatusPaused];
+        if (subTaskCreationError) {
+            [self failMultiPartUploadTask:multiPartUploadTask error:subTaskCreationError];
         }
     }
 }
@@ -929,6 +1091,49 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
     return subTask;
 }
 
+- (AWSS3TransferUtilityMultiPartDownloadTask *) hydrateMultiPartDownloadTask: (NSMutableDictionary *) task
+                                                           sessionIdentifier: (NSString *) sessionIdentifier
+                                                               databaseQueue: (AWSFMDatabaseQueue *) databaseQueue
+{
+    AWSS3TransferUtilityMultiPartDownloadTask *transferUtilityMultiPartDownloadTask = [AWSS3TransferUtilityMultiPartDownloadTask new];
+    transferUtilityMultiPartDownloadTask.nsURLSessionID = sessionIdentifier;
+    transferUtilityMultiPartDownloadTask.databaseQueue = databaseQueue;
+    transferUtilityMultiPartDownloadTask.transferType = [task objectForKey:@"transfer_type"];
+    transferUtilityMultiPartDownloadTask.bucket = [task objectForKey:@"bucket_name"];
+    transferUtilityMultiPartDownloadTask.key = [task objectForKey:@"key"];
+    transferUtilityMultiPartDownloadTask.expression = [AWSS3TransferUtilityMultiPartDownloadExpression new];
+    transferUtilityMultiPartDownloadTask.expression.internalRequestHeaders = [[AWSS3TransferUtilityDatabaseHelper getDictionaryFromJson:[task objectForKey:@"request_headers"]] mutableCopy];
+    transferUtilityMultiPartDownloadTask.expression.internalRequestParameters = [[AWSS3TransferUtilityDatabaseHelper getDictionaryFromJson:[task objectForKey:@"request_parameters"]] mutableCopy];
+    transferUtilityMultiPartDownloadTask.transferID = [task objectForKey:@"transfer_id"];
+    transferUtilityMultiPartDownloadTask.file = [task objectForKey:@"file"];
+    transferUtilityMultiPartDownloadTask.location = [NSURL fileURLWithPath:transferUtilityMultiPartDownloadTask.file];
+    transferUtilityMultiPartDownloadTask.contentLength = [task objectForKey:@"content_length"];
+    transferUtilityMultiPartDownloadTask.progress.totalUnitCount = [transferUtilityMultiPartDownloadTask.contentLength longLongValue];
+    transferUtilityMultiPartDownloadTask.cancelled = NO;
+    transferUtilityMultiPartDownloadTask.retryCount = [[task objectForKey:@"retry_count"] intValue];
+    transferUtilityMultiPartDownloadTask.eTag = [task objectForKey:@"etag"];
+    transferUtilityMultiPartDownloadTask.checksum = [task objectForKey:@"multi_part_id"];
+    NSNumber *statusValue = [task objectForKey:@"status"];
+    transferUtilityMultiPartDownloadTask.status = [statusValue intValue];
+    return transferUtilityMultiPartDownloadTask;
+}
+
+- (AWSS3TransferUtilityDownloadSubTask *) hydrateMultiPartDownloadSubTask:(NSMutableDictionary *) task
+                                                            sessionTaskID: (int) sessionTaskID
+{
+    AWSS3TransferUtilityDownloadSubTask *subTask = [AWSS3TransferUtilityDownloadSubTask new];
+    subTask.taskIdentifier = sessionTaskID;
+    subTask.transferType = [task objectForKey:@"transfer_type"];
+    subTask.partNumber = [task objectForKey:@"part_number"];
+    subTask.transferID = [task objectForKey:@"transfer_id"];
+    subTask.totalBytesExpectedToReceive = [[task objectForKey:@"content_length"] longLongValue];
+    subTask.responseData = @"";
+
+    NSNumber *statusValue = [task objectForKey:@"status"];
+    subTask.status = [statusValue intValue];
+    return subTask;
+}
+
 
 #pragma mark - Upload methods
 
@@ -1030,7 +1235,40 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
     }
     [expression setValue:contentType forRequestHeader:@"Content-Type"];
     expression.completionHandler = completionHandler;
-    
+
+    AWSChecksum *checksum = [AWSChecksum checksumWithAlgorithm:self.transferUtilityConfiguration.checksumAlgorithm];
+    if (checksum) {
+        // Compute the checksum off the calling thread; it is kept with the other request headers in the database.
+        return [AWSTask taskFromExecutor:[self transferExecutor] withBlock:^id{
+            NSError *checksumError = nil;
+            if (![checksum updateWithContentsOfURL:fileURL error:&checksumError]) {
+                if (temporaryFileCreated) {
+                    [self removeFile:[fileURL path]];
+                }
+                return [AWSTask taskWithError:checksumError];
+            }
+            [expression setValue:[checksum base64EncodedChecksum]
+                forRequestHeader:[AWSChecksum headerNameForAlgorithm:checksum.algorithm]];
+            return [self createUploadTaskForFile:fileURL
+                                          bucket:bucket
+                                             key:key
+                                      expression:expression
+                            temporaryFileCreated:temporaryFileCreated];
+        }];
+    }
+
+    return [self createUploadTaskForFile:fileURL
+                                  bucket:bucket
+                                     key:key
+                              expression:expression
+                    temporaryFileCreated:temporaryFileCreated];
+}
+
+- (AWSTask<AWSS3TransferUtilityUploadTask *> *)createUploadTaskForFile:(NSURL *)fileURL
+                                                                bucket:(NSString *)bucket
+                                                                   key:(NSString *)key
+                                                            expression:(AWSS3TransferUtilityUploadExpression *)expression
+                                                  temporaryFileCreated:(BOOL)temporaryFileCreated {
     //Create TransferUtility Upload Task
     AWSS3TransferUtilityUploadTask *transferUtilityUploadTask = [AWSS3TransferUtilityUploadTask new];
     transferUtilityUploadTask.nsURLSessionID = self.sessionIdentifier;
@@ -1315,8 +1553,11 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
     }
     unsigned long long fileSize = [attributes fileSize];
     AWSDDLogDebug(@"File size is %llu", fileSize);
-    NSUInteger partCount = ceil((float)fileSize /(unsigned long) AWSS3TransferUtilityMultiPartSize);
-    AWSDDLogDebug(@"Number of parts is %lu", (unsigned long) partCount);
+    NSUInteger partSize = [AWSS3TransferUtilityMultiPartTuner partSizeForContentLength:fileSize
+                                                                            autoTuning:self.transferUtilityConfiguration.isMultiPartAutoTuningEnabled];
+    NSUInteger partCount = (NSUInteger)((fileSize + partSize - 1) / partSize);
+    AWSDDLogDebug(@"Number of parts is %lu of %lu bytes", (unsigned long) partCount, (unsigned long) partSize);
+    transferUtilityMultiPartUploadTask.partSize = partSize;
     transferUtilityMultiPartUploadTask.progress.totalUnitCount = fileSize;
     transferUtilityMultiPartUploadTask.progress.completedUnitCount = (long long) 0;
     transferUtilityMultiPartUploadTask.cancelled = NO;
@@ -1330,7 +1571,7 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
     [self propagateHeaderInformation:uploadRequest expression:transferUtilityMultiPartUploadTask.expression];
     
     //Initiate the multi part
-    return [[self.s3 createMultipartUpload:uploadRequest] continueWithBlock:^id(AWSTask *task) {
+    return [[self.s3 createMultipartUpload:uploadRequest] continueWithExecutor:[self transferExecutor] withBlock:^id(AWSTask *task) {
         //Initiation of multi part failed.
         if (task.error) {
             if (transferUtilityMultiPartUploadTask.temporaryFileCreated) {
@@ -1361,11 +1602,11 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
         
         AWSDDLogInfo(@"Initiated multipart upload on server: %@", output.uploadId);
         AWSDDLogInfo(@"Concurrency Limit is %@", self.transferUtilityConfiguration.multiPartConcurrencyLimit);
-        //Loop through the file and upload the parts one by one
+        //Record all the parts. Their files are created as they get close to being uploaded.
         for (int32_t i = 1; i <= partCount ; i++) {
-            NSUInteger dataLength = AWSS3TransferUtilityMultiPartSize;
+            NSUInteger dataLength = partSize;
             if (i == partCount) {
-                dataLength = fileSize - ( (i-1) * AWSS3TransferUtilityMultiPartSize);
+                dataLength = fileSize - ( (i-1) * (unsigned long long) partSize);
             }
            
             AWSS3TransferUtilityUploadSubTask *subTask = [AWSS3TransferUtilityUploadSubTask new];
@@ -1377,47 +1618,27 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
             subTask.responseData = @"";
             subTask.file = @"";
             subTask.eTag = @"";
-            
-            NSError *subTaskCreationError;
-            
-            //Move to inProgress or Waiting based on concurrency limit
-            if (i <= [self.transferUtilityConfiguration.multiPartConcurrencyLimit integerValue]) {
-                subTaskCreationError = [self createUploadSubTask:transferUtilityMultiPartUploadTask subTask:subTask startTransfer:NO internalDictionaryToAddSubTaskTo:transferUtilityMultiPartUploadTask.inProgressPartsDictionary];
-                if(!subTaskCreationError) {
-                    subTask.status = AWSS3TransferUtilityTransferStatusInProgress;
-                    AWSDDLogDebug(@"Added task for part [%@] to inProgress list", subTask.partNumber);
-                }
-            }
-            else {
-                subTaskCreationError = [self createUploadSubTask:transferUtilityMultiPartUploadTask subTask:subTask startTransfer:NO internalDictionaryToAddSubTaskTo:transferUtilityMultiPartUploadTask.waitingPartsDictionary];
-                if (!subTaskCreationError ) {
-                    subTask.status = AWSS3TransferUtilityTransferStatusWaiting;
-                    AWSDDLogDebug(@"Added task for part [%@] to Waiting list", subTask.partNumber);
-                }
-            }
-            
-            if (!subTaskCreationError) {
-                //Save in Database after the file has been created, so that file can be referenced incase upload is paused and needs to be restarted.
-                [AWSS3TransferUtilityDatabaseHelper insertMultiPartUploadRequestSubTaskInDB:transferUtilityMultiPartUploadTask subTask:subTask
+            subTask.status = AWSS3TransferUtilityTransferStatusWaiting;
+            [transferUtilityMultiPartUploadTask.pendingParts addObject:subTask];
+
+            //Save in Database without a file, the file is recorded once it has been created.
+            [AWSS3TransferUtilityDatabaseHelper insertMultiPartUploadRequestSubTaskInDB:transferUtilityMultiPartUploadTask subTask:subTask
             databaseQueue:self.databaseQueue];
-            } else {
-                //Abort the request, so the server can clean up any partials.
-                [self callAbortMultiPartForUploadTask:transferUtilityMultiPartUploadTask];
-                transferUtilityMultiPartUploadTask.status = AWSS3TransferUtilityTransferStatusError;
-                //Add it to list of completed Tasks
-                [self.completedTaskDictionary setObject:transferUtilityMultiPartUploadTask forKey:transferUtilityMultiPartUploadTask.transferID];
-                //Clean up.
-                [self cleanupForMultiPartUploadTask:transferUtilityMultiPartUploadTask];
-                return [AWSTask taskWithError:subTaskCreationError];
-            }
-            
         }
-        
-        //Start the subTasks
-        for(id taskIdentifier in transferUtilityMultiPartUploadTask.inProgressPartsDictionary) {
-            AWSS3TransferUtilityUploadSubTask *subTask = [transferUtilityMultiPartUploadTask.inProgressPartsDictionary objectForKey:taskIdentifier];
-            AWSDDLogDebug(@"Starting subTask %@", @(subTask.taskIdentifier));
-            [subTask.sessionTask resume];
+        //Commit the upload and all its parts in a single transaction.
+        [AWSS3TransferUtilityDatabaseHelper flushPendingWritesToDatabaseQueue:self.databaseQueue];
+
+        //Create the files of the first parts and start them.
+        NSError *subTaskCreationError = [self scheduleUploadSubTasks:transferUtilityMultiPartUploadTask startTransfer:YES];
+        if (subTaskCreationError) {
+            //Abort the request, so the server can clean up any partials.
+            [self callAbortMultiPartForUploadTask:transferUtilityMultiPartUploadTask];
+            transferUtilityMultiPartUploadTask.status = AWSS3TransferUtilityTransferStatusError;
+            //Add it to list of completed Tasks
+            [self.completedTaskDictionary setObject:transferUtilityMultiPartUploadTask forKey:transferUtilityMultiPartUploadTask.transferID];
+            //Clean up.
+            [self cleanupForMultiPartUploadTask:transferUtilityMultiPartUploadTask];
+            return [AWSTask taskWithError:subTaskCreationError];
         }
         
         return [AWSTask taskWithResult:transferUtilityMultiPartUploadTask];
@@ -1425,12 +1646,23 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
     return [AWSTask taskWithResult:transferUtilityMultiPartUploadTask];
 }
 
+// Runs the work preparing transfers, in the background lane of `boundedExecutor` when it is set, and on a utility
+// global queue otherwise. The default executor would run it inline on the calling thread.
+- (AWSExecutor *)transferExecutor {
+    AWSBoundedExecutor *boundedExecutor = self.transferUtilityConfiguration.boundedExecutor;
+    if (boundedExecutor) {
+        return [boundedExecutor executorWithPriority:AWSExecutorPriorityBackground];
+    }
+    return [AWSExecutor executorWithDispatchQueue:dispatch_get_global_queue(QOS_CLASS_UTILITY, 0)];
+}
+
 - (NSString *)createTemporaryFileForPart:(NSString *)fileName
                               partNumber:(long)partNumber
+                                partSize:(NSUInteger)partSize
                               dataLength:(NSUInteger)dataLength
                                    error:(NSError **)error {
     NSURL *fileURL = [NSURL URLWithString:fileName];
-    NSUInteger offset = (partNumber - 1) * AWSS3TransferUtilityMultiPartSize;
+    NSUInteger offset = (partNumber - 1) * partSize;
 
     NSURL *partialFileURL = [self createPartialFile:fileURL offset:offset length:dataLength error:error];
     if (*error) {
@@ -1500,6 +1732,14 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
     NSURL *partialFileURL = [baseURL URLByAppendingPathComponent:filename];
     AWSDDLogInfo(@"Partial File URL: %@", partialFileURL);
 
+    //A part covering the whole file shares its data instead of copying it.
+    if (offset == 0
+        && length == [[[NSFileManager defaultManager] attributesOfItemAtPath:fileURL.path error:nil] fileSize]
+        && [self linkFile:fileURL toURL:partialFileURL]) {
+        [readFileHandle closeFile];
+        return partialFileURL;
+    }
+
     BOOL created = [[NSFileManager defaultManager] createFileAtPath:partialFileURL.path contents:nil attributes:nil];
     NSCAssert(created, @"File must be created");
     BOOL exists = [[NSFileManager defaultManager] fileExistsAtPath:partialFileURL.path];
@@ -1557,6 +1797,21 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
     return partialFileURL;
 }
 
+//Clones the file where the file system supports it, or else hard links it. Parts are only read, so they can share the data of the file.
+- (BOOL)linkFile:(NSURL *)fileURL
+           toURL:(NSURL *)linkURL {
+    if (@available(iOS 10.0, *)) {
+        if (clonefile(fileURL.fileSystemRepresentation, linkURL.fileSystemRepresentation, 0) == 0) {
+            return YES;
+        }
+    }
+    if (link(fileURL.fileSystemRepresentation, linkURL.fileSystemRepresentation) == 0) {
+        return YES;
+    }
+    AWSDDLogDebug(@"Unable to clone or link %@, copying it: %s", fileURL, strerror(errno));
+    return NO;
+}
+
 -(NSError *) createUploadSubTask:(AWSS3TransferUtilityMultiPartUploadTask *) transferUtilityMultiPartUploadTask
                          subTask: (AWSS3TransferUtilityUploadSubTask *) subTask
 internalDictionaryToAddSubTaskTo: (NSMutableDictionary *) internalDictionaryToAddSubTaskTo
@@ -1574,12 +1829,22 @@ internalDictionaryToAddSubTaskTo: (NSMutableDictionary *) internalDictionaryToAd
     //Create a temporary part file if required.
     if (!(subTask.file || [subTask.file isEqualToString:@""]) || ![[NSFileManager defaultManager] fileExistsAtPath:subTask.file]) {
         //Create a temporary file for this part.
-        NSString * partFileName = [self createTemporaryFileForPart:transferUtilityMultiPartUploadTask.file partNumber:[subTask.partNumber integerValue] dataLength:subTask.totalBytesExpectedToSend error:&error];
+        NSString * partFileName = [self createTemporaryFileForPart:transferUtilityMultiPartUploadTask.file
+                                                        partNumber:[subTask.partNumber integerValue]
+                                                          partSize:transferUtilityMultiPartUploadTask.partSize ?: AWSS3TransferUtilityMultiPartSize
+                                                        dataLength:subTask.totalBytesExpectedToSend
+                                                             error:&error];
         if (partFileName == nil)  {
             //Unable to create partFile. Send back error object to indicate that createUploadSubtask failed.
             return error;
         }
         subTask.file = partFileName;
+
+        //Record the file, so that the part can be resumed from it.
+        [AWSS3TransferUtilityDatabaseHelper updateTransferRequestInDB:subTask.transferID
+                                                           partNumber:subTask.partNumber
+                                                                 file:partFileName
+                                                        databaseQueue:self.databaseQueue];
     }
     
     //Create a presignedURL for this part.
@@ -1699,6 +1964,88 @@ internalDictionaryToAddSubTaskTo: (NSMutableDictionary *) internalDictionaryToAd
     }
 }
 
+//Creates the files of pending parts, in order, while the parts in progress and the waiting parts are fewer than the concurrency limit
+//plus the prepared parts, then moves waiting parts to inProgress up to the concurrency limit.
+-(NSError *) scheduleUploadSubTasks: (AWSS3TransferUtilityMultiPartUploadTask *) transferUtilityMultiPartUploadTask
+                      startTransfer: (BOOL) startTransfer {
+    NSUInteger concurrencyLimit = [self concurrencyLimitForMultiPartUploadTask:transferUtilityMultiPartUploadTask];
+    
+    while ([transferUtilityMultiPartUploadTask.pendingParts count] > 0
+           && [transferUtilityMultiPartUploadTask.inProgressPartsDictionary count] + [transferUtilityMultiPartUploadTask.waitingPartsDictionary count] < concurrencyLimit + AWSS3TransferUtilityMultiPartPreparedPartCount) {
+        AWSS3TransferUtilityUploadSubTask *subTask = [transferUtilityMultiPartUploadTask.pendingParts firstObject];
+        [transferUtilityMultiPartUploadTask.pendingParts removeObjectAtIndex:0];
+        
+        NSError *subTaskCreationError = [self createUploadSubTask:transferUtilityMultiPartUploadTask subTask:subTask startTransfer:NO internalDictionaryToAddSubTaskTo:transferUtilityMultiPartUploadTask.waitingPartsDictionary];
+        if (subTaskCreationError) {
+            return subTaskCreationError;
+        }
+        subTask.status = AWSS3TransferUtilityTransferStatusWaiting;
+        [transferUtilityMultiPartUploadTask.waitingParts addObject:subTask];
+        AWSDDLogDebug(@"Added task for part [%@] to Waiting list", subTask.partNumber);
+    }
+    
+    while ([transferUtilityMultiPartUploadTask.inProgressPartsDictionary count] < concurrencyLimit
+           && [transferUtilityMultiPartUploadTask.waitingParts count] > 0) {
+        //Get the first part from the waitingList. Parts are started in the order their files were created in.
+        AWSS3TransferUtilityUploadSubTask *nextSubTask = [transferUtilityMultiPartUploadTask.waitingParts firstObject];
+        [transferUtilityMultiPartUploadTask.waitingParts removeObjectAtIndex:0];
+        
+        //Add to inProgress list
+        [transferUtilityMultiPartUploadTask.inProgressPartsDictionary setObject:nextSubTask forKey:@(nextSubTask.taskIdentifier)];
+        
+        //Remove it from the waitingList
+        [transferUtilityMultiPartUploadTask.waitingPartsDictionary removeObjectForKey:@(nextSubTask.taskIdentifier)];
+        
+        if (startTransfer) {
+            AWSDDLogDebug(@"Moving Task[%@] to progress for Multipart[%@]", @(nextSubTask.taskIdentifier), transferUtilityMultiPartUploadTask.uploadID);
+            nextSubTask.status = AWSS3TransferUtilityTransferStatusInProgress;
+            [nextSubTask.sessionTask resume];
+        }
+        else {
+            //Started when the transfer is resumed.
+            nextSubTask.status = AWSS3TransferUtilityTransferStatusPaused;
+        }
+    }
+    return nil;
+}
+
+//The number of parts to keep in progress, chosen by the tuner of the transfer when auto-tuning is enabled.
+-(NSUInteger) concurrencyLimitForMultiPartUploadTask: (AWSS3TransferUtilityMultiPartUploadTask *) transferUtilityMultiPartUploadTask {
+    NSUInteger concurrencyLimit = [self.transferUtilityConfiguration.multiPartConcurrencyLimit unsignedIntegerValue];
+    if (!self.transferUtilityConfiguration.isMultiPartAutoTuningEnabled) {
+        return concurrencyLimit;
+    }
+    if (!transferUtilityMultiPartUploadTask.tuner) {
+        transferUtilityMultiPartUploadTask.tuner = [[AWSS3TransferUtilityMultiPartTuner alloc] initWithMaxConcurrency:concurrencyLimit];
+    }
+    return transferUtilityMultiPartUploadTask.tuner.concurrency;
+}
+
+-(void) failMultiPartUploadTask: (AWSS3TransferUtilityMultiPartUploadTask *) transferUtilityMultiPartUploadTask
+                          error: (NSError *) error {
+    transferUtilityMultiPartUploadTask.error = error;
+    transferUtilityMultiPartUploadTask.status = AWSS3TransferUtilityTransferStatusError;
+    
+    //Execute call back if provided.
+    if (transferUtilityMultiPartUploadTask.expression.completionHandler) {
+        transferUtilityMultiPartUploadTask.expression.completionHandler(transferUtilityMultiPartUploadTask, error);
+    }
+    
+    //Make sure all other parts are canceled.
+    for (AWSS3TransferUtilityUploadSubTask *subTask in [transferUtilityMultiPartUploadTask.inProgressPartsDictionary allValues]) {
+        [subTask.sessionTask cancel];
+    }
+    for (AWSS3TransferUtilityUploadSubTask *subTask in [transferUtilityMultiPartUploadTask.waitingPartsDictionary allValues]) {
+        [subTask.sessionTask cancel];
+    }
+    
+    //Abort the request, so the server can clean up any partials.
+    [self callAbortMultiPartForUploadTask:transferUtilityMultiPartUploadTask];
+    
+    //clean up.
+    [self cleanupForMultiPartUploadTask:transferUtilityMultiPartUploadTask];
+}
+
 #pragma mark - Download methods
 
 - (AWSTask<AWSS3TransferUtilityDownloadTask *> *)downloadDataForKey:(NSString *)key
@@ -1857,6 +2204,517 @@ internalDictionaryToAddSubTaskTo: (NSMutableDictionary *) internalDictionaryToAd
     [self createDownloadTask:transferUtilityDownloadTask];
 }
 
+#pragma mark - MultiPart Download methods
+
+- (AWSTask<AWSS3TransferUtilityMultiPartDownloadTask *> *)downloadUsingMultiPartToURL:(NSURL *)fileURL
+                                                                                 key:(NSString *)key
+                                                                          expression:(AWSS3TransferUtilityMultiPartDownloadExpression *)expression
+                                                                   completionHandler:(AWSS3TransferUtilityMultiPartDownloadCompletionHandlerBlock)completionHandler {
+    return [self downloadUsingMultiPartToURL:fileURL
+                                      bucket:self.transferUtilityConfiguration.bucket
+                                         key:key
+                                  expression:expression
+                           completionHandler:completionHandler];
+}
+
+- (AWSTask<AWSS3TransferUtilityMultiPartDownloadTask *> *)downloadUsingMultiPartToURL:(NSURL *)fileURL
+                                                                              bucket:(NSString *)bucket
+                                                                                 key:(NSString *)key
+                                                                          expression:(AWSS3TransferUtilityMultiPartDownloadExpression *)expression
+                                                                   completionHandler:(AWSS3TransferUtilityMultiPartDownloadCompletionHandlerBlock)completionHandler {
+    //Validate that bucket and key have been specified.
+    AWSTask *error = [self validateParameters:bucket key:key accelerationModeEnabled:self.transferUtilityConfiguration.isAccelerateModeEnabled];
+    if (error) {
+        return error;
+    }
+    if (![fileURL isFileURL]) {
+        NSDictionary *userInfo = [NSDictionary dictionaryWithObject:@"A file URL must be provided to download the object to"
+                                                             forKey:@"Message"];
+        return [AWSTask taskWithError:[NSError errorWithDomain:AWSS3TransferUtilityErrorDomain
+                                                          code:AWSS3TransferUtilityErrorClientError
+                                                      userInfo:userInfo]];
+    }
+
+    //Create Expression if required and set completion Handler.
+    if (!expression) {
+        expression = [AWSS3TransferUtilityMultiPartDownloadExpression new];
+    }
+    expression.completionHandler = completionHandler;
+
+    //Create TransferUtility Multipart Download Task
+    AWSS3TransferUtilityMultiPartDownloadTask *transferUtilityMultiPartDownloadTask = [AWSS3TransferUtilityMultiPartDownloadTask new];
+    transferUtilityMultiPartDownloadTask.nsURLSessionID = self.sessionIdentifier;
+    transferUtilityMultiPartDownloadTask.databaseQueue = self.databaseQueue;
+    transferUtilityMultiPartDownloadTask.transferType = @"MULTI_PART_DOWNLOAD";
+    transferUtilityMultiPartDownloadTask.bucket = bucket;
+    transferUtilityMultiPartDownloadTask.key = key;
+    transferUtilityMultiPartDownloadTask.expression = expression;
+    transferUtilityMultiPartDownloadTask.transferID = [[NSUUID UUID] UUIDString];
+    transferUtilityMultiPartDownloadTask.location = fileURL;
+    transferUtilityMultiPartDownloadTask.file = [fileURL path];
+    transferUtilityMultiPartDownloadTask.retryCount = 0;
+    transferUtilityMultiPartDownloadTask.cancelled = NO;
+    transferUtilityMultiPartDownloadTask.status = AWSS3TransferUtilityTransferStatusInProgress;
+
+    //Get the length, the ETag and the checksum of the object. Every range is requested from the version of the object they describe.
+    AWSS3HeadObjectRequest *headObjectRequest = [AWSS3HeadObjectRequest new];
+    headObjectRequest.bucket = bucket;
+    headObjectRequest.key = key;
+    headObjectRequest.checksumMode = AWSS3ChecksumModeEnabled;
+    headObjectRequest.versionId = expression.requestParameters[AWSS3PresignedURLVersionID];
+    headObjectRequest.SSECustomerAlgorithm = expression.requestHeaders[AWSS3PresignedURLServerSideEncryptionCustomerAlgorithm];
+    headObjectRequest.SSECustomerKey = expression.requestHeaders[AWSS3PresignedURLServerSideEncryptionCustomerKey];
+    headObjectRequest.SSECustomerKeyMD5 = expression.requestHeaders[AWSS3PresignedURLServerSdieEncryptionCustomerKeyMD5];
+
+    return [[self.s3 headObject:headObjectRequest] continueWithExecutor:[self transferExecutor] withBlock:^id(AWSTask *task) {
+        if (task.error) {
+            return [AWSTask taskWithError:task.error];
+        }
+
+        AWSS3HeadObjectOutput *output = task.result;
+        unsigned long long contentLength = [output.contentLength unsignedLongLongValue];
+        transferUtilityMultiPartDownloadTask.contentLength = [[NSNumber alloc] initWithUnsignedLongLong:contentLength];
+        transferUtilityMultiPartDownloadTask.eTag = output.ETag ?: @"";
+        transferUtilityMultiPartDownloadTask.checksum = [self checksumForHeadObjectOutput:output];
+        transferUtilityMultiPartDownloadTask.progress.totalUnitCount = contentLength;
+        transferUtilityMultiPartDownloadTask.progress.completedUnitCount = (long long) 0;
+
+        //Create the file the ranges are written to.
+        NSError *fileError = nil;
+        if (![self preallocateFile:[self partialFilePathForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask]
+                            length:contentLength
+                             error:&fileError]) {
+            return [AWSTask taskWithError:fileError];
+        }
+
+        NSUInteger partSize = [AWSS3TransferUtilityMultiPartTuner partSizeForContentLength:contentLength
+                                                                                autoTuning:self.transferUtilityConfiguration.isMultiPartAutoTuningEnabled];
+        NSUInteger partCount = (NSUInteger)((contentLength + partSize - 1) / partSize);
+        AWSDDLogDebug(@"Number of ranges is %lu of %lu bytes", (unsigned long) partCount, (unsigned long) partSize);
+        transferUtilityMultiPartDownloadTask.partSize = partSize;
+
+        //Save the Multipart Download in the DB
+        [AWSS3TransferUtilityDatabaseHelper insertMultiPartDownloadRequestInDB:transferUtilityMultiPartDownloadTask databaseQueue:self->_databaseQueue];
+
+        //Record all the ranges, so that the ones downloaded are not requested again when the transfer is recovered.
+        for (int32_t i = 1; i <= partCount; i++) {
+            AWSS3TransferUtilityDownloadSubTask *subTask = [AWSS3TransferUtilityDownloadSubTask new];
+            subTask.transferID = transferUtilityMultiPartDownloadTask.transferID;
+            subTask.partNumber = @(i);
+            subTask.transferType = @"MULTI_PART_DOWNLOAD_SUB_TASK";
+            subTask.offset = (i - 1) * (int64_t) partSize;
+            subTask.totalBytesExpectedToReceive = MIN((int64_t) partSize, (int64_t) contentLength - subTask.offset);
+            subTask.totalBytesReceived = (long long) 0;
+            subTask.responseData = @"";
+            subTask.status = AWSS3TransferUtilityTransferStatusWaiting;
+            [transferUtilityMultiPartDownloadTask.pendingParts addObject:subTask];
+
+            [AWSS3TransferUtilityDatabaseHelper insertMultiPartDownloadRequestSubTaskInDB:transferUtilityMultiPartDownloadTask
+                                                                                  subTask:subTask
+                                                                            databaseQueue:self.databaseQueue];
+        }
+        //Commit the download and all its ranges in a single transaction.
+        [AWSS3TransferUtilityDatabaseHelper flushPendingWritesToDatabaseQueue:self.databaseQueue];
+        [self.taskDictionary setObject:transferUtilityMultiPartDownloadTask forKey:transferUtilityMultiPartDownloadTask.transferID];
+
+        //An empty object has no range to download.
+        if (partCount == 0) {
+            [self finishMultiPartDownloadTask:transferUtilityMultiPartDownloadTask];
+            return [AWSTask taskWithResult:transferUtilityMultiPartDownloadTask];
+        }
+
+        NSError *subTaskCreationError = [self scheduleDownloadSubTasks:transferUtilityMultiPartDownloadTask startTransfer:YES];
+        if (subTaskCreationError) {
+            transferUtilityMultiPartDownloadTask.error = subTaskCreationError;
+            transferUtilityMultiPartDownloadTask.status = AWSS3TransferUtilityTransferStatusError;
+            [self cleanupForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask];
+            return [AWSTask taskWithError:subTaskCreationError];
+        }
+
+        return [AWSTask taskWithResult:transferUtilityMultiPartDownloadTask];
+    }];
+}
+
+//The ranges are written next to the destination, so that moving the file there once it is complete does not copy it.
+- (NSString *)partialFilePathForMultiPartDownloadTask:(AWSS3TransferUtilityMultiPartDownloadTask *)transferUtilityMultiPartDownloadTask {
+    return [transferUtilityMultiPartDownloadTask.file stringByAppendingFormat:@".%@.part", transferUtilityMultiPartDownloadTask.transferID];
+}
+
+//Returns the checksum of the whole object as `header:value`, or an empty string. A checksum ending with `-<part count>` is computed
+//from the checksums of the parts of a multipart upload, which the downloaded file cannot be checked against.
+- (NSString *)checksumForHeadObjectOutput:(AWSS3HeadObjectOutput *)output {
+    NSArray<NSNumber *> *algorithms = @[@(AWSChecksumAlgorithmCRC64NVME), @(AWSChecksumAlgorithmCRC32C), @(AWSChecksumAlgorithmCRC32)];
+    NSArray<NSString *> *checksums = @[output.checksumCRC64NVME ?: @"", output.checksumCRC32C ?: @"", output.checksumCRC32 ?: @""];
+    for (NSUInteger i = 0; i < [algorithms count]; i++) {
+        NSString *checksum = checksums[i];
+        if ([checksum length] > 0 && [checksum rangeOfString:@"-"].location == NSNotFound) {
+            return [NSString stringWithFormat:@"%@:%@", [AWSChecksum headerNameForAlgorithm:[algorithms[i] integerValue]], checksum];
+        }
+    }
+    return @"";
+}
+
+//Creates the file with the length of the object. Its blocks are allocated up front where the file system allows it, so that
+//ranges written out of order do not fragment it and a download that cannot fit fails before requesting anything.
+- (BOOL)preallocateFile:(NSString *)path
+                 length:(unsigned long long)length
+                  error:(NSError **)error {
+    int fileDescriptor = open([path fileSystemRepresentation], O_RDWR | O_CREAT, 0644);
+    if (fileDescriptor < 0) {
+        *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSFilePathErrorKey : path}];
+        return NO;
+    }
+
+    fstore_t store = {F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, (off_t) length, 0};
+    if (length > 0 && fcntl(fileDescriptor, F_PREALLOCATE, &store) == -1) {
+        store.fst_flags = F_ALLOCATEALL;
+        if (fcntl(fileDescriptor, F_PREALLOCATE, &store) == -1 && errno == ENOSPC) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:ENOSPC userInfo:@{NSFilePathErrorKey : path}];
+            close(fileDescriptor);
+            [self removeFile:path];
+            return NO;
+        }
+    }
+
+    if (ftruncate(fileDescriptor, (off_t) length) != 0) {
+        *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSFilePathErrorKey : path}];
+        close(fileDescriptor);
+        [self removeFile:path];
+        return NO;
+    }
+    close(fileDescriptor);
+    return YES;
+}
+
+//Copies a downloaded range into the file of the download at the offset of the range.
+- (BOOL)writeRangeFile:(NSURL *)rangeFileURL
+                toFile:(NSString *)path
+              atOffset:(int64_t)offset
+                 error:(NSError **)error {
+    NSFileHandle *readFileHandle = [NSFileHandle fileHandleForReadingFromURL:rangeFileURL error:error];
+    if (*error) {
+        return NO;
+    }
+    NSFileHandle *writeFileHandle = [NSFileHandle fileHandleForWritingToURL:[NSURL fileURLWithPath:path] error:error];
+    if (*error) {
+        [readFileHandle closeFile];
+        return NO;
+    }
+
+    if (@available(iOS 13.0, *)) {
+        [writeFileHandle seekToOffset:offset error:error];
+    } else {
+        [writeFileHandle seekToFileOffset:offset];
+    }
+
+    while (!*error) {
+        @autoreleasepool {
+            NSData *data;
+            if (@available(iOS 13.0, *)) {
+                data = [readFileHandle readDataUpToLength:AWSS3TransferUtilityMultiPartSize error:error];
+            } else {
+                data = [readFileHandle readDataOfLength:AWSS3TransferUtilityMultiPartSize];
+            }
+            if (*error || [data length] == 0) {
+                break;
+            }
+
+            if (@available(iOS 13.0, *)) {
+                [writeFileHandle writeData:data error:error];
+            } else {
+                [writeFileHandle writeData:data];
+            }
+        }
+    }
+
+    [readFileHandle closeFile];
+    [writeFileHandle closeFile];
+    return *error == nil;
+}
+
+//Checks the file of a download against the checksum S3 returned for the object, recorded as `header:value`.
+- (BOOL)validateChecksum:(NSString *)checksum
+                  ofFile:(NSString *)path
+                   error:(NSError **)error {
+    NSRange separator = [checksum rangeOfString:@":"];
+    if ([checksum length] == 0 || separator.location == NSNotFound) {
+        //The object has no checksum of its content.
+        return YES;
+    }
+    NSString *headerName = [checksum substringToIndex:separator.location];
+    NSString *expectedChecksum = [checksum substringFromIndex:NSMaxRange(separator)];
+
+    AWSChecksum *fileChecksum = nil;
+    for (NSNumber *algorithm in @[@(AWSChecksumAlgorithmCRC64NVME), @(AWSChecksumAlgorithmCRC32C), @(AWSChecksumAlgorithmCRC32)]) {
+        if ([headerName isEqualToString:[AWSChecksum headerNameForAlgorithm:[algorithm integerValue]]]) {
+            fileChecksum = [AWSChecksum checksumWithAlgorithm:[algorithm integerValue]];
+        }
+    }
+    if (!fileChecksum) {
+        return YES;
+    }
+    if (![fileChecksum updateWithContentsOfURL:[NSURL fileURLWithPath:path] error:error]) {
+        return NO;
+    }
+
+    NSString *actualChecksum = [fileChecksum base64EncodedChecksum];
+    if (![actualChecksum isEqualToString:expectedChecksum]) {
+        NSString *errorMessage = [NSString stringWithFormat:@"The %@ of the downloaded file is [%@], but S3 returned [%@]. Failing transfer", headerName, actualChecksum, expectedChecksum];
+        NSDictionary *userInfo = [NSDictionary dictionaryWithObject:errorMessage
+                                                             forKey:@"Message"];
+        *error = [NSError errorWithDomain:AWSS3TransferUtilityErrorDomain
+                                     code:AWSS3TransferUtilityErrorChecksumMismatch
+                                 userInfo:userInfo];
+        return NO;
+    }
+    return YES;
+}
+
+-(NSError *) createDownloadSubTask:(AWSS3TransferUtilityMultiPartDownloadTask *) transferUtilityMultiPartDownloadTask
+                           subTask: (AWSS3TransferUtilityDownloadSubTask *) subTask
+                     startTransfer: (BOOL) startTransfer
+{
+    __block NSError *error = nil;
+
+    //Create a presignedURL for this range.
+    AWSS3GetPreSignedURLRequest *request = [AWSS3GetPreSignedURLRequest new];
+    request.bucket = transferUtilityMultiPartDownloadTask.bucket;
+    request.key = transferUtilityMultiPartDownloadTask.key;
+    request.HTTPMethod = AWSHTTPMethodGET;
+    request.expires = [NSDate dateWithTimeIntervalSinceNow:_transferUtilityConfiguration.timeoutIntervalForResource];
+    request.minimumCredentialsExpirationInterval = _transferUtilityConfiguration.timeoutIntervalForResource;
+    request.accelerateModeEnabled = self.transferUtilityConfiguration.isAccelerateModeEnabled;
+
+    [transferUtilityMultiPartDownloadTask.expression assignRequestHeaders:request];
+    [transferUtilityMultiPartDownloadTask.expression assignRequestParameters:request];
+
+    [[[self.preSignedURLBuilder getPreSignedURL:request] continueWithBlock:^id(AWSTask *task) {
+        error = task.error;
+        if ( error ) {
+            return nil;
+        }
+
+        NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:task.result];
+        urlRequest.cachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+        urlRequest.HTTPMethod = @"GET";
+        for (NSString *key in transferUtilityMultiPartDownloadTask.expression.requestHeaders) {
+            [urlRequest setValue:transferUtilityMultiPartDownloadTask.expression.requestHeaders[key] forHTTPHeaderField:key];
+        }
+        [urlRequest setValue:[self.configuration.userAgent stringByAppendingString:@" MultiPart"] forHTTPHeaderField:@"User-Agent"];
+        [urlRequest setValue:[NSString stringWithFormat:@"bytes=%lld-%lld", subTask.offset, subTask.offset + subTask.totalBytesExpectedToReceive - 1]
+          forHTTPHeaderField:@"Range"];
+        //Fail the range rather than mix two versions of the object in the file.
+        if ([transferUtilityMultiPartDownloadTask.eTag length] > 0) {
+            [urlRequest setValue:transferUtilityMultiPartDownloadTask.eTag forHTTPHeaderField:@"If-Match"];
+        }
+
+        NSURLSessionDownloadTask *downloadTask = [self.session downloadTaskWithRequest:urlRequest];
+        subTask.sessionTask = downloadTask;
+        subTask.taskIdentifier = downloadTask.taskIdentifier;
+        if (startTransfer) {
+            subTask.status = AWSS3TransferUtilityTransferStatusInProgress;
+        }
+        else {
+            subTask.status = AWSS3TransferUtilityTransferStatusPaused;
+        }
+
+        //Register transferUtilityMultiPartDownloadTask into the taskDictionary for easy lookup in the NSURLCallback
+        [self->_taskDictionary setObject:transferUtilityMultiPartDownloadTask forKey:@(subTask.taskIdentifier)];
+        [transferUtilityMultiPartDownloadTask.inProgressPartsDictionary setObject:subTask forKey:@(subTask.taskIdentifier)];
+
+        //Update Database
+        [AWSS3TransferUtilityDatabaseHelper updateTransferRequestInDB:subTask.transferID
+                                                           partNumber:subTask.partNumber
+                                                       taskIdentifier:subTask.taskIdentifier
+                                                                 eTag:@""
+                                                               status:subTask.status
+                                                          retry_count:transferUtilityMultiPartDownloadTask.retryCount
+                                                        databaseQueue:self.databaseQueue];
+
+        if (startTransfer) {
+            AWSDDLogDebug(@"Starting range [%@] of MultiPartDownload [%@]", subTask.partNumber, transferUtilityMultiPartDownloadTask.transferID);
+            [downloadTask resume];
+        }
+        return nil;
+    }] waitUntilFinished];
+    return error;
+}
+
+-(void) retryDownloadSubTask: (AWSS3TransferUtilityMultiPartDownloadTask *) transferUtilityMultiPartDownloadTask
+                     subTask: (AWSS3TransferUtilityDownloadSubTask *) subTask {
+    [self.taskDictionary removeObjectForKey:@(subTask.taskIdentifier)];
+    [transferUtilityMultiPartDownloadTask.inProgressPartsDictionary removeObjectForKey:@(subTask.taskIdentifier)];
+    transferUtilityMultiPartDownloadTask.retryCount = transferUtilityMultiPartDownloadTask.retryCount + 1;
+    subTask.totalBytesReceived = (long long) 0;
+    subTask.responseData = @"";
+    subTask.error = nil;
+
+    NSError *subTaskCreationError = [self createDownloadSubTask:transferUtilityMultiPartDownloadTask
+                                                        subTask:subTask
+                                                  startTransfer:transferUtilityMultiPartDownloadTask.status != AWSS3TransferUtilityTransferStatusPaused];
+    if (subTaskCreationError) {
+        [self failMultiPartDownloadTask:transferUtilityMultiPartDownloadTask error:subTaskCreationError];
+    }
+}
+
+//Requests pending ranges, in order, while the ranges in progress are fewer than the concurrency limit.
+-(NSError *) scheduleDownloadSubTasks: (AWSS3TransferUtilityMultiPartDownloadTask *) transferUtilityMultiPartDownloadTask
+                        startTransfer: (BOOL) startTransfer {
+    NSUInteger concurrencyLimit = [self concurrencyLimitForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask];
+
+    while ([transferUtilityMultiPartDownloadTask.pendingParts count] > 0
+           && [transferUtilityMultiPartDownloadTask.inProgressPartsDictionary count] < concurrencyLimit) {
+        AWSS3TransferUtilityDownloadSubTask *subTask = [transferUtilityMultiPartDownloadTask.pendingParts firstObject];
+        [transferUtilityMultiPartDownloadTask.pendingParts removeObjectAtIndex:0];
+
+        NSError *subTaskCreationError = [self createDownloadSubTask:transferUtilityMultiPartDownloadTask subTask:subTask startTransfer:startTransfer];
+        if (subTaskCreationError) {
+            return subTaskCreationError;
+        }
+    }
+    return nil;
+}
+
+//The number of ranges to keep in progress, chosen by the tuner of the transfer when auto-tuning is enabled.
+-(NSUInteger) concurrencyLimitForMultiPartDownloadTask: (AWSS3TransferUtilityMultiPartDownloadTask *) transferUtilityMultiPartDownloadTask {
+    NSUInteger concurrencyLimit = [self.transferUtilityConfiguration.multiPartConcurrencyLimit unsignedIntegerValue];
+    if (!self.transferUtilityConfiguration.isMultiPartAutoTuningEnabled) {
+        return concurrencyLimit;
+    }
+    if (!transferUtilityMultiPartDownloadTask.tuner) {
+        transferUtilityMultiPartDownloadTask.tuner = [[AWSS3TransferUtilityMultiPartTuner alloc] initWithMaxConcurrency:concurrencyLimit];
+    }
+    return transferUtilityMultiPartDownloadTask.tuner.concurrency;
+}
+
+-(void) scheduleRecoveredMultiPartDownloadTask: (AWSS3TransferUtilityMultiPartDownloadTask *) transferUtilityMultiPartDownloadTask {
+    [self.taskDictionary setObject:transferUtilityMultiPartDownloadTask forKey:transferUtilityMultiPartDownloadTask.transferID];
+    AWSDDLogDebug(@"Multipart download status is [%@]", @(transferUtilityMultiPartDownloadTask.status));
+
+    //Ranges are recorded in order, but may have been read back in any order.
+    [transferUtilityMultiPartDownloadTask.pendingParts sortUsingComparator:^NSComparisonResult(AWSS3TransferUtilityDownloadSubTask *subTask1, AWSS3TransferUtilityDownloadSubTask *subTask2) {
+        return [subTask1.partNumber compare:subTask2.partNumber];
+    }];
+    [self updateProgressForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask];
+
+    //The ranges already downloaded are in the file of the download.
+    if (![[NSFileManager defaultManager] fileExistsAtPath:[self partialFilePathForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask]]) {
+        NSDictionary *userInfo = @{NSLocalizedDescriptionKey:[NSString stringWithFormat:@"Local file not found: %@", [self partialFilePathForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask]]};
+        [self failMultiPartDownloadTask:transferUtilityMultiPartDownloadTask
+                                  error:[NSError errorWithDomain:AWSS3TransferUtilityErrorDomain
+                                                            code:AWSS3TransferUtilityErrorLocalFileNotFound
+                                                        userInfo:userInfo]];
+        return;
+    }
+
+    if ([transferUtilityMultiPartDownloadTask.pendingParts count] == 0 && [transferUtilityMultiPartDownloadTask.inProgressPartsDictionary count] == 0) {
+        [self finishMultiPartDownloadTask:transferUtilityMultiPartDownloadTask];
+        return;
+    }
+
+    NSError *subTaskCreationError = [self scheduleDownloadSubTasks:transferUtilityMultiPartDownloadTask
+                                                     startTransfer:transferUtilityMultiPartDownloadTask.status != AWSS3TransferUtilityTransferStatusPaused];
+    if (subTaskCreationError) {
+        [self failMultiPartDownloadTask:transferUtilityMultiPartDownloadTask error:subTaskCreationError];
+    }
+}
+
+- (void)updateProgressForMultiPartDownloadTask:(AWSS3TransferUtilityMultiPartDownloadTask *)transferUtilityMultiPartDownloadTask {
+    int64_t totalBytesReceived = 0;
+    for (AWSS3TransferUtilityDownloadSubTask *subTask in transferUtilityMultiPartDownloadTask.completedPartsSet) {
+        totalBytesReceived += subTask.totalBytesExpectedToReceive;
+    }
+    for (AWSS3TransferUtilityDownloadSubTask *subTask in [transferUtilityMultiPartDownloadTask.inProgressPartsDictionary allValues]) {
+        totalBytesReceived += subTask.totalBytesReceived;
+    }
+
+    if (transferUtilityMultiPartDownloadTask.progress.completedUnitCount != totalBytesReceived) {
+        transferUtilityMultiPartDownloadTask.progress.totalUnitCount = [transferUtilityMultiPartDownloadTask.contentLength longLongValue];
+        transferUtilityMultiPartDownloadTask.progress.completedUnitCount = totalBytesReceived;
+        if (transferUtilityMultiPartDownloadTask.expression.progressBlock) {
+            transferUtilityMultiPartDownloadTask.expression.progressBlock(transferUtilityMultiPartDownloadTask, transferUtilityMultiPartDownloadTask.progress);
+        }
+    }
+}
+
+//Checks the file once all the ranges have been written to it, then moves it to the location of the download.
+-(void) finishMultiPartDownloadTask: (AWSS3TransferUtilityMultiPartDownloadTask *) transferUtilityMultiPartDownloadTask {
+    int64_t totalBytesReceived = 0;
+    for (AWSS3TransferUtilityDownloadSubTask *subTask in transferUtilityMultiPartDownloadTask.completedPartsSet) {
+        totalBytesReceived += subTask.totalBytesExpectedToReceive;
+    }
+    if (totalBytesReceived != [transferUtilityMultiPartDownloadTask.contentLength longLongValue]) {
+        NSString *errorMessage = [NSString stringWithFormat:@"Expected to receive [%@], but received [%lld] and there are no remaining ranges. Failing transfer", transferUtilityMultiPartDownloadTask.contentLength, totalBytesReceived];
+        NSDictionary *userInfo = [NSDictionary dictionaryWithObject:errorMessage
+                                                             forKey:@"Message"];
+        [self failMultiPartDownloadTask:transferUtilityMultiPartDownloadTask
+                                  error:[NSError errorWithDomain:AWSS3TransferUtilityErrorDomain
+                                                            code:AWSS3TransferUtilityErrorClientError
+                                                        userInfo:userInfo]];
+        return;
+    }
+
+    //The checksum reads the whole file, so it is not computed on the delegate queue of the session.
+    [AWSTask taskFromExecutor:[self transferExecutor] withBlock:^id{
+        NSString *partialFilePath = [self partialFilePathForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask];
+        NSURL *partialFileURL = [NSURL fileURLWithPath:partialFilePath];
+        NSError *error = nil;
+        BOOL moved = NO;
+        if ([self validateChecksum:transferUtilityMultiPartDownloadTask.checksum ofFile:partialFilePath error:&error]) {
+            if ([[NSFileManager defaultManager] fileExistsAtPath:transferUtilityMultiPartDownloadTask.file]) {
+                moved = [[NSFileManager defaultManager] replaceItemAtURL:transferUtilityMultiPartDownloadTask.location
+                                                           withItemAtURL:partialFileURL
+                                                          backupItemName:nil
+                                                                 options:0
+                                                        resultingItemURL:nil
+                                                                   error:&error];
+            }
+            else {
+                moved = [[NSFileManager defaultManager] moveItemAtURL:partialFileURL
+                                                                toURL:transferUtilityMultiPartDownloadTask.location
+                                                                error:&error];
+            }
+        }
+        if (!moved) {
+            [self failMultiPartDownloadTask:transferUtilityMultiPartDownloadTask error:error];
+            return nil;
+        }
+
+        AWSDDLogInfo(@"Completed MultiPartDownload [%@]", transferUtilityMultiPartDownloadTask.transferID);
+        transferUtilityMultiPartDownloadTask.status = AWSS3TransferUtilityTransferStatusCompleted;
+        transferUtilityMultiPartDownloadTask.progress.totalUnitCount = [transferUtilityMultiPartDownloadTask.contentLength longLongValue];
+        transferUtilityMultiPartDownloadTask.progress.completedUnitCount = transferUtilityMultiPartDownloadTask.progress.totalUnitCount;
+        if (transferUtilityMultiPartDownloadTask.expression.progressBlock) {
+            transferUtilityMultiPartDownloadTask.expression.progressBlock(transferUtilityMultiPartDownloadTask, transferUtilityMultiPartDownloadTask.progress);
+        }
+        [self cleanupForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask];
+
+        if (transferUtilityMultiPartDownloadTask.expression.completionHandler) {
+            transferUtilityMultiPartDownloadTask.expression.completionHandler(transferUtilityMultiPartDownloadTask, transferUtilityMultiPartDownloadTask.location, nil);
+        }
+        return nil;
+    }];
+}
+
+-(void) failMultiPartDownloadTask: (AWSS3TransferUtilityMultiPartDownloadTask *) transferUtilityMultiPartDownloadTask
+                            error: (NSError *) error {
+    transferUtilityMultiPartDownloadTask.error = error;
+    transferUtilityMultiPartDownloadTask.status = AWSS3TransferUtilityTransferStatusError;
+
+    //Execute call back if provided.
+    if (transferUtilityMultiPartDownloadTask.expression.completionHandler) {
+        transferUtilityMultiPartDownloadTask.expression.completionHandler(transferUtilityMultiPartDownloadTask, nil, error);
+    }
+
+    //Make sure all other ranges are canceled.
+    for (AWSS3TransferUtilityDownloadSubTask *subTask in [transferUtilityMultiPartDownloadTask.inProgressPartsDictionary allValues]) {
+        [subTask.sessionTask cancel];
+    }
+
+    //clean up.
+    [self cleanupForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask];
+}
+
 #pragma mark - Utility methods
 
 - (void)enumerateToAssignBlocksForUploadTask:(void (^)(AWSS3TransferUtilityUploadTask *uploadTask,
@@ -1894,8 +2752,7 @@ internalDictionaryToAddSubTaskTo: (NSMutableDictionary *) internalDictionaryToAd
                                                                AWSS3TransferUtilityProgressBlock *downloadProgressBlockReference,
                                                                AWSS3TransferUtilityDownloadCompletionHandlerBlock *completionHandlerReference))downloadBlocksAssigner {
     // Iterate all tasks
-    for (id key in [self.taskDictionary allKeys]) {
-        id value = [self.taskDictionary objectForKey:key];
+    for (id value in [self.taskDictionary allValues]) {
         if (uploadBlocksAssigner && [value isKindOfClass:[AWSS3TransferUtilityUploadTask class]]) {
             AWSS3TransferUtilityUploadTask *task = value;
             AWSS3TransferUtilityProgressBlock progressBlock = nil;
@@ -1983,13 +2840,24 @@ internalDictionaryToAddSubTaskTo: (NSMutableDictionary *) internalDictionaryToAd
     return completionSource.task;
 }
 
+- (AWSTask *)getMultiPartDownloadTasks {
+    AWSTaskCompletionSource *completionSource = [AWSTaskCompletionSource new];
+    NSMutableSet *transferIDs = [NSMutableSet new];
+    NSString *className = NSStringFromClass(AWSS3TransferUtilityMultiPartDownloadTask.class);
+
+    NSMutableArray *allTasks = [self getTasksHelper:self.completedTaskDictionary transferIDs:transferIDs className:className];
+    [allTasks addObjectsFromArray:[self getTasksHelper:self.taskDictionary transferIDs:transferIDs className:className]];
+
+    [completionSource setResult:allTasks];
+    return completionSource.task;
+}
+
 
 - (NSMutableArray *) getTasksHelper:(AWSSynchronizedMutableDictionary *)dictionary
                              transferIDs:(NSMutableSet *) transferIDs
                                className: (NSString *) className {
     NSMutableArray *tasks = [NSMutableArray new];
-    for (id key in [dictionary allKeys]) {
-        id value = [dictionary objectForKey:key];
+    for (id value in [dictionary allValues]) {
         NSString * taskClassName = NSStringFromClass([value class]);
         if ([className isEqualToString:taskClassName]) {
             AWSS3TransferUtilityTask *task = value;
@@ -2088,6 +2956,8 @@ handleEventsForBackgroundURLSession:(NSString *)identifier
 
 - (void)URLSessionDidFinishEventsForBackgroundURLSession:(NSURLSession *)session {
     AWSDDLogDebug(@"URLSessionDidFinishEventsForBackgroundURLSession called for NSURLSession %@", _sessionIdentifier);
+    //The app is suspended once the completion handler is called, commit the updates of the parts before.
+    [AWSS3TransferUtilityDatabaseHelper flushPendingWritesToDatabaseQueue:self.databaseQueue];
     dispatch_async(dispatch_get_main_queue(), ^{
         if (self.backgroundURLSessionCompletionHandler) {
             self.backgroundURLSessionCompletionHandler();
@@ -2218,6 +3088,7 @@ didCompleteWithError:(NSError *)error {
                 
                 //Remove it from the waitingList
                 [transferUtilityMultiPartUploadTask.waitingPartsDictionary removeObjectForKey:@(subTask.taskIdentifier)];
+                [transferUtilityMultiPartUploadTask.waitingParts removeObject:subTask];
             }
             
             subTask = [transferUtilityMultiPartUploadTask.inProgressPartsDictionary objectForKey:@(task.taskIdentifier)];
@@ -2245,6 +3116,7 @@ didCompleteWithError:(NSError *)error {
                 //Retrying if a 500, 503 or 400 RequestTimeout error occured.
                 if  ([self isErrorRetriable:HTTPResponse.statusCode responseFromServer:subTask.responseData]) {
                     AWSDDLogDebug(@"Received a 500, 503 or 400 error. Response Data is [%@]", subTask.responseData);
+                    [transferUtilityMultiPartUploadTask.tuner partDidFailAtTime:CFAbsoluteTimeGetCurrent()];
                     if (transferUtilityMultiPartUploadTask.retryCount < self.transferUtilityConfiguration.retryLimit) {
                         AWSDDLogDebug(@"Retry count is below limit and error is retriable. ");
                         [self retryUploadSubTask:transferUtilityMultiPartUploadTask subTask:subTask startTransfer:YES];
@@ -2292,9 +3164,11 @@ didCompleteWithError:(NSError *)error {
             
             //Add it to completed parts and remove it from remaining parts.
             [transferUtilityMultiPartUploadTask.completedPartsSet addObject:subTask];
+            transferUtilityMultiPartUploadTask.completedPartsLength += subTask.totalBytesExpectedToSend;
             [transferUtilityMultiPartUploadTask.inProgressPartsDictionary removeObjectForKey:@(subTask.taskIdentifier)];
             //Update progress
             transferUtilityMultiPartUploadTask.progress.completedUnitCount = transferUtilityMultiPartUploadTask.progress.completedUnitCount - subTask.totalBytesSent + subTask.totalBytesExpectedToSend;
+            [transferUtilityMultiPartUploadTask.tuner partDidCompleteWithLength:subTask.totalBytesExpectedToSend atTime:CFAbsoluteTimeGetCurrent()];
             
             //Delete the temporary upload file for this subTask
             [self removeFile:subTask.file];
@@ -2308,35 +3182,21 @@ didCompleteWithError:(NSError *)error {
                                                                    status:subTask.status
                                                               retry_count:transferUtilityMultiPartUploadTask.retryCount databaseQueue:self.databaseQueue];
             
-            //If there are parts waiting to be uploaded, pick from the waiting parts list and move it to inProgress
-            if ([transferUtilityMultiPartUploadTask.waitingPartsDictionary count] > 0) {
-                long numberOfPartsInProgress = [transferUtilityMultiPartUploadTask.inProgressPartsDictionary count];
-                while (numberOfPartsInProgress < [self.transferUtilityConfiguration.multiPartConcurrencyLimit integerValue]) {
-                    if ([transferUtilityMultiPartUploadTask.waitingPartsDictionary count] > 0) {
-                        //Get a part from the waitingList
-                        AWSS3TransferUtilityUploadSubTask *nextSubTask = [[transferUtilityMultiPartUploadTask.waitingPartsDictionary allValues] objectAtIndex:0];
-                        
-                        //Add to inProgress list
-                        [transferUtilityMultiPartUploadTask.inProgressPartsDictionary setObject:nextSubTask forKey:@(nextSubTask.taskIdentifier)];
-                        
-                        //Remove it from the waitingList
-                        [transferUtilityMultiPartUploadTask.waitingPartsDictionary removeObjectForKey:@(nextSubTask.taskIdentifier)];
-                        AWSDDLogDebug(@"Moving Task[%@] to progress for Multipart[%@]", @(nextSubTask.taskIdentifier), transferUtilityMultiPartUploadTask.uploadID);
-                        [nextSubTask.sessionTask resume];
-                        numberOfPartsInProgress++;
-                        continue;
-                    }
-                    break;
+            //If there are parts waiting to be uploaded, create the files of the next parts and move waiting parts to inProgress
+            if ([transferUtilityMultiPartUploadTask.waitingPartsDictionary count] > 0
+                || [transferUtilityMultiPartUploadTask.pendingParts count] > 0) {
+                NSError *subTaskCreationError = [self scheduleUploadSubTasks:transferUtilityMultiPartUploadTask
+                                                               startTransfer:transferUtilityMultiPartUploadTask.status != AWSS3TransferUtilityTransferStatusPaused];
+                if (subTaskCreationError) {
+                    [self failMultiPartUploadTask:transferUtilityMultiPartUploadTask error:subTaskCreationError];
+                    return;
                 }
             }
             else if ([transferUtilityMultiPartUploadTask.inProgressPartsDictionary count] == 0) {
                 //If there are no more inProgress parts, then we are done.
                 
                 //Validate that all the content has been uploaded.
-                int64_t totalBytesSent = 0;
-                for (AWSS3TransferUtilityUploadSubTask *aSubTask in transferUtilityMultiPartUploadTask.completedPartsSet) {
-                    totalBytesSent += aSubTask.totalBytesExpectedToSend;
-                }
+                int64_t totalBytesSent = transferUtilityMultiPartUploadTask.completedPartsLength;
                 
                 if (totalBytesSent != transferUtilityMultiPartUploadTask.contentLength.longLongValue ) {
                     NSString *errorMessage = [NSString stringWithFormat:@"Expected to send [%@], but sent [%@] and there are no remaining parts. Failing transfer ",
@@ -2397,7 +3257,16 @@ didCompleteWithError:(NSError *)error {
         }
     }
     else if ([task isKindOfClass:[NSURLSessionDownloadTask class]]) {
-        AWSS3TransferUtilityDownloadTask *downloadTask = [self.taskDictionary objectForKey:@(task.taskIdentifier)];
+        id transferUtilityTask = [self.taskDictionary objectForKey:@(task.taskIdentifier)];
+        if ([transferUtilityTask isKindOfClass:[AWSS3TransferUtilityMultiPartDownloadTask class]]) {
+            [self multiPartDownloadTask:transferUtilityTask
+                  didCompleteSessionTask:task
+                                   error:error
+                            HTTPResponse:HTTPResponse
+                                userInfo:userInfo];
+            return;
+        }
+        AWSS3TransferUtilityDownloadTask *downloadTask = transferUtilityTask;
         if (!downloadTask) {
             AWSDDLogDebug(@"Unable to find information for task %lu in taskDictionary", (unsigned long)task.taskIdentifier);
             return;
@@ -2496,16 +3365,8 @@ totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend {
         subTask.totalBytesSent = totalBytesSent;
         
     
-        //Calculate the total sent so far
-        int64_t totalSentSoFar = 0;
-        //Create a new Dictionary with the partNumber as the Key
-        NSMutableDictionary *completedPartsByPartNumber = [NSMutableDictionary new];
-        for(AWSS3TransferUtilityUploadSubTask *subTask in transferUtilityMultiPartUploadTask.completedPartsSet) {
-            [completedPartsByPartNumber setObject:subTask forKey:subTask.partNumber];
-        }
-        for (AWSS3TransferUtilityUploadSubTask *aSubTask in [completedPartsByPartNumber allValues]) {
-            totalSentSoFar += aSubTask.totalBytesExpectedToSend;
-        }
+        //Calculate the total sent so far. The completed parts are kept as a running total, so only the parts in progress are added up.
+        int64_t totalSentSoFar = transferUtilityMultiPartUploadTask.completedPartsLength;
         for (AWSS3TransferUtilityUploadSubTask *aSubTask in [transferUtilityMultiPartUploadTask.inProgressPartsDictionary allValues]) {
             totalSentSoFar += aSubTask.totalBytesSent;
         }
@@ -2535,6 +3396,11 @@ totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend {
         [self.taskDictionary removeObjectForKey:@(subTask.taskIdentifier)];
         [self removeFile:subTask.file];
     }
+    for ( AWSS3TransferUtilityUploadSubTask *subTask in [task.waitingPartsDictionary allValues] ) {
+        [self.taskDictionary removeObjectForKey:@(subTask.taskIdentifier)];
+        [self removeFile:subTask.file];
+    }
+    [task.waitingParts removeAllObjects];
     
     //Remove temporary file if required.
     if (task.temporaryFileCreated) {
@@ -2546,6 +3412,133 @@ totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend {
     
 }
 
+- (void) cleanupForMultiPartDownloadTask: (AWSS3TransferUtilityMultiPartDownloadTask *) task {
+
+    //Add it to list of completed Tasks
+    [self.completedTaskDictionary setObject:task forKey:task.transferID];
+
+    //Remove all entries from taskDictionary.
+    for ( AWSS3TransferUtilityDownloadSubTask *subTask in [task.inProgressPartsDictionary allValues] ) {
+        [self.taskDictionary removeObjectForKey:@(subTask.taskIdentifier)];
+    }
+    [self.taskDictionary removeObjectForKey:task.transferID];
+
+    //The file of a download that did not complete only holds some of the ranges of the object.
+    [self removeFile:[self partialFilePathForMultiPartDownloadTask:task]];
+
+    //Remove data from the Database.
+    [AWSS3TransferUtilityDatabaseHelper deleteTransferRequestFromDB:task.transferID databaseQueue:_databaseQueue];
+}
+
+//Writes a range to the file of the download at its offset. The file NSURLSession downloads to is removed once this returns.
+- (void) multiPartDownloadTask: (AWSS3TransferUtilityMultiPartDownloadTask *) transferUtilityMultiPartDownloadTask
+didFinishDownloadingSessionTask: (NSURLSessionDownloadTask *) downloadTask
+                         toURL: (NSURL *) location {
+    AWSS3TransferUtilityDownloadSubTask *subTask = [transferUtilityMultiPartDownloadTask.inProgressPartsDictionary objectForKey:@(downloadTask.taskIdentifier)];
+    if (!subTask || transferUtilityMultiPartDownloadTask.cancelled) {
+        return;
+    }
+
+    //Errors are downloaded too. Keep the response, to tell whether the error is retriable.
+    NSHTTPURLResponse *HTTPResponse = [downloadTask.response isKindOfClass:[NSHTTPURLResponse class]] ? (NSHTTPURLResponse *) downloadTask.response : nil;
+    if (HTTPResponse.statusCode / 100 != 2) {
+        subTask.responseData = [NSString stringWithContentsOfURL:location encoding:NSUTF8StringEncoding error:nil] ?: @"";
+        return;
+    }
+
+    unsigned long long length = [[[NSFileManager defaultManager] attributesOfItemAtPath:location.path error:nil] fileSize];
+    if (length != subTask.totalBytesExpectedToReceive) {
+        NSString *errorMessage = [NSString stringWithFormat:@"Expected [%lld] bytes for range #: %@, but received [%llu]", subTask.totalBytesExpectedToReceive, subTask.partNumber, length];
+        NSDictionary *userInfo = [NSDictionary dictionaryWithObject:errorMessage
+                                                             forKey:@"Message"];
+        subTask.error = [NSError errorWithDomain:AWSS3TransferUtilityErrorDomain
+                                            code:AWSS3TransferUtilityErrorServerError
+                                        userInfo:userInfo];
+        return;
+    }
+
+    NSError *error = nil;
+    if (![self writeRangeFile:location
+                       toFile:[self partialFilePathForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask]
+                     atOffset:subTask.offset
+                        error:&error]) {
+        AWSDDLogError(@"Unable to write range #: %@ of MultiPartDownload [%@]: %@", subTask.partNumber, transferUtilityMultiPartDownloadTask.transferID, error);
+        subTask.error = error;
+    }
+}
+
+- (void) multiPartDownloadTask: (AWSS3TransferUtilityMultiPartDownloadTask *) transferUtilityMultiPartDownloadTask
+        didCompleteSessionTask: (NSURLSessionTask *) task
+                         error: (NSError *) error
+                  HTTPResponse: (NSHTTPURLResponse *) HTTPResponse
+                      userInfo: (NSMutableDictionary *) userInfo {
+    AWSS3TransferUtilityDownloadSubTask *subTask = [transferUtilityMultiPartDownloadTask.inProgressPartsDictionary objectForKey:@(task.taskIdentifier)];
+    if (!subTask) {
+        AWSDDLogDebug(@"Unable to find information for task %lu in taskDictionary", (unsigned long)task.taskIdentifier);
+        return;
+    }
+
+    //Check if the task was cancelled.
+    if (transferUtilityMultiPartDownloadTask.cancelled) {
+        [self cleanupForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask];
+        return;
+    }
+
+    //A range that could not be written to the file fails like its request.
+    if (!error) {
+        error = subTask.error;
+    }
+
+    if (error) {
+        //Retrying if a 500, 503 or 400 RequestTimeout error occured.
+        if (HTTPResponse && [self isErrorRetriable:HTTPResponse.statusCode responseFromServer:subTask.responseData]) {
+            [transferUtilityMultiPartDownloadTask.tuner partDidFailAtTime:CFAbsoluteTimeGetCurrent()];
+            if (transferUtilityMultiPartDownloadTask.retryCount < self.transferUtilityConfiguration.retryLimit) {
+                AWSDDLogDebug(@"Retrying range #: %@ of MultiPartDownload [%@]", subTask.partNumber, transferUtilityMultiPartDownloadTask.transferID);
+                [self retryDownloadSubTask:transferUtilityMultiPartDownloadTask subTask:subTask];
+                return;
+            }
+        }
+
+        if (HTTPResponse.statusCode / 100 != 2 && userInfo) {
+            [self extractErrorInformation:subTask.responseData userInfo:userInfo];
+            error = [[NSError alloc] initWithDomain:error.domain code:error.code userInfo:userInfo];
+        }
+        [self failMultiPartDownloadTask:transferUtilityMultiPartDownloadTask error:error];
+        return;
+    }
+
+    //Add it to completed ranges and remove it from the ranges in progress.
+    [transferUtilityMultiPartDownloadTask.completedPartsSet addObject:subTask];
+    [transferUtilityMultiPartDownloadTask.inProgressPartsDictionary removeObjectForKey:@(subTask.taskIdentifier)];
+    [self.taskDictionary removeObjectForKey:@(subTask.taskIdentifier)];
+    subTask.totalBytesReceived = subTask.totalBytesExpectedToReceive;
+    subTask.status = AWSS3TransferUtilityTransferStatusCompleted;
+    [transferUtilityMultiPartDownloadTask.tuner partDidCompleteWithLength:subTask.totalBytesExpectedToReceive
+                                                                   atTime:CFAbsoluteTimeGetCurrent()];
+
+    //Record the range, so that it is not downloaded again if the transfer is recovered.
+    [AWSS3TransferUtilityDatabaseHelper updateTransferRequestInDB:subTask.transferID
+                                                       partNumber:subTask.partNumber
+                                                   taskIdentifier:subTask.taskIdentifier
+                                                             eTag:@""
+                                                           status:subTask.status
+                                                      retry_count:transferUtilityMultiPartDownloadTask.retryCount
+                                                    databaseQueue:self.databaseQueue];
+    [self updateProgressForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask];
+
+    if ([transferUtilityMultiPartDownloadTask.pendingParts count] > 0) {
+        NSError *subTaskCreationError = [self scheduleDownloadSubTasks:transferUtilityMultiPartDownloadTask
+                                                         startTransfer:transferUtilityMultiPartDownloadTask.status != AWSS3TransferUtilityTransferStatusPaused];
+        if (subTaskCreationError) {
+            [self failMultiPartDownloadTask:transferUtilityMultiPartDownloadTask error:subTaskCreationError];
+        }
+    }
+    else if ([transferUtilityMultiPartDownloadTask.inProgressPartsDictionary count] == 0) {
+        [self finishMultiPartDownloadTask:transferUtilityMultiPartDownloadTask];
+    }
+}
+
 - (void) cleanupForUploadTask: (AWSS3TransferUtilityUploadTask *) uploadTask {
     //Add it to list of completed Tasks
     [self.completedTaskDictionary setObject:uploadTask forKey:uploadTask.transferID];
@@ -2628,6 +3621,12 @@ didFinishDownloadingToURL:(NSURL *)location {
         AWSDDLogDebug(@"Unable to find information for task %lu in taskDictionary", (unsigned long)downloadTask.taskIdentifier);
         return;
     }
+    if ([transferUtilityTask isKindOfClass:[AWSS3TransferUtilityMultiPartDownloadTask class]]) {
+        [self multiPartDownloadTask:(AWSS3TransferUtilityMultiPartDownloadTask *) transferUtilityTask
+    didFinishDownloadingSessionTask:downloadTask
+                              toURL:location];
+        return;
+    }
     if (transferUtilityTask.location) {
         if (![[NSFileManager defaultManager] fileExistsAtPath:[transferUtilityTask.location path]]) {
             NSError *error = nil;
@@ -2661,6 +3660,14 @@ totalBytesExpectedToWrite:(int64_t)totalBytesExpectedToWrite {
         return;
     }
     
+    if ([transferUtilityDownloadTask isKindOfClass:[AWSS3TransferUtilityMultiPartDownloadTask class]]) {
+        AWSS3TransferUtilityMultiPartDownloadTask *transferUtilityMultiPartDownloadTask = (AWSS3TransferUtilityMultiPartDownloadTask *) transferUtilityDownloadTask;
+        AWSS3TransferUtilityDownloadSubTask *subTask = [transferUtilityMultiPartDownloadTask.inProgressPartsDictionary objectForKey:@(downloadTask.taskIdentifier)];
+        subTask.totalBytesReceived = totalBytesWritten;
+        [self updateProgressForMultiPartDownloadTask:transferUtilityMultiPartDownloadTask];
+        return;
+    }
+    
     if (transferUtilityDownloadTask.progress.totalUnitCount != totalBytesExpectedToWrite) {
         transferUtilityDownloadTask.progress.totalUnitCount = totalBytesExpectedToWrite;
     }
@@ -2688,6 +3695,7 @@ totalBytesExpectedToWrite:(int64_t)totalBytesExpectedToWrite {
         _accelerateModeEnabled = NO;
         _retryLimit = 0;
         _multiPartConcurrencyLimit = @(AWSS3TransferUtilityMultiPartDefaultConcurrencyLimit);
+        _multiPartAutoTuningEnabled = NO;
         _timeoutIntervalForResource = AWSS3TransferUtilityTimeoutIntervalForResource;
     }
     return self;
@@ -2699,7 +3707,10 @@ totalBytesExpectedToWrite:(int64_t)totalBytesExpectedToWrite {
     configuration.bucket = self.bucket;
     configuration.retryLimit = self.retryLimit;
     configuration.multiPartConcurrencyLimit = self.multiPartConcurrencyLimit;
+    configuration.multiPartAutoTuningEnabled = self.isMultiPartAutoTuningEnabled;
     configuration.timeoutIntervalForResource = self.timeoutIntervalForResource;
+    configuration.checksumAlgorithm = self.checksumAlgorithm;
+    configuration.boundedExecutor = self.boundedExecutor;
     return configuration;
 }
 
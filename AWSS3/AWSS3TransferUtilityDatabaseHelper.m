@@ -21,6 +21,33 @@
 //Constants for DB
 NSString *const AWSS3TransferUtilityDatabaseDirectory = @"/com/amazonaws/AWSS3TransferUtility/";
 NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
+//Updates of parts are committed together at most this long after they were made.
+static NSTimeInterval const AWSS3TransferUtilityDatabaseFlushInterval = 1.0;
+static NSUInteger const AWSS3TransferUtilityDatabaseMaximumPendingWrites = 256;
+
+typedef void (^AWSS3TransferUtilityDatabaseWrite)(AWSFMDatabase *db);
+
+//The writes to a database that are not committed yet, in the order they were made in.
+@interface AWSS3TransferUtilityDatabasePendingWrites : NSObject
+
+@property (nonatomic, strong) NSMutableArray<NSString *> *keys;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, AWSS3TransferUtilityDatabaseWrite> *writes;
+@property (nonatomic, assign) NSUInteger sequenceNumber;
+@property (nonatomic, assign) BOOL flushScheduled;
+
+@end
+
+@implementation AWSS3TransferUtilityDatabasePendingWrites
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _keys = [NSMutableArray new];
+        _writes = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+@end
 
 @interface AWSS3TransferUtilityTask()
 @property NSString *nsURLSessionID;
@@ -53,6 +80,25 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
 @property NSUInteger taskIdentifier;
 @end
 
+@interface AWSS3TransferUtilityMultiPartDownloadTask()
+@property (strong, nonatomic) AWSS3TransferUtilityMultiPartDownloadExpression *expression;
+@property NSString *nsURLSessionID;
+@property NSString *file;
+@property NSNumber *contentLength;
+@property int retryCount;
+@property NSString *transferType;
+@property NSString *eTag;
+@property NSString *checksum;
+@end
+
+@interface AWSS3TransferUtilityDownloadSubTask()
+@property NSUInteger taskIdentifier;
+@property (strong, nonatomic) NSNumber *partNumber;
+@property int64_t totalBytesExpectedToReceive;
+@property AWSS3TransferUtilityTransferStatusType status;
+@property NSString *transferType;
+@end
+
 @interface AWSS3TransferUtilityUploadSubTask()
 @property NSUInteger taskIdentifier;
 @property (strong, nonatomic) NSNumber *partNumber;
@@ -108,14 +154,121 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
         return nil;
     }
     
+    NSString *const AWSS3TransferUtilityCreateAWSTransferIndexes = @"CREATE INDEX IF NOT EXISTS awstransfer_transfer_id ON awstransfer (transfer_id, part_number);"
+    @"CREATE INDEX IF NOT EXISTS awstransfer_ns_url_session_id ON awstransfer (ns_url_session_id);";
+
     [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        //With a write-ahead log, a commit appends to the log instead of rewriting the database, and the transactions
+        //committed before the app is terminated are kept.
+        if (![db executeStatements:@"PRAGMA journal_mode=WAL;PRAGMA synchronous=NORMAL;"]) {
+            AWSDDLogError(@"Failed to enable the write-ahead log of the transfer utility database. [%@]", db.lastError);
+        }
         if (! [db executeUpdate: AWSS3TransferUtilityCreateAWSTransfer]) {
             AWSDDLogError(@"Failed to create awstransfer Database table. [%@]", db.lastError);
         }
+        if (![db executeStatements:AWSS3TransferUtilityCreateAWSTransferIndexes]) {
+            AWSDDLogError(@"Failed to create the indexes of the awstransfer Database table. [%@]", db.lastError);
+        }
     }];
     return databaseQueue;
 }
 
+#pragma mark - Pending writes
+
++ (AWSS3TransferUtilityDatabasePendingWrites *) pendingWritesForDatabaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
+    static NSMapTable<AWSFMDatabaseQueue *, AWSS3TransferUtilityDatabasePendingWrites *> *pendingWritesByDatabaseQueue = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        pendingWritesByDatabaseQueue = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality
+                                                             valueOptions:NSPointerFunctionsStrongMemory];
+    });
+
+    @synchronized (pendingWritesByDatabaseQueue) {
+        AWSS3TransferUtilityDatabasePendingWrites *pendingWrites = [pendingWritesByDatabaseQueue objectForKey:databaseQueue];
+        if (!pendingWrites) {
+            pendingWrites = [AWSS3TransferUtilityDatabasePendingWrites new];
+            [pendingWritesByDatabaseQueue setObject:pendingWrites forKey:databaseQueue];
+        }
+        return pendingWrites;
+    }
+}
+
+//Queues a write to the database. A write with the coalescing key of a pending write replaces it. The pending writes are committed
+//in a single transaction, in order, right away if `commit` is set. Coalesced writes are otherwise committed once there are too many
+//pending writes or AWSS3TransferUtilityDatabaseFlushInterval after the first of them, other writes wait for the next commit.
++ (void) writeToDatabaseQueue: (AWSFMDatabaseQueue *) databaseQueue
+                coalescingKey: (NSString *) coalescingKey
+                       commit: (BOOL) commit
+                        block: (AWSS3TransferUtilityDatabaseWrite) block {
+    if (!databaseQueue) {
+        return;
+    }
+
+    AWSS3TransferUtilityDatabasePendingWrites *pendingWrites = [self pendingWritesForDatabaseQueue:databaseQueue];
+    BOOL flush = commit;
+    BOOL scheduleFlush = NO;
+    @synchronized (pendingWrites) {
+        NSString *key = coalescingKey;
+        if (!key) {
+            key = [NSString stringWithFormat:@"%lu", (unsigned long)pendingWrites.sequenceNumber++];
+        }
+        if (![pendingWrites.writes objectForKey:key]) {
+            [pendingWrites.keys addObject:key];
+        }
+        [pendingWrites.writes setObject:block forKey:key];
+
+        //The records of a multipart transfer, which are not coalesced, are committed together by the caller.
+        if (coalescingKey && !flush) {
+            if ([pendingWrites.keys count] >= AWSS3TransferUtilityDatabaseMaximumPendingWrites) {
+                flush = YES;
+            }
+            else if (!pendingWrites.flushScheduled) {
+                pendingWrites.flushScheduled = YES;
+                scheduleFlush = YES;
+            }
+        }
+    }
+
+    if (flush) {
+        [self flushPendingWritesToDatabaseQueue:databaseQueue];
+    }
+    else if (scheduleFlush) {
+        __weak AWSFMDatabaseQueue *weakDatabaseQueue = databaseQueue;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(AWSS3TransferUtilityDatabaseFlushInterval * NSEC_PER_SEC)),
+                       dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [AWSS3TransferUtilityDatabaseHelper flushPendingWritesToDatabaseQueue:weakDatabaseQueue];
+        });
+    }
+}
+
+//Commits the pending writes to the database.
++ (void) flushPendingWritesToDatabaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
+    if (!databaseQueue) {
+        return;
+    }
+
+    AWSS3TransferUtilityDatabasePendingWrites *pendingWrites = [self pendingWritesForDatabaseQueue:databaseQueue];
+    @synchronized (pendingWrites) {
+        if ([pendingWrites.keys count] == 0) {
+            return;
+        }
+    }
+
+    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        //Taken on the queue of the database, so that writes are committed in the order they were made in.
+        NSArray<AWSS3TransferUtilityDatabaseWrite> *writes = nil;
+        @synchronized (pendingWrites) {
+            writes = [pendingWrites.writes objectsForKeys:pendingWrites.keys notFoundMarker:[NSNull null]];
+            [pendingWrites.keys removeAllObjects];
+            [pendingWrites.writes removeAllObjects];
+            pendingWrites.flushScheduled = NO;
+        }
+        for (AWSS3TransferUtilityDatabaseWrite write in writes) {
+            write(db);
+        }
+    }];
+}
+
 
 //Delete a transfer request given its transfer ID
 + (void) deleteTransferRequestFromDB:(NSString *) transferID
@@ -123,7 +276,7 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
     NSString *const AWSS3TransferUtilityDeleteTransfer =  @"DELETE FROM awstransfer "
     @"WHERE transfer_id=:transfer_id";
     
-    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+    [self writeToDatabaseQueue:databaseQueue coalescingKey:nil commit:YES block:^(AWSFMDatabase *db) {
         BOOL result = [db executeUpdate: AWSS3TransferUtilityDeleteTransfer
                 withParameterDictionary:@{
                                           @"transfer_id": transferID
@@ -145,7 +298,7 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
     NSString *const AWSS3TransferUtilityDeleteATask =  @"DELETE FROM awstransfer "
     @"WHERE transfer_id=:transfer_id and "
     @"      session_task_id=:session_task_id ";
-    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+    [self writeToDatabaseQueue:databaseQueue coalescingKey:nil commit:YES block:^(AWSFMDatabase *db) {
         BOOL result = [db executeUpdate:AWSS3TransferUtilityDeleteATask
                 withParameterDictionary:@{
                                           @"transfer_id": transferID,
@@ -158,7 +311,9 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
     }];
 }
 
-// update transfer record given transferID and partNumber
+// update transfer record given transferID and partNumber. The updates of a part are coalesced and committed with the other
+// pending writes, the updates of a transfer or of the master record of a multipart transfer are committed right away.
+// Should the app be terminated before an update of a part is committed, the part is transferred again when the transfer is recovered.
 + (void) updateTransferRequestInDB: (NSString *) transferID
                         partNumber: (NSNumber *) partNumber
                     taskIdentifier: (NSUInteger) taskIdentifier
@@ -170,7 +325,9 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
     @"SET status=:status, etag = :etag, session_task_id = :session_task_id, retry_count = :retry_count "
     @"WHERE transfer_id=:transfer_id and "
     @"      part_number =:part_number ";
-    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+    BOOL isPart = [partNumber integerValue] > 0;
+    NSString *coalescingKey = isPart ? [NSString stringWithFormat:@"%@/%@", transferID, partNumber] : nil;
+    [self writeToDatabaseQueue:databaseQueue coalescingKey:coalescingKey commit:!isPart block:^(AWSFMDatabase *db) {
         BOOL result = [db executeUpdate: AWSS3TransferUtilityUpdateTransferUtilityStatusAndETag
                 withParameterDictionary:@{
                                           @"transfer_id": transferID,
@@ -188,6 +345,30 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
     }];
 }
 
+// update the part file of a transfer record given transferID and partNumber. Committed right away, so that the file is
+// removed should the transfer be cancelled after the app is relaunched.
++ (void) updateTransferRequestInDB: (NSString *) transferID
+                        partNumber: (NSNumber *) partNumber
+                              file: (NSString *) file
+                     databaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
+    NSString *const AWSS3TransferUtilityUpdateTransferUtilityFile = @"UPDATE awstransfer "
+    @"SET file = :file "
+    @"WHERE transfer_id=:transfer_id and "
+    @"      part_number =:part_number ";
+    [self writeToDatabaseQueue:databaseQueue coalescingKey:nil commit:YES block:^(AWSFMDatabase *db) {
+        BOOL result = [db executeUpdate: AWSS3TransferUtilityUpdateTransferUtilityFile
+                withParameterDictionary:@{
+                                          @"transfer_id": transferID,
+                                          @"part_number": partNumber,
+                                          @"file": [AWSS3TransferUtilityDatabaseHelper relativePathFromAbsolutePath:file]
+                                          }];
+
+        if (!result) {
+            AWSDDLogError(@"Failed to update transfer_request [%@] in Database. [%@]", transferID,
+                          db.lastError);
+        }
+    }];
+}
 
 + (void) insertUploadTransferRequestInDB:(AWSS3TransferUtilityUploadTask *) task
                            databaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
@@ -208,6 +389,7 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
                                                        retryCount:@(task.retryCount)
                                                requestHeadersJSON:[AWSS3TransferUtilityDatabaseHelper getJSONRepresentation:task.expression.requestHeaders]
                                             requestParametersJSON:[AWSS3TransferUtilityDatabaseHelper getJSONRepresentation:task.expression.requestParameters]
+                                                           commit:YES
                                                     databaseQueue:databaseQueue];
 }
 
@@ -233,9 +415,11 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
                                                        retryCount:@(task.retryCount)
                                                requestHeadersJSON:[self getJSONRepresentation:task.expression.requestHeaders]
                                             requestParametersJSON:[self getJSONRepresentation:task.expression.requestParameters]
+                                                           commit:YES
                                                     databaseQueue:databaseQueue];
 }
 
+//The master record of a multipart upload is committed with the records of its parts, once the pending writes are flushed.
 + (void) insertMultiPartUploadRequestInDB:(AWSS3TransferUtilityMultiPartUploadTask *) task
                             databaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
     [AWSS3TransferUtilityDatabaseHelper insertTransferRequestInDB:task.transferID
@@ -254,9 +438,12 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
                                                        retryCount:@(task.retryCount)
                                                requestHeadersJSON:[self getJSONRepresentation:task.expression.requestHeaders]
                                             requestParametersJSON:[self getJSONRepresentation:task.expression.requestParameters]
+                                                           commit:NO
                                                     databaseQueue:databaseQueue];
 }
 
+//The request headers and parameters of a multipart transfer are only read back from its master record, so the part records
+//leave them empty rather than repeating them for every part.
 + (void) insertMultiPartUploadRequestSubTaskInDB:(AWSS3TransferUtilityMultiPartUploadTask *) task
                                          subTask:(AWSS3TransferUtilityUploadSubTask *) subTask
                                    databaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
@@ -274,8 +461,56 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
                                                     contentLength:@(subTask.totalBytesExpectedToSend)
                                                            status:subTask.status
                                                        retryCount:@(0)
+                                               requestHeadersJSON:@""
+                                            requestParametersJSON:@""
+                                                           commit:NO
+                                                    databaseQueue:databaseQueue];
+}
+
+//The master record of a multipart download keeps the ETag the ranges are requested with and, in multi_part_id, the checksum
+//header and value the downloaded file is validated with. Like the one of an upload, it is committed with the records of its ranges.
++ (void) insertMultiPartDownloadRequestInDB:(AWSS3TransferUtilityMultiPartDownloadTask *) task
+                              databaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
+    [AWSS3TransferUtilityDatabaseHelper insertTransferRequestInDB:task.transferID
+                                                   nsURLSessionID:task.nsURLSessionID
+                                                   taskIdentifier:@0
+                                                     transferType:task.transferType
+                                                           bucket:task.bucket
+                                                              key:task.key
+                                                       partNumber:@0
+                                                      multiPartID:task.checksum ?: @""
+                                                             eTag:task.eTag ?: @""
+                                                             file:task.file
+                                             temporaryFileCreated: YES
+                                                    contentLength:task.contentLength
+                                                           status:task.status
+                                                       retryCount:@(task.retryCount)
                                                requestHeadersJSON:[self getJSONRepresentation:task.expression.requestHeaders]
                                             requestParametersJSON:[self getJSONRepresentation:task.expression.requestParameters]
+                                                           commit:NO
+                                                    databaseQueue:databaseQueue];
+}
+
++ (void) insertMultiPartDownloadRequestSubTaskInDB:(AWSS3TransferUtilityMultiPartDownloadTask *) task
+                                           subTask:(AWSS3TransferUtilityDownloadSubTask *) subTask
+                                     databaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
+    [AWSS3TransferUtilityDatabaseHelper insertTransferRequestInDB:task.transferID
+                                                   nsURLSessionID:task.nsURLSessionID
+                                                   taskIdentifier:@(subTask.taskIdentifier)
+                                                     transferType:subTask.transferType
+                                                           bucket:task.bucket
+                                                              key:task.key
+                                                       partNumber:subTask.partNumber
+                                                      multiPartID:@""
+                                                             eTag:@""
+                                                             file:task.file
+                                             temporaryFileCreated: NO
+                                                    contentLength:@(subTask.totalBytesExpectedToReceive)
+                                                           status:subTask.status
+                                                       retryCount:@(0)
+                                               requestHeadersJSON:@""
+                                            requestParametersJSON:@""
+                                                           commit:NO
                                                     databaseQueue:databaseQueue];
 }
 
@@ -295,6 +530,7 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
                         retryCount: (NSNumber *) retryCount
                 requestHeadersJSON: (NSString *) requestHeadersJSON
              requestParametersJSON: (NSString *) requestParametersJSON
+                            commit: (BOOL) commit
                      databaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
     NSString *const AWSS3TransferUtiltyInsertIntoAWSTransfer = @"INSERT INTO awstransfer ("
     @"transfer_id,ns_url_session_id, session_task_id, transfer_type, bucket_name, key, part_number, multi_part_id, etag, file, "
@@ -309,7 +545,7 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
         tempFileCreated = [NSNumber numberWithInt:1];
     }
     
-    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+    [self writeToDatabaseQueue:databaseQueue coalescingKey:nil commit:commit block:^(AWSFMDatabase *db) {
         BOOL result = [db executeUpdate: AWSS3TransferUtiltyInsertIntoAWSTransfer
                 withParameterDictionary:@{
                                           @"transfer_id": transferID,
@@ -346,6 +582,7 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
     @"Where ns_url_session_id=:ns_url_session_id order by transfer_id, part_number";
     
     NSMutableArray *tasks = [NSMutableArray new];
+    [self flushPendingWritesToDatabaseQueue:databaseQueue];
     //Read from DB
     [databaseQueue inDatabase:^(AWSFMDatabase *db) {
         //Get all AWSTransferRecords
@@ -365,7 +602,7 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
             [transfer setObject:[rs stringForColumn:@"etag"] forKey:@"etag"];
             [transfer setObject:[AWSS3TransferUtilityDatabaseHelper absolutePathFromRelativePath:[rs stringForColumn:@"file"]] forKey:@"file"];
             [transfer setObject:@([rs intForColumn:@"temporary_file_created"]) forKey:@"temporary_file_created"];
-            [transfer setObject:@([rs intForColumn:@"content_length"]) forKey:@"content_length"];
+            [transfer setObject:@([rs longLongIntForColumn:@"content_length"]) forKey:@"content_length"];
             [transfer setObject:@([rs intForColumn:@"retry_count"]) forKey:@"retry_count"];
             [transfer setObject:[rs stringForColumn:@"request_headers"] forKey:@"request_headers"];
             [transfer setObject:[rs stringForColumn:@"request_parameters"] forKey:@"request_parameters"];
@@ -0,0 +1,70 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Picks the part size of a multipart upload and, when auto-tuning is enabled, the number of parts in progress. Multipart
+ downloads use it the same way for their ranges.
+
+ The number of parts in progress starts low and grows by one part per round while the throughput of the upload grows,
+ a round being as many finished parts as there are parts in progress. It steps back when a part more does not make
+ the upload faster and is halved when a part fails, so that slow links are not overcommitted. Once settled, it probes
+ a part more every few rounds, in case the link got faster.
+
+ Not thread safe. The transfer utility calls it from the delegate callbacks of its session, which are serial.
+ */
+@interface AWSS3TransferUtilityMultiPartTuner : NSObject
+
+/**
+ The number of parts to keep in progress.
+ */
+@property (nonatomic, assign, readonly) NSUInteger concurrency;
+
+/**
+ The upper bound of `concurrency`, the concurrency limit of the transfer utility.
+ */
+@property (nonatomic, assign, readonly) NSUInteger maxConcurrency;
+
+/**
+ Returns the part size of a multipart upload of `contentLength` bytes.
+
+ The part size is 5 MB, or more when it takes more than 10,000 parts, the maximum number of parts of an upload. With
+ auto-tuning, it is chosen to make about 1,000 parts of up to 32 MB, so that large files are not sent in thousands of
+ requests.
+ */
++ (NSUInteger)partSizeForContentLength:(unsigned long long)contentLength
+                            autoTuning:(BOOL)autoTuning;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithMaxConcurrency:(NSUInteger)maxConcurrency NS_DESIGNATED_INITIALIZER;
+
+/**
+ Records a part of `length` bytes that finished uploading at `time`, in seconds.
+ */
+- (void)partDidCompleteWithLength:(int64_t)length
+                           atTime:(NSTimeInterval)time;
+
+/**
+ Records a part that failed with a retriable error at `time`, in seconds.
+ */
+- (void)partDidFailAtTime:(NSTimeInterval)time;
+
+@end
+
+NS_ASSUME_NONNULL_END
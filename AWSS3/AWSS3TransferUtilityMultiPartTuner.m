@@ -0,0 +1,137 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSS3TransferUtilityMultiPartTuner.h"
+
+static unsigned long long const AWSS3TransferUtilityMultiPartTunerMegabyte = 1024 * 1024;
+// The minimum part size of S3, but for the last part.
+static unsigned long long const AWSS3TransferUtilityMultiPartTunerMinimumPartSize = 5 * 1024 * 1024;
+static unsigned long long const AWSS3TransferUtilityMultiPartTunerMaximumPartCount = 10000;
+static unsigned long long const AWSS3TransferUtilityMultiPartTunerTargetPartCount = 1000;
+static unsigned long long const AWSS3TransferUtilityMultiPartTunerMaximumTargetPartSize = 32 * 1024 * 1024;
+static NSUInteger const AWSS3TransferUtilityMultiPartTunerInitialConcurrency = 2;
+// A part more has to make the upload this much faster to be kept.
+static double const AWSS3TransferUtilityMultiPartTunerImprovementThreshold = 0.1;
+static NSUInteger const AWSS3TransferUtilityMultiPartTunerSteadyRoundCount = 4;
+
+// Rounds `length` divided by `divisor` up to a whole number of megabytes.
+static unsigned long long AWSS3TransferUtilityMultiPartTunerMegabytesCeiling(unsigned long long length, unsigned long long divisor) {
+    unsigned long long quotient = (length + divisor - 1) / divisor;
+    return (quotient + AWSS3TransferUtilityMultiPartTunerMegabyte - 1) / AWSS3TransferUtilityMultiPartTunerMegabyte * AWSS3TransferUtilityMultiPartTunerMegabyte;
+}
+
+@interface AWSS3TransferUtilityMultiPartTuner()
+
+@property (nonatomic, assign, readwrite) NSUInteger concurrency;
+@property (nonatomic, assign, readwrite) NSUInteger maxConcurrency;
+@property (nonatomic, assign) BOOL roundStarted;
+@property (nonatomic, assign) NSTimeInterval roundStartTime;
+@property (nonatomic, assign) int64_t roundBytes;
+@property (nonatomic, assign) NSUInteger roundPartCount;
+// The throughput of the upload with one part less in progress while probing, or of the last round otherwise.
+@property (nonatomic, assign) double baselineThroughput;
+@property (nonatomic, assign) BOOL probing;
+@property (nonatomic, assign) NSUInteger steadyRoundCount;
+
+@end
+
+@implementation AWSS3TransferUtilityMultiPartTuner
+
++ (NSUInteger)partSizeForContentLength:(unsigned long long)contentLength
+                            autoTuning:(BOOL)autoTuning {
+    unsigned long long partSize = AWSS3TransferUtilityMultiPartTunerMinimumPartSize;
+    if (autoTuning) {
+        unsigned long long targetPartSize = AWSS3TransferUtilityMultiPartTunerMegabytesCeiling(contentLength, AWSS3TransferUtilityMultiPartTunerTargetPartCount);
+        partSize = MAX(partSize, MIN(targetPartSize, AWSS3TransferUtilityMultiPartTunerMaximumTargetPartSize));
+    }
+    // Applies to every upload, as S3 rejects the parts past the maximum part count.
+    partSize = MAX(partSize, AWSS3TransferUtilityMultiPartTunerMegabytesCeiling(contentLength, AWSS3TransferUtilityMultiPartTunerMaximumPartCount));
+    return (NSUInteger)partSize;
+}
+
+- (instancetype)initWithMaxConcurrency:(NSUInteger)maxConcurrency {
+    if (self = [super init]) {
+        _maxConcurrency = MAX(maxConcurrency, 1);
+        _concurrency = MIN(AWSS3TransferUtilityMultiPartTunerInitialConcurrency, _maxConcurrency);
+        // The first round is compared with nothing, so it always adds a part.
+        _probing = YES;
+    }
+    return self;
+}
+
+- (void)partDidCompleteWithLength:(int64_t)length
+                           atTime:(NSTimeInterval)time {
+    // The first part to finish starts the clock, as the parts in progress may have started long before.
+    if (!self.roundStarted) {
+        [self startRoundAtTime:time];
+        return;
+    }
+
+    self.roundBytes += length;
+    self.roundPartCount++;
+    if (self.roundPartCount < MAX(self.concurrency, AWSS3TransferUtilityMultiPartTunerInitialConcurrency)) {
+        return;
+    }
+
+    NSTimeInterval duration = time - self.roundStartTime;
+    if (duration > 0) {
+        [self finishRoundWithThroughput:self.roundBytes / duration];
+    }
+    [self startRoundAtTime:time];
+}
+
+- (void)partDidFailAtTime:(NSTimeInterval)time {
+    self.concurrency = MAX(self.concurrency / 2, 1);
+    self.probing = NO;
+    self.steadyRoundCount = 0;
+    [self startRoundAtTime:time];
+}
+
+- (void)startRoundAtTime:(NSTimeInterval)time {
+    self.roundStarted = YES;
+    self.roundStartTime = time;
+    self.roundBytes = 0;
+    self.roundPartCount = 0;
+}
+
+- (void)finishRoundWithThroughput:(double)throughput {
+    if (self.probing) {
+        if (throughput > self.baselineThroughput * (1 + AWSS3TransferUtilityMultiPartTunerImprovementThreshold)) {
+            self.baselineThroughput = throughput;
+            if (self.concurrency < self.maxConcurrency) {
+                self.concurrency++;
+            } else {
+                self.probing = NO;
+            }
+        } else {
+            // The link is saturated, the part added only shares it.
+            self.concurrency = MAX(self.concurrency - 1, 1);
+            self.probing = NO;
+        }
+        self.steadyRoundCount = 0;
+        return;
+    }
+
+    self.baselineThroughput = throughput;
+    self.steadyRoundCount++;
+    if (self.steadyRoundCount >= AWSS3TransferUtilityMultiPartTunerSteadyRoundCount
+        && self.concurrency < self.maxConcurrency) {
+        self.concurrency++;
+        self.probing = YES;
+        self.steadyRoundCount = 0;
+    }
+}
+
+@end
@@ -21,10 +21,12 @@ NS_ASSUME_NONNULL_BEGIN
 @class AWSS3TransferUtilityUploadTask;
 @class AWSS3TransferUtilityMultiPartUploadTask;
 @class AWSS3TransferUtilityDownloadTask;
+@class AWSS3TransferUtilityMultiPartDownloadTask;
 @class AWSS3TransferUtilityExpression;
 @class AWSS3TransferUtilityUploadExpression;
 @class AWSS3TransferUtilityMultiPartUploadExpression;
 @class AWSS3TransferUtilityDownloadExpression;
+@class AWSS3TransferUtilityMultiPartDownloadExpression;
 
 typedef NS_ENUM(NSInteger, AWSS3TransferUtilityTransferStatusType) {
     AWSS3TransferUtilityTransferStatusUnknown,
@@ -67,6 +69,17 @@ typedef void (^AWSS3TransferUtilityDownloadCompletionHandlerBlock) (AWSS3Transfe
                                                                     NSData * _Nullable data,
                                                                     NSError * _Nullable error);
 
+/**
+ The download completion handler for MultiPart.
+
+ @param task     The download task object.
+ @param location The file URL of the downloaded object. Returns `nil` when the download failed.
+ @param error    Returns the error object when the download failed. Returns `nil` on successful download.
+ */
+typedef void (^AWSS3TransferUtilityMultiPartDownloadCompletionHandlerBlock) (AWSS3TransferUtilityMultiPartDownloadTask *task,
+                                                                             NSURL * _Nullable location,
+                                                                             NSError * _Nullable error);
+
 /**
  The transfer progress feedback block.
  
@@ -87,6 +100,15 @@ typedef void (^AWSS3TransferUtilityProgressBlock) (AWSS3TransferUtilityTask *tas
 typedef void (^AWSS3TransferUtilityMultiPartProgressBlock) (AWSS3TransferUtilityMultiPartUploadTask *task,
                                                             NSProgress *progress);
 
+/**
+ The multi part download progress feedback block.
+
+ @param task                     The download task object.
+ @param progress                 The progress object.
+ */
+typedef void (^AWSS3TransferUtilityMultiPartDownloadProgressBlock) (AWSS3TransferUtilityMultiPartDownloadTask *task,
+                                                                    NSProgress *progress);
+
 
 #pragma mark - AWSS3TransferUtilityTasks
 
@@ -252,9 +274,69 @@ typedef void (^AWSS3TransferUtilityMultiPartProgressBlock) (AWSS3TransferUtility
 
 @end
 
+/**
+ The task object to represent a multipart download task, which downloads byte ranges of the object in parallel.
+ */
+@interface AWSS3TransferUtilityMultiPartDownloadTask: NSObject
+
+/**
+ An identifier uniquely identifies the transferID.
+ */
+@property (readonly) NSString *transferID;
+
+/**
+ The Amazon S3 bucket name associated with the transfer.
+ */
+@property (readonly) NSString *bucket;
+
+/**
+ The Amazon S3 object key name associated with the transfer.
+ */
+@property (readonly) NSString *key;
+
+/**
+ The transfer progress.
+ */
+@property (readonly) NSProgress *progress;
+
+/**
+ the status of the Transfer.
+ */
+@property (readonly) AWSS3TransferUtilityTransferStatusType status;
+
+/**
+ Cancels the task.
+ */
+- (void)cancel;
+
+/**
+ Resumes the task, if it is suspended.
+ */
+- (void)resume;
+
+/**
+ Temporarily suspends a task.
+ */
+- (void)suspend;
+
+/**
+ set completion handler for task
+ **/
+- (void) setCompletionHandler: (AWSS3TransferUtilityMultiPartDownloadCompletionHandlerBlock)completionHandler;
+
+/**
+ Set the progress Block
+ */
+- (void) setProgressBlock: (AWSS3TransferUtilityMultiPartDownloadProgressBlock) progressBlock;
+
+@end
+
 @interface AWSS3TransferUtilityUploadSubTask: NSObject
 @end
 
+@interface AWSS3TransferUtilityDownloadSubTask: NSObject
+@end
+
 #pragma mark - AWSS3TransferUtilityExpressions
 
 /**
@@ -356,5 +438,43 @@ typedef void (^AWSS3TransferUtilityMultiPartProgressBlock) (AWSS3TransferUtility
 
 @end
 
+/**
+ The expression object for configuring a Multipart download task.
+ */
+@interface AWSS3TransferUtilityMultiPartDownloadExpression : NSObject
+
+/**
+ This NSDictionary can contains additional request headers to be included in the pre-signed URL. Default is emtpy.
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, NSString *> *requestHeaders;
+
+/**
+ This NSDictionary can contains additional request parameters to be included in the pre-signed URL. Adding additional request parameters enables more advanced pre-signed URLs, such as accessing Amazon S3's torrent resource for an object, or for specifying a version ID when accessing an object. Default is emtpy.
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, NSString *> *requestParameters;
+
+/**
+ The progress feedback block.
+ */
+@property (copy, nonatomic, nullable) AWSS3TransferUtilityMultiPartDownloadProgressBlock progressBlock;
+
+/**
+ Set an additional request header to be included in the pre-signed URL.
+
+ @param value The value of the request parameter being added. Set to nil if parameter doesn't contains value.
+ @param requestHeader The name of the request header.
+ */
+- (void)setValue:(nullable NSString *)value forRequestHeader:(NSString *)requestHeader;
+
+/**
+ Set an additional request parameter to be included in the pre-signed URL. Adding additional request parameters enables more advanced pre-signed URLs, such as accessing Amazon S3's torrent resource for an object, or for specifying a version ID when accessing an object.
+
+ @param value The value of the request parameter being added. Set to nil if parameter doesn't contains value.
+ @param requestParameter The name of the request parameter, as it appears in the URL's query string (e.g. AWSS3PresignedURLVersionID).
+ */
+- (void)setValue:(nullable NSString *)value forRequestParameter:(NSString *)requestParameter;
+
+@end
+
 NS_ASSUME_NONNULL_END
 
@@ -16,6 +16,7 @@
 #import <Foundation/Foundation.h>
 #import "AWSS3TransferUtilityTasks.h"
 #import "AWSS3TransferUtilityDatabaseHelper.h"
+#import "AWSS3TransferUtilityMultiPartTuner.h"
 #import "AWSS3PreSignedURL.h"
 #import <AWSCore/AWSFMDB.h>
 
@@ -45,6 +46,14 @@
 @property (copy, atomic) AWSS3TransferUtilityDownloadCompletionHandlerBlock completionHandler;
 @end
 
+@interface AWSS3TransferUtilityMultiPartDownloadExpression()
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSString *> *internalRequestHeaders;
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSString *> *internalRequestParameters;
+- (void)assignRequestParameters:(AWSS3GetPreSignedURLRequest *)getPreSignedURLRequest;
+- (void)assignRequestHeaders:(AWSS3GetPreSignedURLRequest *)getPreSignedURLRequest;
+@property (copy, atomic) AWSS3TransferUtilityMultiPartDownloadCompletionHandlerBlock completionHandler;
+@end
+
 
 @interface AWSS3TransferUtilityTask()
 
@@ -78,10 +87,17 @@
 @property BOOL cancelled;
 @property BOOL temporaryFileCreated;
 @property (strong, atomic) NSMutableDictionary <NSNumber *, AWSS3TransferUtilityUploadSubTask *> *waitingPartsDictionary;
+//The parts in waitingPartsDictionary, in the order they are started in.
+@property (strong, atomic) NSMutableOrderedSet <AWSS3TransferUtilityUploadSubTask *> *waitingParts;
+@property (strong, atomic) NSMutableArray <AWSS3TransferUtilityUploadSubTask *> *pendingParts;
 @property (strong, atomic) NSMutableSet <AWSS3TransferUtilityUploadSubTask *> *completedPartsSet;
+//The length of the parts in completedPartsSet.
+@property int64_t completedPartsLength;
 @property (strong, atomic) NSMutableDictionary <NSNumber *, AWSS3TransferUtilityUploadSubTask *> *inProgressPartsDictionary;
 @property int retryCount;
 @property int partNumber;
+@property NSUInteger partSize;
+@property (strong, nonatomic) AWSS3TransferUtilityMultiPartTuner *tuner;
 @property NSString *file;
 @property NSString *transferType;
 @property NSString *nsURLSessionID;
@@ -117,6 +133,45 @@
 @property NSString *responseData;
 @end
 
+@interface AWSS3TransferUtilityMultiPartDownloadTask()
+
+@property (strong, nonatomic) AWSS3TransferUtilityMultiPartDownloadExpression *expression;
+@property BOOL cancelled;
+@property (strong, atomic) NSMutableArray <AWSS3TransferUtilityDownloadSubTask *> *pendingParts;
+@property (strong, atomic) NSMutableSet <AWSS3TransferUtilityDownloadSubTask *> *completedPartsSet;
+@property (strong, atomic) NSMutableDictionary <NSNumber *, AWSS3TransferUtilityDownloadSubTask *> *inProgressPartsDictionary;
+@property int retryCount;
+@property NSUInteger partSize;
+@property (strong, nonatomic) AWSS3TransferUtilityMultiPartTuner *tuner;
+@property NSString *file;
+@property NSString *transferType;
+@property NSString *nsURLSessionID;
+@property (strong) AWSFMDatabaseQueue *databaseQueue;
+@property (strong, nonatomic) NSError *error;
+@property (strong, nonatomic) NSString *bucket;
+@property (strong, nonatomic) NSString *key;
+@property (strong, nonatomic) NSString *transferID;
+@property (strong, nonatomic) NSURL *location;
+@property AWSS3TransferUtilityTransferStatusType status;
+@property NSNumber *contentLength;
+@property NSString *eTag;
+@property NSString *checksum;
+@end
+
+@interface AWSS3TransferUtilityDownloadSubTask()
+@property (strong, nonatomic) NSURLSessionTask *sessionTask;
+@property (strong, nonatomic) NSNumber *partNumber;
+@property (readwrite) NSUInteger taskIdentifier;
+@property int64_t offset;
+@property int64_t totalBytesExpectedToReceive;
+@property int64_t totalBytesReceived;
+@property NSString *responseData;
+@property NSString *transferType;
+@property NSString *transferID;
+@property AWSS3TransferUtilityTransferStatusType status;
+@property (strong, nonatomic) NSError *error;
+@end
+
 
 
 @interface AWSS3TransferUtilityDatabaseHelper()
@@ -241,6 +296,8 @@
     if (self = [super init]) {
         _progress = [NSProgress new];
         _waitingPartsDictionary = [NSMutableDictionary new];
+        _waitingParts = [NSMutableOrderedSet new];
+        _pendingParts = [NSMutableArray new];
         _inProgressPartsDictionary = [NSMutableDictionary new];
         _completedPartsSet = [NSMutableSet new];
     }
@@ -383,9 +440,120 @@
 
 @end
 
+@implementation AWSS3TransferUtilityMultiPartDownloadTask
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _progress = [NSProgress new];
+        _pendingParts = [NSMutableArray new];
+        _inProgressPartsDictionary = [NSMutableDictionary new];
+        _completedPartsSet = [NSMutableSet new];
+    }
+    return self;
+}
+
+- (AWSS3TransferUtilityMultiPartDownloadExpression *)expression {
+    if (!_expression) {
+        _expression = [AWSS3TransferUtilityMultiPartDownloadExpression new];
+    }
+    return _expression;
+}
+
+- (void)cancel {
+    self.cancelled = YES;
+    self.status = AWSS3TransferUtilityTransferStatusCancelled;
+    for (NSNumber *key in [self.inProgressPartsDictionary allKeys]) {
+        AWSS3TransferUtilityDownloadSubTask *subTask = [self.inProgressPartsDictionary objectForKey:key];
+        [subTask.sessionTask cancel];
+    }
+
+    [AWSS3TransferUtilityDatabaseHelper deleteTransferRequestFromDB:_transferID databaseQueue:self.databaseQueue];
+}
+
+- (void)resume {
+    if (self.status != AWSS3TransferUtilityTransferStatusPaused ) {
+        //Resume called on a transfer that hasn't been paused. No op.
+        return;
+    }
+
+    for (NSNumber *key in [self.inProgressPartsDictionary allKeys]) {
+        AWSS3TransferUtilityDownloadSubTask *subTask = [self.inProgressPartsDictionary objectForKey:key];
+        subTask.status = AWSS3TransferUtilityTransferStatusInProgress;
+        [AWSS3TransferUtilityDatabaseHelper updateTransferRequestInDB:subTask.transferID
+                                                           partNumber:subTask.partNumber
+                                                       taskIdentifier:subTask.taskIdentifier
+                                                                 eTag:@""
+                                                               status:subTask.status
+                                                          retry_count:self.retryCount
+                                                        databaseQueue:self.databaseQueue];
+        [subTask.sessionTask resume];
+    }
+    self.status = AWSS3TransferUtilityTransferStatusInProgress;
+    //Update the Master Record, which keeps the ETag of the object.
+    [AWSS3TransferUtilityDatabaseHelper updateTransferRequestInDB:self.transferID
+                                                       partNumber:@0
+                                                   taskIdentifier:0
+                                                             eTag:self.eTag
+                                                           status:self.status
+                                                      retry_count:self.retryCount
+                                                    databaseQueue:self.databaseQueue];
+}
+
+- (void)suspend {
+    if (self.status != AWSS3TransferUtilityTransferStatusInProgress) {
+        //Pause called on a transfer that is not in progresss. No op.
+        return;
+    }
+
+    for (NSNumber *key in [self.inProgressPartsDictionary allKeys]) {
+        AWSS3TransferUtilityDownloadSubTask *subTask = [self.inProgressPartsDictionary objectForKey:key];
+        [subTask.sessionTask suspend];
+        subTask.status = AWSS3TransferUtilityTransferStatusPaused;
+
+        [AWSS3TransferUtilityDatabaseHelper updateTransferRequestInDB:subTask.transferID
+                                                           partNumber:subTask.partNumber
+                                                       taskIdentifier:subTask.taskIdentifier
+                                                                 eTag:@""
+                                                               status:subTask.status
+                                                          retry_count:self.retryCount
+                                                        databaseQueue:self.databaseQueue];
+    }
+    self.status = AWSS3TransferUtilityTransferStatusPaused;
+    //Update the Master Record, which keeps the ETag of the object.
+    [AWSS3TransferUtilityDatabaseHelper updateTransferRequestInDB:self.transferID
+                                                       partNumber:@0
+                                                   taskIdentifier:0
+                                                             eTag:self.eTag
+                                                           status:self.status
+                                                      retry_count:self.retryCount
+                                                    databaseQueue:self.databaseQueue];
+}
+
+-(void) setCompletionHandler:(AWSS3TransferUtilityMultiPartDownloadCompletionHandlerBlock)completionHandler {
+
+    self.expression.completionHandler = completionHandler;
+    //If the task has already completed successfully, call the completion handler
+    if (self.status == AWSS3TransferUtilityTransferStatusCompleted) {
+        _expression.completionHandler(self, self.location, nil);
+    }
+    //If the task has completed with error, call the completion handler
+    else if (self.error ) {
+        _expression.completionHandler(self, nil, self.error);
+    }
+}
+
+-(void) setProgressBlock:(AWSS3TransferUtilityMultiPartDownloadProgressBlock)progressBlock {
+    self.expression.progressBlock = progressBlock;
+}
+
+@end
+
 @implementation AWSS3TransferUtilityUploadSubTask
 @end
 
+@implementation AWSS3TransferUtilityDownloadSubTask
+@end
+
 #pragma mark - AWSS3TransferUtilityExpressions
 
 @implementation AWSS3TransferUtilityExpression
@@ -478,3 +646,45 @@
 
 @implementation AWSS3TransferUtilityDownloadExpression
 @end
+
+@implementation AWSS3TransferUtilityMultiPartDownloadExpression
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _internalRequestHeaders = [NSMutableDictionary new];
+        _internalRequestParameters = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (NSDictionary<NSString *, NSString *> *)requestHeaders {
+    return [NSDictionary dictionaryWithDictionary:self.internalRequestHeaders];
+}
+
+- (NSDictionary<NSString *, NSString *> *)requestParameters {
+    return [NSDictionary dictionaryWithDictionary:self.internalRequestParameters];
+}
+
+- (void)setValue:(NSString *)value forRequestHeader:(NSString *)requestHeader {
+    [self.internalRequestHeaders setValue:value forKey:requestHeader];
+}
+
+- (void)setValue:(NSString *)value forRequestParameter:(NSString *)requestParameter {
+    [self.internalRequestParameters setValue:value forKey:requestParameter];
+}
+
+- (void)assignRequestHeaders:(AWSS3GetPreSignedURLRequest *)getPreSignedURLRequest {
+    for (NSString *key in self.internalRequestHeaders) {
+        [getPreSignedURLRequest setValue:self.internalRequestHeaders[key]
+                        forRequestHeader:key];
+    }
+}
+
+- (void)assignRequestParameters:(AWSS3GetPreSignedURLRequest *)getPreSignedURLRequest {
+    for (NSString *key in self.internalRequestParameters) {
+        [getPreSignedURLRequest setValue:self.internalRequestParameters[key]
+                     forRequestParameter:key];
+    }
+}
+
+@end
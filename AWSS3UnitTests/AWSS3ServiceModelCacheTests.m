@@ -0,0 +1,70 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+#import "AWSS3Resources.h"
+
+@interface AWSS3Resources (AWSS3ServiceModelCacheTests)
+
+- (NSString *)definitionString;
+
+@end
+
+@interface AWSServiceModelCache (AWSS3ServiceModelCacheTests)
+
+@property (nonatomic, strong) dispatch_queue_t writeQueue;
+
+@end
+
+// The S3 definition is the largest one loaded at startup, so it is benchmarked here, where it is linked.
+@interface AWSS3ServiceModelCacheTests : XCTestCase
+
+@end
+
+@implementation AWSS3ServiceModelCacheTests
+
+- (void)testS3DefinitionIsLoadedThroughTheCache {
+    NSDictionary *definition = [[AWSS3Resources sharedInstance] JSONObject];
+    XCTAssertEqualObjects(definition[@"metadata"][@"endpointPrefix"], @"s3");
+    XCTAssertNotNil(definition[@"operations"][@"PutObject"]);
+}
+
+- (void)testPerformanceParsingJSONDefinition {
+    NSString *definitionString = [[AWSS3Resources sharedInstance] definitionString];
+    [self measureBlock:^{
+        @autoreleasepool {
+            NSDictionary *definition = [NSJSONSerialization JSONObjectWithData:[definitionString dataUsingEncoding:NSUTF8StringEncoding] options:0 error:nil];
+            XCTAssertNotNil(definition);
+        }
+    }];
+}
+
+- (void)testPerformanceLoadingCompiledDefinition {
+    NSString *definitionString = [[AWSS3Resources sharedInstance] definitionString];
+    AWSServiceModelCache *cache = [AWSServiceModelCache new];
+    [cache serviceDefinitionForName:@"S3Benchmark" definitionString:definitionString bundle:nil];
+    dispatch_sync(cache.writeQueue, ^{});
+
+    [self measureBlock:^{
+        @autoreleasepool {
+            NSDictionary *definition = [cache serviceDefinitionForName:@"S3Benchmark" definitionString:definitionString bundle:nil];
+            XCTAssertNotNil(definition[AWSServiceModelCacheFingerprintKey]);
+        }
+    }];
+    [cache removeAllCachedModels];
+}
+
+@end
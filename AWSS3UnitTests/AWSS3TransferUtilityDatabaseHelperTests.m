@@ -0,0 +1,140 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSFMDB.h>
+#import "AWSS3TransferUtility.h"
+#import "AWSS3TransferUtilityDatabaseHelper.h"
+
+@interface AWSS3TransferUtilityDatabaseHelper (DatabaseHelperTests)
+
++ (AWSFMDatabaseQueue *)createDatabase:(NSString *)cacheDirectoryPath;
+
++ (void)insertMultiPartUploadRequestInDB:(AWSS3TransferUtilityMultiPartUploadTask *)task
+                           databaseQueue:(AWSFMDatabaseQueue *)databaseQueue;
+
++ (void)insertMultiPartUploadRequestSubTaskInDB:(AWSS3TransferUtilityMultiPartUploadTask *)task
+                                        subTask:(AWSS3TransferUtilityUploadSubTask *)subTask
+                                  databaseQueue:(AWSFMDatabaseQueue *)databaseQueue;
+
++ (void)updateTransferRequestInDB:(NSString *)transferID
+                       partNumber:(NSNumber *)partNumber
+                   taskIdentifier:(NSUInteger)taskIdentifier
+                             eTag:(NSString *)eTag
+                           status:(AWSS3TransferUtilityTransferStatusType)status
+                      retry_count:(NSUInteger)retryCount
+                    databaseQueue:(AWSFMDatabaseQueue *)databaseQueue;
+
++ (void)flushPendingWritesToDatabaseQueue:(AWSFMDatabaseQueue *)databaseQueue;
+
+@end
+
+@interface AWSS3TransferUtilityDatabaseHelperTests : XCTestCase
+
+@property (nonatomic, strong) NSString *directoryPath;
+@property (nonatomic, strong) AWSFMDatabaseQueue *databaseQueue;
+@property (nonatomic, strong) AWSFMDatabase *database;
+
+@end
+
+@implementation AWSS3TransferUtilityDatabaseHelperTests
+
+- (void)setUp {
+    [super setUp];
+    self.directoryPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    self.databaseQueue = [AWSS3TransferUtilityDatabaseHelper createDatabase:self.directoryPath];
+    // A second connection only sees the transactions that are committed.
+    self.database = [AWSFMDatabase databaseWithPath:self.databaseQueue.path];
+    [self.database open];
+}
+
+- (void)tearDown {
+    [self.database close];
+    [self.databaseQueue close];
+    [[NSFileManager defaultManager] removeItemAtPath:self.directoryPath error:nil];
+    [super tearDown];
+}
+
+- (AWSS3TransferUtilityMultiPartUploadTask *)insertUploadWithPartCount:(NSUInteger)partCount {
+    AWSS3TransferUtilityMultiPartUploadTask *task = [AWSS3TransferUtilityMultiPartUploadTask new];
+    [task setValue:[[NSUUID UUID] UUIDString] forKey:@"transferID"];
+    [task setValue:@"session" forKey:@"nsURLSessionID"];
+    [task setValue:@"MULTI_PART_UPLOAD" forKey:@"transferType"];
+    [task setValue:@"bucket" forKey:@"bucket"];
+    [task setValue:@"key" forKey:@"key"];
+    [task setValue:@"uploadID" forKey:@"uploadID"];
+    [task setValue:@"" forKey:@"file"];
+    [task setValue:@(partCount) forKey:@"contentLength"];
+    [task setValue:@(AWSS3TransferUtilityTransferStatusInProgress) forKey:@"status"];
+    [AWSS3TransferUtilityDatabaseHelper insertMultiPartUploadRequestInDB:task databaseQueue:self.databaseQueue];
+
+    for (NSUInteger i = 1; i <= partCount; i++) {
+        AWSS3TransferUtilityUploadSubTask *subTask = [AWSS3TransferUtilityUploadSubTask new];
+        [subTask setValue:@(i) forKey:@"partNumber"];
+        [subTask setValue:@"MULTI_PART_UPLOAD_SUB_TASK" forKey:@"transferType"];
+        [subTask setValue:@1 forKey:@"totalBytesExpectedToSend"];
+        [subTask setValue:@"" forKey:@"file"];
+        [subTask setValue:@(AWSS3TransferUtilityTransferStatusWaiting) forKey:@"status"];
+        [AWSS3TransferUtilityDatabaseHelper insertMultiPartUploadRequestSubTaskInDB:task subTask:subTask databaseQueue:self.databaseQueue];
+    }
+    return task;
+}
+
+- (int)committedRowCount {
+    return [self.database intForQuery:@"SELECT count(*) FROM awstransfer"];
+}
+
+- (void)testDatabaseUsesWriteAheadLogAndIndexes {
+    XCTAssertEqualObjects([[self.database stringForQuery:@"PRAGMA journal_mode"] lowercaseString], @"wal");
+
+    NSMutableSet<NSString *> *indexes = [NSMutableSet new];
+    AWSFMResultSet *resultSet = [self.database executeQuery:@"SELECT name FROM sqlite_master WHERE type = 'index' AND tbl_name = 'awstransfer'"];
+    while ([resultSet next]) {
+        [indexes addObject:[resultSet stringForColumn:@"name"]];
+    }
+    [resultSet close];
+    XCTAssertTrue([indexes containsObject:@"awstransfer_transfer_id"]);
+    XCTAssertTrue([indexes containsObject:@"awstransfer_ns_url_session_id"]);
+}
+
+- (void)testUploadIsCommittedWithItsParts {
+    [self insertUploadWithPartCount:3];
+    XCTAssertEqual([self committedRowCount], 0);
+
+    [AWSS3TransferUtilityDatabaseHelper flushPendingWritesToDatabaseQueue:self.databaseQueue];
+    XCTAssertEqual([self committedRowCount], 4);
+}
+
+- (void)testUpdatesOfAPartAreCoalescedUntilTheMasterRecordIsUpdated {
+    AWSS3TransferUtilityMultiPartUploadTask *task = [self insertUploadWithPartCount:2];
+    [AWSS3TransferUtilityDatabaseHelper flushPendingWritesToDatabaseQueue:self.databaseQueue];
+
+    [AWSS3TransferUtilityDatabaseHelper updateTransferRequestInDB:task.transferID partNumber:@1 taskIdentifier:1 eTag:@""
+                                                           status:AWSS3TransferUtilityTransferStatusInProgress retry_count:0 databaseQueue:self.databaseQueue];
+    [AWSS3TransferUtilityDatabaseHelper updateTransferRequestInDB:task.transferID partNumber:@1 taskIdentifier:1 eTag:@"\"etag\""
+                                                           status:AWSS3TransferUtilityTransferStatusCompleted retry_count:0 databaseQueue:self.databaseQueue];
+    NSString *const query = @"SELECT status FROM awstransfer WHERE transfer_id = ? AND part_number = ?";
+    XCTAssertEqualObjects([self.database stringForQuery:query, task.transferID, @1], @"WAITING");
+
+    // The updates of a master record are committed right away, with the pending updates of the parts.
+    [AWSS3TransferUtilityDatabaseHelper updateTransferRequestInDB:task.transferID partNumber:@0 taskIdentifier:0 eTag:@""
+                                                           status:AWSS3TransferUtilityTransferStatusPaused retry_count:0 databaseQueue:self.databaseQueue];
+    XCTAssertEqualObjects([self.database stringForQuery:query, task.transferID, @0], @"PAUSED");
+    XCTAssertEqualObjects([self.database stringForQuery:query, task.transferID, @1], @"COMPLETED");
+    XCTAssertEqualObjects([self.database stringForQuery:@"SELECT etag FROM awstransfer WHERE transfer_id = ? AND part_number = 1", task.transferID], @"\"etag\"");
+    XCTAssertEqualObjects([self.database stringForQuery:query, task.transferID, @2], @"WAITING");
+}
+
+@end
@@ -0,0 +1,355 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "OCMock.h"
+#import "AWSS3Service.h"
+#import "AWSS3TransferUtility.h"
+#import "AWSS3PreSignedURL.h"
+
+static NSUInteger const AWSS3TestRangeSize = 5 * 1024 * 1024;
+static NSUInteger const AWSS3TestObjectLength = 12 * 1024 * 1024;
+
+@interface AWSS3TransferUtility (MultiPartDownloadTests)
+
+- (instancetype)initWithConfiguration:(AWSServiceConfiguration *)serviceConfiguration
+         transferUtilityConfiguration:(AWSS3TransferUtilityConfiguration *)transferUtilityConfiguration
+                           identifier:(NSString *)identifier
+                         recoverState:(BOOL)recoverState
+                    completionHandler:(void (^)(NSError *_Nullable error))completionHandler;
+
+- (void)recover:(void (^)(NSError *_Nullable error))completionHandler;
+
+@end
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+
+// A download task that is never sent, completed by the test.
+@interface AWSS3TestDownloadTask : NSURLSessionDownloadTask
+
+@property (nonatomic, assign) NSUInteger testTaskIdentifier;
+@property (nonatomic, strong) NSURLRequest *testRequest;
+@property (nonatomic, strong) NSHTTPURLResponse *testResponse;
+@property (nonatomic, assign) BOOL resumed;
+@property (nonatomic, assign) BOOL finished;
+
+@end
+
+@implementation AWSS3TestDownloadTask
+
+- (NSUInteger)taskIdentifier {
+    return self.testTaskIdentifier;
+}
+
+- (NSURLRequest *)originalRequest {
+    return self.testRequest;
+}
+
+- (NSURLResponse *)response {
+    return self.testResponse;
+}
+
+- (NSURLSessionTaskState)state {
+    if (self.finished) {
+        return NSURLSessionTaskStateCompleted;
+    }
+    return self.resumed ? NSURLSessionTaskStateRunning : NSURLSessionTaskStateSuspended;
+}
+
+- (void)resume {
+    self.resumed = YES;
+}
+
+- (void)suspend {
+    self.resumed = NO;
+}
+
+- (void)cancel {
+    self.finished = YES;
+}
+
+@end
+
+#pragma clang diagnostic pop
+
+// Stands in for the background session of the transfer utility.
+@interface AWSS3TestDownloadURLSession : NSObject
+
+@property (nonatomic, strong) NSMutableArray<AWSS3TestDownloadTask *> *tasks;
+
+@end
+
+@implementation AWSS3TestDownloadURLSession
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _tasks = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (NSURLSessionDownloadTask *)downloadTaskWithRequest:(NSURLRequest *)request {
+    AWSS3TestDownloadTask *task = [AWSS3TestDownloadTask new];
+    task.testTaskIdentifier = 2000 + [self.tasks count];
+    task.testRequest = request;
+    [self.tasks addObject:task];
+    return task;
+}
+
+// The session of a relaunched app, which has none of the tasks of the previous one.
+- (void)getTasksWithCompletionHandler:(void (^)(NSArray *dataTasks, NSArray *uploadTasks, NSArray *downloadTasks))completionHandler {
+    completionHandler(@[], @[], @[]);
+}
+
+- (void)finishTasksAndInvalidate {
+}
+
+- (NSArray<AWSS3TestDownloadTask *> *)runningTasks {
+    NSMutableArray *runningTasks = [NSMutableArray new];
+    for (AWSS3TestDownloadTask *task in self.tasks) {
+        if (task.resumed && !task.finished) {
+            [runningTasks addObject:task];
+        }
+    }
+    return runningTasks;
+}
+
+@end
+
+@interface AWSS3TransferUtilityMultiPartDownloadTests : XCTestCase
+
+@property (nonatomic, strong) NSString *key;
+@property (nonatomic, strong) AWSS3TransferUtility *transferUtility;
+@property (nonatomic, strong) AWSS3TestDownloadURLSession *session;
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, strong) NSURL *fileURL;
+
+@end
+
+@implementation AWSS3TransferUtilityMultiPartDownloadTests
+
+- (void)setUp {
+    [super setUp];
+    self.key = [[NSUUID UUID] UUIDString];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1 credentialsProvider:nil];
+    AWSS3TransferUtilityConfiguration *transferUtilityConfiguration = [AWSS3TransferUtilityConfiguration new];
+    transferUtilityConfiguration.multiPartConcurrencyLimit = @2;
+    [AWSS3TransferUtility registerS3TransferUtilityWithConfiguration:configuration
+                                        transferUtilityConfiguration:transferUtilityConfiguration
+                                                              forKey:self.key];
+    self.transferUtility = [AWSS3TransferUtility S3TransferUtilityForKey:self.key];
+
+    NSMutableData *data = [NSMutableData dataWithLength:AWSS3TestObjectLength];
+    arc4random_buf([data mutableBytes], [data length]);
+    self.data = data;
+    self.fileURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+
+    self.session = [AWSS3TestDownloadURLSession new];
+    [self injectMocksIntoTransferUtility:self.transferUtility checksumData:self.data];
+}
+
+- (void)tearDown {
+    [AWSS3TransferUtility removeS3TransferUtilityForKey:self.key];
+    [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:nil];
+    [super tearDown];
+}
+
+// HeadObject returns the CRC32C of `checksumData` as the checksum of the object.
+- (void)injectMocksIntoTransferUtility:(AWSS3TransferUtility *)transferUtility
+                          checksumData:(NSData *)checksumData {
+    AWSChecksum *checksum = [AWSChecksum checksumWithAlgorithm:AWSChecksumAlgorithmCRC32C];
+    [checksum updateWithData:checksumData];
+    AWSS3HeadObjectOutput *output = [AWSS3HeadObjectOutput new];
+    output.contentLength = @(AWSS3TestObjectLength);
+    output.ETag = @"\"etag\"";
+    output.checksumCRC32C = [checksum base64EncodedChecksum];
+
+    id s3 = OCMClassMock([AWSS3 class]);
+    OCMStub([s3 headObject:[OCMArg checkWithBlock:^BOOL(AWSS3HeadObjectRequest *request) {
+        return request.checksumMode == AWSS3ChecksumModeEnabled;
+    }]]).andReturn([AWSTask taskWithResult:output]);
+    id preSignedURLBuilder = OCMClassMock([AWSS3PreSignedURLBuilder class]);
+    OCMStub([preSignedURLBuilder getPreSignedURL:[OCMArg any]]).andReturn([AWSTask taskWithResult:[NSURL URLWithString:@"https://bucket.s3.amazonaws.com/key"]]);
+
+    [transferUtility setValue:s3 forKey:@"s3"];
+    [transferUtility setValue:preSignedURLBuilder forKey:@"preSignedURLBuilder"];
+    [transferUtility setValue:self.session forKey:@"session"];
+}
+
+- (AWSS3TransferUtilityMultiPartDownloadTask *)downloadWithCompletionHandler:(AWSS3TransferUtilityMultiPartDownloadCompletionHandlerBlock)completionHandler {
+    AWSTask *task = [self.transferUtility downloadUsingMultiPartToURL:self.fileURL
+                                                               bucket:@"bucket"
+                                                                  key:@"key"
+                                                           expression:nil
+                                                    completionHandler:completionHandler];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    return task.result;
+}
+
+- (NSRange)rangeOfTask:(AWSS3TestDownloadTask *)task {
+    NSString *range = [task.testRequest valueForHTTPHeaderField:@"Range"];
+    NSArray<NSString *> *bounds = [[range substringFromIndex:[@"bytes=" length]] componentsSeparatedByString:@"-"];
+    NSUInteger first = (NSUInteger)[bounds[0] longLongValue];
+    return NSMakeRange(first, (NSUInteger)[bounds[1] longLongValue] - first + 1);
+}
+
+// Delivers the bytes of the range of `task`, or an error body, the way a background session does.
+- (void)finishTask:(AWSS3TestDownloadTask *)task
+        statusCode:(NSInteger)statusCode
+    transferUtility:(AWSS3TransferUtility *)transferUtility {
+    NSData *body = statusCode == 206
+        ? [self.data subdataWithRange:[self rangeOfTask:task]]
+        : [@"<Error><Code>SlowDown</Code></Error>" dataUsingEncoding:NSUTF8StringEncoding];
+    NSURL *location = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [body writeToURL:location atomically:YES];
+
+    task.testResponse = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://bucket.s3.amazonaws.com/key"]
+                                                    statusCode:statusCode
+                                                   HTTPVersion:@"HTTP/1.1"
+                                                  headerFields:@{@"ETag" : @"\"etag\""}];
+    task.finished = YES;
+    [(id<NSURLSessionDownloadDelegate>)transferUtility URLSession:(NSURLSession *)self.session
+                                                    downloadTask:task
+                                       didFinishDownloadingToURL:location];
+    [[NSFileManager defaultManager] removeItemAtURL:location error:nil];
+    [(id<NSURLSessionTaskDelegate>)transferUtility URLSession:(NSURLSession *)self.session
+                                                         task:task
+                                         didCompleteWithError:nil];
+}
+
+- (void)finishTask:(AWSS3TestDownloadTask *)task statusCode:(NSInteger)statusCode {
+    [self finishTask:task statusCode:statusCode transferUtility:self.transferUtility];
+}
+
+- (void)testRangesFinishedOutOfOrderAreWrittenAtTheirOffsets {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"The download completes"];
+    __block NSError *completionError = nil;
+    AWSS3TransferUtilityMultiPartDownloadTask *downloadTask = [self downloadWithCompletionHandler:^(AWSS3TransferUtilityMultiPartDownloadTask *task, NSURL *location, NSError *error) {
+        completionError = error;
+        [expectation fulfill];
+    }];
+
+    // 3 ranges of 5 MB, 5 MB and 2 MB, the first two in progress.
+    XCTAssertEqual([[self.session runningTasks] count], 2);
+    AWSS3TestDownloadTask *firstTask = self.session.tasks[0];
+    AWSS3TestDownloadTask *secondTask = self.session.tasks[1];
+    XCTAssertEqualObjects([firstTask.testRequest valueForHTTPHeaderField:@"Range"], @"bytes=0-5242879");
+    XCTAssertEqualObjects([secondTask.testRequest valueForHTTPHeaderField:@"Range"], @"bytes=5242880-10485759");
+    XCTAssertEqualObjects([firstTask.testRequest valueForHTTPHeaderField:@"If-Match"], @"\"etag\"");
+
+    [self finishTask:secondTask statusCode:206];
+    XCTAssertEqual([self.session.tasks count], 3);
+    AWSS3TestDownloadTask *thirdTask = self.session.tasks[2];
+    XCTAssertEqualObjects([thirdTask.testRequest valueForHTTPHeaderField:@"Range"], @"bytes=10485760-12582911");
+    [self finishTask:thirdTask statusCode:206];
+    XCTAssertEqual(downloadTask.progress.completedUnitCount, AWSS3TestObjectLength - AWSS3TestRangeSize);
+    [self finishTask:firstTask statusCode:206];
+
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    XCTAssertNil(completionError);
+    XCTAssertEqual(downloadTask.status, AWSS3TransferUtilityTransferStatusCompleted);
+    XCTAssertEqual(downloadTask.progress.completedUnitCount, AWSS3TestObjectLength);
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:self.fileURL], self.data);
+    NSArray *files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:NSTemporaryDirectory() error:nil];
+    XCTAssertEqual([[files filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"SELF BEGINSWITH %@", self.fileURL.lastPathComponent]] count], 1);
+}
+
+- (void)testChecksumMismatchFailsTheDownload {
+    NSMutableData *otherData = [self.data mutableCopy];
+    ((uint8_t *)[otherData mutableBytes])[AWSS3TestObjectLength - 1] ^= 0xFF;
+    [self injectMocksIntoTransferUtility:self.transferUtility checksumData:otherData];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"The download fails"];
+    __block NSError *completionError = nil;
+    [self downloadWithCompletionHandler:^(AWSS3TransferUtilityMultiPartDownloadTask *task, NSURL *location, NSError *error) {
+        XCTAssertNil(location);
+        completionError = error;
+        [expectation fulfill];
+    }];
+    [self finishTask:self.session.tasks[0] statusCode:206];
+    [self finishTask:self.session.tasks[1] statusCode:206];
+    [self finishTask:self.session.tasks[2] statusCode:206];
+
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    XCTAssertEqualObjects(completionError.domain, AWSS3TransferUtilityErrorDomain);
+    XCTAssertEqual(completionError.code, AWSS3TransferUtilityErrorChecksumMismatch);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:self.fileURL.path]);
+}
+
+- (void)testServerErrorIsRetried {
+    AWSS3TransferUtilityConfiguration *transferUtilityConfiguration = [self.transferUtility valueForKey:@"transferUtilityConfiguration"];
+    transferUtilityConfiguration.retryLimit = 1;
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"The download completes"];
+    __block NSError *completionError = nil;
+    [self downloadWithCompletionHandler:^(AWSS3TransferUtilityMultiPartDownloadTask *task, NSURL *location, NSError *error) {
+        completionError = error;
+        [expectation fulfill];
+    }];
+
+    AWSS3TestDownloadTask *firstTask = self.session.tasks[0];
+    [self finishTask:firstTask statusCode:503];
+    AWSS3TestDownloadTask *retriedTask = [self.session.tasks lastObject];
+    XCTAssertNotEqual(retriedTask, firstTask);
+    XCTAssertEqualObjects([retriedTask.testRequest valueForHTTPHeaderField:@"Range"], [firstTask.testRequest valueForHTTPHeaderField:@"Range"]);
+
+    while ([[self.session runningTasks] count] > 0) {
+        [self finishTask:[[self.session runningTasks] firstObject] statusCode:206];
+    }
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    XCTAssertNil(completionError);
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:self.fileURL], self.data);
+}
+
+- (void)testRecoveredDownloadOnlyRequestsRemainingRanges {
+    [self downloadWithCompletionHandler:nil];
+    [self finishTask:self.session.tasks[1] statusCode:206];
+    XCTAssertEqual([[self.session runningTasks] count], 2);
+
+    // The app is terminated with the first range in progress and relaunched with a new session.
+    AWSS3TestDownloadTask *interruptedTask = self.session.tasks[0];
+    self.session = [AWSS3TestDownloadURLSession new];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1 credentialsProvider:nil];
+    AWSS3TransferUtility *transferUtility = [[AWSS3TransferUtility alloc] initWithConfiguration:configuration
+                                                                  transferUtilityConfiguration:[self.transferUtility valueForKey:@"transferUtilityConfiguration"]
+                                                                                    identifier:[self.transferUtility valueForKey:@"sessionIdentifier"]
+                                                                                  recoverState:NO
+                                                                             completionHandler:nil];
+    [self injectMocksIntoTransferUtility:transferUtility checksumData:self.data];
+    [transferUtility recover:nil];
+
+    NSArray<AWSS3TransferUtilityMultiPartDownloadTask *> *downloadTasks = [[transferUtility getMultiPartDownloadTasks] result];
+    XCTAssertEqual([downloadTasks count], 1);
+    XCTestExpectation *expectation = [self expectationWithDescription:@"The download completes"];
+    __block NSError *completionError = nil;
+    [[downloadTasks firstObject] setCompletionHandler:^(AWSS3TransferUtilityMultiPartDownloadTask *task, NSURL *location, NSError *error) {
+        completionError = error;
+        [expectation fulfill];
+    }];
+
+    XCTAssertEqual([self.session.tasks count], 2);
+    XCTAssertEqualObjects([self.session.tasks[0].testRequest valueForHTTPHeaderField:@"Range"], [interruptedTask.testRequest valueForHTTPHeaderField:@"Range"]);
+    XCTAssertEqualObjects([self.session.tasks[1].testRequest valueForHTTPHeaderField:@"Range"], @"bytes=10485760-12582911");
+    [self finishTask:self.session.tasks[0] statusCode:206 transferUtility:transferUtility];
+    [self finishTask:self.session.tasks[1] statusCode:206 transferUtility:transferUtility];
+
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    XCTAssertNil(completionError);
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:self.fileURL], self.data);
+}
+
+@end
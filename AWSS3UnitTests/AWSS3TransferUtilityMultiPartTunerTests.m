@@ -0,0 +1,285 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSS3TransferUtilityMultiPartTuner.h"
+
+static unsigned long long const AWSS3TestMegabyte = 1024 * 1024;
+static unsigned long long const AWSS3TestGigabyte = 1024 * 1024 * 1024;
+static NSUInteger const AWSS3TestStaticPartSize = 5 * 1024 * 1024;
+
+typedef struct {
+    NSTimeInterval duration;
+    NSUInteger requestCount;
+    NSUInteger failedPartCount;
+} AWSS3TestUploadResult;
+
+/**
+ A link of `bandwidth` bytes per second, shared by the parts in progress. Each part waits `requestLatency` before
+ sending and sends at most `connectionRate` bytes per second. A part sent slower than `minimumRate` times out, with a
+ probability that grows with how much slower it is, as S3 does with idle connections.
+ */
+@interface AWSS3TestSimulatedLink : NSObject
+
+@property (nonatomic, assign) double bandwidth;
+@property (nonatomic, assign) double connectionRate;
+@property (nonatomic, assign) NSTimeInterval requestLatency;
+@property (nonatomic, assign) double minimumRate;
+
+@end
+
+@implementation AWSS3TestSimulatedLink
+
+@end
+
+@interface AWSS3TestSimulatedPart : NSObject
+
+@property (nonatomic, assign) double length;
+@property (nonatomic, assign) NSTimeInterval startTime;
+@property (nonatomic, assign) NSTimeInterval remainingLatency;
+@property (nonatomic, assign) double remainingLength;
+
+@end
+
+@implementation AWSS3TestSimulatedPart
+
+@end
+
+@interface AWSS3TransferUtilityMultiPartTunerTests : XCTestCase
+
+@end
+
+@implementation AWSS3TransferUtilityMultiPartTunerTests
+
+#pragma mark - Part size
+
+- (void)testPartSize {
+    XCTAssertEqual([AWSS3TransferUtilityMultiPartTuner partSizeForContentLength:0 autoTuning:NO], AWSS3TestStaticPartSize);
+    XCTAssertEqual([AWSS3TransferUtilityMultiPartTuner partSizeForContentLength:AWSS3TestMegabyte autoTuning:YES], AWSS3TestStaticPartSize);
+    XCTAssertEqual([AWSS3TransferUtilityMultiPartTuner partSizeForContentLength:10 * AWSS3TestGigabyte autoTuning:NO], AWSS3TestStaticPartSize);
+    // About 1,000 parts, in whole megabytes.
+    XCTAssertEqual([AWSS3TransferUtilityMultiPartTuner partSizeForContentLength:10 * AWSS3TestGigabyte autoTuning:YES], 11 * AWSS3TestMegabyte);
+    XCTAssertEqual([AWSS3TransferUtilityMultiPartTuner partSizeForContentLength:100 * AWSS3TestGigabyte autoTuning:YES], 32 * AWSS3TestMegabyte);
+    // Past 10,000 parts of 5 MB, even without auto-tuning.
+    XCTAssertEqual([AWSS3TransferUtilityMultiPartTuner partSizeForContentLength:100 * AWSS3TestGigabyte autoTuning:NO], 11 * AWSS3TestMegabyte);
+}
+
+- (void)testPartCountLimit {
+    unsigned long long const contentLengths[] = {
+        AWSS3TestMegabyte,
+        50000 * AWSS3TestMegabyte,
+        50000 * AWSS3TestMegabyte + 1,
+        AWSS3TestGigabyte * 1000,
+        AWSS3TestGigabyte * 5 * 1024,
+    };
+    for (NSUInteger i = 0; i < sizeof(contentLengths) / sizeof(contentLengths[0]); i++) {
+        for (NSNumber *autoTuning in @[@NO, @YES]) {
+            unsigned long long partSize = [AWSS3TransferUtilityMultiPartTuner partSizeForContentLength:contentLengths[i]
+                                                                                            autoTuning:[autoTuning boolValue]];
+            XCTAssertGreaterThanOrEqual(partSize, AWSS3TestStaticPartSize);
+            XCTAssertEqual(partSize % AWSS3TestMegabyte, 0);
+            XCTAssertLessThanOrEqual((contentLengths[i] + partSize - 1) / partSize, 10000);
+        }
+    }
+}
+
+#pragma mark - Concurrency
+
+- (void)testInitialConcurrency {
+    XCTAssertEqual([[AWSS3TransferUtilityMultiPartTuner alloc] initWithMaxConcurrency:5].concurrency, 2);
+    XCTAssertEqual([[AWSS3TransferUtilityMultiPartTuner alloc] initWithMaxConcurrency:1].concurrency, 1);
+    XCTAssertEqual([[AWSS3TransferUtilityMultiPartTuner alloc] initWithMaxConcurrency:0].concurrency, 1);
+}
+
+- (void)testFailureHalvesConcurrency {
+    AWSS3TransferUtilityMultiPartTuner *tuner = [[AWSS3TransferUtilityMultiPartTuner alloc] initWithMaxConcurrency:16];
+    [self simulateUploadOfLength:AWSS3TestGigabyte
+                        partSize:AWSS3TestStaticPartSize
+                     concurrency:0
+                           tuner:tuner
+                            link:[self fastLink]];
+    NSUInteger concurrency = tuner.concurrency;
+    XCTAssertGreaterThanOrEqual(concurrency, 8);
+
+    [tuner partDidFailAtTime:1000];
+    XCTAssertEqual(tuner.concurrency, concurrency / 2);
+    [tuner partDidFailAtTime:1001];
+    [tuner partDidFailAtTime:1002];
+    [tuner partDidFailAtTime:1003];
+    [tuner partDidFailAtTime:1004];
+    XCTAssertEqual(tuner.concurrency, 1);
+}
+
+- (void)testConcurrencyGrowsToTheLimit {
+    AWSS3TransferUtilityMultiPartTuner *tuner = [[AWSS3TransferUtilityMultiPartTuner alloc] initWithMaxConcurrency:3];
+    [self simulateUploadOfLength:AWSS3TestGigabyte
+                        partSize:AWSS3TestStaticPartSize
+                     concurrency:0
+                           tuner:tuner
+                            link:[self fastLink]];
+    XCTAssertEqual(tuner.concurrency, 3);
+}
+
+- (void)testConcurrencyStaysLowOnSlowLinks {
+    AWSS3TransferUtilityMultiPartTuner *tuner = [[AWSS3TransferUtilityMultiPartTuner alloc] initWithMaxConcurrency:16];
+    AWSS3TestUploadResult result = [self simulateUploadOfLength:200 * AWSS3TestMegabyte
+                                                       partSize:AWSS3TestStaticPartSize
+                                                    concurrency:0
+                                                          tuner:tuner
+                                                           link:[self slowLink]];
+    XCTAssertLessThanOrEqual(tuner.concurrency, 3);
+    XCTAssertEqual(result.failedPartCount, 0);
+}
+
+#pragma mark - Benchmark
+
+// 100 MB/s, of which a single connection gets 8 MB/s.
+- (AWSS3TestSimulatedLink *)fastLink {
+    AWSS3TestSimulatedLink *link = [AWSS3TestSimulatedLink new];
+    link.bandwidth = 100 * AWSS3TestMegabyte;
+    link.connectionRate = 8 * AWSS3TestMegabyte;
+    link.requestLatency = 0.1;
+    link.minimumRate = 64 * 1024;
+    return link;
+}
+
+// 256 KB/s, so that a few parts in progress already time out.
+- (AWSS3TestSimulatedLink *)slowLink {
+    AWSS3TestSimulatedLink *link = [AWSS3TestSimulatedLink new];
+    link.bandwidth = 256 * 1024;
+    link.connectionRate = 8 * AWSS3TestMegabyte;
+    link.requestLatency = 0.3;
+    link.minimumRate = 64 * 1024;
+    return link;
+}
+
+/**
+ Simulates an upload of `length` bytes in parts of `partSize` over `link`, with `concurrency` parts in progress or as
+ many as `tuner` picks when it is set. Failed parts are retried first. The random draws are seeded, so that results are
+ reproducible.
+ */
+- (AWSS3TestUploadResult)simulateUploadOfLength:(unsigned long long)length
+                                       partSize:(NSUInteger)partSize
+                                    concurrency:(NSUInteger)concurrency
+                                          tuner:(AWSS3TransferUtilityMultiPartTuner *)tuner
+                                           link:(AWSS3TestSimulatedLink *)link {
+    NSMutableArray<NSNumber *> *queue = [NSMutableArray new];
+    for (unsigned long long offset = 0; offset < length; offset += partSize) {
+        [queue addObject:@(MIN(partSize, length - offset))];
+    }
+
+    AWSS3TestUploadResult result = {0, 0, 0};
+    NSMutableArray<AWSS3TestSimulatedPart *> *parts = [NSMutableArray new];
+    NSTimeInterval now = 0;
+    uint32_t seed = 1;
+    while ([queue count] > 0 || [parts count] > 0) {
+        NSUInteger limit = tuner ? tuner.concurrency : concurrency;
+        while ([parts count] < limit && [queue count] > 0) {
+            AWSS3TestSimulatedPart *part = [AWSS3TestSimulatedPart new];
+            part.length = [[queue firstObject] doubleValue];
+            part.startTime = now;
+            part.remainingLatency = link.requestLatency;
+            part.remainingLength = part.length;
+            [queue removeObjectAtIndex:0];
+            [parts addObject:part];
+            result.requestCount++;
+        }
+
+        NSUInteger sendingCount = 0;
+        for (AWSS3TestSimulatedPart *part in parts) {
+            if (part.remainingLatency <= 0) {
+                sendingCount++;
+            }
+        }
+        double rate = sendingCount > 0 ? MIN(link.connectionRate, link.bandwidth / sendingCount) : 0;
+
+        // Runs to the next part that starts sending or finishes.
+        NSTimeInterval step = INFINITY;
+        for (AWSS3TestSimulatedPart *part in parts) {
+            step = MIN(step, part.remainingLatency > 0 ? part.remainingLatency : part.remainingLength / rate);
+        }
+        now += step;
+
+        for (AWSS3TestSimulatedPart *part in [parts copy]) {
+            if (part.remainingLatency > 0) {
+                part.remainingLatency = part.remainingLatency - step > 1e-9 ? part.remainingLatency - step : 0;
+                continue;
+            }
+            part.remainingLength -= rate * step;
+            if (part.remainingLength > 1) {
+                continue;
+            }
+
+            [parts removeObject:part];
+            double averageRate = part.length / (now - part.startTime - link.requestLatency);
+            double failureProbability = averageRate < link.minimumRate ? 1 - averageRate / link.minimumRate : 0;
+            seed = seed * 1664525 + 1013904223;
+            if ((seed >> 8) / (double)(1 << 24) < failureProbability) {
+                result.failedPartCount++;
+                [queue insertObject:@(part.length) atIndex:0];
+                [tuner partDidFailAtTime:now];
+            } else {
+                [tuner partDidCompleteWithLength:(int64_t)part.length atTime:now];
+            }
+        }
+    }
+    result.duration = now;
+    return result;
+}
+
+- (void)testSimulatedBandwidthBenchmark {
+    NSUInteger const maxConcurrency = 16;
+    NSDictionary<NSString *, AWSS3TestSimulatedLink *> *links = @{@"fast" : [self fastLink], @"slow" : [self slowLink]};
+    NSDictionary<NSString *, NSNumber *> *lengths = @{@"fast" : @(10 * AWSS3TestGigabyte), @"slow" : @(100 * AWSS3TestMegabyte)};
+    NSMutableDictionary<NSString *, NSValue *> *results = [NSMutableDictionary new];
+
+    for (NSString *name in @[@"fast", @"slow"]) {
+        AWSS3TestSimulatedLink *link = links[name];
+        unsigned long long length = [lengths[name] unsignedLongLongValue];
+        NSUInteger autoPartSize = [AWSS3TransferUtilityMultiPartTuner partSizeForContentLength:length autoTuning:YES];
+        AWSS3TestUploadResult defaultResult = [self simulateUploadOfLength:length partSize:AWSS3TestStaticPartSize concurrency:5 tuner:nil link:link];
+        AWSS3TestUploadResult wideResult = [self simulateUploadOfLength:length partSize:AWSS3TestStaticPartSize concurrency:maxConcurrency tuner:nil link:link];
+        AWSS3TransferUtilityMultiPartTuner *tuner = [[AWSS3TransferUtilityMultiPartTuner alloc] initWithMaxConcurrency:maxConcurrency];
+        AWSS3TestUploadResult autoResult = [self simulateUploadOfLength:length partSize:autoPartSize concurrency:0 tuner:tuner link:link];
+
+        NSLog(@"%@ link, %.0f MB: 5 MB x 5 parts %.0f s, %lu requests, %lu failed parts; 5 MB x %lu parts %.0f s, %lu requests, %lu failed parts; auto-tuned %lu MB parts %.0f s, %lu requests, %lu failed parts, %lu parts in progress at the end",
+              name, length / (double)AWSS3TestMegabyte,
+              defaultResult.duration, (unsigned long)defaultResult.requestCount, (unsigned long)defaultResult.failedPartCount,
+              (unsigned long)maxConcurrency, wideResult.duration, (unsigned long)wideResult.requestCount, (unsigned long)wideResult.failedPartCount,
+              (unsigned long)(autoPartSize / AWSS3TestMegabyte), autoResult.duration, (unsigned long)autoResult.requestCount, (unsigned long)autoResult.failedPartCount,
+              (unsigned long)tuner.concurrency);
+
+        results[[name stringByAppendingString:@".default"]] = [NSValue valueWithBytes:&defaultResult objCType:@encode(AWSS3TestUploadResult)];
+        results[[name stringByAppendingString:@".wide"]] = [NSValue valueWithBytes:&wideResult objCType:@encode(AWSS3TestUploadResult)];
+        results[[name stringByAppendingString:@".auto"]] = [NSValue valueWithBytes:&autoResult objCType:@encode(AWSS3TestUploadResult)];
+    }
+
+    AWSS3TestUploadResult fastDefault, fastAuto, slowDefault, slowWide, slowAuto;
+    [results[@"fast.default"] getValue:&fastDefault];
+    [results[@"fast.auto"] getValue:&fastAuto];
+    [results[@"slow.default"] getValue:&slowDefault];
+    [results[@"slow.wide"] getValue:&slowWide];
+    [results[@"slow.auto"] getValue:&slowAuto];
+
+    // Fewer, larger parts and more of them in progress on the fast link.
+    XCTAssertLessThan(fastAuto.requestCount, fastDefault.requestCount / 2);
+    XCTAssertLessThan(fastAuto.duration, fastDefault.duration / 2);
+    // No overcommitment on the slow link.
+    XCTAssertLessThan(slowAuto.failedPartCount, slowDefault.failedPartCount);
+    XCTAssertLessThan(slowAuto.failedPartCount, slowWide.failedPartCount);
+    XCTAssertLessThanOrEqual(slowAuto.duration, slowDefault.duration);
+}
+
+@end
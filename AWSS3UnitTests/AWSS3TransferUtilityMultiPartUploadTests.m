@@ -0,0 +1,475 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "OCMock.h"
+#import "AWSS3Service.h"
+#import "AWSS3TransferUtility.h"
+#import "AWSS3PreSignedURL.h"
+#import "AWSS3TransferUtilityDatabaseHelper.h"
+#import <AWSCore/AWSFMDB.h>
+
+static NSUInteger const AWSS3TestPartSize = 5 * 1024 * 1024;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+
+// An upload task that is never sent, completed by the test.
+@interface AWSS3TestUploadTask : NSURLSessionUploadTask
+
+@property (nonatomic, assign) NSUInteger testTaskIdentifier;
+@property (nonatomic, strong) NSURL *fileURL;
+@property (nonatomic, strong) NSHTTPURLResponse *testResponse;
+@property (nonatomic, assign) BOOL resumed;
+@property (nonatomic, assign) BOOL finished;
+
+@end
+
+@implementation AWSS3TestUploadTask
+
+- (NSUInteger)taskIdentifier {
+    return self.testTaskIdentifier;
+}
+
+- (NSURLResponse *)response {
+    return self.testResponse;
+}
+
+- (NSURLSessionTaskState)state {
+    if (self.finished) {
+        return NSURLSessionTaskStateCompleted;
+    }
+    return self.resumed ? NSURLSessionTaskStateRunning : NSURLSessionTaskStateSuspended;
+}
+
+- (void)resume {
+    self.resumed = YES;
+}
+
+- (void)suspend {
+    self.resumed = NO;
+}
+
+- (void)cancel {
+    self.finished = YES;
+}
+
+@end
+
+#pragma clang diagnostic pop
+
+// Stands in for the background session of the transfer utility.
+@interface AWSS3TestURLSession : NSObject
+
+@property (nonatomic, strong) NSMutableArray<AWSS3TestUploadTask *> *tasks;
+
+@end
+
+@implementation AWSS3TestURLSession
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _tasks = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (NSURLSessionUploadTask *)uploadTaskWithRequest:(NSURLRequest *)request
+                                         fromFile:(NSURL *)fileURL {
+    AWSS3TestUploadTask *task = [AWSS3TestUploadTask new];
+    task.testTaskIdentifier = 1000 + [self.tasks count];
+    task.fileURL = fileURL;
+    [self.tasks addObject:task];
+    return task;
+}
+
+// The session of a relaunched app, which has none of the tasks of the previous one.
+- (void)getTasksWithCompletionHandler:(void (^)(NSArray *dataTasks, NSArray *uploadTasks, NSArray *downloadTasks))completionHandler {
+    completionHandler(@[], @[], @[]);
+}
+
+- (void)finishTasksAndInvalidate {
+}
+
+- (NSArray<AWSS3TestUploadTask *> *)runningTasks {
+    NSMutableArray *runningTasks = [NSMutableArray new];
+    for (AWSS3TestUploadTask *task in self.tasks) {
+        if (task.resumed && !task.finished) {
+            [runningTasks addObject:task];
+        }
+    }
+    return runningTasks;
+}
+
+- (NSUInteger)partFileCount {
+    NSUInteger count = 0;
+    for (AWSS3TestUploadTask *task in self.tasks) {
+        if ([[NSFileManager defaultManager] fileExistsAtPath:task.fileURL.path]) {
+            count++;
+        }
+    }
+    return count;
+}
+
+@end
+
+@interface AWSS3TransferUtility (MultiPartUploadTests)
+
+- (instancetype)initWithConfiguration:(AWSServiceConfiguration *)serviceConfiguration
+         transferUtilityConfiguration:(AWSS3TransferUtilityConfiguration *)transferUtilityConfiguration
+                           identifier:(NSString *)identifier
+                         recoverState:(BOOL)recoverState
+                    completionHandler:(void (^)(NSError *_Nullable error))completionHandler;
+
+- (void)recover:(void (^)(NSError *_Nullable error))completionHandler;
+
+- (NSError *)scheduleUploadSubTasks:(AWSS3TransferUtilityMultiPartUploadTask *)transferUtilityMultiPartUploadTask
+                      startTransfer:(BOOL)startTransfer;
+
+@end
+
+@interface AWSS3TransferUtilityDatabaseHelper (MultiPartUploadTests)
+
++ (void)flushPendingWritesToDatabaseQueue:(AWSFMDatabaseQueue *)databaseQueue;
+
+@end
+
+@interface AWSS3TransferUtilityMultiPartUploadTests : XCTestCase
+
+@property (nonatomic, strong) NSString *key;
+@property (nonatomic, strong) AWSS3TransferUtility *transferUtility;
+@property (nonatomic, strong) AWSS3TestURLSession *session;
+@property (nonatomic, strong) NSURL *fileURL;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *presignedPartNumbers;
+@property (nonatomic, strong) AWSS3CompleteMultipartUploadRequest *completeMultipartUploadRequest;
+
+@end
+
+@implementation AWSS3TransferUtilityMultiPartUploadTests
+
+- (void)setUp {
+    [super setUp];
+    self.key = [[NSUUID UUID] UUIDString];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1 credentialsProvider:nil];
+    AWSS3TransferUtilityConfiguration *transferUtilityConfiguration = [AWSS3TransferUtilityConfiguration new];
+    transferUtilityConfiguration.multiPartConcurrencyLimit = @2;
+    [AWSS3TransferUtility registerS3TransferUtilityWithConfiguration:configuration
+                                        transferUtilityConfiguration:transferUtilityConfiguration
+                                                              forKey:self.key];
+    self.transferUtility = [AWSS3TransferUtility S3TransferUtilityForKey:self.key];
+
+    self.session = [AWSS3TestURLSession new];
+    [self injectMocksIntoTransferUtility:self.transferUtility];
+}
+
+// Records the part numbers the URLs are presigned for and the parts the upload is completed with.
+- (void)injectMocksIntoTransferUtility:(AWSS3TransferUtility *)transferUtility {
+    self.presignedPartNumbers = [NSMutableArray new];
+    __weak AWSS3TransferUtilityMultiPartUploadTests *weakSelf = self;
+
+    id s3 = OCMClassMock([AWSS3 class]);
+    AWSS3CreateMultipartUploadOutput *output = [AWSS3CreateMultipartUploadOutput new];
+    output.uploadId = @"uploadID";
+    OCMStub([s3 createMultipartUpload:[OCMArg any]]).andReturn([AWSTask taskWithResult:output]);
+    OCMStub([s3 completeMultipartUpload:[OCMArg checkWithBlock:^BOOL(AWSS3CompleteMultipartUploadRequest *request) {
+        weakSelf.completeMultipartUploadRequest = request;
+        return YES;
+    }]]).andReturn([AWSTask taskWithResult:[AWSS3CompleteMultipartUploadOutput new]]);
+    OCMStub([s3 abortMultipartUpload:[OCMArg any]]).andReturn([AWSTask taskWithResult:nil]);
+    id preSignedURLBuilder = OCMClassMock([AWSS3PreSignedURLBuilder class]);
+    OCMStub([preSignedURLBuilder getPreSignedURL:[OCMArg checkWithBlock:^BOOL(AWSS3GetPreSignedURLRequest *request) {
+        NSNumber *partNumber = [request valueForKey:@"partNumber"];
+        if (partNumber) {
+            [weakSelf.presignedPartNumbers addObject:partNumber];
+        }
+        return YES;
+    }]]).andReturn([AWSTask taskWithResult:[NSURL URLWithString:@"https://bucket.s3.amazonaws.com/key"]]);
+
+    [transferUtility setValue:s3 forKey:@"s3"];
+    [transferUtility setValue:preSignedURLBuilder forKey:@"preSignedURLBuilder"];
+    [transferUtility setValue:self.session forKey:@"session"];
+}
+
+- (void)tearDown {
+    [AWSS3TransferUtility removeS3TransferUtilityForKey:self.key];
+    if (self.fileURL) {
+        [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:nil];
+    }
+    [super tearDown];
+}
+
+// A sparse file, so that a large upload takes no space but its parts do.
+- (NSURL *)createFileWithLength:(unsigned long long)length {
+    NSURL *fileURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [[NSFileManager defaultManager] createFileAtPath:fileURL.path contents:nil attributes:nil];
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingToURL:fileURL error:nil];
+    [fileHandle truncateFileAtOffset:length];
+    [fileHandle closeFile];
+    self.fileURL = fileURL;
+    return fileURL;
+}
+
+- (AWSS3TransferUtilityMultiPartUploadTask *)uploadFile:(NSURL *)fileURL
+                                      completionHandler:(AWSS3TransferUtilityMultiPartUploadCompletionHandlerBlock)completionHandler {
+    AWSTask *task = [self.transferUtility uploadFileUsingMultiPart:fileURL
+                                                            bucket:@"bucket"
+                                                               key:@"key"
+                                                       contentType:@"application/octet-stream"
+                                                        expression:nil
+                                                 completionHandler:completionHandler];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    return task.result;
+}
+
+- (void)finishTask:(AWSS3TestUploadTask *)task statusCode:(NSInteger)statusCode {
+    [self finishTask:task statusCode:statusCode transferUtility:self.transferUtility];
+}
+
+- (void)finishTask:(AWSS3TestUploadTask *)task
+        statusCode:(NSInteger)statusCode
+   transferUtility:(AWSS3TransferUtility *)transferUtility {
+    task.testResponse = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://bucket.s3.amazonaws.com/key"]
+                                                    statusCode:statusCode
+                                                   HTTPVersion:@"HTTP/1.1"
+                                                  headerFields:@{@"ETag" : [NSString stringWithFormat:@"\"%lu\"", (unsigned long)task.taskIdentifier]}];
+    task.finished = YES;
+    [(id<NSURLSessionTaskDelegate>)transferUtility URLSession:(NSURLSession *)self.session
+                                                         task:task
+                                         didCompleteWithError:nil];
+}
+
+- (void)testPartFilesAreCreatedAheadOfTheConcurrencyLimit {
+    NSUInteger const partCount = 10;
+    NSURL *fileURL = [self createFileWithLength:partCount * AWSS3TestPartSize - 1024];
+
+    __block NSError *completionError = nil;
+    __block BOOL completed = NO;
+    [self uploadFile:fileURL completionHandler:^(AWSS3TransferUtilityMultiPartUploadTask *task, NSError *error) {
+        completionError = error;
+        completed = YES;
+    }];
+
+    // Only the parts in progress and the two prepared after them have a file.
+    XCTAssertEqual([[self.session runningTasks] count], 2);
+    XCTAssertEqual([self.session.tasks count], 4);
+    NSUInteger highWaterMark = [self.session partFileCount];
+
+    while ([[self.session runningTasks] count] > 0) {
+        AWSS3TestUploadTask *task = [[self.session runningTasks] firstObject];
+        [self finishTask:task statusCode:200];
+        // The file of a part is deleted as soon as it has been uploaded.
+        XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:task.fileURL.path]);
+        highWaterMark = MAX(highWaterMark, [self.session partFileCount]);
+        XCTAssertLessThanOrEqual([[self.session runningTasks] count], 2);
+    }
+
+    XCTAssertLessThanOrEqual(highWaterMark, 4);
+    XCTAssertEqual([self.session.tasks count], partCount);
+    XCTAssertEqual([self.session partFileCount], 0);
+    XCTAssertTrue(completed);
+    XCTAssertNil(completionError);
+    NSLog(@"Part files on disk: at most %lu of %lu parts (%.0f MB instead of %.0f MB)",
+          (unsigned long)highWaterMark, (unsigned long)partCount,
+          highWaterMark * AWSS3TestPartSize / 1048576.0, partCount * AWSS3TestPartSize / 1048576.0);
+}
+
+- (void)testFailedPartRemovesPreparedPartFiles {
+    NSURL *fileURL = [self createFileWithLength:8 * AWSS3TestPartSize];
+
+    __block NSError *completionError = nil;
+    [self uploadFile:fileURL completionHandler:^(AWSS3TransferUtilityMultiPartUploadTask *task, NSError *error) {
+        completionError = error;
+    }];
+    XCTAssertEqual([self.session partFileCount], 4);
+
+    [self finishTask:[[self.session runningTasks] firstObject] statusCode:403];
+    XCTAssertNotNil(completionError);
+    XCTAssertEqual([self.session partFileCount], 0);
+    XCTAssertEqual([self.session.tasks count], 4);
+}
+
+- (void)testAutoTuningPicksThePartSize {
+    AWSS3TransferUtilityConfiguration *transferUtilityConfiguration = [self.transferUtility valueForKey:@"transferUtilityConfiguration"];
+    transferUtilityConfiguration.multiPartAutoTuningEnabled = YES;
+    NSURL *fileURL = [self createFileWithLength:10 * 1024ULL * 1024 * 1024];
+
+    AWSS3TransferUtilityMultiPartUploadTask *task = [self uploadFile:fileURL completionHandler:nil];
+    XCTAssertNotNil(task);
+    // 931 parts of 11 MB, the first two in progress.
+    XCTAssertEqual([[self.session runningTasks] count], 2);
+    for (AWSS3TestUploadTask *uploadTask in self.session.tasks) {
+        NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:uploadTask.fileURL.path error:nil];
+        XCTAssertEqual([attributes fileSize], 11 * 1024 * 1024);
+    }
+
+    AWSS3TestUploadTask *runningTask = [[self.session runningTasks] firstObject];
+    [task cancel];
+    [self finishTask:runningTask statusCode:200];
+    XCTAssertEqual([self.session partFileCount], 0);
+}
+
+- (void)testSinglePartSharesTheFile {
+    NSURL *fileURL = [self createFileWithLength:0];
+    NSData *data = [[[NSUUID UUID] UUIDString] dataUsingEncoding:NSUTF8StringEncoding];
+    [data writeToURL:fileURL atomically:YES];
+
+    __block BOOL completed = NO;
+    [self uploadFile:fileURL completionHandler:^(AWSS3TransferUtilityMultiPartUploadTask *task, NSError *error) {
+        XCTAssertNil(error);
+        completed = YES;
+    }];
+    XCTAssertEqual([self.session.tasks count], 1);
+    AWSS3TestUploadTask *task = [self.session.tasks firstObject];
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:task.fileURL], data);
+
+    [self finishTask:task statusCode:200];
+    XCTAssertTrue(completed);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:task.fileURL.path]);
+    XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:fileURL.path]);
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:fileURL], data);
+}
+
+- (void)testUploadIsRecoveredFromTheDatabaseOfATerminatedApp {
+    NSUInteger const partCount = 6;
+    NSURL *fileURL = [self createFileWithLength:partCount * AWSS3TestPartSize];
+    [self uploadFile:fileURL completionHandler:nil];
+
+    // The first two parts are committed with the files of the parts after them, the third one only when the pending writes are flushed.
+    [self finishTask:self.session.tasks[0] statusCode:200];
+    [self finishTask:self.session.tasks[1] statusCode:200];
+    [self finishTask:self.session.tasks[2] statusCode:200];
+
+    // The app is terminated: only the database files on disk are left, with the transactions committed so far.
+    AWSFMDatabaseQueue *databaseQueue = [self.transferUtility valueForKey:@"databaseQueue"];
+    NSString *databasePath = databaseQueue.path;
+    NSString *snapshotPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    NSArray<NSString *> *suffixes = @[@"", @"-wal"];
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        for (NSString *suffix in suffixes) {
+            [[NSFileManager defaultManager] copyItemAtPath:[databasePath stringByAppendingString:suffix]
+                                                    toPath:[snapshotPath stringByAppendingString:suffix]
+                                                     error:nil];
+        }
+    }];
+    [AWSS3TransferUtilityDatabaseHelper flushPendingWritesToDatabaseQueue:databaseQueue];
+    [databaseQueue close];
+    for (NSString *suffix in [suffixes arrayByAddingObject:@"-shm"]) {
+        [[NSFileManager defaultManager] removeItemAtPath:[databasePath stringByAppendingString:suffix] error:nil];
+    }
+    for (NSString *suffix in suffixes) {
+        [[NSFileManager defaultManager] moveItemAtPath:[snapshotPath stringByAppendingString:suffix]
+                                                toPath:[databasePath stringByAppendingString:suffix]
+                                                 error:nil];
+    }
+
+    // The relaunched app recovers the upload from the database.
+    self.session = [AWSS3TestURLSession new];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1 credentialsProvider:nil];
+    AWSS3TransferUtility *transferUtility = [[AWSS3TransferUtility alloc] initWithConfiguration:configuration
+                                                                  transferUtilityConfiguration:[self.transferUtility valueForKey:@"transferUtilityConfiguration"]
+                                                                                    identifier:[self.transferUtility valueForKey:@"sessionIdentifier"]
+                                                                                  recoverState:NO
+                                                                             completionHandler:nil];
+    [self injectMocksIntoTransferUtility:transferUtility];
+    [transferUtility recover:nil];
+
+    NSArray<AWSS3TransferUtilityMultiPartUploadTask *> *uploadTasks = [[transferUtility getMultiPartUploadTasks] result];
+    XCTAssertEqual([uploadTasks count], 1);
+    XCTestExpectation *expectation = [self expectationWithDescription:@"The upload completes"];
+    __block NSError *completionError = nil;
+    [[uploadTasks firstObject] setCompletionHandler:^(AWSS3TransferUtilityMultiPartUploadTask *task, NSError *error) {
+        completionError = error;
+        [expectation fulfill];
+    }];
+
+    // The third part is uploaded again, as its completion was not committed.
+    NSArray<NSNumber *> *expectedPartNumbers = @[@3, @4, @5, @6];
+    XCTAssertEqualObjects(self.presignedPartNumbers, expectedPartNumbers);
+    while ([[self.session runningTasks] count] > 0) {
+        [self finishTask:[[self.session runningTasks] firstObject] statusCode:200 transferUtility:transferUtility];
+    }
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    XCTAssertNil(completionError);
+    XCTAssertEqual([self.session.tasks count], 4);
+
+    NSArray<AWSS3CompletedPart *> *parts = self.completeMultipartUploadRequest.multipartUpload.parts;
+    XCTAssertEqual([parts count], partCount);
+    for (NSUInteger i = 0; i < [parts count]; i++) {
+        XCTAssertEqualObjects(parts[i].partNumber, @(i + 1));
+    }
+    // The ETags of the parts uploaded before the app was terminated are read from the database.
+    XCTAssertEqualObjects(parts[0].ETag, @"\"1000\"");
+    XCTAssertEqualObjects(parts[1].ETag, @"\"1001\"");
+}
+
+// Parts of S3 are at least 5 MB, so the upload is built with parts of a byte to time the scheduling of 10,000 parts only.
+- (void)testSchedulingTenThousandPartsBenchmark {
+    NSUInteger const partCount = 10000;
+    NSURL *fileURL = [self createFileWithLength:partCount];
+    // The parts are not in the database, so only the scheduling is timed.
+    [self.transferUtility setValue:nil forKey:@"databaseQueue"];
+
+    AWSS3TransferUtilityMultiPartUploadTask *task = [AWSS3TransferUtilityMultiPartUploadTask new];
+    [task setValue:[[NSUUID UUID] UUIDString] forKey:@"transferID"];
+    [task setValue:@"bucket" forKey:@"bucket"];
+    [task setValue:@"key" forKey:@"key"];
+    [task setValue:@"uploadID" forKey:@"uploadID"];
+    [task setValue:fileURL.path forKey:@"file"];
+    [task setValue:@1 forKey:@"partSize"];
+    [task setValue:@(partCount) forKey:@"contentLength"];
+    [task setValue:@(AWSS3TransferUtilityTransferStatusInProgress) forKey:@"status"];
+    task.progress.totalUnitCount = partCount;
+    NSMutableArray *pendingParts = [task valueForKey:@"pendingParts"];
+    for (NSUInteger i = 1; i <= partCount; i++) {
+        AWSS3TransferUtilityUploadSubTask *subTask = [AWSS3TransferUtilityUploadSubTask new];
+        [subTask setValue:[task transferID] forKey:@"transferID"];
+        [subTask setValue:@(i) forKey:@"partNumber"];
+        [subTask setValue:@"MULTI_PART_UPLOAD_SUB_TASK" forKey:@"transferType"];
+        [subTask setValue:@1 forKey:@"totalBytesExpectedToSend"];
+        [subTask setValue:@"" forKey:@"responseData"];
+        [subTask setValue:@"" forKey:@"file"];
+        [subTask setValue:@"" forKey:@"eTag"];
+        [pendingParts addObject:subTask];
+    }
+    __block NSError *completionError = nil;
+    __block BOOL completed = NO;
+    [task setCompletionHandler:^(AWSS3TransferUtilityMultiPartUploadTask *task, NSError *error) {
+        completionError = error;
+        completed = YES;
+    }];
+
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    XCTAssertNil([self.transferUtility scheduleUploadSubTasks:task startTransfer:YES]);
+    // The parts are started in the order they were created in, which is the order of their part numbers.
+    for (NSUInteger i = 0; i < [self.session.tasks count]; i++) {
+        AWSS3TestUploadTask *uploadTask = self.session.tasks[i];
+        if (!uploadTask.resumed) {
+            XCTFail(@"Task %lu was not started before the tasks after it", (unsigned long)i);
+            break;
+        }
+        [self finishTask:uploadTask statusCode:200];
+    }
+    CFAbsoluteTime duration = CFAbsoluteTimeGetCurrent() - startTime;
+
+    XCTAssertEqual([self.session.tasks count], partCount);
+    XCTAssertEqual(task.progress.completedUnitCount, (int64_t)partCount);
+    XCTAssertTrue(completed);
+    XCTAssertNil(completionError);
+    NSLog(@"Scheduled %lu parts in %.3f seconds (%.1f microseconds per part)",
+          (unsigned long)partCount, duration, duration * 1000000 / partCount);
+}
+
+@end
@@ -0,0 +1,238 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSS3Service.h"
+#import "AWSS3Resources.h"
+
+static NSUInteger const AWSS3XMLStreamingParserTestsKeyCount = 1000;
+
+@interface AWSS3XMLStreamingParserTests : XCTestCase
+
+@property (nonatomic, strong) NSData *listObjectsV2Data;
+@property (nonatomic, strong) NSDictionary *serviceDefinitionRule;
+@property (nonatomic, strong) NSDictionary *legacyServiceDefinitionRule;
+
+@end
+
+@implementation AWSS3XMLStreamingParserTests
+
+- (void)setUp {
+    [super setUp];
+
+    NSMutableString *xml = [NSMutableString stringWithString:@"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\"><Name>bucket</Name><Prefix>photos/</Prefix>"];
+    [xml appendFormat:@"<KeyCount>%lu</KeyCount><MaxKeys>1000</MaxKeys><IsTruncated>true</IsTruncated>", (unsigned long)AWSS3XMLStreamingParserTestsKeyCount];
+    for (NSUInteger i = 0; i < AWSS3XMLStreamingParserTestsKeyCount; i++) {
+        [xml appendFormat:@"<Contents><Key>photos/%05lu &amp; more.jpg</Key><LastModified>2021-06-01T12:00:00.000Z</LastModified>"
+                          @"<ETag>&quot;d41d8cd98f00b204e9800998ecf8427e&quot;</ETag><Size>%lu</Size><StorageClass>STANDARD</StorageClass>"
+                          @"<Owner><ID>owner-id</ID><DisplayName>owner</DisplayName></Owner></Contents>", (unsigned long)i, (unsigned long)(i * 1024)];
+    }
+    [xml appendString:@"<CommonPrefixes><Prefix>photos/2020/</Prefix></CommonPrefixes><CommonPrefixes><Prefix>photos/2021/</Prefix></CommonPrefixes>"];
+    [xml appendString:@"<NextContinuationToken>token</NextContinuationToken></ListBucketResult>"];
+    self.listObjectsV2Data = [xml dataUsingEncoding:NSUTF8StringEncoding];
+
+    self.serviceDefinitionRule = [[AWSS3Resources sharedInstance] JSONObject];
+
+    // Any protocol other than rest-xml makes AWSXMLParser build the full xml tree, as it did before.
+    NSMutableDictionary *legacyServiceDefinitionRule = [self.serviceDefinitionRule mutableCopy];
+    NSMutableDictionary *metadata = [self.serviceDefinitionRule[@"metadata"] mutableCopy];
+    metadata[@"protocol"] = @"rest-xml-tree";
+    legacyServiceDefinitionRule[@"metadata"] = metadata;
+    self.legacyServiceDefinitionRule = legacyServiceDefinitionRule;
+}
+
+- (NSDictionary *)parseWithServiceDefinitionRule:(NSDictionary *)serviceDefinitionRule {
+    NSError *error = nil;
+    NSDictionary *result = [[AWSXMLParser sharedInstance] dictionaryForXMLData:self.listObjectsV2Data
+                                                                    actionName:@"ListObjectsV2"
+                                                         serviceDefinitionRule:serviceDefinitionRule
+                                                                         error:&error];
+    XCTAssertNil(error);
+    return result;
+}
+
+- (void)testStreamingParserMatchesTreeParser {
+    NSDictionary *streamed = [self parseWithServiceDefinitionRule:self.serviceDefinitionRule];
+    NSDictionary *tree = [self parseWithServiceDefinitionRule:self.legacyServiceDefinitionRule];
+
+    XCTAssertEqualObjects(streamed, tree);
+    XCTAssertEqual([streamed[@"Contents"] count], AWSS3XMLStreamingParserTestsKeyCount);
+    XCTAssertEqualObjects(streamed[@"Contents"][1][@"Key"], @"photos/00001 & more.jpg");
+    XCTAssertEqualObjects(streamed[@"Contents"][1][@"Size"], @1024);
+    XCTAssertEqualObjects(streamed[@"Contents"][1][@"Owner"][@"ID"], @"owner-id");
+    XCTAssertEqualObjects(streamed[@"IsTruncated"], @YES);
+    XCTAssertEqualObjects(streamed[@"CommonPrefixes"][1][@"Prefix"], @"photos/2021/");
+}
+
+- (void)testErrorDocumentFallsBackToTreeParser {
+    NSData *data = [@"<?xml version=\"1.0\" encoding=\"UTF-8\"?><Error><Code>NoSuchBucket</Code><Message>The specified bucket does not exist</Message></Error>" dataUsingEncoding:NSUTF8StringEncoding];
+    NSDictionary *result = [[AWSXMLParser sharedInstance] dictionaryForXMLData:data
+                                                                    actionName:@"ListObjectsV2"
+                                                         serviceDefinitionRule:self.serviceDefinitionRule
+                                                                         error:nil];
+    XCTAssertEqualObjects(result[@"Error"][@"Code"], @"NoSuchBucket");
+}
+
+- (void)testRootElementMemberFallsBackToTreeParser {
+    NSData *data = [@"<?xml version=\"1.0\" encoding=\"UTF-8\"?><LocationConstraint xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">us-west-2</LocationConstraint>" dataUsingEncoding:NSUTF8StringEncoding];
+    NSDictionary *result = [[AWSXMLParser sharedInstance] dictionaryForXMLData:data
+                                                                    actionName:@"GetBucketLocation"
+                                                         serviceDefinitionRule:self.serviceDefinitionRule
+                                                                         error:nil];
+    XCTAssertEqualObjects(result[@"LocationConstraint"], @"us-west-2");
+}
+
+- (void)testResponseItemHandlerReceivesModelObjects {
+    AWSXMLResponseSerializer *serializer = [[AWSXMLResponseSerializer alloc] initWithJSONDefinition:self.serviceDefinitionRule
+                                                                                         actionName:@"ListObjectsV2"
+                                                                                        outputClass:[AWSS3ListObjectsV2Output class]];
+    NSMutableArray<AWSS3Object *> *objects = [NSMutableArray new];
+    NSMutableArray<AWSS3CommonPrefix *> *commonPrefixes = [NSMutableArray new];
+    serializer.responseItemHandler = ^(NSString *memberName, id item) {
+        if ([memberName isEqualToString:@"Contents"]) {
+            [objects addObject:item];
+        } else if ([memberName isEqualToString:@"CommonPrefixes"]) {
+            [commonPrefixes addObject:item];
+        }
+    };
+
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://bucket.s3.amazonaws.com/"]
+                                                              statusCode:200
+                                                             HTTPVersion:@"HTTP/1.1"
+                                                            headerFields:@{}];
+    NSError *error = nil;
+    NSDictionary *result = [serializer responseObjectForResponse:response
+                                                 originalRequest:nil
+                                                  currentRequest:nil
+                                                            data:self.listObjectsV2Data
+                                                           error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqual([result[@"Contents"] count], 0);
+    XCTAssertEqualObjects(result[@"NextContinuationToken"], @"token");
+
+    XCTAssertEqual([objects count], AWSS3XMLStreamingParserTestsKeyCount);
+    XCTAssertTrue([objects[2] isKindOfClass:[AWSS3Object class]]);
+    XCTAssertEqualObjects(objects[2].key, @"photos/00002 & more.jpg");
+    XCTAssertEqualObjects(objects[2].size, @2048);
+    XCTAssertEqualObjects(objects[2].owner.displayName, @"owner");
+    XCTAssertNotNil(objects[2].lastModified);
+    XCTAssertEqual([commonPrefixes count], 2);
+    XCTAssertEqualObjects(commonPrefixes[0].prefix, @"photos/2020/");
+}
+
+- (void)testResponseIsParsedWhileItIsReceived {
+    AWSXMLResponseSerializer *serializer = [[AWSXMLResponseSerializer alloc] initWithJSONDefinition:self.serviceDefinitionRule
+                                                                                         actionName:@"ListObjectsV2"
+                                                                                        outputClass:[AWSS3ListObjectsV2Output class]];
+    NSMutableArray<AWSS3Object *> *objects = [NSMutableArray new];
+    serializer.responseItemHandler = ^(NSString *memberName, id item) {
+        if ([memberName isEqualToString:@"Contents"]) {
+            @synchronized(objects) {
+                [objects addObject:item];
+            }
+        }
+    };
+
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://bucket.s3.amazonaws.com/"]
+                                                              statusCode:200
+                                                             HTTPVersion:@"HTTP/1.1"
+                                                            headerFields:@{}];
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:response.URL];
+    request.HTTPMethod = @"GET";
+    id<AWSNetworkingResponseBodyConsumer> consumer = [serializer responseBodyConsumerForResponse:response originalRequest:request];
+    XCTAssertTrue([consumer isKindOfClass:[AWSStreamingResponseBodyConsumer class]]);
+
+    NSError *error = nil;
+    XCTAssertTrue([consumer beginResponse:response error:&error]);
+    NSUInteger chunkSize = 4096;
+    for (NSUInteger offset = 0; offset < [self.listObjectsV2Data length]; offset += chunkSize) {
+        NSData *chunk = [self.listObjectsV2Data subdataWithRange:NSMakeRange(offset, MIN(chunkSize, [self.listObjectsV2Data length] - offset))];
+        XCTAssertTrue([consumer consumeData:chunk error:&error]);
+    }
+    id body = [consumer finishResponseWithError:&error];
+    XCTAssertNil(error);
+    XCTAssertTrue([body isKindOfClass:[NSDictionary class]]);
+
+    NSDictionary *result = [serializer responseObjectForResponse:response
+                                                 originalRequest:request
+                                                  currentRequest:request
+                                                            data:body
+                                                           error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(result[@"NextContinuationToken"], @"token");
+    XCTAssertEqualObjects(result[@"KeyCount"], @(AWSS3XMLStreamingParserTestsKeyCount));
+    XCTAssertEqual([objects count], AWSS3XMLStreamingParserTestsKeyCount);
+    XCTAssertEqualObjects(objects[2].key, @"photos/00002 & more.jpg");
+
+    // Error documents and uploads are collected and parsed as a whole.
+    NSHTTPURLResponse *errorResponse = [[NSHTTPURLResponse alloc] initWithURL:response.URL statusCode:404 HTTPVersion:@"HTTP/1.1" headerFields:@{}];
+    XCTAssertNil([serializer responseBodyConsumerForResponse:errorResponse originalRequest:request]);
+    request.HTTPMethod = @"PUT";
+    XCTAssertNil([serializer responseBodyConsumerForResponse:response originalRequest:request]);
+}
+
+- (void)testTruncatedStreamedResponseFails {
+    AWSXMLResponseSerializer *serializer = [[AWSXMLResponseSerializer alloc] initWithJSONDefinition:self.serviceDefinitionRule
+                                                                                         actionName:@"ListObjectsV2"
+                                                                                        outputClass:[AWSS3ListObjectsV2Output class]];
+    serializer.responseItemHandler = ^(NSString *memberName, id item) {};
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://bucket.s3.amazonaws.com/"]
+                                                              statusCode:200
+                                                             HTTPVersion:@"HTTP/1.1"
+                                                            headerFields:@{}];
+    id<AWSNetworkingResponseBodyConsumer> consumer = [serializer responseBodyConsumerForResponse:response
+                                                                                originalRequest:[NSURLRequest requestWithURL:response.URL]];
+    NSError *error = nil;
+    XCTAssertTrue([consumer beginResponse:response error:&error]);
+    [consumer consumeData:[self.listObjectsV2Data subdataWithRange:NSMakeRange(0, [self.listObjectsV2Data length] / 2)] error:&error];
+    XCTAssertNil([consumer finishResponseWithError:&error]);
+    XCTAssertNotNil(error);
+}
+
+#pragma mark - Benchmarks
+
+- (void)testPerformanceStreamingParser {
+    if (@available(iOS 13.0, *)) {
+        [self measureWithMetrics:@[[XCTMemoryMetric new], [XCTClockMetric new]] block:^{
+            [self parseWithServiceDefinitionRule:self.serviceDefinitionRule];
+        }];
+    }
+}
+
+- (void)testPerformanceStreamingParserWithItemHandler {
+    if (@available(iOS 13.0, *)) {
+        [self measureWithMetrics:@[[XCTMemoryMetric new], [XCTClockMetric new]] block:^{
+            __block NSUInteger count = 0;
+            [[AWSXMLParser sharedInstance] dictionaryForXMLData:self.listObjectsV2Data
+                                                     actionName:@"ListObjectsV2"
+                                          serviceDefinitionRule:self.serviceDefinitionRule
+                                                    itemHandler:^(NSString *memberName, id item) {
+                count++;
+            }
+                                                          error:nil];
+            XCTAssertEqual(count, AWSS3XMLStreamingParserTestsKeyCount + 2);
+        }];
+    }
+}
+
+- (void)testPerformanceTreeParser {
+    if (@available(iOS 13.0, *)) {
+        [self measureWithMetrics:@[[XCTMemoryMetric new], [XCTClockMetric new]] block:^{
+            [self parseWithServiceDefinitionRule:self.legacyServiceDefinitionRule];
+        }];
+    }
+}
+
+@end
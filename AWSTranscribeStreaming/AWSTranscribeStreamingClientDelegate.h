@@ -27,7 +27,8 @@ typedef NS_ENUM(NSInteger, AWSTranscribeStreamingClientErrorCode) {
     AWSTranscribeStreamingClientErrorCodeWebSocketProtocolError,
     AWSTranscribeStreamingClientErrorCodeWebSocketCouldNotInitialize,
     AWSTranscribeStreamingClientErrorCodeWebSocketClosedUnexpectedly,
-    AWSTranscribeStreamingClientErrorCodeUnknown
+    AWSTranscribeStreamingClientErrorCodeUnknown,
+    AWSTranscribeStreamingClientErrorCodeInvalidMessageChecksum
 };
 
 typedef NS_ENUM(NSInteger, AWSTranscribeStreamingClientConnectionStatus) {
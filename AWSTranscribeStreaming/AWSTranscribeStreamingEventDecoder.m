@@ -42,6 +42,10 @@
     if (![AWSTranscribeStreamingEventDecoder verifyMessageLengthHeaderForData:data decodingError:decodingErrorPointer]) {
         return nil;
     }
+
+    if (![AWSTranscribeStreamingEventDecoder verifyChecksumsForData:data decodingError:decodingErrorPointer]) {
+        return nil;
+    }
     
     NSDictionary<NSString *, NSString *> *headers = [AWSTranscribeStreamingEventDecoder getHeadersForData:data];
     AWSDDLogVerbose(@"Response headers: %@", headers);
@@ -93,6 +97,34 @@
     return YES;
 }
 
++(bool)verifyChecksumsForData:(NSData *)data
+                decodingError:(NSError **)decodingErrorPointer {
+    const uint8_t *bytes = [data bytes];
+    NSUInteger totalLength = (NSUInteger)[AWSTranscribeStreamingEventDecoder getTotalLengthForData:data];
+    if (totalLength < 16) {
+        totalLength = [data length];
+    }
+
+    uint32_t preludeCRC = CFSwapInt32BigToHost(*(UInt32 *)(bytes + 8));
+    uint32_t messageCRC = CFSwapInt32BigToHost(*(UInt32 *)(bytes + totalLength - 4));
+    uint32_t computedPreludeCRC = [AWSChecksum CRC32ForBytes:bytes length:8];
+    uint32_t computedMessageCRC = [AWSChecksum CRC32ForBytes:bytes length:totalLength - 4];
+
+    if (preludeCRC != computedPreludeCRC || messageCRC != computedMessageCRC) {
+        NSString *failureReason = [NSString stringWithFormat:@"Checksum mismatch, prelude CRC %08x (computed %08x), message CRC %08x (computed %08x)",
+                                   preludeCRC,
+                                   computedPreludeCRC,
+                                   messageCRC,
+                                   computedMessageCRC];
+        NSDictionary *userInfo = @{NSLocalizedFailureReasonErrorKey: failureReason};
+        *decodingErrorPointer = [NSError errorWithDomain:AWSTranscribeStreamingClientErrorDomain
+                                                    code:AWSTranscribeStreamingClientErrorCodeInvalidMessageChecksum
+                                                userInfo:userInfo];
+        return NO;
+    }
+    return YES;
+}
+
 +(NSDictionary<NSString *, NSString *> *)getHeadersForData:(NSData *)data {
     
     int headerLen = [AWSTranscribeStreamingEventDecoder getHeaderLengthForData:data];
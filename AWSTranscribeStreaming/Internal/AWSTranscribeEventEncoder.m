@@ -16,7 +16,6 @@
 #import "AWSTranscribeEventEncoder.h"
 #import "AWSTranscribeStreamingModel.h"
 #import <CommonCrypto/CommonDigest.h>
-#import <zlib.h>
 #import <AWSCore/AWSCore.h>
 
 @implementation AWSTranscribeEventEncoder
@@ -53,11 +52,9 @@
     int headerLengthToEncode = (int)headerLength;
     headerLengthToEncode = CFSwapInt32HostToBig(headerLengthToEncode);
     [resultData appendBytes:&headerLengthToEncode length:sizeof(headerLengthToEncode)];
-    NSData *preludeData = [resultData subdataWithRange:NSMakeRange(0, 8)];
+    uint32_t crc = [AWSChecksum CRC32ForBytes:resultData.bytes length:8];
     
-    unsigned long crc = crc32(0, preludeData.bytes, (int)preludeData.length);
-    
-    uint32_t crcInt = CFSwapInt32HostToBig((uint32_t)crc);
+    uint32_t crcInt = CFSwapInt32HostToBig(crc);
     [resultData appendBytes:&crcInt length:sizeof(crcInt)];
     
     for (NSString *headerKey in headers) {
@@ -77,9 +74,9 @@
     }
     [resultData appendBytes:[data bytes] length:[data length]];
     
-    unsigned long crcMessage = crc32(0, resultData.bytes, (int)resultData.length);
+    uint32_t crcMessage = [AWSChecksum CRC32ForBytes:resultData.bytes length:resultData.length];
     
-    uint32_t crcMessageInt = CFSwapInt32HostToBig((uint32_t)crcMessage);
+    uint32_t crcMessageInt = CFSwapInt32HostToBig(crcMessage);
     [resultData appendBytes:&crcMessageInt length:sizeof(crcMessageInt)];
     
     return resultData;
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+#
+# Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License").
+# You may not use this file except in compliance with the License.
+# A copy of the License is located at
+#
+# http://aws.amazon.com/apache2.0
+#
+# or in the "license" file accompanying this file. This file is distributed
+# on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+# express or implied. See the License for the specific language governing
+# permissions and limitations under the License.
+#
+
+"""
+Compiles the JSON service definitions embedded in the `*Resources.m` files into
+the binary `.awsmodel` files read by `AWSServiceModelCache`.
+
+Copy the generated files into the app bundle (or the bundle of the service
+framework) to skip parsing the JSON definition on first launch:
+
+    python3 Scripts/compile_service_models.py --output build/models AWSS3 AWSIoT
+
+Each file is named after its `*Resources` class without the `AWS` prefix and
+the `Resources` suffix, e.g. `AWSS3Resources.m` produces `S3.awsmodel`. The
+fingerprint stored in each file is computed the same way as
+`+[AWSServiceModelCache fingerprintForDefinitionString:]`, so a model compiled
+for a different SDK version or definition is ignored at runtime.
+"""
+
+import argparse
+import glob
+import json
+import os
+import plistlib
+import re
+import sys
+import zlib
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+FINGERPRINT_KEY = "x-aws-model-fingerprint"
+DOCUMENTATION_KEYS = ("documentation", "documentationUrl")
+
+
+def sdk_version():
+    with open(os.path.join(ROOT, "AWSCore", "Service", "AWSService.m"), encoding="utf-8") as f:
+        match = re.search(r'AWSiOSSDKVersion = @"([^"]+)"', f.read())
+    if not match:
+        sys.exit("Can not find AWSiOSSDKVersion in AWSService.m")
+    return match.group(1)
+
+
+def definition_string(resources_path):
+    """Returns the value of the Objective-C literal returned by -definitionString."""
+    with open(resources_path, encoding="utf-8") as f:
+        source = f.read()
+    match = re.search(r'- \(NSString \*\)definitionString \{\s*return @"(.*?)";\s*\}', source, re.DOTALL)
+    if not match:
+        return None
+
+    # Line splices are removed before escape sequences are processed.
+    literal = match.group(1).replace("\\\n", "")
+    escapes = {'"': '"', "\\": "\\", "n": "\n", "t": "\t", "'": "'", "r": "\r"}
+    result = []
+    index = 0
+    while index < len(literal):
+        char = literal[index]
+        if char == "\\" and index + 1 < len(literal):
+            result.append(escapes.get(literal[index + 1], literal[index + 1]))
+            index += 2
+        else:
+            result.append(char)
+            index += 1
+    return "".join(result)
+
+
+def fingerprint(definition, version):
+    data = definition.encode("utf-8")
+    return "%s-%d-%08x" % (version, len(data), zlib.crc32(data) & 0xFFFFFFFF)
+
+
+def strip_documentation(value, parent_key=None):
+    if isinstance(value, dict):
+        is_members = parent_key == "members"
+        return {
+            key: strip_documentation(item, key)
+            for key, item in value.items()
+            if is_members or key not in DOCUMENTATION_KEYS or not isinstance(item, str)
+        }
+    if isinstance(value, list):
+        return [strip_documentation(item) for item in value]
+    return value
+
+
+def compile_resources(resources_path, output_dir, version):
+    name = os.path.basename(resources_path)[len("AWS"):-len("Resources.m")]
+    definition = definition_string(resources_path)
+    if definition is None:
+        print("Skipping %s: no definitionString found" % resources_path)
+        return
+    model = strip_documentation(json.loads(definition))
+    model[FINGERPRINT_KEY] = fingerprint(definition, version)
+
+    output_path = os.path.join(output_dir, name + ".awsmodel")
+    with open(output_path, "wb") as f:
+        plistlib.dump(model, f, fmt=plistlib.FMT_BINARY, sort_keys=False)
+    print("%s -> %s (%d bytes of JSON, %d bytes compiled)" % (
+        resources_path, output_path, len(definition.encode("utf-8")), os.path.getsize(output_path)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--output", required=True, help="directory the .awsmodel files are written to")
+    parser.add_argument("services", nargs="*", help="service directories, e.g. AWSS3; defaults to every service")
+    args = parser.parse_args()
+
+    directories = args.services or [os.path.relpath(path, ROOT) for path in glob.glob(os.path.join(ROOT, "AWS*")) if os.path.isdir(path)]
+    os.makedirs(args.output, exist_ok=True)
+    version = sdk_version()
+    for directory in sorted(directories):
+        for resources_path in sorted(glob.glob(os.path.join(ROOT, directory, "**", "AWS*Resources.m"), recursive=True)):
+            compile_resources(resources_path, args.output, version)
+
+
+if __name__ == "__main__":
+    main()